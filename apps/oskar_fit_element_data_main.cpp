@@ -83,6 +83,7 @@ int main(int argc, char** argv)
             s->to_double("average_fractional_error_factor_increase", &e);
     int ignore_below_horizon = s->to_int("ignore_data_below_horizon", &e);
     int ignore_at_pole = s->to_int("ignore_data_at_pole", &e);
+    double tabulation_tolerance = s->to_double("tabulation_tolerance", &e);
     int port = pol_type == "X" ? 1 : pol_type == "Y" ? 2 : 0;
 
     // Check that the input and output files have been set.
@@ -108,6 +109,8 @@ int main(int argc, char** argv)
                 input_cst_file.c_str(), average_fractional_error,
                 average_fractional_error_factor_increase,
                 ignore_at_pole, ignore_below_horizon, log, &e);
+        if (tabulation_tolerance > 0.0)
+            oskar_element_tabulate(element, tabulation_tolerance, log, &e);
 
         // Construct the output file name based on the settings.
         if (port == 0)
@@ -139,6 +142,8 @@ int main(int argc, char** argv)
                 input_scalar_file.c_str(), average_fractional_error,
                 average_fractional_error_factor_increase,
                 ignore_at_pole, ignore_below_horizon, log, &e);
+        if (tabulation_tolerance > 0.0)
+            oskar_element_tabulate(element, tabulation_tolerance, log, &e);
 
         // Construct the output file name based on the settings.
         string output = construct_element_pathname(output_dir, 0,
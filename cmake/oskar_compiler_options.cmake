@@ -4,6 +4,9 @@ macro(APPEND_FLAGS FLAG_VAR)
     endforeach()
 endmacro()
 
+# Build the AVX2 and AVX-512 versions of selected kernels, if supported.
+option(USE_SIMD "Build AVX2 and AVX-512 versions of CPU kernels" ON)
+
 # Set general compiler flags.
 set(BUILD_SHARED_LIBS ON)
 set(CMAKE_POSITION_INDEPENDENT_CODE ON)
@@ -52,6 +55,23 @@ if (NOT WIN32)
             -fvisibility=hidden
             -fdiagnostics-show-option)
 
+        # Check for SIMD instruction sets that can be selected at run time.
+        # Only the source files that need them are compiled with these flags.
+        if (CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64)$"
+                AND USE_SIMD)
+            include(CheckCXXCompilerFlag)
+            check_cxx_compiler_flag("-mavx2 -mfma" COMPILER_SUPPORTS_AVX2)
+            check_cxx_compiler_flag("-mavx512f" COMPILER_SUPPORTS_AVX512)
+            if (COMPILER_SUPPORTS_AVX2)
+                set(OSKAR_AVX2_FLAGS "-mavx2 -mfma")
+                add_definitions(-DOSKAR_HAVE_AVX2)
+                if (COMPILER_SUPPORTS_AVX512)
+                    set(OSKAR_AVX512_FLAGS "-mavx512f -mavx2 -mfma")
+                    add_definitions(-DOSKAR_HAVE_AVX512)
+                endif()
+            endif()
+        endif()
+
          # Additional test flags
 #        append_flags(CMAKE_C_FLAGS
 #            -Wbad-function-cast -Wstack-protector -Wpacked
@@ -37,7 +37,6 @@ using namespace std;
 oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
         oskar_Log* log, int* status)
 {
-    (void) log;
     if (*status || !s) return 0;
     s->clear_group();
 
@@ -114,6 +113,20 @@ oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
     oskar_imager_set_grid_on_gpu(h, s->to_int("fft/grid_on_gpu", status));
     oskar_imager_set_generate_w_kernels_on_gpu(h,
             s->to_int("wproj/generate_w_kernels_on_gpu", status));
+    oskar_imager_set_w_kernel_cache_dir(h,
+            s->to_string("wproj/w_kernel_cache_dir", status));
+    const char* telescope_model = s->to_string("idg/telescope_model", status);
+    if (telescope_model && strlen(telescope_model) > 0)
+    {
+        // Load the telescope model used for the station beams.
+        oskar_Telescope* tel = oskar_telescope_create(
+                s->to_int("double_precision", status) ?
+                OSKAR_DOUBLE : OSKAR_SINGLE, OSKAR_CPU, 0, status);
+        oskar_telescope_set_pol_mode(tel, "Scalar", status);
+        oskar_telescope_load(tel, telescope_model, log, status);
+        oskar_imager_set_telescope_model(h, tel, status);
+        oskar_telescope_free(tel, status);
+    }
     if (s->first_letter("direction", status) == 'R')
         oskar_imager_set_direction(h,
                 s->to_double("direction/ra_deg", status),
@@ -78,6 +78,12 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
             s->to_int("max_time_samples_per_block", status));
     oskar_interferometer_set_max_channels_per_block(h,
             s->to_int("max_channels_per_block", status));
+    oskar_interferometer_set_write_queue_depth(h,
+            s->to_int("write_queue_depth", status));
+    oskar_interferometer_set_share_telescope(h,
+            s->to_int("share_telescope_model", status));
+    oskar_interferometer_set_max_flux_table_mb(h,
+            s->to_double("max_flux_table_size_mb", status));
     oskar_interferometer_set_output_vis_file(h,
             s->to_string("oskar_vis_filename", status));
     oskar_interferometer_set_output_measurement_set(h,
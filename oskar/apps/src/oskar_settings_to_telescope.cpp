@@ -44,9 +44,24 @@ oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
             s->to_string("telescope/pol_mode", status), status);
     oskar_telescope_set_allow_station_beam_duplication(t,
             s->to_int("telescope/allow_station_beam_duplication", status));
+    oskar_telescope_set_station_beam_max_distance(t,
+            s->to_double("telescope/station_beam_duplication_max_distance_m",
+                    status));
+    if (s->to_int("telescope/aperture_array/beam_interpolation/enable",
+            status))
+        oskar_telescope_set_station_beam_interpolation(t,
+                s->to_int("telescope/aperture_array/beam_interpolation/"
+                        "samples_per_beam_width", status),
+                s->to_double("telescope/aperture_array/beam_interpolation/"
+                        "max_cache_size_mb", status));
     oskar_telescope_set_enable_numerical_patterns(t,
             s->to_int("telescope/aperture_array/element_pattern/"
                     "enable_numerical", status));
+    if (s->to_int("telescope/aperture_array/element_pattern/"
+            "tabulation/enable", status))
+        oskar_telescope_set_element_tabulation_tolerance(t,
+                s->to_double("telescope/aperture_array/element_pattern/"
+                        "tabulation/tolerance", status));
 
     /************************************************************************/
     /* Load telescope model folders to define the stations. */
@@ -103,6 +118,10 @@ oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
                 s->to_double("uv_filter_min", status),
                 s->to_double("uv_filter_max", status),
                 s->to_string("uv_filter_units", status), status);
+        oskar_telescope_set_correlator_tiling(t,
+                s->to_int("correlator_tiling", status),
+                s->to_int("correlator_station_tile", status),
+                s->to_int("correlator_source_tile", status));
         switch (s->first_letter("noise/freq", status))
         {
         case 'R': /* Range. */
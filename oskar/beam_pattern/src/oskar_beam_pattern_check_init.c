@@ -618,6 +618,9 @@ static void set_up_device_data(oskar_BeamPattern* h, int* status)
             if (oskar_telescope_ionosphere_screen_type(d->tel) == 'E')
                 oskar_station_work_set_tec_screen_path(d->work,
                         oskar_telescope_tec_screen_path(d->tel));
+            oskar_station_work_set_beam_interpolation(d->work,
+                    oskar_telescope_station_beam_interp_samples(d->tel),
+                    oskar_telescope_station_beam_interp_cache_mb(d->tel));
         }
 
         /* Host memory. */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/*
+ * Functions shared by the fused correlators.
+ *
+ * The phase for a baseline is the difference of the phases at its two
+ * stations, so the factor for baseline (p, q) is K_p * conj(K_q).
+ * Evaluating K once per station and source, rather than once per
+ * baseline and source, needs only O(stations * sources) sincos calls.
+ *
+ * Baselines are processed in tiles, each covering a range of stations q
+ * and a range of stations p, so that the Jones matrices for a block of
+ * sources at the stations in the tile can be re-used from cache.
+ */
+
+#ifndef OSKAR_DEFINE_CROSS_CORRELATE_FUSED_H_
+#define OSKAR_DEFINE_CROSS_CORRELATE_FUSED_H_
+
+#include "oskar_global.h"
+#include "utility/oskar_kernel_macros.h"
+
+/* Default number of sources for which the station phase factors
+ * are held at once. */
+#define OSKAR_XCORR_PHASE_BLOCK 256
+
+/*
+ * Returns the number of sources to process at once, given the requested
+ * source tile size, which is used if it is greater than zero.
+ */
+inline int oskar_xcorr_source_block(int num_sources, int source_tile)
+{
+    int block = (source_tile > 0) ? source_tile : OSKAR_XCORR_PHASE_BLOCK;
+    if (block > num_sources) block = num_sources;
+    return (block < 1) ? 1 : block;
+}
+
+/*
+ * Fills the baseline tiles, if tiles is not NULL, and returns the number
+ * of them. Each tile is given by four values: the first and one-past-last
+ * station q, and the first and one-past-last station p, where only
+ * baselines with p > q are used.
+ *
+ * If station_tile is less than 1, each tile is one row of baselines
+ * (station q with all stations p > q); otherwise, tiles are formed from
+ * all pairs of blocks of station_tile stations.
+ */
+inline int oskar_xcorr_station_tiles(int num_stations, int station_tile,
+        int* tiles)
+{
+    int num_tiles = 0;
+    if (station_tile < 1)
+    {
+        for (int SQ = 0; SQ < num_stations - 1; ++SQ, ++num_tiles)
+        {
+            if (!tiles) continue;
+            int* t = &tiles[4 * num_tiles];
+            t[0] = SQ; t[1] = SQ + 1; t[2] = SQ + 1; t[3] = num_stations;
+        }
+        return num_tiles;
+    }
+    for (int SQ = 0; SQ < num_stations; SQ += station_tile)
+    {
+        for (int SP = SQ; SP < num_stations; SP += station_tile, ++num_tiles)
+        {
+            if (!tiles) continue;
+            int* t = &tiles[4 * num_tiles];
+            t[0] = SQ;
+            t[1] = (SQ + station_tile < num_stations) ?
+                    SQ + station_tile : num_stations;
+            t[2] = SP;
+            t[3] = (SP + station_tile < num_stations) ?
+                    SP + station_tile : num_stations;
+        }
+    }
+    return num_tiles;
+}
+
+/*
+ * Evaluates the phase factor at one station for a block of sources,
+ * for the first channel and, if k_inc is not NULL, the phase rotation
+ * between channels.
+ */
+template<typename REAL, typename REAL2>
+inline void oskar_xcorr_station_phase(
+        const int                   num_sources,
+        const REAL*  const RESTRICT source_l,
+        const REAL*  const RESTRICT source_m,
+        const REAL*  const RESTRICT source_n,
+        const REAL                  station_u,
+        const REAL                  station_v,
+        const REAL                  station_w,
+        const REAL                  wavenumber,
+        const REAL                  wavenumber_inc,
+        REAL2*             RESTRICT k,
+        REAL2*             RESTRICT k_inc)
+{
+    for (int i = 0; i < num_sources; ++i)
+    {
+        const REAL path = station_u * source_l[i] + station_v * source_m[i] +
+                station_w * (source_n[i] - (REAL) 1);
+        SINCOS(wavenumber * path, k[i].y, k[i].x);
+        if (k_inc)
+        {
+            SINCOS(wavenumber_inc * path, k_inc[i].y, k_inc[i].x);
+        }
+    }
+}
+
+#endif /* include guard */
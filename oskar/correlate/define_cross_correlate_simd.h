@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/*
+ * Vectorised fused cross-correlator, for Jones matrices held as
+ * structure-of-arrays (see oskar_jones_soa.h).
+ *
+ * This is included by each translation unit that implements the
+ * correlator for a particular instruction set. The VEC template parameter
+ * is a wrapper around the native vector type, as described in
+ * math/define_simd_math.h.
+ */
+
+#ifndef OSKAR_DEFINE_CROSS_CORRELATE_SIMD_H_
+#define OSKAR_DEFINE_CROSS_CORRELATE_SIMD_H_
+
+#include "oskar_global.h"
+#include "correlate/define_correlate_utils.h"
+#include "correlate/define_cross_correlate_fused.h"
+#include "math/define_simd_math.h"
+#include "utility/oskar_kernel_macros.h"
+
+#include <cstddef>
+#include <cstring>
+
+/* sin(x) / x, or 1 if x is 0. */
+template<typename VEC>
+inline typename VEC::type oskar_simd_sinc(typename VEC::type x)
+{
+    typename VEC::type s, c;
+    VEC::sincos(x, s, c);
+    return VEC::select(VEC::cmp_eq(x, VEC::set1(0)),
+            VEC::set1(1), VEC::div(s, x));
+}
+
+/* Loads up to VEC::width elements, setting the others to zero. */
+template<typename VEC>
+inline typename VEC::type oskar_simd_load(const typename VEC::real* p, int n)
+{
+    if (n == (int) VEC::width) return VEC::load(p);
+    typename VEC::real t[VEC::width] = {0};
+    memcpy(t, p, n * sizeof(typename VEC::real));
+    return VEC::load(t);
+}
+
+/* Accumulates a vector, using Kahan summation if in single precision. */
+template<typename VEC>
+inline void oskar_simd_accumulate(typename VEC::real* sum,
+        typename VEC::real* guard, typename VEC::type x)
+{
+    if (sizeof(typename VEC::real) == 4)
+    {
+        const typename VEC::type s = VEC::load(sum);
+        const typename VEC::type y = VEC::sub(x, VEC::load(guard));
+        const typename VEC::type t = VEC::add(s, y);
+        VEC::store(guard, VEC::sub(VEC::sub(t, s), y));
+        VEC::store(sum, t);
+    }
+    else
+    {
+        VEC::store(sum, VEC::add(VEC::load(sum), x));
+    }
+}
+
+/* X * conj(Y) */
+#define OSKAR_SIMD_MUL_CONJ(VEC, OUT_X, OUT_Y, X_X, X_Y, Y_X, Y_Y) {\
+        OUT_X = VEC::fmadd(X_X, Y_X, VEC::mul(X_Y, Y_Y));\
+        OUT_Y = VEC::fnmadd(X_X, Y_Y, VEC::mul(X_Y, Y_X));}\
+
+/* (A * conj(B)) + (C * conj(D)) */
+#define OSKAR_SIMD_MUL_CONJ_ADD(VEC, OUT_X, OUT_Y, A, B, C, D) {\
+        typename VEC::type t1__, t2__;\
+        OSKAR_SIMD_MUL_CONJ(VEC, OUT_X, OUT_Y, A[0], A[1], B[0], B[1])\
+        OSKAR_SIMD_MUL_CONJ(VEC, t1__, t2__, C[0], C[1], D[0], D[1])\
+        OUT_X = VEC::add(OUT_X, t1__); OUT_Y = VEC::add(OUT_Y, t2__);}\
+
+/*
+ * Evaluates the phase factor at one station for a block of sources,
+ * for the first channel and, if num_channels > 1, the phase rotation
+ * between channels. The real and imaginary parts are stored in
+ * separate arrays, padded to a whole number of vectors.
+ */
+template<typename VEC>
+inline void oskar_simd_station_phase(
+        const int                                 num_sources,
+        const int                                 num_channels,
+        const typename VEC::real* const RESTRICT  source_l,
+        const typename VEC::real* const RESTRICT  source_m,
+        const typename VEC::real* const RESTRICT  source_n,
+        const typename VEC::real                  station_u,
+        const typename VEC::real                  station_v,
+        const typename VEC::real                  station_w,
+        const typename VEC::real                  wavenumber,
+        const typename VEC::real                  wavenumber_inc,
+        typename VEC::real*              RESTRICT k_re,
+        typename VEC::real*              RESTRICT k_im,
+        typename VEC::real*              RESTRICT k_inc_re,
+        typename VEC::real*              RESTRICT k_inc_im)
+{
+    typedef typename VEC::type V;
+    const int W = VEC::width;
+    const V u = VEC::set1(station_u), v = VEC::set1(station_v);
+    const V w = VEC::set1(station_w), one = VEC::set1(1);
+    for (int i = 0; i < num_sources; i += W)
+    {
+        V s, c;
+        const int n_lanes = (num_sources - i < W) ? num_sources - i : W;
+        const V l = oskar_simd_load<VEC>(&source_l[i], n_lanes);
+        const V m = oskar_simd_load<VEC>(&source_m[i], n_lanes);
+        const V n = VEC::sub(oskar_simd_load<VEC>(
+                &source_n[i], n_lanes), one);
+        const V path = VEC::fmadd(u, l, VEC::fmadd(v, m, VEC::mul(w, n)));
+        VEC::sincos(VEC::mul(VEC::set1(wavenumber), path), s, c);
+        VEC::store(&k_re[i], c);
+        VEC::store(&k_im[i], s);
+        if (num_channels > 1)
+        {
+            VEC::sincos(VEC::mul(VEC::set1(wavenumber_inc), path), s, c);
+            VEC::store(&k_inc_re[i], c);
+            VEC::store(&k_inc_im[i], s);
+        }
+    }
+}
+
+/*
+ * Jones matrices are held as 8 arrays of real values per station
+ * and channel, each of length jones_stride, with dimension order
+ * [station][channel][element][source].
+ *
+ * Source fluxes have dimension order [channel][source], where the
+ * channel stride is flux_stride.
+ *
+ * Visibilities for consecutive channels are num_baselines apart.
+ */
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename VEC, typename REAL4c
+>
+void oskar_xcorr_fused_simd(
+        const int                                 num_sources,
+        const int                                 num_stations,
+        const int                                 num_channels,
+        const int                                 offset_out,
+        const int                               station_tile,
+        const int                                source_tile,
+        const typename VEC::real* const RESTRICT  jones,
+        const int                                 jones_stride,
+        const typename VEC::real* const RESTRICT  source_I,
+        const typename VEC::real* const RESTRICT  source_Q,
+        const typename VEC::real* const RESTRICT  source_U,
+        const typename VEC::real* const RESTRICT  source_V,
+        const int                                 flux_stride,
+        const typename VEC::real* const RESTRICT  source_l,
+        const typename VEC::real* const RESTRICT  source_m,
+        const typename VEC::real* const RESTRICT  source_n,
+        const typename VEC::real* const RESTRICT  source_a,
+        const typename VEC::real* const RESTRICT  source_b,
+        const typename VEC::real* const RESTRICT  source_c,
+        const typename VEC::real* const RESTRICT  station_u,
+        const typename VEC::real* const RESTRICT  station_v,
+        const typename VEC::real* const RESTRICT  station_w,
+        const typename VEC::real* const RESTRICT  station_x,
+        const typename VEC::real* const RESTRICT  station_y,
+        const typename VEC::real                  uv_min_lambda,
+        const typename VEC::real                  uv_max_lambda,
+        const int                                 uv_filter_in_metres,
+        const typename VEC::real                  inv_wavelength,
+        const typename VEC::real                  inv_wavelength_inc,
+        const typename VEC::real                  frac_bandwidth,
+        const typename VEC::real                  time_int_sec,
+        const typename VEC::real                  gha0_rad,
+        const typename VEC::real                  dec0_rad,
+        const typename VEC::real                  source_filter_min,
+        const typename VEC::real                  source_filter_max,
+        const int                                 ignore_w_components,
+        REAL4c*                          RESTRICT vis)
+{
+    typedef typename VEC::real REAL;
+    typedef typename VEC::type V;
+    typedef typename VEC::mask M;
+    const int W = VEC::width;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const size_t channel_stride = 8 * (size_t) jones_stride;
+    const size_t station_stride = num_channels * channel_stride;
+    const REAL inv_wavelength_ratio = inv_wavelength_inc / inv_wavelength;
+    REAL lane_index[VEC::width];
+    for (int i = 0; i < W; ++i) lane_index[i] = (REAL) i;
+
+    // Station phase factors (K-Jones) for one block of sources, shared by
+    // all threads, for the first channel and the increment per channel.
+    // Each station's arrays are padded to a whole number of vectors.
+    const int block = oskar_xcorr_source_block(num_sources,
+            ((source_tile + W - 1) / W) * W);
+    const int block_stride = ((block + W - 1) / W) * W;
+    const size_t phase_size = (size_t) num_stations * block_stride;
+    REAL* phase_mem = new REAL[4 * phase_size];
+    REAL* const phase_re = phase_mem;
+    REAL* const phase_im = phase_re + phase_size;
+    REAL* const phase_inc_re = phase_im + phase_size;
+    REAL* const phase_inc_im = phase_inc_re + phase_size;
+    const REAL wavenumber = ((REAL) (2.0 * M_PI)) * inv_wavelength;
+    const REAL wavenumber_inc = ((REAL) (2.0 * M_PI)) * inv_wavelength_inc;
+
+    // Baseline tiles, shared between threads for each block of sources.
+    const int num_tiles =
+            oskar_xcorr_station_tiles(num_stations, station_tile, 0);
+    int* tiles = new int[4 * num_tiles + 4];
+    oskar_xcorr_station_tiles(num_stations, station_tile, tiles);
+#pragma omp parallel
+    {
+    // Per-thread accumulators for each channel and matrix element,
+    // aligned for vector loads and stores.
+    const size_t num_acc = 8 * (size_t) num_channels * W;
+    char* acc_mem = new char[2 * num_acc * sizeof(REAL) + 64];
+    REAL* sum = (REAL*) (acc_mem + (64 - ((size_t) acc_mem & 63)));
+    REAL* guard = sum + num_acc;
+
+    // Loop over source blocks.
+    for (int i_start = 0; i_start < num_sources; i_start += block)
+    {
+        const int i_end = (i_start + block < num_sources) ?
+                i_start + block : num_sources;
+
+        // Evaluate the phase factors at each station for this block.
+#pragma omp for schedule(static)
+        for (int s = 0; s < num_stations; ++s)
+        {
+            const size_t o = (size_t) s * block_stride;
+            oskar_simd_station_phase<VEC>(i_end - i_start, num_channels,
+                    &source_l[i_start], &source_m[i_start], &source_n[i_start],
+                    station_u[s], station_v[s],
+                    ignore_w_components ? (REAL) 0 : station_w[s],
+                    wavenumber, wavenumber_inc, &phase_re[o], &phase_im[o],
+                    &phase_inc_re[o], &phase_inc_im[o]);
+        }
+
+        // Loop over baseline tiles.
+#pragma omp for schedule(dynamic, 1)
+        for (int tile = 0; tile < num_tiles; ++tile)
+        {
+            const int* const lim = &tiles[4 * tile];
+            for (int SQ = lim[0]; SQ < lim[1]; ++SQ)
+            {
+                // Pointer to Jones matrix arrays for station q.
+                const REAL* const station_q = &jones[SQ * station_stride];
+                const size_t oq = (size_t) SQ * block_stride;
+
+                // Loop over baselines for this station in the tile.
+                const int SP_start = (lim[2] > SQ) ? lim[2] : SQ + 1;
+                for (int SP = SP_start; SP < lim[3]; ++SP)
+                {
+                    REAL uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+                    int c;
+
+                    // Pointer to Jones matrix arrays for station p.
+                    const REAL* const station_p = &jones[SP * station_stride];
+                    const size_t op = (size_t) SP * block_stride;
+
+                    // Get common baseline values.
+                    OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
+                            station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ],
+                            uu, vv, ww, uu2, vv2, uuvv, uv_len);
+
+                    // Apply the baseline length filter to each channel.
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        const REAL t = uv_filter_in_metres ? uv_len :
+                                uv_len * ((REAL) 1 + c * inv_wavelength_ratio);
+                        if (t >= uv_min_lambda && t <= uv_max_lambda) break;
+                    }
+                    if (c == num_channels) continue;
+
+                    // Compute the deltas for time-average smearing.
+                    du = dv = dw = (REAL) 0;
+                    if (TIME_SMEARING)
+                        OSKAR_BASELINE_DELTAS(REAL,
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ], du, dv, dw);
+
+                    // Broadcast baseline values.
+                    const V v_uu = VEC::set1(uu), v_vv = VEC::set1(vv);
+                    const V v_ww = VEC::set1(ww), v_du = VEC::set1(du);
+                    const V v_dv = VEC::set1(dv), v_dw = VEC::set1(dw);
+                    const V v_uu2 = VEC::set1(uu2), v_vv2 = VEC::set1(vv2);
+                    const V v_uuvv = VEC::set1(uuvv);
+                    const V v_filter_min = VEC::set1(source_filter_min);
+                    const V v_filter_max = VEC::set1(source_filter_max);
+                    const V zero = VEC::set1(0), one = VEC::set1(1);
+
+                    // Clear the accumulators.
+                    for (size_t i = 0; i < num_acc; ++i)
+                        sum[i] = guard[i] = (REAL) 0;
+
+                    // Loop over sources in the block, one vector at a time.
+                    for (int i = i_start; i < i_end; i += W)
+                    {
+                        V k[2], k_inc[2], s_time[2], s_time_inc[2];
+                        V smearing = one, gaussian = zero, t_time = zero;
+                        k_inc[0] = s_time_inc[0] = one;
+                        k_inc[1] = s_time_inc[1] = s_time[0] = s_time[1] = zero;
+                        const int n_lanes = (i_end - i < W) ? i_end - i : W;
+                        const size_t j = i - i_start;
+                        const M valid = VEC::cmp_lt(VEC::load(lane_index),
+                                VEC::set1((REAL) n_lanes));
+                        const V l = oskar_simd_load<VEC>(&source_l[i], n_lanes);
+                        const V m = oskar_simd_load<VEC>(&source_m[i], n_lanes);
+                        const V n = VEC::sub(oskar_simd_load<VEC>(
+                                &source_n[i], n_lanes), one);
+
+                        // Bandwidth smearing does not depend on frequency.
+                        if (BANDWIDTH_SMEARING)
+                        {
+                            const V t = VEC::fmadd(v_uu, l,
+                                    VEC::fmadd(v_vv, m, VEC::mul(v_ww, n)));
+                            smearing = oskar_simd_sinc<VEC>(t);
+                        }
+                        if (GAUSSIAN)
+                        {
+                            const V a =
+                                    oskar_simd_load<VEC>(&source_a[i], n_lanes);
+                            const V b =
+                                    oskar_simd_load<VEC>(&source_b[i], n_lanes);
+                            const V cc =
+                                    oskar_simd_load<VEC>(&source_c[i], n_lanes);
+                            gaussian = VEC::fmadd(a, v_uu2,
+                                    VEC::fmadd(b, v_uuvv, VEC::mul(cc, v_vv2)));
+                        }
+
+                        // Form the interferometer phase for the first channel,
+                        // and the rotation between channels, from the station
+                        // phase factors.
+                        OSKAR_SIMD_MUL_CONJ(VEC, k[0], k[1],
+                                VEC::load(&phase_re[op + j]),
+                                VEC::load(&phase_im[op + j]),
+                                VEC::load(&phase_re[oq + j]),
+                                VEC::load(&phase_im[oq + j]))
+                        if (num_channels > 1)
+                            OSKAR_SIMD_MUL_CONJ(VEC, k_inc[0], k_inc[1],
+                                    VEC::load(&phase_inc_re[op + j]),
+                                    VEC::load(&phase_inc_im[op + j]),
+                                    VEC::load(&phase_inc_re[oq + j]),
+                                    VEC::load(&phase_inc_im[oq + j]))
+
+                        // The time-smearing argument is linear in frequency,
+                        // so its sine is stepped between channels in the same
+                        // way.
+                        if (TIME_SMEARING)
+                        {
+                            t_time = VEC::fmadd(v_du, l,
+                                    VEC::fmadd(v_dv, m, VEC::mul(v_dw, n)));
+                            VEC::sincos(t_time, s_time[1], s_time[0]);
+                            if (num_channels > 1)
+                                VEC::sincos(VEC::mul(t_time,
+                                        VEC::set1(inv_wavelength_ratio)),
+                                        s_time_inc[1], s_time_inc[0]);
+                        }
+
+                        // Loop over channels.
+                        for (c = 0; c < num_channels; ++c)
+                        {
+                            V p[8], q[8], t[8], kf[2];
+                            const int f = c * flux_stride + i;
+                            const V I =
+                                    oskar_simd_load<VEC>(&source_I[f], n_lanes);
+                            const V Q =
+                                    oskar_simd_load<VEC>(&source_Q[f], n_lanes);
+                            const V U =
+                                    oskar_simd_load<VEC>(&source_U[f], n_lanes);
+                            const V VV =
+                                    oskar_simd_load<VEC>(&source_V[f], n_lanes);
+
+                            // Apply the source flux filter, and the smearing
+                            // terms.
+                            const M use = VEC::mask_and(valid, VEC::mask_and(
+                                    VEC::cmp_lt(v_filter_min, I),
+                                    VEC::cmp_le(I, v_filter_max)));
+                            V factor = smearing;
+                            if (GAUSSIAN || TIME_SMEARING)
+                            {
+                                const V r = VEC::set1(
+                                        (REAL) 1 + c * inv_wavelength_ratio);
+                                if (GAUSSIAN)
+                                    factor = VEC::mul(factor, VEC::exp(
+                                            VEC::sub(zero, VEC::mul(gaussian,
+                                            VEC::mul(r, r)))));
+                                if (TIME_SMEARING)
+                                {
+                                    const V tt = VEC::mul(t_time, r);
+                                    factor = VEC::mul(factor, VEC::select(
+                                            VEC::cmp_eq(tt, zero), one,
+                                            VEC::div(s_time[1], tt)));
+                                }
+                            }
+                            factor = VEC::select(use, factor, zero);
+                            kf[0] = VEC::mul(k[0], factor);
+                            kf[1] = VEC::mul(k[1], factor);
+
+                            // Load Jones matrices for this channel.
+                            const REAL* jp = &station_p[c * channel_stride + i];
+                            const REAL* jq = &station_q[c * channel_stride + i];
+                            for (int e = 0; e < 8; ++e)
+                            {
+                                p[e] = oskar_simd_load<VEC>(
+                                        jp + e * jones_stride, n_lanes);
+                                q[e] = oskar_simd_load<VEC>(
+                                        jq + e * jones_stride, n_lanes);
+                            }
+
+                            // Multiply first Jones matrix with source
+                            // brightness matrix (I + Q, U + iV; U - iV, I - Q).
+                            const V b_a = VEC::add(I, Q), b_d = VEC::sub(I, Q);
+                            t[0] = VEC::fmadd(p[0], b_a,
+                                    VEC::fmadd(p[2], U, VEC::mul(p[3], VV)));
+                            t[1] = VEC::fmadd(p[1], b_a,
+                                    VEC::fnmadd(p[2], VV, VEC::mul(p[3], U)));
+                            t[2] = VEC::fmadd(p[2], b_d,
+                                    VEC::fnmadd(p[1], VV, VEC::mul(p[0], U)));
+                            t[3] = VEC::fmadd(p[3], b_d,
+                                    VEC::fmadd(p[0], VV, VEC::mul(p[1], U)));
+                            t[4] = VEC::fmadd(p[4], b_a,
+                                    VEC::fmadd(p[6], U, VEC::mul(p[7], VV)));
+                            t[5] = VEC::fmadd(p[5], b_a,
+                                    VEC::fnmadd(p[6], VV, VEC::mul(p[7], U)));
+                            t[6] = VEC::fmadd(p[6], b_d,
+                                    VEC::fnmadd(p[5], VV, VEC::mul(p[4], U)));
+                            t[7] = VEC::fmadd(p[7], b_d,
+                                    VEC::fmadd(p[4], VV, VEC::mul(p[5], U)));
+
+                            // Multiply by phase and smearing terms.
+                            for (int e = 0; e < 8; e += 2)
+                            {
+                                const V x = t[e];
+                                t[e] = VEC::fnmadd(t[e + 1], kf[1],
+                                        VEC::mul(x, kf[0]));
+                                t[e + 1] = VEC::fmadd(t[e + 1], kf[0],
+                                        VEC::mul(x, kf[1]));
+                            }
+
+                            // Multiply result with second (Hermitian
+                            // transposed) Jones matrix, and accumulate.
+                            V out[8];
+                            OSKAR_SIMD_MUL_CONJ_ADD(VEC, out[0], out[1],
+                                    (t + 0), (q + 0), (t + 2), (q + 2))
+                            OSKAR_SIMD_MUL_CONJ_ADD(VEC, out[2], out[3],
+                                    (t + 0), (q + 4), (t + 2), (q + 6))
+                            OSKAR_SIMD_MUL_CONJ_ADD(VEC, out[4], out[5],
+                                    (t + 4), (q + 0), (t + 6), (q + 2))
+                            OSKAR_SIMD_MUL_CONJ_ADD(VEC, out[6], out[7],
+                                    (t + 4), (q + 4), (t + 6), (q + 6))
+                            REAL* s = &sum[8 * c * W];
+                            REAL* g = &guard[8 * c * W];
+                            for (int e = 0; e < 8; ++e)
+                                oskar_simd_accumulate<VEC>(
+                                        s + e * W, g + e * W, out[e]);
+
+                            // Rotate phase terms to the next channel.
+                            if (c < num_channels - 1)
+                            {
+                                V x = k[0];
+                                k[0] = VEC::fnmadd(k[1], k_inc[1],
+                                        VEC::mul(x, k_inc[0]));
+                                k[1] = VEC::fmadd(k[1], k_inc[0],
+                                        VEC::mul(x, k_inc[1]));
+                                if (TIME_SMEARING)
+                                {
+                                    x = s_time[0];
+                                    s_time[0] = VEC::fnmadd(s_time[1],
+                                            s_time_inc[1],
+                                            VEC::mul(x, s_time_inc[0]));
+                                    s_time[1] = VEC::fmadd(s_time[1],
+                                            s_time_inc[0],
+                                            VEC::mul(x, s_time_inc[1]));
+                                }
+                            }
+                        }
+                    }
+
+                    // Add results to the baseline visibilities for each
+                    // channel.
+                    const int b = offset_out +
+                            OSKAR_BASELINE_INDEX(num_stations, SP, SQ);
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        REAL r[8];
+                        const REAL t = uv_filter_in_metres ? uv_len :
+                                uv_len * ((REAL) 1 + c * inv_wavelength_ratio);
+                        if (t < uv_min_lambda || t > uv_max_lambda) continue;
+                        for (int e = 0; e < 8; ++e)
+                        {
+                            const size_t j = (8 * c + e) * W;
+                            r[e] = VEC::reduce_add(VEC::sub(
+                                    VEC::load(&sum[j]), VEC::load(&guard[j])));
+                        }
+                        // Access the output as an array of reals: the vector
+                        // types are over-aligned compared with the memory
+                        // allocator, so must not be loaded or stored directly.
+                        REAL* out = (REAL*) vis +
+                                8 * ((size_t) b + c * num_baselines);
+                        for (int e = 0; e < 8; ++e) out[e] += r[e];
+                    }
+                }
+            }
+        }
+    }
+    delete [] acc_mem;
+    }
+    delete [] phase_mem;
+    delete [] tiles;
+}
+
+#define OSKAR_XCORR_FUSED_SIMD_KERNEL(BS, TS, GAUSSIAN, VEC, REAL4c)        \
+        oskar_xcorr_fused_simd<BS, TS, GAUSSIAN, VEC, REAL4c>               \
+        (num_sources, num_stations, num_channels, offset_out,               \
+                station_tile, source_tile,                                  \
+                jones, jones_stride, I, Q, U, V, flux_stride,               \
+                l, m, n, a, b, c, station_u, station_v, station_w,          \
+                station_x, station_y, uv_min_lambda, uv_max_lambda,         \
+                uv_filter_in_metres, inv_wavelength, inv_wavelength_inc,    \
+                frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,           \
+                source_filter_min, source_filter_max,                       \
+                ignore_w_components, vis);
+
+#define OSKAR_XCORR_FUSED_SIMD_SELECT(GAUSSIAN, VEC, REAL4c)                \
+        if (frac_bandwidth == 0 && time_int_sec == 0)                       \
+            OSKAR_XCORR_FUSED_SIMD_KERNEL(false, false, GAUSSIAN, VEC, REAL4c) \
+        else if (frac_bandwidth != 0 && time_int_sec == 0)                  \
+            OSKAR_XCORR_FUSED_SIMD_KERNEL(true, false, GAUSSIAN, VEC, REAL4c)  \
+        else if (frac_bandwidth == 0 && time_int_sec != 0)                  \
+            OSKAR_XCORR_FUSED_SIMD_KERNEL(false, true, GAUSSIAN, VEC, REAL4c)  \
+        else if (frac_bandwidth != 0 && time_int_sec != 0)                  \
+            OSKAR_XCORR_FUSED_SIMD_KERNEL(true, true, GAUSSIAN, VEC, REAL4c)
+
+/* Defines the entry point for one instruction set and precision. */
+#define OSKAR_XCORR_FUSED_SIMD_DEFINE(NAME, VEC, FP, FP4c)                  \
+void NAME(int use_extended, int num_sources, int num_stations,              \
+        int num_channels, int offset_out,                                   \
+        int station_tile, int source_tile,                                  \
+        const FP* jones, int jones_stride,                                  \
+        const FP* I, const FP* Q, const FP* U, const FP* V,                 \
+        int flux_stride, const FP* l, const FP* m, const FP* n,             \
+        const FP* a, const FP* b, const FP* c,                              \
+        const FP* station_u, const FP* station_v, const FP* station_w,      \
+        const FP* station_x, const FP* station_y,                           \
+        FP uv_min_lambda, FP uv_max_lambda, int uv_filter_in_metres,        \
+        FP inv_wavelength, FP inv_wavelength_inc, FP frac_bandwidth,        \
+        FP time_int_sec, FP gha0_rad, FP dec0_rad,                          \
+        FP source_filter_min, FP source_filter_max,                         \
+        int ignore_w_components, FP4c* vis)                                 \
+{                                                                           \
+    if (use_extended)                                                       \
+    {                                                                       \
+        OSKAR_XCORR_FUSED_SIMD_SELECT(true, VEC, FP4c)                      \
+    }                                                                       \
+    else                                                                    \
+    {                                                                       \
+        OSKAR_XCORR_FUSED_SIMD_SELECT(false, VEC, FP4c)                     \
+    }                                                                       \
+}
+
+#endif /* include guard */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_FUSED_H_
+#define OSKAR_CROSS_CORRELATE_FUSED_H_
+
+/**
+ * @file oskar_cross_correlate_fused.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/oskar_telescope.h>
+#include <interferometer/oskar_jones.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Forms visibilities using Jones matrices that exclude the interferometer
+ * phase, which is evaluated on-the-fly for each station.
+ *
+ * @details
+ * This function produces the same result as calling
+ * oskar_evaluate_jones_K(), joining the result with the supplied Jones
+ * matrices using oskar_jones_join(), and then calling
+ * oskar_cross_correlate(); however, the K-Jones scalars are evaluated
+ * inside the correlator for each station and a block of sources at a time,
+ * so neither the full set of them nor the joined Jones matrices need to
+ * be stored.
+ *
+ * The Jones matrices should have dimensions corresponding to the number of
+ * sources in the brightness matrix and the number of stations.
+ *
+ * Sources are only included if their Stokes I value is greater than
+ * \p source_filter_min and less than or equal to \p source_filter_max.
+ *
+ * This is currently only available for data in CPU memory.
+ *
+ * @param[in]  source_type    Source type (0 = point, 1 = Gaussian).
+ * @param[in]  num_sources    Number of sources to use.
+ * @param[in]  jones          Set of Jones matrices, excluding K-Jones.
+ * @param[in]  src_flux[4]    Vectors of source Stokes (I, Q, U, V) values.
+ * @param[in]  src_dir[3]     Vectors of source direction cosines.
+ * @param[in]  src_ext[3]     Vectors of extended source parameters.
+ * @param[in]  source_filter_min   Minimum allowed source Stokes I, in Jy.
+ * @param[in]  source_filter_max   Maximum allowed source Stokes I, in Jy.
+ * @param[in]  ignore_w_components If set, ignore w in the phase term.
+ * @param[in]  tel            Telescope model.
+ * @param[in]  station_uvw[3] Station (u, v, w) coordinates, in metres.
+ * @param[in]  gast           Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_hz   Current observation frequency, in Hz.
+ * @param[in]  offset_out     Output visibility start offset.
+ * @param[out] vis            Output visibility amplitudes.
+ * @param[in,out] status      Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused(
+        int source_type,
+        int num_sources,
+        const oskar_Jones* jones,
+        const oskar_Mem* const src_flux[4],
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status);
+
+/**
+ * @brief
+ * Forms visibilities for a set of channels in one pass over the sources,
+ * evaluating the interferometer phase on-the-fly for each station.
+ *
+ * @details
+ * This is a multi-channel version of oskar_cross_correlate_fused().
+ * The interferometer phase is evaluated for the first channel, and then
+ * rotated by the phase increment between channels, so only one sincos
+ * is needed per station and source for all channels.
+ *
+ * The input Jones matrices (excluding K-Jones) must be ordered with channel
+ * as the fastest-varying dimension, then source, then station.
+ * The source flux values must similarly be ordered with channel as the
+ * fastest-varying dimension, followed by source.
+ * The channel frequencies must be equally spaced, and the output
+ * visibilities for consecutive channels are assumed to be separated by
+ * the number of baselines.
+ *
+ * This is currently only available for data in CPU memory.
+ *
+ * @param[in]  source_type    Source type (0 = point, 1 = Gaussian).
+ * @param[in]  num_sources    Number of sources to use.
+ * @param[in]  num_channels   Number of channels to use.
+ * @param[in]  jones          Jones matrices for all channels, excluding K.
+ * @param[in]  src_flux[4]    Source Stokes (I, Q, U, V) values per channel.
+ * @param[in]  src_dir[3]     Vectors of source direction cosines.
+ * @param[in]  src_ext[3]     Vectors of extended source parameters.
+ * @param[in]  source_filter_min   Minimum allowed source Stokes I, in Jy.
+ * @param[in]  source_filter_max   Maximum allowed source Stokes I, in Jy.
+ * @param[in]  ignore_w_components If set, ignore w in the phase term.
+ * @param[in]  tel            Telescope model.
+ * @param[in]  station_uvw[3] Station (u, v, w) coordinates, in metres.
+ * @param[in]  gast           Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_start_hz Frequency of the first channel, in Hz.
+ * @param[in]  frequency_inc_hz   Frequency increment between channels, in Hz.
+ * @param[in]  offset_out     Output visibility start offset.
+ * @param[out] vis            Output visibility amplitudes.
+ * @param[in,out] status      Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused_channels(
+        int source_type,
+        int num_sources,
+        int num_channels,
+        const oskar_Mem* jones,
+        const oskar_Mem* const src_flux[4],
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_start_hz,
+        double frequency_inc_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status);
+
+/**
+ * @brief
+ * Forms visibilities for a set of channels using a vectorised correlator,
+ * with Jones matrices held as structure-of-arrays.
+ *
+ * @details
+ * This produces the same result as oskar_cross_correlate_fused_channels(),
+ * but the Jones matrices are held as 8 real-valued arrays for each station
+ * and channel, each of length \p jones_stride, with dimension order
+ * [station][channel][element][source] (see oskar_jones_soa.h).
+ * For a single channel, the array returned by oskar_jones_soa_const()
+ * can be used directly, with the stride given by oskar_jones_soa_stride().
+ *
+ * The source flux values must be ordered with source as the
+ * fastest-varying dimension, and consecutive channels must be
+ * \p flux_stride elements apart.
+ *
+ * The correlator uses the best SIMD instruction set available at run time,
+ * as returned by oskar_cross_correlate_simd_isa().
+ * Only polarised (matrix) visibilities are supported.
+ *
+ * This is currently only available for data in CPU memory.
+ *
+ * @param[in]  source_type    Source type (0 = point, 1 = Gaussian).
+ * @param[in]  num_sources    Number of sources to use.
+ * @param[in]  num_channels   Number of channels to use.
+ * @param[in]  jones          Structure-of-arrays Jones matrices, excluding K.
+ * @param[in]  jones_stride   Number of elements in each Jones array.
+ * @param[in]  src_flux[4]    Source Stokes (I, Q, U, V) values per channel.
+ * @param[in]  flux_stride    Channel stride of the source flux values.
+ * @param[in]  src_dir[3]     Vectors of source direction cosines.
+ * @param[in]  src_ext[3]     Vectors of extended source parameters.
+ * @param[in]  source_filter_min   Minimum allowed source Stokes I, in Jy.
+ * @param[in]  source_filter_max   Maximum allowed source Stokes I, in Jy.
+ * @param[in]  ignore_w_components If set, ignore w in the phase term.
+ * @param[in]  tel            Telescope model.
+ * @param[in]  station_uvw[3] Station (u, v, w) coordinates, in metres.
+ * @param[in]  gast           Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_start_hz Frequency of the first channel, in Hz.
+ * @param[in]  frequency_inc_hz   Frequency increment between channels, in Hz.
+ * @param[in]  offset_out     Output visibility start offset.
+ * @param[out] vis            Output visibility amplitudes.
+ * @param[in,out] status      Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused_soa(
+        int source_type,
+        int num_sources,
+        int num_channels,
+        const oskar_Mem* jones,
+        int jones_stride,
+        const oskar_Mem* const src_flux[4],
+        int flux_stride,
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_start_hz,
+        double frequency_inc_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
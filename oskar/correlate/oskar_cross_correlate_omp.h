@@ -244,6 +244,287 @@ void oskar_cross_correlate_gaussian_omp_d(
         double inv_wavelength, double frac_bandwidth, double time_int_sec,
         double gha0_rad, double dec0_rad, double4c* vis);
 
+/**
+ * @brief
+ * Correlate function with fused interferometer phase (single precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones matrices for pairs
+ * of stations and summing along the source dimension.
+ *
+ * Unlike the other correlate functions, the supplied Jones matrices must
+ * not include the interferometer phase (K-Jones) term: instead, this is
+ * evaluated for each station over a block of sources at a time, so that
+ * the full set of K-Jones scalars and their product with the other Jones
+ * terms never need to be stored.
+ *
+ * Sources with Stokes I values outside the range of the source filter are
+ * not included in the sum.
+ *
+ * Visibilities for \p num_channels channels, equally spaced in frequency,
+ * are formed in a single pass over the sources: the phase term is
+ * evaluated once for the first channel and then rotated between channels.
+ * The Jones matrices must be ordered with channel as the fastest-varying
+ * dimension, then source, then station; the source flux values must be
+ * ordered with channel as the fastest-varying dimension. Output
+ * visibilities for consecutive channels are separated by the number of
+ * baselines.
+ *
+ * If \p station_tile is positive, baselines are processed in tiles formed
+ * from pairs of blocks of \p station_tile stations, so that the Jones
+ * matrices for each block of \p source_tile sources are re-used from
+ * cache; otherwise, the baselines for each station are processed in turn.
+ * If \p source_tile is not positive, a default block size is used.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] num_channels   Number of channels.
+ * @param[in] offset_out     Output visibility start offset.
+ * @param[in] station_tile   Number of stations in each block, or 0.
+ * @param[in] source_tile    Number of sources in each block, or 0.
+ * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] I              Source Stokes I values, in Jy.
+ * @param[in] Q              Source Stokes Q values, in Jy.
+ * @param[in] U              Source Stokes U values, in Jy.
+ * @param[in] V              Source Stokes V values, in Jy.
+ * @param[in] l              Source l-direction cosines from phase centre.
+ * @param[in] m              Source m-direction cosines from phase centre.
+ * @param[in] n              Source n-direction cosines from phase centre.
+ * @param[in] a              Source Gaussian parameter a.
+ * @param[in] b              Source Gaussian parameter b.
+ * @param[in] c              Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length at first channel.
+ * @param[in] uv_max_lambda  Maximum allowed UV length at first channel.
+ * @param[in] uv_filter_in_metres If set, UV filter is fixed in metres.
+ * @param[in] inv_wavelength Inverse of the wavelength at the first channel.
+ * @param[in] inv_wavelength_inc Increment in inverse wavelength per channel.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency of first channel.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_filter_min Minimum allowed source Stokes I value, in Jy.
+ * @param[in] source_filter_max Maximum allowed source Stokes I value, in Jy.
+ * @param[in] ignore_w_components If set, ignore w in the phase term.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused_omp_f(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const float4c* jones, const float* I, const float* Q,
+        const float* U, const float* V,
+        const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        int uv_filter_in_metres, float inv_wavelength, float inv_wavelength_inc,
+        float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* vis);
+
+/**
+ * @brief
+ * Correlate function with fused interferometer phase (double precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones matrices for pairs
+ * of stations and summing along the source dimension.
+ *
+ * Unlike the other correlate functions, the supplied Jones matrices must
+ * not include the interferometer phase (K-Jones) term: instead, this is
+ * evaluated for each station over a block of sources at a time, so that
+ * the full set of K-Jones scalars and their product with the other Jones
+ * terms never need to be stored.
+ *
+ * Sources with Stokes I values outside the range of the source filter are
+ * not included in the sum.
+ *
+ * Visibilities for \p num_channels channels, equally spaced in frequency,
+ * are formed in a single pass over the sources: the phase term is
+ * evaluated once for the first channel and then rotated between channels.
+ * The Jones matrices must be ordered with channel as the fastest-varying
+ * dimension, then source, then station; the source flux values must be
+ * ordered with channel as the fastest-varying dimension. Output
+ * visibilities for consecutive channels are separated by the number of
+ * baselines.
+ *
+ * If \p station_tile is positive, baselines are processed in tiles formed
+ * from pairs of blocks of \p station_tile stations, so that the Jones
+ * matrices for each block of \p source_tile sources are re-used from
+ * cache; otherwise, the baselines for each station are processed in turn.
+ * If \p source_tile is not positive, a default block size is used.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] num_channels   Number of channels.
+ * @param[in] offset_out     Output visibility start offset.
+ * @param[in] station_tile   Number of stations in each block, or 0.
+ * @param[in] source_tile    Number of sources in each block, or 0.
+ * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] I              Source Stokes I values, in Jy.
+ * @param[in] Q              Source Stokes Q values, in Jy.
+ * @param[in] U              Source Stokes U values, in Jy.
+ * @param[in] V              Source Stokes V values, in Jy.
+ * @param[in] l              Source l-direction cosines from phase centre.
+ * @param[in] m              Source m-direction cosines from phase centre.
+ * @param[in] n              Source n-direction cosines from phase centre.
+ * @param[in] a              Source Gaussian parameter a.
+ * @param[in] b              Source Gaussian parameter b.
+ * @param[in] c              Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length at first channel.
+ * @param[in] uv_max_lambda  Maximum allowed UV length at first channel.
+ * @param[in] uv_filter_in_metres If set, UV filter is fixed in metres.
+ * @param[in] inv_wavelength Inverse of the wavelength at the first channel.
+ * @param[in] inv_wavelength_inc Increment in inverse wavelength per channel.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency of first channel.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_filter_min Minimum allowed source Stokes I value, in Jy.
+ * @param[in] source_filter_max Maximum allowed source Stokes I value, in Jy.
+ * @param[in] ignore_w_components If set, ignore w in the phase term.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused_omp_d(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const double4c* jones, const double* I, const double* Q,
+        const double* U, const double* V,
+        const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        int uv_filter_in_metres, double inv_wavelength, double inv_wavelength_inc,
+        double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* vis);
+
+/**
+ * @brief
+ * Returns the tile sizes to use for the cache-blocked correlator.
+ *
+ * @details
+ * Tile sizes that are zero or negative on input are replaced by values
+ * chosen automatically, so that the Jones matrices for a pair of station
+ * blocks fit comfortably within the per-core cache.
+ * All tile sizes are clamped to the number of stations or sources.
+ *
+ * @param[in] num_sources       Number of sources.
+ * @param[in] num_stations      Number of stations.
+ * @param[in] element_size      Size of each Jones matrix, in bytes.
+ * @param[in,out] station_tile  Number of stations in each block.
+ * @param[in,out] source_tile   Number of sources in each block.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_tile_size(int num_sources, int num_stations,
+        int element_size, int* station_tile, int* source_tile);
+
+/**
+ * @brief
+ * Cache-blocked correlate function (single precision).
+ *
+ * @details
+ * This produces the same visibilities as
+ * oskar_cross_correlate_point_omp_f() or
+ * oskar_cross_correlate_gaussian_omp_f(), but the baselines are processed
+ * in tiles formed from pairs of station blocks, and the sources in blocks,
+ * so that the Jones matrices used by each tile are re-used from cache
+ * rather than being reloaded from memory for every baseline.
+ * Tiles are distributed between threads, and each thread accumulates the
+ * visibilities for its tile privately before adding them to the output.
+ *
+ * Tile sizes that are zero or negative are chosen automatically
+ * (see oskar_cross_correlate_tile_size()).
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] offset_out     Output visibility start offset.
+ * @param[in] station_tile   Number of stations in each block.
+ * @param[in] source_tile    Number of sources in each block.
+ * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] I              Source Stokes I values, in Jy.
+ * @param[in] Q              Source Stokes Q values, in Jy.
+ * @param[in] U              Source Stokes U values, in Jy.
+ * @param[in] V              Source Stokes V values, in Jy.
+ * @param[in] l              Source l-direction cosines from phase centre.
+ * @param[in] m              Source m-direction cosines from phase centre.
+ * @param[in] n              Source n-direction cosines from phase centre.
+ * @param[in] a              Source Gaussian parameter a.
+ * @param[in] b              Source Gaussian parameter b.
+ * @param[in] c              Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_tiled_omp_f(
+        int use_extended, int num_sources, int num_stations, int offset_out,
+        int station_tile, int source_tile,
+        const float4c* jones, const float* I, const float* Q,
+        const float* U, const float* V,
+        const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float4c* vis);
+
+/**
+ * @brief
+ * Cache-blocked correlate function (double precision).
+ *
+ * @details
+ * See oskar_cross_correlate_tiled_omp_f().
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_tiled_omp_d(
+        int use_extended, int num_sources, int num_stations, int offset_out,
+        int station_tile, int source_tile,
+        const double4c* jones, const double* I, const double* Q,
+        const double* U, const double* V,
+        const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* vis);
+
 #ifdef __cplusplus
 }
 #endif
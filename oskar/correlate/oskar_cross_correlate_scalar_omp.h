@@ -228,6 +228,178 @@ void oskar_cross_correlate_scalar_gaussian_omp_d(
         double frac_bandwidth, double time_int_sec, double gha0_rad,
         double dec0_rad, double2* vis);
 
+/**
+ * @brief
+ * Correlate function with fused interferometer phase, scalar version
+ * (single precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones scalars for pairs
+ * of stations and summing along the source dimension.
+ *
+ * Unlike the other correlate functions, the supplied Jones scalars must
+ * not include the interferometer phase (K-Jones) term: instead, this is
+ * evaluated for each station over a block of sources at a time, so that
+ * the full set of K-Jones scalars and their product with the other Jones
+ * terms never need to be stored.
+ *
+ * Sources with Stokes I values outside the range of the source filter are
+ * not included in the sum.
+ *
+ * Visibilities for \p num_channels channels, equally spaced in frequency,
+ * are formed in a single pass over the sources: the phase term is
+ * evaluated once for the first channel and then rotated between channels.
+ * The Jones scalars must be ordered with channel as the fastest-varying
+ * dimension, then source, then station; the source flux values must be
+ * ordered with channel as the fastest-varying dimension. Output
+ * visibilities for consecutive channels are separated by the number of
+ * baselines.
+ *
+ * If \p station_tile is positive, baselines are processed in tiles formed
+ * from pairs of blocks of \p station_tile stations, so that the Jones
+ * matrices for each block of \p source_tile sources are re-used from
+ * cache; otherwise, the baselines for each station are processed in turn.
+ * If \p source_tile is not positive, a default block size is used.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] num_channels   Number of channels.
+ * @param[in] offset_out     Output visibility start offset.
+ * @param[in] station_tile   Number of stations in each block, or 0.
+ * @param[in] source_tile    Number of sources in each block, or 0.
+ * @param[in] jones          Matrix of Jones scalars to correlate.
+ * @param[in] I              Source Stokes I values, in Jy.
+ * @param[in] l              Source l-direction cosines from phase centre.
+ * @param[in] m              Source m-direction cosines from phase centre.
+ * @param[in] n              Source n-direction cosines from phase centre.
+ * @param[in] a              Source Gaussian parameter a.
+ * @param[in] b              Source Gaussian parameter b.
+ * @param[in] c              Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length at first channel.
+ * @param[in] uv_max_lambda  Maximum allowed UV length at first channel.
+ * @param[in] uv_filter_in_metres If set, UV filter is fixed in metres.
+ * @param[in] inv_wavelength Inverse of the wavelength at the first channel.
+ * @param[in] inv_wavelength_inc Increment in inverse wavelength per channel.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency of first channel.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_filter_min Minimum allowed source Stokes I value, in Jy.
+ * @param[in] source_filter_max Maximum allowed source Stokes I value, in Jy.
+ * @param[in] ignore_w_components If set, ignore w in the phase term.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_scalar_fused_omp_f(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const float2* jones, const float* I, const float* l,
+        const float* m, const float* n,
+        const float* a, const float* b,
+        const float* c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, int uv_filter_in_metres,
+        float inv_wavelength, float inv_wavelength_inc,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float source_filter_min, float source_filter_max,
+        int ignore_w_components, float2* vis);
+
+/**
+ * @brief
+ * Correlate function with fused interferometer phase, scalar version
+ * (double precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones scalars for pairs
+ * of stations and summing along the source dimension.
+ *
+ * Unlike the other correlate functions, the supplied Jones scalars must
+ * not include the interferometer phase (K-Jones) term: instead, this is
+ * evaluated for each station over a block of sources at a time, so that
+ * the full set of K-Jones scalars and their product with the other Jones
+ * terms never need to be stored.
+ *
+ * Sources with Stokes I values outside the range of the source filter are
+ * not included in the sum.
+ *
+ * Visibilities for \p num_channels channels, equally spaced in frequency,
+ * are formed in a single pass over the sources: the phase term is
+ * evaluated once for the first channel and then rotated between channels.
+ * The Jones scalars must be ordered with channel as the fastest-varying
+ * dimension, then source, then station; the source flux values must be
+ * ordered with channel as the fastest-varying dimension. Output
+ * visibilities for consecutive channels are separated by the number of
+ * baselines.
+ *
+ * If \p station_tile is positive, baselines are processed in tiles formed
+ * from pairs of blocks of \p station_tile stations, so that the Jones
+ * matrices for each block of \p source_tile sources are re-used from
+ * cache; otherwise, the baselines for each station are processed in turn.
+ * If \p source_tile is not positive, a default block size is used.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] num_channels   Number of channels.
+ * @param[in] offset_out     Output visibility start offset.
+ * @param[in] station_tile   Number of stations in each block, or 0.
+ * @param[in] source_tile    Number of sources in each block, or 0.
+ * @param[in] jones          Matrix of Jones scalars to correlate.
+ * @param[in] I              Source Stokes I values, in Jy.
+ * @param[in] l              Source l-direction cosines from phase centre.
+ * @param[in] m              Source m-direction cosines from phase centre.
+ * @param[in] n              Source n-direction cosines from phase centre.
+ * @param[in] a              Source Gaussian parameter a.
+ * @param[in] b              Source Gaussian parameter b.
+ * @param[in] c              Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length at first channel.
+ * @param[in] uv_max_lambda  Maximum allowed UV length at first channel.
+ * @param[in] uv_filter_in_metres If set, UV filter is fixed in metres.
+ * @param[in] inv_wavelength Inverse of the wavelength at the first channel.
+ * @param[in] inv_wavelength_inc Increment in inverse wavelength per channel.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency of first channel.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_filter_min Minimum allowed source Stokes I value, in Jy.
+ * @param[in] source_filter_max Maximum allowed source Stokes I value, in Jy.
+ * @param[in] ignore_w_components If set, ignore w in the phase term.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_scalar_fused_omp_d(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const double2* jones, const double* I, const double* l,
+        const double* m, const double* n,
+        const double* a, const double* b,
+        const double* c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, int uv_filter_in_metres,
+        double inv_wavelength, double inv_wavelength_inc,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double source_filter_min, double source_filter_max,
+        int ignore_w_components, double2* vis);
+
 #ifdef __cplusplus
 }
 #endif
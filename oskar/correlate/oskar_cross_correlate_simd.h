@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_SIMD_H_
+#define OSKAR_CROSS_CORRELATE_SIMD_H_
+
+/**
+ * @file oskar_cross_correlate_simd.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum OSKAR_SIMD_ISA
+{
+    OSKAR_SIMD_NONE,
+    OSKAR_SIMD_AVX2,
+    OSKAR_SIMD_AVX512
+};
+
+/**
+ * @brief
+ * Returns the best instruction set available for the vectorised correlator.
+ *
+ * @details
+ * Returns the best instruction set supported by both the build and the
+ * processor at run time, as an enumerated OSKAR_SIMD_ISA value.
+ *
+ * @return The instruction set to use.
+ */
+OSKAR_EXPORT
+int oskar_cross_correlate_simd_isa(void);
+
+/**
+ * @brief
+ * Returns a string describing the enumerated instruction set.
+ *
+ * @param[in] isa  Enumerated OSKAR_SIMD_ISA value.
+ */
+OSKAR_EXPORT
+const char* oskar_cross_correlate_simd_isa_name(int isa);
+
+/**
+ * @brief
+ * Vectorised fused cross-correlation function for Jones matrices held
+ * as structure-of-arrays (single precision).
+ *
+ * @details
+ * This produces the same result as oskar_cross_correlate_fused_omp_f(),
+ * but the Jones matrices are held as 8 arrays of real values per station
+ * and channel (see oskar_jones_soa.h), each of length \p jones_stride,
+ * with dimension order [station][channel][element][source].
+ * Source fluxes have dimension order [channel][source], where
+ * consecutive channels are \p flux_stride elements apart.
+ *
+ * Baselines and sources are processed in blocks as described for
+ * oskar_cross_correlate_fused_omp_f().
+ *
+ * The requested instruction set is used if it is available at run time;
+ * otherwise, the best one available is used instead. If no vector
+ * instructions are available, a scalar version is used.
+ *
+ * @param[in] isa                 Enumerated OSKAR_SIMD_ISA value to use.
+ * @param[in] use_extended        If true, use extended sources.
+ * @param[in] num_sources         Number of sources.
+ * @param[in] num_stations        Number of stations.
+ * @param[in] num_channels        Number of channels.
+ * @param[in] offset_out          Output visibility start offset.
+ * @param[in] station_tile        Number of stations in each block, or 0.
+ * @param[in] source_tile         Number of sources in each block, or 0.
+ * @param[in] jones               Structure-of-arrays Jones matrix data.
+ * @param[in] jones_stride        Number of elements in each Jones array.
+ * @param[in] I                   Source Stokes I values, in Jy.
+ * @param[in] Q                   Source Stokes Q values, in Jy.
+ * @param[in] U                   Source Stokes U values, in Jy.
+ * @param[in] V                   Source Stokes V values, in Jy.
+ * @param[in] flux_stride         Channel stride of the source fluxes.
+ * @param[in] l                   Source l-direction cosines.
+ * @param[in] m                   Source m-direction cosines.
+ * @param[in] n                   Source n-direction cosines.
+ * @param[in] a                   Source Gaussian parameter a.
+ * @param[in] b                   Source Gaussian parameter b.
+ * @param[in] c                   Source Gaussian parameter c.
+ * @param[in] station_u           Station u-coordinates, in metres.
+ * @param[in] station_v           Station v-coordinates, in metres.
+ * @param[in] station_w           Station w-coordinates, in metres.
+ * @param[in] station_x           Station x-coordinates, in metres.
+ * @param[in] station_y           Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda       Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda       Maximum allowed UV length, in wavelengths.
+ * @param[in] uv_filter_in_metres If true, the UV range is fixed in metres.
+ * @param[in] inv_wavelength      1/(wavelength) at the first channel.
+ * @param[in] inv_wavelength_inc  Increment in 1/(wavelength) per channel.
+ * @param[in] frac_bandwidth      Bandwidth divided by frequency.
+ * @param[in] time_int_sec        Time averaging interval, in seconds.
+ * @param[in] gha0_rad            Greenwich Hour Angle of phase centre.
+ * @param[in] dec0_rad            Declination of phase centre, in radians.
+ * @param[in] source_filter_min   Minimum allowed source Stokes I, in Jy.
+ * @param[in] source_filter_max   Maximum allowed source Stokes I, in Jy.
+ * @param[in] ignore_w_components If set, ignore w in the phase term.
+ * @param[in,out] vis             Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused_simd_f(int isa, int use_extended,
+        int num_sources, int num_stations, int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const float* jones, int jones_stride,
+        const float* I, const float* Q, const float* U, const float* V,
+        int flux_stride, const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        int uv_filter_in_metres, float inv_wavelength,
+        float inv_wavelength_inc, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* vis);
+
+/**
+ * @brief
+ * Vectorised fused cross-correlation function for Jones matrices held
+ * as structure-of-arrays (double precision).
+ *
+ * @details
+ * See oskar_cross_correlate_fused_simd_f().
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_fused_simd_d(int isa, int use_extended,
+        int num_sources, int num_stations, int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const double* jones, int jones_stride,
+        const double* I, const double* Q, const double* U, const double* V,
+        int flux_stride, const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        int uv_filter_in_metres, double inv_wavelength,
+        double inv_wavelength_inc, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* vis);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
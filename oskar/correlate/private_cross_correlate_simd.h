@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_CROSS_CORRELATE_SIMD_H_
+#define OSKAR_PRIVATE_CROSS_CORRELATE_SIMD_H_
+
+/**
+ * @file private_cross_correlate_simd.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+/* Declares the fused correlator for one instruction set and precision.
+ * The parameters are as for oskar_cross_correlate_fused_simd_f(). */
+#define OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(NAME, FP, FP4c)                    \
+void NAME(int use_extended, int num_sources, int num_stations,              \
+        int num_channels, int offset_out,                                   \
+        int station_tile, int source_tile,                                  \
+        const FP* jones, int jones_stride,                                  \
+        const FP* I, const FP* Q, const FP* U, const FP* V,                 \
+        int flux_stride, const FP* l, const FP* m, const FP* n,             \
+        const FP* a, const FP* b, const FP* c,                              \
+        const FP* station_u, const FP* station_v, const FP* station_w,      \
+        const FP* station_x, const FP* station_y,                           \
+        FP uv_min_lambda, FP uv_max_lambda, int uv_filter_in_metres,        \
+        FP inv_wavelength, FP inv_wavelength_inc, FP frac_bandwidth,        \
+        FP time_int_sec, FP gha0_rad, FP dec0_rad,                          \
+        FP source_filter_min, FP source_filter_max,                         \
+        int ignore_w_components, FP4c* vis);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(
+        oskar_cross_correlate_fused_scalar_f, float, float4c)
+OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(
+        oskar_cross_correlate_fused_scalar_d, double, double4c)
+
+#ifdef OSKAR_HAVE_AVX2
+OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(
+        oskar_cross_correlate_fused_avx2_f, float, float4c)
+OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(
+        oskar_cross_correlate_fused_avx2_d, double, double4c)
+#endif
+
+#ifdef OSKAR_HAVE_AVX512
+OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(
+        oskar_cross_correlate_fused_avx512_f, float, float4c)
+OSKAR_XCORR_FUSED_SIMD_PROTOTYPE(
+        oskar_cross_correlate_fused_avx512_d, double, double4c)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -114,7 +114,66 @@ void oskar_cross_correlate(
     /* Select kernel. */
     if (location == OSKAR_CPU)
     {
-        if (use_extended)
+        const int station_tile = oskar_telescope_correlator_station_tile(tel);
+        const int source_tile = oskar_telescope_correlator_source_tile(tel);
+        const int use_tiled = oskar_telescope_correlator_tiled(tel);
+        if (use_tiled && jones_type == OSKAR_SINGLE_COMPLEX_MATRIX)
+        {
+            oskar_cross_correlate_tiled_omp_f(use_extended,
+                    num_sources, num_stations, offset_out,
+                    station_tile, source_tile,
+                    oskar_mem_float4c_const(J, status),
+                    oskar_mem_float_const(src_flux[0], status),
+                    oskar_mem_float_const(src_flux[1], status),
+                    oskar_mem_float_const(src_flux[2], status),
+                    oskar_mem_float_const(src_flux[3], status),
+                    oskar_mem_float_const(src_dir[0], status),
+                    oskar_mem_float_const(src_dir[1], status),
+                    oskar_mem_float_const(src_dir[2], status),
+                    use_extended ?
+                            oskar_mem_float_const(src_ext[0], status) : 0,
+                    use_extended ?
+                            oskar_mem_float_const(src_ext[1], status) : 0,
+                    use_extended ?
+                            oskar_mem_float_const(src_ext[2], status) : 0,
+                    oskar_mem_float_const(station_uvw[0], status),
+                    oskar_mem_float_const(station_uvw[1], status),
+                    oskar_mem_float_const(station_uvw[2], status),
+                    oskar_mem_float_const(x, status),
+                    oskar_mem_float_const(y, status),
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    oskar_mem_float4c(vis, status));
+        }
+        else if (use_tiled && jones_type == OSKAR_DOUBLE_COMPLEX_MATRIX)
+        {
+            oskar_cross_correlate_tiled_omp_d(use_extended,
+                    num_sources, num_stations, offset_out,
+                    station_tile, source_tile,
+                    oskar_mem_double4c_const(J, status),
+                    oskar_mem_double_const(src_flux[0], status),
+                    oskar_mem_double_const(src_flux[1], status),
+                    oskar_mem_double_const(src_flux[2], status),
+                    oskar_mem_double_const(src_flux[3], status),
+                    oskar_mem_double_const(src_dir[0], status),
+                    oskar_mem_double_const(src_dir[1], status),
+                    oskar_mem_double_const(src_dir[2], status),
+                    use_extended ?
+                            oskar_mem_double_const(src_ext[0], status) : 0,
+                    use_extended ?
+                            oskar_mem_double_const(src_ext[1], status) : 0,
+                    use_extended ?
+                            oskar_mem_double_const(src_ext[2], status) : 0,
+                    oskar_mem_double_const(station_uvw[0], status),
+                    oskar_mem_double_const(station_uvw[1], status),
+                    oskar_mem_double_const(station_uvw[2], status),
+                    oskar_mem_double_const(x, status),
+                    oskar_mem_double_const(y, status),
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    oskar_mem_double4c(vis, status));
+        }
+        else if (use_extended)
         {
             switch (oskar_mem_type(vis))
             {
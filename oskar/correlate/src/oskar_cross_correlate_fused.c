@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "correlate/oskar_cross_correlate_fused.h"
+#include "correlate/oskar_cross_correlate_omp.h"
+#include "correlate/oskar_cross_correlate_scalar_omp.h"
+#include "correlate/oskar_cross_correlate_simd.h"
+
+#include <float.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void cross_correlate_fused(
+        int source_type,
+        int num_sources,
+        int num_channels,
+        const oskar_Mem* J,
+        int jones_stride,
+        const oskar_Mem* const src_flux[4],
+        int flux_stride,
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_hz,
+        double frequency_inc_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status)
+{
+    const oskar_Mem *x, *y;
+    double uv_filter_min, uv_filter_max;
+    double time_avg = 0.0, gha0 = 0.0, dec0 = 0.0;
+    if (*status) return;
+
+    /* Get the data dimensions. */
+    const int num_stations = oskar_telescope_num_stations(tel);
+    const int use_extended = (source_type == 1);
+
+    /* Get bandwidth-smearing terms. */
+    frequency_hz = fabs(frequency_hz);
+    const double inv_wavelength = frequency_hz / 299792458.0;
+    const double inv_wavelength_inc = frequency_inc_hz / 299792458.0;
+    const double channel_bandwidth = oskar_telescope_channel_bandwidth_hz(tel);
+    const double frac_bandwidth = channel_bandwidth / frequency_hz;
+
+    /* Get time-average smearing terms.
+     * Ignore if drift scanning - this will need to be done differently. */
+    if (oskar_telescope_phase_centre_coord_type(tel) != OSKAR_COORDS_AZEL)
+    {
+        time_avg = oskar_telescope_time_average_sec(tel);
+        gha0 = gast - oskar_telescope_phase_centre_longitude_rad(tel);
+        dec0 = oskar_telescope_phase_centre_latitude_rad(tel);
+    }
+
+    /* Get UV filter parameters in wavelengths. */
+    uv_filter_min = oskar_telescope_uv_filter_min(tel);
+    uv_filter_max = oskar_telescope_uv_filter_max(tel);
+    const int uv_filter_in_metres =
+            (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES);
+    if (uv_filter_in_metres)
+    {
+        uv_filter_min *= inv_wavelength;
+        uv_filter_max *= inv_wavelength;
+    }
+    if (uv_filter_max < 0.0 || uv_filter_max > FLT_MAX)
+        uv_filter_max = FLT_MAX;
+
+    /* Check data locations. */
+    const int location = oskar_mem_location(J);
+    if (oskar_telescope_mem_location(tel) != location ||
+            oskar_mem_location(vis) != location ||
+            oskar_mem_location(station_uvw[0]) != location ||
+            oskar_mem_location(station_uvw[1]) != location ||
+            oskar_mem_location(station_uvw[2]) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+
+    /* Check for consistent data types.
+     * Jones matrices held as structure-of-arrays have a real type. */
+    const int base_type = oskar_mem_precision(J);
+    if (oskar_mem_precision(vis) != base_type ||
+            oskar_mem_type(station_uvw[0]) != base_type ||
+            oskar_mem_type(station_uvw[1]) != base_type ||
+            oskar_mem_type(station_uvw[2]) != base_type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (jones_stride > 0)
+    {
+        if (!oskar_mem_is_matrix(vis))
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (oskar_mem_type(J) != base_type)
+        {
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+            return;
+        }
+    }
+    else if (oskar_mem_type(vis) != oskar_mem_type(J))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Check the input dimensions. */
+    const size_t jones_length = (size_t) num_stations * num_channels *
+            (jones_stride > 0 ? 8 * (size_t) jones_stride :
+                    (size_t) num_sources);
+    const size_t flux_length = (flux_stride > 0 ?
+            (size_t) (num_channels - 1) * flux_stride :
+            (size_t) (num_channels - 1) * num_sources) + num_sources;
+    if (oskar_mem_length(J) < jones_length ||
+            oskar_mem_length(src_flux[0]) < flux_length ||
+            (jones_stride > 0 && jones_stride < num_sources) ||
+            (int)oskar_mem_length(station_uvw[0]) != num_stations ||
+            (int)oskar_mem_length(station_uvw[1]) != num_stations ||
+            (int)oskar_mem_length(station_uvw[2]) != num_stations)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Get handles to arrays. */
+    x = oskar_telescope_station_true_offset_ecef_metres_const(tel, 0);
+    y = oskar_telescope_station_true_offset_ecef_metres_const(tel, 1);
+
+    /* Get the tile sizes, if the correlator is cache-blocked.
+     * Each source uses the Jones matrices for all channels at a station,
+     * and the station phase factors. */
+    int station_tile = 0, source_tile = 0;
+    if (oskar_telescope_correlator_tiled(tel))
+    {
+        const int real_size = (int) oskar_mem_element_size(base_type);
+        const int element_size = num_channels *
+                (int) oskar_mem_element_size(oskar_mem_type(vis)) +
+                (num_channels > 1 ? 4 : 2) * real_size;
+        station_tile = oskar_telescope_correlator_station_tile(tel);
+        source_tile = oskar_telescope_correlator_source_tile(tel);
+        oskar_cross_correlate_tile_size(num_sources, num_stations,
+                element_size, &station_tile, &source_tile);
+    }
+
+    /* Select kernel. */
+    if (jones_stride > 0)
+    {
+        const int isa = oskar_cross_correlate_simd_isa();
+        if (base_type == OSKAR_SINGLE)
+            oskar_cross_correlate_fused_simd_f(isa,
+                    use_extended, num_sources, num_stations, num_channels,
+                    offset_out, station_tile, source_tile,
+                    oskar_mem_float_const(J, status),
+                    jones_stride,
+                    oskar_mem_float_const(src_flux[0], status),
+                    oskar_mem_float_const(src_flux[1], status),
+                    oskar_mem_float_const(src_flux[2], status),
+                    oskar_mem_float_const(src_flux[3], status),
+                    flux_stride,
+                    oskar_mem_float_const(src_dir[0], status),
+                    oskar_mem_float_const(src_dir[1], status),
+                    oskar_mem_float_const(src_dir[2], status),
+                    oskar_mem_float_const(src_ext[0], status),
+                    oskar_mem_float_const(src_ext[1], status),
+                    oskar_mem_float_const(src_ext[2], status),
+                    oskar_mem_float_const(station_uvw[0], status),
+                    oskar_mem_float_const(station_uvw[1], status),
+                    oskar_mem_float_const(station_uvw[2], status),
+                    oskar_mem_float_const(x, status),
+                    oskar_mem_float_const(y, status),
+                    uv_filter_min, uv_filter_max, uv_filter_in_metres,
+                    inv_wavelength, inv_wavelength_inc,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    source_filter_min, source_filter_max,
+                    ignore_w_components, oskar_mem_float4c(vis, status));
+        else
+            oskar_cross_correlate_fused_simd_d(isa,
+                    use_extended, num_sources, num_stations, num_channels,
+                    offset_out, station_tile, source_tile,
+                    oskar_mem_double_const(J, status),
+                    jones_stride,
+                    oskar_mem_double_const(src_flux[0], status),
+                    oskar_mem_double_const(src_flux[1], status),
+                    oskar_mem_double_const(src_flux[2], status),
+                    oskar_mem_double_const(src_flux[3], status),
+                    flux_stride,
+                    oskar_mem_double_const(src_dir[0], status),
+                    oskar_mem_double_const(src_dir[1], status),
+                    oskar_mem_double_const(src_dir[2], status),
+                    oskar_mem_double_const(src_ext[0], status),
+                    oskar_mem_double_const(src_ext[1], status),
+                    oskar_mem_double_const(src_ext[2], status),
+                    oskar_mem_double_const(station_uvw[0], status),
+                    oskar_mem_double_const(station_uvw[1], status),
+                    oskar_mem_double_const(station_uvw[2], status),
+                    oskar_mem_double_const(x, status),
+                    oskar_mem_double_const(y, status),
+                    uv_filter_min, uv_filter_max, uv_filter_in_metres,
+                    inv_wavelength, inv_wavelength_inc,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    source_filter_min, source_filter_max,
+                    ignore_w_components, oskar_mem_double4c(vis, status));
+        return;
+    }
+    switch (oskar_mem_type(vis))
+    {
+    case OSKAR_SINGLE_COMPLEX_MATRIX:
+        oskar_cross_correlate_fused_omp_f(
+                use_extended, num_sources, num_stations, num_channels, offset_out,
+                station_tile, source_tile,
+                oskar_mem_float4c_const(J, status),
+                oskar_mem_float_const(src_flux[0], status),
+                oskar_mem_float_const(src_flux[1], status),
+                oskar_mem_float_const(src_flux[2], status),
+                oskar_mem_float_const(src_flux[3], status),
+                oskar_mem_float_const(src_dir[0], status),
+                oskar_mem_float_const(src_dir[1], status),
+                oskar_mem_float_const(src_dir[2], status),
+                oskar_mem_float_const(src_ext[0], status),
+                oskar_mem_float_const(src_ext[1], status),
+                oskar_mem_float_const(src_ext[2], status),
+                oskar_mem_float_const(station_uvw[0], status),
+                oskar_mem_float_const(station_uvw[1], status),
+                oskar_mem_float_const(station_uvw[2], status),
+                oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status),
+                uv_filter_min, uv_filter_max, uv_filter_in_metres,
+                inv_wavelength, inv_wavelength_inc,
+                frac_bandwidth, time_avg, gha0, dec0,
+                source_filter_min, source_filter_max, ignore_w_components,
+                oskar_mem_float4c(vis, status));
+        break;
+    case OSKAR_DOUBLE_COMPLEX_MATRIX:
+        oskar_cross_correlate_fused_omp_d(
+                use_extended, num_sources, num_stations, num_channels, offset_out,
+                station_tile, source_tile,
+                oskar_mem_double4c_const(J, status),
+                oskar_mem_double_const(src_flux[0], status),
+                oskar_mem_double_const(src_flux[1], status),
+                oskar_mem_double_const(src_flux[2], status),
+                oskar_mem_double_const(src_flux[3], status),
+                oskar_mem_double_const(src_dir[0], status),
+                oskar_mem_double_const(src_dir[1], status),
+                oskar_mem_double_const(src_dir[2], status),
+                oskar_mem_double_const(src_ext[0], status),
+                oskar_mem_double_const(src_ext[1], status),
+                oskar_mem_double_const(src_ext[2], status),
+                oskar_mem_double_const(station_uvw[0], status),
+                oskar_mem_double_const(station_uvw[1], status),
+                oskar_mem_double_const(station_uvw[2], status),
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status),
+                uv_filter_min, uv_filter_max, uv_filter_in_metres,
+                inv_wavelength, inv_wavelength_inc,
+                frac_bandwidth, time_avg, gha0, dec0,
+                source_filter_min, source_filter_max, ignore_w_components,
+                oskar_mem_double4c(vis, status));
+        break;
+    case OSKAR_SINGLE_COMPLEX:
+        oskar_cross_correlate_scalar_fused_omp_f(
+                use_extended, num_sources, num_stations, num_channels, offset_out,
+                station_tile, source_tile,
+                oskar_mem_float2_const(J, status),
+                oskar_mem_float_const(src_flux[0], status),
+                oskar_mem_float_const(src_dir[0], status),
+                oskar_mem_float_const(src_dir[1], status),
+                oskar_mem_float_const(src_dir[2], status),
+                oskar_mem_float_const(src_ext[0], status),
+                oskar_mem_float_const(src_ext[1], status),
+                oskar_mem_float_const(src_ext[2], status),
+                oskar_mem_float_const(station_uvw[0], status),
+                oskar_mem_float_const(station_uvw[1], status),
+                oskar_mem_float_const(station_uvw[2], status),
+                oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status),
+                uv_filter_min, uv_filter_max, uv_filter_in_metres,
+                inv_wavelength, inv_wavelength_inc,
+                frac_bandwidth, time_avg, gha0, dec0,
+                source_filter_min, source_filter_max, ignore_w_components,
+                oskar_mem_float2(vis, status));
+        break;
+    case OSKAR_DOUBLE_COMPLEX:
+        oskar_cross_correlate_scalar_fused_omp_d(
+                use_extended, num_sources, num_stations, num_channels, offset_out,
+                station_tile, source_tile,
+                oskar_mem_double2_const(J, status),
+                oskar_mem_double_const(src_flux[0], status),
+                oskar_mem_double_const(src_dir[0], status),
+                oskar_mem_double_const(src_dir[1], status),
+                oskar_mem_double_const(src_dir[2], status),
+                oskar_mem_double_const(src_ext[0], status),
+                oskar_mem_double_const(src_ext[1], status),
+                oskar_mem_double_const(src_ext[2], status),
+                oskar_mem_double_const(station_uvw[0], status),
+                oskar_mem_double_const(station_uvw[1], status),
+                oskar_mem_double_const(station_uvw[2], status),
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status),
+                uv_filter_min, uv_filter_max, uv_filter_in_metres,
+                inv_wavelength, inv_wavelength_inc,
+                frac_bandwidth, time_avg, gha0, dec0,
+                source_filter_min, source_filter_max, ignore_w_components,
+                oskar_mem_double2(vis, status));
+        break;
+    default:
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+}
+
+void oskar_cross_correlate_fused(
+        int source_type,
+        int num_sources,
+        const oskar_Jones* jones,
+        const oskar_Mem* const src_flux[4],
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status)
+{
+    if (*status) return;
+    if (oskar_jones_num_sources(jones) < num_sources ||
+            oskar_jones_num_stations(jones) !=
+                    oskar_telescope_num_stations(tel))
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    cross_correlate_fused(source_type, num_sources, 1,
+            oskar_jones_mem_const(jones), 0, src_flux, 0, src_dir, src_ext,
+            source_filter_min, source_filter_max, ignore_w_components,
+            tel, station_uvw, gast, frequency_hz, 0.0, offset_out,
+            vis, status);
+}
+
+void oskar_cross_correlate_fused_channels(
+        int source_type,
+        int num_sources,
+        int num_channels,
+        const oskar_Mem* jones,
+        const oskar_Mem* const src_flux[4],
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_start_hz,
+        double frequency_inc_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status)
+{
+    if (*status) return;
+    if (num_channels < 1)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    cross_correlate_fused(source_type, num_sources, num_channels, jones, 0,
+            src_flux, 0, src_dir, src_ext, source_filter_min,
+            source_filter_max, ignore_w_components, tel, station_uvw, gast,
+            frequency_start_hz, frequency_inc_hz, offset_out, vis, status);
+}
+
+void oskar_cross_correlate_fused_soa(
+        int source_type,
+        int num_sources,
+        int num_channels,
+        const oskar_Mem* jones,
+        int jones_stride,
+        const oskar_Mem* const src_flux[4],
+        int flux_stride,
+        const oskar_Mem* const src_dir[3],
+        const oskar_Mem* const src_ext[3],
+        double source_filter_min,
+        double source_filter_max,
+        int ignore_w_components,
+        const oskar_Telescope* tel,
+        const oskar_Mem* const station_uvw[3],
+        double gast,
+        double frequency_start_hz,
+        double frequency_inc_hz,
+        int offset_out,
+        oskar_Mem* vis,
+        int* status)
+{
+    if (*status) return;
+    if (num_channels < 1 || jones_stride < 1 || flux_stride < 0)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    cross_correlate_fused(source_type, num_sources, num_channels, jones,
+            jones_stride, src_flux, flux_stride, src_dir, src_ext,
+            source_filter_min, source_filter_max, ignore_w_components,
+            tel, station_uvw, gast, frequency_start_hz, frequency_inc_hz,
+            offset_out, vis, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
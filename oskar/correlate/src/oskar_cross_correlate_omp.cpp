@@ -27,6 +27,7 @@
  */
 
 #include "correlate/define_correlate_utils.h"
+#include "correlate/define_cross_correlate_fused.h"
 #include "correlate/oskar_cross_correlate_omp.h"
 #include "math/define_multiply.h"
 #include "math/oskar_kahan_sum.h"
@@ -173,6 +174,497 @@ void oskar_xcorr_omp(
     }
 }
 
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2, typename REAL4c
+>
+void oskar_xcorr_tiled_omp(
+        const int                    num_sources,
+        const int                    num_stations,
+        const int                    offset_out,
+        const int                    station_tile,
+        const int                    source_tile,
+        const REAL4c* const RESTRICT jones,
+        const REAL*   const RESTRICT source_I,
+        const REAL*   const RESTRICT source_Q,
+        const REAL*   const RESTRICT source_U,
+        const REAL*   const RESTRICT source_V,
+        const REAL*   const RESTRICT source_l,
+        const REAL*   const RESTRICT source_m,
+        const REAL*   const RESTRICT source_n,
+        const REAL*   const RESTRICT source_a,
+        const REAL*   const RESTRICT source_b,
+        const REAL*   const RESTRICT source_c,
+        const REAL*   const RESTRICT station_u,
+        const REAL*   const RESTRICT station_v,
+        const REAL*   const RESTRICT station_w,
+        const REAL*   const RESTRICT station_x,
+        const REAL*   const RESTRICT station_y,
+        const REAL                   uv_min_lambda,
+        const REAL                   uv_max_lambda,
+        const REAL                   inv_wavelength,
+        const REAL                   frac_bandwidth,
+        const REAL                   time_int_sec,
+        const REAL                   gha0_rad,
+        const REAL                   dec0_rad,
+        REAL4c*             RESTRICT vis)
+{
+    // Baselines are grouped into tiles formed from pairs of station blocks,
+    // and sources are processed in blocks, so that the Jones matrices for
+    // both station blocks stay in cache while all baselines in the tile
+    // are accumulated.
+    const int num_blocks = (num_stations + station_tile - 1) / station_tile;
+    const int num_tiles = num_blocks * (num_blocks + 1) / 2;
+    const int max_baselines = station_tile * station_tile;
+#pragma omp parallel
+    {
+    // Per-thread baseline terms and accumulators for one tile.
+    int* station_pairs = new int[2 * max_baselines];
+    REAL* terms = new REAL[9 * max_baselines];
+    REAL4c* sum = new REAL4c[max_baselines];
+    REAL4c* guard = new REAL4c[max_baselines];
+
+    // Loop over baseline tiles.
+#pragma omp for schedule(dynamic, 1)
+    for (int tile = 0; tile < num_tiles; ++tile)
+    {
+        // Get the station blocks for this tile, with BQ <= BP.
+        int BQ = 0, BP = tile;
+        while (BP >= num_blocks - BQ) BP -= num_blocks - BQ++;
+        BP += BQ;
+        const int SQ_start = BQ * station_tile, SP_start = BP * station_tile;
+        const int SQ_end = (SQ_start + station_tile < num_stations) ?
+                SQ_start + station_tile : num_stations;
+        const int SP_end = (SP_start + station_tile < num_stations) ?
+                SP_start + station_tile : num_stations;
+
+        // Get common values for each baseline in the tile.
+        int num_baselines = 0;
+        for (int SQ = SQ_start; SQ < SQ_end; ++SQ)
+        {
+            for (int SP = (SP_start > SQ ? SP_start : SQ + 1);
+                    SP < SP_end; ++SP)
+            {
+                REAL uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                REAL du = (REAL) 0, dv = (REAL) 0, dw = (REAL) 0;
+                OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
+                        station_v[SP], station_v[SQ],
+                        station_w[SP], station_w[SQ],
+                        uu, vv, ww, uu2, vv2, uuvv, uv_len);
+
+                // Apply the baseline length filter.
+                if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                    continue;
+
+                // Compute the deltas for time-average smearing.
+                if (TIME_SMEARING)
+                    OSKAR_BASELINE_DELTAS(REAL, station_x[SP], station_x[SQ],
+                            station_y[SP], station_y[SQ], du, dv, dw);
+                REAL* t = &terms[9 * num_baselines];
+                t[0] = uu; t[1] = vv; t[2] = ww;
+                t[3] = uu2; t[4] = vv2; t[5] = uuvv;
+                t[6] = du; t[7] = dv; t[8] = dw;
+                station_pairs[2 * num_baselines] = SP;
+                station_pairs[2 * num_baselines + 1] = SQ;
+                OSKAR_CLEAR_COMPLEX_MATRIX(REAL, sum[num_baselines])
+                if (is_same<REAL, float>::value)
+                    OSKAR_CLEAR_COMPLEX_MATRIX(REAL, guard[num_baselines])
+                num_baselines++;
+            }
+        }
+
+        // Loop over source blocks.
+        for (int i_start = 0; i_start < num_sources; i_start += source_tile)
+        {
+            const int i_end = (i_start + source_tile < num_sources) ?
+                    i_start + source_tile : num_sources;
+
+            // Loop over baselines in the tile.
+            for (int b = 0; b < num_baselines; ++b)
+            {
+                REAL4c m1, m2, acc, acc_guard;
+                const REAL* t = &terms[9 * b];
+                const REAL uu = t[0], vv = t[1], ww = t[2];
+                const REAL uu2 = t[3], vv2 = t[4], uuvv = t[5];
+                const REAL du = t[6], dv = t[7], dw = t[8];
+                OSKAR_LOAD_MATRIX(acc, sum[b])
+                if (is_same<REAL, float>::value)
+                    OSKAR_LOAD_MATRIX(acc_guard, guard[b])
+
+                // Pointers to source vectors for stations p and q.
+                const REAL4c* const station_p =
+                        &jones[station_pairs[2 * b] * num_sources];
+                const REAL4c* const station_q =
+                        &jones[station_pairs[2 * b + 1] * num_sources];
+
+                // Loop over sources in the block.
+                for (int i = i_start; i < i_end; ++i)
+                {
+                    REAL smearing;
+                    if (GAUSSIAN)
+                    {
+                        const REAL t = source_a[i] * uu2 +
+                                source_b[i] * uuvv + source_c[i] * vv2;
+                        smearing = exp((REAL) -t);
+                    }
+                    else smearing = (REAL) 1;
+                    if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                    {
+                        const REAL l = source_l[i];
+                        const REAL m = source_m[i];
+                        const REAL n = source_n[i] - (REAL) 1;
+                        if (BANDWIDTH_SMEARING)
+                        {
+                            const REAL t = uu * l + vv * m + ww * n;
+                            smearing *= OSKAR_SINC(REAL, t);
+                        }
+                        if (TIME_SMEARING)
+                        {
+                            const REAL t = du * l + dv * m + dw * n;
+                            smearing *= OSKAR_SINC(REAL, t);
+                        }
+                    }
+
+                    // Construct source brightness matrix.
+                    OSKAR_CONSTRUCT_B(REAL, m2, source_I[i], source_Q[i],
+                            source_U[i], source_V[i])
+
+                    // Multiply first Jones matrix with source brightness
+                    // matrix.
+                    OSKAR_LOAD_MATRIX(m1, station_p[i])
+                    OSKAR_MUL_COMPLEX_MATRIX_HERMITIAN_IN_PLACE(REAL2, m1, m2)
+
+                    // Multiply result with second (Hermitian transposed)
+                    // Jones matrix.
+                    OSKAR_LOAD_MATRIX(m2, station_q[i])
+                    OSKAR_MUL_COMPLEX_MATRIX_CONJUGATE_TRANSPOSE_IN_PLACE(
+                            REAL2, m1, m2)
+
+                    // Multiply result by smearing term and accumulate.
+                    if (is_same<REAL, float>::value)
+                    {
+                        OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX_MATRIX(
+                                REAL, acc, m1, smearing, acc_guard)
+                    }
+                    else
+                    {
+                        OSKAR_MUL_ADD_COMPLEX_MATRIX_SCALAR(acc, m1, smearing)
+                    }
+                }
+                OSKAR_LOAD_MATRIX(sum[b], acc)
+                if (is_same<REAL, float>::value)
+                    OSKAR_LOAD_MATRIX(guard[b], acc_guard)
+            }
+        }
+
+        // Add results to the baseline visibilities.
+        for (int b = 0; b < num_baselines; ++b)
+        {
+            const int SP = station_pairs[2 * b];
+            const int SQ = station_pairs[2 * b + 1];
+            const int i = OSKAR_BASELINE_INDEX(num_stations, SP, SQ) +
+                    offset_out;
+            OSKAR_ADD_COMPLEX_MATRIX_IN_PLACE(vis[i], sum[b]);
+        }
+    }
+    delete [] station_pairs;
+    delete [] terms;
+    delete [] sum;
+    delete [] guard;
+    }
+}
+
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2, typename REAL4c
+>
+void oskar_xcorr_fused_omp(
+        const int                    num_sources,
+        const int                    num_stations,
+        const int                    num_channels,
+        const int                    offset_out,
+        const int                  station_tile,
+        const int                   source_tile,
+        const REAL4c* const RESTRICT jones,
+        const REAL*   const RESTRICT source_I,
+        const REAL*   const RESTRICT source_Q,
+        const REAL*   const RESTRICT source_U,
+        const REAL*   const RESTRICT source_V,
+        const REAL*   const RESTRICT source_l,
+        const REAL*   const RESTRICT source_m,
+        const REAL*   const RESTRICT source_n,
+        const REAL*   const RESTRICT source_a,
+        const REAL*   const RESTRICT source_b,
+        const REAL*   const RESTRICT source_c,
+        const REAL*   const RESTRICT station_u,
+        const REAL*   const RESTRICT station_v,
+        const REAL*   const RESTRICT station_w,
+        const REAL*   const RESTRICT station_x,
+        const REAL*   const RESTRICT station_y,
+        const REAL                   uv_min_lambda,
+        const REAL                   uv_max_lambda,
+        const int                    uv_filter_in_metres,
+        const REAL                   inv_wavelength,
+        const REAL                   inv_wavelength_inc,
+        const REAL                   frac_bandwidth,
+        const REAL                   time_int_sec,
+        const REAL                   gha0_rad,
+        const REAL                   dec0_rad,
+        const REAL                   source_filter_min,
+        const REAL                   source_filter_max,
+        const int                    ignore_w_components,
+        REAL4c*             RESTRICT vis)
+{
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int station_stride = num_sources * num_channels;
+    const REAL inv_wavelength_ratio = inv_wavelength_inc / inv_wavelength;
+    const REAL wavenumber = ((REAL) (2.0 * M_PI)) * inv_wavelength;
+    const REAL wavenumber_inc = ((REAL) (2.0 * M_PI)) * inv_wavelength_inc;
+
+    // Station phase factors (K-Jones) for one block of sources, shared by
+    // all threads, for the first channel and the increment per channel.
+    const int block = oskar_xcorr_source_block(num_sources, source_tile);
+    const size_t phase_size = (size_t) num_stations * block;
+    REAL2* phase = new REAL2[(num_channels > 1 ? 2 : 1) * phase_size];
+    REAL2* phase_inc = (num_channels > 1) ? phase + phase_size : 0;
+
+    // Baseline tiles, shared between threads for each block of sources.
+    const int num_tiles =
+            oskar_xcorr_station_tiles(num_stations, station_tile, 0);
+    int* tiles = new int[4 * num_tiles + 4];
+    oskar_xcorr_station_tiles(num_stations, station_tile, tiles);
+#pragma omp parallel
+    {
+    // Per-thread accumulators for each channel.
+    REAL4c* sum = new REAL4c[num_channels];
+    REAL4c* guard = new REAL4c[num_channels];
+
+    // Loop over source blocks.
+    for (int i_start = 0; i_start < num_sources; i_start += block)
+    {
+        const int i_end = (i_start + block < num_sources) ?
+                i_start + block : num_sources;
+
+        // Evaluate the phase factors at each station for this block.
+#pragma omp for schedule(static)
+        for (int s = 0; s < num_stations; ++s)
+            oskar_xcorr_station_phase<REAL, REAL2>(i_end - i_start,
+                    &source_l[i_start], &source_m[i_start], &source_n[i_start],
+                    station_u[s], station_v[s],
+                    ignore_w_components ? (REAL) 0 : station_w[s],
+                    wavenumber, wavenumber_inc, &phase[s * block],
+                    phase_inc ? &phase_inc[s * block] : 0);
+
+        // Loop over baseline tiles.
+#pragma omp for schedule(dynamic, 1)
+        for (int tile = 0; tile < num_tiles; ++tile)
+        {
+            const int* const lim = &tiles[4 * tile];
+            for (int SQ = lim[0]; SQ < lim[1]; ++SQ)
+            {
+                // Pointers to source vector and phase factors for station q.
+                const REAL4c* const station_q = &jones[SQ * station_stride];
+                const REAL2* const phase_q = &phase[SQ * block];
+                const REAL2* const phase_inc_q =
+                        phase_inc ? &phase_inc[SQ * block] : 0;
+
+                // Loop over baselines for this station in the tile.
+                const int SP_start = (lim[2] > SQ) ? lim[2] : SQ + 1;
+                for (int SP = SP_start; SP < lim[3]; ++SP)
+                {
+                    REAL uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+                    REAL4c m1, m2;
+                    int c;
+
+                    // Pointers to source vector and phase factors for
+                    // station p.
+                    const REAL4c* const station_p = &jones[SP * station_stride];
+                    const REAL2* const phase_p = &phase[SP * block];
+                    const REAL2* const phase_inc_p =
+                            phase_inc ? &phase_inc[SP * block] : 0;
+
+                    // Get common baseline values.
+                    OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
+                            station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ],
+                            uu, vv, ww, uu2, vv2, uuvv, uv_len);
+
+                    // Apply the baseline length filter to each channel.
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        const REAL t = uv_filter_in_metres ? uv_len :
+                                uv_len * ((REAL) 1 + c * inv_wavelength_ratio);
+                        if (t >= uv_min_lambda && t <= uv_max_lambda) break;
+                    }
+                    if (c == num_channels) continue;
+
+                    // Compute the deltas for time-average smearing.
+                    if (TIME_SMEARING)
+                        OSKAR_BASELINE_DELTAS(REAL,
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ], du, dv, dw);
+
+                    // Clear the accumulators.
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        OSKAR_CLEAR_COMPLEX_MATRIX(REAL, sum[c])
+                        if (is_same<REAL, float>::value)
+                            OSKAR_CLEAR_COMPLEX_MATRIX(REAL, guard[c])
+                    }
+
+                    // Loop over sources in the block.
+                    for (int i = i_start; i < i_end; ++i)
+                    {
+                        REAL smearing = (REAL) 1, gaussian = (REAL) 0;
+                        REAL t_time = (REAL) 0, t_time_inc = (REAL) 0;
+                        REAL2 k, k_inc, s_time, s_time_inc;
+                        k_inc.x = s_time_inc.x = (REAL) 1;
+                        k_inc.y = s_time_inc.y = (REAL) 0;
+                        s_time.x = s_time.y = (REAL) 0;
+                        const int j = i - i_start;
+
+                        // Bandwidth smearing does not depend on frequency,
+                        // as the channel width is the same for all channels.
+                        if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                        {
+                            const REAL l = source_l[i];
+                            const REAL m = source_m[i];
+                            const REAL n = source_n[i] - (REAL) 1;
+                            if (BANDWIDTH_SMEARING)
+                            {
+                                const REAL t = uu * l + vv * m + ww * n;
+                                smearing = OSKAR_SINC(REAL, t);
+                            }
+
+                            // The time-smearing argument is linear in
+                            // frequency, so its sine is stepped between
+                            // channels in the same way as the phase.
+                            if (TIME_SMEARING)
+                            {
+                                t_time = du * l + dv * m + dw * n;
+                                SINCOS(t_time, s_time.y, s_time.x);
+                                if (num_channels > 1)
+                                {
+                                    t_time_inc = t_time * inv_wavelength_ratio;
+                                    SINCOS(t_time_inc,
+                                            s_time_inc.y, s_time_inc.x);
+                                }
+                            }
+                        }
+                        if (GAUSSIAN)
+                        {
+                            gaussian = source_a[i] * uu2 + source_b[i] * uuvv +
+                                    source_c[i] * vv2;
+                        }
+
+                        // Form the interferometer phase for the first channel,
+                        // and the rotation between channels, from the
+                        // station phase factors.
+                        OSKAR_MUL_COMPLEX_CONJUGATE(k, phase_p[j], phase_q[j])
+                        if (phase_inc)
+                            OSKAR_MUL_COMPLEX_CONJUGATE(k_inc,
+                                    phase_inc_p[j], phase_inc_q[j])
+
+                        // Loop over channels.
+                        const REAL4c* const jones_p =
+                                &station_p[i * num_channels];
+                        const REAL4c* const jones_q =
+                                &station_q[i * num_channels];
+                        const int src_offset = i * num_channels;
+                        for (c = 0; c < num_channels; ++c)
+                        {
+                            // Apply the source flux filter.
+                            const REAL I = source_I[src_offset + c];
+                            if (I > source_filter_min && I <= source_filter_max)
+                            {
+                                REAL2 k_smear;
+                                REAL f = smearing;
+                                if (GAUSSIAN)
+                                {
+                                    const REAL r =
+                                            (REAL) 1 + c * inv_wavelength_ratio;
+                                    f *= exp((REAL) (-gaussian * r * r));
+                                }
+                                if (TIME_SMEARING)
+                                {
+                                    const REAL t = t_time + c * t_time_inc;
+                                    if (t != (REAL) 0) f *= s_time.y / t;
+                                }
+                                k_smear.x = k.x * f;
+                                k_smear.y = k.y * f;
+
+                                // Construct source brightness matrix.
+                                OSKAR_CONSTRUCT_B(REAL, m2, I,
+                                        source_Q[src_offset + c],
+                                        source_U[src_offset + c],
+                                        source_V[src_offset + c])
+
+                                // Multiply first Jones matrix with source
+                                // brightness matrix.
+                                OSKAR_LOAD_MATRIX(m1, jones_p[c])
+                                OSKAR_MUL_COMPLEX_MATRIX_HERMITIAN_IN_PLACE(
+                                        REAL2, m1, m2)
+
+                                // Multiply result with second (Hermitian
+                                // transposed) Jones matrix.
+                                OSKAR_LOAD_MATRIX(m2, jones_q[c])
+                                OSKAR_MUL_COMPLEX_MATRIX_CONJUGATE_TRANSPOSE_IN_PLACE(
+                                        REAL2, m1, m2)
+
+                                // Multiply result by phase and smearing terms
+                                // and accumulate.
+                                OSKAR_MUL_COMPLEX_MATRIX_COMPLEX_SCALAR_IN_PLACE(
+                                        REAL2, m1, k_smear)
+                                if (is_same<REAL, float>::value)
+                                {
+                                    OSKAR_KAHAN_SUM_COMPLEX_MATRIX(
+                                            REAL, sum[c], m1, guard[c])
+                                }
+                                else
+                                {
+                                    OSKAR_ADD_COMPLEX_MATRIX_IN_PLACE(
+                                            sum[c], m1)
+                                }
+                            }
+
+                            // Rotate phase terms to the next channel.
+                            if (c < num_channels - 1)
+                            {
+                                OSKAR_MUL_COMPLEX_IN_PLACE(REAL2, k, k_inc)
+                                if (TIME_SMEARING)
+                                    OSKAR_MUL_COMPLEX_IN_PLACE(
+                                            REAL2, s_time, s_time_inc)
+                            }
+                        }
+                    }
+
+                    // Add results to the baseline visibilities for each
+                    // channel.
+                    const int b = offset_out +
+                            OSKAR_BASELINE_INDEX(num_stations, SP, SQ);
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        const REAL t = uv_filter_in_metres ? uv_len :
+                                uv_len * ((REAL) 1 + c * inv_wavelength_ratio);
+                        if (t < uv_min_lambda || t > uv_max_lambda) continue;
+                        OSKAR_ADD_COMPLEX_MATRIX_IN_PLACE(
+                                vis[b + c * num_baselines], sum[c]);
+                    }
+                }
+            }
+        }
+    }
+    delete [] sum;
+    delete [] guard;
+    }
+    delete [] phase;
+    delete [] tiles;
+}
+
 #define XCORR_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)                 \
         oskar_xcorr_omp<BS, TS, GAUSSIAN, REAL, REAL2, REAL4c>              \
         (num_sources, num_stations, offset_out, d_jones,                    \
@@ -253,3 +745,165 @@ void oskar_cross_correlate_gaussian_omp_d(
 {
     XCORR_SELECT(true, double, double2, double4c)
 }
+
+void oskar_cross_correlate_tile_size(int num_sources, int num_stations,
+        int element_size, int* station_tile, int* source_tile)
+{
+    // Aim to keep the Jones matrices for a pair of station blocks
+    // within this many bytes.
+    const int cache_bytes = 256 * 1024;
+    if (*station_tile <= 0) *station_tile = 16;
+    if (*station_tile > num_stations) *station_tile = num_stations;
+    if (*station_tile < 1) *station_tile = 1;
+    if (*source_tile <= 0)
+    {
+        *source_tile = cache_bytes / (2 * *station_tile * element_size);
+        *source_tile = (*source_tile / 16) * 16;
+        if (*source_tile < 16) *source_tile = 16;
+    }
+    if (*source_tile > num_sources) *source_tile = num_sources;
+    if (*source_tile < 1) *source_tile = 1;
+}
+
+#define XCORR_TILED_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)           \
+        oskar_xcorr_tiled_omp<BS, TS, GAUSSIAN, REAL, REAL2, REAL4c>        \
+        (num_sources, num_stations, offset_out, station_tile, source_tile,  \
+                d_jones, d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,  \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,     \
+                inv_wavelength, frac_bandwidth, time_int_sec,               \
+                gha0_rad, dec0_rad, d_vis);
+
+#define XCORR_TILED_SELECT(GAUSSIAN, REAL, REAL2, REAL4c)                   \
+        if (frac_bandwidth == (REAL)0 && time_int_sec == (REAL)0)           \
+            XCORR_TILED_KERNEL(false, false, GAUSSIAN, REAL, REAL2, REAL4c) \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec == (REAL)0)      \
+            XCORR_TILED_KERNEL(true, false, GAUSSIAN, REAL, REAL2, REAL4c)  \
+        else if (frac_bandwidth == (REAL)0 && time_int_sec != (REAL)0)      \
+            XCORR_TILED_KERNEL(false, true, GAUSSIAN, REAL, REAL2, REAL4c)  \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec != (REAL)0)      \
+            XCORR_TILED_KERNEL(true, true, GAUSSIAN, REAL, REAL2, REAL4c)
+
+void oskar_cross_correlate_tiled_omp_f(
+        int use_extended, int num_sources, int num_stations, int offset_out,
+        int station_tile, int source_tile,
+        const float4c* d_jones, const float* d_I, const float* d_Q,
+        const float* d_U, const float* d_V,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float4c* d_vis)
+{
+    oskar_cross_correlate_tile_size(num_sources, num_stations,
+            sizeof(float4c), &station_tile, &source_tile);
+    if (use_extended)
+    {
+        XCORR_TILED_SELECT(true, float, float2, float4c)
+    }
+    else
+    {
+        XCORR_TILED_SELECT(false, float, float2, float4c)
+    }
+}
+
+void oskar_cross_correlate_tiled_omp_d(
+        int use_extended, int num_sources, int num_stations, int offset_out,
+        int station_tile, int source_tile,
+        const double4c* d_jones, const double* d_I, const double* d_Q,
+        const double* d_U, const double* d_V,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* d_vis)
+{
+    oskar_cross_correlate_tile_size(num_sources, num_stations,
+            sizeof(double4c), &station_tile, &source_tile);
+    if (use_extended)
+    {
+        XCORR_TILED_SELECT(true, double, double2, double4c)
+    }
+    else
+    {
+        XCORR_TILED_SELECT(false, double, double2, double4c)
+    }
+}
+
+#define XCORR_FUSED_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)           \
+        oskar_xcorr_fused_omp<BS, TS, GAUSSIAN, REAL, REAL2, REAL4c>        \
+        (num_sources, num_stations, num_channels, offset_out,               \
+                station_tile, source_tile, d_jones,                         \
+                d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,           \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,     \
+                uv_filter_in_metres, inv_wavelength, inv_wavelength_inc,    \
+                frac_bandwidth, time_int_sec,                               \
+                gha0_rad, dec0_rad, source_filter_min, source_filter_max,   \
+                ignore_w_components, d_vis);
+
+#define XCORR_FUSED_SELECT(GAUSSIAN, REAL, REAL2, REAL4c)                   \
+        if (frac_bandwidth == (REAL)0 && time_int_sec == (REAL)0)           \
+            XCORR_FUSED_KERNEL(false, false, GAUSSIAN, REAL, REAL2, REAL4c) \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec == (REAL)0)      \
+            XCORR_FUSED_KERNEL(true, false, GAUSSIAN, REAL, REAL2, REAL4c)  \
+        else if (frac_bandwidth == (REAL)0 && time_int_sec != (REAL)0)      \
+            XCORR_FUSED_KERNEL(false, true, GAUSSIAN, REAL, REAL2, REAL4c)  \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec != (REAL)0)      \
+            XCORR_FUSED_KERNEL(true, true, GAUSSIAN, REAL, REAL2, REAL4c)
+
+void oskar_cross_correlate_fused_omp_f(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const float4c* d_jones, const float* d_I, const float* d_Q,
+        const float* d_U, const float* d_V,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, float uv_min_lambda, float uv_max_lambda,
+        int uv_filter_in_metres, float inv_wavelength, float inv_wavelength_inc,
+        float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* d_vis)
+{
+    if (use_extended)
+    {
+        XCORR_FUSED_SELECT(true, float, float2, float4c)
+    }
+    else
+    {
+        XCORR_FUSED_SELECT(false, float, float2, float4c)
+    }
+}
+
+void oskar_cross_correlate_fused_omp_d(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const double4c* d_jones, const double* d_I, const double* d_Q,
+        const double* d_U, const double* d_V,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, double uv_min_lambda, double uv_max_lambda,
+        int uv_filter_in_metres, double inv_wavelength, double inv_wavelength_inc,
+        double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* d_vis)
+{
+    if (use_extended)
+    {
+        XCORR_FUSED_SELECT(true, double, double2, double4c)
+    }
+    else
+    {
+        XCORR_FUSED_SELECT(false, double, double2, double4c)
+    }
+}
@@ -27,6 +27,7 @@
  */
 
 #include "correlate/define_correlate_utils.h"
+#include "correlate/define_cross_correlate_fused.h"
 #include "correlate/oskar_cross_correlate_scalar_omp.h"
 #include "math/define_multiply.h"
 #include "math/oskar_kahan_sum.h"
@@ -170,6 +171,272 @@ void oskar_xcorr_scalar_omp(
     }
 }
 
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2
+>
+void oskar_xcorr_scalar_fused_omp(
+        const int                   num_sources,
+        const int                   num_stations,
+        const int                   num_channels,
+        const int                   offset_out,
+        const int                 station_tile,
+        const int                  source_tile,
+        const REAL2* const RESTRICT jones,
+        const REAL*  const RESTRICT source_I,
+        const REAL*  const RESTRICT source_l,
+        const REAL*  const RESTRICT source_m,
+        const REAL*  const RESTRICT source_n,
+        const REAL*  const RESTRICT source_a,
+        const REAL*  const RESTRICT source_b,
+        const REAL*  const RESTRICT source_c,
+        const REAL*  const RESTRICT station_u,
+        const REAL*  const RESTRICT station_v,
+        const REAL*  const RESTRICT station_w,
+        const REAL*  const RESTRICT station_x,
+        const REAL*  const RESTRICT station_y,
+        const REAL                  uv_min_lambda,
+        const REAL                  uv_max_lambda,
+        const int                   uv_filter_in_metres,
+        const REAL                  inv_wavelength,
+        const REAL                  inv_wavelength_inc,
+        const REAL                  frac_bandwidth,
+        const REAL                  time_int_sec,
+        const REAL                  gha0_rad,
+        const REAL                  dec0_rad,
+        const REAL                  source_filter_min,
+        const REAL                  source_filter_max,
+        const int                   ignore_w_components,
+        REAL2*             RESTRICT vis)
+{
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int station_stride = num_sources * num_channels;
+    const REAL inv_wavelength_ratio = inv_wavelength_inc / inv_wavelength;
+    const REAL wavenumber = ((REAL) (2.0 * M_PI)) * inv_wavelength;
+    const REAL wavenumber_inc = ((REAL) (2.0 * M_PI)) * inv_wavelength_inc;
+
+    // Station phase factors (K-Jones) for one block of sources, shared by
+    // all threads, for the first channel and the increment per channel.
+    const int block = oskar_xcorr_source_block(num_sources, source_tile);
+    const size_t phase_size = (size_t) num_stations * block;
+    REAL2* phase = new REAL2[(num_channels > 1 ? 2 : 1) * phase_size];
+    REAL2* phase_inc = (num_channels > 1) ? phase + phase_size : 0;
+
+    // Baseline tiles, shared between threads for each block of sources.
+    const int num_tiles =
+            oskar_xcorr_station_tiles(num_stations, station_tile, 0);
+    int* tiles = new int[4 * num_tiles + 4];
+    oskar_xcorr_station_tiles(num_stations, station_tile, tiles);
+#pragma omp parallel
+    {
+    // Per-thread accumulators for each channel.
+    REAL2* sum = new REAL2[num_channels];
+    REAL2* guard = new REAL2[num_channels];
+
+    // Loop over source blocks.
+    for (int i_start = 0; i_start < num_sources; i_start += block)
+    {
+        const int i_end = (i_start + block < num_sources) ?
+                i_start + block : num_sources;
+
+        // Evaluate the phase factors at each station for this block.
+#pragma omp for schedule(static)
+        for (int s = 0; s < num_stations; ++s)
+            oskar_xcorr_station_phase<REAL, REAL2>(i_end - i_start,
+                    &source_l[i_start], &source_m[i_start], &source_n[i_start],
+                    station_u[s], station_v[s],
+                    ignore_w_components ? (REAL) 0 : station_w[s],
+                    wavenumber, wavenumber_inc, &phase[s * block],
+                    phase_inc ? &phase_inc[s * block] : 0);
+
+        // Loop over baseline tiles.
+#pragma omp for schedule(dynamic, 1)
+        for (int tile = 0; tile < num_tiles; ++tile)
+        {
+            const int* const lim = &tiles[4 * tile];
+            for (int SQ = lim[0]; SQ < lim[1]; ++SQ)
+            {
+                // Pointers to source vector and phase factors for station q.
+                const REAL2* const station_q = &jones[SQ * station_stride];
+                const REAL2* const phase_q = &phase[SQ * block];
+                const REAL2* const phase_inc_q =
+                        phase_inc ? &phase_inc[SQ * block] : 0;
+
+                // Loop over baselines for this station in the tile.
+                const int SP_start = (lim[2] > SQ) ? lim[2] : SQ + 1;
+                for (int SP = SP_start; SP < lim[3]; ++SP)
+                {
+                    REAL uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+                    REAL2 t1, t2;
+                    int c;
+
+                    // Pointers to source vector and phase factors for
+                    // station p.
+                    const REAL2* const station_p = &jones[SP * station_stride];
+                    const REAL2* const phase_p = &phase[SP * block];
+                    const REAL2* const phase_inc_p =
+                            phase_inc ? &phase_inc[SP * block] : 0;
+
+                    // Get common baseline values.
+                    OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
+                            station_v[SP], station_v[SQ],
+                            station_w[SP], station_w[SQ],
+                            uu, vv, ww, uu2, vv2, uuvv, uv_len);
+
+                    // Apply the baseline length filter to each channel.
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        const REAL t = uv_filter_in_metres ? uv_len :
+                                uv_len * ((REAL) 1 + c * inv_wavelength_ratio);
+                        if (t >= uv_min_lambda && t <= uv_max_lambda) break;
+                    }
+                    if (c == num_channels) continue;
+
+                    // Compute the deltas for time-average smearing.
+                    if (TIME_SMEARING)
+                        OSKAR_BASELINE_DELTAS(REAL,
+                                station_x[SP], station_x[SQ],
+                                station_y[SP], station_y[SQ], du, dv, dw);
+
+                    // Clear the accumulators.
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        sum[c].x = sum[c].y = (REAL) 0;
+                        if (is_same<REAL, float>::value)
+                            guard[c].x = guard[c].y = (REAL) 0;
+                    }
+
+                    // Loop over sources in the block.
+                    for (int i = i_start; i < i_end; ++i)
+                    {
+                        REAL smearing = (REAL) 1, gaussian = (REAL) 0;
+                        REAL t_time = (REAL) 0, t_time_inc = (REAL) 0;
+                        REAL2 k, k_inc, s_time, s_time_inc;
+                        k_inc.x = s_time_inc.x = (REAL) 1;
+                        k_inc.y = s_time_inc.y = (REAL) 0;
+                        s_time.x = s_time.y = (REAL) 0;
+                        const int j = i - i_start;
+
+                        // Bandwidth smearing does not depend on frequency,
+                        // as the channel width is the same for all channels.
+                        if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                        {
+                            const REAL l = source_l[i];
+                            const REAL m = source_m[i];
+                            const REAL n = source_n[i] - (REAL) 1;
+                            if (BANDWIDTH_SMEARING)
+                            {
+                                const REAL t = uu * l + vv * m + ww * n;
+                                smearing = OSKAR_SINC(REAL, t);
+                            }
+
+                            // The time-smearing argument is linear in
+                            // frequency, so its sine is stepped between
+                            // channels in the same way as the phase.
+                            if (TIME_SMEARING)
+                            {
+                                t_time = du * l + dv * m + dw * n;
+                                SINCOS(t_time, s_time.y, s_time.x);
+                                if (num_channels > 1)
+                                {
+                                    t_time_inc = t_time * inv_wavelength_ratio;
+                                    SINCOS(t_time_inc,
+                                            s_time_inc.y, s_time_inc.x);
+                                }
+                            }
+                        }
+                        if (GAUSSIAN)
+                        {
+                            gaussian = source_a[i] * uu2 + source_b[i] * uuvv +
+                                    source_c[i] * vv2;
+                        }
+
+                        // Form the interferometer phase for the first channel,
+                        // and the rotation between channels, from the
+                        // station phase factors.
+                        OSKAR_MUL_COMPLEX_CONJUGATE(k, phase_p[j], phase_q[j])
+                        if (phase_inc)
+                            OSKAR_MUL_COMPLEX_CONJUGATE(k_inc,
+                                    phase_inc_p[j], phase_inc_q[j])
+
+                        // Loop over channels.
+                        const int src_offset = i * num_channels;
+                        for (c = 0; c < num_channels; ++c)
+                        {
+                            // Apply the source flux filter.
+                            const REAL I = source_I[src_offset + c];
+                            if (I > source_filter_min && I <= source_filter_max)
+                            {
+                                REAL f = smearing * I;
+                                if (GAUSSIAN)
+                                {
+                                    const REAL r =
+                                            (REAL) 1 + c * inv_wavelength_ratio;
+                                    f *= exp((REAL) (-gaussian * r * r));
+                                }
+                                if (TIME_SMEARING)
+                                {
+                                    const REAL t = t_time + c * t_time_inc;
+                                    if (t != (REAL) 0) f *= s_time.y / t;
+                                }
+
+                                // Multiply Jones scalars and phase.
+                                t1 = station_p[src_offset + c];
+                                OSKAR_MUL_COMPLEX_IN_PLACE(REAL2, t1, k)
+                                t2 = station_q[src_offset + c];
+                                OSKAR_MUL_COMPLEX_CONJUGATE_IN_PLACE(
+                                        REAL2, t1, t2)
+
+                                // Multiply result by smearing term and
+                                // accumulate.
+                                if (is_same<REAL, float>::value)
+                                {
+                                    OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX(
+                                            REAL, sum[c], t1, f, guard[c])
+                                }
+                                else
+                                {
+                                    sum[c].x += t1.x * f;
+                                    sum[c].y += t1.y * f;
+                                }
+                            }
+
+                            // Rotate phase terms to the next channel.
+                            if (c < num_channels - 1)
+                            {
+                                OSKAR_MUL_COMPLEX_IN_PLACE(REAL2, k, k_inc)
+                                if (TIME_SMEARING)
+                                    OSKAR_MUL_COMPLEX_IN_PLACE(
+                                            REAL2, s_time, s_time_inc)
+                            }
+                        }
+                    }
+
+                    // Add results to the baseline visibilities for each
+                    // channel.
+                    const int b = offset_out +
+                            OSKAR_BASELINE_INDEX(num_stations, SP, SQ);
+                    for (c = 0; c < num_channels; ++c)
+                    {
+                        const REAL t = uv_filter_in_metres ? uv_len :
+                                uv_len * ((REAL) 1 + c * inv_wavelength_ratio);
+                        if (t < uv_min_lambda || t > uv_max_lambda) continue;
+                        vis[b + c * num_baselines].x += sum[c].x;
+                        vis[b + c * num_baselines].y += sum[c].y;
+                    }
+                }
+            }
+        }
+    }
+    delete [] sum;
+    delete [] guard;
+    }
+    delete [] phase;
+    delete [] tiles;
+}
+
 #define XCORR_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2)                         \
         oskar_xcorr_scalar_omp<BS, TS, GAUSSIAN, REAL, REAL2>               \
         (num_sources, num_stations, offset_out, d_jones, d_I, d_l, d_m, d_n,\
@@ -245,3 +512,77 @@ void oskar_cross_correlate_scalar_gaussian_omp_d(
 {
     XCORR_SELECT(true, double, double2)
 }
+
+#define XCORR_FUSED_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2)                   \
+        oskar_xcorr_scalar_fused_omp<BS, TS, GAUSSIAN, REAL, REAL2>         \
+        (num_sources, num_stations, num_channels, offset_out,               \
+                station_tile, source_tile, d_jones,                         \
+                d_I, d_l, d_m, d_n, d_a, d_b, d_c,                          \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,     \
+                uv_filter_in_metres, inv_wavelength, inv_wavelength_inc,    \
+                frac_bandwidth, time_int_sec,                               \
+                gha0_rad, dec0_rad, source_filter_min, source_filter_max,   \
+                ignore_w_components, d_vis);
+
+#define XCORR_FUSED_SELECT(GAUSSIAN, REAL, REAL2)                           \
+        if (frac_bandwidth == (REAL)0 && time_int_sec == (REAL)0)           \
+            XCORR_FUSED_KERNEL(false, false, GAUSSIAN, REAL, REAL2)         \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec == (REAL)0)      \
+            XCORR_FUSED_KERNEL(true, false, GAUSSIAN, REAL, REAL2)          \
+        else if (frac_bandwidth == (REAL)0 && time_int_sec != (REAL)0)      \
+            XCORR_FUSED_KERNEL(false, true, GAUSSIAN, REAL, REAL2)          \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec != (REAL)0)      \
+            XCORR_FUSED_KERNEL(true, true, GAUSSIAN, REAL, REAL2)
+
+void oskar_cross_correlate_scalar_fused_omp_f(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const float2* d_jones, const float* d_I, const float* d_l,
+        const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b,
+        const float* d_c, const float* d_station_u,
+        const float* d_station_v, const float* d_station_w,
+        const float* d_station_x, const float* d_station_y,
+        float uv_min_lambda, float uv_max_lambda, int uv_filter_in_metres,
+        float inv_wavelength, float inv_wavelength_inc,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float source_filter_min, float source_filter_max,
+        int ignore_w_components, float2* d_vis)
+{
+    if (use_extended)
+    {
+        XCORR_FUSED_SELECT(true, float, float2)
+    }
+    else
+    {
+        XCORR_FUSED_SELECT(false, float, float2)
+    }
+}
+
+void oskar_cross_correlate_scalar_fused_omp_d(
+        int use_extended, int num_sources, int num_stations,
+        int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const double2* d_jones, const double* d_I, const double* d_l,
+        const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b,
+        const double* d_c, const double* d_station_u,
+        const double* d_station_v, const double* d_station_w,
+        const double* d_station_x, const double* d_station_y,
+        double uv_min_lambda, double uv_max_lambda, int uv_filter_in_metres,
+        double inv_wavelength, double inv_wavelength_inc,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double source_filter_min, double source_filter_max,
+        int ignore_w_components, double2* d_vis)
+{
+    if (use_extended)
+    {
+        XCORR_FUSED_SELECT(true, double, double2)
+    }
+    else
+    {
+        XCORR_FUSED_SELECT(false, double, double2)
+    }
+}
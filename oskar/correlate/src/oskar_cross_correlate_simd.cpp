@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "correlate/define_cross_correlate_simd.h"
+#include "correlate/oskar_cross_correlate_simd.h"
+#include "correlate/private_cross_correlate_simd.h"
+#include "math/private_simd_scalar.h"
+
+OSKAR_XCORR_FUSED_SIMD_DEFINE(oskar_cross_correlate_fused_scalar_f,
+        oskar_simd_scalar<float>, float, float4c)
+OSKAR_XCORR_FUSED_SIMD_DEFINE(oskar_cross_correlate_fused_scalar_d,
+        oskar_simd_scalar<double>, double, double4c)
+
+static int simd_isa = -1;
+
+int oskar_cross_correlate_simd_isa(void)
+{
+    if (simd_isa < 0)
+    {
+        int isa = OSKAR_SIMD_NONE;
+#ifdef OSKAR_HAVE_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            isa = OSKAR_SIMD_AVX2;
+#ifdef OSKAR_HAVE_AVX512
+        if (__builtin_cpu_supports("avx512f"))
+            isa = OSKAR_SIMD_AVX512;
+#endif
+#endif
+        simd_isa = isa;
+    }
+    return simd_isa;
+}
+
+const char* oskar_cross_correlate_simd_isa_name(int isa)
+{
+    switch (isa)
+    {
+    case OSKAR_SIMD_AVX2:   return "AVX2";
+    case OSKAR_SIMD_AVX512: return "AVX-512";
+    default:                return "scalar";
+    }
+}
+
+#define SIMD_DISPATCH(FP)                                                   \
+        const int available = oskar_cross_correlate_simd_isa();             \
+        if (isa > available) isa = available;                               \
+        switch (isa)                                                        \
+        {                                                                   \
+        SIMD_CASE_AVX512(FP)                                                \
+        SIMD_CASE_AVX2(FP)                                                  \
+        default:                                                            \
+            oskar_cross_correlate_fused_scalar_ ## FP SIMD_ARGS;            \
+        }
+
+#ifdef OSKAR_HAVE_AVX2
+#define SIMD_CASE_AVX2(FP) case OSKAR_SIMD_AVX2:                            \
+        oskar_cross_correlate_fused_avx2_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX2(FP)
+#endif
+#ifdef OSKAR_HAVE_AVX512
+#define SIMD_CASE_AVX512(FP) case OSKAR_SIMD_AVX512:                        \
+        oskar_cross_correlate_fused_avx512_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX512(FP)
+#endif
+
+#define SIMD_ARGS (use_extended, num_sources, num_stations, num_channels,   \
+        offset_out, station_tile, source_tile,                              \
+        jones, jones_stride, I, Q, U, V, flux_stride,                       \
+        l, m, n, a, b, c, station_u, station_v, station_w,                  \
+        station_x, station_y, uv_min_lambda, uv_max_lambda,                 \
+        uv_filter_in_metres, inv_wavelength, inv_wavelength_inc,            \
+        frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,                   \
+        source_filter_min, source_filter_max, ignore_w_components, vis)
+
+void oskar_cross_correlate_fused_simd_f(int isa, int use_extended,
+        int num_sources, int num_stations, int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const float* jones, int jones_stride,
+        const float* I, const float* Q, const float* U, const float* V,
+        int flux_stride, const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        int uv_filter_in_metres, float inv_wavelength,
+        float inv_wavelength_inc, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* vis)
+{
+    SIMD_DISPATCH(f)
+}
+
+void oskar_cross_correlate_fused_simd_d(int isa, int use_extended,
+        int num_sources, int num_stations, int num_channels, int offset_out,
+        int station_tile, int source_tile,
+        const double* jones, int jones_stride,
+        const double* I, const double* Q, const double* U, const double* V,
+        int flux_stride, const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        int uv_filter_in_metres, double inv_wavelength,
+        double inv_wavelength_inc, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* vis)
+{
+    SIMD_DISPATCH(d)
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/* This file must be compiled with AVX2 and FMA instructions enabled. */
+
+#include "correlate/define_cross_correlate_simd.h"
+#include "correlate/private_cross_correlate_simd.h"
+#include "math/private_simd_avx2.h"
+
+OSKAR_XCORR_FUSED_SIMD_DEFINE(oskar_cross_correlate_fused_avx2_f,
+        oskar_simd_avx2_f, float, float4c)
+OSKAR_XCORR_FUSED_SIMD_DEFINE(oskar_cross_correlate_fused_avx2_d,
+        oskar_simd_avx2_d, double, double4c)
@@ -8,8 +8,13 @@
 #include "utility/oskar_timer.h"
 
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_fused.h"
+#include "correlate/oskar_cross_correlate_simd.h"
+#include "interferometer/oskar_evaluate_jones_K.h"
+#include "interferometer/oskar_jones_join.h"
 #include "utility/oskar_get_error_string.h"
 #include "math/oskar_kahan_sum.h"
+#include <cfloat>
 #include <cstdlib>
 
 // Comment out this line to disable benchmark timer printing.
@@ -216,6 +221,449 @@ protected:
                 time2 * 1000.0);
 #endif
     }
+
+    void run_test_fused(int prec, int matrix, int extended,
+            double time_average, double freq_average)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *vis1, *vis2;
+        oskar_Jones *K, *J;
+        const double frequency = 100e6;
+        const double filter_min = 1.2, filter_max = 1.8;
+
+        // Create the test data and visibility arrays.
+        create_test_data(prec, OSKAR_CPU, matrix);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        oskar_telescope_set_channel_bandwidth(tel, freq_average);
+        oskar_telescope_set_time_average(tel, time_average);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Evaluate K-Jones and join with the other Jones terms.
+        K = oskar_jones_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+                num_stations, num_sources, &status);
+        J = oskar_jones_create(type, OSKAR_CPU,
+                num_stations, num_sources, &status);
+        oskar_evaluate_jones_K(K, num_sources,
+                src_dir[0], src_dir[1], src_dir[2], uvw[0], uvw[1], uvw[2],
+                frequency, src_flux[0], filter_min, filter_max, 0, &status);
+        oskar_jones_join(J, K, jones, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate using the joined Jones matrices.
+        oskar_cross_correlate(extended, num_sources, J,
+                src_flux, src_dir, src_ext,
+                tel, uvw, 1.0, frequency, 0, vis1, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate using the fused interferometer phase.
+        oskar_cross_correlate_fused(extended, num_sources, jones,
+                src_flux, src_dir, src_ext, filter_min, filter_max, 0,
+                tel, uvw, 1.0, frequency, 0, vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Compare results.
+        check_values(vis1, vis2);
+
+        // Free memory.
+        oskar_jones_free(K, &status);
+        oskar_jones_free(J, &status);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        destroy_test_data();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    void run_test_fused_channels(int prec, int matrix, int extended,
+            double time_average, double freq_average)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *vis1, *vis2, *jones_chan, *flux_chan[4];
+        const int num_channels = 5;
+        const double freq_start = 100e6, freq_inc = 5e6;
+        const double filter_min = 1.2, filter_max = 1.8;
+
+        // Create the test data and visibility arrays.
+        create_test_data(prec, OSKAR_CPU, matrix);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU,
+                num_baselines * num_channels, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU,
+                num_baselines * num_channels, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        jones_chan = oskar_mem_create(type, OSKAR_CPU,
+                num_stations * num_sources * num_channels, &status);
+        for (int i = 0; i < 4; ++i)
+            flux_chan[i] = oskar_mem_create(prec, OSKAR_CPU,
+                    num_sources * num_channels, &status);
+        oskar_telescope_set_channel_bandwidth(tel, freq_average);
+        oskar_telescope_set_time_average(tel, time_average);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate each channel separately, using different Jones matrices
+        // and fluxes for each channel, and store them for the batch.
+        for (int c = 0; c < num_channels; ++c)
+        {
+            const double scale = 1.0 + 0.1 * c;
+            oskar_Mem* flux[4];
+            oskar_Jones* J = oskar_jones_create_copy(jones, OSKAR_CPU,
+                    &status);
+            oskar_mem_scale_real(oskar_jones_mem(J), scale,
+                    0, num_stations * num_sources, &status);
+            for (int i = 0; i < 4; ++i)
+            {
+                flux[i] = oskar_mem_create_copy(src_flux[i], OSKAR_CPU,
+                        &status);
+                oskar_mem_scale_real(flux[i], scale, 0, num_sources, &status);
+            }
+            oskar_cross_correlate_fused(extended, num_sources, J,
+                    flux, src_dir, src_ext, filter_min, filter_max, 0,
+                    tel, uvw, 1.0, freq_start + c * freq_inc,
+                    c * num_baselines, vis1, &status);
+            for (int j = 0; j < num_stations * num_sources; ++j)
+                oskar_mem_copy_contents(jones_chan, oskar_jones_mem(J),
+                        j * num_channels + c, j, 1, &status);
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < num_sources; ++j)
+                    oskar_mem_copy_contents(flux_chan[i], flux[i],
+                            j * num_channels + c, j, 1, &status);
+                oskar_mem_free(flux[i], &status);
+            }
+            oskar_jones_free(J, &status);
+        }
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate all channels in one pass.
+        const oskar_Mem* const src_flux_chan[] = {
+                flux_chan[0], flux_chan[1], flux_chan[2], flux_chan[3]
+        };
+        oskar_cross_correlate_fused_channels(extended, num_sources,
+                num_channels, jones_chan, src_flux_chan, src_dir, src_ext,
+                filter_min, filter_max, 0, tel, uvw, 1.0,
+                freq_start, freq_inc, 0, vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Compare results.
+        check_values(vis2, vis1);
+
+        // Free memory.
+        oskar_mem_free(jones_chan, &status);
+        for (int i = 0; i < 4; ++i)
+            oskar_mem_free(flux_chan[i], &status);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        destroy_test_data();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    void run_test_fused_soa(int prec, int extended,
+            double time_average, double freq_average)
+    {
+        int num_baselines, status = 0, type, stride;
+        oskar_Mem *vis1, *vis2, *jones_chan, *jones_soa, *flux_chan[4];
+        oskar_Mem *flux_soa[4];
+        const int num_channels = 3;
+        const double freq_start = 100e6, freq_inc = 5e6;
+        const double filter_min = 1.2, filter_max = 1.8;
+
+        // Create the test data and visibility arrays.
+        create_test_data(prec, OSKAR_CPU, 1);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX | OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU,
+                num_baselines * num_channels, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU,
+                num_baselines * num_channels, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        jones_chan = oskar_mem_create(type, OSKAR_CPU,
+                num_stations * num_sources * num_channels, &status);
+        stride = oskar_jones_soa_stride(jones);
+        jones_soa = oskar_mem_create(prec, OSKAR_CPU,
+                num_stations * num_channels * 8 * stride, &status);
+        for (int i = 0; i < 4; ++i)
+        {
+            flux_chan[i] = oskar_mem_create(prec, OSKAR_CPU,
+                    num_sources * num_channels, &status);
+            flux_soa[i] = oskar_mem_create(prec, OSKAR_CPU,
+                    num_sources * num_channels, &status);
+        }
+        oskar_telescope_set_channel_bandwidth(tel, freq_average);
+        oskar_telescope_set_time_average(tel, time_average);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Store the Jones matrices and fluxes for each channel,
+        // in both layouts.
+        for (int c = 0; c < num_channels; ++c)
+        {
+            const double scale = 1.0 + 0.1 * c;
+            const size_t block = 8 * stride;
+            oskar_Jones* J = oskar_jones_create_copy(jones, OSKAR_CPU,
+                    &status);
+            oskar_mem_scale_real(oskar_jones_mem(J), scale,
+                    0, num_stations * num_sources, &status);
+            oskar_jones_set_soa_enabled(J, 1, &status);
+            oskar_jones_convert_to_soa(J, 0, num_stations, &status);
+            for (int j = 0; j < num_stations * num_sources; ++j)
+                oskar_mem_copy_contents(jones_chan, oskar_jones_mem(J),
+                        j * num_channels + c, j, 1, &status);
+            for (int j = 0; j < num_stations; ++j)
+                oskar_mem_copy_contents(jones_soa, oskar_jones_soa(J),
+                        (j * num_channels + c) * block, j * block, block,
+                        &status);
+            for (int i = 0; i < 4; ++i)
+            {
+                oskar_Mem* flux = oskar_mem_create_copy(src_flux[i],
+                        OSKAR_CPU, &status);
+                oskar_mem_scale_real(flux, scale, 0, num_sources, &status);
+                for (int j = 0; j < num_sources; ++j)
+                    oskar_mem_copy_contents(flux_chan[i], flux,
+                            j * num_channels + c, j, 1, &status);
+                oskar_mem_copy_contents(flux_soa[i], flux,
+                        c * num_sources, 0, num_sources, &status);
+                oskar_mem_free(flux, &status);
+            }
+            oskar_jones_free(J, &status);
+        }
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate using the array-of-structures Jones matrices.
+        const oskar_Mem* const src_flux_chan[] = {
+                flux_chan[0], flux_chan[1], flux_chan[2], flux_chan[3]
+        };
+        oskar_cross_correlate_fused_channels(extended, num_sources,
+                num_channels, jones_chan, src_flux_chan, src_dir, src_ext,
+                filter_min, filter_max, 0, tel, uvw, 1.0,
+                freq_start, freq_inc, 0, vis1, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate using the structure-of-arrays Jones matrices.
+        const oskar_Mem* const src_flux_soa[] = {
+                flux_soa[0], flux_soa[1], flux_soa[2], flux_soa[3]
+        };
+        // Use cache blocking here, to check it against the unblocked version.
+        oskar_mem_clear_contents(vis2, &status);
+        oskar_telescope_set_correlator_tiling(tel, 1, 4, 50);
+        oskar_cross_correlate_fused_soa(extended, num_sources,
+                num_channels, jones_soa, stride, src_flux_soa, num_sources,
+                src_dir, src_ext, filter_min, filter_max, 0, tel, uvw, 1.0,
+                freq_start, freq_inc, 0, vis2, &status);
+        oskar_telescope_set_correlator_tiling(tel, 0, 0, 0);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        check_values(vis2, vis1);
+
+        // Check each available instruction set against the scalar version.
+        const int num_isa = oskar_cross_correlate_simd_isa() + 1;
+        oskar_Mem* vis_isa[3];
+        for (int isa = 0; isa < num_isa; ++isa)
+        {
+            const double inv_wavelength = freq_start / 299792458.0;
+            const double inv_wavelength_inc = freq_inc / 299792458.0;
+            const double frac_bandwidth = freq_average / freq_start;
+            const oskar_Mem* x =
+                    oskar_telescope_station_true_offset_ecef_metres_const(
+                            tel, 0);
+            const oskar_Mem* y =
+                    oskar_telescope_station_true_offset_ecef_metres_const(
+                            tel, 1);
+            vis_isa[isa] = oskar_mem_create(type, OSKAR_CPU,
+                    num_baselines * num_channels, &status);
+            oskar_mem_clear_contents(vis_isa[isa], &status);
+            if (prec == OSKAR_SINGLE)
+                oskar_cross_correlate_fused_simd_f(isa, extended,
+                        num_sources, num_stations, num_channels, 0, 0, 0,
+                        oskar_mem_float_const(jones_soa, &status), stride,
+                        oskar_mem_float_const(flux_soa[0], &status),
+                        oskar_mem_float_const(flux_soa[1], &status),
+                        oskar_mem_float_const(flux_soa[2], &status),
+                        oskar_mem_float_const(flux_soa[3], &status),
+                        num_sources,
+                        oskar_mem_float_const(src_dir[0], &status),
+                        oskar_mem_float_const(src_dir[1], &status),
+                        oskar_mem_float_const(src_dir[2], &status),
+                        oskar_mem_float_const(src_ext[0], &status),
+                        oskar_mem_float_const(src_ext[1], &status),
+                        oskar_mem_float_const(src_ext[2], &status),
+                        oskar_mem_float_const(uvw[0], &status),
+                        oskar_mem_float_const(uvw[1], &status),
+                        oskar_mem_float_const(uvw[2], &status),
+                        oskar_mem_float_const(x, &status),
+                        oskar_mem_float_const(y, &status),
+                        0.0f, FLT_MAX, 0, (float) inv_wavelength,
+                        (float) inv_wavelength_inc, (float) frac_bandwidth,
+                        (float) time_average, 1.0f, 0.5f,
+                        (float) filter_min, (float) filter_max, 0,
+                        oskar_mem_float4c(vis_isa[isa], &status));
+            else
+                oskar_cross_correlate_fused_simd_d(isa, extended,
+                        num_sources, num_stations, num_channels, 0, 0, 0,
+                        oskar_mem_double_const(jones_soa, &status), stride,
+                        oskar_mem_double_const(flux_soa[0], &status),
+                        oskar_mem_double_const(flux_soa[1], &status),
+                        oskar_mem_double_const(flux_soa[2], &status),
+                        oskar_mem_double_const(flux_soa[3], &status),
+                        num_sources,
+                        oskar_mem_double_const(src_dir[0], &status),
+                        oskar_mem_double_const(src_dir[1], &status),
+                        oskar_mem_double_const(src_dir[2], &status),
+                        oskar_mem_double_const(src_ext[0], &status),
+                        oskar_mem_double_const(src_ext[1], &status),
+                        oskar_mem_double_const(src_ext[2], &status),
+                        oskar_mem_double_const(uvw[0], &status),
+                        oskar_mem_double_const(uvw[1], &status),
+                        oskar_mem_double_const(uvw[2], &status),
+                        oskar_mem_double_const(x, &status),
+                        oskar_mem_double_const(y, &status),
+                        0.0, DBL_MAX, 0, inv_wavelength, inv_wavelength_inc,
+                        frac_bandwidth, time_average, 1.0, 0.5,
+                        filter_min, filter_max, 0,
+                        oskar_mem_double4c(vis_isa[isa], &status));
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            if (isa > 0) check_values(vis_isa[isa], vis_isa[0]);
+        }
+
+        // Free memory.
+        for (int isa = 0; isa < num_isa; ++isa)
+            oskar_mem_free(vis_isa[isa], &status);
+        oskar_mem_free(jones_chan, &status);
+        oskar_mem_free(jones_soa, &status);
+        for (int i = 0; i < 4; ++i)
+        {
+            oskar_mem_free(flux_chan[i], &status);
+            oskar_mem_free(flux_soa[i], &status);
+        }
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        destroy_test_data();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    void run_test_tiled(int prec, int extended, int station_tile,
+            int source_tile, double time_average, double freq_average)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *vis1, *vis2;
+        double frequency = 100e6;
+
+        // Create the test data.
+        create_test_data(prec, OSKAR_CPU, 1);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX | OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        oskar_telescope_set_channel_bandwidth(tel, freq_average);
+        oskar_telescope_set_time_average(tel, time_average);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate without cache blocking.
+        oskar_telescope_set_correlator_tiling(tel, 0, 0, 0);
+        oskar_cross_correlate(extended, num_sources, jones,
+                src_flux, src_dir, src_ext,
+                tel, uvw, 1.0, frequency, 0, vis1, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate with cache blocking.
+        oskar_telescope_set_correlator_tiling(tel, 1,
+                station_tile, source_tile);
+        oskar_cross_correlate(extended, num_sources, jones,
+                src_flux, src_dir, src_ext,
+                tel, uvw, 1.0, frequency, 0, vis2, &status);
+        destroy_test_data();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Sources are summed in the same order, so results should match.
+        EXPECT_EQ(0, oskar_mem_different(vis1, vis2, 0, &status));
+        check_values(vis2, vis1);
+
+        // Free memory.
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    void run_test_fused_tiled(int prec, int matrix, int extended,
+            int station_tile, int source_tile,
+            double time_average, double freq_average)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *vis1, *vis2;
+        const int num_channels = 3;
+        const double freq_start = 100e6, freq_inc = 5e6;
+        oskar_Mem *jones_chan, *flux_chan[4];
+
+        // Create the test data, using the same Jones matrices and fluxes
+        // for each channel.
+        create_test_data(prec, OSKAR_CPU, matrix);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU,
+                num_baselines * num_channels, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU,
+                num_baselines * num_channels, &status);
+        jones_chan = oskar_mem_create(type, OSKAR_CPU,
+                num_stations * num_sources * num_channels, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        for (int i = 0; i < 4; ++i)
+            flux_chan[i] = oskar_mem_create(prec, OSKAR_CPU,
+                    num_sources * num_channels, &status);
+        for (int c = 0; c < num_channels; ++c)
+        {
+            for (int j = 0; j < num_stations * num_sources; ++j)
+                oskar_mem_copy_contents(jones_chan, oskar_jones_mem(jones),
+                        j * num_channels + c, j, 1, &status);
+            for (int i = 0; i < 4; ++i)
+                for (int j = 0; j < num_sources; ++j)
+                    oskar_mem_copy_contents(flux_chan[i], src_flux[i],
+                            j * num_channels + c, j, 1, &status);
+        }
+        const oskar_Mem* const src_flux_chan[] = {
+                flux_chan[0], flux_chan[1], flux_chan[2], flux_chan[3]
+        };
+        oskar_telescope_set_channel_bandwidth(tel, freq_average);
+        oskar_telescope_set_time_average(tel, time_average);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate without cache blocking.
+        oskar_telescope_set_correlator_tiling(tel, 0, 0, 0);
+        oskar_cross_correlate_fused_channels(extended, num_sources,
+                num_channels, jones_chan, src_flux_chan, src_dir, src_ext,
+                0.0, DBL_MAX, 0, tel, uvw, 1.0, freq_start, freq_inc, 0,
+                vis1, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate with cache blocking.
+        oskar_telescope_set_correlator_tiling(tel, 1,
+                station_tile, source_tile);
+        oskar_cross_correlate_fused_channels(extended, num_sources,
+                num_channels, jones_chan, src_flux_chan, src_dir, src_ext,
+                0.0, DBL_MAX, 0, tel, uvw, 1.0, freq_start, freq_inc, 0,
+                vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Sources are summed in different blocks, so only check values.
+        check_values(vis2, vis1);
+
+        // Free memory.
+        oskar_mem_free(jones_chan, &status);
+        for (int i = 0; i < 4; ++i)
+            oskar_mem_free(flux_chan[i], &status);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        destroy_test_data();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
 };
 
 
@@ -247,6 +695,148 @@ TEST_F(cross_correlate, CPU)
     }
 }
 
+// CPU only.
+// Check the fused K-Jones correlator against K-Jones join and correlate.
+TEST_F(cross_correlate, fused_CPU)
+{
+    const int precision[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+    const int matrix_type[] = {0, 1};
+    const int source_type[] = {0, 1};
+    const double time_avg[] = {0.0, 10.0};
+    const double freq_avg[] = {0.0, 1.e4};
+    for (int i_prec = 0; i_prec < 2; ++i_prec)
+    {
+        for (int i_matrix_type = 0; i_matrix_type < 2; ++i_matrix_type)
+        {
+            for (int i_source_type = 0; i_source_type < 2; ++i_source_type)
+            {
+                for (int i_time_avg = 0; i_time_avg < 2; ++i_time_avg)
+                {
+                    for (int i_freq_avg = 0; i_freq_avg < 2; ++i_freq_avg)
+                    {
+                        run_test_fused(precision[i_prec],
+                                matrix_type[i_matrix_type],
+                                source_type[i_source_type],
+                                time_avg[i_time_avg],
+                                freq_avg[i_freq_avg]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// CPU only.
+// Check the channel-batched correlator against separate channels.
+TEST_F(cross_correlate, fused_channels_CPU)
+{
+    const int precision[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+    const int matrix_type[] = {0, 1};
+    const int source_type[] = {0, 1};
+    const double time_avg[] = {0.0, 10.0};
+    const double freq_avg[] = {0.0, 1.e4};
+    for (int i_prec = 0; i_prec < 2; ++i_prec)
+    {
+        for (int i_matrix_type = 0; i_matrix_type < 2; ++i_matrix_type)
+        {
+            for (int i_source_type = 0; i_source_type < 2; ++i_source_type)
+            {
+                for (int i_time_avg = 0; i_time_avg < 2; ++i_time_avg)
+                {
+                    for (int i_freq_avg = 0; i_freq_avg < 2; ++i_freq_avg)
+                    {
+                        run_test_fused_channels(precision[i_prec],
+                                matrix_type[i_matrix_type],
+                                source_type[i_source_type],
+                                time_avg[i_time_avg],
+                                freq_avg[i_freq_avg]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// CPU only.
+// Check the vectorised correlator against the array-of-structures version.
+TEST_F(cross_correlate, fused_soa_CPU)
+{
+    const int precision[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+    const int source_type[] = {0, 1};
+    const double time_avg[] = {0.0, 10.0};
+    const double freq_avg[] = {0.0, 1.e4};
+    for (int i_prec = 0; i_prec < 2; ++i_prec)
+    {
+        for (int i_source_type = 0; i_source_type < 2; ++i_source_type)
+        {
+            for (int i_time_avg = 0; i_time_avg < 2; ++i_time_avg)
+            {
+                for (int i_freq_avg = 0; i_freq_avg < 2; ++i_freq_avg)
+                {
+                    run_test_fused_soa(precision[i_prec],
+                            source_type[i_source_type],
+                            time_avg[i_time_avg],
+                            freq_avg[i_freq_avg]);
+                }
+            }
+        }
+    }
+}
+
+// CPU only.
+// Check the cache-blocked correlator against the unblocked version.
+TEST_F(cross_correlate, tiled_CPU)
+{
+    const int precision[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+    const int source_type[] = {0, 1};
+    const int tile_size[][2] = {{0, 0}, {4, 50}, {1, 1}, {64, 1000}};
+    const double time_avg[] = {0.0, 10.0};
+    const double freq_avg[] = {0.0, 1.e4};
+    for (int i_prec = 0; i_prec < 2; ++i_prec)
+    {
+        for (int i_source_type = 0; i_source_type < 2; ++i_source_type)
+        {
+            for (int i_tile = 0; i_tile < 4; ++i_tile)
+            {
+                for (int i_avg = 0; i_avg < 2; ++i_avg)
+                {
+                    run_test_tiled(precision[i_prec],
+                            source_type[i_source_type],
+                            tile_size[i_tile][0], tile_size[i_tile][1],
+                            time_avg[i_avg], freq_avg[i_avg]);
+                }
+            }
+        }
+    }
+}
+
+// CPU only.
+// Check the cache-blocked fused correlator against the unblocked version.
+TEST_F(cross_correlate, fused_tiled_CPU)
+{
+    const int precision[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+    const int matrix_type[] = {0, 1};
+    const int tile_size[][2] = {{0, 0}, {4, 50}, {1, 1}, {64, 1000}};
+    const double time_avg[] = {0.0, 10.0};
+    const double freq_avg[] = {0.0, 1.e4};
+    for (int i_prec = 0; i_prec < 2; ++i_prec)
+    {
+        for (int i_matrix_type = 0; i_matrix_type < 2; ++i_matrix_type)
+        {
+            for (int i_tile = 0; i_tile < 4; ++i_tile)
+            {
+                for (int i_avg = 0; i_avg < 2; ++i_avg)
+                {
+                    run_test_fused_tiled(precision[i_prec],
+                            matrix_type[i_matrix_type], i_avg,
+                            tile_size[i_tile][0], tile_size[i_tile][1],
+                            time_avg[i_avg], freq_avg[i_avg]);
+                }
+            }
+        }
+    }
+}
+
 #ifdef OSKAR_HAVE_CUDA
 // Check for consistency between CPU and CUDA versions.
 TEST_F(cross_correlate, CUDA)
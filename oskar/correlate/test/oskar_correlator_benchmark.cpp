@@ -6,6 +6,7 @@
 #include "settings/oskar_option_parser.h"
 #include "correlate/oskar_cross_correlate.h"
 #include "interferometer/oskar_jones.h"
+#include "mem/oskar_mem.h"
 #include "telescope/oskar_telescope.h"
 #include "utility/oskar_get_error_string.h"
 #include "utility/oskar_timer.h"
@@ -21,8 +22,16 @@
 static void benchmark(int num_stations, int num_sources, int type,
         int jones_type, int location, int use_extended,
         int use_bandwidth_smearing, int use_time_smearing,
+        int use_tiling, int station_tile, int source_tile,
         int niter, std::vector<double>& times, const std::string& ascii_file,
-        int* status);
+        oskar_Mem** vis_out, int* status);
+
+static double mean(const std::vector<double>& times)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < times.size(); ++i) sum += times[i];
+    return times.empty() ? 0.0 : sum / times.size();
+}
 
 int main(int argc, char** argv)
 {
@@ -37,6 +46,11 @@ int main(int argc, char** argv)
     opt.add_flag("-e", "Use Gaussian sources (default: point sources).");
     opt.add_flag("-b", "Use bandwidth smearing (default: no bandwidth smearing).");
     opt.add_flag("-t", "Use time smearing (default: no time smearing).");
+    opt.add_flag("-tile", "Station and source block sizes for the CPU "
+            "correlator, as <stations>,<sources> (0 = auto).", 1, "0,0");
+    opt.add_flag("-notile", "Disable cache blocking in the CPU correlator.");
+    opt.add_flag("-cmp", "Compare timings and results of the CPU correlator "
+            "with and without cache blocking.");
     opt.add_flag("-r", "Dump raw iteration data to this file.", 1);
     opt.add_flag("-a", "Dump ASCII visibility data to this file.", 1);
     opt.add_flag("-std", "Discard values greater than this number of standard "
@@ -58,6 +72,14 @@ int main(int argc, char** argv)
     int use_extended = opt.is_set("-e") ? OSKAR_TRUE : OSKAR_FALSE;
     int use_bandwidth_smearing = opt.is_set("-b") ? OSKAR_TRUE : OSKAR_FALSE;
     int use_time_smearing = opt.is_set("-t") ? OSKAR_TRUE : OSKAR_FALSE;
+    int use_tiling = opt.is_set("-notile") ? OSKAR_FALSE : OSKAR_TRUE;
+    int station_tile = 0, source_tile = 0;
+    if (opt.is_set("-tile") && sscanf(opt.get_string("-tile"), "%d,%d",
+            &station_tile, &source_tile) != 2)
+    {
+        opt.error("Tile sizes must be given as <stations>,<sources>");
+        return EXIT_FAILURE;
+    }
     std::string raw_file, ascii_file;
     if (opt.is_set("-r"))
         raw_file = opt.get_string("-r");
@@ -89,6 +111,13 @@ int main(int argc, char** argv)
                 "true" : "false");
         printf("- Time smearing: %s\n", (use_time_smearing) ?
                 "true" : "false");
+        if (location == OSKAR_CPU)
+        {
+            printf("- Cache blocking: %s\n", use_tiling ? "true" : "false");
+            if (use_tiling)
+                printf("- Tile sizes (0 = auto): %i stations, %i sources\n",
+                        station_tile, source_tile);
+        }
         printf("- Number of iterations: %i\n", niter);
         if (max_std_dev > 0.0)
             printf("- Max standard deviations: %f\n", max_std_dev);
@@ -101,9 +130,45 @@ int main(int argc, char** argv)
     oskar_device_set_require_double_precision(type == OSKAR_DOUBLE);
     double time_taken_sec = 0.0, average_time_sec = 0.0;
     std::vector<double> times;
+    if (opt.is_set("-cmp"))
+    {
+        double min_err = 0.0, max_err = 0.0, avg_err = 0.0, std_err = 0.0;
+        oskar_Mem *vis_ref = 0, *vis_tiled = 0;
+        std::vector<double> times_tiled;
+        if (location != OSKAR_CPU)
+        {
+            opt.error("Comparison mode (-cmp) requires the CPU (-c)");
+            return EXIT_FAILURE;
+        }
+        benchmark(num_stations, num_sources, type, jones_type, location,
+                use_extended, use_bandwidth_smearing, use_time_smearing,
+                OSKAR_FALSE, 0, 0, niter, times, std::string(),
+                &vis_ref, &status);
+        benchmark(num_stations, num_sources, type, jones_type, location,
+                use_extended, use_bandwidth_smearing, use_time_smearing,
+                OSKAR_TRUE, station_tile, source_tile, niter, times_tiled,
+                ascii_file, &vis_tiled, &status);
+        oskar_mem_evaluate_relative_error(vis_tiled, vis_ref,
+                &min_err, &max_err, &avg_err, &std_err, &status);
+        oskar_mem_free(vis_ref, &status);
+        oskar_mem_free(vis_tiled, &status);
+        if (status)
+        {
+            fprintf(stderr, "ERROR: correlate failed with code %i: %s\n",
+                    status, oskar_get_error_string(status));
+            return EXIT_FAILURE;
+        }
+        const double time_ref = mean(times), time_tiled = mean(times_tiled);
+        printf("==> Time per iteration, unblocked: %f seconds.\n", time_ref);
+        printf("==> Time per iteration, blocked:   %f seconds.\n", time_tiled);
+        printf("==> Speed-up: %.3f\n", time_ref / time_tiled);
+        printf("==> Max relative difference: %.3e\n", max_err);
+        return EXIT_SUCCESS;
+    }
     benchmark(num_stations, num_sources, type, jones_type, location,
             use_extended, use_bandwidth_smearing, use_time_smearing,
-            niter, times, ascii_file, &status);
+            use_tiling, station_tile, source_tile,
+            niter, times, ascii_file, 0, &status);
 
     // Compute total time taken.
     for (int i = 0; i < niter; ++i)
@@ -192,8 +257,9 @@ int main(int argc, char** argv)
 void benchmark(int num_stations, int num_sources, int type,
         int jones_type, int location, int use_extended,
         int use_bandwidth_smearing, int use_time_smearing,
+        int use_tiling, int station_tile, int source_tile,
         int niter, std::vector<double>& times, const std::string& ascii_file,
-        int* status)
+        oskar_Mem** vis_out, int* status)
 {
     oskar_Timer* timer = oskar_timer_create(location);
 
@@ -229,6 +295,8 @@ void benchmark(int num_stations, int num_sources, int type,
     // Set options for bandwidth smearing, time smearing, extended sources.
     oskar_telescope_set_channel_bandwidth(tel, 10e6 * use_bandwidth_smearing);
     oskar_telescope_set_time_average(tel, 10 * use_time_smearing);
+    oskar_telescope_set_correlator_tiling(tel,
+            use_tiling, station_tile, source_tile);
 
     // Run benchmark.
     times.resize(niter);
@@ -258,7 +326,10 @@ void benchmark(int num_stations, int num_sources, int type,
     }
 
     // Free memory.
-    oskar_mem_free(vis, status);
+    if (vis_out)
+        *vis_out = vis;
+    else
+        oskar_mem_free(vis, status);
     oskar_jones_free(J, status);
     oskar_telescope_free(tel, status);
     for (int i = 0; i < 3; ++i)
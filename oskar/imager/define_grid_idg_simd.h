@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/*
+ * Direct Fourier transform of visibilities to a subgrid image, for IDG.
+ *
+ * This is included by each translation unit that implements the transform
+ * for a particular instruction set. The VEC template parameter is a wrapper
+ * around the native vector type, as described in math/define_simd_math.h.
+ *
+ * Pixels are processed in blocks. Within each block, the phase of each
+ * visibility is evaluated for all pixels at once using vectorised sincos,
+ * as the W-term makes the phase a nonlinear function of pixel position.
+ */
+
+#ifndef OSKAR_DEFINE_GRID_IDG_SIMD_H_
+#define OSKAR_DEFINE_GRID_IDG_SIMD_H_
+
+#include "oskar_global.h"
+#include "math/define_simd_math.h"
+
+/* Number of pixels in each block: a multiple of all vector widths. */
+#define OSKAR_GRID_IDG_SIMD_BLOCK 64
+
+template<typename VEC>
+void oskar_grid_idg_dft_simd(
+        const int                                 num_pixels,
+        const typename VEC::real* const RESTRICT  x,
+        const typename VEC::real* const RESTRICT  y,
+        const typename VEC::real* const RESTRICT  n,
+        const int                                 num_vis,
+        const typename VEC::real* const RESTRICT  au,
+        const typename VEC::real* const RESTRICT  av,
+        const typename VEC::real* const RESTRICT  aw,
+        const typename VEC::real* const RESTRICT  vis_re,
+        const typename VEC::real* const RESTRICT  vis_im,
+        typename VEC::real* RESTRICT              out_re,
+        typename VEC::real* RESTRICT              out_im)
+{
+    typedef typename VEC::real REAL;
+    typedef typename VEC::type V;
+    enum { B = OSKAR_GRID_IDG_SIMD_BLOCK };
+    int o0, i, k;
+    for (o0 = 0; o0 < num_pixels; o0 += B)
+    {
+        REAL xb[B], yb[B], nb[B], a_re[B], a_im[B];
+        const int nk = (num_pixels - o0 < (int) B) ? num_pixels - o0 : (int) B;
+        for (k = 0; k < (int) B; ++k)
+        {
+            xb[k] = (k < nk) ? x[o0 + k] : (REAL) 0;
+            yb[k] = (k < nk) ? y[o0 + k] : (REAL) 0;
+            nb[k] = (k < nk) ? n[o0 + k] : (REAL) 0;
+            a_re[k] = a_im[k] = (REAL) 0;
+        }
+        const int nv = ((nk + VEC::width - 1) / VEC::width) * VEC::width;
+        for (i = 0; i < num_vis; ++i)
+        {
+            const V u = VEC::set1(au[i]), v = VEC::set1(av[i]);
+            const V w = VEC::set1(aw[i]);
+            const V re = VEC::set1(vis_re[i]), im = VEC::set1(vis_im[i]);
+            for (k = 0; k < nv; k += VEC::width)
+            {
+                V s, c, t = VEC::mul(VEC::load(xb + k), u);
+                t = VEC::fmadd(VEC::load(yb + k), v, t);
+                t = VEC::fmadd(VEC::load(nb + k), w, t);
+                VEC::sincos(t, s, c);
+                V acc_re = VEC::fmadd(re, c, VEC::load(a_re + k));
+                V acc_im = VEC::fmadd(re, s, VEC::load(a_im + k));
+                VEC::store(a_re + k, VEC::fnmadd(im, s, acc_re));
+                VEC::store(a_im + k, VEC::fmadd(im, c, acc_im));
+            }
+        }
+        for (k = 0; k < nk; ++k)
+        {
+            out_re[o0 + k] = a_re[k];
+            out_im[o0 + k] = a_im[k];
+        }
+    }
+}
+
+/* Defines a C function for one instruction set and precision.
+ * The parameters are as for oskar_grid_idg_dft_simd_f(). */
+#define OSKAR_GRID_IDG_DFT_SIMD_DEFINE(NAME, VEC, FP)                       \
+void NAME(int num_pixels, const FP* x, const FP* y, const FP* n,            \
+        int num_vis, const FP* au, const FP* av, const FP* aw,              \
+        const FP* vis_re, const FP* vis_im, FP* out_re, FP* out_im)         \
+{                                                                           \
+    oskar_grid_idg_dft_simd<VEC>(num_pixels, x, y, n, num_vis,              \
+            au, av, aw, vis_re, vis_im, out_re, out_im);                    \
+}
+
+#endif /* include guard */
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_GRID_IDG_H_
+#define OSKAR_GRID_IDG_H_
+
+/**
+ * @file oskar_grid_idg.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Image-domain gridding function (double precision).
+ *
+ * @details
+ * Grids visibilities onto a stack of W planes using image-domain gridding.
+ *
+ * The grid is divided into tiles of half the subgrid size, and visibilities
+ * are sorted by baseline (if A-terms are used), W plane and tile.
+ * For each group, a small subgrid image is made by a direct Fourier
+ * transform of its visibilities, using their exact (u, v) positions and
+ * the difference between their w coordinate and that of the W plane.
+ * The image is multiplied by the taper and any A-terms, then transformed
+ * with an FFT and added to the W plane around the tile.
+ * Visibilities with negative w are gridded as their complex conjugate
+ * at (-u, -v, -w), with the stations swapped.
+ *
+ * Subgrids are processed in parallel in batches, and are added to the grid
+ * in a fixed order, so the results do not depend on the number of threads.
+ *
+ * The W planes are spaced linearly in w: the W plane index for a given w
+ * is round(|w| * w_scale), clamped to num_w_planes - 1, and the w value
+ * of plane k is k / w_scale. If grid_w_plane is negative, the grid holds
+ * num_w_planes complex planes of grid_size * grid_size cells, one after
+ * the other. Otherwise, the grid holds only W plane grid_w_plane, and
+ * visibilities on other W planes are ignored: they are neither gridded
+ * nor counted as skipped. Each plane must be transformed and
+ * multiplied by the conjugate of its W-term phase screen when finalised.
+ *
+ * If A-terms are supplied, the subgrid image of each visibility is
+ * multiplied by conj(A1) * A2, where A1 and A2 are the A-terms of its
+ * first and second station. The A-terms are sampled at the subgrid
+ * pixels given by oskar_grid_idg_subgrid_lmn_d(), and can be generated
+ * using oskar_station_beam() with these direction cosines.
+ *
+ * The normalisation is updated with the weight of each visibility
+ * multiplied by the square of the taper at the subgrid centre.
+ *
+ * Visibilities are skipped if their kernel would not fit inside the grid.
+ * The kernel, including the spread of the residual W-term, must also fit
+ * inside a quarter of the subgrid from its centre, so the W planes must be
+ * closely enough spaced for the range of w: use
+ * oskar_grid_idg_num_w_planes() to find how many are needed.
+ * If any visibility does not fit, no visibilities are gridded and the
+ * status code is set to OSKAR_ERR_OUT_OF_RANGE.
+ *
+ * @param[in] subgrid_size   Subgrid side length (must be a multiple of 4).
+ * @param[in] support        Taper kernel support size, in grid cells
+ *                           (must be less than subgrid_size / 4).
+ * @param[in] taper          Separable image-domain taper, length subgrid_size.
+ * @param[in] num_w_planes   Number of W planes.
+ * @param[in] w_scale        Scaling factor used to find W-plane index.
+ * @param[in] grid_w_plane   The only W plane to grid, or -1 for all.
+ * @param[in] num_stations   Number of stations with A-terms.
+ * @param[in] aterms         Complex A-terms for each station, or NULL.
+ * @param[in] station1       First station index of each visibility.
+ * @param[in] station2       Second station index of each visibility.
+ * @param[in] num_points     Number of visibility points.
+ * @param[in] uu             Visibility baseline uu coordinates, in wavelengths.
+ * @param[in] vv             Visibility baseline vv coordinates, in wavelengths.
+ * @param[in] ww             Visibility baseline ww coordinates, in wavelengths.
+ * @param[in] vis            Complex visibilities for each baseline.
+ * @param[in] weight         Visibility weight for each baseline.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] grid_size      Side length of grid.
+ * @param[out] num_skipped   Number of visibilities that were off the grid.
+ * @param[in,out] norm       Updated grid normalisation factor.
+ * @param[in,out] grid       Updated stack of complex visibility grids.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_grid_idg_d(
+        const int subgrid_size,
+        const int support,
+        const double* RESTRICT taper,
+        const int num_w_planes,
+        const double w_scale,
+        const int grid_w_plane,
+        const int num_stations,
+        const double* RESTRICT aterms,
+        const int* RESTRICT station1,
+        const int* RESTRICT station2,
+        const size_t num_points,
+        const double* RESTRICT uu,
+        const double* RESTRICT vv,
+        const double* RESTRICT ww,
+        const double* RESTRICT vis,
+        const double* RESTRICT weight,
+        const double cell_size_rad,
+        const int grid_size,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        double* RESTRICT grid,
+        int* status);
+
+/**
+ * @brief
+ * Image-domain gridding function (single precision).
+ *
+ * @details
+ * Grids visibilities onto a stack of W planes using image-domain gridding.
+ *
+ * See oskar_grid_idg_d() for details.
+ *
+ * @param[in] subgrid_size   Subgrid side length (must be a multiple of 4).
+ * @param[in] support        Taper kernel support size, in grid cells
+ *                           (must be less than subgrid_size / 4).
+ * @param[in] taper          Separable image-domain taper, length subgrid_size.
+ * @param[in] num_w_planes   Number of W planes.
+ * @param[in] w_scale        Scaling factor used to find W-plane index.
+ * @param[in] grid_w_plane   The only W plane to grid, or -1 for all.
+ * @param[in] num_stations   Number of stations with A-terms.
+ * @param[in] aterms         Complex A-terms for each station, or NULL.
+ * @param[in] station1       First station index of each visibility.
+ * @param[in] station2       Second station index of each visibility.
+ * @param[in] num_points     Number of visibility points.
+ * @param[in] uu             Visibility baseline uu coordinates, in wavelengths.
+ * @param[in] vv             Visibility baseline vv coordinates, in wavelengths.
+ * @param[in] ww             Visibility baseline ww coordinates, in wavelengths.
+ * @param[in] vis            Complex visibilities for each baseline.
+ * @param[in] weight         Visibility weight for each baseline.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] grid_size      Side length of grid.
+ * @param[out] num_skipped   Number of visibilities that were off the grid.
+ * @param[in,out] norm       Updated grid normalisation factor.
+ * @param[in,out] grid       Updated stack of complex visibility grids.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_grid_idg_f(
+        const int subgrid_size,
+        const int support,
+        const float* RESTRICT taper,
+        const int num_w_planes,
+        const double w_scale,
+        const int grid_w_plane,
+        const int num_stations,
+        const float* RESTRICT aterms,
+        const int* RESTRICT station1,
+        const int* RESTRICT station2,
+        const size_t num_points,
+        const float* RESTRICT uu,
+        const float* RESTRICT vv,
+        const float* RESTRICT ww,
+        const float* RESTRICT vis,
+        const float* RESTRICT weight,
+        const float cell_size_rad,
+        const int grid_size,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        float* RESTRICT grid,
+        int* status);
+
+/**
+ * @brief
+ * Returns the number of W planes needed for image-domain gridding.
+ *
+ * @details
+ * Returns the smallest number of W planes that keeps the kernel of every
+ * visibility with |w| <= w_max inside its subgrid, if the W scale passed
+ * to oskar_grid_idg_d() or oskar_grid_idg_f() is (num_w_planes - 1) / w_max.
+ * If w_max is zero, one plane is needed, and the W scale should be zero.
+ *
+ * @param[in] subgrid_size   Subgrid side length.
+ * @param[in] support        Taper kernel support size, in grid cells
+ *                           (must be less than subgrid_size / 4).
+ * @param[in] w_max          Maximum |w| of the visibilities, in wavelengths.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] grid_size      Side length of grid.
+ */
+OSKAR_EXPORT
+int oskar_grid_idg_num_w_planes(const int subgrid_size, const int support,
+        const double w_max, const double cell_size_rad, const int grid_size);
+
+/**
+ * @brief
+ * Returns the direction cosines of the pixels in an IDG subgrid.
+ *
+ * @details
+ * Returns the direction cosines, relative to the phase centre, at which
+ * the A-terms passed to oskar_grid_idg_d() and oskar_grid_idg_f() are
+ * sampled. The l and m axes follow the same convention as the image.
+ * The arrays are of length subgrid_size * subgrid_size, with l varying
+ * fastest.
+ *
+ * @param[in] subgrid_size   Subgrid side length.
+ * @param[in] grid_size      Side length of grid.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[out] l             Direction cosine l of each subgrid pixel.
+ * @param[out] m             Direction cosine m of each subgrid pixel.
+ * @param[out] n             Direction cosine n of each subgrid pixel.
+ */
+OSKAR_EXPORT
+void oskar_grid_idg_subgrid_lmn_d(const int subgrid_size, const int grid_size,
+        const double cell_size_rad, double* l, double* m, double* n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_GRID_IDG_H_ */
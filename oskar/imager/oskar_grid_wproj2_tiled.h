@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_GRID_WPROJ2_TILED_H_
+#define OSKAR_GRID_WPROJ2_TILED_H_
+
+/**
+ * @file oskar_grid_wproj2_tiled.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Parallel gridding function for W-projection (double precision).
+ *
+ * @details
+ * Gridding function for W-projection, which gives the same result as
+ * oskar_grid_wproj2_d() using multiple threads.
+ *
+ * The grid is divided into square tiles, and the visibilities are sorted
+ * by tile with a counting sort, keeping their original order within
+ * each tile. Each visibility is listed in every tile that its kernel
+ * overlaps. Each tile is then updated by a single thread, which adds only
+ * the part of each kernel that lies inside the tile, so no atomic
+ * operations are needed. As every grid cell is updated in the same order
+ * as in the serial version, the results do not depend on the number of
+ * threads and are identical to those from oskar_grid_wproj2_d().
+ *
+ * If there is not enough memory for the sorted visibility list,
+ * oskar_grid_wproj2_d() is used instead.
+ *
+ * @param[in] num_w_planes   Number of W-projection planes.
+ * @param[in] support        GCF support size per W-plane.
+ * @param[in] oversample     GCF oversample factor.
+ * @param[in] wkernel_start  Start index of each convolution kernel.
+ * @param[in] wkernel        The rearranged convolution kernels.
+ * @param[in] num_points     Number of visibility points.
+ * @param[in] uu             Visibility baseline uu coordinates, in wavelengths.
+ * @param[in] vv             Visibility baseline vv coordinates, in wavelengths.
+ * @param[in] ww             Visibility baseline ww coordinates, in wavelengths.
+ * @param[in] vis            Complex visibilities for each baseline.
+ * @param[in] weight         Visibility weight for each baseline.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] w_scale        Scaling factor used to find W-plane index.
+ * @param[in] grid_size      Side length of grid.
+ * @param[out] num_skipped   Number of visibilities that fell outside the grid.
+ * @param[in,out] norm       Updated grid normalisation factor.
+ * @param[in,out] grid       Updated complex visibility grid.
+ */
+OSKAR_EXPORT
+void oskar_grid_wproj2_tiled_d(
+        const size_t num_w_planes,
+        const int* RESTRICT support,
+        const int oversample,
+        const int* wkernel_start,
+        const double* RESTRICT wkernel,
+        const size_t num_points,
+        const double* RESTRICT uu,
+        const double* RESTRICT vv,
+        const double* RESTRICT ww,
+        const double* RESTRICT vis,
+        const double* RESTRICT weight,
+        const double cell_size_rad,
+        const double w_scale,
+        const int grid_size,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        double* RESTRICT grid);
+
+/**
+ * @brief
+ * Parallel gridding function for W-projection (single precision).
+ *
+ * @details
+ * Gridding function for W-projection, which gives the same result as
+ * oskar_grid_wproj2_f() using multiple threads.
+ *
+ * The grid is divided into square tiles, and the visibilities are sorted
+ * by tile with a counting sort, keeping their original order within
+ * each tile. Each visibility is listed in every tile that its kernel
+ * overlaps. Each tile is then updated by a single thread, which adds only
+ * the part of each kernel that lies inside the tile, so no atomic
+ * operations are needed. As every grid cell is updated in the same order
+ * as in the serial version, the results do not depend on the number of
+ * threads and are identical to those from oskar_grid_wproj2_f().
+ *
+ * If there is not enough memory for the sorted visibility list,
+ * oskar_grid_wproj2_f() is used instead.
+ *
+ * @param[in] num_w_planes   Number of W-projection planes.
+ * @param[in] support        GCF support size per W-plane.
+ * @param[in] oversample     GCF oversample factor.
+ * @param[in] wkernel_start  Start index of each convolution kernel.
+ * @param[in] wkernel        The rearranged convolution kernels.
+ * @param[in] num_points     Number of visibility points.
+ * @param[in] uu             Visibility baseline uu coordinates, in wavelengths.
+ * @param[in] vv             Visibility baseline vv coordinates, in wavelengths.
+ * @param[in] ww             Visibility baseline ww coordinates, in wavelengths.
+ * @param[in] vis            Complex visibilities for each baseline.
+ * @param[in] weight         Visibility weight for each baseline.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] w_scale        Scaling factor used to find W-plane index.
+ * @param[in] grid_size      Side length of grid.
+ * @param[out] num_skipped   Number of visibilities that fell outside the grid.
+ * @param[in,out] norm       Updated grid normalisation factor.
+ * @param[in,out] grid       Updated complex visibility grid.
+ */
+OSKAR_EXPORT
+void oskar_grid_wproj2_tiled_f(
+        const size_t num_w_planes,
+        const int* RESTRICT support,
+        const int oversample,
+        const int* wkernel_start,
+        const float* RESTRICT wkernel,
+        const size_t num_points,
+        const float* RESTRICT uu,
+        const float* RESTRICT vv,
+        const float* RESTRICT ww,
+        const float* RESTRICT vis,
+        const float* RESTRICT weight,
+        const float cell_size_rad,
+        const float w_scale,
+        const int grid_size,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        float* RESTRICT grid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
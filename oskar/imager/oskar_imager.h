@@ -66,7 +66,9 @@ enum OSKAR_IMAGE_ALGORITHM
     OSKAR_ALGORITHM_DFT_2D,
     OSKAR_ALGORITHM_DFT_3D,
     OSKAR_ALGORITHM_WPROJ,
-    OSKAR_ALGORITHM_AWPROJ
+    OSKAR_ALGORITHM_AWPROJ,
+    OSKAR_ALGORITHM_WSTACK,
+    OSKAR_ALGORITHM_IDG
 };
 
 enum OSKAR_IMAGE_WEIGHTING
@@ -35,6 +35,7 @@
 
 #include <oskar_global.h>
 #include <log/oskar_log.h>
+#include <telescope/oskar_telescope.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -319,6 +320,12 @@ int oskar_imager_scale_norm_with_num_input_files(const oskar_Imager* h);
  * The \p type string can be:
  * - "FFT" to use standard gridding followed by a FFT.
  * - "W-projection" to use W-projection gridding followed by a FFT.
+ * - "W-stacking" to grid into W planes, and apply the W-term correction
+ *   to each plane in the image domain after its FFT.
+ * - "IDG" to use image-domain gridding into W planes, which makes small
+ *   subgrids of the visibilities by a direct Fourier transform and
+ *   applies the residual W-term to them before their FFT. If a telescope
+ *   model has been set, the station beams are also applied as A-terms.
  * - "DFT 2D" to use a 2D Direct Fourier Transform, without gridding.
  * - "DFT 3D" to use a 3D Direct Fourier Transform, without gridding.
  *
@@ -684,6 +691,30 @@ void oskar_imager_set_scale_norm_with_num_input_files(oskar_Imager* h,
 OSKAR_EXPORT
 void oskar_imager_set_size(oskar_Imager* h, int size, int* status);
 
+/**
+ * @brief
+ * Sets the telescope model used to evaluate station beams.
+ *
+ * @details
+ * Sets the telescope model used to evaluate the station beams, which are
+ * applied as A-terms when using image-domain gridding (IDG).
+ * A copy of the model is made, so it can be freed after calling this.
+ *
+ * The beams are evaluated in the scalar polarisation mode, at the image
+ * frequency and the time centroid of the visibilities, and applied to
+ * each visibility using the indices of its two stations. The station beams
+ * point at the image centre, where they are normalised if required.
+ *
+ * Set to NULL to disable A-terms (the default).
+ *
+ * @param[in,out] h          Handle to imager.
+ * @param[in]     model      Telescope model, or NULL.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_telescope_model(oskar_Imager* h,
+        const oskar_Telescope* model, int* status);
+
 /**
  * @brief
  * Sets the maximum timestamp of visibility data to include in the image.
@@ -776,12 +807,32 @@ OSKAR_EXPORT
 void oskar_imager_set_vis_phase_centre(oskar_Imager* h,
         double ra_deg, double dec_deg);
 
+/**
+ * @brief
+ * Sets the visibility start time and time increment.
+ *
+ * @details
+ * Sets the start time and time increment of the visibility data.
+ * These are used only by IDG, to find the time index of each time
+ * centroid when evaluating the station beams, so that any time-variable
+ * element errors in the telescope model are applied. If the time
+ * increment is 0, the time index is 0.
+ *
+ * @param[in,out] h                Handle to imager.
+ * @param[in]     time_start_mjd_utc Start time, as MJD(UTC).
+ * @param[in]     time_inc_sec     Time increment, in seconds.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_vis_time(oskar_Imager* h,
+        double time_start_mjd_utc, double time_inc_sec);
+
 /**
  * @brief
  * Sets the number of W planes to use.
  *
  * @details
- * Sets the number of W planes, used only for W-projection.
+ * Sets the number of W planes, used only for W-projection, W-stacking
+ * and IDG. For IDG, this is raised if needed to fit the range of w.
  * A value of 0 or less means 'automatic'.
  *
  * @param[in,out] h            Handle to imager.
@@ -805,6 +856,28 @@ void oskar_imager_set_num_w_planes(oskar_Imager* h, int value);
 OSKAR_EXPORT
 void oskar_imager_set_weighting(oskar_Imager* h, const char* type, int* status);
 
+/**
+ * @brief
+ * Sets the directory used to cache W-projection kernels.
+ *
+ * @details
+ * Sets the directory used to cache W-projection kernels.
+ *
+ * If set, the kernels are saved to a file in this directory when they are
+ * generated, and loaded from it on subsequent runs with the same image size,
+ * cell size, number of W planes, W scale, oversample factor, kernel type
+ * and precision. The file contains a checksum, which is used to check
+ * that the kernels are valid before they are used.
+ *
+ * The directory must already exist. Set to NULL or an empty string
+ * to disable the cache (the default).
+ *
+ * @param[in,out] h     Handle to imager.
+ * @param[in]     dir   Path to the cache directory.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_w_kernel_cache_dir(oskar_Imager* h, const char* dir);
+
 /**
  * @brief
  * Returns the image side length.
@@ -879,6 +952,19 @@ double oskar_imager_uv_filter_min(const oskar_Imager* h);
 OSKAR_EXPORT
 const char* oskar_imager_weighting(const oskar_Imager* h);
 
+/**
+ * @brief
+ * Returns the directory used to cache W-projection kernels.
+ *
+ * @details
+ * Returns the directory used to cache W-projection kernels,
+ * or NULL if the cache is disabled.
+ *
+ * @param[in] h  Handle to imager.
+ */
+OSKAR_EXPORT
+const char* oskar_imager_w_kernel_cache_dir(const oskar_Imager* h);
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,6 +81,41 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
         const oskar_Mem* ww, const oskar_Mem* amps, const oskar_Mem* weight,
         const oskar_Mem* time_centroid, int* status);
 
+/**
+ * @brief
+ * Intermediate-level function to run the imager, with station indices.
+ *
+ * @details
+ * This function is the same as oskar_imager_update(), but also takes the
+ * indices of the two stations that form the baseline of each row.
+ * These are needed to apply station beams as A-terms when using IDG
+ * with a telescope model; otherwise they may be NULL.
+ *
+ * The time centroids must be supplied if station beams are applied.
+ *
+ * @param[in,out] h             Handle to imager.
+ * @param[in]     num_rows      Number of times/baselines.
+ * @param[in]     start_chan    Start channel index of the visibility block.
+ * @param[in]     end_chan      End channel index of the visibility block.
+ * @param[in]     num_pols      Number of polarisations in the visibility block.
+ * @param[in]     uu            Visibility uu coordinates, in metres.
+ * @param[in]     vv            Visibility vv coordinates, in metres.
+ * @param[in]     ww            Visibility ww coordinates, in metres.
+ * @param[in]     amps          Visibility complex amplitudes.
+ * @param[in]     weight        Visibility weights.
+ * @param[in]     time_centroid Visibility time centroids, at MJD(UTC) seconds
+ *                              (double precision).
+ * @param[in]     station1      First station index of each row (integer).
+ * @param[in]     station2      Second station index of each row (integer).
+ * @param[in,out] status        Status return code.
+ */
+OSKAR_EXPORT
+void oskar_imager_update_with_stations(oskar_Imager* h, size_t num_rows,
+        int start_chan, int end_chan, int num_pols, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, const oskar_Mem* time_centroid,
+        const oskar_Mem* station1, const oskar_Mem* station2, int* status);
+
 /**
  * @brief
  * Low-level function to run the imager only for the supplied visibilities.
@@ -120,6 +155,41 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
         oskar_Mem* plane, double* plane_norm, oskar_Mem* weights_grid,
         int* status);
 
+/**
+ * @brief
+ * Low-level function to run the imager, with station indices.
+ *
+ * @details
+ * This function is the same as oskar_imager_update_plane(), but also takes
+ * the time centroid and the indices of the two stations of each
+ * visibility. These are needed to apply station beams as A-terms
+ * when using IDG with a telescope model; otherwise they may be NULL.
+ *
+ * @param[in,out] h             Handle to imager.
+ * @param[in]     num_vis       Number of visibilities.
+ * @param[in]     uu            Visibility uu coordinates, in wavelengths.
+ * @param[in]     vv            Visibility vv coordinates, in wavelengths.
+ * @param[in]     ww            Visibility ww coordinates, in wavelengths.
+ * @param[in]     amps          Visibility complex amplitudes.
+ * @param[in]     weight        Visibility weights.
+ * @param[in]     time_centroid Visibility time centroids, at MJD(UTC) seconds
+ *                              (double precision).
+ * @param[in]     station1      First station index of each visibility.
+ * @param[in]     station2      Second station index of each visibility.
+ * @param[in]     i_plane       Internal plane index, used if \p plane is NULL.
+ * @param[in,out] plane         Updated image or visibility plane.
+ * @param[in,out] plane_norm    Updated required normalisation of plane.
+ * @param[in,out] weights_grid  Grid of weights, updated if required.
+ * @param[in,out] status        Status return code.
+ */
+OSKAR_EXPORT
+void oskar_imager_update_plane_with_stations(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight,
+        const oskar_Mem* time_centroid, const oskar_Mem* station1,
+        const oskar_Mem* station2, int i_plane, oskar_Mem* plane,
+        double* plane_norm, oskar_Mem* weights_grid, int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_GRID_IDG_SIMD_H_
+#define OSKAR_PRIVATE_GRID_IDG_SIMD_H_
+
+/**
+ * @file private_grid_idg_simd.h
+ */
+
+#include <oskar_global.h>
+
+/* Declares the subgrid DFT for one instruction set and precision.
+ * The parameters are as for oskar_grid_idg_dft_simd_f(). */
+#define OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(NAME, FP)                         \
+void NAME(int num_pixels, const FP* x, const FP* y, const FP* n,            \
+        int num_vis, const FP* au, const FP* av, const FP* aw,              \
+        const FP* vis_re, const FP* vis_im, FP* out_re, FP* out_im);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Direct Fourier transform of visibilities to a subgrid image
+ * (single precision).
+ *
+ * @details
+ * Evaluates, for each pixel p,
+ *
+ *   out[p] = sum_i vis[i] * exp(j (au[i] x[p] + av[i] y[p] + aw[i] n[p]))
+ *
+ * using the best instruction set available at run time.
+ *
+ * @param[in] num_pixels  Number of pixels.
+ * @param[in] x           Pixel x coordinates.
+ * @param[in] y           Pixel y coordinates.
+ * @param[in] n           Pixel n coordinates.
+ * @param[in] num_vis     Number of visibilities.
+ * @param[in] au          Phase per unit x, for each visibility.
+ * @param[in] av          Phase per unit y, for each visibility.
+ * @param[in] aw          Phase per unit n, for each visibility.
+ * @param[in] vis_re      Real part of each visibility.
+ * @param[in] vis_im      Imaginary part of each visibility.
+ * @param[out] out_re     Real part of each pixel.
+ * @param[out] out_im     Imaginary part of each pixel.
+ */
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_simd_f, float)
+
+/**
+ * @brief
+ * Direct Fourier transform of visibilities to a subgrid image
+ * (double precision).
+ *
+ * @details
+ * See oskar_grid_idg_dft_simd_f().
+ */
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_simd_d, double)
+
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_scalar_f, float)
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_scalar_d, double)
+
+#ifdef OSKAR_HAVE_AVX2
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_avx2_f, float)
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_avx2_d, double)
+#endif
+
+#ifdef OSKAR_HAVE_AVX512
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_avx512_f, float)
+OSKAR_GRID_IDG_DFT_SIMD_PROTOTYPE(oskar_grid_idg_dft_avx512_d, double)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -7,6 +7,7 @@
 #include <log/oskar_log.h>
 #include <math/oskar_fft.h>
 #include <mem/oskar_mem.h>
+#include <telescope/oskar_telescope.h>
 #include <utility/oskar_thread.h>
 #include <utility/oskar_timer.h>
 
@@ -51,6 +52,7 @@ struct oskar_Imager
     int num_files, scale_norm_with_num_input_files;
     char direction_type, kernel_type;
     char **input_files, *input_root, *output_root, *ms_column;
+    char *w_kernel_cache_dir;
     double cellsize_rad, fov_deg, image_padding, im_centre_deg[2];
     double uv_filter_min, uv_filter_max;
     double time_min_utc, time_max_utc, freq_min_hz, freq_max_hz;
@@ -59,6 +61,7 @@ struct oskar_Imager
     int num_sel_freqs;
     double *im_freqs, *sel_freqs;
     double vis_freq_start_hz, freq_inc_hz;
+    double vis_time_start_mjd_utc, vis_time_inc_sec;
 
     /* State. */
     int init, status, i_block;
@@ -69,6 +72,7 @@ struct oskar_Imager
 
     /* Scratch data. */
     oskar_Mem *uu_im, *vv_im, *ww_im, *vis_im, *weight_im, *time_im;
+    oskar_Mem *station1_im, *station2_im;
     oskar_Mem *uu_tmp, *vv_tmp, *ww_tmp, *stokes, *weight_tmp;
     int num_planes; /* For each output channel and polarisation. */
     double *plane_norm, delta_l, delta_m, delta_n, M[9];
@@ -88,6 +92,13 @@ struct oskar_Imager
     double w_scale, ww_min, ww_max, ww_rms;
     oskar_Mem *w_support, *w_kernels_compact, *w_kernel_start;
 
+    /* IDG imager data, used to evaluate station beams as A-terms.
+     * The A-terms are held for each time in aterm_times, at one frequency. */
+    oskar_Telescope* telescope;
+    oskar_StationWork* station_work;
+    oskar_Mem *aterms, *aterm_times, *aterm_dir[3];
+    double aterm_freq_hz;
+
     /* Memory allocated per GPU (array of DeviceData structures). */
     DeviceData* d;
 };
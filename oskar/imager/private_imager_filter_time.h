@@ -59,12 +59,17 @@ extern "C" {
  * @param[in,out] weight        Baseline visibility weights.
  * @param[in,out] time_centroid Time centroid values as MJD(UTC) _seconds_
  *                              (double precision).
+ * @param[in,out] station1      First station index of each visibility,
+ *                              or NULL.
+ * @param[in,out] station2      Second station index of each visibility,
+ *                              or NULL.
  * @param[in,out] status        Status return code.
  */
 OSKAR_EXPORT
 void oskar_imager_filter_time(oskar_Imager* h, size_t* num_vis,
         oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, oskar_Mem* time_centroid, int* status);
+        oskar_Mem* weight, oskar_Mem* time_centroid, oskar_Mem* station1,
+        oskar_Mem* station2, int* status);
 
 #ifdef __cplusplus
 }
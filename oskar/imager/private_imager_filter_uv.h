@@ -57,12 +57,17 @@ extern "C" {
  * @param[in,out] ww         Baseline ww coordinates, in wavelengths.
  * @param[in,out] amp        Baseline complex visibility amplitudes.
  * @param[in,out] weight     Baseline visibility weights.
+ * @param[in,out] time_centroid Time centroid values as MJD(UTC) _seconds_
+ *                           (double precision), or NULL.
+ * @param[in,out] station1   First station index of each visibility, or NULL.
+ * @param[in,out] station2   Second station index of each visibility, or NULL.
  * @param[in,out] status     Status return code.
  */
 OSKAR_EXPORT
 void oskar_imager_filter_uv(oskar_Imager* h, size_t* num_vis,
         oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, int* status);
+        oskar_Mem* weight, oskar_Mem* time_centroid, oskar_Mem* station1,
+        oskar_Mem* station2, int* status);
 
 #ifdef __cplusplus
 }
@@ -35,6 +35,11 @@ extern "C" {
 
 void oskar_imager_init_wproj(oskar_Imager* h, int* status);
 
+/* Evaluates the number of W planes (if not set), and the W scale factor.
+ * Plane index i corresponds to |w| = i * i / w_scale. */
+void oskar_imager_evaluate_w_kernel_params(const oskar_Imager* h,
+        int* num_w_planes, double* w_scale);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,8 @@ void oskar_imager_select_data(
         const oskar_Mem* vis_in,
         const oskar_Mem* weight_in,
         const oskar_Mem* time_in,
+        const oskar_Mem* station1_in,
+        const oskar_Mem* station2_in,
         double im_freq_hz,
         int im_pol,
         size_t* num_out,
@@ -57,6 +59,8 @@ void oskar_imager_select_data(
         oskar_Mem* vis_out,
         oskar_Mem* weight_out,
         oskar_Mem* time_out,
+        oskar_Mem* station1_out,
+        oskar_Mem* station2_out,
         int* status);
 
 #ifdef __cplusplus
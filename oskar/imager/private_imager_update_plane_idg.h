@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_IMAGER_UPDATE_PLANE_IDG_H_
+#define OSKAR_IMAGER_UPDATE_PLANE_IDG_H_
+
+#include <mem/oskar_mem.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Side length of each IDG subgrid, in cells. */
+#define OSKAR_IDG_SUBGRID_SIZE 32
+
+/* Each W plane is gridded, transformed and added to the image held in
+ * the plane, so the plane holds one image whatever the number of W planes.
+ * If a telescope model has been set, the station beams are applied as
+ * A-terms, which needs the time centroid and station indices. */
+void oskar_imager_update_plane_idg(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight,
+        const oskar_Mem* time_centroid, const oskar_Mem* station1,
+        const oskar_Mem* station2, int i_plane, oskar_Mem* plane,
+        double* plane_norm, size_t* num_skipped, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_IMAGER_UPDATE_PLANE_IDG_H_ */
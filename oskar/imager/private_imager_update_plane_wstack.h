@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_IMAGER_UPDATE_PLANE_WSTACK_H_
+#define OSKAR_IMAGER_UPDATE_PLANE_WSTACK_H_
+
+#include <mem/oskar_mem.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The plane holds the image, followed by any visibilities not yet gridded. */
+void oskar_imager_update_plane_wstack(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight, int i_plane,
+        oskar_Mem* plane, double* plane_norm, size_t* num_skipped, int* status);
+
+/* Grids any visibilities still stored in the plane, so that it holds only
+ * the accumulated image. */
+void oskar_imager_finalise_plane_wstack(oskar_Imager* h, oskar_Mem* plane,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_IMAGER_UPDATE_PLANE_WSTACK_H_ */
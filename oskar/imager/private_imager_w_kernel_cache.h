@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_IMAGER_W_KERNEL_CACHE_H_
+#define OSKAR_IMAGER_W_KERNEL_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Loads the W-projection kernels from the cache directory, if set.
+ * Returns 1 if the kernels were loaded, or 0 if they must be generated. */
+int oskar_imager_w_kernel_cache_read(oskar_Imager* h, int* status);
+
+/* Saves the W-projection kernels to the cache directory, if set.
+ * Failure to write the cache file is not an error. */
+void oskar_imager_w_kernel_cache_write(oskar_Imager* h, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_IMAGER_W_KERNEL_CACHE_H_ */
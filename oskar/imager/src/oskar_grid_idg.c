@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "imager/oskar_grid_idg.h"
+#include "imager/private_grid_idg_simd.h"
+#include "math/oskar_cmath.h"
+#include "math/oskar_fftpack_cfft.h"
+#include "math/oskar_fftpack_cfft_f.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of subgrids computed in parallel before they are added. */
+#define IDG_BATCH 64
+
+/* Subgrid index and visibility index, used to sort the visibilities. */
+struct IdgKey
+{
+    unsigned long long subgrid;
+    size_t index;
+};
+typedef struct IdgKey IdgKey;
+
+static int compare_keys(const void* a, const void* b)
+{
+    const IdgKey* p = (const IdgKey*) a;
+    const IdgKey* q = (const IdgKey*) b;
+    if (p->subgrid != q->subgrid) return (p->subgrid < q->subgrid) ? -1 : 1;
+    if (p->index != q->index) return (p->index < q->index) ? -1 : 1;
+    return 0;
+}
+
+
+int oskar_grid_idg_num_w_planes(const int subgrid_size, const int support,
+        const double w_max, const double cell_size_rad, const int grid_size)
+{
+    /* The largest residual w that fits in the margin of a subgrid. */
+    const double grid_scale = grid_size * cell_size_rad;
+    const double dw_max = (subgrid_size / 4 - support) /
+            (0.5 * grid_scale * grid_scale);
+    if (w_max <= 0.0) return 1;
+    return 2 + (int) floor(w_max / (2.0 * dw_max));
+}
+
+
+void oskar_grid_idg_subgrid_lmn_d(const int subgrid_size, const int grid_size,
+        const double cell_size_rad, double* l, double* m, double* n)
+{
+    int x, y;
+    const int half = subgrid_size / 2;
+    const double inc = cell_size_rad * grid_size / subgrid_size;
+    for (y = 0; y < subgrid_size; ++y)
+    {
+        for (x = 0; x < subgrid_size; ++x)
+        {
+            const size_t p = (size_t) y * subgrid_size + x;
+            l[p] = (x - half) * inc;
+            m[p] = (half - y) * inc;
+            const double r2 = l[p] * l[p] + m[p] * m[p];
+            n[p] = r2 < 1.0 ? sqrt(1.0 - r2) : 0.0;
+        }
+    }
+}
+
+/*
+ * The first pass finds the subgrid of each visibility.
+ * The key of a visibility that is off the grid is larger than that of any
+ * subgrid, the key of one that does not fit in its subgrid is larger
+ * still, and the key of one on a W plane that is not being gridded is
+ * largest, so these are sorted to the end.
+ *
+ * Each subgrid image is the sum of the visibilities, each multiplied by the
+ * phase 2 pi [du * x + dv * y] / N - 2 pi dw (n - 1) at pixel (x, y),
+ * where du and dv are the distances in cells from the subgrid centre,
+ * and dw is the difference from the w value of the W plane.
+ * This is evaluated using vectorised sincos by oskar_grid_idg_dft_simd_*().
+ * The sign of alternate pixels is flipped before and after the FFT so that
+ * the subgrid is centred, which needs N / 2 to be even.
+ * The FFT normalisation by 1 / N^2 means that the kernel of each visibility
+ * sums to the taper at the subgrid centre.
+ */
+#define OSKAR_GRID_IDG(NAME, FP, CFFT2F, DFT) \
+void NAME(const int subgrid_size, const int support, \
+        const FP* RESTRICT taper, const int num_w_planes, \
+        const double w_scale, const int grid_w_plane, \
+        const int num_stations, const FP* RESTRICT aterms, const int* RESTRICT station1, \
+        const int* RESTRICT station2, const size_t num_points, \
+        const FP* RESTRICT uu, const FP* RESTRICT vv, const FP* RESTRICT ww, \
+        const FP* RESTRICT vis, const FP* RESTRICT weight, \
+        const FP cell_size_rad, const int grid_size, \
+        size_t* RESTRICT num_skipped, double* RESTRICT norm, \
+        FP* RESTRICT grid, int* status) \
+{ \
+    long long i; \
+    int error = 0; \
+    size_t j, num_subgrids = 0, num_gridded = 0, max_count; \
+    IdgKey* keys; \
+    size_t* start; \
+    FP *coords, *wsave, *subgrids; \
+    const int N = subgrid_size, half = subgrid_size / 2; \
+    const int tile = subgrid_size / 2, margin = subgrid_size / 4; \
+    const int num_tiles = (grid_size + tile - 1) / tile; \
+    const int num_baselines = aterms ? num_stations * num_stations : 1; \
+    const size_t sub_cells = (size_t) N * (size_t) N; \
+    const size_t num_cells = (size_t) grid_size * (size_t) grid_size; \
+    const int grid_centre = grid_size / 2; \
+    const double grid_scale = grid_size * (double) cell_size_rad; \
+    const double l_edge = 0.5 * grid_scale; \
+    const unsigned long long skip_key = (unsigned long long) num_baselines * \
+            (unsigned long long) num_w_planes * \
+            (unsigned long long) num_tiles * (unsigned long long) num_tiles; \
+    const unsigned long long wide_key = skip_key + 1; \
+    const unsigned long long other_key = skip_key + 2; \
+    if (*status) return; \
+    if (N < 4 || N % 4 != 0 || support >= margin || num_w_planes < 1 || \
+            (aterms && (!station1 || !station2 || num_stations < 1))) \
+    { \
+        *status = OSKAR_ERR_INVALID_ARGUMENT; \
+        return; \
+    } \
+    *num_skipped = 0; \
+    if (num_points == 0) return; \
+    keys = (IdgKey*) malloc(num_points * sizeof(IdgKey)); \
+    start = (size_t*) malloc((num_points + 1) * sizeof(size_t)); \
+    coords = (FP*) malloc(3 * sub_cells * sizeof(FP)); \
+    wsave = (FP*) malloc((4 * N + 2 * (int)(log((double)N) / log(2.0)) + 8) \
+            * sizeof(FP)); \
+    subgrids = (FP*) malloc(IDG_BATCH * 2 * sub_cells * sizeof(FP)); \
+    if (!keys || !start || !coords || !wsave || !subgrids) \
+    { \
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE; \
+        free(keys); \
+        free(start); \
+        free(coords); \
+        free(wsave); \
+        free(subgrids); \
+        return; \
+    } \
+    \
+    /* Find the subgrid of each visibility. */ \
+    _Pragma("omp parallel for private(i)") \
+    for (i = 0; i < (long long) num_points; ++i) \
+    { \
+        int k = 0; \
+        double w_k = 0.0; \
+        const double w = fabs((double) ww[i]); \
+        const double sign = (ww[i] < (FP)0) ? -1.0 : 1.0; \
+        const double pos_u = -sign * uu[i] * grid_scale; \
+        const double pos_v = sign * vv[i] * grid_scale; \
+        const int grid_u = (int)round(pos_u) + grid_centre; \
+        const int grid_v = (int)round(pos_v) + grid_centre; \
+        if (w_scale > 0.0) \
+        { \
+            k = (int) round(w * w_scale); \
+            if (k >= num_w_planes) k = num_w_planes - 1; \
+            w_k = k / w_scale; \
+        } \
+        keys[i].index = (size_t) i; \
+        keys[i].subgrid = other_key; \
+        if (grid_w_plane >= 0 && k != grid_w_plane) continue; \
+        const int width = support + \
+                (int) ceil(fabs(w - w_k) * l_edge * grid_scale); \
+        keys[i].subgrid = wide_key; \
+        if (width > margin) continue; \
+        keys[i].subgrid = skip_key; \
+        if (grid_u - width < 0 || grid_v - width < 0 || \
+                grid_u + width >= grid_size || grid_v + width >= grid_size) \
+            continue; \
+        int baseline = 0; \
+        if (aterms) \
+        { \
+            const int s1 = (sign > 0.0) ? station1[i] : station2[i]; \
+            const int s2 = (sign > 0.0) ? station2[i] : station1[i]; \
+            if (s1 < 0 || s2 < 0 || s1 >= num_stations || \
+                    s2 >= num_stations) continue; \
+            baseline = s1 * num_stations + s2; \
+        } \
+        keys[i].subgrid = (((unsigned long long) baseline * num_w_planes + \
+                k) * num_tiles + grid_v / tile) * num_tiles + grid_u / tile; \
+    } \
+    \
+    /* Sort the visibilities by subgrid, and find the start of each. \
+     * Fail if any would not fit in a subgrid, as there are too few \
+     * W planes for the range of w. */ \
+    qsort(keys, num_points, sizeof(IdgKey), compare_keys); \
+    for (j = 0; j < num_points; ++j) \
+    { \
+        if (keys[j].subgrid == wide_key) break; \
+        if (keys[j].subgrid < skip_key) ++num_gridded; \
+        else if (keys[j].subgrid == skip_key) ++(*num_skipped); \
+    } \
+    if (j < num_points) \
+    { \
+        *status = OSKAR_ERR_OUT_OF_RANGE; \
+        free(keys); \
+        free(start); \
+        free(coords); \
+        free(wsave); \
+        free(subgrids); \
+        return; \
+    } \
+    for (j = 0; j < num_gridded; ++j) \
+    { \
+        if (j == 0 || keys[j].subgrid != keys[j - 1].subgrid) \
+            start[num_subgrids++] = j; \
+        *norm += weight[keys[j].index] * taper[half] * taper[half]; \
+    } \
+    start[num_subgrids] = num_gridded; \
+    max_count = 1; \
+    for (j = 0; j < num_subgrids; ++j) \
+        if (start[j + 1] - start[j] > max_count) \
+            max_count = start[j + 1] - start[j]; \
+    \
+    /* Evaluate x, y and n - 1 at each subgrid pixel, \
+     * and initialise the FFT. */ \
+    { \
+        int x, y; \
+        const double inc = grid_scale / N; \
+        for (y = 0; y < N; ++y) \
+        { \
+            for (x = 0; x < N; ++x) \
+            { \
+                const size_t p = (size_t) y * N + x; \
+                const double l = (x - half) * inc, m = (y - half) * inc; \
+                const double r2 = 1.0 - l * l - m * m; \
+                coords[p] = (FP) (x - half); \
+                coords[sub_cells + p] = (FP) (y - half); \
+                coords[2 * sub_cells + p] = \
+                        (FP) ((r2 > 0.0 ? sqrt(r2) : 0.0) - 1.0); \
+            } \
+        } \
+    } \
+    oskar_fftpack_cfft2i##CFFT2F(N, N, wsave); \
+    \
+    _Pragma("omp parallel") \
+    { \
+        size_t b, s; \
+        FP* work = (FP*) malloc(2 * sub_cells * sizeof(FP)); \
+        FP* image = (FP*) malloc(2 * sub_cells * sizeof(FP)); \
+        FP* par = (FP*) malloc(5 * max_count * sizeof(FP)); \
+        if (!work || !image || !par) error = 1; \
+        _Pragma("omp barrier") \
+        for (b = 0; b < num_subgrids && !error; b += IDG_BATCH) \
+        { \
+            const size_t end = (b + IDG_BATCH < num_subgrids) ? \
+                    b + IDG_BATCH : num_subgrids; \
+    \
+            /* Compute the subgrids in this batch. */ \
+            _Pragma("omp for schedule(dynamic, 1)") \
+            for (s = b; s < end; ++s) \
+            { \
+                int x, y; \
+                size_t v; \
+                FP *au = par, *av = par + max_count, *aw = par + 2 * max_count; \
+                FP *vr = par + 3 * max_count, *vi = par + 4 * max_count; \
+                FP *o_re = image, *o_im = image + sub_cells; \
+                FP* sub = &subgrids[2 * sub_cells * (s - b)]; \
+                const size_t count = start[s + 1] - start[s]; \
+                const unsigned long long key = keys[start[s]].subgrid; \
+                const int tu = (int) (key % num_tiles); \
+                const int tv = (int) ((key / num_tiles) % num_tiles); \
+                const int k = (int) ((key / num_tiles / num_tiles) % \
+                        num_w_planes); \
+                const int baseline = (int) (key / num_tiles / num_tiles / \
+                        num_w_planes); \
+                const double c_u = tu * tile + margin; \
+                const double c_v = tv * tile + margin; \
+                const double w_k = (w_scale > 0.0) ? k / w_scale : 0.0; \
+                \
+                /* Get the phase terms and weighted visibilities. */ \
+                for (v = 0; v < count; ++v) \
+                { \
+                    const size_t t = keys[start[s] + v].index; \
+                    const double sign = (ww[t] < (FP)0) ? -1.0 : 1.0; \
+                    const double pos_u = -sign * uu[t] * grid_scale + \
+                            grid_centre; \
+                    const double pos_v = sign * vv[t] * grid_scale + \
+                            grid_centre; \
+                    au[v] = (FP) (2.0 * M_PI * (pos_u - c_u) / N); \
+                    av[v] = (FP) (2.0 * M_PI * (pos_v - c_v) / N); \
+                    aw[v] = (FP) (-2.0 * M_PI * (fabs((double) ww[t]) - w_k)); \
+                    vr[v] = weight[t] * vis[2 * t]; \
+                    vi[v] = (FP) sign * weight[t] * vis[2 * t + 1]; \
+                } \
+                \
+                /* Direct Fourier transform to the subgrid image. */ \
+                DFT((int) sub_cells, coords, coords + sub_cells, \
+                        coords + 2 * sub_cells, (int) count, \
+                        au, av, aw, vr, vi, o_re, o_im); \
+                for (y = 0; y < N; ++y) \
+                { \
+                    for (x = 0; x < N; ++x) \
+                    { \
+                        const size_t p = (size_t) y * N + x; \
+                        FP re = o_re[p], im = o_im[p]; \
+                        \
+                        /* Apply the A-terms. */ \
+                        if (aterms) \
+                        { \
+                            const FP* a1 = &aterms[2 * (sub_cells * \
+                                    (baseline / num_stations) + p)]; \
+                            const FP* a2 = &aterms[2 * (sub_cells * \
+                                    (baseline % num_stations) + p)]; \
+                            const FP g_re = a1[0] * a2[0] + a1[1] * a2[1]; \
+                            const FP g_im = a1[0] * a2[1] - a1[1] * a2[0]; \
+                            const FP t_re = re * g_re - im * g_im; \
+                            im = re * g_im + im * g_re; \
+                            re = t_re; \
+                        } \
+                        \
+                        /* Apply the taper, and shift for the FFT. */ \
+                        const FP f = taper[x] * taper[y] * \
+                                (((x + y) & 1) ? (FP)-1 : (FP)1); \
+                        sub[2 * p] = f * re; \
+                        sub[2 * p + 1] = f * im; \
+                    } \
+                } \
+                \
+                /* Transform to the subgrid, and shift back. */ \
+                oskar_fftpack_cfft2f##CFFT2F(N, N, N, sub, wsave, work); \
+                for (y = 0; y < N; ++y) \
+                { \
+                    for (x = (y & 1) ? 0 : 1; x < N; x += 2) \
+                    { \
+                        const size_t p = (size_t) y * N + x; \
+                        sub[2 * p] = -sub[2 * p]; \
+                        sub[2 * p + 1] = -sub[2 * p + 1]; \
+                    } \
+                } \
+            } \
+    \
+            /* Add the subgrids to the grid in order. */ \
+            _Pragma("omp single") \
+            for (s = b; s < end; ++s) \
+            { \
+                int x, y; \
+                const FP* sub = &subgrids[2 * sub_cells * (s - b)]; \
+                const unsigned long long key = keys[start[s]].subgrid; \
+                const int u0 = (int) (key % num_tiles) * tile - margin; \
+                const int v0 = (int) ((key / num_tiles) % num_tiles) * tile - \
+                        margin; \
+                const int k = (int) ((key / num_tiles / num_tiles) % \
+                        num_w_planes); \
+                FP* plane = &grid[2 * num_cells * \
+                        (grid_w_plane >= 0 ? 0 : k)]; \
+                for (y = 0; y < N; ++y) \
+                { \
+                    const int gv = v0 + y; \
+                    if (gv < 0 || gv >= grid_size) continue; \
+                    for (x = 0; x < N; ++x) \
+                    { \
+                        const int gu = u0 + x; \
+                        if (gu < 0 || gu >= grid_size) continue; \
+                        const size_t p = 2 * ((size_t) y * N + x); \
+                        const size_t g = 2 * ((size_t) gv * grid_size + gu); \
+                        plane[g] += sub[p]; \
+                        plane[g + 1] += sub[p + 1]; \
+                    } \
+                } \
+            } \
+        } \
+        free(work); \
+        free(image); \
+        free(par); \
+    } \
+    if (error) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE; \
+    free(keys); \
+    free(start); \
+    free(coords); \
+    free(wsave); \
+    free(subgrids); \
+}
+
+OSKAR_GRID_IDG(oskar_grid_idg_d, double, , oskar_grid_idg_dft_simd_d)
+OSKAR_GRID_IDG(oskar_grid_idg_f, float, _f, oskar_grid_idg_dft_simd_f)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "correlate/oskar_cross_correlate_simd.h"
+#include "imager/define_grid_idg_simd.h"
+#include "imager/private_grid_idg_simd.h"
+#include "math/private_simd_scalar.h"
+
+OSKAR_GRID_IDG_DFT_SIMD_DEFINE(oskar_grid_idg_dft_scalar_f,
+        oskar_simd_scalar<float>, float)
+OSKAR_GRID_IDG_DFT_SIMD_DEFINE(oskar_grid_idg_dft_scalar_d,
+        oskar_simd_scalar<double>, double)
+
+/* The instruction set is chosen in the same way as for the correlator. */
+#define SIMD_DISPATCH(FP)                                                   \
+        switch (oskar_cross_correlate_simd_isa())                           \
+        {                                                                   \
+        SIMD_CASE_AVX512(FP)                                                \
+        SIMD_CASE_AVX2(FP)                                                  \
+        default:                                                            \
+            oskar_grid_idg_dft_scalar_ ## FP SIMD_ARGS;                     \
+        }
+
+#ifdef OSKAR_HAVE_AVX2
+#define SIMD_CASE_AVX2(FP) case OSKAR_SIMD_AVX2:                            \
+        oskar_grid_idg_dft_avx2_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX2(FP)
+#endif
+#ifdef OSKAR_HAVE_AVX512
+#define SIMD_CASE_AVX512(FP) case OSKAR_SIMD_AVX512:                        \
+        oskar_grid_idg_dft_avx512_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX512(FP)
+#endif
+
+#define SIMD_ARGS (num_pixels, x, y, n, num_vis, au, av, aw,                \
+        vis_re, vis_im, out_re, out_im)
+
+void oskar_grid_idg_dft_simd_f(int num_pixels, const float* x,
+        const float* y, const float* n, int num_vis, const float* au,
+        const float* av, const float* aw, const float* vis_re,
+        const float* vis_im, float* out_re, float* out_im)
+{
+    SIMD_DISPATCH(f)
+}
+
+void oskar_grid_idg_dft_simd_d(int num_pixels, const double* x,
+        const double* y, const double* n, int num_vis, const double* au,
+        const double* av, const double* aw, const double* vis_re,
+        const double* vis_im, double* out_re, double* out_im)
+{
+    SIMD_DISPATCH(d)
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/* This file must be compiled with AVX2 and FMA instructions enabled. */
+
+#include "imager/define_grid_idg_simd.h"
+#include "imager/private_grid_idg_simd.h"
+#include "math/private_simd_avx2.h"
+
+OSKAR_GRID_IDG_DFT_SIMD_DEFINE(oskar_grid_idg_dft_avx2_f,
+        oskar_simd_avx2_f, float)
+OSKAR_GRID_IDG_DFT_SIMD_DEFINE(oskar_grid_idg_dft_avx2_d,
+        oskar_simd_avx2_d, double)
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/* This file must be compiled with AVX-512F instructions enabled. */
+
+#include "imager/define_grid_idg_simd.h"
+#include "imager/private_grid_idg_simd.h"
+#include "math/private_simd_avx512.h"
+
+OSKAR_GRID_IDG_DFT_SIMD_DEFINE(oskar_grid_idg_dft_avx512_f,
+        oskar_simd_avx512_f, float)
+OSKAR_GRID_IDG_DFT_SIMD_DEFINE(oskar_grid_idg_dft_avx512_d,
+        oskar_simd_avx512_d, double)
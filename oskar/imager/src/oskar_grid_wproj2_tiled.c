@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "imager/oskar_grid_wproj2.h"
+#include "imager/oskar_grid_wproj2_tiled.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Side length of a grid tile, in cells. */
+#define TILE_SIZE 64
+
+/* Grid location of a visibility, found in the first pass. */
+struct VisLocation
+{
+    int grid_u, grid_v;   /* Grid cell nearest to the visibility. */
+    int support;          /* Kernel support size, or -1 if skipped. */
+    int mid, stride;      /* Kernel index parameters. */
+    int off_v;            /* Scaled distance from grid cell in v. */
+};
+typedef struct VisLocation VisLocation;
+
+/* Sorted list of visibilities in each tile. */
+struct TileList
+{
+    int num_tiles_u, num_tiles;
+    size_t* offset;       /* Start of each tile in vis_index. */
+    size_t* vis_index;    /* Visibility indices, sorted by tile. */
+};
+typedef struct TileList TileList;
+
+/* Returns the range of tiles overlapped by the kernel of a visibility. */
+static void tile_range(const VisLocation* loc, int* tu0, int* tu1,
+        int* tv0, int* tv1)
+{
+    *tu0 = (loc->grid_u - loc->support) / TILE_SIZE;
+    *tu1 = (loc->grid_u + loc->support) / TILE_SIZE;
+    *tv0 = (loc->grid_v - loc->support) / TILE_SIZE;
+    *tv1 = (loc->grid_v + loc->support) / TILE_SIZE;
+}
+
+/* Counting sort of the visibilities by tile, keeping their order. */
+static int sort_tiles(size_t num_points, const VisLocation* loc,
+        int grid_size, TileList* tiles)
+{
+    size_t i, total = 0;
+    int t, tu, tv, tu0, tu1, tv0, tv1;
+    tiles->num_tiles_u = (grid_size + TILE_SIZE - 1) / TILE_SIZE;
+    tiles->num_tiles = tiles->num_tiles_u * tiles->num_tiles_u;
+    tiles->offset = (size_t*) calloc(tiles->num_tiles + 1, sizeof(size_t));
+    tiles->vis_index = 0;
+    if (!tiles->offset) return 1;
+    for (i = 0; i < num_points; ++i)
+    {
+        if (loc[i].support < 0) continue;
+        tile_range(&loc[i], &tu0, &tu1, &tv0, &tv1);
+        for (tv = tv0; tv <= tv1; ++tv)
+            for (tu = tu0; tu <= tu1; ++tu)
+                tiles->offset[tv * tiles->num_tiles_u + tu + 1]++;
+    }
+    for (t = 0; t < tiles->num_tiles; ++t)
+    {
+        total += tiles->offset[t + 1];
+        tiles->offset[t + 1] = total;
+    }
+    tiles->vis_index = (size_t*) malloc((total > 0 ? total : 1) *
+            sizeof(size_t));
+    if (!tiles->vis_index) return 1;
+    for (i = 0; i < num_points; ++i)
+    {
+        if (loc[i].support < 0) continue;
+        tile_range(&loc[i], &tu0, &tu1, &tv0, &tv1);
+        for (tv = tv0; tv <= tv1; ++tv)
+            for (tu = tu0; tu <= tu1; ++tu)
+                tiles->vis_index[tiles->offset[tv * tiles->num_tiles_u + tu]++]
+                        = i;
+    }
+
+    /* Restore the start offsets, which were advanced by the fill. */
+    for (t = tiles->num_tiles; t > 0; --t)
+        tiles->offset[t] = tiles->offset[t - 1];
+    tiles->offset[0] = 0;
+    return 0;
+}
+
+
+static void free_tiles(TileList* tiles)
+{
+    free(tiles->offset);
+    free(tiles->vis_index);
+}
+
+
+void oskar_grid_wproj2_tiled_d(
+        const size_t num_w_planes,
+        const int* RESTRICT support,
+        const int oversample,
+        const int* wkernel_start,
+        const double* RESTRICT wkernel,
+        const size_t num_points,
+        const double* RESTRICT uu,
+        const double* RESTRICT vv,
+        const double* RESTRICT ww,
+        const double* RESTRICT vis,
+        const double* RESTRICT weight,
+        const double cell_size_rad,
+        const double w_scale,
+        const int grid_size,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        double* RESTRICT grid)
+{
+    int i, t;
+    TileList tiles;
+    const int n = (int) num_points;
+    const int grid_centre = grid_size / 2;
+    const int oversample_h = oversample / 2;
+    const double grid_scale = grid_size * cell_size_rad;
+    VisLocation* loc = (VisLocation*) malloc(
+            (num_points > 0 ? num_points : 1) * sizeof(VisLocation));
+    double* vis_norm = (double*) malloc(
+            (num_points > 0 ? num_points : 1) * sizeof(double));
+    if (!loc || !vis_norm || num_points > (size_t) 0x7FFFFFFF)
+    {
+        free(loc);
+        free(vis_norm);
+        oskar_grid_wproj2_d(num_w_planes, support, oversample, wkernel_start,
+                wkernel, num_points, uu, vv, ww, vis, weight, cell_size_rad,
+                w_scale, grid_size, num_skipped, norm, grid);
+        return;
+    }
+
+    /* Find the grid location and kernel sum of each visibility. */
+#pragma omp parallel for private(i)
+    for (i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        int j, k;
+
+        /* Convert UV coordinates to grid coordinates. */
+        const double pos_u = -uu[i] * grid_scale;
+        const double pos_v = vv[i] * grid_scale;
+        const size_t grid_w = (size_t)round(sqrt(fabs(ww[i] * w_scale)));
+        const int grid_u = (int)round(pos_u) + grid_centre;
+        const int grid_v = (int)round(pos_v) + grid_centre;
+
+        /* Scaled distance from nearest grid point. */
+        const int off_u = (int)round((round(pos_u) - pos_u) * oversample);
+        const int off_v = (int)round((round(pos_v) - pos_v) * oversample);
+
+        /* Get kernel support size and start offset. */
+        const int w_support = grid_w < num_w_planes ?
+                support[grid_w] : support[num_w_planes - 1];
+        const int kernel_start = grid_w < num_w_planes ?
+                wkernel_start[grid_w] : wkernel_start[num_w_planes - 1];
+
+        /* Catch points that would lie outside the grid. */
+        vis_norm[i] = 0.0;
+        loc[i].support = -1;
+        if (grid_u + w_support >= grid_size || grid_u - w_support < 0 ||
+                grid_v + w_support >= grid_size || grid_v - w_support < 0)
+            continue;
+        const int conv_len = 2 * w_support + 1;
+        const int width = (oversample_h * conv_len + 1) * conv_len;
+        const int mid = kernel_start + (abs(off_u) + 1) * width - 1 - w_support;
+        const int stride = (off_u >= 0) ? 1 : -1;
+        loc[i].grid_u = grid_u;
+        loc[i].grid_v = grid_v;
+        loc[i].support = w_support;
+        loc[i].mid = mid;
+        loc[i].stride = stride;
+        loc[i].off_v = off_v;
+
+        /* Sum the kernel, in the same order as the serial version. */
+        for (j = -w_support; j <= w_support; ++j)
+        {
+            const int row = mid - abs(off_v + j * oversample) * conv_len;
+            for (k = -w_support; k <= w_support; ++k)
+                sum += wkernel[(row + stride * k) << 1]; /* Real part only. */
+        }
+        vis_norm[i] = sum;
+    }
+
+    /* Accumulate the normalisation in visibility order. */
+    *num_skipped = 0;
+    for (i = 0; i < n; ++i)
+    {
+        if (loc[i].support < 0)
+            *num_skipped += 1;
+        else
+            *norm += vis_norm[i] * weight[i];
+    }
+
+    /* Sort the visibilities by tile. */
+    if (sort_tiles(num_points, loc, grid_size, &tiles))
+    {
+        double norm_temp = 0.0;
+        free_tiles(&tiles);
+        free(loc);
+        free(vis_norm);
+        oskar_grid_wproj2_d(num_w_planes, support, oversample, wkernel_start,
+                wkernel, num_points, uu, vv, ww, vis, weight, cell_size_rad,
+                w_scale, grid_size, num_skipped, &norm_temp, grid);
+        return;
+    }
+
+    /* Update each tile using a single thread. */
+#pragma omp parallel for private(t) schedule(dynamic)
+    for (t = 0; t < tiles.num_tiles; ++t)
+    {
+        size_t m;
+        const int u0 = (t % tiles.num_tiles_u) * TILE_SIZE;
+        const int v0 = (t / tiles.num_tiles_u) * TILE_SIZE;
+        const int u1 = (u0 + TILE_SIZE < grid_size) ?
+                u0 + TILE_SIZE : grid_size;
+        const int v1 = (v0 + TILE_SIZE < grid_size) ?
+                v0 + TILE_SIZE : grid_size;
+        for (m = tiles.offset[t]; m < tiles.offset[t + 1]; ++m)
+        {
+            int j, k;
+            const size_t i = tiles.vis_index[m];
+            const VisLocation* l = &loc[i];
+            const int w_support = l->support;
+            const int conv_len = 2 * w_support + 1;
+            const double conv_conj = (ww[i] > 0.0) ? -1.0 : 1.0;
+
+            /* Get visibility data. */
+            const double weight_i = weight[i];
+            const double v_re = weight_i * vis[2 * i];
+            const double v_im = weight_i * vis[2 * i + 1];
+
+            /* Convolve the part of this point inside the tile. */
+            const int j0 = (v0 - l->grid_v > -w_support) ?
+                    v0 - l->grid_v : -w_support;
+            const int j1 = (v1 - 1 - l->grid_v < w_support) ?
+                    v1 - 1 - l->grid_v : w_support;
+            const int k0 = (u0 - l->grid_u > -w_support) ?
+                    u0 - l->grid_u : -w_support;
+            const int k1 = (u1 - 1 - l->grid_u < w_support) ?
+                    u1 - 1 - l->grid_u : w_support;
+            for (j = j0; j <= j1; ++j)
+            {
+                const int row = l->mid - abs(l->off_v + j * oversample) *
+                        conv_len;
+                size_t p1 = l->grid_v + j;
+                p1 *= grid_size; /* Tested to avoid int overflow. */
+                p1 += l->grid_u;
+                for (k = k0; k <= k1; ++k)
+                {
+                    const int p = (row + l->stride * k) << 1;
+                    const double c_re = wkernel[p];
+                    const double c_im = wkernel[p + 1] * conv_conj;
+                    const size_t p2 = (p1 + k) << 1;
+                    grid[p2]     += (v_re * c_re - v_im * c_im);
+                    grid[p2 + 1] += (v_im * c_re + v_re * c_im);
+                }
+            }
+        }
+    }
+    free_tiles(&tiles);
+    free(loc);
+    free(vis_norm);
+}
+
+
+void oskar_grid_wproj2_tiled_f(
+        const size_t num_w_planes,
+        const int* RESTRICT support,
+        const int oversample,
+        const int* wkernel_start,
+        const float* RESTRICT wkernel,
+        const size_t num_points,
+        const float* RESTRICT uu,
+        const float* RESTRICT vv,
+        const float* RESTRICT ww,
+        const float* RESTRICT vis,
+        const float* RESTRICT weight,
+        const float cell_size_rad,
+        const float w_scale,
+        const int grid_size,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        float* RESTRICT grid)
+{
+    int i, t;
+    TileList tiles;
+    const int n = (int) num_points;
+    const int grid_centre = grid_size / 2;
+    const int oversample_h = oversample / 2;
+    const float grid_scale = grid_size * cell_size_rad;
+    VisLocation* loc = (VisLocation*) malloc(
+            (num_points > 0 ? num_points : 1) * sizeof(VisLocation));
+    double* vis_norm = (double*) malloc(
+            (num_points > 0 ? num_points : 1) * sizeof(double));
+    if (!loc || !vis_norm || num_points > (size_t) 0x7FFFFFFF)
+    {
+        free(loc);
+        free(vis_norm);
+        oskar_grid_wproj2_f(num_w_planes, support, oversample, wkernel_start,
+                wkernel, num_points, uu, vv, ww, vis, weight, cell_size_rad,
+                w_scale, grid_size, num_skipped, norm, grid);
+        return;
+    }
+
+    /* Find the grid location and kernel sum of each visibility. */
+#pragma omp parallel for private(i)
+    for (i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        int j, k;
+
+        /* Convert UV coordinates to grid coordinates. */
+        const float pos_u = -uu[i] * grid_scale;
+        const float pos_v = vv[i] * grid_scale;
+        const size_t grid_w = (size_t)roundf(sqrtf(fabsf(ww[i] * w_scale)));
+        const int grid_u = (int)roundf(pos_u) + grid_centre;
+        const int grid_v = (int)roundf(pos_v) + grid_centre;
+
+        /* Scaled distance from nearest grid point. */
+        const int off_u = (int)roundf((roundf(pos_u) - pos_u) * oversample);
+        const int off_v = (int)roundf((roundf(pos_v) - pos_v) * oversample);
+
+        /* Get kernel support size and start offset. */
+        const int w_support = grid_w < num_w_planes ?
+                support[grid_w] : support[num_w_planes - 1];
+        const int kernel_start = grid_w < num_w_planes ?
+                wkernel_start[grid_w] : wkernel_start[num_w_planes - 1];
+
+        /* Catch points that would lie outside the grid. */
+        vis_norm[i] = 0.0;
+        loc[i].support = -1;
+        if (grid_u + w_support >= grid_size || grid_u - w_support < 0 ||
+                grid_v + w_support >= grid_size || grid_v - w_support < 0)
+            continue;
+        const int conv_len = 2 * w_support + 1;
+        const int width = (oversample_h * conv_len + 1) * conv_len;
+        const int mid = kernel_start + (abs(off_u) + 1) * width - 1 - w_support;
+        const int stride = (off_u >= 0) ? 1 : -1;
+        loc[i].grid_u = grid_u;
+        loc[i].grid_v = grid_v;
+        loc[i].support = w_support;
+        loc[i].mid = mid;
+        loc[i].stride = stride;
+        loc[i].off_v = off_v;
+
+        /* Sum the kernel, in the same order as the serial version. */
+        for (j = -w_support; j <= w_support; ++j)
+        {
+            const int row = mid - abs(off_v + j * oversample) * conv_len;
+            for (k = -w_support; k <= w_support; ++k)
+                sum += wkernel[(row + stride * k) << 1]; /* Real part only. */
+        }
+        vis_norm[i] = sum;
+    }
+
+    /* Accumulate the normalisation in visibility order. */
+    *num_skipped = 0;
+    for (i = 0; i < n; ++i)
+    {
+        if (loc[i].support < 0)
+            *num_skipped += 1;
+        else
+            *norm += vis_norm[i] * weight[i];
+    }
+
+    /* Sort the visibilities by tile. */
+    if (sort_tiles(num_points, loc, grid_size, &tiles))
+    {
+        double norm_temp = 0.0;
+        free_tiles(&tiles);
+        free(loc);
+        free(vis_norm);
+        oskar_grid_wproj2_f(num_w_planes, support, oversample, wkernel_start,
+                wkernel, num_points, uu, vv, ww, vis, weight, cell_size_rad,
+                w_scale, grid_size, num_skipped, &norm_temp, grid);
+        return;
+    }
+
+    /* Update each tile using a single thread. */
+#pragma omp parallel for private(t) schedule(dynamic)
+    for (t = 0; t < tiles.num_tiles; ++t)
+    {
+        size_t m;
+        const int u0 = (t % tiles.num_tiles_u) * TILE_SIZE;
+        const int v0 = (t / tiles.num_tiles_u) * TILE_SIZE;
+        const int u1 = (u0 + TILE_SIZE < grid_size) ?
+                u0 + TILE_SIZE : grid_size;
+        const int v1 = (v0 + TILE_SIZE < grid_size) ?
+                v0 + TILE_SIZE : grid_size;
+        for (m = tiles.offset[t]; m < tiles.offset[t + 1]; ++m)
+        {
+            int j, k;
+            const size_t i = tiles.vis_index[m];
+            const VisLocation* l = &loc[i];
+            const int w_support = l->support;
+            const int conv_len = 2 * w_support + 1;
+            const float conv_conj = (ww[i] > 0.0f) ? -1.0f : 1.0f;
+
+            /* Get visibility data. */
+            const float weight_i = weight[i];
+            const float v_re = weight_i * vis[2 * i];
+            const float v_im = weight_i * vis[2 * i + 1];
+
+            /* Convolve the part of this point inside the tile. */
+            const int j0 = (v0 - l->grid_v > -w_support) ?
+                    v0 - l->grid_v : -w_support;
+            const int j1 = (v1 - 1 - l->grid_v < w_support) ?
+                    v1 - 1 - l->grid_v : w_support;
+            const int k0 = (u0 - l->grid_u > -w_support) ?
+                    u0 - l->grid_u : -w_support;
+            const int k1 = (u1 - 1 - l->grid_u < w_support) ?
+                    u1 - 1 - l->grid_u : w_support;
+            for (j = j0; j <= j1; ++j)
+            {
+                const int row = l->mid - abs(l->off_v + j * oversample) *
+                        conv_len;
+                size_t p1 = l->grid_v + j;
+                p1 *= grid_size; /* Tested to avoid int overflow. */
+                p1 += l->grid_u;
+                for (k = k0; k <= k1; ++k)
+                {
+                    const int p = (row + l->stride * k) << 1;
+                    const float c_re = wkernel[p];
+                    const float c_im = wkernel[p + 1] * conv_conj;
+                    const size_t p2 = (p1 + k) << 1;
+                    grid[p2]     += (v_re * c_re - v_im * c_im);
+                    grid[p2 + 1] += (v_im * c_re + v_re * c_im);
+                }
+            }
+        }
+    }
+    free_tiles(&tiles);
+    free(loc);
+    free(vis_norm);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,6 +32,8 @@ const char* oskar_imager_algorithm(const oskar_Imager* h)
     {
     case OSKAR_ALGORITHM_FFT:    return "FFT";
     case OSKAR_ALGORITHM_WPROJ:  return "W-projection";
+    case OSKAR_ALGORITHM_WSTACK: return "W-stacking";
+    case OSKAR_ALGORITHM_IDG:    return "IDG";
     case OSKAR_ALGORITHM_DFT_2D: return "DFT 2D";
     case OSKAR_ALGORITHM_DFT_3D: return "DFT 3D";
     default:                     return "";
@@ -165,7 +167,9 @@ int oskar_imager_plane_size(oskar_Imager* h)
 {
     if (h->grid_size == 0)
     {
-        if (h->algorithm == OSKAR_ALGORITHM_WPROJ)
+        if (h->algorithm == OSKAR_ALGORITHM_WPROJ ||
+                h->algorithm == OSKAR_ALGORITHM_WSTACK ||
+                h->algorithm == OSKAR_ALGORITHM_IDG)
         {
             (void) oskar_imager_composite_nearest_even(h->image_padding *
                     ((double)(h->image_size)) - 0.5, 0, &h->grid_size);
@@ -216,6 +220,23 @@ void oskar_imager_set_algorithm(oskar_Imager* h, const char* type,
         h->support = 3;
         h->oversample = 100;
     }
+    else if (!strncmp(type, "W-S", 3) || !strncmp(type, "w-s", 3) ||
+            !strncmp(type, "W-s", 3))
+    {
+        h->algorithm = OSKAR_ALGORITHM_WSTACK;
+        h->kernel_type = 'S';
+        h->support = 3;
+        h->oversample = 100;
+        h->image_padding = 1.2;
+    }
+    else if (!strncmp(type, "IDG", 3) || !strncmp(type, "idg", 3))
+    {
+        h->algorithm = OSKAR_ALGORITHM_IDG;
+        h->kernel_type = 'S';
+        h->support = 3;
+        h->oversample = 100;
+        h->image_padding = 1.2;
+    }
     else if (!strncmp(type, "W", 1) || !strncmp(type, "w", 1))
     {
         h->algorithm = OSKAR_ALGORITHM_WPROJ;
@@ -270,8 +291,12 @@ void oskar_imager_set_coords_only(oskar_Imager* h, int flag)
         if (h->ww_points > 0)
             h->ww_rms = sqrt(h->ww_rms / h->ww_points);
 
-        /* Calculate required number of w-planes if not set. */
-        if ((h->ww_max > 0.0) && (h->num_w_planes < 1))
+        /* Calculate required number of w-planes if not set.
+         * W-stacking and IDG work out their own number of planes
+         * when initialised. */
+        if ((h->ww_max > 0.0) && (h->num_w_planes < 1) &&
+                h->algorithm != OSKAR_ALGORITHM_WSTACK &&
+                h->algorithm != OSKAR_ALGORITHM_IDG)
         {
             double max_uvw, ww_mid;
             max_uvw = 1.05 * h->ww_max;
@@ -558,6 +583,22 @@ void oskar_imager_set_size(oskar_Imager* h, int size, int* status)
 }
 
 
+void oskar_imager_set_telescope_model(oskar_Imager* h,
+        const oskar_Telescope* model, int* status)
+{
+    if (*status) return;
+    oskar_imager_reset_cache(h, status);
+    oskar_telescope_free(h->telescope, status);
+    oskar_station_work_free(h->station_work, status);
+    h->telescope = 0;
+    h->station_work = 0;
+    if (!model) return;
+    h->telescope = oskar_telescope_create_copy(model, OSKAR_CPU, status);
+    h->station_work = oskar_station_work_create(
+            oskar_telescope_precision(model), OSKAR_CPU, status);
+}
+
+
 void oskar_imager_set_time_max_utc(oskar_Imager* h, double time_max_mjd_utc)
 {
     if (time_max_mjd_utc != 0.0 && time_max_mjd_utc != DBL_MAX)
@@ -632,6 +673,14 @@ void oskar_imager_set_vis_frequency(oskar_Imager* h,
 }
 
 
+void oskar_imager_set_vis_time(oskar_Imager* h,
+        double time_start_mjd_utc, double time_inc_sec)
+{
+    h->vis_time_start_mjd_utc = time_start_mjd_utc;
+    h->vis_time_inc_sec = time_inc_sec;
+}
+
+
 void oskar_imager_set_vis_phase_centre(oskar_Imager* h,
         double ra_deg, double dec_deg)
 {
@@ -691,6 +740,20 @@ void oskar_imager_set_num_w_planes(oskar_Imager* h, int value)
 }
 
 
+void oskar_imager_set_w_kernel_cache_dir(oskar_Imager* h, const char* dir)
+{
+    int len = 0;
+    free(h->w_kernel_cache_dir);
+    h->w_kernel_cache_dir = 0;
+    if (dir) len = (int) strlen(dir);
+    if (len > 0)
+    {
+        h->w_kernel_cache_dir = (char*) calloc(1 + len, 1);
+        strcpy(h->w_kernel_cache_dir, dir);
+    }
+}
+
+
 void oskar_imager_set_weighting(oskar_Imager* h, const char* type, int* status)
 {
     if (*status || !type) return;
@@ -736,6 +799,12 @@ double oskar_imager_uv_filter_min(const oskar_Imager* h)
 }
 
 
+const char* oskar_imager_w_kernel_cache_dir(const oskar_Imager* h)
+{
+    return h->w_kernel_cache_dir;
+}
+
+
 const char* oskar_imager_weighting(const oskar_Imager* h)
 {
     switch (h->weighting)
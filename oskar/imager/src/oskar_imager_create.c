@@ -75,6 +75,8 @@ oskar_Imager* oskar_imager_create(int imager_precision, int* status)
     h->weight_im   = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
     h->weight_tmp  = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
     h->time_im     = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    h->station1_im = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
+    h->station2_im = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
 
     /* Check data type. */
     if (imager_precision != OSKAR_SINGLE && imager_precision != OSKAR_DOUBLE)
@@ -33,6 +33,7 @@
 #include "imager/oskar_grid_functions_pillbox.h"
 #include "imager/oskar_grid_functions_spheroidal.h"
 #include "imager/private_imager_free_device_data.h"
+#include "imager/private_imager_update_plane_wstack.h"
 #include "math/oskar_fft.h"
 #include "math/oskar_fftphase.h"
 #include "mem/oskar_mem.h"
@@ -50,6 +51,8 @@
 extern "C" {
 #endif
 
+static void finalise_plane(oskar_Imager* h, oskar_Mem* plane,
+        double plane_norm, int real_only, int* status);
 static void write_plane(oskar_Imager* h, oskar_Mem* plane,
         int c, int p, int* status);
 
@@ -122,6 +125,15 @@ void oskar_imager_finalise(oskar_Imager* h,
         oskar_mem_free(temp, status);
     }
 
+    /* Grid any visibilities still held in W-stacking planes. */
+    if (h->algorithm == OSKAR_ALGORITHM_WSTACK)
+    {
+        oskar_timer_resume(h->tmr_grid_finalise);
+        for (i = 0; i < h->num_planes; ++i)
+            oskar_imager_finalise_plane_wstack(h, h->planes[i], status);
+        oskar_timer_pause(h->tmr_grid_finalise);
+    }
+
     /* Copy grids to output grid planes if given. */
     for (i = 0; (i < h->num_planes) && (i < num_output_grids); ++i)
     {
@@ -150,7 +162,8 @@ void oskar_imager_finalise(oskar_Imager* h,
                     h->algorithm == OSKAR_ALGORITHM_DFT_2D ||
                     h->algorithm == OSKAR_ALGORITHM_DFT_3D))
                 plane = h->d[0].planes[i];
-            oskar_imager_finalise_plane(h, plane, h->plane_norm[i], status);
+            /* Only the real part is needed, as the image is trimmed next. */
+            finalise_plane(h, plane, h->plane_norm[i], 1, status);
             if (plane != h->planes[i])
                 oskar_mem_copy(h->planes[i], plane, status);
             oskar_imager_trim_image(h, h->planes[i],
@@ -237,7 +250,11 @@ void oskar_imager_finalise(oskar_Imager* h,
                     (unsigned long) (h->num_vis_processed));
         if (h->num_w_planes > 0)
             oskar_log_value(h->log, 'M', 0,
-                    "W-projection planes", "%d", h->num_w_planes);
+                    (h->algorithm == OSKAR_ALGORITHM_WPROJ ?
+                    "W-projection planes" : (h->algorithm ==
+                    OSKAR_ALGORITHM_IDG ? "IDG W planes" :
+                    "W-stacking planes")),
+                    "%d", h->num_w_planes);
         if (h->fov_deg > 0.1)
             oskar_log_value(h->log, 'M', 0,
                     "Field of view [deg]", "%.1f", h->fov_deg);
@@ -305,9 +322,24 @@ void oskar_imager_finalise(oskar_Imager* h,
 
 void oskar_imager_finalise_plane(oskar_Imager* h,
         oskar_Mem* plane, double plane_norm, int* status)
+{
+    finalise_plane(h, plane, plane_norm, 0, status);
+}
+
+
+static void finalise_plane(oskar_Imager* h, oskar_Mem* plane,
+        double plane_norm, int real_only, int* status)
 {
     if (*status) return;
 
+    /* Grid any visibilities still held in a W-stacking plane. */
+    if (h->algorithm == OSKAR_ALGORITHM_WSTACK)
+    {
+        oskar_timer_resume(h->tmr_grid_finalise);
+        oskar_imager_finalise_plane_wstack(h, plane, status);
+        oskar_timer_pause(h->tmr_grid_finalise);
+    }
+
     /* Apply normalisation. */
     if (plane_norm > 0.0 || plane_norm < 0.0)
     {
@@ -343,24 +375,32 @@ void oskar_imager_finalise_plane(oskar_Imager* h,
             h->dev_loc : OSKAR_CPU;
     if (fft_loc != OSKAR_CPU)
         oskar_device_set(h->dev_loc, h->gpu_ids[0], status);
-    oskar_fftphase(size, size, plane, status);
-
-    /* Call FFT. */
     if (!h->fft)
         h->fft = oskar_fft_create(h->imager_prec, fft_loc, 2, size, 0, status);
-    oskar_fft_exec(h->fft, plane, status);
+    if (h->algorithm != OSKAR_ALGORITHM_WSTACK &&
+            h->algorithm != OSKAR_ALGORITHM_IDG)
+    {
+        oskar_fftphase(size, size, plane, status);
+
+        /* Call FFT. */
+        if (real_only)
+            oskar_fft_exec_real(h->fft, plane, status);
+        else
+            oskar_fft_exec(h->fft, plane, status);
+    }
 
     /* Generate grid correction function if required. */
     if (!h->corr_func)
     {
         oskar_Mem* corr_func = 0;
         corr_func = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, size, status);
-        if (h->algorithm != OSKAR_ALGORITHM_FFT)
+        if (h->algorithm == OSKAR_ALGORITHM_WPROJ)
             oskar_grid_correction_function_spheroidal(size, h->oversample,
                     oskar_mem_double(corr_func, status));
         else
         {
-            if (h->kernel_type == 'S')
+            if (h->kernel_type == 'S' ||
+                    h->algorithm == OSKAR_ALGORITHM_IDG)
                 oskar_grid_correction_function_spheroidal(size, 0,
                         oskar_mem_double(corr_func, status));
             else if (h->kernel_type == 'P')
@@ -54,6 +54,10 @@ void oskar_imager_free(oskar_Imager* h, int* status)
     oskar_mem_free(h->weight_im, status);
     oskar_mem_free(h->weight_tmp, status);
     oskar_mem_free(h->time_im, status);
+    oskar_mem_free(h->station1_im, status);
+    oskar_mem_free(h->station2_im, status);
+    oskar_telescope_free(h->telescope, status);
+    oskar_station_work_free(h->station_work, status);
     oskar_timer_free(h->tmr_grid_finalise);
     oskar_timer_free(h->tmr_grid_update);
     oskar_timer_free(h->tmr_init);
@@ -76,6 +80,7 @@ void oskar_imager_free(oskar_Imager* h, int* status)
     free(h->input_root);
     free(h->output_root);
     free(h->ms_column);
+    free(h->w_kernel_cache_dir);
     free(h->gpu_ids);
     free(h->d);
     free(h);
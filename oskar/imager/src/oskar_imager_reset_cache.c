@@ -41,6 +41,12 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
     oskar_mem_free(h->w_support, status); h->w_support = 0;
     oskar_mem_free(h->w_kernels_compact, status); h->w_kernels_compact = 0;
     oskar_mem_free(h->w_kernel_start, status); h->w_kernel_start = 0;
+    oskar_mem_free(h->aterms, status); h->aterms = 0;
+    oskar_mem_free(h->aterm_times, status); h->aterm_times = 0;
+    for (i = 0; i < 3; ++i)
+    {
+        oskar_mem_free(h->aterm_dir[i], status); h->aterm_dir[i] = 0;
+    }
 
     /* Free the image planes. */
     if (h->planes)
@@ -70,6 +76,8 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
     oskar_mem_realloc(h->weight_im, 0, status);
     oskar_mem_realloc(h->weight_tmp, 0, status);
     oskar_mem_realloc(h->time_im, 0, status);
+    oskar_mem_realloc(h->station1_im, 0, status);
+    oskar_mem_realloc(h->station2_im, 0, status);
     oskar_mem_free(h->stokes, status); h->stokes = 0;
 
     /* Close any open FITS files. */
@@ -93,7 +93,9 @@ void oskar_imager_run(oskar_Imager* h,
 
     /* Read baseline coordinates and weights if required. */
     if (h->weighting == OSKAR_WEIGHTING_UNIFORM ||
-            h->algorithm == OSKAR_ALGORITHM_WPROJ)
+            h->algorithm == OSKAR_ALGORITHM_WPROJ ||
+            h->algorithm == OSKAR_ALGORITHM_WSTACK ||
+            h->algorithm == OSKAR_ALGORITHM_IDG)
     {
         oskar_imager_set_coords_only(h, 1);
         oskar_log_section(h->log, 'M', "Reading coordinates...");
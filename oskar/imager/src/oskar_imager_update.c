@@ -14,7 +14,9 @@
 #include "imager/private_imager_select_data.h"
 #include "imager/private_imager_update_plane_dft.h"
 #include "imager/private_imager_update_plane_fft.h"
+#include "imager/private_imager_update_plane_idg.h"
 #include "imager/private_imager_update_plane_wproj.h"
+#include "imager/private_imager_update_plane_wstack.h"
 #include "imager/private_imager_weight_radial.h"
 #include "imager/private_imager_weight_uniform.h"
 #include "log/oskar_log.h"
@@ -38,9 +40,12 @@ void oskar_imager_update_from_block(oskar_Imager* h,
         const oskar_VisHeader* hdr, oskar_VisBlock* block,
         int* status)
 {
-    int c, t;
+    int c, t, s1, s2;
+    int *station1_, *station2_;
+    size_t i = 0;
     double time_start_mjd, time_inc_sec;
     oskar_Mem *weight = 0, *weight_ptr = 0, *time_centroid;
+    oskar_Mem *station1, *station2;
     if (*status) return;
 
     /* Check that cross-correlations exist. */
@@ -54,6 +59,7 @@ void oskar_imager_update_from_block(oskar_Imager* h,
     const int num_channels  = oskar_vis_block_num_channels(block);
     const int num_pols      = oskar_vis_block_num_pols(block);
     const int num_times     = oskar_vis_block_num_times(block);
+    const int num_stations  = oskar_vis_block_num_stations(block);
     const size_t num_rows   = num_baselines * num_times;
 
     /* Get visibility meta-data. */
@@ -66,6 +72,8 @@ void oskar_imager_update_from_block(oskar_Imager* h,
     oskar_imager_set_vis_phase_centre(h,
             oskar_vis_header_phase_centre_ra_deg(hdr),
             oskar_vis_header_phase_centre_dec_deg(hdr));
+    oskar_imager_set_vis_time(h, oskar_vis_header_time_start_mjd_utc(hdr),
+            oskar_vis_header_time_inc_sec(hdr));
 
     /* Weights are all 1. */
     if (!weight)
@@ -86,6 +94,23 @@ void oskar_imager_update_from_block(oskar_Imager* h,
                 time_start_mjd + (start_time + t + 0.5) * time_inc_sec,
                 t * num_baselines, num_baselines, status);
 
+    /* Fill in the station indices of each baseline. */
+    station1 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_rows, status);
+    station2 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_rows, status);
+    station1_ = oskar_mem_int(station1, status);
+    station2_ = oskar_mem_int(station2, status);
+    for (t = 0; t < num_times && !*status; ++t)
+    {
+        for (s1 = 0; s1 < num_stations; ++s1)
+        {
+            for (s2 = s1 + 1; s2 < num_stations; ++s2, ++i)
+            {
+                station1_[i] = s1;
+                station2_[i] = s2;
+            }
+        }
+    }
+
     /* Get baseline coordinates if required. */
     if (oskar_vis_block_has_station_coords(block))
         oskar_vis_block_station_to_baseline_coords(block, status);
@@ -114,12 +139,13 @@ void oskar_imager_update_from_block(oskar_Imager* h,
                             num_baselines, status);
                 }
                 oskar_timer_pause(h->tmr_copy_convert);
-                oskar_imager_update(h, num_rows,
+                oskar_imager_update_with_stations(h, num_rows,
                         start_chan + c, start_chan + c, num_pols,
                         oskar_vis_block_baseline_uu_metres_const(block),
                         oskar_vis_block_baseline_vv_metres_const(block),
                         oskar_vis_block_baseline_ww_metres_const(block),
-                        scratch, weight_ptr, time_centroid, status);
+                        scratch, weight_ptr, time_centroid,
+                        station1, station2, status);
             }
         }
         oskar_mem_free(scratch, status);
@@ -134,18 +160,21 @@ void oskar_imager_update_from_block(oskar_Imager* h,
             if (freq_hz >= h->freq_min_hz &&
                     (freq_hz <= h->freq_max_hz || h->freq_max_hz == 0.0))
             {
-                oskar_imager_update(h, num_rows,
+                oskar_imager_update_with_stations(h, num_rows,
                         start_chan + c, start_chan + c, num_pols,
                         oskar_vis_block_baseline_uu_metres_const(block),
                         oskar_vis_block_baseline_vv_metres_const(block),
                         oskar_vis_block_baseline_ww_metres_const(block),
-                        0, weight_ptr, time_centroid, status);
+                        0, weight_ptr, time_centroid,
+                        station1, station2, status);
             }
         }
     }
 
     oskar_mem_free(weight, status);
     oskar_mem_free(time_centroid, status);
+    oskar_mem_free(station1, status);
+    oskar_mem_free(station2, status);
 }
 
 #if 0
@@ -265,6 +294,17 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
         int end_chan, int num_pols, const oskar_Mem* uu, const oskar_Mem* vv,
         const oskar_Mem* ww, const oskar_Mem* amps, const oskar_Mem* weight,
         const oskar_Mem* time_centroid, int* status)
+{
+    oskar_imager_update_with_stations(h, num_rows, start_chan, end_chan,
+            num_pols, uu, vv, ww, amps, weight, time_centroid, 0, 0, status);
+}
+
+
+void oskar_imager_update_with_stations(oskar_Imager* h, size_t num_rows,
+        int start_chan, int end_chan, int num_pols, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, const oskar_Mem* time_centroid,
+        const oskar_Mem* station1, const oskar_Mem* station2, int* status)
 {
     int c, p, i_plane;
     size_t max_num_vis;
@@ -355,6 +395,16 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
     if (!h->coords_only)
         oskar_mem_ensure(h->vis_im, max_num_vis, status);
     oskar_mem_ensure(h->weight_im, max_num_vis, status);
+    if (station1 && station2)
+    {
+        oskar_mem_ensure(h->station1_im, max_num_vis, status);
+        oskar_mem_ensure(h->station2_im, max_num_vis, status);
+    }
+    else
+    {
+        station1 = 0;
+        station2 = 0;
+    }
     if (h->direction_type == 'R')
     {
         oskar_mem_ensure(h->uu_tmp, max_num_vis, status);
@@ -367,23 +417,31 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
     {
         for (p = 0; p < h->num_im_pols; ++p)
         {
-            oskar_Mem *pu, *pv, *pw, *pt;
+            oskar_Mem *pu, *pv, *pw, *pt, *ps1 = 0, *ps2 = 0;
             size_t num_vis = 0;
             if (*status) break;
 
-            /* Get all visibility data needed to update this plane. */
+            /* Get all visibility data needed to update this plane.
+             * Time centroids are also needed to evaluate station beams. */
             pu = h->uu_im; pv = h->vv_im; pw = h->ww_im; pt = h->time_im;
             if (h->direction_type == 'R')
             {
                 pu = h->uu_tmp; pv = h->vv_tmp; pw = h->ww_tmp;
             }
-            if (h->time_min_utc <= 0.0 && h->time_max_utc <= 0.0) pt = 0;
+            if (h->time_min_utc <= 0.0 && h->time_max_utc <= 0.0 &&
+                    !(h->algorithm == OSKAR_ALGORITHM_IDG && h->telescope))
+                pt = 0;
+            if (!time_centroid) pt = 0;
+            if (station1)
+            {
+                ps1 = h->station1_im; ps2 = h->station2_im;
+            }
             oskar_timer_resume(h->tmr_select_scale);
             oskar_imager_select_data(h, num_rows, start_chan, end_chan,
                     num_pols, u_in, v_in, w_in, amp_in, weight_in,
-                    time_centroid, h->im_freqs[c], p,
+                    time_centroid, station1, station2, h->im_freqs[c], p,
                     &num_vis, pu, pv, pw, h->vis_im, h->weight_im,
-                    pt, status);
+                    pt, ps1, ps2, status);
             oskar_timer_pause(h->tmr_select_scale);
 
             /* Skip if nothing was selected. */
@@ -408,9 +466,9 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
 
             /* Apply time and baseline length filters if required. */
             oskar_imager_filter_time(h, &num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, h->vis_im, h->weight_im, pt, status);
+                    h->ww_im, h->vis_im, h->weight_im, pt, ps1, ps2, status);
             oskar_imager_filter_uv(h, &num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, h->vis_im, h->weight_im, status);
+                    h->ww_im, h->vis_im, h->weight_im, pt, ps1, ps2, status);
 
 #if 0
             /* Sort visibility data by w coordinate. */
@@ -421,9 +479,11 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
 
             /* Update this image plane with the visibilities. */
             i_plane = h->num_im_pols * c + p;
-            oskar_imager_update_plane(h, num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, (h->coords_only ? 0 : h->vis_im), h->weight_im,
-                    i_plane, 0, 0, h->weights_grids[i_plane], status);
+            oskar_imager_update_plane_with_stations(h, num_vis,
+                    h->uu_im, h->vv_im, h->ww_im,
+                    (h->coords_only ? 0 : h->vis_im), h->weight_im,
+                    pt, ps1, ps2, i_plane, 0, 0,
+                    h->weights_grids[i_plane], status);
         }
     }
 
@@ -440,6 +500,18 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
         const oskar_Mem* amps, const oskar_Mem* weight, int i_plane,
         oskar_Mem* plane, double* plane_norm, oskar_Mem* weights_grid,
         int* status)
+{
+    oskar_imager_update_plane_with_stations(h, num_vis, uu, vv, ww, amps,
+            weight, 0, 0, 0, i_plane, plane, plane_norm, weights_grid, status);
+}
+
+
+void oskar_imager_update_plane_with_stations(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight,
+        const oskar_Mem* time_centroid, const oskar_Mem* station1,
+        const oskar_Mem* station2, int i_plane, oskar_Mem* plane,
+        double* plane_norm, oskar_Mem* weights_grid, int* status)
 {
     oskar_Mem *tu = 0, *tv = 0, *tw = 0, *ta = 0, *th = 0;
     const oskar_Mem *pu, *pv, *pw, *pa, *ph;
@@ -549,6 +621,15 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
             oskar_imager_update_plane_wproj(h, num_vis, pu, pv, pw, pa, ph,
                     i_plane, plane, plane_norm_ptr, &num_skipped, status);
             break;
+        case OSKAR_ALGORITHM_WSTACK:
+            oskar_imager_update_plane_wstack(h, num_vis, pu, pv, pw, pa, ph,
+                    i_plane, plane, plane_norm_ptr, &num_skipped, status);
+            break;
+        case OSKAR_ALGORITHM_IDG:
+            oskar_imager_update_plane_idg(h, num_vis, pu, pv, pw, pa, ph,
+                    time_centroid, station1, station2, i_plane, plane,
+                    plane_norm_ptr, &num_skipped, status);
+            break;
         default:
             *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
             break;
@@ -616,7 +697,9 @@ void oskar_imager_update_weights_grid(oskar_Imager* h, size_t num_points,
     }
 
     /* Update baseline W minimum, maximum and RMS. */
-    if (h->algorithm == OSKAR_ALGORITHM_WPROJ)
+    if (h->algorithm == OSKAR_ALGORITHM_WPROJ ||
+            h->algorithm == OSKAR_ALGORITHM_WSTACK ||
+            h->algorithm == OSKAR_ALGORITHM_IDG)
     {
         size_t j;
         oskar_timer_resume(h->tmr_coord_scan);
@@ -37,9 +37,11 @@ extern "C" {
 
 void oskar_imager_filter_time(oskar_Imager* h, size_t* num_vis,
         oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, oskar_Mem* time_centroid, int* status)
+        oskar_Mem* weight, oskar_Mem* time_centroid, oskar_Mem* station1,
+        oskar_Mem* station2, int* status)
 {
     size_t i;
+    int *s1_ = 0, *s2_ = 0;
     double t, range[2], *time_centroid_;
 
     /* Return immediately if filtering is not enabled. */
@@ -60,6 +62,11 @@ void oskar_imager_filter_time(oskar_Imager* h, size_t* num_vis,
     /* Apply the time centroid filter. */
     oskar_timer_resume(h->tmr_filter);
     time_centroid_ = oskar_mem_double(time_centroid, status);
+    if (station1 && station2)
+    {
+        s1_ = oskar_mem_int(station1, status);
+        s2_ = oskar_mem_int(station2, status);
+    }
     if (h->imager_prec == OSKAR_DOUBLE)
     {
         double2* amp_ = 0;
@@ -82,6 +89,11 @@ void oskar_imager_filter_time(oskar_Imager* h, size_t* num_vis,
                 weight_[*num_vis] = weight_[i];
                 time_centroid_[*num_vis] = t;
                 if (amp_) amp_[*num_vis] = amp_[i];
+                if (s1_)
+                {
+                    s1_[*num_vis] = s1_[i];
+                    s2_[*num_vis] = s2_[i];
+                }
                 (*num_vis)++;
             }
         }
@@ -108,6 +120,11 @@ void oskar_imager_filter_time(oskar_Imager* h, size_t* num_vis,
                 weight_[*num_vis] = weight_[i];
                 time_centroid_[*num_vis] = t;
                 if (amp_) amp_[*num_vis] = amp_[i];
+                if (s1_)
+                {
+                    s1_[*num_vis] = s1_[i];
+                    s2_[*num_vis] = s2_[i];
+                }
                 (*num_vis)++;
             }
         }
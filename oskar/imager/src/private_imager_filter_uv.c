@@ -37,10 +37,12 @@ extern "C" {
 
 void oskar_imager_filter_uv(oskar_Imager* h, size_t* num_vis,
         oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* amp,
-        oskar_Mem* weight, int* status)
+        oskar_Mem* weight, oskar_Mem* time_centroid, oskar_Mem* station1,
+        oskar_Mem* station2, int* status)
 {
     size_t i;
-    double r, range[2];
+    int *s1_ = 0, *s2_ = 0;
+    double r, range[2], *time_centroid_ = 0;
 
     /* Return immediately if filtering is not enabled. */
     if (h->uv_filter_min <= 0.0 &&
@@ -60,6 +62,13 @@ void oskar_imager_filter_uv(oskar_Imager* h, size_t* num_vis,
 
     /* Apply the UV baseline length filter. */
     oskar_timer_resume(h->tmr_filter);
+    if (time_centroid && oskar_mem_length(time_centroid) > 0)
+        time_centroid_ = oskar_mem_double(time_centroid, status);
+    if (station1 && station2)
+    {
+        s1_ = oskar_mem_int(station1, status);
+        s2_ = oskar_mem_int(station2, status);
+    }
     if (h->imager_prec == OSKAR_DOUBLE)
     {
         double2* amp_ = 0;
@@ -81,6 +90,13 @@ void oskar_imager_filter_uv(oskar_Imager* h, size_t* num_vis,
                 ww_[*num_vis] = ww_[i];
                 weight_[*num_vis] = weight_[i];
                 if (amp_) amp_[*num_vis] = amp_[i];
+                if (time_centroid_)
+                    time_centroid_[*num_vis] = time_centroid_[i];
+                if (s1_)
+                {
+                    s1_[*num_vis] = s1_[i];
+                    s2_[*num_vis] = s2_[i];
+                }
                 (*num_vis)++;
             }
         }
@@ -106,6 +122,13 @@ void oskar_imager_filter_uv(oskar_Imager* h, size_t* num_vis,
                 ww_[*num_vis] = ww_[i];
                 weight_[*num_vis] = weight_[i];
                 if (amp_) amp_[*num_vis] = amp_[i];
+                if (time_centroid_)
+                    time_centroid_[*num_vis] = time_centroid_[i];
+                if (s1_)
+                {
+                    s1_[*num_vis] = s1_[i];
+                    s2_[*num_vis] = s2_[i];
+                }
                 (*num_vis)++;
             }
         }
@@ -32,6 +32,7 @@
 #include "imager/private_imager_composite_nearest_even.h"
 #include "imager/private_imager_generate_w_phase_screen.h"
 #include "imager/private_imager_init_wproj.h"
+#include "imager/private_imager_w_kernel_cache.h"
 #include "imager/oskar_grid_functions_spheroidal.h"
 #include "math/oskar_cmath.h"
 #include "math/oskar_fft.h"
@@ -51,8 +52,7 @@ extern "C" {
 
 #include <fitsio.h>
 
-static void oskar_imager_evaluate_w_kernel_params(const oskar_Imager* h,
-        int* num_w_planes, double* w_scale);
+static void oskar_imager_generate_w_kernels(oskar_Imager* h, int* status);
 
 static oskar_Mem* oskar_imager_evaluate_w_kernel_cube(oskar_Imager* h,
         int num_w_planes, double w_scale,
@@ -81,55 +81,18 @@ static void oskar_imager_rearrange_kernels(int num_w_planes,
  */
 void oskar_imager_init_wproj(oskar_Imager* h, int* status)
 {
-    size_t conv_size_half = 0;
-    double norm_factor = 1.;
-    oskar_Mem *kernel_cube = 0;
-    const int save_kernels = 0;
     if (*status) return;
 
     /* Evaluate number of w-projection planes, and w-scale. */
     oskar_imager_evaluate_w_kernel_params(h, &h->num_w_planes, &h->w_scale);
 
-    /* Evaluate unnormalised kernels. */
-    kernel_cube = oskar_imager_evaluate_w_kernel_cube(h, h->num_w_planes,
-            h->w_scale, &conv_size_half, &norm_factor, status);
-
-    /* Evaluate the support size of each kernel. */
-    oskar_mem_free(h->w_support, status);
-    h->w_support = oskar_imager_evaluate_w_kernel_support_sizes(
-            h->num_w_planes, h->oversample, conv_size_half,
-            kernel_cube, norm_factor, status);
-
-#if 0
-    /* Print kernel support sizes. */
+    /* Load the kernels from the cache if possible, or generate them. */
+    if (!oskar_imager_w_kernel_cache_read(h, status))
     {
-        int i;
-        for (i = 0; i < h->num_w_planes; ++i)
-        {
-            const int* supp = oskar_mem_int_const(h->w_support, status);
-            printf("Plane %d, support: %d\n", i, supp[i]);
-        }
+        oskar_imager_generate_w_kernels(h, status);
+        oskar_imager_w_kernel_cache_write(h, status);
     }
-#endif
-
-    /* Normalise the kernel cube. */
-    oskar_imager_normalise_kernel_cube(h->w_support, h->oversample,
-            conv_size_half, kernel_cube, status);
-    if (save_kernels)
-        oskar_imager_trim_and_save_kernel_cube(h, h->num_w_planes,
-                h->w_support, &conv_size_half, kernel_cube, status);
-
-    /* Rearrange and compact the kernels. */
-    oskar_mem_free(h->w_kernels_compact, status);
-    oskar_mem_free(h->w_kernel_start, status);
-    h->w_kernel_start = oskar_mem_create(OSKAR_INT, OSKAR_CPU,
-            h->num_w_planes, status);
-    h->w_kernels_compact = oskar_mem_create(h->imager_prec| OSKAR_COMPLEX,
-            OSKAR_CPU, 0, status);
-    oskar_imager_rearrange_kernels(h->num_w_planes, h->w_support,
-            h->oversample, conv_size_half, kernel_cube, h->w_kernels_compact,
-            oskar_mem_int(h->w_kernel_start, status), status);
-    oskar_mem_free(kernel_cube, status);
+    if (*status) return;
 
     /* Record data about the kernels. */
     oskar_log_message(h->log, 'M', 0, "Baseline W values (wavelengths)");
@@ -176,7 +139,59 @@ void oskar_imager_init_wproj(oskar_Imager* h, int* status)
 }
 
 
-static void oskar_imager_evaluate_w_kernel_params(const oskar_Imager* h,
+/* Generates the compacted W-projection kernels. */
+static void oskar_imager_generate_w_kernels(oskar_Imager* h, int* status)
+{
+    size_t conv_size_half = 0;
+    double norm_factor = 1.;
+    oskar_Mem *kernel_cube = 0;
+    const int save_kernels = 0;
+    if (*status) return;
+
+    /* Evaluate unnormalised kernels. */
+    kernel_cube = oskar_imager_evaluate_w_kernel_cube(h, h->num_w_planes,
+            h->w_scale, &conv_size_half, &norm_factor, status);
+
+    /* Evaluate the support size of each kernel. */
+    oskar_mem_free(h->w_support, status);
+    h->w_support = oskar_imager_evaluate_w_kernel_support_sizes(
+            h->num_w_planes, h->oversample, conv_size_half,
+            kernel_cube, norm_factor, status);
+
+#if 0
+    /* Print kernel support sizes. */
+    {
+        int i;
+        for (i = 0; i < h->num_w_planes; ++i)
+        {
+            const int* supp = oskar_mem_int_const(h->w_support, status);
+            printf("Plane %d, support: %d\n", i, supp[i]);
+        }
+    }
+#endif
+
+    /* Normalise the kernel cube. */
+    oskar_imager_normalise_kernel_cube(h->w_support, h->oversample,
+            conv_size_half, kernel_cube, status);
+    if (save_kernels)
+        oskar_imager_trim_and_save_kernel_cube(h, h->num_w_planes,
+                h->w_support, &conv_size_half, kernel_cube, status);
+
+    /* Rearrange and compact the kernels. */
+    oskar_mem_free(h->w_kernels_compact, status);
+    oskar_mem_free(h->w_kernel_start, status);
+    h->w_kernel_start = oskar_mem_create(OSKAR_INT, OSKAR_CPU,
+            h->num_w_planes, status);
+    h->w_kernels_compact = oskar_mem_create(h->imager_prec| OSKAR_COMPLEX,
+            OSKAR_CPU, 0, status);
+    oskar_imager_rearrange_kernels(h->num_w_planes, h->w_support,
+            h->oversample, conv_size_half, kernel_cube, h->w_kernels_compact,
+            oskar_mem_int(h->w_kernel_start, status), status);
+    oskar_mem_free(kernel_cube, status);
+}
+
+
+void oskar_imager_evaluate_w_kernel_params(const oskar_Imager* h,
         int* num_w_planes, double* w_scale)
 {
     double max_uvw = 0.0;
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/oskar_grid_idg.h"
+#include "imager/private_imager_init_fft.h"
+#include "imager/private_imager_init_wstack.h"
+#include "imager/private_imager_update_plane_idg.h"
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum phase error, in radians, allowed at the edge of the image
+ * between the W term of a visibility and that of its W plane. */
+#define MAX_W_PHASE_ERROR 0.1
+
+/*
+ * Sets the number of W-stacking planes, and the W scale.
+ * Planes are spaced linearly in |w|, with plane k at w = k / w_scale,
+ * so that the residual W term of any visibility changes the phase across
+ * the image by at most MAX_W_PHASE_ERROR, unless the number of planes
+ * has been set explicitly.
+ * Image-domain gridding corrects the residual W term of each visibility,
+ * so it only needs enough planes for the residual to fit in the margin
+ * of a subgrid, which is also the minimum if the number has been set.
+ */
+static void set_w_planes(oskar_Imager* h)
+{
+    const double w_max = (h->ww_max > 0.0) ?
+            h->ww_max : 0.25 / fabs(h->cellsize_rad);
+    const double l_max = 0.5 * h->image_size * fabs(h->cellsize_rad);
+    const double r2 = 1.0 - 2.0 * l_max * l_max;
+    const double n_max = (r2 > 0.0) ? 1.0 - sqrt(r2) : 1.0;
+    if (h->algorithm == OSKAR_ALGORITHM_IDG)
+    {
+        const int min_planes = oskar_grid_idg_num_w_planes(
+                OSKAR_IDG_SUBGRID_SIZE, h->support, w_max,
+                h->cellsize_rad, oskar_imager_plane_size(h));
+        if (h->num_w_planes < min_planes) h->num_w_planes = min_planes;
+    }
+    else if (h->num_w_planes < 1)
+        h->num_w_planes = 1 + (int) ceil(w_max * M_PI * n_max /
+                MAX_W_PHASE_ERROR);
+    h->w_scale = (h->num_w_planes > 1) ? (h->num_w_planes - 1) / w_max : 0.0;
+}
+
+void oskar_imager_init_wstack(oskar_Imager* h, int* status)
+{
+    if (*status) return;
+
+    /* W planes are only gridded and transformed on the CPU. */
+    if (h->grid_on_gpu)
+    {
+        oskar_log_warning(h->log, "%s grids are only updated on the CPU.",
+                oskar_imager_algorithm(h));
+        h->grid_on_gpu = 0;
+    }
+    h->fft_on_gpu = 0;
+
+    /* Generate the convolution function used for each W plane.
+     * Image-domain gridding uses its own taper instead. */
+    if (h->algorithm == OSKAR_ALGORITHM_WSTACK)
+        oskar_imager_init_fft(h, status);
+
+    /* Set the number of W planes, and W-scale. */
+    set_w_planes(h);
+
+    /* Record data about the W planes. */
+    oskar_log_message(h->log, 'M', 0, "Baseline W values (wavelengths)");
+    oskar_log_message(h->log, 'M', 1, "Min: %.12e", h->ww_min);
+    oskar_log_message(h->log, 'M', 1, "Max: %.12e", h->ww_max);
+    oskar_log_message(h->log, 'M', 1, "RMS: %.12e", h->ww_rms);
+    oskar_log_message(h->log, 'M', 0,
+            "Using %d %s planes (W increment %.3e wavelengths).",
+            h->num_w_planes, (h->algorithm == OSKAR_ALGORITHM_WSTACK ?
+            "W-stacking" : "IDG W"),
+            h->w_scale > 0.0 ? 1.0 / h->w_scale : 0.0);
+}
+
+#ifdef __cplusplus
+}
+#endif
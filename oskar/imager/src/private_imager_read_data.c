@@ -30,6 +30,7 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
 #ifndef OSKAR_NO_MS
     oskar_MeasurementSet* ms;
     oskar_Mem *uvw, *u, *v, *w, *data, *weight, *time_centroid;
+    oskar_Mem *station1, *station2;
     int type;
     size_t start_row;
     double *uvw_, *u_, *v_, *w_;
@@ -56,6 +57,8 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
     oskar_imager_set_vis_phase_centre(h,
             oskar_ms_phase_centre_ra_rad(ms) * 180/M_PI,
             oskar_ms_phase_centre_dec_rad(ms) * 180/M_PI);
+    oskar_imager_set_vis_time(h, oskar_ms_time_start_mjd_utc(ms),
+            oskar_ms_time_inc_sec(ms));
 
     /* Create arrays. */
     uvw = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 3 * num_baselines, status);
@@ -66,6 +69,8 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
             num_baselines * num_pols, status);
     time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines,
             status);
+    station1 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_baselines, status);
+    station2 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_baselines, status);
     uvw_ = oskar_mem_double(uvw, status);
     u_ = oskar_mem_double(u, status);
     v_ = oskar_mem_double(v, status);
@@ -97,6 +102,12 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
                 oskar_mem_element_size(oskar_mem_type(time_centroid));
         oskar_ms_read_column(ms, "TIME_CENTROID", start_row, block_size,
                 allocated, oskar_mem_void(time_centroid), &required, status);
+        allocated = oskar_mem_length(station1) *
+                oskar_mem_element_size(oskar_mem_type(station1));
+        oskar_ms_read_column(ms, "ANTENNA1", start_row, block_size,
+                allocated, oskar_mem_void(station1), &required, status);
+        oskar_ms_read_column(ms, "ANTENNA2", start_row, block_size,
+                allocated, oskar_mem_void(station2), &required, status);
         allocated = oskar_mem_length(data) *
                 oskar_mem_element_size(oskar_mem_type(data));
         oskar_ms_read_column(ms, h->ms_column, start_row, block_size,
@@ -113,8 +124,9 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
 
         /* Update the imager with the data. */
         oskar_timer_pause(h->tmr_read);
-        oskar_imager_update(h, block_size, 0, num_channels - 1,
-                num_pols, u, v, w, data, weight, time_centroid, status);
+        oskar_imager_update_with_stations(h, block_size, 0, num_channels - 1,
+                num_pols, u, v, w, data, weight, time_centroid,
+                station1, station2, status);
         *percent_done = (int) round(100.0 * (
                 (start_row + block_size) / (double)(num_rows * num_files) +
                 i_file / (double)num_files));
@@ -131,6 +143,8 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
     oskar_mem_free(data, status);
     oskar_mem_free(weight, status);
     oskar_mem_free(time_centroid, status);
+    oskar_mem_free(station1, status);
+    oskar_mem_free(station2, status);
     oskar_ms_close(ms);
 #else
     (void) filename;
@@ -152,8 +166,9 @@ void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
     oskar_Binary* vis_file;
     oskar_VisBlock* block;
     oskar_VisHeader* hdr;
-    oskar_Mem *weight, *time_centroid, *scratch;
-    int i_block;
+    oskar_Mem *weight, *time_centroid, *scratch, *station1, *station2;
+    int i_block, s1, s2, t;
+    int *station1_, *station2_;
     double time_start_mjd, time_inc_sec;
     if (*status) return;
 
@@ -186,6 +201,8 @@ void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
     oskar_imager_set_vis_phase_centre(h,
             oskar_vis_header_phase_centre_ra_deg(hdr),
             oskar_vis_header_phase_centre_dec_deg(hdr));
+    oskar_imager_set_vis_time(h, oskar_vis_header_time_start_mjd_utc(hdr),
+            oskar_vis_header_time_inc_sec(hdr));
 
     /* Create scratch arrays. Weights are all 1. */
     time_centroid = oskar_mem_create(OSKAR_DOUBLE,
@@ -195,11 +212,31 @@ void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
     scratch = oskar_mem_create(oskar_vis_header_amp_type(hdr), OSKAR_CPU,
             num_baselines * max_times_per_block, status);
 
+    /* Fill in the station indices of each baseline. */
+    station1 = oskar_mem_create(OSKAR_INT, OSKAR_CPU,
+            num_baselines * max_times_per_block, status);
+    station2 = oskar_mem_create(OSKAR_INT, OSKAR_CPU,
+            num_baselines * max_times_per_block, status);
+    station1_ = oskar_mem_int(station1, status);
+    station2_ = oskar_mem_int(station2, status);
+    for (t = 0; t < max_times_per_block && !*status; ++t)
+    {
+        int i = t * num_baselines;
+        for (s1 = 0; s1 < num_stations; ++s1)
+        {
+            for (s2 = s1 + 1; s2 < num_stations; ++s2, ++i)
+            {
+                station1_[i] = s1;
+                station2_[i] = s2;
+            }
+        }
+    }
+
     /* Loop over visibility blocks. */
     block = oskar_vis_block_create_from_header(OSKAR_CPU, hdr, status);
     for (i_block = 0; i_block < num_blocks; ++i_block)
     {
-        int c, t;
+        int c;
         if (*status) break;
 
         /* Read the visibility data. */
@@ -239,12 +276,13 @@ void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
                             num_baselines, status);
                 }
                 oskar_timer_pause(h->tmr_copy_convert);
-                oskar_imager_update(h, num_rows,
+                oskar_imager_update_with_stations(h, num_rows,
                         start_chan + c, start_chan + c, num_pols,
                         oskar_vis_block_baseline_uu_metres_const(block),
                         oskar_vis_block_baseline_vv_metres_const(block),
                         oskar_vis_block_baseline_ww_metres_const(block),
-                        scratch, weight, time_centroid, status);
+                        scratch, weight, time_centroid,
+                        station1, station2, status);
             }
         }
         *percent_done = (int) round(100.0 * (
@@ -259,6 +297,8 @@ void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
     oskar_mem_free(scratch, status);
     oskar_mem_free(weight, status);
     oskar_mem_free(time_centroid, status);
+    oskar_mem_free(station1, status);
+    oskar_mem_free(station2, status);
     oskar_vis_block_free(block, status);
     oskar_vis_header_free(hdr, status);
     oskar_binary_free(vis_file);
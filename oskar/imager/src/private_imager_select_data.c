@@ -99,6 +99,8 @@ void oskar_imager_select_data(
         const oskar_Mem* vis_in,
         const oskar_Mem* weight_in,
         const oskar_Mem* time_in,
+        const oskar_Mem* station1_in,
+        const oskar_Mem* station2_in,
         double im_freq_hz,
         int im_pol,
         size_t* num_out,
@@ -108,6 +110,8 @@ void oskar_imager_select_data(
         oskar_Mem* vis_out,
         oskar_Mem* weight_out,
         oskar_Mem* time_out,
+        oskar_Mem* station1_out,
+        oskar_Mem* station2_out,
         int* status)
 {
     int i, c, p;
@@ -173,6 +177,17 @@ void oskar_imager_select_data(
             oskar_mem_ensure(time_out, num_rows, status);
             oskar_mem_copy_contents(time_out, time_in, 0, 0, num_rows, status);
         }
+
+        /* Copy station indices if present. */
+        if (station1_in && station2_in && station1_out && station2_out)
+        {
+            oskar_mem_ensure(station1_out, num_rows, status);
+            oskar_mem_ensure(station2_out, num_rows, status);
+            oskar_mem_copy_contents(station1_out, station1_in,
+                    0, 0, num_rows, status);
+            oskar_mem_copy_contents(station2_out, station2_in,
+                    0, 0, num_rows, status);
+        }
         *num_out += num_rows;
     }
     else /* Frequency synthesis */
@@ -226,6 +241,19 @@ void oskar_imager_select_data(
                 oskar_mem_copy_contents(time_out, time_in, *num_out, 0,
                         num_rows, status);
             }
+
+            /* Copy station indices if present. */
+            if (station1_in && station2_in && station1_out && station2_out)
+            {
+                oskar_mem_ensure(station1_out,
+                        num_rows * num_channels, status);
+                oskar_mem_ensure(station2_out,
+                        num_rows * num_channels, status);
+                oskar_mem_copy_contents(station1_out, station1_in,
+                        *num_out, 0, num_rows, status);
+                oskar_mem_copy_contents(station2_out, station2_in,
+                        *num_out, 0, num_rows, status);
+            }
             *num_out += num_rows;
         }
     }
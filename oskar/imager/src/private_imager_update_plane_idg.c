@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_generate_w_phase_screen.h"
+#include "imager/private_imager_update_plane_idg.h"
+#include "imager/oskar_grid_functions_spheroidal.h"
+#include "imager/oskar_grid_idg.h"
+#include "convert/oskar_convert_mjd_to_gast_fast.h"
+#include "math/oskar_cmath.h"
+#include "math/oskar_fft.h"
+#include "math/oskar_fftphase.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEG2RAD (M_PI / 180.0)
+
+/* Returns the W plane of a visibility, as found by oskar_grid_idg_*(). */
+#define OSKAR_IDG_W_PLANE(NAME, FP) \
+static void NAME(const size_t num_vis, const FP* ww, const double w_scale, \
+        const int num_w_planes, int* iw) \
+{ \
+    size_t i; \
+    for (i = 0; i < num_vis; ++i) \
+    { \
+        int k = 0; \
+        if (w_scale > 0.0) \
+        { \
+            k = (int) round(fabs((double) ww[i]) * w_scale); \
+            if (k >= num_w_planes) k = num_w_planes - 1; \
+        } \
+        iw[i] = k; \
+    } \
+}
+
+OSKAR_IDG_W_PLANE(w_plane_d, double)
+OSKAR_IDG_W_PLANE(w_plane_f, float)
+
+/* Multiplies a transformed W plane by the complex conjugate of its
+ * phase screen, and adds it to the image.
+ * The screen is centred on element 0, and the image on size / 2. */
+#define OSKAR_IDG_ACCUMULATE(NAME, FP) \
+static void NAME(const int size, const FP* screen, const FP* layer, \
+        FP* image) \
+{ \
+    int y; \
+    const int half = size / 2; \
+    _Pragma("omp parallel for private(y)") \
+    for (y = 0; y < size; ++y) \
+    { \
+        int x; \
+        const FP* s = &screen[2 * (size_t) size * ((y + half) % size)]; \
+        const FP* a = &layer[2 * (size_t) size * y]; \
+        FP* b = &image[2 * (size_t) size * y]; \
+        for (x = 0; x < size; ++x) \
+        { \
+            const int j = 2 * ((x + half) % size); \
+            b[2 * x] += a[2 * x] * s[j] + a[2 * x + 1] * s[j + 1]; \
+            b[2 * x + 1] += a[2 * x + 1] * s[j] - a[2 * x] * s[j + 1]; \
+        } \
+    } \
+}
+
+OSKAR_IDG_ACCUMULATE(accumulate_d, double)
+OSKAR_IDG_ACCUMULATE(accumulate_f, float)
+
+static int find_time(const oskar_Imager* h, double time_mjd_sec);
+static void update_aterms(oskar_Imager* h, size_t num_vis,
+        const double* time_centroid, double freq_hz, int* status);
+static void gather(const oskar_Mem* in, const size_t* order, size_t num,
+        oskar_Mem* out, int* status);
+static void grid(oskar_Imager* h, const oskar_Mem* taper, int w_plane,
+        const oskar_Mem* aterms, size_t aterm_offset,
+        const int* station1, const int* station2,
+        size_t offset, size_t num_vis, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, double* plane_norm, size_t* num_skipped,
+        oskar_Mem* grid, int* status);
+
+void oskar_imager_update_plane_idg(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight,
+        const oskar_Mem* time_centroid, const oskar_Mem* station1,
+        const oskar_Mem* station2, int i_plane, oskar_Mem* plane,
+        double* plane_norm, size_t* num_skipped, int* status)
+{
+    int i, k, num_times = 1, *iw = 0, *slot = 0;
+    size_t j, *offset = 0, *order = 0;
+    oskar_Mem *taper_d, *taper, *layer, *screen, *screen_taper;
+    oskar_Mem *s_uu, *s_vv, *s_ww, *s_amps, *s_wt, *s_st1 = 0, *s_st2 = 0;
+    if (*status) return;
+    oskar_Mem* plane_ptr = plane;
+    if (!plane_ptr)
+    {
+        if (h->planes)
+            plane_ptr = h->planes[i_plane];
+        else
+        {
+            *status = OSKAR_ERR_MEMORY_NOT_ALLOCATED;
+            return;
+        }
+    }
+    if (oskar_mem_location(plane_ptr) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (oskar_mem_precision(plane_ptr) != h->imager_prec)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Station beams need the time and stations of each visibility. */
+    if (h->telescope && (!time_centroid || !station1 || !station2 ||
+            oskar_mem_length(time_centroid) < num_vis ||
+            oskar_mem_length(station1) < num_vis ||
+            oskar_mem_length(station2) < num_vis))
+    {
+        oskar_log_error(h->log, "Station beams can only be applied if "
+                "the time and stations of each visibility are known.");
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        return;
+    }
+
+    /* Make sure there is space for the image. */
+    const int prec = h->imager_prec;
+    const int grid_size = oskar_imager_plane_size(h);
+    const size_t num_cells = ((size_t) grid_size) * ((size_t) grid_size);
+    if (oskar_mem_length(plane_ptr) < num_cells)
+    {
+        oskar_mem_realloc(plane_ptr, num_cells, status);
+        oskar_mem_clear_contents(plane_ptr, status);
+    }
+    if (*status || num_vis == 0) return;
+
+    /* Get the A-terms at each time, if needed. */
+    if (h->telescope)
+    {
+        const int num_stations = oskar_telescope_num_stations(h->telescope);
+        const double freq_hz = h->im_freqs ?
+                h->im_freqs[i_plane / h->num_im_pols] : h->vis_freq_start_hz;
+        const int* s1_ = oskar_mem_int_const(station1, status);
+        const int* s2_ = oskar_mem_int_const(station2, status);
+        for (j = 0; j < num_vis && !*status; ++j)
+        {
+            if (s1_[j] < 0 || s1_[j] >= num_stations ||
+                    s2_[j] < 0 || s2_[j] >= num_stations)
+            {
+                oskar_log_error(h->log, "The telescope model has %d "
+                        "stations, but the visibilities use station %d.",
+                        num_stations, (s1_[j] > s2_[j] ? s1_[j] : s2_[j]));
+                *status = OSKAR_ERR_OUT_OF_RANGE;
+            }
+        }
+        update_aterms(h, num_vis,
+                oskar_mem_double_const(time_centroid, status),
+                freq_hz, status);
+        if (*status) return;
+        num_times = (int) oskar_mem_length(h->aterm_times);
+    }
+
+    /* Find the W plane of each visibility, and the time of its A-terms,
+     * and sort the visibilities by W plane and time. */
+    const size_t num_keys = (size_t) h->num_w_planes * (size_t) num_times;
+    const size_t num_aterms_per_time = h->telescope ?
+            (size_t) oskar_telescope_num_stations(h->telescope) *
+            OSKAR_IDG_SUBGRID_SIZE * OSKAR_IDG_SUBGRID_SIZE : 0;
+    iw = (int*) malloc(num_vis * sizeof(int));
+    slot = (int*) calloc(num_vis, sizeof(int));
+    order = (size_t*) malloc(num_vis * sizeof(size_t));
+    offset = (size_t*) calloc(num_keys + 1, sizeof(size_t));
+    if (!iw || !slot || !order || !offset)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(iw);
+        free(slot);
+        free(order);
+        free(offset);
+        return;
+    }
+    if (prec == OSKAR_DOUBLE)
+        w_plane_d(num_vis, oskar_mem_double_const(ww, status),
+                h->w_scale, h->num_w_planes, iw);
+    else
+        w_plane_f(num_vis, oskar_mem_float_const(ww, status),
+                h->w_scale, h->num_w_planes, iw);
+    if (h->telescope)
+    {
+        const double* t_ = oskar_mem_double_const(time_centroid, status);
+        for (j = 0; j < num_vis; ++j)
+            slot[j] = (j > 0 && t_[j] == t_[j - 1]) ?
+                    slot[j - 1] : find_time(h, t_[j]);
+    }
+    for (j = 0; j < num_vis; ++j)
+        offset[(size_t) iw[j] * num_times + slot[j] + 1]++;
+    for (j = 0; j < num_keys; ++j) offset[j + 1] += offset[j];
+    for (j = 0; j < num_vis; ++j)
+        order[offset[(size_t) iw[j] * num_times + slot[j]]++] = j;
+    for (j = num_keys; j > 0; --j) offset[j] = offset[j - 1];
+    offset[0] = 0;
+    free(iw);
+    free(slot);
+    s_uu = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    s_vv = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    s_ww = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    s_amps = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU, 0, status);
+    s_wt = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    gather(uu, order, num_vis, s_uu, status);
+    gather(vv, order, num_vis, s_vv, status);
+    gather(ww, order, num_vis, s_ww, status);
+    gather(amps, order, num_vis, s_amps, status);
+    gather(weight, order, num_vis, s_wt, status);
+    if (h->telescope)
+    {
+        s_st1 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
+        s_st2 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
+        gather(station1, order, num_vis, s_st1, status);
+        gather(station2, order, num_vis, s_st2, status);
+    }
+    free(order);
+
+    /* Generate the taper, which is removed by the grid correction. */
+    taper_d = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            OSKAR_IDG_SUBGRID_SIZE, status);
+    double* t = oskar_mem_double(taper_d, status);
+    for (i = 0; i < OSKAR_IDG_SUBGRID_SIZE && !*status; ++i)
+    {
+        const double nu = (double) (i - OSKAR_IDG_SUBGRID_SIZE / 2) /
+                (double) (OSKAR_IDG_SUBGRID_SIZE / 2);
+        t[i] = oskar_grid_function_spheroidal(fabs(nu));
+    }
+    taper = oskar_mem_convert_precision(taper_d, prec, status);
+
+    /* Create the W plane grid and the phase screen. */
+    layer = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, status);
+    screen = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, status);
+    screen_taper = oskar_mem_create(prec, OSKAR_CPU, grid_size, status);
+    oskar_mem_set_value_real(screen_taper, 1.0, 0, grid_size, status);
+    if (!h->fft)
+        h->fft = oskar_fft_create(prec, OSKAR_CPU, 2, grid_size, 0, status);
+
+    /* Grid each non-empty W plane, one time at a time so the A-terms
+     * of that time can be used, then transform it and add it to the
+     * image. */
+    for (k = 0; k < h->num_w_planes && !*status; ++k)
+    {
+        const size_t* o = &offset[(size_t) k * num_times];
+        if (o[num_times] == o[0]) continue;
+        oskar_mem_clear_contents(layer, status);
+        for (i = 0; i < num_times; ++i)
+        {
+            if (o[i + 1] == o[i]) continue;
+            grid(h, taper, k, h->telescope ? h->aterms : 0,
+                    i * num_aterms_per_time,
+                    s_st1 ? oskar_mem_int_const(s_st1, status) : 0,
+                    s_st2 ? oskar_mem_int_const(s_st2, status) : 0,
+                    o[i], o[i + 1] - o[i], s_uu, s_vv, s_ww, s_amps, s_wt,
+                    plane_norm, num_skipped, layer, status);
+        }
+        oskar_fftphase(grid_size, grid_size, layer, status);
+        oskar_fft_exec(h->fft, layer, status);
+
+        /* Plane k is at w = k / w_scale. */
+        oskar_imager_generate_w_phase_screen(k, grid_size, grid_size,
+                h->cellsize_rad, (k > 0 ? k * h->w_scale : 1.0),
+                screen_taper, screen, status);
+        if (*status) break;
+        if (prec == OSKAR_DOUBLE)
+            accumulate_d(grid_size, oskar_mem_double_const(screen, status),
+                    oskar_mem_double_const(layer, status),
+                    oskar_mem_double(plane_ptr, status));
+        else
+            accumulate_f(grid_size, oskar_mem_float_const(screen, status),
+                    oskar_mem_float_const(layer, status),
+                    oskar_mem_float(plane_ptr, status));
+    }
+
+    /* Clean up. */
+    free(offset);
+    oskar_mem_free(s_uu, status);
+    oskar_mem_free(s_vv, status);
+    oskar_mem_free(s_ww, status);
+    oskar_mem_free(s_amps, status);
+    oskar_mem_free(s_wt, status);
+    oskar_mem_free(s_st1, status);
+    oskar_mem_free(s_st2, status);
+    oskar_mem_free(taper_d, status);
+    oskar_mem_free(taper, status);
+    oskar_mem_free(layer, status);
+    oskar_mem_free(screen, status);
+    oskar_mem_free(screen_taper, status);
+}
+
+
+/* Returns the index of the time in the A-term cache, or -1 if not found. */
+static int find_time(const oskar_Imager* h, double time_mjd_sec)
+{
+    int i, status = 0;
+    if (!h->aterm_times) return -1;
+    const int num_times = (int) oskar_mem_length(h->aterm_times);
+    const double* t = oskar_mem_double_const(h->aterm_times, &status);
+    for (i = 0; i < num_times; ++i)
+        if (t[i] == time_mjd_sec) return i;
+    return -1;
+}
+
+
+/* Evaluates the A-terms at each time centroid of the visibilities,
+ * unless they are all held already for this frequency.
+ * The polarisation planes of a channel share the same A-terms. */
+static void update_aterms(oskar_Imager* h, size_t num_vis,
+        const double* time_centroid, double freq_hz, int* status)
+{
+    int i, s, num_times = 0;
+    size_t j;
+    oskar_Mem *times, *beam = 0;
+    if (*status) return;
+
+    /* Check if the A-terms are already known. */
+    if (h->aterms && h->aterm_freq_hz == freq_hz)
+    {
+        for (j = 0; j < num_vis; ++j)
+        {
+            if (j > 0 && time_centroid[j] == time_centroid[j - 1]) continue;
+            if (find_time(h, time_centroid[j]) < 0) break;
+        }
+        if (j == num_vis) return;
+    }
+
+    /* Get the distinct times. */
+    times = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    for (j = 0; j < num_vis && !*status; ++j)
+    {
+        if (j > 0 && time_centroid[j] == time_centroid[j - 1]) continue;
+        const double* t = oskar_mem_double_const(times, status);
+        for (i = 0; i < num_times; ++i)
+            if (t[i] == time_centroid[j]) break;
+        if (i < num_times) continue;
+        oskar_mem_realloc(times, ++num_times, status);
+        if (!*status)
+            oskar_mem_double(times, status)[num_times - 1] = time_centroid[j];
+    }
+    oskar_mem_free(h->aterm_times, status);
+    h->aterm_times = times;
+    h->aterm_freq_hz = freq_hz;
+
+    /* Get the directions of the subgrid pixels, if not already done. */
+    const int prec = oskar_telescope_precision(h->telescope);
+    const int num_stations = oskar_telescope_num_stations(h->telescope);
+    const int num_pixels = OSKAR_IDG_SUBGRID_SIZE * OSKAR_IDG_SUBGRID_SIZE;
+    if (!h->aterm_dir[0])
+    {
+        oskar_Mem* dir[3];
+        for (i = 0; i < 3; ++i)
+            dir[i] = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                    num_pixels, status);
+        if (!*status)
+            oskar_grid_idg_subgrid_lmn_d(OSKAR_IDG_SUBGRID_SIZE,
+                    oskar_imager_plane_size(h), h->cellsize_rad,
+                    oskar_mem_double(dir[0], status),
+                    oskar_mem_double(dir[1], status),
+                    oskar_mem_double(dir[2], status));
+        for (i = 0; i < 3; ++i)
+        {
+            h->aterm_dir[i] = oskar_mem_convert_precision(dir[i], prec,
+                    status);
+            oskar_mem_free(dir[i], status);
+        }
+    }
+    const size_t num_per_time = (size_t) num_stations * num_pixels;
+    if (!h->aterms)
+        h->aterms = oskar_mem_create(h->imager_prec | OSKAR_COMPLEX,
+                OSKAR_CPU, 0, status);
+    oskar_mem_ensure(h->aterms, num_times * num_per_time, status);
+    if (prec != h->imager_prec)
+        beam = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+                num_per_time, status);
+
+    /* Point the station beams at the image centre. */
+    oskar_telescope_set_phase_centre(h->telescope, OSKAR_COORDS_RADEC,
+            h->im_centre_deg[0] * DEG2RAD, h->im_centre_deg[1] * DEG2RAD);
+    const double lon_rad = oskar_telescope_phase_centre_longitude_rad(
+            h->telescope);
+    const double lat_rad = oskar_telescope_phase_centre_latitude_rad(
+            h->telescope);
+
+    /* Evaluate the beam of each station at each time.
+     * The time index is needed for time-variable element errors. */
+    for (i = 0; i < num_times && !*status; ++i)
+    {
+        int time_index = 0;
+        const double t = oskar_mem_double_const(times, status)[i];
+        const double gast_rad = oskar_convert_mjd_to_gast_fast(t / 86400.0);
+        if (h->vis_time_inc_sec > 0.0)
+        {
+            time_index = (int) floor((t -
+                    h->vis_time_start_mjd_utc * 86400.0) /
+                    h->vis_time_inc_sec);
+            if (time_index < 0) time_index = 0;
+        }
+        for (s = 0; s < num_stations; ++s)
+            oskar_station_beam(
+                    oskar_telescope_station_const(h->telescope, s),
+                    h->station_work, OSKAR_COORDS_REL_DIR, num_pixels,
+                    (const oskar_Mem* const*) h->aterm_dir, lon_rad, lat_rad,
+                    oskar_telescope_phase_centre_coord_type(h->telescope),
+                    lon_rad, lat_rad, time_index, gast_rad, freq_hz,
+                    (beam ? 0 : i * num_per_time) + s * num_pixels,
+                    (beam ? beam : h->aterms), status);
+        if (beam)
+        {
+            oskar_Mem* temp = oskar_mem_convert_precision(beam,
+                    h->imager_prec, status);
+            oskar_mem_copy_contents(h->aterms, temp, i * num_per_time, 0,
+                    num_per_time, status);
+            oskar_mem_free(temp, status);
+        }
+    }
+    oskar_mem_free(beam, status);
+}
+
+
+/* Copies the elements of an array in the given order. */
+static void gather(const oskar_Mem* in, const size_t* order, size_t num,
+        oskar_Mem* out, int* status)
+{
+    size_t i;
+    if (*status) return;
+    const size_t element_size = oskar_mem_element_size(oskar_mem_type(in));
+    oskar_mem_ensure(out, num, status);
+    if (*status) return;
+    const char* src = (const char*) oskar_mem_void_const(in);
+    char* dst = oskar_mem_char(out);
+    for (i = 0; i < num; ++i)
+        memcpy(dst + i * element_size, src + order[i] * element_size,
+                element_size);
+}
+
+
+static void grid(oskar_Imager* h, const oskar_Mem* taper, int w_plane,
+        const oskar_Mem* aterms, size_t aterm_offset,
+        const int* station1, const int* station2,
+        size_t offset, size_t num_vis, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, double* plane_norm, size_t* num_skipped,
+        oskar_Mem* grid, int* status)
+{
+    size_t num_skipped_run = 0;
+    const int num_stations = aterms ?
+            oskar_telescope_num_stations(h->telescope) : 0;
+    if (*status) return;
+    if (station1) station1 += offset;
+    if (station2) station2 += offset;
+    if (h->imager_prec == OSKAR_DOUBLE)
+        oskar_grid_idg_d(OSKAR_IDG_SUBGRID_SIZE, h->support,
+                oskar_mem_double_const(taper, status),
+                h->num_w_planes, h->w_scale, w_plane, num_stations,
+                aterms ? oskar_mem_double_const(aterms, status) +
+                        2 * aterm_offset : 0,
+                station1, station2, num_vis,
+                oskar_mem_double_const(uu, status) + offset,
+                oskar_mem_double_const(vv, status) + offset,
+                oskar_mem_double_const(ww, status) + offset,
+                oskar_mem_double_const(amps, status) + 2 * offset,
+                oskar_mem_double_const(weight, status) + offset,
+                h->cellsize_rad, oskar_imager_plane_size(h),
+                &num_skipped_run, plane_norm,
+                oskar_mem_double(grid, status), status);
+    else
+        oskar_grid_idg_f(OSKAR_IDG_SUBGRID_SIZE, h->support,
+                oskar_mem_float_const(taper, status),
+                h->num_w_planes, h->w_scale, w_plane, num_stations,
+                aterms ? oskar_mem_float_const(aterms, status) +
+                        2 * aterm_offset : 0,
+                station1, station2, num_vis,
+                oskar_mem_float_const(uu, status) + offset,
+                oskar_mem_float_const(vv, status) + offset,
+                oskar_mem_float_const(ww, status) + offset,
+                oskar_mem_float_const(amps, status) + 2 * offset,
+                oskar_mem_float_const(weight, status) + offset,
+                (float) (h->cellsize_rad), oskar_imager_plane_size(h),
+                &num_skipped_run, plane_norm,
+                oskar_mem_float(grid, status), status);
+    *num_skipped += num_skipped_run;
+}
+
+#ifdef __cplusplus
+}
+#endif
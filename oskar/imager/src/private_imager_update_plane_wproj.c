@@ -31,7 +31,7 @@
 
 #include "imager/define_grid_tile_grid.h"
 #include "imager/private_imager_update_plane_wproj.h"
-#include "imager/oskar_grid_wproj2.h"
+#include "imager/oskar_grid_wproj2_tiled.h"
 #include "math/oskar_prefix_sum.h"
 #include "math/oskar_round_robin.h"
 #include "utility/oskar_device.h"
@@ -90,7 +90,7 @@ void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
         oskar_mem_ensure(plane_ptr, num_cells, status);
         if (*status) return;
         if (h->imager_prec == OSKAR_DOUBLE)
-            oskar_grid_wproj2_d(h->num_w_planes,
+            oskar_grid_wproj2_tiled_d(h->num_w_planes,
                     oskar_mem_int_const(h->w_support, status),
                     h->oversample,
                     oskar_mem_int_const(h->w_kernel_start, status),
@@ -104,7 +104,7 @@ void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
                     grid_size, num_skipped, plane_norm,
                     oskar_mem_double(plane_ptr, status));
         else
-            oskar_grid_wproj2_f(h->num_w_planes,
+            oskar_grid_wproj2_tiled_f(h->num_w_planes,
                     oskar_mem_int_const(h->w_support, status),
                     h->oversample,
                     oskar_mem_int_const(h->w_kernel_start, status),
@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_generate_w_phase_screen.h"
+#include "imager/private_imager_update_plane_wstack.h"
+#include "imager/oskar_grid_simple.h"
+#include "math/oskar_fft.h"
+#include "math/oskar_fftphase.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Visibilities are not gridded as they arrive, but are stored after the
+ * image in the plane, as records of (u, v, w, re, im, weight), using three
+ * complex elements each. Visibilities with negative w are stored as their
+ * complex conjugate at (-u, -v, -w), so only planes with w >= 0 are needed,
+ * and visibilities that would not fit on the grid are not stored at all.
+ *
+ * The stored visibilities are gridded when they use more memory than
+ * MAX_STORED_GRIDS grids, or when the plane is finalised.
+ * W planes are then gridded in batches of at most MAX_BATCH, and each one
+ * is transformed, multiplied by the conjugate of its W-term phase screen
+ * and added to the image, so the number of W planes does not affect the
+ * memory needed.
+ */
+#define RECORD_LEN 3
+#define MAX_STORED_GRIDS 8
+#define MAX_BATCH 4
+
+/* Returns the sum of the convolution function over the kernel support. */
+#define OSKAR_KERNEL_SUM(NAME, FP) \
+static double NAME(const int support, const int oversample, \
+        const FP* conv_func, const int offset) \
+{ \
+    int j; \
+    double sum = 0.0; \
+    for (j = -support; j <= support; ++j) \
+        sum += conv_func[abs(offset + j * oversample)]; \
+    return sum; \
+}
+
+OSKAR_KERNEL_SUM(kernel_sum_d, double)
+OSKAR_KERNEL_SUM(kernel_sum_f, float)
+
+/*
+ * Stores visibilities that fall on the grid, and updates the normalisation.
+ * This uses the same positions and kernel offsets as oskar_grid_simple(),
+ * so the normalisation is the same as if they were gridded now.
+ */
+#define OSKAR_WSTACK_STORE(NAME, FP, ROUND, KERNEL_SUM) \
+static size_t NAME(const int support, const int oversample, \
+        const FP* conv_func, const size_t num_vis, const FP* uu, \
+        const FP* vv, const FP* ww, const FP* vis, const FP* weight, \
+        const FP cell_size_rad, const int grid_size, double* norm, \
+        FP* records) \
+{ \
+    size_t i, num_stored = 0; \
+    const int grid_centre = grid_size / 2; \
+    const FP grid_scale = grid_size * cell_size_rad; \
+    for (i = 0; i < num_vis; ++i) \
+    { \
+        const FP sign = (ww[i] < (FP)0) ? (FP)-1 : (FP)1; \
+        const FP u = sign * uu[i], v = sign * vv[i]; \
+        const FP pos_u = -u * grid_scale; \
+        const FP pos_v = v * grid_scale; \
+        const int grid_u = (int)ROUND(pos_u) + grid_centre; \
+        const int grid_v = (int)ROUND(pos_v) + grid_centre; \
+        if (grid_u + support >= grid_size || grid_u - support < 0 || \
+                grid_v + support >= grid_size || grid_v - support < 0) \
+            continue; \
+        const int off_u = (int)ROUND((ROUND(pos_u) - pos_u) * oversample); \
+        const int off_v = (int)ROUND((ROUND(pos_v) - pos_v) * oversample); \
+        *norm += weight[i] * \
+                KERNEL_SUM(support, oversample, conv_func, off_u) * \
+                KERNEL_SUM(support, oversample, conv_func, off_v); \
+        FP* r = &records[2 * RECORD_LEN * num_stored++]; \
+        r[0] = u; \
+        r[1] = v; \
+        r[2] = sign * ww[i]; \
+        r[3] = vis[2 * i]; \
+        r[4] = sign * vis[2 * i + 1]; \
+        r[5] = weight[i]; \
+    } \
+    return num_stored; \
+}
+
+OSKAR_WSTACK_STORE(store_d, double, round, kernel_sum_d)
+OSKAR_WSTACK_STORE(store_f, float, roundf, kernel_sum_f)
+
+/* Sorts the stored visibilities by W plane. */
+#define OSKAR_WSTACK_SORT(NAME, FP) \
+static void NAME(const int num_w_planes, const double w_scale, \
+        const size_t num_records, const FP* records, size_t* offset, \
+        int* iw, FP* s_uu, FP* s_vv, FP* s_vis, FP* s_wt) \
+{ \
+    int k; \
+    size_t i; \
+    for (i = 0; i < num_records; ++i) \
+    { \
+        int t = (int) round(records[2 * RECORD_LEN * i + 2] * w_scale); \
+        if (t >= num_w_planes) t = num_w_planes - 1; \
+        iw[i] = t; \
+        offset[t + 1]++; \
+    } \
+    for (k = 0; k < num_w_planes; ++k) offset[k + 1] += offset[k]; \
+    for (i = 0; i < num_records; ++i) \
+    { \
+        const FP* r = &records[2 * RECORD_LEN * i]; \
+        const size_t j = offset[iw[i]]++; \
+        s_uu[j] = r[0]; \
+        s_vv[j] = r[1]; \
+        s_vis[2 * j] = r[3]; \
+        s_vis[2 * j + 1] = r[4]; \
+        s_wt[j] = r[5]; \
+    } \
+    for (k = num_w_planes; k > 0; --k) offset[k] = offset[k - 1]; \
+    offset[0] = 0; \
+}
+
+OSKAR_WSTACK_SORT(sort_d, double)
+OSKAR_WSTACK_SORT(sort_f, float)
+
+/* Grids a batch of W planes in parallel, each onto its own grid. */
+#define OSKAR_WSTACK_GRID(NAME, FP, GRID_SIMPLE) \
+static void NAME(const int num_batch, const int* batch, \
+        const size_t* offset, const int support, const int oversample, \
+        const FP* conv_func, const FP* s_uu, const FP* s_vv, \
+        const FP* s_vis, const FP* s_wt, const FP cell_size_rad, \
+        const int grid_size, FP** grids) \
+{ \
+    int b; \
+    _Pragma("omp parallel for schedule(dynamic, 1)") \
+    for (b = 0; b < num_batch; ++b) \
+    { \
+        size_t num_skipped = 0; \
+        double norm = 0.0; \
+        const size_t start = offset[batch[b]]; \
+        const size_t count = offset[batch[b] + 1] - start; \
+        GRID_SIMPLE(support, oversample, conv_func, count, \
+                &s_uu[start], &s_vv[start], &s_vis[2 * start], \
+                &s_wt[start], cell_size_rad, grid_size, \
+                &num_skipped, &norm, grids[b]); \
+    } \
+}
+
+OSKAR_WSTACK_GRID(grid_batch_d, double, oskar_grid_simple_d)
+OSKAR_WSTACK_GRID(grid_batch_f, float, oskar_grid_simple_f)
+
+/* Multiplies a transformed W plane by the complex conjugate of its
+ * phase screen, and adds it to the image.
+ * The screen is centred on element 0, and the image on size / 2. */
+#define OSKAR_WSTACK_ACCUMULATE(NAME, FP) \
+static void NAME(const int size, const FP* screen, const FP* layer, \
+        FP* image) \
+{ \
+    int y; \
+    const int half = size / 2; \
+    _Pragma("omp parallel for private(y)") \
+    for (y = 0; y < size; ++y) \
+    { \
+        int x; \
+        const FP* s = &screen[2 * (size_t) size * ((y + half) % size)]; \
+        const FP* a = &layer[2 * (size_t) size * y]; \
+        FP* b = &image[2 * (size_t) size * y]; \
+        for (x = 0; x < size; ++x) \
+        { \
+            const int j = 2 * ((x + half) % size); \
+            b[2 * x] += a[2 * x] * s[j] + a[2 * x + 1] * s[j + 1]; \
+            b[2 * x + 1] += a[2 * x + 1] * s[j] - a[2 * x] * s[j + 1]; \
+        } \
+    } \
+}
+
+OSKAR_WSTACK_ACCUMULATE(accumulate_d, double)
+OSKAR_WSTACK_ACCUMULATE(accumulate_f, float)
+
+
+static void grid_stored_visibilities(oskar_Imager* h, oskar_Mem* plane,
+        int* status)
+{
+    int i, k, num_batch = 0, batch[MAX_BATCH];
+    size_t *offset = 0;
+    int *iw = 0;
+    oskar_Mem *s_uu, *s_vv, *s_vis, *s_wt, *screen, *taper;
+    oskar_Mem *grids[MAX_BATCH];
+    if (*status) return;
+    const int prec = h->imager_prec;
+    const int size = oskar_imager_plane_size(h);
+    const size_t num_cells = (size_t) size * (size_t) size;
+    const size_t num_records =
+            (oskar_mem_length(plane) - num_cells) / RECORD_LEN;
+    if (num_records == 0)
+    {
+        oskar_mem_realloc(plane, num_cells, status);
+        return;
+    }
+
+    /* Sort the stored visibilities by W plane. */
+    offset = (size_t*) calloc(h->num_w_planes + 1, sizeof(size_t));
+    iw = (int*) malloc(num_records * sizeof(int));
+    s_uu = oskar_mem_create(prec, OSKAR_CPU, num_records, status);
+    s_vv = oskar_mem_create(prec, OSKAR_CPU, num_records, status);
+    s_vis = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_records, status);
+    s_wt = oskar_mem_create(prec, OSKAR_CPU, num_records, status);
+    if (!offset || !iw) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    if (!*status)
+    {
+        if (prec == OSKAR_DOUBLE)
+            sort_d(h->num_w_planes, h->w_scale, num_records,
+                    oskar_mem_double_const(plane, status) + 2 * num_cells,
+                    offset, iw,
+                    oskar_mem_double(s_uu, status),
+                    oskar_mem_double(s_vv, status),
+                    oskar_mem_double(s_vis, status),
+                    oskar_mem_double(s_wt, status));
+        else
+            sort_f(h->num_w_planes, h->w_scale, num_records,
+                    oskar_mem_float_const(plane, status) + 2 * num_cells,
+                    offset, iw,
+                    oskar_mem_float(s_uu, status),
+                    oskar_mem_float(s_vv, status),
+                    oskar_mem_float(s_vis, status),
+                    oskar_mem_float(s_wt, status));
+    }
+    free(iw);
+
+    /* The records are no longer needed. */
+    oskar_mem_realloc(plane, num_cells, status);
+
+    /* Create the grids for each batch, and the phase screen. */
+    for (i = 0; i < MAX_BATCH; ++i)
+        grids[i] = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+                num_cells, status);
+    screen = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, status);
+    taper = oskar_mem_create(prec, OSKAR_CPU, size, status);
+    oskar_mem_set_value_real(taper, 1.0, 0, size, status);
+    if (!h->fft)
+        h->fft = oskar_fft_create(prec, OSKAR_CPU, 2, size, 0, status);
+
+    /* Grid, transform and accumulate each batch of non-empty W planes. */
+    for (k = 0; k < h->num_w_planes && !*status; ++k)
+    {
+        if (offset[k + 1] > offset[k]) batch[num_batch++] = k;
+        if (num_batch < MAX_BATCH && k < h->num_w_planes - 1) continue;
+        for (i = 0; i < num_batch; ++i)
+            oskar_mem_clear_contents(grids[i], status);
+        if (*status) break;
+        if (prec == OSKAR_DOUBLE)
+        {
+            double* g[MAX_BATCH];
+            for (i = 0; i < num_batch; ++i)
+                g[i] = oskar_mem_double(grids[i], status);
+            grid_batch_d(num_batch, batch, offset, h->support, h->oversample,
+                    oskar_mem_double_const(h->conv_func, status),
+                    oskar_mem_double_const(s_uu, status),
+                    oskar_mem_double_const(s_vv, status),
+                    oskar_mem_double_const(s_vis, status),
+                    oskar_mem_double_const(s_wt, status),
+                    h->cellsize_rad, size, g);
+        }
+        else
+        {
+            float* g[MAX_BATCH];
+            for (i = 0; i < num_batch; ++i)
+                g[i] = oskar_mem_float(grids[i], status);
+            grid_batch_f(num_batch, batch, offset, h->support, h->oversample,
+                    oskar_mem_float_const(h->conv_func, status),
+                    oskar_mem_float_const(s_uu, status),
+                    oskar_mem_float_const(s_vv, status),
+                    oskar_mem_float_const(s_vis, status),
+                    oskar_mem_float_const(s_wt, status),
+                    (float) (h->cellsize_rad), size, g);
+        }
+        for (i = 0; i < num_batch; ++i)
+        {
+            /* Plane k is at w = k / w_scale. */
+            const int iw_k = batch[i];
+            oskar_fftphase(size, size, grids[i], status);
+            oskar_fft_exec(h->fft, grids[i], status);
+            oskar_imager_generate_w_phase_screen(iw_k, size, size,
+                    h->cellsize_rad, (iw_k > 0 ? iw_k * h->w_scale : 1.0),
+                    taper, screen, status);
+            if (*status) break;
+            if (prec == OSKAR_DOUBLE)
+                accumulate_d(size, oskar_mem_double_const(screen, status),
+                        oskar_mem_double_const(grids[i], status),
+                        oskar_mem_double(plane, status));
+            else
+                accumulate_f(size, oskar_mem_float_const(screen, status),
+                        oskar_mem_float_const(grids[i], status),
+                        oskar_mem_float(plane, status));
+        }
+        num_batch = 0;
+    }
+
+    /* Clean up. */
+    free(offset);
+    for (i = 0; i < MAX_BATCH; ++i)
+        oskar_mem_free(grids[i], status);
+    oskar_mem_free(s_uu, status);
+    oskar_mem_free(s_vv, status);
+    oskar_mem_free(s_vis, status);
+    oskar_mem_free(s_wt, status);
+    oskar_mem_free(screen, status);
+    oskar_mem_free(taper, status);
+}
+
+
+void oskar_imager_update_plane_wstack(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight, int i_plane,
+        oskar_Mem* plane, double* plane_norm, size_t* num_skipped, int* status)
+{
+    size_t num_stored = 0;
+    if (*status) return;
+    oskar_Mem* plane_ptr = plane;
+    if (!plane_ptr)
+    {
+        if (h->planes)
+            plane_ptr = h->planes[i_plane];
+        else
+        {
+            *status = OSKAR_ERR_MEMORY_NOT_ALLOCATED;
+            return;
+        }
+    }
+    if (oskar_mem_location(plane_ptr) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (oskar_mem_precision(plane_ptr) != h->imager_prec)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Make sure there is space for the image and the new visibilities. */
+    const int grid_size = oskar_imager_plane_size(h);
+    const size_t num_cells = ((size_t) grid_size) * ((size_t) grid_size);
+    if (oskar_mem_length(plane_ptr) < num_cells)
+    {
+        oskar_mem_realloc(plane_ptr, num_cells, status);
+        oskar_mem_clear_contents(plane_ptr, status);
+    }
+    const size_t old_len = oskar_mem_length(plane_ptr);
+    oskar_mem_realloc(plane_ptr, old_len + RECORD_LEN * num_vis, status);
+    if (*status) return;
+
+    /* Store the visibilities. */
+    if (h->imager_prec == OSKAR_DOUBLE)
+        num_stored = store_d(h->support, h->oversample,
+                oskar_mem_double_const(h->conv_func, status), num_vis,
+                oskar_mem_double_const(uu, status),
+                oskar_mem_double_const(vv, status),
+                oskar_mem_double_const(ww, status),
+                oskar_mem_double_const(amps, status),
+                oskar_mem_double_const(weight, status),
+                h->cellsize_rad, grid_size, plane_norm,
+                oskar_mem_double(plane_ptr, status) + 2 * old_len);
+    else
+        num_stored = store_f(h->support, h->oversample,
+                oskar_mem_float_const(h->conv_func, status), num_vis,
+                oskar_mem_float_const(uu, status),
+                oskar_mem_float_const(vv, status),
+                oskar_mem_float_const(ww, status),
+                oskar_mem_float_const(amps, status),
+                oskar_mem_float_const(weight, status),
+                (float) (h->cellsize_rad), grid_size, plane_norm,
+                oskar_mem_float(plane_ptr, status) + 2 * old_len);
+    *num_skipped += (num_vis - num_stored);
+    oskar_mem_realloc(plane_ptr, old_len + RECORD_LEN * num_stored, status);
+
+    /* Grid the stored visibilities if they are using too much memory. */
+    if (oskar_mem_length(plane_ptr) > (MAX_STORED_GRIDS + 1) * num_cells)
+        grid_stored_visibilities(h, plane_ptr, status);
+}
+
+
+void oskar_imager_finalise_plane_wstack(oskar_Imager* h, oskar_Mem* plane,
+        int* status)
+{
+    if (*status) return;
+    const int size = oskar_imager_plane_size(h);
+    const size_t num_cells = (size_t) size * (size_t) size;
+    const size_t len = oskar_mem_length(plane);
+    if (len < num_cells || (len - num_cells) % RECORD_LEN != 0)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    grid_stored_visibilities(h, plane, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
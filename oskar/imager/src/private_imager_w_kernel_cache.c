@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_w_kernel_cache.h"
+#include "binary/oskar_crc.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef OSKAR_OS_WIN
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHE_VERSION 3
+#define CACHE_BYTE_ORDER 0x01020304
+
+/*
+ * The cache file contains the key, the number of kernel elements and the
+ * CRC-32C checksum of everything else, followed by the support size and
+ * start index of each kernel as int32_t values, and then the compacted
+ * kernels. The header uses fixed-width types, with explicit padding, so
+ * the layout does not depend on the platform. Values are stored in the
+ * native byte order, which is recorded in the key, so a file written
+ * on a machine with the other byte order does not match.
+ */
+struct WKernelCacheKey
+{
+    char magic[8];
+    int32_t version, byte_order, precision, image_size, num_w_planes;
+    int32_t oversample, kernel_type, reserved;
+    double image_padding, cellsize_rad, w_scale;
+};
+typedef struct WKernelCacheKey WKernelCacheKey;
+
+struct WKernelCacheHeader
+{
+    WKernelCacheKey key;
+    uint64_t num_elements;
+    uint32_t checksum, reserved;
+};
+typedef struct WKernelCacheHeader WKernelCacheHeader;
+
+static void cache_key(const oskar_Imager* h, WKernelCacheKey* key)
+{
+    /* Clear any padding, so the key can be compared and hashed as bytes. */
+    memset(key, 0, sizeof(WKernelCacheKey));
+    memcpy(key->magic, "OSKARWK", 7);
+    key->version = CACHE_VERSION;
+    key->byte_order = CACHE_BYTE_ORDER;
+    key->precision = h->imager_prec;
+    key->image_size = h->image_size;
+    key->num_w_planes = h->num_w_planes;
+    key->oversample = h->oversample;
+    key->kernel_type = (int32_t) h->kernel_type;
+    key->image_padding = h->image_padding;
+    key->cellsize_rad = h->cellsize_rad;
+    key->w_scale = h->w_scale;
+}
+
+static char* cache_file_name(const oskar_Imager* h, const WKernelCacheKey* key)
+{
+    char* name;
+    oskar_CRC* crc = oskar_crc_create(OSKAR_CRC_32C);
+    const uint32_t hash = (uint32_t) oskar_crc_compute(crc, key,
+            sizeof(*key));
+    const size_t len = strlen(h->w_kernel_cache_dir) + 40;
+    oskar_crc_free(crc);
+    name = (char*) calloc(len, 1);
+    if (name)
+        snprintf(name, len, "%s/oskar_w_kernels_%08lx.bin",
+                h->w_kernel_cache_dir, (unsigned long) hash);
+    return name;
+}
+
+static unsigned long crc_update_int32(oskar_CRC* crc, unsigned long c,
+        const oskar_Mem* mem)
+{
+    size_t i;
+    const int* data = (const int*) oskar_mem_void_const(mem);
+    const size_t num = oskar_mem_length(mem);
+    for (i = 0; i < num; ++i)
+    {
+        const int32_t value = (int32_t) data[i];
+        c = oskar_crc_update(crc, c, &value, sizeof(value));
+    }
+    return c;
+}
+
+static uint32_t checksum(const WKernelCacheHeader* hdr,
+        const oskar_Mem* support, const oskar_Mem* start,
+        const oskar_Mem* kernels)
+{
+    unsigned long c;
+    oskar_CRC* crc = oskar_crc_create(OSKAR_CRC_32C);
+    c = oskar_crc_update(crc, 0, &hdr->key, sizeof(hdr->key));
+    c = oskar_crc_update(crc, c, &hdr->num_elements,
+            sizeof(hdr->num_elements));
+    c = crc_update_int32(crc, c, support);
+    c = crc_update_int32(crc, c, start);
+    c = oskar_crc_update(crc, c, oskar_mem_void_const(kernels),
+            oskar_mem_length(kernels) *
+            oskar_mem_element_size(oskar_mem_type(kernels)));
+    oskar_crc_free(crc);
+    return (uint32_t) c;
+}
+
+/* Reads an array of int32_t values into an integer array. */
+static int read_int32(FILE* file, oskar_Mem* mem)
+{
+    size_t i;
+    int* data = (int*) oskar_mem_void(mem);
+    const size_t num = oskar_mem_length(mem);
+    for (i = 0; i < num; ++i)
+    {
+        int32_t value = 0;
+        if (fread(&value, sizeof(value), 1, file) != 1) return 0;
+        data[i] = (int) value;
+    }
+    return 1;
+}
+
+/* Writes an integer array as int32_t values. */
+static int write_int32(FILE* file, const oskar_Mem* mem)
+{
+    size_t i;
+    const int* data = (const int*) oskar_mem_void_const(mem);
+    const size_t num = oskar_mem_length(mem);
+    for (i = 0; i < num; ++i)
+    {
+        const int32_t value = (int32_t) data[i];
+        if (fwrite(&value, sizeof(value), 1, file) != 1) return 0;
+    }
+    return 1;
+}
+
+/* Returns the size of the file in bytes, or -1 on error. */
+static long file_size(FILE* file)
+{
+    long size;
+    const long current = ftell(file);
+    if (current < 0 || fseek(file, 0, SEEK_END)) return -1;
+    size = ftell(file);
+    if (fseek(file, current, SEEK_SET)) return -1;
+    return size;
+}
+
+
+int oskar_imager_w_kernel_cache_read(oskar_Imager* h, int* status)
+{
+    FILE* file;
+    char* filename;
+    int loaded = 0;
+    WKernelCacheHeader hdr;
+    WKernelCacheKey key;
+    oskar_Mem *support = 0, *start = 0, *kernels = 0;
+    if (*status || !h->w_kernel_cache_dir) return 0;
+    cache_key(h, &key);
+    filename = cache_file_name(h, &key);
+    if (!filename) return 0;
+    file = fopen(filename, "rb");
+    if (!file)
+    {
+        free(filename);
+        return 0;
+    }
+
+    /* Read the header, and check it matches the current parameters.
+     * The number of elements is checked against the size of the file
+     * before anything is allocated, so a corrupt count is ignored.
+     * Buffers are allocated with a local status, so that a failure here
+     * only means the kernels are regenerated. */
+    memset(&hdr, 0, sizeof(hdr));
+    if (fread(&hdr, sizeof(hdr), 1, file) == 1 &&
+            !memcmp(&hdr.key, &key, sizeof(key)) && hdr.num_elements > 0)
+    {
+        int read_status = 0;
+        const int type = h->imager_prec | OSKAR_COMPLEX;
+        const size_t num_planes = (size_t) h->num_w_planes;
+        const size_t element_size = oskar_mem_element_size(type);
+        const long size = file_size(file);
+        const uint64_t prefix = (uint64_t) sizeof(hdr) +
+                2 * (uint64_t) num_planes * sizeof(int32_t);
+        if (size > 0 && (uint64_t) size > prefix &&
+                ((uint64_t) size - prefix) % element_size == 0 &&
+                ((uint64_t) size - prefix) / element_size == hdr.num_elements)
+        {
+            const size_t num_elements = (size_t) hdr.num_elements;
+            support = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_planes,
+                    &read_status);
+            start = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_planes,
+                    &read_status);
+            kernels = oskar_mem_create(type, OSKAR_CPU, num_elements,
+                    &read_status);
+            if (!read_status &&
+                    read_int32(file, support) && read_int32(file, start) &&
+                    fread(oskar_mem_void(kernels), element_size,
+                            num_elements, file) == num_elements &&
+                    checksum(&hdr, support, start, kernels) == hdr.checksum)
+                loaded = 1;
+        }
+    }
+    fclose(file);
+
+    /* Use the kernels if they are valid. */
+    if (loaded)
+    {
+        oskar_mem_free(h->w_support, status);
+        oskar_mem_free(h->w_kernel_start, status);
+        oskar_mem_free(h->w_kernels_compact, status);
+        h->w_support = support;
+        h->w_kernel_start = start;
+        h->w_kernels_compact = kernels;
+        oskar_log_message(h->log, 'M', 0,
+                "Loaded W-projection kernels from '%s'.", filename);
+    }
+    else
+    {
+        oskar_log_warning(h->log,
+                "Ignoring invalid W-projection kernel cache file '%s'.",
+                filename);
+        int free_status = 0;
+        oskar_mem_free(support, &free_status);
+        oskar_mem_free(start, &free_status);
+        oskar_mem_free(kernels, &free_status);
+    }
+    free(filename);
+    return loaded;
+}
+
+
+void oskar_imager_w_kernel_cache_write(oskar_Imager* h, int* status)
+{
+    FILE* file;
+    char *filename, *temp_name;
+    int ok = 0;
+    WKernelCacheHeader hdr;
+    if (*status || !h->w_kernel_cache_dir || !h->w_kernels_compact) return;
+    memset(&hdr, 0, sizeof(hdr));
+    cache_key(h, &hdr.key);
+    hdr.num_elements = (uint64_t) oskar_mem_length(h->w_kernels_compact);
+    hdr.checksum = checksum(&hdr, h->w_support, h->w_kernel_start,
+            h->w_kernels_compact);
+    filename = cache_file_name(h, &hdr.key);
+    if (!filename) return;
+
+    /* Write to a temporary file first, so a partial file is never used.
+     * The name is unique to this process and imager, so concurrent writers
+     * do not share it, and the file is then renamed over any existing one
+     * in a single step. */
+    const size_t len = strlen(filename) + 48;
+    temp_name = (char*) calloc(len, 1);
+    if (temp_name)
+    {
+#ifdef OSKAR_OS_WIN
+        const unsigned long pid = (unsigned long) GetCurrentProcessId();
+#else
+        const unsigned long pid = (unsigned long) getpid();
+#endif
+        snprintf(temp_name, len, "%s.%lu.%llx.tmp", filename, pid,
+                (unsigned long long) (size_t) h);
+        file = fopen(temp_name, "wb");
+        if (file)
+        {
+            const size_t num_elements = oskar_mem_length(h->w_kernels_compact);
+            ok = fwrite(&hdr, sizeof(hdr), 1, file) == 1 &&
+                    write_int32(file, h->w_support) &&
+                    write_int32(file, h->w_kernel_start) &&
+                    fwrite(oskar_mem_void_const(h->w_kernels_compact),
+                            oskar_mem_element_size(oskar_mem_type(
+                                    h->w_kernels_compact)),
+                            num_elements, file) == num_elements;
+            if (fclose(file)) ok = 0;
+#ifdef OSKAR_OS_WIN
+            if (ok && !MoveFileExA(temp_name, filename,
+                    MOVEFILE_REPLACE_EXISTING))
+                ok = 0;
+#else
+            if (ok && rename(temp_name, filename)) ok = 0;
+#endif
+            if (!ok) remove(temp_name);
+        }
+    }
+    if (ok)
+        oskar_log_message(h->log, 'M', 0,
+                "Saved W-projection kernels to '%s'.", filename);
+    else
+        oskar_log_warning(h->log,
+                "Unable to write W-projection kernel cache file '%s'.",
+                filename);
+    free(temp_name);
+    free(filename);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,670 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "convert/oskar_convert_mjd_to_gast_fast.h"
+#include "imager/oskar_grid_functions_spheroidal.h"
+#include "imager/oskar_grid_idg.h"
+#include "imager/oskar_imager.h"
+#include "imager/private_imager.h"
+#include "imager/oskar_grid_correction.h"
+#include "math/oskar_cmath.h"
+#include "math/oskar_evaluate_image_lmn_grid.h"
+#include "math/oskar_fft.h"
+#include "math/oskar_fftphase.h"
+#include "telescope/oskar_telescope.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cstdlib>
+
+static const int size = 128, num_vis = 2000, num_stations = 8;
+static const int subgrid_size = 32;
+static const double fov_deg = 10.0, uv_max = 150.0, ww_max = 500.0;
+
+// Real part of the A-term, common to all stations.
+static double aterm(double l, double m)
+{
+    return 1.0 + 3.0 * l - 2.0 * m;
+}
+
+static oskar_Imager* create_imager(const char* algorithm, int* status)
+{
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_algorithm(im, algorithm, status);
+    oskar_imager_set_fov(im, fov_deg);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_num_w_planes(im, 64);
+    im->ww_min = 0.0;
+    im->ww_max = ww_max;
+    im->ww_rms = 0.5 * ww_max;
+    oskar_imager_check_init(im, status);
+    return im;
+}
+
+static oskar_Mem* make_image(const char* algorithm, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* vis,
+        const oskar_Mem* weight, int* status, size_t num = num_vis)
+{
+    double norm = 0.0;
+    oskar_Imager* im = create_imager(algorithm, status);
+    oskar_Mem* plane = oskar_mem_create(oskar_imager_plane_type(im),
+            OSKAR_CPU, 0, status);
+    oskar_imager_update_plane(im, num, uu, vv, ww, vis, weight, 0,
+            plane, &norm, 0, status);
+    oskar_imager_finalise_plane(im, plane, norm, status);
+    oskar_imager_trim_image(im, plane, oskar_imager_plane_size(im), size,
+            status);
+    oskar_imager_free(im, status);
+    return plane;
+}
+
+// Grids the visibilities using oskar_grid_idg_d(), then transforms each
+// W plane, applies its W-term correction and returns the sum as an image.
+// If num_w_planes is 0, as many W planes are used as are needed.
+static oskar_Mem* make_idg_image(int num_w_planes, int num_st,
+        const double* aterms, const int* st1, const int* st2,
+        const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* vis,
+        const oskar_Mem* weight, size_t* num_skipped, int* status)
+{
+    double norm = 0.0;
+    const int type = OSKAR_DOUBLE;
+    oskar_Imager* im = create_imager("W-stacking", status);
+    const int grid_size = oskar_imager_plane_size(im);
+    const size_t num_cells = (size_t) grid_size * grid_size;
+    if (num_w_planes < 1)
+        num_w_planes = oskar_grid_idg_num_w_planes(subgrid_size,
+                im->support, ww_max, im->cellsize_rad, grid_size);
+    const double w_scale = (num_w_planes - 1) / ww_max;
+    double* taper = new double[subgrid_size];
+    for (int i = 0; i < subgrid_size; ++i)
+        taper[i] = oskar_grid_function_spheroidal(
+                fabs(i - subgrid_size / 2) / (subgrid_size / 2));
+
+    // Grid the visibilities.
+    oskar_Mem* grids = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells * num_w_planes, status);
+    oskar_grid_idg_d(subgrid_size, im->support, taper, num_w_planes,
+            w_scale, -1, num_st, aterms, st1, st2, num_vis,
+            oskar_mem_double_const(uu, status),
+            oskar_mem_double_const(vv, status),
+            oskar_mem_double_const(ww, status),
+            oskar_mem_double_const(vis, status),
+            oskar_mem_double_const(weight, status),
+            im->cellsize_rad, grid_size, num_skipped, &norm,
+            oskar_mem_double(grids, status), status);
+    delete [] taper;
+    if (*status)
+    {
+        oskar_mem_free(grids, status);
+        oskar_imager_free(im, status);
+        return 0;
+    }
+
+    // Transform each W plane and remove its W-term phase.
+    oskar_Mem* image = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, status);
+    oskar_Mem* layer = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, status);
+    oskar_FFT* fft = oskar_fft_create(type, OSKAR_CPU, 2, grid_size, 0,
+            status);
+    const int half = grid_size / 2;
+    for (int k = 0; k < num_w_planes && !*status; ++k)
+    {
+        oskar_mem_copy_contents(layer, grids, 0, num_cells * k, num_cells,
+                status);
+        oskar_fftphase(grid_size, grid_size, layer, status);
+        oskar_fft_exec(fft, layer, status);
+        const double w_k = k / w_scale;
+        const double* a = oskar_mem_double_const(layer, status);
+        double* b = oskar_mem_double(image, status);
+        for (int y = 0; y < grid_size; ++y)
+        {
+            for (int x = 0; x < grid_size; ++x)
+            {
+                const double l = (x - half) * im->cellsize_rad;
+                const double m = (y - half) * im->cellsize_rad;
+                const double r2 = 1.0 - l * l - m * m;
+                if (r2 <= 0.0) continue;
+                const double phase = 2.0 * M_PI * w_k * (sqrt(r2) - 1.0);
+                const double c = cos(phase), d = sin(phase);
+                const size_t p = 2 * ((size_t) y * grid_size + x);
+                b[p] += a[p] * c + a[p + 1] * d;
+                b[p + 1] += a[p + 1] * c - a[p] * d;
+            }
+        }
+    }
+
+    // Apply the grid correction and normalisation, and trim the image.
+    oskar_Mem* corr = oskar_mem_create(type, OSKAR_CPU, grid_size, status);
+    oskar_grid_correction_function_spheroidal(grid_size, 0,
+            oskar_mem_double(corr, status));
+    oskar_fftphase(grid_size, grid_size, image, status);
+    oskar_grid_correction(grid_size, corr, image, status);
+    oskar_mem_scale_real(image, 1.0 / norm, 0, num_cells, status);
+    oskar_imager_trim_image(im, image, grid_size, size, status);
+
+    // Clean up.
+    oskar_fft_free(fft);
+    oskar_mem_free(grids, status);
+    oskar_mem_free(layer, status);
+    oskar_mem_free(corr, status);
+    oskar_imager_free(im, status);
+    return image;
+}
+
+static double max_diff(const oskar_Mem* a, const oskar_Mem* b,
+        double* max_val)
+{
+    int status = 0;
+    double diff = 0.0;
+    const double* pa = oskar_mem_double_const(a, &status);
+    const double* pb = oskar_mem_double_const(b, &status);
+    *max_val = 0.0;
+    for (int i = 0; i < size * size; ++i)
+    {
+        if (fabs(pa[i]) > *max_val) *max_val = fabs(pa[i]);
+        if (fabs(pa[i] - pb[i]) > diff) diff = fabs(pa[i] - pb[i]);
+    }
+    return diff;
+}
+
+// Creates visibilities for some point sources, with large w values.
+// If station phases are given, the visibilities are corrupted by the A-terms.
+static void make_vis(const double* phase_st, int* st1, int* st2,
+        oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww, oskar_Mem* vis,
+        int* status)
+{
+    const int num_sources = 3;
+    const double lm[][2] = {{0.0, 0.0}, {0.06, 0.02}, {-0.03, -0.065}};
+    double* u_ = oskar_mem_double(uu, status);
+    double* v_ = oskar_mem_double(vv, status);
+    double* w_ = oskar_mem_double(ww, status);
+    double* vis_ = oskar_mem_double(vis, status);
+    srand(2);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        u_[i] = uv_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        v_[i] = uv_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        w_[i] = ww_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        st1[i] = rand() % num_stations;
+        st2[i] = (st1[i] + 1 + rand() % (num_stations - 1)) % num_stations;
+        vis_[2 * i] = vis_[2 * i + 1] = 0.0;
+        for (int s = 0; s < num_sources; ++s)
+        {
+            const double l = lm[s][0], m = lm[s][1];
+            const double n = sqrt(1.0 - l * l - m * m);
+            double phase = -2.0 * M_PI *
+                    (u_[i] * l + v_[i] * m + w_[i] * (n - 1.0));
+            double amp = 1.0;
+            if (phase_st)
+            {
+                amp = aterm(l, m) * aterm(l, m);
+                phase += phase_st[st1[i]] - phase_st[st2[i]];
+            }
+            vis_[2 * i] += amp * cos(phase);
+            vis_[2 * i + 1] += amp * sin(phase);
+        }
+    }
+}
+
+TEST(grid_idg, matches_dft_3d)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    int *st1 = new int[num_vis], *st2 = new int[num_vis];
+    oskar_Mem *uu, *vv, *ww, *vis, *weight;
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    weight = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, &status);
+    make_vis(0, st1, st2, uu, vv, ww, vis, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Make images using each algorithm.
+    oskar_Mem* dft = make_image("DFT 3D", uu, vv, ww, vis, weight, &status);
+    size_t num_skipped = 0;
+    oskar_Mem* idg = make_idg_image(0, 0, 0, 0, 0, uu, vv, ww, vis, weight,
+            &num_skipped, &status);
+    oskar_Mem* wstack = make_image("W-stacking", uu, vv, ww, vis, weight,
+            &status);
+    oskar_Mem* idg_imager = make_image("IDG", uu, vv, ww, vis, weight,
+            &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check IDG is close to the DFT, and better than W-stacking.
+    EXPECT_EQ(0u, num_skipped);
+    double max_val = 0.0;
+    const double diff_idg = max_diff(dft, idg, &max_val);
+    const double diff_wstack = max_diff(dft, wstack, &max_val);
+    EXPECT_GT(max_val, 0.5);
+    EXPECT_LT(diff_idg / max_val, 0.002);
+    EXPECT_LT(diff_idg, diff_wstack);
+    EXPECT_LT(max_diff(dft, idg_imager, &max_val) / max_val, 0.002);
+
+    // Clean up.
+    delete [] st1;
+    delete [] st2;
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(dft, &status);
+    oskar_mem_free(idg, &status);
+    oskar_mem_free(wstack, &status);
+    oskar_mem_free(idg_imager, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(grid_idg, aterms)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    int *st1 = new int[num_vis], *st2 = new int[num_vis];
+    double phase_st[num_stations];
+    for (int s = 0; s < num_stations; ++s) phase_st[s] = 0.7 * s;
+    oskar_Mem *uu, *vv, *ww, *vis, *weight;
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    weight = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, &status);
+    make_vis(phase_st, st1, st2, uu, vv, ww, vis, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Make a reference image from the visibilities without the station
+    // phases, multiplied by the square of the A-term at each pixel.
+    oskar_Mem* vis_ref = oskar_mem_create_copy(vis, OSKAR_CPU, &status);
+    double* v_ = oskar_mem_double(vis_ref, &status);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        const double phase = phase_st[st2[i]] - phase_st[st1[i]];
+        const double re = v_[2 * i], im = v_[2 * i + 1];
+        v_[2 * i] = re * cos(phase) - im * sin(phase);
+        v_[2 * i + 1] = re * sin(phase) + im * cos(phase);
+    }
+    oskar_Mem* ref = make_image("DFT 3D", uu, vv, ww, vis_ref, weight,
+            &status);
+    oskar_Mem *l, *m, *n;
+    l = oskar_mem_create(type, OSKAR_CPU, size * size, &status);
+    m = oskar_mem_create(type, OSKAR_CPU, size * size, &status);
+    n = oskar_mem_create(type, OSKAR_CPU, size * size, &status);
+    oskar_evaluate_image_lmn_grid(size, size, fov_deg * M_PI / 180.0,
+            fov_deg * M_PI / 180.0, 0, l, m, n, &status);
+    double* ref_ = oskar_mem_double(ref, &status);
+    const double* l_ = oskar_mem_double_const(l, &status);
+    const double* m_ = oskar_mem_double_const(m, &status);
+    for (int i = 0; i < size * size; ++i)
+        ref_[i] *= aterm(l_[i], m_[i]) * aterm(l_[i], m_[i]);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Evaluate the A-terms of each station at the subgrid pixels.
+    const int num_pixels = subgrid_size * subgrid_size;
+    oskar_Imager* im = create_imager("W-stacking", &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    double* sub_l = new double[num_pixels];
+    double* sub_m = new double[num_pixels];
+    double* sub_n = new double[num_pixels];
+    double* aterms = new double[2 * num_stations * num_pixels];
+    oskar_grid_idg_subgrid_lmn_d(subgrid_size, oskar_imager_plane_size(im),
+            im->cellsize_rad, sub_l, sub_m, sub_n);
+    oskar_imager_free(im, &status);
+    for (int s = 0; s < num_stations; ++s)
+    {
+        for (int p = 0; p < num_pixels; ++p)
+        {
+            const double a = aterm(sub_l[p], sub_m[p]);
+            aterms[2 * (s * num_pixels + p)] = a * cos(phase_st[s]);
+            aterms[2 * (s * num_pixels + p) + 1] = a * sin(phase_st[s]);
+        }
+    }
+
+    // Grid the corrupted visibilities, applying the A-terms.
+    size_t num_skipped = 0;
+    oskar_Mem* idg = make_idg_image(0, num_stations, aterms, st1, st2,
+            uu, vv, ww, vis, weight, &num_skipped, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0u, num_skipped);
+
+    // Check the image is close to the reference.
+    double max_val = 0.0;
+    const double diff = max_diff(ref, idg, &max_val);
+    EXPECT_GT(max_val, 0.5);
+    EXPECT_LT(diff / max_val, 0.002);
+
+    // Clean up.
+    delete [] st1;
+    delete [] st2;
+    delete [] sub_l;
+    delete [] sub_m;
+    delete [] sub_n;
+    delete [] aterms;
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(vis_ref, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(ref, &status);
+    oskar_mem_free(idg, &status);
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(grid_idg, too_few_w_planes)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    int *st1 = new int[num_vis], *st2 = new int[num_vis];
+    oskar_Mem *uu, *vv, *ww, *vis, *weight;
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    weight = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, &status);
+    make_vis(0, st1, st2, uu, vv, ww, vis, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check that gridding fails if the W planes are too far apart,
+    // rather than dropping visibilities.
+    size_t num_skipped = 0;
+    oskar_Imager* im = create_imager("W-stacking", &status);
+    const int num_w_planes = oskar_grid_idg_num_w_planes(subgrid_size,
+            im->support, ww_max, im->cellsize_rad,
+            oskar_imager_plane_size(im));
+    oskar_imager_free(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_GT(num_w_planes, 2);
+    oskar_Mem* idg = make_idg_image(num_w_planes - 1, 0, 0, 0, 0,
+            uu, vv, ww, vis, weight, &num_skipped, &status);
+    EXPECT_EQ((int) OSKAR_ERR_OUT_OF_RANGE, status);
+    status = 0;
+
+    // Clean up.
+    delete [] st1;
+    delete [] st2;
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(idg, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+// Creates an IDG imager that applies the beams of the telescope stations.
+static oskar_Imager* create_idg_imager(const oskar_Telescope* tel,
+        double freq_hz, double ra_rad, double dec_rad, int* status)
+{
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_algorithm(im, "IDG", status);
+    oskar_imager_set_telescope_model(im, tel, status);
+    oskar_imager_set_fov(im, fov_deg);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_vis_frequency(im, freq_hz, 0.0, 1);
+    oskar_imager_set_vis_phase_centre(im, ra_rad * 180.0 / M_PI,
+            dec_rad * 180.0 / M_PI);
+    im->ww_min = 0.0;
+    im->ww_max = ww_max;
+    im->ww_rms = 0.5 * ww_max;
+    oskar_imager_check_init(im, status);
+    return im;
+}
+
+TEST(grid_idg, imager_station_beams)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    const int num_times = 2;
+    const double freq_hz = 100e6, lat_rad = -0.5, mjd_start = 59000.0;
+    int *st1 = new int[num_vis], *st2 = new int[num_vis];
+    int *time_index = new int[num_vis];
+    oskar_Mem *uu, *vv, *ww, *vis, *weight, *time_centroid;
+    oskar_Mem *station1, *station2;
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    weight = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_vis,
+            &status);
+    station1 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_vis, &status);
+    station2 = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_vis, &status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, &status);
+    make_vis(0, st1, st2, uu, vv, ww, vis, &status);
+    double* t_ = oskar_mem_double(time_centroid, &status);
+    int* s1_ = oskar_mem_int(station1, &status);
+    int* s2_ = oskar_mem_int(station2, &status);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        time_index[i] = i * num_times / num_vis;
+        t_[i] = mjd_start * 86400.0 + 3600.0 * time_index[i];
+        s1_[i] = st1[i];
+        s2_[i] = st2[i];
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Create a telescope with a different Gaussian beam for each station,
+    // and point it at the zenith at the start time.
+    oskar_Telescope* tel = oskar_telescope_create(type, OSKAR_CPU,
+            num_stations, &status);
+    oskar_telescope_set_position(tel, 0.0, lat_rad, 0.0);
+    for (int s = 0; s < num_stations; ++s)
+    {
+        oskar_Station* station = oskar_telescope_station(tel, s);
+        oskar_station_set_station_type(station,
+                OSKAR_STATION_TYPE_GAUSSIAN_BEAM);
+        oskar_station_set_gaussian_beam_values(station,
+                (6.0 + s) * M_PI / 180.0, freq_hz);
+        oskar_station_set_position(station, 0.0, lat_rad, 0.0, 0.0, 0.0, 0.0);
+    }
+    const double ra_rad = oskar_convert_mjd_to_gast_fast(mjd_start);
+    oskar_telescope_set_phase_centre(tel, OSKAR_COORDS_RADEC,
+            ra_rad, lat_rad);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Make the image with IDG, applying the station beams.
+    double norm = 0.0;
+    oskar_Imager* im = create_idg_imager(tel, freq_hz, ra_rad, lat_rad,
+            &status);
+    oskar_Mem* idg = oskar_mem_create(oskar_imager_plane_type(im),
+            OSKAR_CPU, 0, &status);
+    oskar_imager_update_plane_with_stations(im, num_vis, uu, vv, ww, vis,
+            weight, time_centroid, station1, station2, 0, idg, &norm, 0,
+            &status);
+    oskar_imager_finalise_plane(im, idg, norm, &status);
+    oskar_imager_trim_image(im, idg, oskar_imager_plane_size(im), size,
+            &status);
+    oskar_imager_free(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Make a reference image from a DFT of the visibilities of each
+    // baseline and time, multiplied by the beams of its stations.
+    const int num_pixels = size * size;
+    oskar_Mem *l, *m, *n, *beam;
+    l = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    m = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    n = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    beam = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+            num_stations * num_pixels, &status);
+    oskar_evaluate_image_lmn_grid(size, size, fov_deg * M_PI / 180.0,
+            fov_deg * M_PI / 180.0, 0, l, m, n, &status);
+    const oskar_Mem* const dir[] = {l, m, n};
+    oskar_StationWork* work = oskar_station_work_create(type, OSKAR_CPU,
+            &status);
+    oskar_Mem* ref = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    oskar_Mem* sub[5];
+    for (int j = 0; j < 5; ++j)
+        sub[j] = oskar_mem_create_copy(j == 3 ? vis : uu, OSKAR_CPU, &status);
+    double* ref_ = oskar_mem_double(ref, &status);
+    const double* beam_ = oskar_mem_double_const(beam, &status);
+    for (int t = 0; t < num_times; ++t)
+    {
+        const double gast = oskar_convert_mjd_to_gast_fast(
+                mjd_start + t / 24.0);
+        for (int s = 0; s < num_stations; ++s)
+            oskar_station_beam(oskar_telescope_station_const(tel, s), work,
+                    OSKAR_COORDS_REL_DIR, num_pixels, dir, ra_rad, lat_rad,
+                    OSKAR_COORDS_RADEC, ra_rad, lat_rad, 0, gast, freq_hz,
+                    s * num_pixels, beam, &status);
+        for (int a = 0; a < num_stations; ++a)
+        {
+            for (int b = a + 1; b < num_stations; ++b)
+            {
+                size_t num_sub = 0;
+                double* sub_[5];
+                for (int j = 0; j < 5; ++j)
+                    sub_[j] = oskar_mem_double(sub[j], &status);
+                const double* in_[] = {
+                        oskar_mem_double_const(uu, &status),
+                        oskar_mem_double_const(vv, &status),
+                        oskar_mem_double_const(ww, &status),
+                        oskar_mem_double_const(vis, &status),
+                        oskar_mem_double_const(weight, &status)
+                };
+                for (int i = 0; i < num_vis; ++i)
+                {
+                    if (time_index[i] != t || !((st1[i] == a && st2[i] == b)
+                            || (st1[i] == b && st2[i] == a)))
+                        continue;
+                    for (int j = 0; j < 5; ++j)
+                    {
+                        if (j == 3)
+                        {
+                            sub_[j][2 * num_sub] = in_[j][2 * i];
+                            sub_[j][2 * num_sub + 1] = in_[j][2 * i + 1];
+                        }
+                        else
+                            sub_[j][num_sub] = in_[j][i];
+                    }
+                    num_sub++;
+                }
+                if (num_sub == 0) continue;
+                oskar_Mem* image = make_image("DFT 3D", sub[0], sub[1],
+                        sub[2], sub[3], sub[4], &status, num_sub);
+                const double* image_ = oskar_mem_double_const(image,
+                        &status);
+                const double scale = (double) num_sub / num_vis;
+                for (int p = 0; p < num_pixels && !status; ++p)
+                    ref_[p] += scale * image_[p] *
+                            beam_[2 * (a * num_pixels + p)] *
+                            beam_[2 * (b * num_pixels + p)];
+                oskar_mem_free(image, &status);
+            }
+        }
+    }
+    oskar_Mem* dft = make_image("DFT 3D", uu, vv, ww, vis, weight, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the image is close to the reference, and that the beams
+    // make a significant difference.
+    double max_val = 0.0;
+    const double diff = max_diff(ref, idg, &max_val);
+    const double diff_no_beam = max_diff(ref, dft, &max_val);
+    EXPECT_GT(max_val, 0.5);
+    EXPECT_LT(diff / max_val, 0.002);
+    EXPECT_GT(diff_no_beam / max_val, 0.05);
+
+    // Make the image again from the baseline coordinates in metres,
+    // using the visibility selection and a UV filter, which must keep the
+    // times and stations with the visibilities that remain.
+    const double uv_filter_max = 0.8 * uv_max;
+    const double wavelength = 299792458.0 / freq_hz;
+    oskar_Mem* uvw_m[3];
+    for (int j = 0; j < 3; ++j)
+    {
+        uvw_m[j] = oskar_mem_create_copy(j == 0 ? uu : (j == 1 ? vv : ww),
+                OSKAR_CPU, &status);
+        oskar_mem_scale_real(uvw_m[j], wavelength, 0, num_vis, &status);
+    }
+    im = create_idg_imager(tel, freq_hz, ra_rad, lat_rad, &status);
+    oskar_imager_set_uv_filter_max(im, uv_filter_max);
+    oskar_imager_update_with_stations(im, num_vis, 0, 0, 1,
+            uvw_m[0], uvw_m[1], uvw_m[2], vis, weight, time_centroid,
+            station1, station2, &status);
+    oskar_Mem *filtered = 0, *filtered_grid = 0;
+    const int plane_size = oskar_imager_plane_size(im);
+    oskar_imager_finalise(im, 1, &filtered, 1, &filtered_grid, &status);
+    oskar_imager_free(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ((size_t) plane_size * plane_size,
+            oskar_mem_length(filtered_grid));
+
+    // Compare with the image of only the visibilities inside the filter.
+    size_t num_sub = 0;
+    oskar_Mem* sub_t = oskar_mem_create_copy(time_centroid, OSKAR_CPU,
+            &status);
+    oskar_Mem* sub_s[] = {
+            oskar_mem_create_copy(station1, OSKAR_CPU, &status),
+            oskar_mem_create_copy(station2, OSKAR_CPU, &status)
+    };
+    for (int i = 0; i < num_vis; ++i)
+    {
+        const double* u_ = oskar_mem_double_const(uu, &status);
+        const double* v_ = oskar_mem_double_const(vv, &status);
+        if (sqrt(u_[i] * u_[i] + v_[i] * v_[i]) > uv_filter_max) continue;
+        oskar_mem_copy_contents(sub[0], uu, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub[1], vv, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub[2], ww, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub[3], vis, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub[4], weight, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub_t, time_centroid, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub_s[0], station1, num_sub, i, 1, &status);
+        oskar_mem_copy_contents(sub_s[1], station2, num_sub, i, 1, &status);
+        num_sub++;
+    }
+    EXPECT_GT(num_sub, 0u);
+    EXPECT_LT(num_sub, (size_t) num_vis);
+    norm = 0.0;
+    im = create_idg_imager(tel, freq_hz, ra_rad, lat_rad, &status);
+    oskar_Mem* expected = oskar_mem_create(oskar_imager_plane_type(im),
+            OSKAR_CPU, 0, &status);
+    oskar_imager_update_plane_with_stations(im, num_sub,
+            sub[0], sub[1], sub[2], sub[3], sub[4], sub_t, sub_s[0], sub_s[1],
+            0, expected, &norm, 0, &status);
+    oskar_imager_finalise_plane(im, expected, norm, &status);
+    oskar_imager_trim_image(im, expected, oskar_imager_plane_size(im), size,
+            &status);
+    oskar_imager_free(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double diff_filtered = max_diff(expected, filtered, &max_val);
+    EXPECT_GT(max_val, 0.5);
+    EXPECT_LT(diff_filtered / max_val, 1e-6);
+
+    // Clean up.
+    delete [] st1;
+    delete [] st2;
+    delete [] time_index;
+    for (int j = 0; j < 5; ++j) oskar_mem_free(sub[j], &status);
+    oskar_station_work_free(work, &status);
+    oskar_telescope_free(tel, &status);
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(time_centroid, &status);
+    oskar_mem_free(station1, &status);
+    oskar_mem_free(station2, &status);
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_mem_free(beam, &status);
+    oskar_mem_free(ref, &status);
+    oskar_mem_free(dft, &status);
+    oskar_mem_free(idg, &status);
+    oskar_mem_free(filtered, &status);
+    oskar_mem_free(filtered_grid, &status);
+    oskar_mem_free(expected, &status);
+    oskar_mem_free(sub_t, &status);
+    oskar_mem_free(sub_s[0], &status);
+    oskar_mem_free(sub_s[1], &status);
+    for (int j = 0; j < 3; ++j) oskar_mem_free(uvw_m[j], &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
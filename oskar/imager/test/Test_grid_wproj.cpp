@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "imager/oskar_imager.h"
+#include "imager/private_imager.h"
+#include "imager/oskar_grid_wproj2.h"
+#include "imager/oskar_grid_wproj2_tiled.h"
+#include "utility/oskar_dir.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static oskar_Imager* create_wproj_imager(const char* cache_dir, int* status)
+{
+    const double ww_max = 1000.0;
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_algorithm(im, "W-projection", status);
+    oskar_imager_set_fov(im, 4.0);
+    oskar_imager_set_size(im, 256, status);
+    oskar_imager_set_num_w_planes(im, 16);
+    oskar_imager_set_w_kernel_cache_dir(im, cache_dir);
+    im->ww_min = 0.0;
+    im->ww_max = ww_max;
+    im->ww_rms = 0.5 * ww_max;
+    oskar_imager_check_init(im, status);
+    return im;
+}
+
+static bool mem_equal(const oskar_Mem* a, const oskar_Mem* b)
+{
+    const size_t len = oskar_mem_length(a);
+    return oskar_mem_type(a) == oskar_mem_type(b) &&
+            len == oskar_mem_length(b) &&
+            !memcmp(oskar_mem_void_const(a), oskar_mem_void_const(b),
+                    len * oskar_mem_element_size(oskar_mem_type(a)));
+}
+
+TEST(grid_wproj, tiled_matches_serial)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    const int num_vis = 20000;
+    const double ww_max = 1000.0;
+
+    // Create the W-projection kernels.
+    oskar_Imager* im = oskar_imager_create(type, &status);
+    oskar_imager_set_algorithm(im, "W-projection", &status);
+    oskar_imager_set_fov(im, 4.0);
+    oskar_imager_set_size(im, 256, &status);
+    oskar_imager_set_num_w_planes(im, 16);
+    im->ww_min = 0.0;
+    im->ww_max = ww_max;
+    im->ww_rms = 0.5 * ww_max;
+    oskar_imager_check_init(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const int grid_size = oskar_imager_plane_size(im);
+    const size_t num_cells = (size_t) grid_size * grid_size;
+    const double uv_max = 0.5 * grid_size / (grid_size * im->cellsize_rad);
+
+    // Create visibility data, some of which will fall off the grid.
+    oskar_Mem *uu, *vv, *ww, *vis, *weight;
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    weight = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    double* uu_ = oskar_mem_double(uu, &status);
+    double* vv_ = oskar_mem_double(vv, &status);
+    double* ww_ = oskar_mem_double(ww, &status);
+    double* vis_ = oskar_mem_double(vis, &status);
+    double* weight_ = oskar_mem_double(weight, &status);
+    srand(1);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        uu_[i] = uv_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        vv_[i] = uv_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        ww_[i] = ww_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        vis_[2 * i] = 2.0 * rand() / (double) RAND_MAX - 1.0;
+        vis_[2 * i + 1] = 2.0 * rand() / (double) RAND_MAX - 1.0;
+        weight_[i] = 0.5 + rand() / (double) RAND_MAX;
+    }
+
+    // Grid the data with the serial and tiled versions.
+    double norm[] = {1.0, 1.0};
+    size_t num_skipped[] = {0, 0};
+    oskar_Mem* grid[2];
+    for (int t = 0; t < 2; ++t)
+    {
+        grid[t] = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+                num_cells, &status);
+        oskar_mem_clear_contents(grid[t], &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        (t == 0 ? oskar_grid_wproj2_d : oskar_grid_wproj2_tiled_d)(
+                im->num_w_planes,
+                oskar_mem_int_const(im->w_support, &status),
+                im->oversample,
+                oskar_mem_int_const(im->w_kernel_start, &status),
+                oskar_mem_double_const(im->w_kernels_compact, &status),
+                num_vis, uu_, vv_, ww_, vis_, weight_,
+                im->cellsize_rad, im->w_scale, grid_size,
+                &num_skipped[t], &norm[t], oskar_mem_double(grid[t], &status));
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the results are identical.
+    EXPECT_GT(num_skipped[0], 0u);
+    EXPECT_LT(num_skipped[0], (size_t) num_vis);
+    EXPECT_EQ(num_skipped[0], num_skipped[1]);
+    EXPECT_EQ(norm[0], norm[1]);
+    EXPECT_EQ(0, memcmp(oskar_mem_void_const(grid[0]),
+            oskar_mem_void_const(grid[1]),
+            num_cells * oskar_mem_element_size(type | OSKAR_COMPLEX)));
+
+    // Clean up.
+    oskar_imager_free(im, &status);
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(grid[0], &status);
+    oskar_mem_free(grid[1], &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(grid_wproj, kernel_cache)
+{
+    int status = 0, num_files = 0;
+    char** files = 0;
+    const char* cache_dir = "temp_test_w_kernel_cache";
+    oskar_dir_remove(cache_dir);
+    ASSERT_TRUE(oskar_dir_mkpath(cache_dir));
+
+    // Generate the kernels without the cache, for reference.
+    oskar_Imager* ref = create_wproj_imager(0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate the kernels and save them.
+    oskar_Imager* im = create_wproj_imager(cache_dir, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_imager_free(im, &status);
+    oskar_dir_items(cache_dir, "oskar_w_kernels_*.bin", 1, 0,
+            &num_files, &files);
+    ASSERT_EQ(1, num_files);
+
+    // Check the kernels loaded from the cache are identical.
+    im = create_wproj_imager(cache_dir, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(ref->w_scale, im->w_scale);
+    EXPECT_TRUE(mem_equal(ref->w_support, im->w_support));
+    EXPECT_TRUE(mem_equal(ref->w_kernel_start, im->w_kernel_start));
+    EXPECT_TRUE(mem_equal(ref->w_kernels_compact, im->w_kernels_compact));
+    oskar_imager_free(im, &status);
+
+    // Corrupt the end of the file, and check the kernels are regenerated.
+    char* path = oskar_dir_get_path(cache_dir, files[0]);
+    FILE* file = fopen(path, "r+b");
+    ASSERT_TRUE(file != NULL);
+    fseek(file, -16, SEEK_END);
+    fwrite("corrupted kernel", 1, 16, file);
+    fclose(file);
+    im = create_wproj_imager(cache_dir, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(mem_equal(ref->w_kernels_compact, im->w_kernels_compact));
+    oskar_imager_free(im, &status);
+
+    // Check the rewritten file is used.
+    im = create_wproj_imager(cache_dir, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(mem_equal(ref->w_kernels_compact, im->w_kernels_compact));
+    oskar_imager_free(im, &status);
+
+    // Corrupt the number of elements, which follows the 64-byte key,
+    // and check the kernels are regenerated rather than allocated.
+    file = fopen(path, "r+b");
+    ASSERT_TRUE(file != NULL);
+    const uint64_t bad_num_elements = ((uint64_t) 1) << 60;
+    fseek(file, 64, SEEK_SET);
+    fwrite(&bad_num_elements, sizeof(bad_num_elements), 1, file);
+    fclose(file);
+    im = create_wproj_imager(cache_dir, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(mem_equal(ref->w_kernels_compact, im->w_kernels_compact));
+    oskar_imager_free(im, &status);
+
+    // Reverse the byte order marker, which follows the magic string and
+    // version, and check the file is not used.
+    file = fopen(path, "r+b");
+    ASSERT_TRUE(file != NULL);
+    const uint32_t swapped_byte_order = 0x04030201;
+    fseek(file, 12, SEEK_SET);
+    fwrite(&swapped_byte_order, sizeof(swapped_byte_order), 1, file);
+    fclose(file);
+    im = create_wproj_imager(cache_dir, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(mem_equal(ref->w_kernels_compact, im->w_kernels_compact));
+    oskar_imager_free(im, &status);
+
+    // A different W range must not use the same file.
+    im = oskar_imager_create(OSKAR_DOUBLE, &status);
+    oskar_imager_set_algorithm(im, "W-projection", &status);
+    oskar_imager_set_fov(im, 4.0);
+    oskar_imager_set_size(im, 256, &status);
+    oskar_imager_set_num_w_planes(im, 16);
+    oskar_imager_set_w_kernel_cache_dir(im, cache_dir);
+    im->ww_max = 2000.0;
+    im->ww_rms = 1000.0;
+    oskar_imager_check_init(im, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_imager_free(im, &status);
+    for (int i = 0; i < num_files; ++i) free(files[i]);
+    free(files);
+    files = 0;
+    num_files = 0;
+    oskar_dir_items(cache_dir, "oskar_w_kernels_*.bin", 1, 0,
+            &num_files, &files);
+    EXPECT_EQ(2, num_files);
+
+    // Clean up.
+    for (int i = 0; i < num_files; ++i) free(files[i]);
+    free(files);
+    free(path);
+    oskar_imager_free(ref, &status);
+    oskar_dir_remove(cache_dir);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "imager/oskar_imager.h"
+#include "imager/private_imager.h"
+#include "math/oskar_cmath.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cstdlib>
+
+static oskar_Mem* make_image(const char* algorithm, int size, double fov_deg,
+        int num_w_planes, double ww_max, int num_chunks, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* vis,
+        const oskar_Mem* weight, int* status)
+{
+    double norm = 0.0;
+    const size_t num_vis = oskar_mem_length(uu);
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_algorithm(im, algorithm, status);
+    oskar_imager_set_fov(im, fov_deg);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_num_w_planes(im, num_w_planes);
+    im->ww_min = 0.0;
+    im->ww_max = ww_max;
+    im->ww_rms = 0.5 * ww_max;
+    oskar_imager_check_init(im, status);
+
+    // Make the image, supplying the visibilities in chunks.
+    oskar_Mem* plane = oskar_mem_create(oskar_imager_plane_type(im),
+            OSKAR_CPU, 0, status);
+    for (int c = 0; c < num_chunks; ++c)
+    {
+        const size_t start = c * num_vis / num_chunks;
+        const size_t n = (c + 1) * num_vis / num_chunks - start;
+        oskar_Mem* u_c = oskar_mem_create_alias(uu, start, n, status);
+        oskar_Mem* v_c = oskar_mem_create_alias(vv, start, n, status);
+        oskar_Mem* w_c = oskar_mem_create_alias(ww, start, n, status);
+        oskar_Mem* vis_c = oskar_mem_create_alias(vis, start, n, status);
+        oskar_Mem* wt_c = oskar_mem_create_alias(weight, start, n, status);
+        oskar_imager_update_plane(im, n, u_c, v_c, w_c, vis_c, wt_c, 0,
+                plane, &norm, 0, status);
+        oskar_mem_free(u_c, status);
+        oskar_mem_free(v_c, status);
+        oskar_mem_free(w_c, status);
+        oskar_mem_free(vis_c, status);
+        oskar_mem_free(wt_c, status);
+    }
+    oskar_imager_finalise_plane(im, plane, norm, status);
+    oskar_imager_trim_image(im, plane, oskar_imager_plane_size(im), size,
+            status);
+    oskar_imager_free(im, status);
+    return plane;
+}
+
+static double max_diff(const oskar_Mem* a, const oskar_Mem* b, int size,
+        double* max_val)
+{
+    int status = 0;
+    double diff = 0.0;
+    const double* pa = oskar_mem_double_const(a, &status);
+    const double* pb = oskar_mem_double_const(b, &status);
+    *max_val = 0.0;
+    for (int i = 0; i < size * size; ++i)
+    {
+        if (fabs(pa[i]) > *max_val) *max_val = fabs(pa[i]);
+        if (fabs(pa[i] - pb[i]) > diff) diff = fabs(pa[i] - pb[i]);
+    }
+    return diff;
+}
+
+TEST(imager, wstack_matches_dft_3d)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    const int size = 64, num_vis = 30000, num_chunks = 3, num_sources = 3;
+    const double fov_deg = 10.0, uv_max = 150.0, ww_max = 500.0;
+    const double lm[][2] = {{0.0, 0.0}, {0.06, 0.02}, {-0.03, -0.065}};
+
+    // Create visibilities for some point sources, with large w values.
+    oskar_Mem *uu, *vv, *ww, *vis, *weight;
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    weight = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, &status);
+    double* u_ = oskar_mem_double(uu, &status);
+    double* v_ = oskar_mem_double(vv, &status);
+    double* w_ = oskar_mem_double(ww, &status);
+    double* vis_ = oskar_mem_double(vis, &status);
+    srand(2);
+    for (int i = 0; i < num_vis; ++i)
+    {
+        u_[i] = uv_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        v_[i] = uv_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        w_[i] = ww_max * (2.0 * rand() / (double) RAND_MAX - 1.0);
+        vis_[2 * i] = vis_[2 * i + 1] = 0.0;
+        for (int s = 0; s < num_sources; ++s)
+        {
+            const double l = lm[s][0], m = lm[s][1];
+            const double n = sqrt(1.0 - l * l - m * m);
+            const double phase = -2.0 * M_PI *
+                    (u_[i] * l + v_[i] * m + w_[i] * (n - 1.0));
+            vis_[2 * i] += cos(phase);
+            vis_[2 * i + 1] += sin(phase);
+        }
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Make images using each algorithm.
+    oskar_Mem* dft = make_image("DFT 3D", size, fov_deg, 0, ww_max, 1,
+            uu, vv, ww, vis, weight, &status);
+    oskar_Mem* wstack = make_image("W-stacking", size, fov_deg, 0, ww_max,
+            num_chunks, uu, vv, ww, vis, weight, &status);
+    oskar_Mem* fft = make_image("FFT", size, fov_deg, 0, ww_max, 1,
+            uu, vv, ww, vis, weight, &status);
+    oskar_Mem* coarse = make_image("W-stacking", size, fov_deg, 16, ww_max,
+            1, uu, vv, ww, vis, weight, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check W-stacking is close to the DFT, and much better than the FFT.
+    // The tolerance is tight enough to fail if too few W planes are used.
+    double max_val = 0.0;
+    const double diff_wstack = max_diff(dft, wstack, size, &max_val);
+    const double diff_coarse = max_diff(dft, coarse, size, &max_val);
+    const double diff_fft = max_diff(dft, fft, size, &max_val);
+    EXPECT_GT(max_val, 0.5);
+    EXPECT_LT(diff_wstack / max_val, 0.002);
+    EXPECT_GT(diff_coarse / max_val, 0.002);
+    EXPECT_GT(diff_fft, 5.0 * diff_wstack);
+
+    // Clean up.
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(vis, &status);
+    oskar_mem_free(weight, &status);
+    oskar_mem_free(dft, &status);
+    oskar_mem_free(wstack, &status);
+    oskar_mem_free(coarse, &status);
+    oskar_mem_free(fft, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
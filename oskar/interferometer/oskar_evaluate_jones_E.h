@@ -27,8 +27,10 @@ extern "C" {
  * Evaluates station beams for a telescope model at the specified source
  * positions, storing the results in the Jones matrix data structure.
  *
- * If all stations are marked as identical, the results for the first station
- * are copied into the results for the others.
+ * If station beam duplication is enabled, the beam is evaluated only for
+ * the first station in each station beam equivalence class
+ * (see oskar_telescope_station_beam_class_const()), and copied into the
+ * results for the other stations in the class.
  *
  * @param[out] E             Output set of Jones matrices.
  * @param[in]  coord_type    Type of coordinates.
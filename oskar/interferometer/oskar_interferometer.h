@@ -73,6 +73,14 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status);
 OSKAR_EXPORT
 void oskar_interferometer_free_device_data(oskar_Interferometer* h, int* status);
 
+OSKAR_EXPORT
+void oskar_interferometer_free_flux_tables(oskar_Interferometer* h,
+        int* status);
+
+OSKAR_EXPORT
+void oskar_interferometer_free_horizon_tables(oskar_Interferometer* h,
+        int* status);
+
 OSKAR_EXPORT
 void oskar_interferometer_reset_cache(oskar_Interferometer* h, int* status);
 
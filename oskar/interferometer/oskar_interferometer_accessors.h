@@ -36,6 +36,15 @@ int oskar_interferometer_num_gpus(const oskar_Interferometer* h);
 OSKAR_EXPORT
 int oskar_interferometer_num_vis_blocks(const oskar_Interferometer* h);
 
+OSKAR_EXPORT
+int oskar_interferometer_write_queue_depth(const oskar_Interferometer* h);
+
+OSKAR_EXPORT
+int oskar_interferometer_share_telescope(const oskar_Interferometer* h);
+
+OSKAR_EXPORT
+double oskar_interferometer_max_flux_table_mb(const oskar_Interferometer* h);
+
 OSKAR_EXPORT
 void oskar_interferometer_reset_cache(oskar_Interferometer* h, int* status);
 
@@ -80,6 +89,58 @@ void oskar_interferometer_set_max_times_per_block(oskar_Interferometer* h,
 OSKAR_EXPORT
 void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value);
 
+/**
+ * @brief
+ * Sets the number of visibility blocks held in host memory for writing.
+ *
+ * @details
+ * Each compute device holds this many visibility blocks in host memory,
+ * so up to this number of completed blocks (including the one being
+ * written) can be waiting to be written while simulation continues.
+ * Compute devices only wait for the writer when the queue is full.
+ * The minimum (and default) value of 2 gives double buffering.
+ *
+ * @param[in,out] h     Handle to simulator.
+ * @param[in] value     Number of host visibility blocks per device.
+ */
+OSKAR_EXPORT
+void oskar_interferometer_set_write_queue_depth(oskar_Interferometer* h,
+        int value);
+
+/**
+ * @brief
+ * Sets whether CPU threads share a single telescope model.
+ *
+ * @details
+ * If set (the default), all CPU compute devices read from the
+ * simulator's own copy of the telescope model, rather than each
+ * having a private copy. GPU devices always use their own copy.
+ *
+ * @param[in,out] h     Handle to simulator.
+ * @param[in] value     If true, share the telescope model.
+ */
+OSKAR_EXPORT
+void oskar_interferometer_set_share_telescope(oskar_Interferometer* h,
+        int value);
+
+/**
+ * @brief
+ * Sets the maximum size of the source flux table.
+ *
+ * @details
+ * If the simulation uses CPU devices, the Stokes parameters of every
+ * source are evaluated once for every channel and stored in a table,
+ * so that fluxes do not need to be scaled with frequency at each time
+ * step. The table is not used if it would be larger than this size,
+ * in MiB. A value of 0 disables the table.
+ *
+ * @param[in,out] h     Handle to simulator.
+ * @param[in] value     Maximum size of the flux table, in MiB.
+ */
+OSKAR_EXPORT
+void oskar_interferometer_set_max_flux_table_mb(oskar_Interferometer* h,
+        double value);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels);
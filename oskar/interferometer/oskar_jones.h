@@ -33,5 +33,6 @@ typedef struct oskar_Jones oskar_Jones;
 #include <interferometer/oskar_jones_free.h>
 #include <interferometer/oskar_jones_join.h>
 #include <interferometer/oskar_jones_set_size.h>
+#include <interferometer/oskar_jones_soa.h>
 
 #endif /* include guard */
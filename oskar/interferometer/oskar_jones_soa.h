@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_JONES_SOA_H_
+#define OSKAR_JONES_SOA_H_
+
+/**
+ * @file oskar_jones_soa.h
+ */
+
+#include <oskar_global.h>
+
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Enables or disables the structure-of-arrays copy of the Jones data.
+ *
+ * @details
+ * If enabled, functions that write to the Jones matrix block (such as
+ * oskar_evaluate_jones_E() and oskar_jones_join()) will also store
+ * the data in a structure-of-arrays layout, as required by the
+ * vectorised correlators.
+ *
+ * For each station, the real and imaginary parts of each matrix element
+ * are held in separate contiguous arrays, in the order
+ * (a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y) for matrix types, or
+ * (x, y) for scalar types. Each array holds
+ * oskar_jones_soa_stride() elements, so that each one is suitably aligned
+ * for vector loads; the padding elements are set to zero.
+ *
+ * This is only available for Jones matrices in CPU memory.
+ *
+ * @param[in,out] jones  Pointer to data structure.
+ * @param[in]     value  If set, enable the structure-of-arrays copy.
+ * @param[in,out] status Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_set_soa_enabled(oskar_Jones* jones, int value, int* status);
+
+/**
+ * @brief
+ * Returns true if the structure-of-arrays copy of the Jones data is enabled.
+ *
+ * @details
+ * Returns true if the structure-of-arrays copy of the Jones data is enabled.
+ *
+ * @param[in] jones  Pointer to data structure.
+ *
+ * @return True if enabled.
+ */
+OSKAR_EXPORT
+int oskar_jones_soa_enabled(const oskar_Jones* jones);
+
+/**
+ * @brief
+ * Returns the number of elements in each array of the structure-of-arrays.
+ *
+ * @details
+ * Returns the number of elements in each array of the structure-of-arrays.
+ * This is the source capacity of the Jones matrix block, rounded up to
+ * a multiple of 16.
+ *
+ * @param[in] jones  Pointer to data structure.
+ *
+ * @return The array stride, in real-valued elements.
+ */
+OSKAR_EXPORT
+int oskar_jones_soa_stride(const oskar_Jones* jones);
+
+/**
+ * @brief
+ * Returns a pointer to the structure-of-arrays copy of the Jones data.
+ *
+ * @details
+ * Returns a pointer to the structure-of-arrays copy of the Jones data.
+ * The memory has a real-valued type of the same precision as the
+ * Jones matrices. It is null unless enabled using
+ * oskar_jones_set_soa_enabled().
+ *
+ * @param[in] jones  Pointer to data structure.
+ *
+ * @return A pointer to the memory structure.
+ */
+OSKAR_EXPORT
+oskar_Mem* oskar_jones_soa(oskar_Jones* jones);
+
+/**
+ * @brief
+ * Returns a read-only pointer to the structure-of-arrays copy of the data.
+ *
+ * @details
+ * Returns a read-only pointer to the structure-of-arrays copy of the data.
+ *
+ * @param[in] jones  Pointer to data structure.
+ *
+ * @return A pointer to the memory structure.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_jones_soa_const(const oskar_Jones* jones);
+
+/**
+ * @brief
+ * Updates the structure-of-arrays copy of the Jones data for some stations.
+ *
+ * @details
+ * Copies the Jones matrices for the given range of stations into the
+ * structure-of-arrays layout described in oskar_jones_set_soa_enabled().
+ *
+ * This function does nothing unless the structure-of-arrays copy is enabled.
+ *
+ * @param[in,out] jones          Pointer to data structure.
+ * @param[in]     station_start  Index of the first station to convert.
+ * @param[in]     num_stations   Number of stations to convert.
+ * @param[in,out] status         Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_convert_to_soa(oskar_Jones* jones, int station_start,
+        int num_stations, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -22,7 +22,8 @@
 struct DeviceData
 {
     /* Host memory. */
-    oskar_VisBlock* vis_block_cpu[2]; /* On host, for copy back & write. */
+    int num_vis_block_cpu;
+    oskar_VisBlock** vis_block_cpu; /* On host, for copy back & write. */
 
     /* Device memory. */
     int previous_chunk_index;
@@ -32,6 +33,12 @@ struct DeviceData
     oskar_Sky* chunk_clip;      /* Copy of the chunk after horizon clipping. */
     oskar_Telescope* tel;       /* Telescope model, created as a copy. */
     oskar_Jones *J, *R, *E, *K;
+    oskar_Mem *jones_chan;      /* Jones matrices for a batch of channels. */
+    oskar_Mem *jones_chan_soa;  /* As jones_chan, as structure-of-arrays. */
+    oskar_Mem *flux_chan[4];    /* Source fluxes for a batch of channels. */
+    oskar_Mem *flux[4];         /* Source fluxes from the flux table. */
+    oskar_Mem *flux_index;      /* Chunk index of each clipped source. */
+    const oskar_Mem* flux_table; /* Flux table for the current chunk. */
     oskar_Mem *gains;
     oskar_StationWork* station_work;
 
@@ -43,6 +50,7 @@ struct DeviceData
     oskar_Timer* tmr_join;      /* Time spent combining Jones matrices. */
     oskar_Timer* tmr_E;         /* Time spent evaluating E-Jones. */
     oskar_Timer* tmr_K;         /* Time spent evaluating K-Jones. */
+    oskar_Timer* tmr_stall;     /* Time spent waiting for a host buffer. */
 };
 typedef struct DeviceData DeviceData;
 
@@ -54,20 +62,24 @@ struct oskar_Interferometer
     int num_channels, num_time_steps;
     int max_sources_per_chunk, max_times_per_block, max_channels_per_block;
     int apply_horizon_clip, force_polarised_ms, zero_failed_gaussians;
-    int coords_only, ignore_w_components;
+    int coords_only, ignore_w_components, write_queue_depth;
+    int share_telescope;
+    double max_flux_table_mb;
     double freq_start_hz, freq_inc_hz, time_start_mjd_utc, time_inc_sec;
     double source_min_jy, source_max_jy;
     char correlation_type, *vis_name, *ms_name, *settings_path;
 
     /* State. */
-    int init_sky, work_unit_index;
+    int init_sky, num_work_unit_counters;
+    int* work_unit_index;       /* Index of next work unit, per block. */
     oskar_Mutex* mutex;
-    oskar_Barrier* barrier;
     oskar_Log* log;
 
     /* Sky model and telescope model. */
     int num_sources_total, num_sky_chunks;
     oskar_Sky** sky_chunks;
+    oskar_Mem** sky_horizon;    /* Horizon table for each sky chunk. */
+    oskar_Mem** sky_flux;       /* Flux table for each sky chunk. */
     oskar_Telescope* tel;
 
     /* Output data and file handles. */
@@ -77,6 +89,8 @@ struct oskar_Interferometer
     oskar_Mem *temp;
     oskar_Timer* tmr_sim;   /* The total time for the simulation. */
     oskar_Timer* tmr_write; /* The time spent writing vis blocks. */
+    int queue_max_occupancy, queue_num_samples;
+    double queue_sum_occupancy;
 
     /* Array of DeviceData structures, one per compute device. */
     DeviceData* d;
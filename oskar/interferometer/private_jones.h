@@ -38,6 +38,8 @@ struct oskar_Jones
     int cap_stations; /* Slowest varying dimension. */
     int cap_sources;  /* Fastest varying dimension. */
     oskar_Mem* data;  /* Matrix data. */
+    int soa_enabled;  /* If set, data is also held as structure-of-arrays. */
+    oskar_Mem* soa;   /* Real and imaginary parts of each matrix element. */
 };
 
 #ifndef OSKAR_JONES_TYPEDEF_
@@ -5,6 +5,7 @@
 
 #include "interferometer/oskar_evaluate_jones_E.h"
 #include "interferometer/oskar_jones_accessors.h"
+#include "interferometer/oskar_jones_soa.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,8 +29,12 @@ void oskar_evaluate_jones_E(
     if (*status) return;
     const int num_stations = oskar_telescope_num_stations(tel);
     const int num_sources = oskar_jones_num_sources(E);
-    const int n = (oskar_telescope_allow_station_beam_duplication(tel) &&
-            oskar_telescope_identical_stations(tel)) ? 1 : num_stations;
+    const oskar_Mem* classes = oskar_telescope_station_beam_class_const(tel);
+    const int* station_class = 0;
+    if (oskar_telescope_allow_station_beam_duplication(tel) &&
+            oskar_telescope_num_station_beam_classes(tel) > 0 &&
+            (int) oskar_mem_length(classes) == num_stations)
+        station_class = oskar_mem_int_const(classes, status);
     if (num_stations == 0)
     {
         *status = OSKAR_ERR_MEMORY_NOT_ALLOCATED;
@@ -41,8 +46,15 @@ void oskar_evaluate_jones_E(
         return;
     }
 
-    /* Evaluate the station beam(s). */
-    for (i = 0; i < n; ++i)
+    /* Evaluate the station beam for the first station in each class.
+     * If required, also store each one as structure-of-arrays
+     * while it is still in cache. Beams of identical tiles are shared
+     * between stations if duplication is allowed. */
+    oskar_station_work_set_tile_beam_sharing(work,
+            oskar_telescope_allow_station_beam_duplication(tel));
+    for (i = 0; i < num_stations; ++i)
+    {
+        if (station_class && station_class[i] != i) continue;
         oskar_station_beam(
                 oskar_telescope_station_const(tel, i), work,
                 coord_type, num_points, source_coords,
@@ -52,13 +64,28 @@ void oskar_evaluate_jones_E(
                 oskar_telescope_phase_centre_latitude_rad(tel),
                 time_index, gast_rad, frequency_hz,
                 i * num_sources, oskar_jones_mem(E), status);
+        oskar_jones_convert_to_soa(E, i, 1, status);
+    }
+    oskar_station_work_set_tile_beam_sharing(work, 0);
 
-    /* Copy station beam only if required. */
-    for (i = n; i < num_stations; ++i)
+    /* Copy station beams for the other stations in each class. */
+    for (i = 0; station_class && i < num_stations; ++i)
+    {
+        const int j = station_class[i];
+        if (j == i) continue;
         oskar_mem_copy_contents(
                 oskar_jones_mem(E), oskar_jones_mem(E),
-                (size_t)(i * num_sources), 0,
-                (size_t)num_sources, status);
+                (size_t) i * num_sources, (size_t) j * num_sources,
+                (size_t) num_sources, status);
+        if (oskar_jones_soa_enabled(E))
+        {
+            const size_t block_size = (size_t) oskar_jones_soa_stride(E) *
+                    (oskar_mem_is_matrix(oskar_jones_mem(E)) ? 8 : 2);
+            oskar_mem_copy_contents(
+                    oskar_jones_soa(E), oskar_jones_soa(E),
+                    i * block_size, j * block_size, block_size, status);
+        }
+    }
 }
 
 #ifdef __cplusplus
@@ -47,9 +47,34 @@ int oskar_interferometer_num_vis_blocks(const oskar_Interferometer* h)
     return t * c;
 }
 
+int oskar_interferometer_write_queue_depth(const oskar_Interferometer* h)
+{
+    return h->write_queue_depth;
+}
+
+int oskar_interferometer_share_telescope(const oskar_Interferometer* h)
+{
+    return h->share_telescope;
+}
+
+double oskar_interferometer_max_flux_table_mb(const oskar_Interferometer* h)
+{
+    return h->max_flux_table_mb;
+}
+
 void oskar_interferometer_reset_work_unit_index(oskar_Interferometer* h)
 {
-    h->work_unit_index = 0;
+    /* Each block has its own work unit index, so that different devices
+     * can be working on different blocks at the same time. */
+    const int num_blocks = oskar_interferometer_num_vis_blocks(h);
+    if (h->num_work_unit_counters != num_blocks)
+    {
+        free(h->work_unit_index);
+        h->work_unit_index = (int*) calloc(num_blocks + 1, sizeof(int));
+        h->num_work_unit_counters = h->work_unit_index ? num_blocks : 0;
+    }
+    if (h->work_unit_index)
+        memset(h->work_unit_index, 0, num_blocks * sizeof(int));
 }
 
 void oskar_interferometer_set_coords_only(oskar_Interferometer* h, int value,
@@ -159,12 +184,34 @@ void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value)
     memset(h->d, 0, h->num_devices * sizeof(DeviceData));
 }
 
+void oskar_interferometer_set_write_queue_depth(oskar_Interferometer* h,
+        int value)
+{
+    h->write_queue_depth = (value < 2) ? 2 : value;
+}
+
+void oskar_interferometer_set_share_telescope(oskar_Interferometer* h,
+        int value)
+{
+    h->share_telescope = value;
+}
+
+void oskar_interferometer_set_max_flux_table_mb(oskar_Interferometer* h,
+        double value)
+{
+    int status = 0;
+    h->max_flux_table_mb = value;
+    oskar_interferometer_free_flux_tables(h, &status);
+}
+
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels)
 {
+    int status = 0;
     h->freq_start_hz = start_hz;
     h->freq_inc_hz = inc_hz;
     h->num_channels = num_channels;
+    oskar_interferometer_free_flux_tables(h, &status);
     if (h->max_channels_per_block <= 0)
         h->max_channels_per_block = (num_channels < 8) ? num_channels : 8;
 }
@@ -197,6 +244,8 @@ void oskar_interferometer_set_sky_model(oskar_Interferometer* h,
     if (*status || !h || !sky) return;
 
     /* Clear the old chunk set. */
+    oskar_interferometer_free_flux_tables(h, status);
+    oskar_interferometer_free_horizon_tables(h, status);
     for (i = 0; i < h->num_sky_chunks; ++i)
         oskar_sky_free(h->sky_chunks[i], status);
     free(h->sky_chunks);
@@ -232,7 +281,10 @@ void oskar_interferometer_set_telescope_model(oskar_Interferometer* h,
         return;
     }
 
-    /* Remove any existing telescope model, and copy the new one. */
+    /* Remove any existing telescope model, and copy the new one.
+     * Device data must be reset, as it may refer to the old model. */
+    oskar_interferometer_free_device_data(h, status);
+    oskar_interferometer_free_horizon_tables(h, status);
     oskar_telescope_free(h->tel, status);
     h->tel = oskar_telescope_create_copy(model, OSKAR_CPU, status);
 
@@ -7,6 +7,7 @@
 
 #include "interferometer/private_interferometer.h"
 #include "interferometer/oskar_interferometer.h"
+#include "correlate/oskar_cross_correlate_simd.h"
 #include "math/oskar_cmath.h"
 #include "utility/oskar_device.h"
 #include "utility/oskar_get_memory_usage.h"
@@ -16,6 +17,8 @@ extern "C" {
 #endif
 
 static void set_up_device_data(oskar_Interferometer* h, int* status);
+static void set_up_flux_tables(oskar_Interferometer* h, int* status);
+static double flux_table_mib(const oskar_Interferometer* h);
 static void set_up_vis_header(oskar_Interferometer* h, int* status);
 
 void oskar_interferometer_check_init(oskar_Interferometer* h, int* status)
@@ -70,16 +73,77 @@ void oskar_interferometer_check_init(oskar_Interferometer* h, int* status)
         h->init_sky = 1;
     }
 
+    /* Evaluate the horizon table for each sky chunk if required. */
+    if (h->apply_horizon_clip && !h->sky_horizon && h->num_sky_chunks > 0)
+    {
+        int i;
+        h->sky_horizon = (oskar_Mem**) calloc(h->num_sky_chunks,
+                sizeof(oskar_Mem*));
+        for (i = 0; i < h->num_sky_chunks; ++i)
+        {
+            h->sky_horizon[i] = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                    0, status);
+            oskar_sky_horizon_table(h->sky_chunks[i], h->tel,
+                    h->sky_horizon[i], status);
+        }
+    }
+
+    /* Evaluate the flux table for each sky chunk if required. */
+    if (!h->sky_flux && !h->coords_only)
+        set_up_flux_tables(h, status);
+
     /* Check that each compute device has been set up. */
     set_up_device_data(h, status);
+    oskar_interferometer_reset_work_unit_index(h);
     if (!*status && !h->coords_only)
+    {
         oskar_log_section(h->log, 'M', "Starting simulation...");
+        if (h->num_devices > h->num_gpus)
+            oskar_log_message(h->log, 'M', 0,
+                    "Using %s instructions for CPU correlation.",
+                    oskar_cross_correlate_simd_isa_name(
+                            oskar_cross_correlate_simd_isa()));
+    }
 
     /* Start simulation timer. */
     oskar_timer_start(h->tmr_sim);
 }
 
 
+static void set_up_flux_tables(oskar_Interferometer* h, int* status)
+{
+    int i;
+    if (*status || h->num_sky_chunks == 0 || h->max_flux_table_mb <= 0.0)
+        return;
+
+    /* The table is only used by CPU devices, and only if it is not
+     * too large. */
+    if (h->num_devices <= h->num_gpus ||
+            flux_table_mib(h) > h->max_flux_table_mb)
+        return;
+
+    /* Evaluate source fluxes for all channels. */
+    h->sky_flux = (oskar_Mem**) calloc(h->num_sky_chunks, sizeof(oskar_Mem*));
+    for (i = 0; i < h->num_sky_chunks; ++i)
+    {
+        h->sky_flux[i] = oskar_mem_create(h->prec, OSKAR_CPU, 0, status);
+        oskar_sky_flux_table(h->sky_chunks[i], h->num_channels,
+                h->freq_start_hz, h->freq_inc_hz, h->sky_flux[i], status);
+    }
+}
+
+
+static double flux_table_mib(const oskar_Interferometer* h)
+{
+    int i;
+    size_t num_bytes = 0;
+    for (i = 0; i < h->num_sky_chunks; ++i)
+        num_bytes += (size_t) 4 * h->num_channels *
+                oskar_sky_num_sources(h->sky_chunks[i]) *
+                oskar_mem_element_size(h->prec);
+    return num_bytes / (1024.0 * 1024.0);
+}
+
 
 static void set_up_vis_header(oskar_Interferometer* h, int* status)
 {
@@ -169,7 +233,7 @@ typedef struct ThreadArgs ThreadArgs;
 
 static void* init_device(void* arg)
 {
-    int dev_loc, vistype, *status;
+    int j, dev_loc, vistype, *status;
     ThreadArgs* a = (ThreadArgs*)arg;
     oskar_Interferometer* h = a->h;
     DeviceData* d = a->d;
@@ -205,21 +269,29 @@ static void* init_device(void* arg)
         d->tmr_K         = oskar_timer_create(dev_loc);
         d->tmr_join      = oskar_timer_create(dev_loc);
         d->tmr_correlate = oskar_timer_create(dev_loc);
+        d->tmr_stall     = oskar_timer_create(OSKAR_TIMER_NATIVE);
     }
 
     /* Visibility blocks. */
     if (!d->vis_block)
-    {
         d->vis_block = oskar_vis_block_create_from_header(dev_loc,
                 h->header, status);
-        d->vis_block_cpu[0] = oskar_vis_block_create_from_header(OSKAR_CPU,
-                h->header, status);
-        d->vis_block_cpu[1] = oskar_vis_block_create_from_header(OSKAR_CPU,
-                h->header, status);
-    }
     oskar_vis_block_clear(d->vis_block, status);
-    oskar_vis_block_clear(d->vis_block_cpu[0], status);
-    oskar_vis_block_clear(d->vis_block_cpu[1], status);
+
+    /* Host visibility blocks, one for each slot in the write queue. */
+    if (d->num_vis_block_cpu != h->write_queue_depth)
+    {
+        for (j = h->write_queue_depth; j < d->num_vis_block_cpu; ++j)
+            oskar_vis_block_free(d->vis_block_cpu[j], status);
+        d->vis_block_cpu = (oskar_VisBlock**) realloc(d->vis_block_cpu,
+                h->write_queue_depth * sizeof(oskar_VisBlock*));
+        for (j = d->num_vis_block_cpu; j < h->write_queue_depth; ++j)
+            d->vis_block_cpu[j] = oskar_vis_block_create_from_header(
+                    OSKAR_CPU, h->header, status);
+        d->num_vis_block_cpu = h->write_queue_depth;
+    }
+    for (j = 0; j < d->num_vis_block_cpu; ++j)
+        oskar_vis_block_clear(d->vis_block_cpu[j], status);
 
     /* Device scratch memory. */
     if (!d->tel)
@@ -230,18 +302,34 @@ static void* init_device(void* arg)
         d->lmn[0] = oskar_mem_create(h->prec, dev_loc, 1 + num_src, status);
         d->lmn[1] = oskar_mem_create(h->prec, dev_loc, 1 + num_src, status);
         d->lmn[2] = oskar_mem_create(h->prec, dev_loc, 1 + num_src, status);
-        d->chunk = oskar_sky_create(h->prec, dev_loc, num_src, status);
+        /* On the host, the sky chunk can refer to the shared chunks
+         * directly, rather than being a full copy of each one. */
+        d->chunk = (dev_loc == OSKAR_CPU) ?
+                oskar_sky_create_view(h->prec, dev_loc, status) :
+                oskar_sky_create(h->prec, dev_loc, num_src, status);
         d->chunk_clip = oskar_sky_create(h->prec, dev_loc, num_src, status);
-        d->tel = oskar_telescope_create_copy(h->tel, dev_loc, status);
-        d->J = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                status);
+        d->tel = (dev_loc == OSKAR_CPU && h->share_telescope) ? h->tel :
+                oskar_telescope_create_copy(h->tel, dev_loc, status);
+        /* J and K are not used by the fused correlator, so they are
+         * only sized when they are first needed. */
+        d->J = oskar_jones_create(vistype, dev_loc, num_stations, 0, status);
         d->R = oskar_type_is_matrix(vistype) ? oskar_jones_create(vistype,
                 dev_loc, num_stations, num_src, status) : 0;
         d->E = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
                 status);
-        d->K = oskar_jones_create(complx, dev_loc, num_stations, num_src,
-                status);
+        d->K = oskar_jones_create(complx, dev_loc, num_stations, 0, status);
         d->gains = oskar_mem_create(vistype, dev_loc, num_stations, status);
+        d->jones_chan = oskar_mem_create(vistype, dev_loc, 0, status);
+        d->jones_chan_soa = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_chan[0] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_chan[1] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_chan[2] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_chan[3] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux[0] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux[1] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux[2] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux[3] = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_index = oskar_mem_create(OSKAR_INT, dev_loc, 0, status);
         d->station_work = oskar_station_work_create(h->prec, dev_loc, status);
         oskar_station_work_set_tec_screen_common_params(d->station_work,
                 oskar_telescope_ionosphere_screen_type(d->tel),
@@ -251,6 +339,9 @@ static void* init_device(void* arg)
         if (oskar_telescope_ionosphere_screen_type(d->tel) == 'E')
             oskar_station_work_set_tec_screen_path(d->station_work,
                     oskar_telescope_tec_screen_path(d->tel));
+        oskar_station_work_set_beam_interpolation(d->station_work,
+                oskar_telescope_station_beam_interp_samples(d->tel),
+                oskar_telescope_station_beam_interp_cache_mb(d->tel));
     }
     return 0;
 }
@@ -297,6 +388,32 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
         for (i = 0; i < h->num_gpus; ++i)
             oskar_device_log_mem(h->dev_loc, 0, h->gpu_ids[i], h->log);
         oskar_log_mem(h->log);
+
+        /* Report the memory saved by sharing the telescope model. */
+        int num_shared = 0;
+        for (i = 0; i < num_devices; ++i)
+            if (h->d[i].tel == h->tel) num_shared++;
+        if (num_shared > 0)
+        {
+            const double tel_mib =
+                    oskar_telescope_memory_size(h->tel) / (1024.0 * 1024.0);
+            oskar_log_value(h->log, 'M', 0, "Telescope model",
+                    "%.2f MiB, shared by %d CPU threads", tel_mib, num_shared);
+            oskar_log_value(h->log, 'M', 0, "Telescope memory saved",
+                    "%.2f MiB", tel_mib * num_shared);
+        }
+
+        /* Report the size of the source flux table, or why it is unused. */
+        if (h->sky_flux)
+            oskar_log_value(h->log, 'M', 0, "Source flux table",
+                    "%.2f MiB for %d channels", flux_table_mib(h),
+                    h->num_channels);
+        else if (h->num_devices > h->num_gpus && !h->coords_only &&
+                h->max_flux_table_mb > 0.0 &&
+                flux_table_mib(h) > h->max_flux_table_mb)
+            oskar_log_value(h->log, 'M', 0, "Source flux table",
+                    "not used (needs %.2f MiB, limit %.2f MiB)",
+                    flux_table_mib(h), h->max_flux_table_mb);
     }
 }
 
@@ -23,7 +23,6 @@ oskar_Interferometer* oskar_interferometer_create(int precision, int* status)
     h->tmr_write = oskar_timer_create(OSKAR_TIMER_NATIVE);
     h->temp      = oskar_mem_create(precision, OSKAR_CPU, 0, status);
     h->mutex     = oskar_mutex_create();
-    h->barrier   = oskar_barrier_create(0);
     h->log       = oskar_log_create(OSKAR_LOG_MESSAGE, OSKAR_LOG_WARNING);
 
     /* Get number of devices available, and device location. */
@@ -38,6 +37,9 @@ oskar_Interferometer* oskar_interferometer_create(int precision, int* status)
     oskar_interferometer_set_horizon_clip(h, 1);
     oskar_interferometer_set_source_flux_range(h, -DBL_MAX, DBL_MAX);
     oskar_interferometer_set_max_times_per_block(h, 8);
+    oskar_interferometer_set_write_queue_depth(h, 2);
+    oskar_interferometer_set_share_telescope(h, 1);
+    oskar_interferometer_set_max_flux_table_mb(h, 1024.0);
     return h;
 }
 
@@ -127,7 +127,7 @@ static void record_timing(oskar_Interferometer* h)
     /* Obtain component times. */
     int i;
     double t_copy = 0., t_clip = 0., t_E = 0., t_K = 0., t_join = 0.;
-    double t_correlate = 0., t_compute = 0., t_components = 0.;
+    double t_correlate = 0., t_compute = 0., t_components = 0., t_stall = 0.;
     double *compute_times;
     compute_times = (double*) calloc(h->num_devices, sizeof(double));
     for (i = 0; i < h->num_devices; ++i)
@@ -140,6 +140,7 @@ static void record_timing(oskar_Interferometer* h)
         t_K += oskar_timer_elapsed(h->d[i].tmr_K);
         t_correlate += oskar_timer_elapsed(h->d[i].tmr_correlate);
         t_compute += compute_times[i];
+        t_stall += oskar_timer_elapsed(h->d[i].tmr_stall);
     }
     t_components = t_copy + t_clip + t_E + t_K + t_join + t_correlate;
 
@@ -152,6 +153,17 @@ static void record_timing(oskar_Interferometer* h)
                 compute_times[i], i);
     oskar_log_value(h->log, 'M', 0, "Write", "%.3f s",
             oskar_timer_elapsed(h->tmr_write));
+    if (h->queue_num_samples > 0)
+    {
+        oskar_log_message(h->log, 'M', 0, "Write queue (depth %i):",
+                h->write_queue_depth);
+        oskar_log_value(h->log, 'M', 1, "Mean blocks queued", "%.2f",
+                h->queue_sum_occupancy / h->queue_num_samples);
+        oskar_log_value(h->log, 'M', 1, "Max blocks queued", "%i",
+                h->queue_max_occupancy);
+        oskar_log_value(h->log, 'M', 1, "Compute stall",
+                "%.3f s per device", t_stall / h->num_devices);
+    }
     oskar_log_message(h->log, 'M', 0, "Compute components:");
     oskar_log_value(h->log, 'M', 1, "Copy", "%4.1f%%",
             (t_copy / t_compute) * 100.0);
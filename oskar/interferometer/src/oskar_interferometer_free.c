@@ -19,6 +19,8 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
     int i;
     if (!h) return;
     oskar_interferometer_reset_cache(h, status);
+    oskar_interferometer_free_flux_tables(h, status);
+    oskar_interferometer_free_horizon_tables(h, status);
     for (i = 0; i < h->num_sky_chunks; ++i)
         oskar_sky_free(h->sky_chunks[i], status);
     oskar_telescope_free(h->tel, status);
@@ -26,7 +28,7 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
     oskar_timer_free(h->tmr_sim);
     oskar_timer_free(h->tmr_write);
     oskar_mutex_free(h->mutex);
-    oskar_barrier_free(h->barrier);
+    free(h->work_unit_index);
     oskar_log_free(h->log);
     free(h->sky_chunks);
     free(h->gpu_ids);
@@ -39,7 +41,7 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
 
 void oskar_interferometer_free_device_data(oskar_Interferometer* h, int* status)
 {
-    int i;
+    int i, j;
     if (!h->d) return;
     for (i = 0; i < h->num_devices; ++i)
     {
@@ -54,8 +56,10 @@ void oskar_interferometer_free_device_data(oskar_Interferometer* h, int* status)
         oskar_timer_free(d->tmr_K);
         oskar_timer_free(d->tmr_join);
         oskar_timer_free(d->tmr_correlate);
-        oskar_vis_block_free(d->vis_block_cpu[0], status);
-        oskar_vis_block_free(d->vis_block_cpu[1], status);
+        oskar_timer_free(d->tmr_stall);
+        for (j = 0; j < d->num_vis_block_cpu; ++j)
+            oskar_vis_block_free(d->vis_block_cpu[j], status);
+        free(d->vis_block_cpu);
         oskar_vis_block_free(d->vis_block, status);
         oskar_mem_free(d->lmn[0], status);
         oskar_mem_free(d->lmn[1], status);
@@ -65,17 +69,51 @@ void oskar_interferometer_free_device_data(oskar_Interferometer* h, int* status)
         oskar_mem_free(d->uvw[2], status);
         oskar_sky_free(d->chunk, status);
         oskar_sky_free(d->chunk_clip, status);
-        oskar_telescope_free(d->tel, status);
+        if (d->tel != h->tel)
+            oskar_telescope_free(d->tel, status);
         oskar_station_work_free(d->station_work, status);
         oskar_jones_free(d->J, status);
         oskar_jones_free(d->E, status);
         oskar_jones_free(d->K, status);
         oskar_jones_free(d->R, status);
         oskar_mem_free(d->gains, status);
+        oskar_mem_free(d->jones_chan, status);
+        oskar_mem_free(d->jones_chan_soa, status);
+        oskar_mem_free(d->flux_chan[0], status);
+        oskar_mem_free(d->flux_chan[1], status);
+        oskar_mem_free(d->flux_chan[2], status);
+        oskar_mem_free(d->flux_chan[3], status);
+        oskar_mem_free(d->flux[0], status);
+        oskar_mem_free(d->flux[1], status);
+        oskar_mem_free(d->flux[2], status);
+        oskar_mem_free(d->flux[3], status);
+        oskar_mem_free(d->flux_index, status);
         memset(d, 0, sizeof(DeviceData));
     }
 }
 
+void oskar_interferometer_free_flux_tables(oskar_Interferometer* h,
+        int* status)
+{
+    int i;
+    if (!h->sky_flux) return;
+    for (i = 0; i < h->num_sky_chunks; ++i)
+        oskar_mem_free(h->sky_flux[i], status);
+    free(h->sky_flux);
+    h->sky_flux = 0;
+}
+
+void oskar_interferometer_free_horizon_tables(oskar_Interferometer* h,
+        int* status)
+{
+    int i;
+    if (!h->sky_horizon) return;
+    for (i = 0; i < h->num_sky_chunks; ++i)
+        oskar_mem_free(h->sky_horizon[i], status);
+    free(h->sky_horizon);
+    h->sky_horizon = 0;
+}
+
 void oskar_interferometer_reset_cache(oskar_Interferometer* h, int* status)
 {
     oskar_interferometer_free_device_data(h, status);
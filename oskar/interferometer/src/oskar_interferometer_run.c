@@ -16,10 +16,18 @@
 extern "C" {
 #endif
 
+struct Scheduler
+{
+    int* num_devices_done;        /* Number of devices finished, per block. */
+    oskar_Counter* num_complete;  /* Number of blocks fully simulated. */
+    oskar_Counter* num_written;   /* Number of blocks written. */
+};
+typedef struct Scheduler Scheduler;
+
 struct ThreadArgs
 {
     oskar_Interferometer* h;
-    DeviceData* d;
+    Scheduler* sched;
     int num_threads, thread_id, *status;
 };
 typedef struct ThreadArgs ThreadArgs;
@@ -27,10 +35,12 @@ typedef struct ThreadArgs ThreadArgs;
 static void* run_blocks(void* arg)
 {
     oskar_Interferometer* h;
+    Scheduler* sched;
     int b, *status;
 
     /* Get thread function arguments. */
     h = ((ThreadArgs*)arg)->h;
+    sched = ((ThreadArgs*)arg)->sched;
     const int num_threads = ((ThreadArgs*)arg)->num_threads;
     const int thread_id = ((ThreadArgs*)arg)->thread_id;
     const int device_id = thread_id - 1;
@@ -42,38 +52,70 @@ static void* run_blocks(void* arg)
     omp_set_num_threads(1);
 #endif
 
-    /* Loop over visibility blocks, running simulation and file
-     * writing one block at a time. Simulation and file output are overlapped
-     * by using double buffering, and a dedicated thread is used for file
-     * output.
+    /* Loop over visibility blocks. Simulation and file output are
+     * overlapped by using double buffering, and a dedicated thread is used
+     * for file output.
      *
      * Thread 0 is used for file writes.
      * Threads 1 to n (mapped to compute devices) do the simulation.
      *
-     * Note that no write is launched on the first loop counter (as no
-     * data are ready yet) and no simulation is performed for the last loop
-     * counter (which corresponds to the last block + 1) as this iteration
-     * simply writes the last block.
+     * There are no barriers between blocks: as soon as a device has no more
+     * work units to claim in one block, it moves on to the next, while
+     * other devices may still be finishing their last work unit in the
+     * previous block. The last device to finish a block marks it as
+     * complete, which allows the write thread to finalise and write it.
+     *
+     * Each device has a ring of host buffers, which forms a queue of
+     * completed blocks waiting to be written. A device only waits if the
+     * host buffer it needs for the next block still holds a block that
+     * has not yet been written (i.e. the queue is full).
      */
     const int num_blocks = oskar_interferometer_num_vis_blocks(h);
-    for (b = 0; b < num_blocks + 1; ++b)
+    if (num_threads == 1)
     {
-        if ((thread_id > 0 || num_threads == 1) && b < num_blocks)
-            oskar_interferometer_run_block(h, b, device_id, status);
-        if (thread_id == 0 && b > 0)
+        for (b = 0; b < num_blocks; ++b)
         {
             oskar_VisBlock* block;
-            block = oskar_interferometer_finalise_block(h, b - 1, status);
-            oskar_interferometer_write_block(h, block, b - 1, status);
+            oskar_interferometer_run_block(h, b, device_id, status);
+            block = oskar_interferometer_finalise_block(h, b, status);
+            oskar_interferometer_write_block(h, block, b, status);
         }
+    }
+    else if (thread_id > 0)
+    {
+        DeviceData* d = &h->d[device_id];
+        for (b = 0; b < num_blocks; ++b)
+        {
+            /* Wait until the host buffer for this block is free. */
+            oskar_timer_resume(d->tmr_stall);
+            oskar_counter_wait(sched->num_written,
+                    b - d->num_vis_block_cpu + 1);
+            oskar_timer_pause(d->tmr_stall);
+            oskar_interferometer_run_block(h, b, device_id, status);
 
-        /* Barrier 1: Reset work unit index and print status. */
-        oskar_barrier_wait(h->barrier);
-        if (thread_id == 0)
-            oskar_interferometer_reset_work_unit_index(h);
-
-        /* Barrier 2: Synchronise before moving to the next block. */
-        oskar_barrier_wait(h->barrier);
+            /* Mark the block as complete if all devices have finished. */
+            if (oskar_atomic_fetch_add(&sched->num_devices_done[b], 1) ==
+                    num_threads - 2)
+                oskar_counter_add(sched->num_complete, 1);
+        }
+    }
+    else
+    {
+        for (b = 0; b < num_blocks; ++b)
+        {
+            oskar_VisBlock* block;
+            oskar_counter_wait(sched->num_complete, b + 1);
+
+            /* Record the number of completed blocks not yet written. */
+            const int queued = oskar_counter_value(sched->num_complete) - b;
+            if (queued > h->queue_max_occupancy)
+                h->queue_max_occupancy = queued;
+            h->queue_sum_occupancy += queued;
+            h->queue_num_samples++;
+            block = oskar_interferometer_finalise_block(h, b, status);
+            oskar_interferometer_write_block(h, block, b, status);
+            oskar_counter_add(sched->num_written, 1);
+        }
     }
     return 0;
 }
@@ -84,6 +126,7 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     int i;
     oskar_Thread** threads = 0;
     ThreadArgs* args = 0;
+    Scheduler sched;
     if (*status || !h) return;
 
     /* Check the visibilities are going somewhere. */
@@ -106,14 +149,22 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     /* Initialise if required. */
     oskar_interferometer_check_init(h, status);
 
+    /* Set up the block scheduler. */
+    h->queue_max_occupancy = h->queue_num_samples = 0;
+    h->queue_sum_occupancy = 0.0;
+    sched.num_devices_done = (int*) calloc(
+            oskar_interferometer_num_vis_blocks(h) + 1, sizeof(int));
+    sched.num_complete = oskar_counter_create();
+    sched.num_written = oskar_counter_create();
+
     /* Set up worker threads. */
     const int num_threads = h->num_devices + 1;
-    oskar_barrier_set_num_threads(h->barrier, num_threads);
     threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
     args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
     for (i = 0; i < num_threads; ++i)
     {
         args[i].h = h;
+        args[i].sched = &sched;
         args[i].num_threads = num_threads;
         args[i].thread_id = i;
         args[i].status = status;
@@ -132,6 +183,9 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     }
     free(threads);
     free(args);
+    free(sched.num_devices_done);
+    oskar_counter_free(sched.num_complete);
+    oskar_counter_free(sched.num_written);
 
     /* Finalise. */
     oskar_interferometer_finalise(h, status);
@@ -11,12 +11,20 @@
 #include "convert/oskar_convert_mjd_to_gast_fast.h"
 #include "correlate/oskar_auto_correlate.h"
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_fused.h"
+#include "correlate/oskar_cross_correlate_simd.h"
 #include "interferometer/oskar_evaluate_jones_R.h"
 #include "interferometer/oskar_evaluate_jones_Z.h"
 #include "interferometer/oskar_evaluate_jones_E.h"
 #include "interferometer/oskar_evaluate_jones_K.h"
 #include "utility/oskar_device.h"
 
+#include <float.h>
+#include <string.h>
+
+/* Maximum memory used to store Jones matrices for a batch of channels. */
+#define MAX_CHANNEL_BATCH_BYTES ((size_t) 256 * 1024 * 1024)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,6 +32,32 @@ extern "C" {
 static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
         oskar_Sky* sky, int channel_index_block, int time_index_block,
         int channel_index_sim, int time_index_sim, int* status);
+static void sim_baselines_channels(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, int channel_index_block, int num_channels,
+        int time_index_block, int channel_index_sim, int time_index_sim,
+        int* status);
+static void evaluate_coords(oskar_Interferometer* h, DeviceData* d,
+        const oskar_Sky* sky, int time_index_sim, double gast_rad,
+        const oskar_Mem* lmn[3], int* status);
+static const oskar_Jones* evaluate_station_beams(DeviceData* d,
+        const oskar_Sky* sky, int time_index_sim, double gast_rad,
+        double freq_hz, int* status);
+static void get_source_fluxes(const oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, int channel_index_sim, const oskar_Mem* src_flux[4],
+        int* status);
+static void set_flux_index(DeviceData* d, int num_in, int* status);
+static void resize_jones(oskar_Jones** jones, int num_stations,
+        int num_sources, int* status);
+static void copy_to_channel(oskar_Mem* dst, const oskar_Mem* src,
+        int num_elements, int num_channels, int channel, int* status);
+static void copy_to_channel_soa(oskar_Mem* dst, const oskar_Jones* src,
+        int num_channels, int channel, int* status);
+static int use_fused_correlator(const oskar_Interferometer* h,
+        const DeviceData* d);
+static int use_simd_correlator(const oskar_Interferometer* h,
+        const DeviceData* d);
+static int channel_batch_size(const oskar_Interferometer* h,
+        const DeviceData* d, const oskar_Sky* sky, int num_chans_block);
 static unsigned int disp_width(unsigned int v);
 
 void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
@@ -43,6 +77,13 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
         return;
     }
 
+    /* Check the block index is valid. */
+    if (block_index < 0 || block_index >= h->num_work_unit_counters)
+    {
+        *status = OSKAR_ERR_OUT_OF_RANGE;
+        return;
+    }
+
     /* Set the GPU to use. (Supposed to be a very low-overhead call.) */
     if (device_id >= 0 && device_id < h->num_gpus)
         oskar_device_set(h->dev_loc, h->gpu_ids[device_id], status);
@@ -62,6 +103,7 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     const int i_block_time = block_index / num_blocks_chan;
     const double obs_start_mjd = h->time_start_mjd_utc;
     const double dt_dump_days = h->time_inc_sec / 86400.0;
+    const int sky_is_view = (oskar_sky_mem_location(d->chunk) == OSKAR_CPU);
     chan_index_start = i_block_chan * h->max_channels_per_block;
     chan_index_end = chan_index_start + h->max_channels_per_block - 1;
     time_index_start = i_block_time * h->max_times_per_block;
@@ -80,15 +122,15 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     oskar_vis_block_set_start_channel_index(d->vis_block, chan_index_start);
 
     /* Go though all possible work units in the block. A work unit is defined
-     * as the simulation for one time and one sky chunk. */
+     * as the simulation for one time and one sky chunk.
+     * Work units are claimed without locking, using the block's own index. */
     while (!h->coords_only)
     {
         oskar_Sky* sky;
         int i_channel;
 
-        oskar_mutex_lock(h->mutex);
-        const int i_work_unit = (h->work_unit_index)++;
-        oskar_mutex_unlock(h->mutex);
+        const int i_work_unit =
+                oskar_atomic_fetch_add(&h->work_unit_index[block_index], 1);
         if ((i_work_unit >= num_times_block * total_chunks) || *status) break;
 
         /* Convert slice index to chunk/time index. */
@@ -96,14 +138,21 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
         const int i_time       = i_work_unit - i_chunk * num_times_block;
         const int sim_time_idx = time_index_start + i_time;
 
-        /* Copy sky chunk to device only if different from the previous one. */
+        /* Copy sky chunk to device only if different from the previous one.
+         * On the host, the horizon clip reads the shared chunk directly,
+         * and otherwise only the source fluxes need to be copied. */
         if (i_chunk != d->previous_chunk_index)
         {
             oskar_timer_resume(d->tmr_copy);
-            oskar_sky_copy(d->chunk, h->sky_chunks[i_chunk], status);
+            if (!sky_is_view)
+                oskar_sky_copy(d->chunk, h->sky_chunks[i_chunk], status);
+            else if (!h->apply_horizon_clip)
+                oskar_sky_set_view(d->chunk, h->sky_chunks[i_chunk], status);
             oskar_timer_pause(d->tmr_copy);
         }
         sky = h->apply_horizon_clip ? d->chunk_clip : d->chunk;
+        d->flux_table = (sky_is_view && h->sky_flux) ?
+                h->sky_flux[i_chunk] : 0;
 
         /* Apply horizon clip if required. */
         if (h->apply_horizon_clip)
@@ -112,32 +161,62 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
             mjd = obs_start_mjd + dt_dump_days * (sim_time_idx + 0.5);
             gast = oskar_convert_mjd_to_gast_fast(mjd);
             oskar_timer_resume(d->tmr_clip);
-            oskar_sky_horizon_clip(d->chunk_clip, d->chunk, d->tel, gast,
-                    d->station_work, status);
+            if (sky_is_view && h->sky_horizon)
+                oskar_sky_horizon_clip_table(d->chunk_clip,
+                        h->sky_chunks[i_chunk], h->sky_horizon[i_chunk],
+                        d->tel, gast, d->station_work, status);
+            else
+                oskar_sky_horizon_clip(d->chunk_clip,
+                        sky_is_view ? h->sky_chunks[i_chunk] : d->chunk,
+                        d->tel, gast, d->station_work, status);
+            if (d->flux_table)
+                set_flux_index(d, oskar_sky_num_sources(
+                        h->sky_chunks[i_chunk]), status);
             oskar_timer_pause(d->tmr_clip);
         }
 
-        /* Simulate all baselines for all channels for this time and chunk. */
-        for (i_channel = 0; i_channel < num_chans_block; ++i_channel)
+        /* Simulate all baselines for all channels for this time and chunk.
+         * If possible, channels are processed in batches, to avoid
+         * a separate pass over the sources for each channel. */
+        const int num_chans_batch =
+                channel_batch_size(h, d, sky, num_chans_block);
+        for (i_channel = 0; i_channel < num_chans_block;
+                i_channel += num_chans_batch)
         {
             if (*status) break;
             const int sim_chan_idx = chan_index_start + i_channel;
+            int num_chans = num_chans_block - i_channel;
+            if (num_chans > num_chans_batch) num_chans = num_chans_batch;
             oskar_mutex_lock(h->mutex);
-            oskar_log_message(h->log, 'S', 1, "Time %*i/%i, "
-                    "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
-                    disp_width(total_times), sim_time_idx + 1, total_times,
-                    disp_width(total_chunks), i_chunk + 1, total_chunks,
-                    disp_width(total_chans), sim_chan_idx + 1, total_chans,
-                    device_id, oskar_sky_num_sources(sky));
+            if (num_chans > 1)
+                oskar_log_message(h->log, 'S', 1, "Time %*i/%i, "
+                        "Chunk %*i/%i, Channels %*i-%*i/%i "
+                        "[Device %i, %i sources]",
+                        disp_width(total_times), sim_time_idx + 1, total_times,
+                        disp_width(total_chunks), i_chunk + 1, total_chunks,
+                        disp_width(total_chans), sim_chan_idx + 1,
+                        disp_width(total_chans), sim_chan_idx + num_chans,
+                        total_chans, device_id, oskar_sky_num_sources(sky));
+            else
+                oskar_log_message(h->log, 'S', 1, "Time %*i/%i, "
+                        "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
+                        disp_width(total_times), sim_time_idx + 1, total_times,
+                        disp_width(total_chunks), i_chunk + 1, total_chunks,
+                        disp_width(total_chans), sim_chan_idx + 1, total_chans,
+                        device_id, oskar_sky_num_sources(sky));
             oskar_mutex_unlock(h->mutex);
-            sim_baselines(h, d, sky, i_channel, i_time,
-                    sim_chan_idx, sim_time_idx, status);
+            if (num_chans > 1)
+                sim_baselines_channels(h, d, sky, i_channel, num_chans,
+                        i_time, sim_chan_idx, sim_time_idx, status);
+            else
+                sim_baselines(h, d, sky, i_channel, i_time,
+                        sim_chan_idx, sim_time_idx, status);
         }
         d->previous_chunk_index = i_chunk;
     }
 
     /* Copy the visibility block to host memory. */
-    const int i_active = block_index % 2; /* Index of the active buffer. */
+    const int i_active = block_index % d->num_vis_block_cpu;
     oskar_timer_resume(d->tmr_copy);
     oskar_vis_block_copy(d->vis_block_cpu[i_active], d->vis_block, status);
     oskar_timer_pause(d->tmr_copy);
@@ -170,26 +249,266 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     const double gast_rad = oskar_convert_mjd_to_gast_fast(t_dump);
     const double freq = h->freq_start_hz + channel_index_sim * h->freq_inc_hz;
 
-    /* Scale source fluxes with spectral index and rotation measure. */
-    oskar_sky_scale_flux_with_frequency(sky, freq, status);
-    const oskar_Mem* const src_flux[] = {
-            oskar_sky_I_const(sky),
-            oskar_sky_Q_const(sky),
-            oskar_sky_U_const(sky),
-            oskar_sky_V_const(sky)
-    };
+    /* Get source fluxes with spectral index and rotation measure. */
+    const oskar_Mem* src_flux[4];
+    get_source_fluxes(h, d, sky, channel_index_sim, src_flux, status);
+
+    /* Get station (u,v,w) coordinates and source direction cosines. */
+    const oskar_Mem* lmn[3];
+    const oskar_Mem* const uvw[] = { d->uvw[0], d->uvw[1], d->uvw[2] };
+    evaluate_coords(h, d, sky, time_index_sim, gast_rad, lmn, status);
+
+    /* Evaluate station beams, also as structure-of-arrays if they will
+     * be used by the vectorised correlator. */
+    const int use_simd = use_simd_correlator(h, d);
+    oskar_jones_set_soa_enabled(d->R ? d->R : d->E, use_simd, status);
+    evaluate_station_beams(d, sky, time_index_sim, gast_rad, freq, status);
+
+    /* Use the fused correlator if possible: this evaluates the
+     * interferometer phase per baseline, so K-Jones is never stored. */
+    if (use_fused_correlator(h, d))
+    {
+        const oskar_Jones* J = d->R ? d->R : d->E;
+        const int offset = num_chans_block * time_index_block +
+                channel_index_block;
+        oskar_timer_resume(d->tmr_correlate);
+        if (oskar_vis_block_has_auto_correlations(d->vis_block))
+            oskar_auto_correlate(num_src, J, src_flux, num_stations * offset,
+                    oskar_vis_block_auto_correlations(d->vis_block), status);
+        if (oskar_vis_block_has_cross_correlations(d->vis_block))
+        {
+            const oskar_Mem* const src_extended[] = {
+                oskar_sky_gaussian_a_const(sky),
+                oskar_sky_gaussian_b_const(sky),
+                oskar_sky_gaussian_c_const(sky)
+            };
+            if (use_simd)
+                oskar_cross_correlate_fused_soa(
+                        oskar_sky_use_extended(sky), num_src, 1,
+                        oskar_jones_soa_const(J), oskar_jones_soa_stride(J),
+                        src_flux, 0, lmn, src_extended,
+                        h->source_min_jy, h->source_max_jy,
+                        h->ignore_w_components, d->tel, uvw,
+                        gast_rad, freq, 0.0, num_baselines * offset,
+                        oskar_vis_block_cross_correlations(d->vis_block),
+                        status);
+            else
+                oskar_cross_correlate_fused(
+                        oskar_sky_use_extended(sky), num_src, J,
+                        src_flux, lmn, src_extended,
+                        h->source_min_jy, h->source_max_jy,
+                        h->ignore_w_components, d->tel, uvw,
+                        gast_rad, freq, num_baselines * offset,
+                        oskar_vis_block_cross_correlations(d->vis_block),
+                        status);
+        }
+        oskar_timer_pause(d->tmr_correlate);
+        return;
+    }
+
+    /* Set dimensions of Jones matrices.
+     * These are only allocated here, as the fused correlator needs neither. */
+    resize_jones(&d->J, num_stations, num_src, status);
+    resize_jones(&d->K, num_stations, num_src, status);
+
+    /* Evaluate interferometer phase (Jones K: scalar). */
+    oskar_timer_resume(d->tmr_K);
+    oskar_evaluate_jones_K(d->K, num_src,
+            lmn[0], lmn[1], lmn[2], uvw[0], uvw[1], uvw[2],
+            freq, src_flux[0], h->source_min_jy, h->source_max_jy,
+            h->ignore_w_components, status);
+    oskar_timer_pause(d->tmr_K);
+
+    /* Multiply Jones matrix chain to get a single block. */
+    oskar_timer_resume(d->tmr_join);
+    oskar_jones_join(d->J, d->K, d->R ? d->R : d->E, status);
+    oskar_timer_pause(d->tmr_join);
+
+    /* Check whether gain model exists.
+     * If so, evaluate gains and apply them. */
+    if (oskar_gains_defined(oskar_telescope_gains(d->tel)))
+    {
+        oskar_gains_evaluate(oskar_telescope_gains(d->tel),
+                time_index_sim, freq, d->gains, status);
+        oskar_jones_apply_station_gains(d->J, d->gains, status);
+    }
+
+    /* Calculate output offset. */
+    const int offset = num_chans_block * time_index_block + channel_index_block;
+    oskar_timer_resume(d->tmr_correlate);
+
+    /* Auto-correlate for this time and channel. */
+    if (oskar_vis_block_has_auto_correlations(d->vis_block))
+        oskar_auto_correlate(num_src, d->J, src_flux, num_stations * offset,
+                oskar_vis_block_auto_correlations(d->vis_block), status);
+
+    /* Cross-correlate for this time and channel. */
+    if (oskar_vis_block_has_cross_correlations(d->vis_block))
+    {
+        const int source_type = oskar_sky_use_extended(sky);
+        const oskar_Mem* const src_extended[] = {
+            oskar_sky_gaussian_a_const(sky),
+            oskar_sky_gaussian_b_const(sky),
+            oskar_sky_gaussian_c_const(sky)
+        };
+        oskar_cross_correlate(
+                source_type, num_src, d->J,
+                src_flux, lmn, src_extended,
+                d->tel, uvw,
+                gast_rad, freq, num_baselines * offset,
+                oskar_vis_block_cross_correlations(d->vis_block), status);
+    }
+    oskar_timer_pause(d->tmr_correlate);
+}
+
+
+static void sim_baselines_channels(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, int channel_index_block, int num_channels,
+        int time_index_block, int channel_index_sim, int time_index_sim,
+        int* status)
+{
+    int c, i;
+
+    /* Get dimensions. */
+    const int num_baselines   = oskar_telescope_num_baselines(d->tel);
+    const int num_stations    = oskar_telescope_num_stations(d->tel);
+    const int num_src         = oskar_sky_num_sources(sky);
+    const int num_times_block = oskar_vis_block_num_times(d->vis_block);
+    const int num_chans_block = oskar_vis_block_num_channels(d->vis_block);
+
+    /* Return if there are no sources in the chunk,
+     * or if block indices requested are outside the block dimensions. */
+    if (num_src == 0 ||
+            time_index_block >= num_times_block ||
+            channel_index_block + num_channels > num_chans_block)
+        return;
+
+    /* Get the time and start frequency of the visibilities to simulate. */
+    const double dt_dump_days = h->time_inc_sec / 86400.0;
+    const double t_start = h->time_start_mjd_utc;
+    const double t_dump = t_start + dt_dump_days * (time_index_sim + 0.5);
+    const double gast_rad = oskar_convert_mjd_to_gast_fast(t_dump);
+    const double freq_start = h->freq_start_hz +
+            channel_index_sim * h->freq_inc_hz;
+
+    /* Get station (u,v,w) coordinates and source direction cosines.
+     * These are the same for all channels. */
+    const oskar_Mem* lmn[3];
+    const oskar_Mem* const uvw[] = { d->uvw[0], d->uvw[1], d->uvw[2] };
+    evaluate_coords(h, d, sky, time_index_sim, gast_rad, lmn, status);
+
+    /* Resize arrays to hold Jones matrices and fluxes for all channels.
+     * The vectorised correlator needs structure-of-arrays Jones matrices,
+     * and fluxes stored with channel as the slowest-varying dimension. */
+    const int use_simd = use_simd_correlator(h, d);
+    oskar_jones_set_soa_enabled(d->R ? d->R : d->E, use_simd, status);
+    if (use_simd)
+        oskar_mem_ensure(d->jones_chan_soa,
+                (size_t) num_stations * num_channels * 8 *
+                oskar_jones_soa_stride(d->R ? d->R : d->E), status);
+    else
+        oskar_mem_ensure(d->jones_chan,
+                (size_t) num_stations * num_src * num_channels, status);
+    for (i = 0; i < 4; ++i)
+        oskar_mem_ensure(d->flux_chan[i],
+                (size_t) num_src * num_channels, status);
+
+    /* Evaluate the station beams and source fluxes for each channel. */
+    const int offset = num_chans_block * time_index_block +
+            channel_index_block;
+    for (c = 0; c < num_channels; ++c)
+    {
+        const double freq = freq_start + c * h->freq_inc_hz;
+
+        /* Get source fluxes with spectral index and rotation measure. */
+        const oskar_Mem* src_flux[4];
+        get_source_fluxes(h, d, sky, channel_index_sim + c, src_flux, status);
+        const oskar_Jones* J = evaluate_station_beams(d, sky,
+                time_index_sim, gast_rad, freq, status);
+
+        /* Auto-correlate for this time and channel. */
+        if (oskar_vis_block_has_auto_correlations(d->vis_block))
+        {
+            oskar_timer_resume(d->tmr_correlate);
+            oskar_auto_correlate(num_src, J, src_flux,
+                    num_stations * (offset + c),
+                    oskar_vis_block_auto_correlations(d->vis_block), status);
+            oskar_timer_pause(d->tmr_correlate);
+        }
+
+        /* Store the Jones matrices and fluxes for this channel. */
+        oskar_timer_resume(d->tmr_join);
+        if (use_simd)
+        {
+            copy_to_channel_soa(d->jones_chan_soa, J, num_channels, c, status);
+            for (i = 0; i < 4; ++i)
+                oskar_mem_copy_contents(d->flux_chan[i], src_flux[i],
+                        (size_t) c * num_src, 0, num_src, status);
+        }
+        else
+        {
+            copy_to_channel(d->jones_chan, oskar_jones_mem_const(J),
+                    num_stations * num_src, num_channels, c, status);
+            for (i = 0; i < 4; ++i)
+                copy_to_channel(d->flux_chan[i], src_flux[i],
+                        num_src, num_channels, c, status);
+        }
+        oskar_timer_pause(d->tmr_join);
+    }
+
+    /* Cross-correlate for this time and all channels. */
+    if (oskar_vis_block_has_cross_correlations(d->vis_block))
+    {
+        const oskar_Mem* const src_flux[] = {
+                d->flux_chan[0], d->flux_chan[1],
+                d->flux_chan[2], d->flux_chan[3]
+        };
+        const oskar_Mem* const src_extended[] = {
+                oskar_sky_gaussian_a_const(sky),
+                oskar_sky_gaussian_b_const(sky),
+                oskar_sky_gaussian_c_const(sky)
+        };
+        oskar_timer_resume(d->tmr_correlate);
+        if (use_simd)
+            oskar_cross_correlate_fused_soa(
+                    oskar_sky_use_extended(sky), num_src, num_channels,
+                    d->jones_chan_soa,
+                    oskar_jones_soa_stride(d->R ? d->R : d->E),
+                    src_flux, num_src, lmn, src_extended,
+                    h->source_min_jy, h->source_max_jy,
+                    h->ignore_w_components, d->tel, uvw,
+                    gast_rad, freq_start, h->freq_inc_hz,
+                    num_baselines * offset,
+                    oskar_vis_block_cross_correlations(d->vis_block), status);
+        else
+            oskar_cross_correlate_fused_channels(
+                    oskar_sky_use_extended(sky), num_src, num_channels,
+                    d->jones_chan, src_flux, lmn, src_extended,
+                    h->source_min_jy, h->source_max_jy,
+                    h->ignore_w_components, d->tel, uvw,
+                    gast_rad, freq_start, h->freq_inc_hz,
+                    num_baselines * offset,
+                    oskar_vis_block_cross_correlations(d->vis_block), status);
+        oskar_timer_pause(d->tmr_correlate);
+    }
+}
+
+
+static void evaluate_coords(oskar_Interferometer* h, DeviceData* d,
+        const oskar_Sky* sky, int time_index_sim, double gast_rad,
+        const oskar_Mem* lmn[3], int* status)
+{
+    const int num_src = oskar_sky_num_sources(sky);
 
     /* Get true station (u,v,w) coordinates. */
     oskar_telescope_uvw(d->tel,
             1, /* Use true coordinates. */
             0, /* Do not ignore w-components. */
             1, /* Single time sample. */
-            t_start, dt_dump_days, time_index_sim,
+            h->time_start_mjd_utc, h->time_inc_sec / 86400.0, time_index_sim,
             d->uvw[0], d->uvw[1], d->uvw[2], 0, 0, 0, status);
-    const oskar_Mem* const uvw[] = { d->uvw[0], d->uvw[1], d->uvw[2] };
 
     /* Get source direction cosines. */
-    const oskar_Mem* lmn[3];
     if (oskar_telescope_phase_centre_coord_type(d->tel) == OSKAR_COORDS_AZEL)
     {
         /* Calculate ENU source direction cosines for array centre. */
@@ -211,13 +530,20 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
         lmn[1] = oskar_sky_m_const(sky);
         lmn[2] = oskar_sky_n_const(sky);
     }
+}
+
+
+static const oskar_Jones* evaluate_station_beams(DeviceData* d,
+        const oskar_Sky* sky, int time_index_sim, double gast_rad,
+        double freq_hz, int* status)
+{
+    const int num_stations = oskar_telescope_num_stations(d->tel);
+    const int num_src = oskar_sky_num_sources(sky);
 
     /* Set dimensions of Jones matrices. */
     if (d->R)
         oskar_jones_set_size(d->R, num_stations, num_src, status);
-    oskar_jones_set_size(d->J, num_stations, num_src, status);
     oskar_jones_set_size(d->E, num_stations, num_src, status);
-    oskar_jones_set_size(d->K, num_stations, num_src, status);
 
     /* Evaluate station beam (Jones E: may be matrix). */
     const oskar_Mem* const source_coords[] = {
@@ -228,7 +554,8 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     oskar_timer_resume(d->tmr_E);
     oskar_evaluate_jones_E(d->E, OSKAR_COORDS_REL_DIR, num_src, source_coords,
             oskar_sky_reference_ra_rad(sky), oskar_sky_reference_dec_rad(sky),
-            d->tel, time_index_sim, gast_rad, freq, d->station_work, status);
+            d->tel, time_index_sim, gast_rad, freq_hz, d->station_work,
+            status);
     oskar_timer_pause(d->tmr_E);
 
     /* Evaluate parallactic angle (Jones R: matrix), and join with Jones E.
@@ -245,55 +572,167 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
         oskar_jones_join(d->R, d->E, d->R, status);
         oskar_timer_pause(d->tmr_join);
     }
+    return d->R ? d->R : d->E;
+}
 
-    /* Evaluate interferometer phase (Jones K: scalar). */
-    oskar_timer_resume(d->tmr_K);
-    oskar_evaluate_jones_K(d->K, num_src,
-            lmn[0], lmn[1], lmn[2], uvw[0], uvw[1], uvw[2],
-            freq, src_flux[0], h->source_min_jy, h->source_max_jy,
-            h->ignore_w_components, status);
-    oskar_timer_pause(d->tmr_K);
 
-    /* Multiply Jones matrix chain to get a single block. */
-    oskar_timer_resume(d->tmr_join);
-    oskar_jones_join(d->J, d->K, d->R ? d->R : d->E, status);
-    oskar_timer_pause(d->tmr_join);
+static void get_source_fluxes(const oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, int channel_index_sim, const oskar_Mem* src_flux[4],
+        int* status)
+{
+    int i, j;
+    const int num_src = oskar_sky_num_sources(sky);
 
-    /* Check whether gain model exists.
-     * If so, evaluate gains and apply them. */
-    if (oskar_gains_defined(oskar_telescope_gains(d->tel)))
+    /* Scale the fluxes in the sky model if there is no flux table. */
+    if (!d->flux_table)
     {
-        oskar_gains_evaluate(oskar_telescope_gains(d->tel),
-                time_index_sim, freq, d->gains, status);
-        oskar_jones_apply_station_gains(d->J, d->gains, status);
+        oskar_sky_scale_flux_with_frequency(sky, h->freq_start_hz +
+                channel_index_sim * h->freq_inc_hz, status);
+        src_flux[0] = oskar_sky_I_const(sky);
+        src_flux[1] = oskar_sky_Q_const(sky);
+        src_flux[2] = oskar_sky_U_const(sky);
+        src_flux[3] = oskar_sky_V_const(sky);
+        return;
     }
 
-    /* Calculate output offset. */
-    const int offset = num_chans_block * time_index_block + channel_index_block;
-    oskar_timer_resume(d->tmr_correlate);
+    /* Otherwise, look up the fluxes of the sources in the table.
+     * If the sky model has been clipped, use the index of each source. */
+    const size_t num_src_table = oskar_mem_length(d->flux_table) /
+            (4 * (size_t) h->num_channels);
+    const int* index = h->apply_horizon_clip ?
+            oskar_mem_int_const(d->flux_index, status) : 0;
+    for (i = 0; i < 4; ++i)
+    {
+        const size_t offset = num_src_table *
+                ((size_t) i * h->num_channels + channel_index_sim);
+        src_flux[i] = d->flux[i];
+        oskar_mem_ensure(d->flux[i], num_src, status);
+        if (*status) continue;
+        if (!index)
+            oskar_mem_copy_contents(d->flux[i], d->flux_table,
+                    0, offset, num_src, status);
+        else if (h->prec == OSKAR_DOUBLE)
+        {
+            const double* in =
+                    oskar_mem_double_const(d->flux_table, status) + offset;
+            double* out = oskar_mem_double(d->flux[i], status);
+            for (j = 0; j < num_src; ++j) out[j] = in[index[j]];
+        }
+        else
+        {
+            const float* in =
+                    oskar_mem_float_const(d->flux_table, status) + offset;
+            float* out = oskar_mem_float(d->flux[i], status);
+            for (j = 0; j < num_src; ++j) out[j] = in[index[j]];
+        }
+    }
+}
 
-    /* Auto-correlate for this time and channel. */
-    if (oskar_vis_block_has_auto_correlations(d->vis_block))
-        oskar_auto_correlate(num_src, d->J, src_flux, num_stations * offset,
-                oskar_vis_block_auto_correlations(d->vis_block), status);
 
-    /* Cross-correlate for this time and channel. */
-    if (oskar_vis_block_has_cross_correlations(d->vis_block))
+static void set_flux_index(DeviceData* d, int num_in, int* status)
+{
+    int i, j = 0;
+    oskar_mem_ensure(d->flux_index, num_in, status);
+    if (*status) return;
+    const int* mask = oskar_mem_int_const(
+            oskar_station_work_horizon_mask(d->station_work), status);
+    int* index = oskar_mem_int(d->flux_index, status);
+    for (i = 0; i < num_in; ++i)
+        if (mask[i]) index[j++] = i;
+}
+
+
+static void resize_jones(oskar_Jones** jones, int num_stations,
+        int num_sources, int* status)
+{
+    if (*status) return;
+    const size_t required = (size_t) num_stations * (size_t) num_sources;
+    if (oskar_mem_length(oskar_jones_mem(*jones)) < required)
     {
-        const int source_type = oskar_sky_use_extended(sky);
-        const oskar_Mem* const src_extended[] = {
-            oskar_sky_gaussian_a_const(sky),
-            oskar_sky_gaussian_b_const(sky),
-            oskar_sky_gaussian_c_const(sky)
-        };
-        oskar_cross_correlate(
-                source_type, num_src, d->J,
-                src_flux, lmn, src_extended,
-                d->tel, uvw,
-                gast_rad, freq, num_baselines * offset,
-                oskar_vis_block_cross_correlations(d->vis_block), status);
+        const int type = oskar_jones_type(*jones);
+        const int location = oskar_jones_mem_location(*jones);
+        oskar_jones_free(*jones, status);
+        *jones = oskar_jones_create(type, location,
+                num_stations, num_sources, status);
     }
-    oskar_timer_pause(d->tmr_correlate);
+    oskar_jones_set_size(*jones, num_stations, num_sources, status);
+}
+
+
+static void copy_to_channel(oskar_Mem* dst, const oskar_Mem* src,
+        int num_elements, int num_channels, int channel, int* status)
+{
+    int i;
+    if (*status) return;
+    const size_t element_size = oskar_mem_element_size(oskar_mem_type(src));
+    const char* in = (const char*) oskar_mem_void_const(src);
+    char* out = (char*) oskar_mem_void(dst) + channel * element_size;
+    const size_t stride = num_channels * element_size;
+    for (i = 0; i < num_elements; ++i)
+        memcpy(out + i * stride, in + i * element_size, element_size);
+}
+
+
+static void copy_to_channel_soa(oskar_Mem* dst, const oskar_Jones* src,
+        int num_channels, int channel, int* status)
+{
+    int i;
+    if (*status) return;
+    const int num_stations = oskar_jones_num_stations(src);
+    const size_t block_size = (size_t) 8 * oskar_jones_soa_stride(src);
+    for (i = 0; i < num_stations; ++i)
+        oskar_mem_copy_contents(dst, oskar_jones_soa_const(src),
+                ((size_t) i * num_channels + channel) * block_size,
+                i * block_size, block_size, status);
+}
+
+
+static int use_fused_correlator(const oskar_Interferometer* h,
+        const DeviceData* d)
+{
+    /* The fused correlator is only available on the CPU, and can only be
+     * used if there are no other terms to apply after K-Jones. */
+    if (oskar_jones_mem_location(d->E) != OSKAR_CPU ||
+            oskar_gains_defined(oskar_telescope_gains_const(d->tel)))
+        return 0;
+
+    /* Auto-correlations are formed from the same Jones matrices,
+     * so they would not have the source flux filter applied. */
+    if (oskar_vis_block_has_auto_correlations(d->vis_block) &&
+            (h->source_min_jy > -DBL_MAX || h->source_max_jy < DBL_MAX))
+        return 0;
+    return 1;
+}
+
+
+static int use_simd_correlator(const oskar_Interferometer* h,
+        const DeviceData* d)
+{
+    /* The vectorised correlator is used for polarised visibilities
+     * if the processor supports it. */
+    return use_fused_correlator(h, d) &&
+            oskar_type_is_matrix(oskar_jones_type(d->E)) &&
+            oskar_cross_correlate_simd_isa() > OSKAR_SIMD_NONE;
+}
+
+
+static int channel_batch_size(const oskar_Interferometer* h,
+        const DeviceData* d, const oskar_Sky* sky, int num_chans_block)
+{
+    /* Channels can only be batched using the fused correlator. */
+    if (num_chans_block <= 1 || !use_fused_correlator(h, d)) return 1;
+
+    /* Limit the memory needed to store Jones matrices for all channels. */
+    const size_t num_src = (size_t) oskar_sky_num_sources(sky);
+    const size_t bytes_per_channel = num_src * (
+            oskar_telescope_num_stations(d->tel) *
+            oskar_mem_element_size(oskar_jones_type(d->E)) +
+            4 * oskar_mem_element_size(h->prec));
+    if (bytes_per_channel == 0) return num_chans_block;
+    const size_t max_channels = MAX_CHANNEL_BATCH_BYTES / bytes_per_channel;
+    if (max_channels < 1) return 1;
+    return (max_channels < (size_t) num_chans_block) ?
+            (int) max_channels : num_chans_block;
 }
 
 
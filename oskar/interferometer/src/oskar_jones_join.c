@@ -57,6 +57,7 @@ void oskar_jones_join(oskar_Jones* j3, oskar_Jones* j1, const oskar_Jones* j2,
     const size_t num_elements = n_sources1 * n_stations1;
     oskar_mem_multiply(j3->data, j1->data, j2->data,
             0, 0, 0, num_elements, status);
+    oskar_jones_convert_to_soa(j3, 0, n_stations3, status);
 }
 
 #ifdef __cplusplus
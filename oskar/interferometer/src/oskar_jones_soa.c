@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "interferometer/private_jones.h"
+#include "interferometer/oskar_jones.h"
+
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Copies complex values into separate real and imaginary arrays. */
+#define JONES_TO_SOA(FP, NUM_ARRAYS) {\
+        const FP* in_ = (const FP*) oskar_mem_void_const(jones->data);\
+        FP* out_ = (FP*) oskar_mem_void(jones->soa);\
+        for (s = station_start; s < station_end; ++s) {\
+            const FP* in = in_ + (size_t) s * num_sources * NUM_ARRAYS;\
+            FP* out = out_ + (size_t) s * stride * NUM_ARRAYS;\
+            for (i = 0; i < num_sources; ++i) {\
+                for (j = 0; j < NUM_ARRAYS; ++j)\
+                    out[j * stride + i] = in[i * NUM_ARRAYS + j];\
+            }\
+            for (j = 0; j < NUM_ARRAYS; ++j)\
+                memset(out + j * stride + num_sources, 0,\
+                        (stride - num_sources) * sizeof(FP));\
+        }}\
+
+void oskar_jones_set_soa_enabled(oskar_Jones* jones, int value, int* status)
+{
+    if (*status) return;
+    if (value && oskar_mem_location(jones->data) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    jones->soa_enabled = value;
+    if (value && !jones->soa)
+    {
+        const int num_arrays = oskar_mem_is_matrix(jones->data) ? 8 : 2;
+        const size_t num_elements = (size_t) jones->cap_stations *
+                oskar_jones_soa_stride(jones) * num_arrays;
+        jones->soa = oskar_mem_create(oskar_mem_precision(jones->data),
+                OSKAR_CPU, num_elements, status);
+        oskar_mem_clear_contents(jones->soa, status);
+    }
+}
+
+int oskar_jones_soa_enabled(const oskar_Jones* jones)
+{
+    return jones->soa_enabled;
+}
+
+int oskar_jones_soa_stride(const oskar_Jones* jones)
+{
+    return (jones->cap_sources + 15) & ~15;
+}
+
+oskar_Mem* oskar_jones_soa(oskar_Jones* jones)
+{
+    return jones->soa;
+}
+
+const oskar_Mem* oskar_jones_soa_const(const oskar_Jones* jones)
+{
+    return jones->soa;
+}
+
+void oskar_jones_convert_to_soa(oskar_Jones* jones, int station_start,
+        int num_stations, int* status)
+{
+    int s, i, j;
+    if (*status || !jones->soa_enabled) return;
+    const int num_sources = jones->num_sources;
+    const int stride = oskar_jones_soa_stride(jones);
+    const int station_end = station_start + num_stations;
+    if (station_start < 0 || station_end > jones->num_stations)
+    {
+        *status = OSKAR_ERR_OUT_OF_RANGE;
+        return;
+    }
+    switch (oskar_mem_type(jones->data))
+    {
+    case OSKAR_SINGLE_COMPLEX_MATRIX:
+        JONES_TO_SOA(float, 8)
+        break;
+    case OSKAR_DOUBLE_COMPLEX_MATRIX:
+        JONES_TO_SOA(double, 8)
+        break;
+    case OSKAR_SINGLE_COMPLEX:
+        JONES_TO_SOA(float, 2)
+        break;
+    case OSKAR_DOUBLE_COMPLEX:
+        JONES_TO_SOA(double, 2)
+        break;
+    default:
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        break;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
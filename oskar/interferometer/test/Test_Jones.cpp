@@ -881,6 +881,85 @@ TEST(Jones, set_ones_doubleGPU)
 
 #endif /* OSKAR_HAVE_CUDA */
 
+static void test_soa(int type)
+{
+    int status = 0;
+    const int num_sources = sources - 10;
+    oskar_Jones* jones = oskar_jones_create(type, OSKAR_CPU,
+            stations, sources, &status);
+    oskar_Jones* other = oskar_jones_create(type, OSKAR_CPU,
+            stations, sources, &status);
+    oskar_jones_set_size(jones, stations, num_sources, &status);
+    oskar_jones_set_size(other, stations, num_sources, &status);
+    srand(2);
+    oskar_mem_random_range(oskar_jones_mem(jones), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_jones_mem(other), 1.0, 2.0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Conversion should do nothing until enabled.
+    oskar_jones_convert_to_soa(jones, 0, stations, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(oskar_jones_soa_const(jones) == 0);
+
+    // Check the stride covers all sources, and convert.
+    const int stride = oskar_jones_soa_stride(jones);
+    EXPECT_GE(stride, sources);
+    EXPECT_EQ(0, stride % 16);
+    oskar_jones_set_soa_enabled(jones, 1, &status);
+    EXPECT_TRUE(oskar_jones_soa_enabled(jones) != 0);
+    oskar_jones_convert_to_soa(jones, 0, stations, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check stations out of range are rejected.
+    oskar_jones_convert_to_soa(jones, 1, stations, &status);
+    EXPECT_EQ((int) OSKAR_ERR_OUT_OF_RANGE, status);
+    status = 0;
+
+    // Joining should also update the structure-of-arrays copy.
+    oskar_jones_join(jones, jones, other, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the contents, including zero padding.
+    const int num_arrays = oskar_mem_is_matrix(oskar_jones_mem(jones)) ?
+            8 : 2;
+    const int double_precision = oskar_mem_is_double(oskar_jones_mem(jones));
+    const void* aos = oskar_mem_void_const(oskar_jones_mem(jones));
+    const void* soa = oskar_mem_void_const(oskar_jones_soa_const(jones));
+    for (int st = 0; st < stations; ++st)
+    {
+        for (int j = 0; j < num_arrays; ++j)
+        {
+            const size_t out = ((size_t) st * num_arrays + j) * stride;
+            for (int i = 0; i < stride; ++i)
+            {
+                const size_t in = ((size_t) st * num_sources + i) *
+                        num_arrays + j;
+                if (double_precision)
+                    EXPECT_EQ(i < num_sources ? ((const double*) aos)[in] :
+                            0.0, ((const double*) soa)[out + i]);
+                else
+                    EXPECT_EQ(i < num_sources ? ((const float*) aos)[in] :
+                            0.0f, ((const float*) soa)[out + i]);
+            }
+        }
+    }
+    oskar_jones_free(jones, &status);
+    oskar_jones_free(other, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(Jones, soa_singleCPU)
+{
+    test_soa(SC);
+    test_soa(SCM);
+}
+
+TEST(Jones, soa_doubleCPU)
+{
+    test_soa(DC);
+    test_soa(DCM);
+}
+
 TEST(Jones, set_ones_singleCPU)
 {
     test_ones(OSKAR_SINGLE, OSKAR_CPU);
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/*
+ * DFT using supplied weights, for CPUs.
+ *
+ * This is included by each translation unit that implements the DFT for
+ * a particular instruction set. The VEC template parameter is a wrapper
+ * around the native vector type, as described in math/define_simd_math.h.
+ *
+ * Output points are processed in blocks. Within each block, the phase
+ * factors for each input are evaluated for all outputs at once, either by
+ * complex rotation if the output coordinates are evenly spaced (as they
+ * are along the rows of a regular grid), or otherwise using vectorised
+ * sincos. The phase factors are then applied to the input data, which is
+ * contiguous in the output dimension.
+ */
+
+#ifndef OSKAR_DEFINE_DFTW_SIMD_H_
+#define OSKAR_DEFINE_DFTW_SIMD_H_
+
+#include "oskar_global.h"
+#include "math/define_simd_math.h"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+/* Number of output points in each block: a multiple of all vector widths.
+ * This also limits the length of each phase rotation sequence. */
+#define OSKAR_DFTW_SIMD_BLOCK 64
+
+/* Returns true if the n values are evenly spaced, to within rounding,
+ * and sets the spacing. */
+template<typename REAL>
+inline bool oskar_dftw_simd_is_linear(const REAL* v, int n, double* inc)
+{
+    *inc = 0.0;
+    if (n < 2) return true;
+    const double v0 = v[0], v1 = v[n - 1];
+    const double tol = 4.0 * std::numeric_limits<REAL>::epsilon() *
+            (std::fabs(v0) + std::fabs(v1));
+    *inc = (v1 - v0) / (n - 1);
+    for (int k = 1; k < n - 1; ++k)
+        if (std::fabs(v[k] - (v0 + k * *inc)) > tol) return false;
+    return true;
+}
+
+template<typename VEC, bool IS_3D, bool IS_MATRIX, typename REAL2>
+void oskar_dftw_simd(
+        const int                                 num_in,
+        const typename VEC::real                  wavenumber,
+        const REAL2* const RESTRICT               weights_in,
+        const typename VEC::real* const RESTRICT  x_in,
+        const typename VEC::real* const RESTRICT  y_in,
+        const typename VEC::real* const RESTRICT  z_in,
+        const int                                 offset_coord_out,
+        const int                                 num_out,
+        const typename VEC::real* const RESTRICT  x_out,
+        const typename VEC::real* const RESTRICT  y_out,
+        const typename VEC::real* const RESTRICT  z_out,
+        const int* const RESTRICT                 data_idx,
+        const REAL2* const RESTRICT               data,
+        const int                                 eval_x,
+        const int                                 eval_y,
+        const int                                 offset_out,
+        REAL2* RESTRICT                           output,
+        const typename VEC::real                  norm_factor)
+{
+    typedef typename VEC::real REAL;
+    typedef typename VEC::type V;
+    enum { B = OSKAR_DFTW_SIMD_BLOCK };
+    const int num_pols = IS_MATRIX ? 4 : 1;
+    const int pol_start = (IS_MATRIX && !eval_x) ? 2 : 0;
+    const int pol_end = (IS_MATRIX && eval_y) ? 4 : (IS_MATRIX ? 2 : 1);
+    const int num_blocks = (num_out + B - 1) / B;
+    int b;
+#pragma omp parallel for private(b)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int i, k, p;
+        REAL xo[B], yo[B], zo[B], p_re[B], p_im[B], acc[8][B];
+        const int o0 = b * B;
+        const int nb = (num_out - o0 < (int) B) ? num_out - o0 : (int) B;
+        const REAL* xs = x_out + offset_coord_out + o0;
+        const REAL* ys = y_out + offset_coord_out + o0;
+        const REAL* zs = IS_3D ? z_out + offset_coord_out + o0 : 0;
+        for (k = 0; k < (int) B; ++k)
+        {
+            xo[k] = (k < nb) ? wavenumber * xs[k] : (REAL) 0;
+            yo[k] = (k < nb) ? wavenumber * ys[k] : (REAL) 0;
+            zo[k] = (IS_3D && k < nb) ? wavenumber * zs[k] : (REAL) 0;
+        }
+        for (p = 2 * pol_start; p < 2 * pol_end; ++p)
+            for (k = 0; k < nb; ++k) acc[p][k] = (REAL) 0;
+
+        /* Check if the phase factors can be found by rotation. */
+        double dx = 0.0, dy = 0.0, dz = 0.0;
+        const bool linear = nb > 2 &&
+                oskar_dftw_simd_is_linear(xs, nb, &dx) &&
+                oskar_dftw_simd_is_linear(ys, nb, &dy) &&
+                (!IS_3D || oskar_dftw_simd_is_linear(zs, nb, &dz));
+        dx *= wavenumber; dy *= wavenumber; dz *= wavenumber;
+        const double x0 = (double) wavenumber * xs[0];
+        const double y0 = (double) wavenumber * ys[0];
+        const double z0 = IS_3D ? (double) wavenumber * zs[0] : 0.0;
+
+        for (i = 0; i < num_in; ++i)
+        {
+            const REAL2 w = weights_in[i];
+
+            /* Evaluate the weighted phase factor for each output. */
+            if (linear)
+            {
+                /* Rotate by a constant phase increment, in double
+                 * precision. The rotation sequence restarts for each block,
+                 * which limits the accumulated rounding error. */
+                double t0 = x0 * x_in[i] + y0 * y_in[i];
+                double dt = dx * x_in[i] + dy * y_in[i];
+                if (IS_3D)
+                {
+                    t0 += z0 * z_in[i];
+                    dt += dz * z_in[i];
+                }
+                const double c0 = std::cos(t0), s0 = std::sin(t0);
+                const double c_inc = std::cos(dt), s_inc = std::sin(dt);
+                double re = c0 * w.x - s0 * w.y;
+                double im = s0 * w.x + c0 * w.y;
+                for (k = 0; k < nb; ++k)
+                {
+                    p_re[k] = (REAL) re;
+                    p_im[k] = (REAL) im;
+                    const double t = re * c_inc - im * s_inc;
+                    im = re * s_inc + im * c_inc;
+                    re = t;
+                }
+            }
+            else
+            {
+                const V xi = VEC::set1(x_in[i]), yi = VEC::set1(y_in[i]);
+                const V zi = VEC::set1(IS_3D ? z_in[i] : (REAL) 0);
+                const V w_re = VEC::set1(w.x), w_im = VEC::set1(w.y);
+                for (k = 0; k < nb; k += VEC::width)
+                {
+                    V s, c, t = VEC::mul(VEC::load(xo + k), xi);
+                    t = VEC::fmadd(VEC::load(yo + k), yi, t);
+                    if (IS_3D) t = VEC::fmadd(VEC::load(zo + k), zi, t);
+                    VEC::sincos(t, s, c);
+                    VEC::store(p_re + k,
+                            VEC::fnmadd(s, w_im, VEC::mul(c, w_re)));
+                    VEC::store(p_im + k,
+                            VEC::fmadd(c, w_im, VEC::mul(s, w_re)));
+                }
+            }
+
+            /* Apply the phase factors to the input data. */
+            const size_t j = (size_t) (data_idx ? data_idx[i] : i);
+            const REAL2* d = data + num_pols * (j * num_out + o0);
+            for (p = pol_start; p < pol_end; ++p)
+            {
+                REAL* const RESTRICT a_re = acc[2 * p];
+                REAL* const RESTRICT a_im = acc[2 * p + 1];
+                for (k = 0; k < nb; ++k)
+                {
+                    const REAL2 in = d[num_pols * k + p];
+                    a_re[k] += in.x * p_re[k] - in.y * p_im[k];
+                    a_im[k] += in.y * p_re[k] + in.x * p_im[k];
+                }
+            }
+        }
+
+        /* Store the output. */
+        for (k = 0; k < nb; ++k)
+        {
+            for (p = pol_start; p < pol_end; ++p)
+            {
+                REAL2 out;
+                out.x = acc[2 * p][k] * norm_factor;
+                out.y = acc[2 * p + 1][k] * norm_factor;
+                output[num_pols * (o0 + k + offset_out) + p] = out;
+            }
+        }
+    }
+}
+
+/* Defines a C function for one instruction set and precision.
+ * The parameters are as for oskar_dftw_simd_f(). */
+#define OSKAR_DFTW_SIMD_DEFINE(NAME, VEC, FP, FP2)                          \
+void NAME(int is_3d, int is_matrix, int num_in, FP wavenumber,              \
+        const FP2* weights_in, const FP* x_in, const FP* y_in,              \
+        const FP* z_in, int offset_coord_out, int num_out,                  \
+        const FP* x_out, const FP* y_out, const FP* z_out,                  \
+        const int* data_idx, const FP2* data, int eval_x, int eval_y,       \
+        int offset_out, FP2* output, FP norm_factor)                        \
+{                                                                           \
+    if (is_3d && is_matrix)                                                 \
+        oskar_dftw_simd<VEC, true, true>(OSKAR_DFTW_SIMD_ARGS);             \
+    else if (is_3d)                                                         \
+        oskar_dftw_simd<VEC, true, false>(OSKAR_DFTW_SIMD_ARGS);            \
+    else if (is_matrix)                                                     \
+        oskar_dftw_simd<VEC, false, true>(OSKAR_DFTW_SIMD_ARGS);            \
+    else                                                                    \
+        oskar_dftw_simd<VEC, false, false>(OSKAR_DFTW_SIMD_ARGS);           \
+}
+
+#define OSKAR_DFTW_SIMD_ARGS num_in, wavenumber, weights_in,                \
+        x_in, y_in, z_in, offset_coord_out, num_out, x_out, y_out, z_out,   \
+        data_idx, data, eval_x, eval_y, offset_out, output, norm_factor
+
+#endif /* include guard */
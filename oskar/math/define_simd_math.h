@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/*
+ * Vector maths functions, templated on a wrapper around a native
+ * vector type. The VEC template parameter must provide:
+ *
+ *   typedef real, type, mask; enum { width };
+ *   set1, load, store, add, sub, mul, div,
+ *   fmadd (a * b + c), fnmadd (c - a * b), round, floor,
+ *   cmp_eq, cmp_lt, cmp_le, mask_and, mask_or,
+ *   select (mask ? a : b), pow2n (2^n, for integral n), reduce_add,
+ *   sincos and exp.
+ *
+ * Wrappers for each instruction set are in private_simd_*.h, and must
+ * only be included by translation units compiled for that instruction set.
+ * Their sincos and exp functions are implemented using
+ * oskar_simd_math<real>, below.
+ */
+
+#ifndef OSKAR_DEFINE_SIMD_MATH_H_
+#define OSKAR_DEFINE_SIMD_MATH_H_
+
+/* Quadrant selection for sincos, after reduction to [-pi/4, pi/4].
+ * Uses floating-point operations only, so no integer vectors are needed. */
+template<typename VEC>
+inline void oskar_simd_sincos_quadrant(typename VEC::type q,
+        typename VEC::type sin_r, typename VEC::type cos_r,
+        typename VEC::type& s, typename VEC::type& c)
+{
+    typedef typename VEC::type V;
+    const V zero = VEC::set1(0), one = VEC::set1(1), two = VEC::set1(2);
+    const V qm = VEC::fnmadd(VEC::set1(4),
+            VEC::floor(VEC::mul(q, VEC::set1(0.25))), q);
+    const typename VEC::mask odd = VEC::cmp_eq(
+            VEC::fnmadd(two, VEC::floor(VEC::mul(qm, VEC::set1(0.5))), qm),
+            one);
+    s = VEC::select(odd, cos_r, sin_r);
+    c = VEC::select(odd, sin_r, cos_r);
+    s = VEC::select(VEC::cmp_le(two, qm), VEC::sub(zero, s), s);
+    c = VEC::select(VEC::mask_or(VEC::cmp_eq(qm, one), VEC::cmp_eq(qm, two)),
+            VEC::sub(zero, c), c);
+}
+
+template<typename REAL>
+struct oskar_simd_math;
+
+template<>
+struct oskar_simd_math<double>
+{
+    /* Cody-Waite reduction using a three-part pi/2 with FMA, then
+     * minimax polynomials on [-pi/4, pi/4] (as used in fdlibm). */
+    template<typename VEC>
+    static inline void sincos(typename VEC::type x,
+            typename VEC::type& s, typename VEC::type& c)
+    {
+        typedef typename VEC::type V;
+        const V q = VEC::round(VEC::mul(x, VEC::set1(0.6366197723675814)));
+        V r = VEC::fnmadd(q, VEC::set1(1.5707963267948966), x);
+        r = VEC::fnmadd(q, VEC::set1(6.123233995736766e-17), r);
+        r = VEC::fnmadd(q, VEC::set1(-1.4973849048591698e-33), r);
+        const V z = VEC::mul(r, r);
+        V ps = VEC::set1(1.58969099521155010221e-10);
+        ps = VEC::fmadd(ps, z, VEC::set1(-2.50507602534068634195e-08));
+        ps = VEC::fmadd(ps, z, VEC::set1(2.75573137070700676789e-06));
+        ps = VEC::fmadd(ps, z, VEC::set1(-1.98412698298579493134e-04));
+        ps = VEC::fmadd(ps, z, VEC::set1(8.33333333332248946124e-03));
+        ps = VEC::fmadd(ps, z, VEC::set1(-1.66666666666666324348e-01));
+        ps = VEC::fmadd(VEC::mul(ps, z), r, r);
+        V pc = VEC::set1(-1.13596475577881948265e-11);
+        pc = VEC::fmadd(pc, z, VEC::set1(2.08757232129817482790e-09));
+        pc = VEC::fmadd(pc, z, VEC::set1(-2.75573143513906633035e-07));
+        pc = VEC::fmadd(pc, z, VEC::set1(2.48015872894767294178e-05));
+        pc = VEC::fmadd(pc, z, VEC::set1(-1.38888888888741095749e-03));
+        pc = VEC::fmadd(pc, z, VEC::set1(4.16666666666666019037e-02));
+        pc = VEC::fmadd(VEC::mul(pc, z), z,
+                VEC::fnmadd(VEC::set1(0.5), z, VEC::set1(1)));
+        oskar_simd_sincos_quadrant<VEC>(q, ps, pc, s, c);
+    }
+
+    /* Evaluates exp(x) for x <= 0. */
+    template<typename VEC>
+    static inline typename VEC::type exp(typename VEC::type x)
+    {
+        typedef typename VEC::type V;
+        const V lo = VEC::set1(-708.0);
+        x = VEC::select(VEC::cmp_lt(x, lo), lo, x);
+        const V n = VEC::round(VEC::mul(x, VEC::set1(1.4426950408889634)));
+        V r = VEC::fnmadd(n, VEC::set1(6.93145751953125e-1), x);
+        r = VEC::fnmadd(n, VEC::set1(1.42860682030941723212e-6), r);
+        V p = VEC::set1(1.0 / 6227020800.0);
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 479001600.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 39916800.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 3628800.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 362880.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 40320.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 5040.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 720.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 120.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 24.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0 / 6.0));
+        p = VEC::fmadd(p, r, VEC::set1(0.5));
+        p = VEC::fmadd(p, r, VEC::set1(1.0));
+        p = VEC::fmadd(p, r, VEC::set1(1.0));
+        return VEC::mul(p, VEC::pow2n(n));
+    }
+};
+
+template<>
+struct oskar_simd_math<float>
+{
+    template<typename VEC>
+    static inline void sincos(typename VEC::type x,
+            typename VEC::type& s, typename VEC::type& c)
+    {
+        typedef typename VEC::type V;
+        const V q = VEC::round(VEC::mul(x, VEC::set1(0.636619772f)));
+        V r = VEC::fnmadd(q, VEC::set1(1.570796371f), x);
+        r = VEC::fnmadd(q, VEC::set1(-4.371138829e-08f), r);
+        r = VEC::fnmadd(q, VEC::set1(-1.715124510e-15f), r);
+        const V z = VEC::mul(r, r);
+        V ps = VEC::set1(-1.9515295891e-4f);
+        ps = VEC::fmadd(ps, z, VEC::set1(8.3321608736e-3f));
+        ps = VEC::fmadd(ps, z, VEC::set1(-1.6666654611e-1f));
+        ps = VEC::fmadd(VEC::mul(ps, z), r, r);
+        V pc = VEC::set1(2.443315711809948e-5f);
+        pc = VEC::fmadd(pc, z, VEC::set1(-1.388731625493765e-3f));
+        pc = VEC::fmadd(pc, z, VEC::set1(4.166664568298827e-2f));
+        pc = VEC::fmadd(VEC::mul(pc, z), z,
+                VEC::fnmadd(VEC::set1(0.5f), z, VEC::set1(1.0f)));
+        oskar_simd_sincos_quadrant<VEC>(q, ps, pc, s, c);
+    }
+
+    /* Evaluates exp(x) for x <= 0. */
+    template<typename VEC>
+    static inline typename VEC::type exp(typename VEC::type x)
+    {
+        typedef typename VEC::type V;
+        const V lo = VEC::set1(-87.0f);
+        x = VEC::select(VEC::cmp_lt(x, lo), lo, x);
+        const V n = VEC::round(VEC::mul(x, VEC::set1(1.44269504f)));
+        V r = VEC::fnmadd(n, VEC::set1(0.693359375f), x);
+        r = VEC::fnmadd(n, VEC::set1(-2.12194440e-4f), r);
+        V p = VEC::set1(1.0f / 5040.0f);
+        p = VEC::fmadd(p, r, VEC::set1(1.0f / 720.0f));
+        p = VEC::fmadd(p, r, VEC::set1(1.0f / 120.0f));
+        p = VEC::fmadd(p, r, VEC::set1(1.0f / 24.0f));
+        p = VEC::fmadd(p, r, VEC::set1(1.0f / 6.0f));
+        p = VEC::fmadd(p, r, VEC::set1(0.5f));
+        p = VEC::fmadd(p, r, VEC::set1(1.0f));
+        p = VEC::fmadd(p, r, VEC::set1(1.0f));
+        return VEC::mul(p, VEC::pow2n(n));
+    }
+};
+
+#endif /* include guard */
@@ -68,6 +68,11 @@ extern "C" {
  * The computed points are returned in the \p output array.
  * These are the complex (or complex matrix) values for each output position.
  *
+ * On the CPU, the output points are processed in blocks. Where the output
+ * coordinates are evenly spaced within a block (for example, along the rows
+ * of a regular grid), the phase factors are found by complex rotation
+ * rather than by evaluating sincos for every point.
+ *
  * @param[in] normalise        If true, divide output values by \p num_in.
  * @param[in] num_in           Number of input points.
  * @param[in] wavenumber       Wavenumber (2 pi / wavelength).
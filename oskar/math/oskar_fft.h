@@ -46,6 +46,12 @@ struct oskar_FFT;
 typedef struct oskar_FFT oskar_FFT;
 #endif /* OSKAR_FFT_TYPEDEF_ */
 
+enum OSKAR_FFT_CPU_BACKEND
+{
+    OSKAR_FFT_CPU_FFTPACK = 0,
+    OSKAR_FFT_CPU_THREADED = 1
+};
+
 /**
  * @brief Create FFT plan.
  *
@@ -83,6 +89,22 @@ oskar_FFT* oskar_fft_create(int precision, int location, int num_dim,
 OSKAR_EXPORT
 void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status);
 
+/**
+ * @brief Executes the FFT plan, where only the real part of the output is used.
+ *
+ * @details
+ * Executes the FFT plan with the supplied data, as oskar_fft_exec(),
+ * but only the real part of the output is computed: the imaginary part
+ * is set to zero. For 2D transforms on the CPU, this saves almost half
+ * of the row transforms. Otherwise, the full complex transform is done.
+ *
+ * @param[in] h             Handle to FFT plan.
+ * @param[in] data          Pointer to data to transform.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_fft_exec_real(oskar_FFT* h, oskar_Mem* data, int* status);
+
 /**
  * @brief Frees resources used by the plan.
  *
@@ -94,6 +116,22 @@ void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status);
 OSKAR_EXPORT
 void oskar_fft_free(oskar_FFT* h);
 
+/**
+ * @brief Sets the implementation used for transforms on the CPU.
+ *
+ * @details
+ * By default, 2D transforms on the CPU are split into blocks of rows and
+ * columns which are transformed in parallel using multiple threads
+ * (OSKAR_FFT_CPU_THREADED). The original single-threaded FFTPACK
+ * version can be selected instead using OSKAR_FFT_CPU_FFTPACK.
+ * Both give identical results.
+ *
+ * @param[in] h         Handle to FFT plan.
+ * @param[in] value     Enumerated CPU backend.
+ */
+OSKAR_EXPORT
+void oskar_fft_set_cpu_backend(oskar_FFT* h, int value);
+
 OSKAR_EXPORT
 void oskar_fft_set_ensure_consistent_norm(oskar_FFT* h, int value);
 
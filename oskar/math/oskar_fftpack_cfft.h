@@ -50,6 +50,14 @@ void oskar_fftpack_cfft2f(const int ldim, const int l, const int m,
 OSKAR_EXPORT
 void oskar_fftpack_cfft2i(const int l, const int m, double *wsave);
 
+/* Forward transform of lot sequences of length n, each with stride inc,
+ * starting jump elements apart. The wsave array is as initialised by
+ * oskar_fftpack_cfft2i() for a sequence of length n, and the work array
+ * must hold at least 2 * lot * n values. */
+OSKAR_EXPORT
+void oskar_fftpack_cfftmf(const int lot, const int jump, const int n,
+        const int inc, double *c, double *wsave, double *work);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_DFTW_SIMD_H_
+#define OSKAR_PRIVATE_DFTW_SIMD_H_
+
+/**
+ * @file private_dftw_simd.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+/* Declares the CPU DFT for one instruction set and precision.
+ * The parameters are as for oskar_dftw_simd_f(). */
+#define OSKAR_DFTW_SIMD_PROTOTYPE(NAME, FP, FP2)                            \
+void NAME(int is_3d, int is_matrix, int num_in, FP wavenumber,              \
+        const FP2* weights_in, const FP* x_in, const FP* y_in,              \
+        const FP* z_in, int offset_coord_out, int num_out,                  \
+        const FP* x_out, const FP* y_out, const FP* z_out,                  \
+        const int* data_idx, const FP2* data, int eval_x, int eval_y,       \
+        int offset_out, FP2* output, FP norm_factor);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * DFT using supplied weights, on the CPU (single precision).
+ *
+ * @details
+ * This is the CPU implementation of oskar_dftw(), using the best
+ * instruction set available at run time.
+ *
+ * If the output coordinates are evenly spaced over a block of output
+ * points, the phase factors are evaluated by complex rotation instead of
+ * a sine and cosine for every input and output.
+ *
+ * The data and output arrays hold complex values, or complex matrices
+ * (4 complex values per point) if \p is_matrix is set.
+ * The parameters are otherwise as for oskar_dftw().
+ * Coordinates \p z_in and \p z_out are only used if \p is_3d is set.
+ */
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_simd_f, float, float2)
+
+/**
+ * @brief
+ * DFT using supplied weights, on the CPU (double precision).
+ *
+ * @details
+ * See oskar_dftw_simd_f().
+ */
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_simd_d, double, double2)
+
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_scalar_f, float, float2)
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_scalar_d, double, double2)
+
+#ifdef OSKAR_HAVE_AVX2
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_avx2_f, float, float2)
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_avx2_d, double, double2)
+#endif
+
+#ifdef OSKAR_HAVE_AVX512
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_avx512_f, float, float2)
+OSKAR_DFTW_SIMD_PROTOTYPE(oskar_dftw_avx512_d, double, double2)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_SIMD_AVX2_H_
+#define OSKAR_PRIVATE_SIMD_AVX2_H_
+
+/* Vector wrappers for AVX2 (see define_simd_math.h).
+ * This must only be included by files compiled with AVX2 and FMA
+ * instructions enabled. */
+
+#include "math/define_simd_math.h"
+
+#include <immintrin.h>
+
+struct oskar_simd_avx2_d
+{
+    typedef double real;
+    typedef __m256d type;
+    typedef __m256d mask;
+    enum { width = 4 };
+    static inline type set1(real a) { return _mm256_set1_pd(a); }
+    static inline type load(const real* p) { return _mm256_loadu_pd(p); }
+    static inline void store(real* p, type a) { _mm256_storeu_pd(p, a); }
+    static inline type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+    static inline type div(type a, type b) { return _mm256_div_pd(a, b); }
+    static inline type fmadd(type a, type b, type c)
+    { return _mm256_fmadd_pd(a, b, c); }
+    static inline type fnmadd(type a, type b, type c)
+    { return _mm256_fnmadd_pd(a, b, c); }
+    static inline type round(type a)
+    { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline type floor(type a) { return _mm256_floor_pd(a); }
+    static inline mask cmp_eq(type a, type b)
+    { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static inline mask cmp_lt(type a, type b)
+    { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static inline mask cmp_le(type a, type b)
+    { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static inline mask mask_and(mask a, mask b) { return _mm256_and_pd(a, b); }
+    static inline mask mask_or(mask a, mask b) { return _mm256_or_pd(a, b); }
+    static inline type select(mask m, type a, type b)
+    { return _mm256_blendv_pd(b, a, m); }
+    static inline type pow2n(type n)
+    {
+        const __m256d t = _mm256_add_pd(n, _mm256_set1_pd(4503599627371519.0));
+        return _mm256_castsi256_pd(
+                _mm256_slli_epi64(_mm256_castpd_si256(t), 52));
+    }
+    static inline real reduce_add(type a)
+    {
+        const __m128d t = _mm_add_pd(
+                _mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+    }
+    static inline void sincos(type x, type& s, type& c)
+    { oskar_simd_math<real>::sincos<oskar_simd_avx2_d>(x, s, c); }
+    static inline type exp(type x)
+    { return oskar_simd_math<real>::exp<oskar_simd_avx2_d>(x); }
+};
+
+struct oskar_simd_avx2_f
+{
+    typedef float real;
+    typedef __m256 type;
+    typedef __m256 mask;
+    enum { width = 8 };
+    static inline type set1(real a) { return _mm256_set1_ps(a); }
+    static inline type load(const real* p) { return _mm256_loadu_ps(p); }
+    static inline void store(real* p, type a) { _mm256_storeu_ps(p, a); }
+    static inline type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static inline type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+    static inline type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+    static inline type div(type a, type b) { return _mm256_div_ps(a, b); }
+    static inline type fmadd(type a, type b, type c)
+    { return _mm256_fmadd_ps(a, b, c); }
+    static inline type fnmadd(type a, type b, type c)
+    { return _mm256_fnmadd_ps(a, b, c); }
+    static inline type round(type a)
+    { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static inline type floor(type a) { return _mm256_floor_ps(a); }
+    static inline mask cmp_eq(type a, type b)
+    { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static inline mask cmp_lt(type a, type b)
+    { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline mask cmp_le(type a, type b)
+    { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static inline mask mask_and(mask a, mask b) { return _mm256_and_ps(a, b); }
+    static inline mask mask_or(mask a, mask b) { return _mm256_or_ps(a, b); }
+    static inline type select(mask m, type a, type b)
+    { return _mm256_blendv_ps(b, a, m); }
+    static inline type pow2n(type n)
+    {
+        const __m256 t = _mm256_add_ps(n, _mm256_set1_ps(8388735.0f));
+        return _mm256_castsi256_ps(
+                _mm256_slli_epi32(_mm256_castps_si256(t), 23));
+    }
+    static inline real reduce_add(type a)
+    {
+        __m128 t = _mm_add_ps(
+                _mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        t = _mm_add_ps(t, _mm_movehl_ps(t, t));
+        return _mm_cvtss_f32(_mm_add_ss(t, _mm_movehdup_ps(t)));
+    }
+    static inline void sincos(type x, type& s, type& c)
+    { oskar_simd_math<real>::sincos<oskar_simd_avx2_f>(x, s, c); }
+    static inline type exp(type x)
+    { return oskar_simd_math<real>::exp<oskar_simd_avx2_f>(x); }
+};
+
+#endif /* include guard */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_SIMD_AVX512_H_
+#define OSKAR_PRIVATE_SIMD_AVX512_H_
+
+/* Vector wrappers for AVX-512 (see define_simd_math.h).
+ * This must only be included by files compiled with AVX-512F
+ * instructions enabled. */
+
+#include "math/define_simd_math.h"
+
+/* Some versions of GCC give spurious -Wmaybe-uninitialized warnings
+ * from inside the AVX-512 intrinsic headers (GCC bug 105593). */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+#define OSKAR_AVX512_ROUND_NEAREST \
+        (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define OSKAR_AVX512_ROUND_DOWN \
+        (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)
+
+struct oskar_simd_avx512_d
+{
+    typedef double real;
+    typedef __m512d type;
+    typedef __mmask8 mask;
+    enum { width = 8 };
+    static inline type set1(real a) { return _mm512_set1_pd(a); }
+    static inline type load(const real* p) { return _mm512_loadu_pd(p); }
+    static inline void store(real* p, type a) { _mm512_storeu_pd(p, a); }
+    static inline type add(type a, type b) { return _mm512_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+    static inline type div(type a, type b) { return _mm512_div_pd(a, b); }
+    static inline type fmadd(type a, type b, type c)
+    { return _mm512_fmadd_pd(a, b, c); }
+    static inline type fnmadd(type a, type b, type c)
+    { return _mm512_fnmadd_pd(a, b, c); }
+    static inline type round(type a)
+    { return _mm512_roundscale_pd(a, OSKAR_AVX512_ROUND_NEAREST); }
+    static inline type floor(type a)
+    { return _mm512_roundscale_pd(a, OSKAR_AVX512_ROUND_DOWN); }
+    static inline mask cmp_eq(type a, type b)
+    { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static inline mask cmp_lt(type a, type b)
+    { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static inline mask cmp_le(type a, type b)
+    { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static inline mask mask_and(mask a, mask b) { return (mask) (a & b); }
+    static inline mask mask_or(mask a, mask b) { return (mask) (a | b); }
+    static inline type select(mask m, type a, type b)
+    { return _mm512_mask_blend_pd(m, b, a); }
+    static inline type pow2n(type n)
+    {
+        const __m512d t = _mm512_add_pd(n, _mm512_set1_pd(4503599627371519.0));
+        return _mm512_castsi512_pd(
+                _mm512_slli_epi64(_mm512_castpd_si512(t), 52));
+    }
+    static inline real reduce_add(type a) { return _mm512_reduce_add_pd(a); }
+    static inline void sincos(type x, type& s, type& c)
+    { oskar_simd_math<real>::sincos<oskar_simd_avx512_d>(x, s, c); }
+    static inline type exp(type x)
+    { return oskar_simd_math<real>::exp<oskar_simd_avx512_d>(x); }
+};
+
+struct oskar_simd_avx512_f
+{
+    typedef float real;
+    typedef __m512 type;
+    typedef __mmask16 mask;
+    enum { width = 16 };
+    static inline type set1(real a) { return _mm512_set1_ps(a); }
+    static inline type load(const real* p) { return _mm512_loadu_ps(p); }
+    static inline void store(real* p, type a) { _mm512_storeu_ps(p, a); }
+    static inline type add(type a, type b) { return _mm512_add_ps(a, b); }
+    static inline type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+    static inline type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+    static inline type div(type a, type b) { return _mm512_div_ps(a, b); }
+    static inline type fmadd(type a, type b, type c)
+    { return _mm512_fmadd_ps(a, b, c); }
+    static inline type fnmadd(type a, type b, type c)
+    { return _mm512_fnmadd_ps(a, b, c); }
+    static inline type round(type a)
+    { return _mm512_roundscale_ps(a, OSKAR_AVX512_ROUND_NEAREST); }
+    static inline type floor(type a)
+    { return _mm512_roundscale_ps(a, OSKAR_AVX512_ROUND_DOWN); }
+    static inline mask cmp_eq(type a, type b)
+    { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static inline mask cmp_lt(type a, type b)
+    { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static inline mask cmp_le(type a, type b)
+    { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static inline mask mask_and(mask a, mask b) { return (mask) (a & b); }
+    static inline mask mask_or(mask a, mask b) { return (mask) (a | b); }
+    static inline type select(mask m, type a, type b)
+    { return _mm512_mask_blend_ps(m, b, a); }
+    static inline type pow2n(type n)
+    {
+        const __m512 t = _mm512_add_ps(n, _mm512_set1_ps(8388735.0f));
+        return _mm512_castsi512_ps(
+                _mm512_slli_epi32(_mm512_castps_si512(t), 23));
+    }
+    static inline real reduce_add(type a) { return _mm512_reduce_add_ps(a); }
+    static inline void sincos(type x, type& s, type& c)
+    { oskar_simd_math<real>::sincos<oskar_simd_avx512_f>(x, s, c); }
+    static inline type exp(type x)
+    { return oskar_simd_math<real>::exp<oskar_simd_avx512_f>(x); }
+};
+
+#endif /* include guard */
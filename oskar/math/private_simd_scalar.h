@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_SIMD_SCALAR_H_
+#define OSKAR_PRIVATE_SIMD_SCALAR_H_
+
+/* Scalar wrapper with the same interface as the vector wrappers
+ * (see define_simd_math.h). */
+
+#include <cmath>
+
+/* Scalar fallback, used if no vector instructions are available. */
+template<typename REAL>
+struct oskar_simd_scalar
+{
+    typedef REAL real;
+    typedef REAL type;
+    typedef bool mask;
+    enum { width = 1 };
+    static inline type set1(real a) { return a; }
+    static inline type load(const real* p) { return *p; }
+    static inline void store(real* p, type a) { *p = a; }
+    static inline type add(type a, type b) { return a + b; }
+    static inline type sub(type a, type b) { return a - b; }
+    static inline type mul(type a, type b) { return a * b; }
+    static inline type div(type a, type b) { return a / b; }
+    static inline type fmadd(type a, type b, type c) { return a * b + c; }
+    static inline type fnmadd(type a, type b, type c) { return c - a * b; }
+    static inline type round(type a) { return std::floor(a + (REAL) 0.5); }
+    static inline type floor(type a) { return std::floor(a); }
+    static inline mask cmp_eq(type a, type b) { return a == b; }
+    static inline mask cmp_lt(type a, type b) { return a < b; }
+    static inline mask cmp_le(type a, type b) { return a <= b; }
+    static inline mask mask_and(mask a, mask b) { return a && b; }
+    static inline mask mask_or(mask a, mask b) { return a || b; }
+    static inline type select(mask m, type a, type b) { return m ? a : b; }
+    static inline type pow2n(type n) { return std::ldexp((REAL) 1, (int) n); }
+    static inline real reduce_add(type a) { return a; }
+    static inline void sincos(type x, type& s, type& c)
+    { s = std::sin(x); c = std::cos(x); }
+    static inline type exp(type x) { return std::exp(x); }
+};
+
+#endif /* include guard */
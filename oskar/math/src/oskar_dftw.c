@@ -26,12 +26,9 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "math/define_dftw_c2c.h"
-#include "math/define_dftw_m2m.h"
-#include "math/define_multiply.h"
 #include "math/oskar_dftw.h"
+#include "math/private_dftw_simd.h"
 #include "utility/oskar_device.h"
-#include "utility/oskar_kernel_macros.h"
 #include "utility/oskar_vector_types.h"
 
 #define DBL (1 << 0)
@@ -40,16 +37,6 @@
 #define D2  (0 << 1)
 #define MAT (1 << 2)
 
-OSKAR_DFTW_C2C_CPU(dftw_c2c_2d_float, 0, float, float2)
-OSKAR_DFTW_C2C_CPU(dftw_c2c_3d_float, 1, float, float2)
-OSKAR_DFTW_M2M_CPU(dftw_m2m_2d_float, 0, float, float2)
-OSKAR_DFTW_M2M_CPU(dftw_m2m_3d_float, 1, float, float2)
-
-OSKAR_DFTW_C2C_CPU(dftw_c2c_2d_double, 0, double, double2)
-OSKAR_DFTW_C2C_CPU(dftw_c2c_3d_double, 1, double, double2)
-OSKAR_DFTW_M2M_CPU(dftw_m2m_2d_double, 0, double, double2)
-OSKAR_DFTW_M2M_CPU(dftw_m2m_3d_double, 1, double, double2)
-
 static int get_block_size(int num_total)
 {
     const int warp_size = 32;
@@ -141,128 +128,32 @@ void oskar_dftw(
     {
         const int* data_idx_p =
                 data_idx ? oskar_mem_int_const(data_idx, status) : 0;
-        if (is_matrix)
-        {
-            if (is_3d)
-            {
-                if (is_dbl)
-                    dftw_m2m_3d_double(num_in, wavenumber,
-                            oskar_mem_double2_const(weights_in, status),
-                            oskar_mem_double_const(x_in, status),
-                            oskar_mem_double_const(y_in, status),
-                            oskar_mem_double_const(z_in, status),
-                            offset_coord_out, num_out,
-                            oskar_mem_double_const(x_out, status),
-                            oskar_mem_double_const(y_out, status),
-                            oskar_mem_double_const(z_out, status),
-                            data_idx_p,
-                            oskar_mem_double2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_double2(output, status), norm_factor, 0);
-                else
-                    dftw_m2m_3d_float(num_in, (float)wavenumber,
-                            oskar_mem_float2_const(weights_in, status),
-                            oskar_mem_float_const(x_in, status),
-                            oskar_mem_float_const(y_in, status),
-                            oskar_mem_float_const(z_in, status),
-                            offset_coord_out, num_out,
-                            oskar_mem_float_const(x_out, status),
-                            oskar_mem_float_const(y_out, status),
-                            oskar_mem_float_const(z_out, status),
-                            data_idx_p,
-                            oskar_mem_float2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_float2(output, status), norm_factor_f, 0);
-            }
-            else
-            {
-                if (is_dbl)
-                    dftw_m2m_2d_double(num_in, wavenumber,
-                            oskar_mem_double2_const(weights_in, status),
-                            oskar_mem_double_const(x_in, status),
-                            oskar_mem_double_const(y_in, status), 0,
-                            offset_coord_out, num_out,
-                            oskar_mem_double_const(x_out, status),
-                            oskar_mem_double_const(y_out, status), 0,
-                            data_idx_p,
-                            oskar_mem_double2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_double2(output, status), norm_factor, 0);
-                else
-                    dftw_m2m_2d_float(num_in, (float)wavenumber,
-                            oskar_mem_float2_const(weights_in, status),
-                            oskar_mem_float_const(x_in, status),
-                            oskar_mem_float_const(y_in, status), 0,
-                            offset_coord_out, num_out,
-                            oskar_mem_float_const(x_out, status),
-                            oskar_mem_float_const(y_out, status), 0,
-                            data_idx_p,
-                            oskar_mem_float2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_float2(output, status), norm_factor_f, 0);
-            }
-        }
+        if (is_dbl)
+            oskar_dftw_simd_d(is_3d, is_matrix, num_in, wavenumber,
+                    oskar_mem_double2_const(weights_in, status),
+                    oskar_mem_double_const(x_in, status),
+                    oskar_mem_double_const(y_in, status),
+                    is_3d ? oskar_mem_double_const(z_in, status) : 0,
+                    offset_coord_out, num_out,
+                    oskar_mem_double_const(x_out, status),
+                    oskar_mem_double_const(y_out, status),
+                    is_3d ? oskar_mem_double_const(z_out, status) : 0,
+                    data_idx_p, oskar_mem_double2_const(data, status),
+                    eval_x, eval_y, offset_out,
+                    oskar_mem_double2(output, status), norm_factor);
         else
-        {
-            if (is_3d)
-            {
-                if (is_dbl)
-                    dftw_c2c_3d_double(num_in, wavenumber,
-                            oskar_mem_double2_const(weights_in, status),
-                            oskar_mem_double_const(x_in, status),
-                            oskar_mem_double_const(y_in, status),
-                            oskar_mem_double_const(z_in, status),
-                            offset_coord_out, num_out,
-                            oskar_mem_double_const(x_out, status),
-                            oskar_mem_double_const(y_out, status),
-                            oskar_mem_double_const(z_out, status),
-                            data_idx_p,
-                            oskar_mem_double2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_double2(output, status), norm_factor, 0);
-                else
-                    dftw_c2c_3d_float(num_in, (float)wavenumber,
-                            oskar_mem_float2_const(weights_in, status),
-                            oskar_mem_float_const(x_in, status),
-                            oskar_mem_float_const(y_in, status),
-                            oskar_mem_float_const(z_in, status),
-                            offset_coord_out, num_out,
-                            oskar_mem_float_const(x_out, status),
-                            oskar_mem_float_const(y_out, status),
-                            oskar_mem_float_const(z_out, status),
-                            data_idx_p,
-                            oskar_mem_float2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_float2(output, status), norm_factor_f, 0);
-            }
-            else
-            {
-                if (is_dbl)
-                    dftw_c2c_2d_double(num_in, wavenumber,
-                            oskar_mem_double2_const(weights_in, status),
-                            oskar_mem_double_const(x_in, status),
-                            oskar_mem_double_const(y_in, status), 0,
-                            offset_coord_out, num_out,
-                            oskar_mem_double_const(x_out, status),
-                            oskar_mem_double_const(y_out, status), 0,
-                            data_idx_p,
-                            oskar_mem_double2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_double2(output, status), norm_factor, 0);
-                else
-                    dftw_c2c_2d_float(num_in, (float)wavenumber,
-                            oskar_mem_float2_const(weights_in, status),
-                            oskar_mem_float_const(x_in, status),
-                            oskar_mem_float_const(y_in, status), 0,
-                            offset_coord_out, num_out,
-                            oskar_mem_float_const(x_out, status),
-                            oskar_mem_float_const(y_out, status), 0,
-                            data_idx_p,
-                            oskar_mem_float2_const(data, status),
-                            eval_x, eval_y, offset_out,
-                            oskar_mem_float2(output, status), norm_factor_f, 0);
-            }
-        }
+            oskar_dftw_simd_f(is_3d, is_matrix, num_in, (float)wavenumber,
+                    oskar_mem_float2_const(weights_in, status),
+                    oskar_mem_float_const(x_in, status),
+                    oskar_mem_float_const(y_in, status),
+                    is_3d ? oskar_mem_float_const(z_in, status) : 0,
+                    offset_coord_out, num_out,
+                    oskar_mem_float_const(x_out, status),
+                    oskar_mem_float_const(y_out, status),
+                    is_3d ? oskar_mem_float_const(z_out, status) : 0,
+                    data_idx_p, oskar_mem_float2_const(data, status),
+                    eval_x, eval_y, offset_out,
+                    oskar_mem_float2(output, status), norm_factor_f);
     }
     else
     {
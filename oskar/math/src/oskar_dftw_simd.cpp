@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "correlate/oskar_cross_correlate_simd.h"
+#include "math/define_dftw_simd.h"
+#include "math/private_dftw_simd.h"
+#include "math/private_simd_scalar.h"
+
+OSKAR_DFTW_SIMD_DEFINE(oskar_dftw_scalar_f, oskar_simd_scalar<float>,
+        float, float2)
+OSKAR_DFTW_SIMD_DEFINE(oskar_dftw_scalar_d, oskar_simd_scalar<double>,
+        double, double2)
+
+/* The instruction set is chosen in the same way as for the correlator. */
+#define SIMD_DISPATCH(FP)                                                   \
+        switch (oskar_cross_correlate_simd_isa())                           \
+        {                                                                   \
+        SIMD_CASE_AVX512(FP)                                                \
+        SIMD_CASE_AVX2(FP)                                                  \
+        default:                                                            \
+            oskar_dftw_scalar_ ## FP SIMD_ARGS;                             \
+        }
+
+#ifdef OSKAR_HAVE_AVX2
+#define SIMD_CASE_AVX2(FP) case OSKAR_SIMD_AVX2:                            \
+        oskar_dftw_avx2_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX2(FP)
+#endif
+#ifdef OSKAR_HAVE_AVX512
+#define SIMD_CASE_AVX512(FP) case OSKAR_SIMD_AVX512:                        \
+        oskar_dftw_avx512_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX512(FP)
+#endif
+
+#define SIMD_ARGS (is_3d, is_matrix, num_in, wavenumber, weights_in,        \
+        x_in, y_in, z_in, offset_coord_out, num_out, x_out, y_out, z_out,   \
+        data_idx, data, eval_x, eval_y, offset_out, output, norm_factor)
+
+void oskar_dftw_simd_f(int is_3d, int is_matrix, int num_in, float wavenumber,
+        const float2* weights_in, const float* x_in, const float* y_in,
+        const float* z_in, int offset_coord_out, int num_out,
+        const float* x_out, const float* y_out, const float* z_out,
+        const int* data_idx, const float2* data, int eval_x, int eval_y,
+        int offset_out, float2* output, float norm_factor)
+{
+    SIMD_DISPATCH(f)
+}
+
+void oskar_dftw_simd_d(int is_3d, int is_matrix, int num_in,
+        double wavenumber, const double2* weights_in, const double* x_in,
+        const double* y_in, const double* z_in, int offset_coord_out,
+        int num_out, const double* x_out, const double* y_out,
+        const double* z_out, const int* data_idx, const double2* data,
+        int eval_x, int eval_y, int offset_out, double2* output,
+        double norm_factor)
+{
+    SIMD_DISPATCH(d)
+}
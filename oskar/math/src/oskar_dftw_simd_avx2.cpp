@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/* This file must be compiled with AVX2 and FMA instructions enabled. */
+
+#include "math/define_dftw_simd.h"
+#include "math/private_dftw_simd.h"
+#include "math/private_simd_avx2.h"
+
+OSKAR_DFTW_SIMD_DEFINE(oskar_dftw_avx2_f, oskar_simd_avx2_f, float, float2)
+OSKAR_DFTW_SIMD_DEFINE(oskar_dftw_avx2_d, oskar_simd_avx2_d, double, double2)
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/* This file must be compiled with AVX-512F instructions enabled. */
+
+#include "math/define_dftw_simd.h"
+#include "math/private_dftw_simd.h"
+#include "math/private_simd_avx512.h"
+
+OSKAR_DFTW_SIMD_DEFINE(oskar_dftw_avx512_f, oskar_simd_avx512_f,
+        float, float2)
+OSKAR_DFTW_SIMD_DEFINE(oskar_dftw_avx512_d, oskar_simd_avx512_d,
+        double, double2)
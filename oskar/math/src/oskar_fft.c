@@ -47,6 +47,7 @@ struct oskar_FFT
     size_t num_cells_total;
     oskar_Mem *fftpack_work, *fftpack_wsave;
     int precision, location, num_dim, dim_size, ensure_consistent_norm;
+    int cpu_backend;
 #ifdef OSKAR_HAVE_CUDA
     cufftHandle cufft_plan;
 #endif
@@ -91,6 +92,102 @@ static void print_cufft_error(cufftResult code)
 }
 #endif
 
+/* Number of sequences transformed together by each thread. */
+#define FFT_CHUNK 16
+
+/*
+ * 2D transforms on the CPU, split into independent chunks of columns and
+ * then chunks of rows, which are transformed by different threads.
+ * FFTPACK transforms each sequence in a chunk in the same way as it does
+ * for the whole grid, so the results are identical to oskar_fftpack_cfft2f().
+ *
+ * If real_only is set, only the real part of the output is required.
+ * The row transforms are then done in pairs: for rows a and b, the
+ * transform of z = H(a) + iH(b), where H(x)[k] = (x[k] + conj(x[-k])) / 2,
+ * gives Re(FFT(a)) in its real part and Re(FFT(b)) in its imaginary part.
+ */
+#define OSKAR_FFT2_CPU(NAME, FP, CFFTMF) \
+static void NAME(const int n, const int real_only, FP* c, FP* wsave, \
+        int* status) \
+{ \
+    int a, error = 0; \
+    const int num_chunks = (n + FFT_CHUNK - 1) / FFT_CHUNK; \
+    const int num_pairs = (n + 1) / 2; \
+    FP* wsave_m = &wsave[(n << 1) + (int) (log((double) n) / log(2.0)) + 2]; \
+    _Pragma("omp parallel private(a)") \
+    { \
+        FP *work, *z; \
+        work = (FP*) malloc((2 * FFT_CHUNK * n + 2 * n) * sizeof(FP)); \
+        if (!work) error = 1; \
+        _Pragma("omp barrier") \
+        if (!error) \
+        { \
+            z = work + 2 * FFT_CHUNK * n; \
+            /* Transform the columns. */ \
+            _Pragma("omp for schedule(static)") \
+            for (a = 0; a < num_chunks; ++a) \
+            { \
+                const int start = a * FFT_CHUNK; \
+                const int lot = (n - start < FFT_CHUNK) ? \
+                        n - start : FFT_CHUNK; \
+                CFFTMF(lot, 1, n, n, &c[2 * start], wsave_m, work); \
+            } \
+            /* Transform the rows. */ \
+            if (!real_only) \
+            { \
+                _Pragma("omp for schedule(static)") \
+                for (a = 0; a < num_chunks; ++a) \
+                { \
+                    const int start = a * FFT_CHUNK; \
+                    const int lot = (n - start < FFT_CHUNK) ? \
+                            n - start : FFT_CHUNK; \
+                    CFFTMF(lot, n, n, 1, &c[2 * n * start], wsave, work); \
+                } \
+            } \
+            else \
+            { \
+                _Pragma("omp for schedule(static)") \
+                for (a = 0; a < num_pairs; ++a) \
+                { \
+                    int k; \
+                    FP* ra = &c[4 * n * a]; \
+                    FP* rb = (2 * a + 1 < n) ? ra + 2 * n : 0; \
+                    for (k = 0; k < n; ++k) \
+                    { \
+                        const int r = (n - k) % n; \
+                        const FP a_re = (ra[2 * k] + ra[2 * r]) / 2; \
+                        const FP a_im = (ra[2 * k + 1] - ra[2 * r + 1]) / 2; \
+                        FP b_re = 0, b_im = 0; \
+                        if (rb) \
+                        { \
+                            b_re = (rb[2 * k] + rb[2 * r]) / 2; \
+                            b_im = (rb[2 * k + 1] - rb[2 * r + 1]) / 2; \
+                        } \
+                        z[2 * k] = a_re - b_im; \
+                        z[2 * k + 1] = a_im + b_re; \
+                    } \
+                    CFFTMF(1, n, n, 1, z, wsave, work); \
+                    for (k = 0; k < n; ++k) \
+                    { \
+                        ra[2 * k] = z[2 * k]; \
+                        ra[2 * k + 1] = 0; \
+                        if (rb) \
+                        { \
+                            rb[2 * k] = z[2 * k + 1]; \
+                            rb[2 * k + 1] = 0; \
+                        } \
+                    } \
+                } \
+            } \
+        } \
+        free(work); \
+    } \
+    if (error) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE; \
+}
+
+OSKAR_FFT2_CPU(fft2_cpu_d, double, oskar_fftpack_cfftmf)
+OSKAR_FFT2_CPU(fft2_cpu_f, float, oskar_fftpack_cfftmf_f)
+
 oskar_FFT* oskar_fft_create(int precision, int location, int num_dim,
         int dim_size, int batch_size_1d, int* status)
 {
@@ -107,6 +204,7 @@ oskar_FFT* oskar_fft_create(int precision, int location, int num_dim,
     h->num_dim = num_dim;
     h->dim_size = dim_size;
     h->ensure_consistent_norm = 1;
+    h->cpu_backend = OSKAR_FFT_CPU_THREADED;
     h->num_cells_total = (size_t) dim_size;
     for (i = 1; i < num_dim; ++i) h->num_cells_total *= (size_t) dim_size;
     if (location == OSKAR_CPU || (location & OSKAR_CL))
@@ -136,8 +234,7 @@ oskar_FFT* oskar_fft_create(int precision, int location, int num_dim,
         }
         else
             *status = OSKAR_ERR_INVALID_ARGUMENT;
-        h->fftpack_work = oskar_mem_create(precision, OSKAR_CPU,
-                2 * h->num_cells_total, status);
+        h->fftpack_work = oskar_mem_create(precision, OSKAR_CPU, 0, status);
     }
     else if (location == OSKAR_GPU)
     {
@@ -164,7 +261,8 @@ oskar_FFT* oskar_fft_create(int precision, int location, int num_dim,
     return h;
 }
 
-void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status)
+static void fft_exec(oskar_FFT* h, oskar_Mem* data, int real_only,
+        int* status)
 {
     oskar_Mem *data_copy = 0, *data_ptr = data;
     if (*status) return;
@@ -179,23 +277,41 @@ void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status)
         {
             *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
         }
-        else if (h->num_dim == 2)
+        else if (h->num_dim == 2 && h->cpu_backend == OSKAR_FFT_CPU_THREADED)
         {
             if (h->precision == OSKAR_DOUBLE)
-                oskar_fftpack_cfft2f(h->dim_size, h->dim_size, h->dim_size,
+                fft2_cpu_d(h->dim_size, real_only,
                         oskar_mem_double(data_ptr, status),
-                        oskar_mem_double(h->fftpack_wsave, status),
-                        oskar_mem_double(h->fftpack_work, status));
+                        oskar_mem_double(h->fftpack_wsave, status), status);
             else
-                oskar_fftpack_cfft2f_f(h->dim_size, h->dim_size, h->dim_size,
+                fft2_cpu_f(h->dim_size, real_only,
                         oskar_mem_float(data_ptr, status),
-                        oskar_mem_float(h->fftpack_wsave, status),
-                        oskar_mem_float(h->fftpack_work, status));
-            /* This step not needed for W-kernel generation, so turn it off. */
-            if (h->ensure_consistent_norm)
-                oskar_mem_scale_real(data_ptr, (double)h->num_cells_total,
-                        0, h->num_cells_total, status);
+                        oskar_mem_float(h->fftpack_wsave, status), status);
+        }
+        else if (h->num_dim == 2)
+        {
+            /* Work array is only needed by the single-threaded version. */
+            oskar_mem_ensure(h->fftpack_work, 2 * h->num_cells_total, status);
+            if (!*status)
+            {
+                if (h->precision == OSKAR_DOUBLE)
+                    oskar_fftpack_cfft2f(h->dim_size, h->dim_size,
+                            h->dim_size,
+                            oskar_mem_double(data_ptr, status),
+                            oskar_mem_double(h->fftpack_wsave, status),
+                            oskar_mem_double(h->fftpack_work, status));
+                else
+                    oskar_fftpack_cfft2f_f(h->dim_size, h->dim_size,
+                            h->dim_size,
+                            oskar_mem_float(data_ptr, status),
+                            oskar_mem_float(h->fftpack_wsave, status),
+                            oskar_mem_float(h->fftpack_work, status));
+            }
         }
+        /* This step not needed for W-kernel generation, so turn it off. */
+        if (h->num_dim == 2 && h->ensure_consistent_norm)
+            oskar_mem_scale_real(data_ptr, (double)h->num_cells_total,
+                    0, h->num_cells_total, status);
     }
     else if (h->location == OSKAR_GPU)
     {
@@ -225,6 +341,16 @@ void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status)
     oskar_mem_free(data_copy, status);
 }
 
+void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status)
+{
+    fft_exec(h, data, 0, status);
+}
+
+void oskar_fft_exec_real(oskar_FFT* h, oskar_Mem* data, int* status)
+{
+    fft_exec(h, data, 1, status);
+}
+
 void oskar_fft_free(oskar_FFT* h)
 {
     int status = 0;
@@ -238,6 +364,11 @@ void oskar_fft_free(oskar_FFT* h)
     free(h);
 }
 
+void oskar_fft_set_cpu_backend(oskar_FFT* h, int value)
+{
+    h->cpu_backend = value;
+}
+
 void oskar_fft_set_ensure_consistent_norm(oskar_FFT* h, int value)
 {
     h->ensure_consistent_norm = value;
@@ -160,6 +160,13 @@ void oskar_fftpack_cfft2f(const int ldim, const int l, const int m,
 }
 
 
+void oskar_fftpack_cfftmf(const int lot, const int jump, const int n,
+        const int inc, double *c, double *wsave, double *work)
+{
+    cfftmf(lot, jump, n, inc, c, wsave, work);
+}
+
+
 void oskar_fftpack_cfft2i(const int l, const int m, double *wsave)
 {
     cfftmi(l, wsave);
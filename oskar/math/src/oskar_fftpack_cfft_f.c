@@ -160,6 +160,13 @@ void oskar_fftpack_cfft2f_f(const int ldim, const int l, const int m,
 }
 
 
+void oskar_fftpack_cfftmf_f(const int lot, const int jump, const int n,
+        const int inc, float *c, float *wsave, float *work)
+{
+    cfftmf(lot, jump, n, inc, c, wsave, work);
+}
+
+
 void oskar_fftpack_cfft2i_f(const int l, const int m, float *wsave)
 {
     cfftmi(l, wsave);
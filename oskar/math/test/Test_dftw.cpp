@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "math/oskar_cmath.h"
+#include "math/oskar_dftw.h"
+#include "mem/oskar_mem.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cmath>
+#include <cstdlib>
+
+/* Reference DFT, evaluated directly in double precision. */
+static void dftw_reference(int num_in, double wavenumber,
+        const oskar_Mem* weights_in, const oskar_Mem* x_in,
+        const oskar_Mem* y_in, const oskar_Mem* z_in, int num_out,
+        const oskar_Mem* x_out, const oskar_Mem* y_out,
+        const oskar_Mem* z_out, const oskar_Mem* data_idx,
+        const oskar_Mem* data, oskar_Mem* output, int* status)
+{
+    const int num_pols = oskar_mem_is_matrix(data) ? 4 : 1;
+    const int* idx = data_idx ? oskar_mem_int_const(data_idx, status) : 0;
+    const double* xi = oskar_mem_double_const(x_in, status);
+    const double* yi = oskar_mem_double_const(y_in, status);
+    const double* zi = z_in ? oskar_mem_double_const(z_in, status) : 0;
+    const double* xo = oskar_mem_double_const(x_out, status);
+    const double* yo = oskar_mem_double_const(y_out, status);
+    const double* zo = z_out ? oskar_mem_double_const(z_out, status) : 0;
+    const double2* w = oskar_mem_double2_const(weights_in, status);
+    const double2* d = (const double2*) oskar_mem_void_const(data);
+    double2* out = (double2*) oskar_mem_void(output);
+    for (int k = 0; k < num_out; ++k)
+    {
+        for (int p = 0; p < num_pols; ++p)
+        {
+            double re = 0.0, im = 0.0;
+            for (int i = 0; i < num_in; ++i)
+            {
+                double t = xo[k] * xi[i] + yo[k] * yi[i];
+                if (zi && zo) t += zo[k] * zi[i];
+                t *= wavenumber;
+                const double c = cos(t), s = sin(t);
+                const double f_re = c * w[i].x - s * w[i].y;
+                const double f_im = s * w[i].x + c * w[i].y;
+                const int j = idx ? idx[i] : i;
+                const double2 v = d[num_pols * (j * num_out + k) + p];
+                re += v.x * f_re - v.y * f_im;
+                im += v.y * f_re + v.x * f_im;
+            }
+            out[num_pols * k + p].x = re;
+            out[num_pols * k + p].y = im;
+        }
+    }
+}
+
+static void fill_random(oskar_Mem* mem, double scale)
+{
+    const size_t n = oskar_mem_length(mem) *
+            (oskar_mem_is_complex(mem) ? 2 : 1) *
+            (oskar_mem_is_matrix(mem) ? 4 : 1);
+    double* p = (double*) oskar_mem_void(mem);
+    for (size_t i = 0; i < n; ++i)
+        p[i] = scale * (2.0 * rand() / (double) RAND_MAX - 1.0);
+}
+
+/*
+ * Checks the CPU DFT against the reference, for output directions either
+ * on a regular grid (where phase factors are found by rotation) or at
+ * random (where they are evaluated using sincos).
+ */
+static void check_dftw(int prec, int is_3d, int is_matrix, int use_grid,
+        int use_idx, int eval_x, int eval_y)
+{
+    int status = 0;
+    const int num_in = 200, side = 64, num_out = side * side;
+    const double wavenumber = 2.0 * M_PI / 2.0; /* Wavelength 2 m. */
+    const int data_type = OSKAR_DOUBLE | OSKAR_COMPLEX |
+            (is_matrix ? OSKAR_MATRIX : 0);
+    const int num_pols = is_matrix ? 4 : 1;
+    srand(1);
+
+    /* Station layout: input positions and weights. */
+    oskar_Mem *x_in, *y_in, *z_in, *weights;
+    x_in = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_in, &status);
+    y_in = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_in, &status);
+    z_in = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_in, &status);
+    weights = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_in, &status);
+    fill_random(x_in, 20.0);
+    fill_random(y_in, 20.0);
+    fill_random(z_in, 0.5);
+    fill_random(weights, 1.0);
+
+    /* Output directions. */
+    oskar_Mem *x_out, *y_out, *z_out;
+    x_out = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_out, &status);
+    y_out = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_out, &status);
+    z_out = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_out, &status);
+    double* xo = oskar_mem_double(x_out, &status);
+    double* yo = oskar_mem_double(y_out, &status);
+    double* zo = oskar_mem_double(z_out, &status);
+    for (int k = 0; k < num_out; ++k)
+    {
+        if (use_grid)
+        {
+            xo[k] = -0.7 + 1.4 * (k % side) / (side - 1);
+            yo[k] = -0.7 + 1.4 * (k / side) / (side - 1);
+            zo[k] = 0.1 + 0.001 * (k % side);
+        }
+        else
+        {
+            xo[k] = 0.7 * (2.0 * rand() / (double) RAND_MAX - 1.0);
+            yo[k] = 0.7 * (2.0 * rand() / (double) RAND_MAX - 1.0);
+            zo[k] = sqrt(1.0 - xo[k] * xo[k] - yo[k] * yo[k]);
+        }
+    }
+
+    /* Input data, optionally indirectly addressed. */
+    const int num_data = use_idx ? 3 : num_in;
+    oskar_Mem *data, *data_idx = 0;
+    data = oskar_mem_create(data_type, OSKAR_CPU,
+            (size_t) num_data * num_out, &status);
+    fill_random(data, 1.0);
+    if (use_idx)
+    {
+        data_idx = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_in, &status);
+        int* idx = oskar_mem_int(data_idx, &status);
+        for (int i = 0; i < num_in; ++i) idx[i] = i % num_data;
+    }
+
+    /* Evaluate the reference in double precision. */
+    oskar_Mem* ref = oskar_mem_create(data_type, OSKAR_CPU, num_out, &status);
+    dftw_reference(num_in, wavenumber, weights, x_in, y_in,
+            is_3d ? z_in : 0, num_out, x_out, y_out, is_3d ? z_out : 0,
+            data_idx, data, ref, &status);
+
+    /* Evaluate the DFT in the requested precision. */
+    oskar_Mem *t_x_in, *t_y_in, *t_z_in, *t_weights;
+    oskar_Mem *t_x_out, *t_y_out, *t_z_out, *t_data, *out;
+    t_x_in = oskar_mem_convert_precision(x_in, prec, &status);
+    t_y_in = oskar_mem_convert_precision(y_in, prec, &status);
+    t_z_in = oskar_mem_convert_precision(z_in, prec, &status);
+    t_weights = oskar_mem_convert_precision(weights, prec, &status);
+    t_x_out = oskar_mem_convert_precision(x_out, prec, &status);
+    t_y_out = oskar_mem_convert_precision(y_out, prec, &status);
+    t_z_out = oskar_mem_convert_precision(z_out, prec, &status);
+    t_data = oskar_mem_convert_precision(data, prec, &status);
+    out = oskar_mem_create(prec | OSKAR_COMPLEX |
+            (is_matrix ? OSKAR_MATRIX : 0), OSKAR_CPU, num_out, &status);
+    oskar_dftw(0, num_in, wavenumber, t_weights, t_x_in, t_y_in,
+            is_3d ? t_z_in : 0, 0, num_out, t_x_out, t_y_out,
+            is_3d ? t_z_out : 0, data_idx, t_data, eval_x, eval_y, 0,
+            out, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    /* Check the error against a bound that scales with the sum size. */
+    oskar_Mem* out_d = oskar_mem_convert_precision(out, OSKAR_DOUBLE,
+            &status);
+    const double2* a = (const double2*) oskar_mem_void_const(out_d);
+    const double2* b = (const double2*) oskar_mem_void_const(ref);
+    double max_err = 0.0;
+    for (int k = 0; k < num_out; ++k)
+    {
+        for (int p = 0; p < num_pols; ++p)
+        {
+            if (is_matrix && ((p < 2 && !eval_x) || (p >= 2 && !eval_y)))
+                continue;
+            const int j = num_pols * k + p;
+            const double err = fabs(a[j].x - b[j].x) + fabs(a[j].y - b[j].y);
+            if (err > max_err) max_err = err;
+        }
+    }
+    const double tol = num_in * (prec == OSKAR_DOUBLE ? 1e-13 : 1e-5);
+    EXPECT_LT(max_err, tol) << "3D: " << is_3d << ", matrix: " << is_matrix
+            << ", grid: " << use_grid << ", index: " << use_idx;
+
+    oskar_mem_free(x_in, &status);
+    oskar_mem_free(y_in, &status);
+    oskar_mem_free(z_in, &status);
+    oskar_mem_free(weights, &status);
+    oskar_mem_free(x_out, &status);
+    oskar_mem_free(y_out, &status);
+    oskar_mem_free(z_out, &status);
+    oskar_mem_free(data, &status);
+    oskar_mem_free(data_idx, &status);
+    oskar_mem_free(ref, &status);
+    oskar_mem_free(t_x_in, &status);
+    oskar_mem_free(t_y_in, &status);
+    oskar_mem_free(t_z_in, &status);
+    oskar_mem_free(t_weights, &status);
+    oskar_mem_free(t_x_out, &status);
+    oskar_mem_free(t_y_out, &status);
+    oskar_mem_free(t_z_out, &status);
+    oskar_mem_free(t_data, &status);
+    oskar_mem_free(out, &status);
+    oskar_mem_free(out_d, &status);
+}
+
+TEST(dftw, cpu_accuracy)
+{
+    const int types[] = {OSKAR_SINGLE, OSKAR_DOUBLE};
+    for (int t = 0; t < 2; ++t)
+    {
+        for (int is_3d = 0; is_3d < 2; ++is_3d)
+        {
+            for (int use_grid = 0; use_grid < 2; ++use_grid)
+            {
+                check_dftw(types[t], is_3d, 0, use_grid, 0, 1, 1);
+                check_dftw(types[t], is_3d, 1, use_grid, 0, 1, 1);
+                check_dftw(types[t], is_3d, 1, use_grid, 1, 1, 0);
+                check_dftw(types[t], is_3d, 1, use_grid, 1, 0, 1);
+            }
+        }
+    }
+}
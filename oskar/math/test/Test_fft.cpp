@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "math/oskar_fft.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static void check_fft(int precision, int size, double tol)
+{
+    int status = 0;
+    const int type = precision | OSKAR_COMPLEX;
+    const size_t num_cells = (size_t) size * size;
+
+    // Create random input data.
+    oskar_Mem *data_in, *data[3];
+    data_in = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_cells, &status);
+    double* d = oskar_mem_double(data_in, &status);
+    srand(size);
+    for (size_t i = 0; i < 2 * num_cells; ++i)
+        d[i] = 2.0 * rand() / (double) RAND_MAX - 1.0;
+    for (int i = 0; i < 3; ++i)
+        data[i] = oskar_mem_convert_precision(data_in, precision, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Transform using FFTPACK, the threaded version, and real output only.
+    oskar_FFT* fft = oskar_fft_create(precision, OSKAR_CPU, 2, size, 0,
+            &status);
+    oskar_fft_set_cpu_backend(fft, OSKAR_FFT_CPU_FFTPACK);
+    oskar_fft_exec(fft, data[0], &status);
+    oskar_fft_set_cpu_backend(fft, OSKAR_FFT_CPU_THREADED);
+    oskar_fft_exec(fft, data[1], &status);
+    oskar_fft_exec_real(fft, data[2], &status);
+    oskar_fft_free(fft);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the threaded version gives identical results.
+    EXPECT_EQ(0, memcmp(oskar_mem_void_const(data[0]),
+            oskar_mem_void_const(data[1]),
+            num_cells * oskar_mem_element_size(type))) << "size = " << size;
+
+    // Check the real part, relative to the largest value.
+    oskar_Mem* ref = oskar_mem_convert_precision(data[0], OSKAR_DOUBLE,
+            &status);
+    oskar_Mem* out = oskar_mem_convert_precision(data[2], OSKAR_DOUBLE,
+            &status);
+    const double* r = oskar_mem_double_const(ref, &status);
+    const double* o = oskar_mem_double_const(out, &status);
+    double max_val = 0.0, max_diff = 0.0;
+    for (size_t i = 0; i < num_cells; ++i)
+    {
+        if (fabs(r[2 * i]) > max_val) max_val = fabs(r[2 * i]);
+        if (fabs(r[2 * i] - o[2 * i]) > max_diff)
+            max_diff = fabs(r[2 * i] - o[2 * i]);
+        ASSERT_EQ(0.0, o[2 * i + 1]);
+    }
+    EXPECT_GT(max_val, 0.0);
+    EXPECT_LT(max_diff / max_val, tol) << "size = " << size;
+
+    // Clean up.
+    oskar_mem_free(data_in, &status);
+    oskar_mem_free(ref, &status);
+    oskar_mem_free(out, &status);
+    for (int i = 0; i < 3; ++i) oskar_mem_free(data[i], &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(fft, double_precision)
+{
+    check_fft(OSKAR_DOUBLE, 256, 1e-12);
+    check_fft(OSKAR_DOUBLE, 90, 1e-12);
+    check_fft(OSKAR_DOUBLE, 37, 1e-12);
+}
+
+TEST(fft, single_precision)
+{
+    check_fft(OSKAR_SINGLE, 256, 1e-5);
+    check_fft(OSKAR_SINGLE, 37, 1e-5);
+}
@@ -71,6 +71,22 @@ int oskar_mem_allocated(const oskar_Mem* mem);
 OSKAR_EXPORT
 size_t oskar_mem_length(const oskar_Mem* mem);
 
+/**
+ * @brief
+ * Returns the size of the memory block, in bytes.
+ *
+ * @details
+ * This function returns the number of bytes used by the elements in the
+ * memory block. Aliased memory is not counted, and a NULL
+ * pointer returns 0.
+ *
+ * @param[in] mem Pointer to the memory block.
+ *
+ * @return The size of the memory block, in bytes.
+ */
+OSKAR_EXPORT
+size_t oskar_mem_size_bytes(const oskar_Mem* mem);
+
 /**
  * @brief
  * Returns the enumerated location of the memory block.
@@ -43,6 +43,12 @@ size_t oskar_mem_length(const oskar_Mem* mem)
     return mem->num_elements;
 }
 
+size_t oskar_mem_size_bytes(const oskar_Mem* mem)
+{
+    if (!mem || !mem->owner) return 0;
+    return mem->num_elements * oskar_mem_element_size(mem->type);
+}
+
 int oskar_mem_location(const oskar_Mem* mem)
 {
     return mem->location;
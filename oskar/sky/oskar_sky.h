@@ -76,10 +76,12 @@ enum OSKAR_SKY_TAGS
 #include <sky/oskar_sky_copy_contents.h>
 #include <sky/oskar_sky_create.h>
 #include <sky/oskar_sky_create_copy.h>
+#include <sky/oskar_sky_create_view.h>
 #include <sky/oskar_sky_evaluate_gaussian_source_parameters.h>
 #include <sky/oskar_sky_evaluate_relative_directions.h>
 #include <sky/oskar_sky_filter_by_flux.h>
 #include <sky/oskar_sky_filter_by_radius.h>
+#include <sky/oskar_sky_flux_table.h>
 #include <sky/oskar_sky_free.h>
 #include <sky/oskar_sky_from_fits_file.h>
 #include <sky/oskar_sky_from_healpix_ring.h>
@@ -87,6 +89,7 @@ enum OSKAR_SKY_TAGS
 #include <sky/oskar_sky_generate_grid.h>
 #include <sky/oskar_sky_generate_random_power_law.h>
 #include <sky/oskar_sky_horizon_clip.h>
+#include <sky/oskar_sky_horizon_table.h>
 #include <sky/oskar_sky_load.h>
 #include <sky/oskar_sky_override_polarisation.h>
 #include <sky/oskar_sky_read.h>
@@ -97,6 +100,7 @@ enum OSKAR_SKY_TAGS
 #include <sky/oskar_sky_set_gaussian_parameters.h>
 #include <sky/oskar_sky_set_source.h>
 #include <sky/oskar_sky_set_spectral_index.h>
+#include <sky/oskar_sky_set_view.h>
 #include <sky/oskar_sky_write.h>
 
 
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_SKY_CREATE_VIEW_H_
+#define OSKAR_SKY_CREATE_VIEW_H_
+
+/**
+ * @file oskar_sky_create_view.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Creates an empty view of a sky model.
+ *
+ * @details
+ * This function creates an empty sky model that can later be pointed at
+ * another sky model in the same memory location using oskar_sky_set_view().
+ *
+ * Source positions, spectral parameters and shape parameters in the view
+ * are aliases to the arrays in the source model, and are not copied.
+ * Only the Stokes parameters and reference frequencies are held as
+ * copies, so that oskar_sky_scale_flux_with_frequency() can be used on
+ * the view without modifying the source model.
+ *
+ * The view must be deallocated using oskar_sky_free() when it is
+ * no longer required.
+ *
+ * @param[in]  type         Enumerated data type of arrays.
+ * @param[in]  location     Memory location of sky model.
+ * @param[in,out]  status   Status return code.
+ *
+ * @return A handle to the new data structure.
+ */
+OSKAR_EXPORT
+oskar_Sky* oskar_sky_create_view(int type, int location, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_SKY_FLUX_TABLE_H_
+#define OSKAR_SKY_FLUX_TABLE_H_
+
+/**
+ * @file oskar_sky_flux_table.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates a table of source Stokes parameters for each frequency channel.
+ *
+ * @details
+ * For each source and each channel, this evaluates the Stokes parameters
+ * with spectral index and rotation measure applied, exactly as done by
+ * oskar_sky_scale_flux_with_frequency(), starting from the fluxes at the
+ * reference frequency. The sky model itself is not modified.
+ *
+ * The table has dimension order [Stokes][channel][source], with the
+ * Stokes parameters in the order I, Q, U, V. It must have the same
+ * precision and location as the sky model, and is resized if necessary.
+ *
+ * @param[in]  sky           The sky model.
+ * @param[in]  num_channels  Number of frequency channels.
+ * @param[in]  freq_start_hz Frequency of the first channel, in Hz.
+ * @param[in]  freq_inc_hz   Frequency increment between channels, in Hz.
+ * @param[out] table         The output table.
+ * @param[in,out]  status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_flux_table(const oskar_Sky* sky, int num_channels,
+        double freq_start_hz, double freq_inc_hz, oskar_Mem* table,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
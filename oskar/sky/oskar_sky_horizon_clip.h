@@ -60,6 +60,33 @@ void oskar_sky_horizon_clip(oskar_Sky* out, const oskar_Sky* in,
         const oskar_Telescope* telescope, double gast,
         oskar_StationWork* work, int* status);
 
+/**
+ * @brief
+ * Compacts a sky model into another one by removing sources below the
+ * horizon of all stations, using a precomputed table.
+ *
+ * @details
+ * This gives the same result as oskar_sky_horizon_clip(), but uses
+ * the table of visibility intervals from oskar_sky_horizon_table(),
+ * so that in most cases each source can be tested without looping
+ * over stations. Only sources within the spread of station longitudes
+ * of rising or setting are tested against each station.
+ *
+ * All inputs must be in CPU memory.
+ *
+ * @param[out] out          The output sky model.
+ * @param[in]  in           The input sky model.
+ * @param[in]  table        Table from oskar_sky_horizon_table().
+ * @param[in]  telescope    The telescope model used to make the table.
+ * @param[in]  gast         The Greenwich apparent sidereal time, in radians.
+ * @param[in]  work         Work arrays.
+ * @param[in,out]  status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_horizon_clip_table(oskar_Sky* out, const oskar_Sky* in,
+        const oskar_Mem* table, const oskar_Telescope* telescope,
+        double gast, oskar_StationWork* work, int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_SKY_HORIZON_TABLE_H_
+#define OSKAR_SKY_HORIZON_TABLE_H_
+
+/**
+ * @file oskar_sky_horizon_table.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/oskar_telescope.h>
+
+/* Margin in the sine of the elevation for sources close to the horizon. */
+#define OSKAR_SKY_HORIZON_MARGIN 1e-4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates a table of hour-angle visibility intervals for each source.
+ *
+ * @details
+ * For each source, this evaluates two half-widths, in hour angle:
+ * that of the interval for which the source is certainly above the
+ * horizon of a station at the most northerly or southerly latitude,
+ * and the largest one for which it may be above the horizon of any
+ * station, together with the longitude of the first station.
+ * Both intervals allow a margin of OSKAR_SKY_HORIZON_MARGIN in the sine
+ * of the elevation, to cover rounding errors in the horizon test
+ * used by oskar_sky_horizon_clip(), which may be in single precision.
+ * This depends only on the source declination and the station
+ * latitudes, so it only needs to be evaluated once for a fixed telescope.
+ *
+ * The table is used by oskar_sky_horizon_clip_table() to clip the sky
+ * model at each time step without looping over all stations.
+ *
+ * The table holds three double-precision values per source, and is resized
+ * if necessary. Both the sky model and the table must be in CPU memory.
+ *
+ * @param[in]  sky          The sky model.
+ * @param[in]  telescope    The telescope model.
+ * @param[out] table        The output table.
+ * @param[in,out]  status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_horizon_table(const oskar_Sky* sky,
+        const oskar_Telescope* telescope, oskar_Mem* table, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
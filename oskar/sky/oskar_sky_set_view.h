@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_SKY_SET_VIEW_H_
+#define OSKAR_SKY_SET_VIEW_H_
+
+/**
+ * @file oskar_sky_set_view.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Points a sky model view at another sky model.
+ *
+ * @details
+ * Sets the view (created using oskar_sky_create_view()) to refer to the
+ * sources in \p src. Only the Stokes parameters and reference frequencies
+ * are copied; all other source arrays are aliased.
+ *
+ * The source model must not be resized or freed while the view
+ * refers to it.
+ *
+ * @param[in,out] view     Sky model view to set.
+ * @param[in]     src      Sky model to refer to.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_set_view(oskar_Sky* view, const oskar_Sky* src, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
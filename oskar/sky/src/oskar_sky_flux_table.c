@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "sky/oskar_sky.h"
+#include "sky/oskar_sky_flux_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_sky_flux_table(const oskar_Sky* sky, int num_channels,
+        double freq_start_hz, double freq_inc_hz, oskar_Mem* table,
+        int* status)
+{
+    int c, i;
+    if (*status) return;
+    const int type = oskar_sky_precision(sky);
+    const int location = oskar_sky_mem_location(sky);
+    if (oskar_mem_type(table) != type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (oskar_mem_location(table) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    const int num_sources = oskar_sky_num_sources(sky);
+    const size_t num_per_stokes = (size_t) num_channels * num_sources;
+    oskar_mem_ensure(table, 4 * num_per_stokes, status);
+
+    /* Use a work sky model holding only the columns needed for scaling. */
+    oskar_Sky* work = oskar_sky_create(type, location, num_sources, status);
+    const oskar_Mem* src[] = {
+            oskar_sky_I_const(sky), oskar_sky_Q_const(sky),
+            oskar_sky_U_const(sky), oskar_sky_V_const(sky),
+            oskar_sky_reference_freq_hz_const(sky)
+    };
+    oskar_Mem* dst[] = {
+            oskar_sky_I(work), oskar_sky_Q(work),
+            oskar_sky_U(work), oskar_sky_V(work),
+            oskar_sky_reference_freq_hz(work)
+    };
+    oskar_mem_copy_contents(oskar_sky_spectral_index(work),
+            oskar_sky_spectral_index_const(sky), 0, 0, num_sources, status);
+    oskar_mem_copy_contents(oskar_sky_rotation_measure_rad(work),
+            oskar_sky_rotation_measure_rad_const(sky), 0, 0, num_sources,
+            status);
+    for (c = 0; c < num_channels; ++c)
+    {
+        /* Always scale from the reference frequency. */
+        for (i = 0; i < 5; ++i)
+            oskar_mem_copy_contents(dst[i], src[i], 0, 0, num_sources,
+                    status);
+        oskar_sky_scale_flux_with_frequency(work,
+                freq_start_hz + c * freq_inc_hz, status);
+        for (i = 0; i < 4; ++i)
+            oskar_mem_copy_contents(table, dst[i],
+                    i * num_per_stokes + (size_t) c * num_sources, 0,
+                    num_sources, status);
+    }
+    oskar_sky_free(work, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,11 +26,14 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "math/oskar_cmath.h"
 #include "math/oskar_prefix_sum.h"
 #include "sky/oskar_sky.h"
 #include "sky/oskar_sky_copy_source_data.h"
 #include "sky/oskar_update_horizon_mask.h"
 
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -106,6 +109,144 @@ static double ha0(double longitude, double ra0, double gast)
     return (gast + longitude) - ra0;
 }
 
+static double wrap(double x)
+{
+    return x - 2.0 * M_PI * floor((x + M_PI) / (2.0 * M_PI));
+}
+
+/* Sets the mask for a source using the same test as
+ * oskar_update_horizon_mask(), in the precision of the sky model. */
+#define HORIZON_MASK_STATIONS(FP) {\
+    const FP* l_ = oskar_mem_ ## FP ## _const(oskar_sky_l_const(in), status);\
+    const FP* m_ = oskar_mem_ ## FP ## _const(oskar_sky_m_const(in), status);\
+    const FP* n_ = oskar_mem_ ## FP ## _const(oskar_sky_n_const(in), status);\
+    for (j = 0; j < num_coeffs && !visible; ++j)\
+        visible = (l_[i] * coeffs[3 * j] + m_[i] * coeffs[3 * j + 1] +\
+                n_[i] * coeffs[3 * j + 2]) > (FP) 0;\
+    }
+
+
+void oskar_sky_horizon_clip_table(oskar_Sky* out, const oskar_Sky* in,
+        const oskar_Mem* table, const oskar_Telescope* telescope,
+        double gast, oskar_StationWork* work, int* status)
+{
+    int i, j, first = -1, num_coeffs = 0;
+    double lon0 = 0.0, d_min = 0.0, d_max = 0.0;
+    if (*status) return;
+
+    /* Check types and locations. */
+    if (oskar_sky_precision(in) != oskar_sky_precision(out))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    oskar_Mem* horizon_mask = oskar_station_work_horizon_mask(work);
+    if (oskar_sky_mem_location(in) != OSKAR_CPU ||
+            oskar_sky_mem_location(out) != OSKAR_CPU ||
+            oskar_mem_location(table) != OSKAR_CPU ||
+            oskar_mem_location(horizon_mask) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    const int num_in = oskar_sky_num_sources(in);
+    if ((int) oskar_mem_length(table) < 3 * num_in)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Find the spread of station longitudes, and the coefficients used
+     * by oskar_update_horizon_mask() for each station. */
+    const int num_stations = oskar_telescope_num_stations(telescope);
+    float* coeffs = (float*) calloc(3 * (size_t) num_stations + 1,
+            sizeof(float));
+    if (!coeffs)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    const double ra0 = oskar_sky_reference_ra_rad(in);
+    const double dec0 = oskar_sky_reference_dec_rad(in);
+    const double sin_dec0 = sin(dec0), cos_dec0 = cos(dec0);
+    for (j = 0; j < num_stations; ++j)
+    {
+        const oskar_Station* s = oskar_telescope_station_const(telescope, j);
+        if (!s) continue;
+        const double lon = oskar_station_lon_rad(s);
+        const double lat = oskar_station_lat_rad(s);
+        if (first < 0)
+        {
+            first = j;
+            lon0 = lon;
+        }
+        const double d = wrap(lon - lon0);
+        if (d < d_min) d_min = d;
+        if (d > d_max) d_max = d;
+        const double ha0_rad = ha0(lon, ra0, gast);
+        const double sin_lat = sin(lat), cos_lat = cos(lat);
+        const double cos_ha0 = cos(ha0_rad);
+        coeffs[3 * num_coeffs] = (float) (cos_lat * sin(ha0_rad));
+        coeffs[3 * num_coeffs + 1] = (float) (sin_lat * cos_dec0 -
+                cos_lat * cos_ha0 * sin_dec0);
+        coeffs[3 * num_coeffs + 2] = (float) (sin_lat * sin_dec0 +
+                cos_lat * cos_ha0 * cos_dec0);
+        num_coeffs++;
+    }
+    if (first < 0)
+    {
+        free(coeffs);
+        *status = OSKAR_ERR_SETTINGS_TELESCOPE;
+        return;
+    }
+    const double lon_mid = lon0 + 0.5 * (d_min + d_max);
+    const double lon_spread = 0.5 * (d_max - d_min);
+
+    /* Resize the output sky model and work buffer if necessary. */
+    if (oskar_sky_capacity(out) < num_in)
+        oskar_sky_resize(out, num_in, status);
+    oskar_mem_ensure(horizon_mask, num_in, status);
+    if (*status)
+    {
+        free(coeffs);
+        return;
+    }
+
+    /* Create the horizon mask.
+     * The table intervals include a margin, so only sources that are
+     * within it of the horizon of some station are tested against each
+     * station, in the same way as in oskar_sky_horizon_clip(). */
+    const int type = oskar_sky_precision(in);
+    const void* ra_rad = oskar_mem_void_const(oskar_sky_ra_rad_const(in));
+    const double* t = oskar_mem_double_const(table, status);
+    int* mask = oskar_mem_int(horizon_mask, status);
+    for (i = 0; i < num_in; ++i)
+    {
+        int visible = 0;
+        const double inner = t[3 * i], outer = t[3 * i + 1];
+        const double ra = (type == OSKAR_DOUBLE) ?
+                ((const double*) ra_rad)[i] : ((const float*) ra_rad)[i];
+        const double ha = gast - ra;
+        if (inner >= M_PI)
+            visible = 1;
+        else if (outer <= 0.0)
+            visible = 0;
+        else if (fabs(wrap(ha + t[3 * i + 2])) < inner)
+            visible = 1;
+        else if (fabs(wrap(ha + lon_mid)) >= outer + lon_spread)
+            visible = 0;
+        else if (type == OSKAR_DOUBLE)
+            HORIZON_MASK_STATIONS(double)
+        else
+            HORIZON_MASK_STATIONS(float)
+        mask[i] = visible;
+    }
+    free(coeffs);
+
+    /* Copy sources above horizon. */
+    oskar_sky_copy_source_data(in, horizon_mask, 0, out, status);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "math/oskar_cmath.h"
+#include "sky/oskar_sky.h"
+#include "sky/oskar_sky_horizon_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns the half-width, in hour angle, of the interval in which
+ * sin(elevation) = a + b cos(ha) is greater than the given threshold. */
+static double half_width(double a, double b, double threshold)
+{
+    if (threshold - a <= -b)
+        return M_PI;  /* Always above threshold. */
+    if (threshold - a >= b)
+        return 0.0;   /* Never above threshold. */
+    return acos((threshold - a) / b);
+}
+
+
+void oskar_sky_horizon_table(const oskar_Sky* sky,
+        const oskar_Telescope* telescope, oskar_Mem* table, int* status)
+{
+    int i, i_min = -1, i_max = -1;
+    double lat_min = 0.0, lat_max = 0.0;
+    if (*status) return;
+    if (oskar_sky_mem_location(sky) != OSKAR_CPU ||
+            oskar_mem_location(table) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    if (oskar_mem_type(table) != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+
+    /* Find the stations with the extreme latitudes.
+     * The visible hour-angle range increases monotonically with
+     * tan(lat) * tan(dec), so one of these always gives the widest range.
+     * With a small margin below the horizon, the widest range is still
+     * at one of them, but not always the same one. */
+    const int num_stations = oskar_telescope_num_stations(telescope);
+    for (i = 0; i < num_stations; ++i)
+    {
+        const oskar_Station* s = oskar_telescope_station_const(telescope, i);
+        if (!s) continue;
+        const double lat = oskar_station_lat_rad(s);
+        if (i_min < 0 || lat < lat_min) { i_min = i; lat_min = lat; }
+        if (i_max < 0 || lat > lat_max) { i_max = i; lat_max = lat; }
+    }
+    if (i_min < 0)
+    {
+        *status = OSKAR_ERR_SETTINGS_TELESCOPE;
+        return;
+    }
+    const double lon_at_min = oskar_station_lon_rad(
+            oskar_telescope_station_const(telescope, i_min));
+    const double lon_at_max = oskar_station_lon_rad(
+            oskar_telescope_station_const(telescope, i_max));
+
+    /* Evaluate the table. */
+    const int num_sources = oskar_sky_num_sources(sky);
+    const int type = oskar_sky_precision(sky);
+    const void* dec_rad = oskar_mem_void_const(oskar_sky_dec_rad_const(sky));
+    oskar_mem_ensure(table, 3 * (size_t) num_sources, status);
+    double* t = oskar_mem_double(table, status);
+    if (*status) return;
+    for (i = 0; i < num_sources; ++i)
+    {
+        const double dec = (type == OSKAR_DOUBLE) ?
+                ((const double*) dec_rad)[i] : ((const float*) dec_rad)[i];
+        const double lat = (dec >= 0.0) ? lat_max : lat_min;
+
+        /* The source is above the horizon if
+         * sin(lat) sin(dec) + cos(lat) cos(dec) cos(ha) > 0.
+         * The inner interval is where it is certainly above the horizon
+         * of the station at this latitude, and the outer interval is
+         * where it may be above the horizon of any station. */
+        const double sin_dec = sin(dec), cos_dec = cos(dec);
+        const double w_min = half_width(sin(lat_min) * sin_dec,
+                cos(lat_min) * cos_dec, -OSKAR_SKY_HORIZON_MARGIN);
+        const double w_max = half_width(sin(lat_max) * sin_dec,
+                cos(lat_max) * cos_dec, -OSKAR_SKY_HORIZON_MARGIN);
+        t[3 * i] = half_width(sin(lat) * sin_dec, cos(lat) * cos_dec,
+                OSKAR_SKY_HORIZON_MARGIN);
+        t[3 * i + 1] = (w_min > w_max) ? w_min : w_max;
+        t[3 * i + 2] = (dec >= 0.0) ? lon_at_max : lon_at_min;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
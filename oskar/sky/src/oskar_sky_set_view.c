@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "sky/private_sky.h"
+#include "sky/oskar_sky.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void copy_array(oskar_Mem* dst, const oskar_Mem* src, int num,
+        int* status)
+{
+    if ((int) oskar_mem_length(dst) < num)
+        oskar_mem_realloc(dst, num, status);
+    oskar_mem_copy_contents(dst, src, 0, 0, num, status);
+}
+
+void oskar_sky_set_view(oskar_Sky* view, const oskar_Sky* src, int* status)
+{
+    int num_sources;
+    if (*status) return;
+    if (view->precision != src->precision)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (view->mem_location != src->mem_location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+
+    /* Copy meta data. */
+    num_sources = src->num_sources;
+    view->num_sources = num_sources;
+    view->use_extended = src->use_extended;
+    view->reference_ra_rad = src->reference_ra_rad;
+    view->reference_dec_rad = src->reference_dec_rad;
+
+    /* Copy the arrays that may be modified. */
+    copy_array(view->I, src->I, num_sources, status);
+    copy_array(view->Q, src->Q, num_sources, status);
+    copy_array(view->U, src->U, num_sources, status);
+    copy_array(view->V, src->V, num_sources, status);
+    copy_array(view->reference_freq_hz, src->reference_freq_hz,
+            num_sources, status);
+    view->capacity = (int) oskar_mem_length(view->I);
+
+    /* Alias everything else. */
+    oskar_mem_set_alias(view->ra_rad, src->ra_rad, 0, num_sources, status);
+    oskar_mem_set_alias(view->dec_rad, src->dec_rad, 0, num_sources, status);
+    oskar_mem_set_alias(view->spectral_index, src->spectral_index,
+            0, num_sources, status);
+    oskar_mem_set_alias(view->rm_rad, src->rm_rad, 0, num_sources, status);
+    oskar_mem_set_alias(view->l, src->l, 0, num_sources, status);
+    oskar_mem_set_alias(view->m, src->m, 0, num_sources, status);
+    oskar_mem_set_alias(view->n, src->n, 0, num_sources, status);
+    oskar_mem_set_alias(view->fwhm_major_rad, src->fwhm_major_rad,
+            0, num_sources, status);
+    oskar_mem_set_alias(view->fwhm_minor_rad, src->fwhm_minor_rad,
+            0, num_sources, status);
+    oskar_mem_set_alias(view->pa_rad, src->pa_rad, 0, num_sources, status);
+    oskar_mem_set_alias(view->gaussian_a, src->gaussian_a,
+            0, num_sources, status);
+    oskar_mem_set_alias(view->gaussian_b, src->gaussian_b,
+            0, num_sources, status);
+    oskar_mem_set_alias(view->gaussian_c, src->gaussian_c,
+            0, num_sources, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
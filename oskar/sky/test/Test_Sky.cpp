@@ -35,6 +35,7 @@
 #include "utility/oskar_timer.h"
 #include "utility/oskar_device.h"
 
+#include <cstring>
 #include <cstdlib>
 #include "math/oskar_cmath.h"
 
@@ -104,6 +105,69 @@ TEST(oskar_Sky, copy)
 }
 
 
+TEST(SkyModel, view)
+{
+    int num_sources = 1000, status = 0;
+    double freq_ref = 100e6, freq_new = 200e6, spix = -0.7;
+
+    // Create and fill a sky model.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, &status);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        double value = (double)i;
+        oskar_sky_set_source(sky, i, value, value,
+                value, value, value, value,
+                freq_ref, spix, 0.0, 0.0, 0.0, 0.0, &status);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Set a view of it, and scale the fluxes in the view.
+    oskar_Sky* view = oskar_sky_create_view(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    oskar_sky_set_view(view, sky, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(num_sources, oskar_sky_num_sources(view));
+    oskar_sky_scale_flux_with_frequency(view, freq_new, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check positions are shared, and fluxes in the original are unchanged.
+    EXPECT_EQ(oskar_mem_void_const(oskar_sky_ra_rad_const(sky)),
+            oskar_mem_void_const(oskar_sky_ra_rad_const(view)));
+    EXPECT_NE(oskar_mem_void_const(oskar_sky_I_const(sky)),
+            oskar_mem_void_const(oskar_sky_I_const(view)));
+    const double factor = pow(freq_new / freq_ref, spix);
+    const double* I_sky = oskar_mem_double_const(
+            oskar_sky_I_const(sky), &status);
+    const double* I_view = oskar_mem_double_const(
+            oskar_sky_I_const(view), &status);
+    const double* dec_view = oskar_mem_double_const(
+            oskar_sky_dec_rad_const(view), &status);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        EXPECT_DOUBLE_EQ((double)i, I_sky[i]);
+        EXPECT_DOUBLE_EQ(i * factor, I_view[i]);
+        EXPECT_DOUBLE_EQ((double)i, dec_view[i]);
+    }
+
+    // Point the view at a smaller model.
+    oskar_Sky* sky2 = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU, 10, &status);
+    oskar_sky_set_view(view, sky2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(10, oskar_sky_num_sources(view));
+
+    // Check a type mismatch is reported.
+    oskar_Sky* view_f = oskar_sky_create_view(OSKAR_SINGLE,
+            OSKAR_CPU, &status);
+    oskar_sky_set_view(view_f, sky, &status);
+    EXPECT_EQ((int)OSKAR_ERR_TYPE_MISMATCH, status);
+    status = 0;
+
+    oskar_sky_free(view_f, &status);
+    oskar_sky_free(view, &status);
+    oskar_sky_free(sky2, &status);
+    oskar_sky_free(sky, &status);
+}
+
 TEST(SkyModel, append)
 {
     int status = 0;
@@ -571,6 +635,149 @@ TEST(SkyModel, horizon_clip)
 }
 
 
+TEST(SkyModel, horizon_clip_table)
+{
+    const double deg2rad = M_PI / 180.0;
+    const int types[] = {OSKAR_DOUBLE, OSKAR_SINGLE};
+    for (int type_index = 0; type_index < 2; ++type_index)
+    {
+        int status = 0;
+        const int type = types[type_index];
+
+        // Generate a grid of sources over the whole sky.
+        const int n_lat = 91, n_lon = 180, n_sources = n_lat * n_lon;
+        oskar_Sky* sky = oskar_sky_create(type, OSKAR_CPU, n_sources,
+                &status);
+        for (int i = 0, k = 0; i < n_lat; ++i)
+        {
+            for (int j = 0; j < n_lon; ++j, ++k)
+            {
+                const double ra = j * 2.0 + 0.3;
+                const double dec = -90.0 + i * 2.0;
+                oskar_sky_set_source(sky, k, ra * deg2rad, dec * deg2rad,
+                        1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+                        &status);
+            }
+        }
+        oskar_sky_evaluate_relative_directions(sky, 0.0, -M_PI / 6,
+                &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Create a telescope model with a wide spread of station positions.
+        const int n_stations = 64;
+        oskar_Telescope* tel = oskar_telescope_create(type,
+                OSKAR_CPU, n_stations, &status);
+        for (int i = 0; i < n_stations; ++i)
+        {
+            const double lon = 116.0 + 2.0 * sin(i * 0.7);
+            const double lat = -27.0 + 3.0 * cos(i * 1.3);
+            oskar_station_set_position(oskar_telescope_station(tel, i),
+                    lon * deg2rad, lat * deg2rad, 0.0, 0.0, 0.0, 0.0);
+        }
+
+        // Evaluate the table.
+        oskar_Mem* table = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0,
+                &status);
+        oskar_sky_horizon_table(sky, tel, table, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Check the clipped sky models are the same at many times.
+        oskar_StationWork* work = oskar_station_work_create(type,
+                OSKAR_CPU, &status);
+        oskar_Sky* out1 = oskar_sky_create(type, OSKAR_CPU, 0, &status);
+        oskar_Sky* out2 = oskar_sky_create(type, OSKAR_CPU, 0, &status);
+        const size_t element_size = oskar_mem_element_size(type);
+        for (int t = 0; t < 97; ++t)
+        {
+            const double gast = t * 2.0 * M_PI / 96.0 + 0.01;
+            oskar_sky_horizon_clip(out1, sky, tel, gast, work, &status);
+            oskar_sky_horizon_clip_table(out2, sky, table, tel, gast,
+                    work, &status);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            const int num_out = oskar_sky_num_sources(out1);
+            ASSERT_EQ(num_out, oskar_sky_num_sources(out2));
+            EXPECT_GT(num_out, 0);
+            EXPECT_LT(num_out, n_sources);
+            EXPECT_EQ(0, memcmp(
+                    oskar_mem_void_const(oskar_sky_ra_rad_const(out1)),
+                    oskar_mem_void_const(oskar_sky_ra_rad_const(out2)),
+                    num_out * element_size));
+            EXPECT_EQ(0, memcmp(
+                    oskar_mem_void_const(oskar_sky_dec_rad_const(out1)),
+                    oskar_mem_void_const(oskar_sky_dec_rad_const(out2)),
+                    num_out * element_size));
+        }
+
+        oskar_sky_free(out1, &status);
+        oskar_sky_free(out2, &status);
+        oskar_station_work_free(work, &status);
+        oskar_mem_free(table, &status);
+        oskar_telescope_free(tel, &status);
+        oskar_sky_free(sky, &status);
+    }
+}
+
+
+TEST(SkyModel, flux_table)
+{
+    int status = 0;
+    const int type = OSKAR_DOUBLE, n_sources = 100, n_channels = 5;
+    const double freq_start = 100e6, freq_inc = 10e6;
+
+    // Create a sky model with a range of spectral indices and RMs.
+    oskar_Sky* sky = oskar_sky_create(type, OSKAR_CPU, n_sources, &status);
+    for (int i = 0; i < n_sources; ++i)
+        oskar_sky_set_source(sky, i, 0.0, 0.0,
+                1.0 + i, 0.1 * i, -0.2 * i, 0.01 * i,
+                (i % 3 == 0) ? 0.0 : 120e6, -0.7 + 0.01 * i, 0.5 * i,
+                0.0, 0.0, 0.0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Evaluate the table.
+    oskar_Mem* table = oskar_mem_create(type, OSKAR_CPU, 0, &status);
+    oskar_sky_flux_table(sky, n_channels, freq_start, freq_inc,
+            table, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ((size_t) 4 * n_channels * n_sources, oskar_mem_length(table));
+
+    // Check the input sky model has not been modified.
+    EXPECT_DOUBLE_EQ(2.0, oskar_mem_get_element(oskar_sky_I(sky), 1, &status));
+    EXPECT_DOUBLE_EQ(120e6, oskar_mem_get_element(
+            oskar_sky_reference_freq_hz(sky), 1, &status));
+
+    // Check each channel against fluxes scaled from the reference frequency.
+    const double* t = oskar_mem_double_const(table, &status);
+    for (int c = 0; c < n_channels; ++c)
+    {
+        oskar_Sky* copy = oskar_sky_create_copy(sky, OSKAR_CPU, &status);
+        oskar_sky_scale_flux_with_frequency(copy,
+                freq_start + c * freq_inc, &status);
+        const oskar_Mem* flux[] = {
+                oskar_sky_I_const(copy), oskar_sky_Q_const(copy),
+                oskar_sky_U_const(copy), oskar_sky_V_const(copy)
+        };
+        for (int s = 0; s < 4; ++s)
+        {
+            const double* f = oskar_mem_double_const(flux[s], &status);
+            for (int i = 0; i < n_sources; ++i)
+                ASSERT_EQ(f[i], t[(s * n_channels + c) * n_sources + i]);
+        }
+        oskar_sky_free(copy, &status);
+    }
+
+    // Check a precision mismatch is reported.
+    oskar_Mem* table_f = oskar_mem_create(OSKAR_SINGLE, OSKAR_CPU, 0, &status);
+    oskar_sky_flux_table(sky, n_channels, freq_start, freq_inc,
+            table_f, &status);
+    EXPECT_EQ((int) OSKAR_ERR_TYPE_MISMATCH, status);
+    status = 0;
+
+    oskar_mem_free(table_f, &status);
+    oskar_mem_free(table, &status);
+    oskar_sky_free(sky, &status);
+}
+
+
 TEST(SkyModel, resize)
 {
     int status = 0;
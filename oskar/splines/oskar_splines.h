@@ -100,6 +100,15 @@ const oskar_Mem* oskar_splines_coeff_const(const oskar_Splines* data);
 OSKAR_EXPORT
 double oskar_splines_smoothing_factor(const oskar_Splines* data);
 
+/**
+ * @brief
+ * Returns the memory used by the spline data, in bytes.
+ *
+ * @param[in] data Pointer to data structure (may be NULL).
+ */
+OSKAR_EXPORT
+size_t oskar_splines_memory_size(const oskar_Splines* data);
+
 /**
  * @brief
  * Copies the contents of one data structure to another data structure.
@@ -153,6 +162,7 @@ void oskar_splines_free(oskar_Splines* data, int* status);
 #endif
 
 #include <splines/oskar_splines_evaluate.h>
+#include <splines/oskar_splines_evaluate_group.h>
 #include <splines/oskar_splines_fit.h>
 
 #endif /* OSKAR_SPLINES_H_ */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_SPLINES_EVALUATE_GROUP_H_
+#define OSKAR_SPLINES_EVALUATE_GROUP_H_
+
+/**
+ * @file oskar_splines_evaluate_group.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates a group of surfaces at the same positions.
+ *
+ * @details
+ * This function evaluates a group of fitted surfaces at the same
+ * set of positions, writing the values from surface k at
+ * output[i * stride_out + offset_out + k].
+ *
+ * The results are the same as calling oskar_splines_evaluate() for each
+ * surface, but if there are four surfaces which share the same knots
+ * (as is usual for the components of an element pattern), the b-splines
+ * are evaluated only once per point on the CPU.
+ *
+ * @param[in] num_splines Number of surfaces in the group.
+ * @param[in] splines     Array of pointers to the surfaces.
+ * @param[in] num_points  Number of positions.
+ * @param[in] x           List of x coordinates.
+ * @param[in] y           List of y coordinates.
+ * @param[in] stride_out  Stride between output points.
+ * @param[in] offset_out  Offset into output array.
+ * @param[out] output     Output values.
+ * @param[in,out] status  Status return code.
+ */
+OSKAR_EXPORT
+void oskar_splines_evaluate_group(int num_splines,
+        const oskar_Splines* const* splines, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, int stride_out,
+        int offset_out, oskar_Mem* output, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -95,6 +95,15 @@ double oskar_splines_smoothing_factor(const oskar_Splines* data)
     return data->smoothing_factor;
 }
 
+size_t oskar_splines_memory_size(const oskar_Splines* data)
+{
+    if (!data) return 0;
+    return sizeof(oskar_Splines) +
+            oskar_mem_size_bytes(data->knots_x_theta) +
+            oskar_mem_size_bytes(data->knots_y_phi) +
+            oskar_mem_size_bytes(data->coeff);
+}
+
 void oskar_splines_copy(oskar_Splines* dst, const oskar_Splines* src,
         int* status)
 {
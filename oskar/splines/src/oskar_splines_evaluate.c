@@ -26,14 +26,18 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "splines/oskar_dierckx_bispev.h"
+#include "splines/define_dierckx_bispev_bicubic.h"
 #include "splines/oskar_splines.h"
 #include "utility/oskar_device.h"
+#include "utility/oskar_kernel_macros.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+OSKAR_DIERCKX_BISPEV_BICUBIC(dierckx_bispev_bicubic_f, float)
+OSKAR_DIERCKX_BISPEV_BICUBIC(dierckx_bispev_bicubic_d, double)
+
 void oskar_splines_evaluate(const oskar_Splines* spline,
         int num_points, const oskar_Mem* x, const oskar_Mem* y,
         int stride_out, int offset_out, oskar_Mem* output, int* status)
@@ -61,67 +65,38 @@ void oskar_splines_evaluate(const oskar_Splines* spline,
     if (location == OSKAR_CPU)
     {
         int i;
+        if (nx != 0 && ny != 0 && (nx < 8 || ny < 8))
+        {
+            *status = OSKAR_ERR_SPLINE_EVAL_FAIL;
+            return;
+        }
         if (type == OSKAR_SINGLE)
         {
-            const float *tx_, *ty_, *coeff_, *x_, *y_;
-            float *out;
-            tx_    = oskar_mem_float_const(tx, status);
-            ty_    = oskar_mem_float_const(ty, status);
-            coeff_ = oskar_mem_float_const(coeff, status);
-            x_     = oskar_mem_float_const(x, status);
-            y_     = oskar_mem_float_const(y, status);
-            out    = oskar_mem_float(output, status) + offset_out;
-            if (nx == 0 || ny == 0 || !tx_ || !ty_ || !coeff_)
+            float* out = oskar_mem_float(output, status) + offset_out;
+            if (nx == 0 || ny == 0)
                 for (i = 0; i < num_points; ++i) out[i * stride_out] = 0.0f;
             else
-            {
-                float x1, y1, wrk[8];
-                int iwrk1[2], kwrk1 = 2, lwrk = 8, err = 0;
-                for (i = 0; i < num_points; ++i)
-                {
-                    x1 = x_[i];
-                    y1 = y_[i];
-                    oskar_dierckx_bispev_f(tx_, nx, ty_, ny, coeff_, 3, 3,
-                            &x1, 1, &y1, 1, &out[i * stride_out],
-                            wrk, lwrk, iwrk1, kwrk1, &err);
-                    if (err != 0)
-                    {
-                        *status = OSKAR_ERR_SPLINE_EVAL_FAIL;
-                        return;
-                    }
-                }
-            }
+                dierckx_bispev_bicubic_f(
+                        oskar_mem_float_const(tx, status), nx,
+                        oskar_mem_float_const(ty, status), ny,
+                        oskar_mem_float_const(coeff, status), num_points,
+                        oskar_mem_float_const(x, status),
+                        oskar_mem_float_const(y, status),
+                        stride_out, 0, out);
         }
         else if (type == OSKAR_DOUBLE)
         {
-            const double *tx_, *ty_, *coeff_, *x_, *y_;
-            double *out;
-            tx_    = oskar_mem_double_const(tx, status);
-            ty_    = oskar_mem_double_const(ty, status);
-            coeff_ = oskar_mem_double_const(coeff, status);
-            x_     = oskar_mem_double_const(x, status);
-            y_     = oskar_mem_double_const(y, status);
-            out    = oskar_mem_double(output, status) + offset_out;
-            if (nx == 0 || ny == 0 || !tx_ || !ty_ || !coeff_)
+            double* out = oskar_mem_double(output, status) + offset_out;
+            if (nx == 0 || ny == 0)
                 for (i = 0; i < num_points; ++i) out[i * stride_out] = 0.0;
             else
-            {
-                double x1, y1, wrk[8];
-                int iwrk1[2], kwrk1 = 2, lwrk = 8, err = 0;
-                for (i = 0; i < num_points; ++i)
-                {
-                    x1 = x_[i];
-                    y1 = y_[i];
-                    oskar_dierckx_bispev_d(tx_, nx, ty_, ny, coeff_, 3, 3,
-                            &x1, 1, &y1, 1, &out[i * stride_out],
-                            wrk, lwrk, iwrk1, kwrk1, &err);
-                    if (err != 0)
-                    {
-                        *status = OSKAR_ERR_SPLINE_EVAL_FAIL;
-                        return;
-                    }
-                }
-            }
+                dierckx_bispev_bicubic_d(
+                        oskar_mem_double_const(tx, status), nx,
+                        oskar_mem_double_const(ty, status), ny,
+                        oskar_mem_double_const(coeff, status), num_points,
+                        oskar_mem_double_const(x, status),
+                        oskar_mem_double_const(y, status),
+                        stride_out, 0, out);
         }
         else
             *status = OSKAR_ERR_BAD_DATA_TYPE;
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "splines/define_dierckx_bispev_bicubic.h"
+#include "splines/oskar_splines.h"
+#include "utility/oskar_kernel_macros.h"
+
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_SPLINES 8
+
+/* Finds l such that t[l-1] <= x < t[l], for 4 <= l <= nk1. */
+#define FIND_KNOT_INTERVAL(t, nk1, x, l) {\
+    int hi_ = nk1;\
+    l = 4;\
+    while (l < hi_) {\
+        const int mid_ = (l + hi_) / 2;\
+        if (x < t[mid_]) hi_ = mid_; else l = mid_ + 1;\
+    }\
+}\
+
+/* Evaluates a group of bicubic surfaces at each point, in the same way as
+ * OSKAR_DIERCKX_BISPEV_BICUBIC. The b-splines are evaluated again only if
+ * the knots differ from those of the previous surface in the group. */
+#define OSKAR_SPLINES_EVALUATE_GROUP(NAME, FP) KERNEL(NAME) (\
+        const int num_splines, const FP* const* tx_, const int* nx_,\
+        const FP* const* ty_, const int* ny_, const FP* const* c_,\
+        const int* new_knots, const int n, GLOBAL_IN(FP, x),\
+        GLOBAL_IN(FP, y), const int stride_out, const int offset_out,\
+        GLOBAL_OUT(FP, z))\
+{\
+    KERNEL_LOOP_PAR_X(int, i, 0, n)\
+    int k, l, l1 = 0, l2, nk1 = 0, lx;\
+    FP hh[3], wx[4], wy[4];\
+    for (k = 0; k < num_splines; ++k) {\
+        const FP *tx = tx_[k], *ty = ty_[k], *c = c_[k];\
+        FP t = (FP)0;\
+        if (!c) {\
+            z[i * stride_out + offset_out + k] = t;\
+            continue;\
+        }\
+        if (new_knots[k]) {\
+            FP x1 = x[i], y1 = y[i];\
+            nk1 = nx_[k] - 4;\
+            t = tx[3];   if (x1 < t) x1 = t;\
+            t = tx[nk1]; if (x1 > t) x1 = t;\
+            FIND_KNOT_INTERVAL(tx, nk1, x1, l)\
+            FPBSPL(FP, tx, 3, x1, l, wx)\
+            lx = l - 4;\
+            nk1 = ny_[k] - 4;\
+            t = ty[3];   if (y1 < t) y1 = t;\
+            t = ty[nk1]; if (y1 > t) y1 = t;\
+            FIND_KNOT_INTERVAL(ty, nk1, y1, l)\
+            FPBSPL(FP, ty, 3, y1, l, wy)\
+            l1 = lx * nk1 + (l - 4);\
+        }\
+        t = (FP)0;\
+        for (l = 0, l2 = l1; l <= 3; ++l, l2 += nk1 - 4) {\
+            for (int j = 0; j <= 3; ++j, ++l2) t += c[l2] * wx[l] * wy[j];\
+        }\
+        z[i * stride_out + offset_out + k] = t;\
+    }\
+    KERNEL_LOOP_END\
+}\
+
+OSKAR_SPLINES_EVALUATE_GROUP(splines_evaluate_group_f, float)
+OSKAR_SPLINES_EVALUATE_GROUP(splines_evaluate_group_d, double)
+
+/* Returns true if the splines have the same knots. */
+static int same_knots(const oskar_Splines* a, const oskar_Splines* b)
+{
+    const int nx = oskar_splines_num_knots_x_theta(a);
+    const int ny = oskar_splines_num_knots_y_phi(a);
+    const size_t size = oskar_mem_element_size(oskar_splines_precision(a));
+    if (a == b) return 1;
+    if (nx != oskar_splines_num_knots_x_theta(b) ||
+            ny != oskar_splines_num_knots_y_phi(b))
+        return 0;
+    return !memcmp(oskar_mem_void_const(oskar_splines_knots_x_theta_const(a)),
+            oskar_mem_void_const(oskar_splines_knots_x_theta_const(b)),
+            nx * size) &&
+            !memcmp(oskar_mem_void_const(oskar_splines_knots_y_phi_const(a)),
+            oskar_mem_void_const(oskar_splines_knots_y_phi_const(b)),
+            ny * size);
+}
+
+void oskar_splines_evaluate_group(int num_splines,
+        const oskar_Splines* const* splines, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, int stride_out,
+        int offset_out, oskar_Mem* output, int* status)
+{
+    int i, nx[MAX_SPLINES], ny[MAX_SPLINES], new_knots[MAX_SPLINES];
+    const void *tx[MAX_SPLINES], *ty[MAX_SPLINES], *c[MAX_SPLINES];
+    if (*status || num_splines <= 0) return;
+    const int type = oskar_mem_type(x);
+    const int location = oskar_mem_location(output);
+
+    /* Use the single-surface version on GPUs. */
+    if (location != OSKAR_CPU || num_splines > MAX_SPLINES)
+    {
+        for (i = 0; i < num_splines; ++i)
+            oskar_splines_evaluate(splines[i], num_points, x, y,
+                    stride_out, offset_out + i, output, status);
+        return;
+    }
+    if (type != oskar_mem_type(y))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (location != oskar_mem_location(x) || location != oskar_mem_location(y))
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+
+    /* Check the surfaces, and find which ones share knots. */
+    for (i = 0; i < num_splines; ++i)
+    {
+        const oskar_Splines* s = splines[i];
+        if (oskar_splines_precision(s) != type)
+        {
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+            return;
+        }
+        if (oskar_splines_mem_location(s) != location)
+        {
+            *status = OSKAR_ERR_LOCATION_MISMATCH;
+            return;
+        }
+        nx[i] = oskar_splines_num_knots_x_theta(s);
+        ny[i] = oskar_splines_num_knots_y_phi(s);
+        tx[i] = oskar_mem_void_const(oskar_splines_knots_x_theta_const(s));
+        ty[i] = oskar_mem_void_const(oskar_splines_knots_y_phi_const(s));
+        c[i] = oskar_mem_void_const(oskar_splines_coeff_const(s));
+        if (nx[i] == 0 || ny[i] == 0 || !tx[i] || !ty[i]) c[i] = 0;
+        else if (nx[i] < 8 || ny[i] < 8)
+        {
+            *status = OSKAR_ERR_SPLINE_EVAL_FAIL;
+            return;
+        }
+        new_knots[i] = (i == 0 || !c[i - 1] ||
+                !same_knots(splines[i - 1], s));
+    }
+
+    /* Evaluate the surfaces. */
+    if (type == OSKAR_DOUBLE)
+        splines_evaluate_group_d(num_splines, (const double* const*) tx, nx,
+                (const double* const*) ty, ny, (const double* const*) c,
+                new_knots, num_points, oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status), stride_out, offset_out,
+                (double*) oskar_mem_void(output));
+    else if (type == OSKAR_SINGLE)
+        splines_evaluate_group_f(num_splines, (const float* const*) tx, nx,
+                (const float* const*) ty, ny, (const float* const*) c,
+                new_knots, num_points, oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status), stride_out, offset_out,
+                (float*) oskar_mem_void(output));
+    else
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+}
+
+#ifdef __cplusplus
+}
+#endif
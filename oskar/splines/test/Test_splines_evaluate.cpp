@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "splines/oskar_splines.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/* Cox-de Boor recursion for the b-spline of degree k starting at knot i.
+ * The last non-empty knot interval is closed on the right. */
+static double bspline(const double* t, int n, int i, int k, double x)
+{
+    if (k == 0)
+    {
+        if (t[i] <= x && x < t[i + 1]) return 1.0;
+        return (x == t[n - 4] && t[i + 1] == x && t[i] < x) ? 1.0 : 0.0;
+    }
+    double v = 0.0;
+    if (t[i + k] > t[i])
+        v += (x - t[i]) / (t[i + k] - t[i]) * bspline(t, n, i, k - 1, x);
+    if (t[i + k + 1] > t[i + 1])
+        v += (t[i + k + 1] - x) / (t[i + k + 1] - t[i + 1]) *
+                bspline(t, n, i + 1, k - 1, x);
+    return v;
+}
+
+static double bispev_reference(const oskar_Splines* s, double x, double y,
+        int* status)
+{
+    const int nx = oskar_splines_num_knots_x_theta(s);
+    const int ny = oskar_splines_num_knots_y_phi(s);
+    const double* tx = oskar_mem_double_const(
+            oskar_splines_knots_x_theta_const(s), status);
+    const double* ty = oskar_mem_double_const(
+            oskar_splines_knots_y_phi_const(s), status);
+    const double* c = oskar_mem_double_const(
+            oskar_splines_coeff_const(s), status);
+    x = std::min(std::max(x, tx[3]), tx[nx - 4]);
+    y = std::min(std::max(y, ty[3]), ty[ny - 4]);
+    double z = 0.0;
+    for (int i = 0; i < nx - 4; ++i)
+    {
+        const double bx = bspline(tx, nx, i, 3, x);
+        if (bx == 0.0) continue;
+        for (int j = 0; j < ny - 4; ++j)
+            z += c[i * (ny - 4) + j] * bx * bspline(ty, ny, j, 3, y);
+    }
+    return z;
+}
+
+static oskar_Splines* fit_surface(int k, int* status)
+{
+    const int side = 25, num_points = side * side;
+    std::vector<double> x(num_points), y(num_points);
+    std::vector<double> z(num_points), w(num_points, 1.0);
+    for (int i = 0; i < num_points; ++i)
+    {
+        x[i] = (i % side) / (double) (side - 1);
+        y[i] = (i / side) / (double) (side - 1);
+        z[i] = sin((3.0 + k) * x[i]) * cos((2.0 + k) * y[i]) + k;
+    }
+    double avg_frac_err = 0.01;
+    oskar_Splines* s = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, status);
+    oskar_splines_fit(s, num_points, &x[0], &y[0], &z[0], &w[0],
+            OSKAR_SPLINES_LINEAR, 1, &avg_frac_err, 1.5, 1, 1e-14, status);
+    return s;
+}
+
+TEST(splines, evaluate_group)
+{
+    int status = 0;
+    const int num_points = 5000;
+    oskar_Splines* s[4];
+    for (int k = 0; k < 4; ++k) s[k] = fit_surface(k, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate evaluation points, including some outside the fitted area.
+    oskar_Mem *x, *y;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    double* x_ = oskar_mem_double(x, &status);
+    double* y_ = oskar_mem_double(y, &status);
+    srand(1);
+    for (int i = 0; i < num_points; ++i)
+    {
+        x_[i] = 1.1 * rand() / (double) RAND_MAX - 0.05;
+        y_[i] = 1.1 * rand() / (double) RAND_MAX - 0.05;
+    }
+
+    // Check each surface against the reference implementation.
+    oskar_Mem* out_single = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            4 * num_points, &status);
+    double* out = oskar_mem_double(out_single, &status);
+    for (int k = 0; k < 4; ++k)
+    {
+        oskar_splines_evaluate(s[k], num_points, x, y, 4, k,
+                out_single, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        for (int i = 0; i < num_points; ++i)
+        {
+            const double z1 = bispev_reference(s[k], x_[i], y_[i], &status);
+            ASSERT_NEAR(z1, out[4 * i + k], 1e-12);
+        }
+    }
+
+    // Check that evaluating the surfaces as a group gives the same results.
+    oskar_Mem* out_group = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            4 * num_points, &status);
+    oskar_splines_evaluate_group(4, s, num_points, x, y, 4, 0,
+            out_group, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double* out2 = oskar_mem_double_const(out_group, &status);
+    for (int i = 0; i < 4 * num_points; ++i)
+        ASSERT_EQ(out[i], out2[i]);
+
+    // Check a group in which surfaces share knots.
+    const oskar_Splines* shared[] = {s[2], s[2], s[1], s[1]};
+    oskar_splines_evaluate_group(4, shared, num_points, x, y, 4, 0,
+            out_group, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    for (int i = 0; i < num_points; ++i)
+    {
+        ASSERT_EQ(out[4 * i + 2], out2[4 * i + 0]);
+        ASSERT_EQ(out[4 * i + 2], out2[4 * i + 1]);
+        ASSERT_EQ(out[4 * i + 1], out2[4 * i + 2]);
+        ASSERT_EQ(out[4 * i + 1], out2[4 * i + 3]);
+    }
+
+    for (int k = 0; k < 4; ++k) oskar_splines_free(s[k], &status);
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(out_single, &status);
+    oskar_mem_free(out_group, &status);
+}
@@ -176,6 +176,50 @@ double oskar_telescope_phase_centre_latitude_rad(const oskar_Telescope* model);
 OSKAR_EXPORT
 double oskar_telescope_channel_bandwidth_hz(const oskar_Telescope* model);
 
+/**
+ * @brief
+ * Returns the flag specifying whether the CPU correlator uses cache blocking.
+ *
+ * @details
+ * Returns the flag specifying whether the CPU correlator uses cache blocking.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return True if the cache-blocked correlator is enabled.
+ */
+OSKAR_EXPORT
+int oskar_telescope_correlator_tiled(const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the number of stations in each block of the CPU correlator.
+ *
+ * @details
+ * Returns the number of stations in each block of the CPU correlator.
+ * A value of 0 means the block size is chosen automatically.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The number of stations in each correlator block.
+ */
+OSKAR_EXPORT
+int oskar_telescope_correlator_station_tile(const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the number of sources in each block of the CPU correlator.
+ *
+ * @details
+ * Returns the number of sources in each block of the CPU correlator.
+ * A value of 0 means the block size is chosen automatically.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The number of sources in each correlator block.
+ */
+OSKAR_EXPORT
+int oskar_telescope_correlator_source_tile(const oskar_Telescope* model);
+
 /**
  * @brief
  * Returns the TEC screen height, in km.
@@ -351,6 +395,91 @@ OSKAR_EXPORT
 int oskar_telescope_allow_station_beam_duplication(
         const oskar_Telescope* model);
 
+/**
+ * @brief
+ * Returns the maximum distance between stations that share a beam.
+ *
+ * @details
+ * Returns the maximum distance between stations that can share a
+ * station beam, if station beam duplication is enabled.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The maximum distance, in metres.
+ */
+OSKAR_EXPORT
+double oskar_telescope_station_beam_max_distance_m(
+        const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the number of grid points per beam width for beam interpolation.
+ *
+ * @details
+ * Returns the number of grid points per beam width used when
+ * interpolating aperture array station beams, or 0 if beam interpolation
+ * is disabled.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The number of grid points per beam width.
+ */
+OSKAR_EXPORT
+int oskar_telescope_station_beam_interp_samples(
+        const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the maximum memory used for beam interpolation grids.
+ *
+ * @details
+ * Returns the maximum memory used for beam interpolation grids
+ * on each device, in MB.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The maximum memory size, in MB.
+ */
+OSKAR_EXPORT
+double oskar_telescope_station_beam_interp_cache_mb(
+        const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the number of station beam equivalence classes.
+ *
+ * @details
+ * Returns the number of station beam equivalence classes found by
+ * oskar_telescope_analyse(), or 0 if the telescope has not been analysed.
+ *
+ * Stations in the same class have identical layouts, element models and
+ * beamforming parameters, no time-variable element errors, and are within
+ * the maximum beam duplication distance of the first station in the class.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The number of station beam classes.
+ */
+OSKAR_EXPORT
+int oskar_telescope_num_station_beam_classes(const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the station beam equivalence class of each station.
+ *
+ * @details
+ * Returns an integer array in CPU memory, giving the index of the first
+ * station in the beam equivalence class of each station.
+ * The array is empty if the telescope has not been analysed.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The station beam class array.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_telescope_station_beam_class_const(
+        const oskar_Telescope* model);
+
 /**
  * @brief
  * Returns the flag specifying whether numerical element patterns are enabled.
@@ -365,6 +494,23 @@ int oskar_telescope_allow_station_beam_duplication(
 OSKAR_EXPORT
 int oskar_telescope_enable_numerical_patterns(const oskar_Telescope* model);
 
+/**
+ * @brief
+ * Returns the tolerance used to tabulate numerical element patterns.
+ *
+ * @details
+ * Returns the maximum relative interpolation error allowed when
+ * numerical element patterns are tabulated on loading,
+ * or 0 if they are not tabulated.
+ *
+ * @param[in] model   Pointer to telescope model.
+ *
+ * @return The tabulation tolerance.
+ */
+OSKAR_EXPORT
+double oskar_telescope_element_tabulation_tolerance(
+        const oskar_Telescope* model);
+
 /**
  * @brief
  * Returns the flag specifying whether an ionospheric phase screen is enabled.
@@ -651,6 +797,43 @@ OSKAR_EXPORT
 void oskar_telescope_set_allow_station_beam_duplication(oskar_Telescope* model,
         int value);
 
+/**
+ * @brief
+ * Sets the maximum distance between stations that share a beam.
+ *
+ * @details
+ * Sets the maximum distance between stations that can share a
+ * station beam, if station beam duplication is enabled.
+ * By default, there is no limit.
+ *
+ * This must be set before calling oskar_telescope_analyse().
+ *
+ * @param[in] model            Pointer to telescope model.
+ * @param[in] max_distance_m   Maximum distance, in metres.
+ */
+OSKAR_EXPORT
+void oskar_telescope_set_station_beam_max_distance(oskar_Telescope* model,
+        double max_distance_m);
+
+/**
+ * @brief
+ * Sets the parameters for aperture array station beam interpolation.
+ *
+ * @details
+ * If enabled, aperture array station beams are evaluated on a grid
+ * covering the whole sky, and interpolated at the source positions,
+ * rather than being evaluated directly at each source.
+ * This is an approximation that can be much faster for large sky models.
+ *
+ * @param[in] model                   Pointer to telescope model.
+ * @param[in] samples_per_beam_width  Grid points per beam width,
+ *                                    or 0 to disable interpolation.
+ * @param[in] max_cache_size_mb       Maximum memory for grids, in MB.
+ */
+OSKAR_EXPORT
+void oskar_telescope_set_station_beam_interpolation(oskar_Telescope* model,
+        int samples_per_beam_width, double max_cache_size_mb);
+
 /**
  * @brief
  * Sets the channel bandwidth, used for bandwidth smearing.
@@ -665,6 +848,23 @@ OSKAR_EXPORT
 void oskar_telescope_set_channel_bandwidth(oskar_Telescope* model,
         double bandwidth_hz);
 
+/**
+ * @brief
+ * Sets the cache blocking parameters used by the CPU correlator.
+ *
+ * @details
+ * Sets the cache blocking parameters used by the CPU correlator.
+ * Block sizes of 0 are chosen automatically.
+ *
+ * @param[in] model          Pointer to telescope model.
+ * @param[in] enabled        If true, use the cache-blocked correlator.
+ * @param[in] station_tile   Number of stations in each block.
+ * @param[in] source_tile    Number of sources in each block.
+ */
+OSKAR_EXPORT
+void oskar_telescope_set_correlator_tiling(oskar_Telescope* model,
+        int enabled, int station_tile, int source_tile);
+
 /**
  * @brief
  * Sets the ionosphere screen type.
@@ -708,6 +908,23 @@ OSKAR_EXPORT
 void oskar_telescope_set_enable_numerical_patterns(oskar_Telescope* model,
         int value);
 
+/**
+ * @brief
+ * Sets the tolerance used to tabulate numerical element patterns.
+ *
+ * @details
+ * If the tolerance is greater than zero, numerical element pattern data
+ * are resampled onto regular grids as the telescope model is loaded,
+ * using oskar_element_tabulate(). This must be set before calling
+ * oskar_telescope_load().
+ *
+ * @param[in] model      Pointer to telescope model.
+ * @param[in] tolerance  Maximum relative interpolation error (0 = off).
+ */
+OSKAR_EXPORT
+void oskar_telescope_set_element_tabulation_tolerance(oskar_Telescope* model,
+        double tolerance);
+
 /**
  * @brief
  * Sets the Gaussian station beam parameters.
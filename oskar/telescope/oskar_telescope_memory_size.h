@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_TELESCOPE_MEMORY_SIZE_H_
+#define OSKAR_TELESCOPE_MEMORY_SIZE_H_
+
+/**
+ * @file oskar_telescope_memory_size.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Returns the memory used by a telescope model, in bytes.
+ *
+ * @details
+ * Returns the memory used by the telescope model and all its stations.
+ * Gain tables held in external files are not included.
+ *
+ * @param[in] model Pointer to telescope model (may be NULL).
+ *
+ * @return The memory used, in bytes.
+ */
+OSKAR_EXPORT
+size_t oskar_telescope_memory_size(const oskar_Telescope* model);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -58,6 +58,7 @@ private:
     void load_spherical_wave_data(oskar_Station* station,
             const std::vector<std::string>& keys,
             const std::vector<std::string>& paths, int* status);
+    void tabulate_element_patterns(oskar_Station* station, int* status);
     static void parse_filename(const char* s, char** buffer, size_t* buflen,
             int* index, double* freq);
     void update_map(std::map<std::string, std::string>& files,
@@ -68,6 +69,7 @@ private:
     std::string fit_root_x, fit_root_y, fit_root_scalar;
     std::string root_x, root_y;
     oskar_Telescope* telescope_;
+    std::vector<const oskar_Element*> tabulated_;
 };
 
 #endif /* OSKAR_TELESCOPE_LOADER_ELEMENT_PATTERN_H_ */
@@ -29,6 +29,9 @@ struct oskar_Telescope
     double uv_filter_min;        /* Minimum allowed UV distance. */
     double uv_filter_max;        /* Maximum allowed UV distance. */
     int uv_filter_units;         /* Unit of allowed UV distance (OSKAR_METRES or OSKAR_WAVELENGTHS). */
+    int correlator_tiled;        /* Flag set if the CPU correlator uses cache blocking. */
+    int correlator_station_tile; /* Number of stations per correlator block (0 = auto). */
+    int correlator_source_tile;  /* Number of sources per correlator block (0 = auto). */
     int noise_enabled;           /* Flag set if thermal noise is enabled. */
     unsigned int noise_seed;     /* Random generator seed. */
 
@@ -54,7 +57,13 @@ struct oskar_Telescope
     int max_station_depth;                             /* Maximum station depth. */
     int identical_stations;                            /* True if all stations are identical. */
     int allow_station_beam_duplication;                /* True if station beam duplication is allowed. */
+    double station_beam_max_distance_m;               /* Maximum distance between stations sharing a beam, in metres. */
+    int num_station_beam_classes;                      /* Number of station beam equivalence classes. */
+    oskar_Mem* station_beam_class;                     /* Index of first station in the beam class of each station. */
+    int station_beam_interp_samples;                   /* Grid points per beam width for beam interpolation (0 = off). */
+    double station_beam_interp_cache_mb;               /* Maximum memory for beam interpolation grids, in MB. */
     int enable_numerical_patterns;                     /* True if numerical element patterns are enabled. */
+    double element_tabulation_tolerance;               /* Tolerance for tabulated element patterns (0 = off). */
 };
 
 #ifndef OSKAR_TELESCOPE_TYPEDEF_
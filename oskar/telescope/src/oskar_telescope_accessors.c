@@ -72,6 +72,21 @@ double oskar_telescope_channel_bandwidth_hz(const oskar_Telescope* model)
     return model->channel_bandwidth_hz;
 }
 
+int oskar_telescope_correlator_tiled(const oskar_Telescope* model)
+{
+    return model->correlator_tiled;
+}
+
+int oskar_telescope_correlator_station_tile(const oskar_Telescope* model)
+{
+    return model->correlator_station_tile;
+}
+
+int oskar_telescope_correlator_source_tile(const oskar_Telescope* model)
+{
+    return model->correlator_source_tile;
+}
+
 double oskar_telescope_tec_screen_height_km(const oskar_Telescope* model)
 {
     return model->tec_screen_height_km;
@@ -134,6 +149,35 @@ int oskar_telescope_allow_station_beam_duplication(
     return model->allow_station_beam_duplication;
 }
 
+double oskar_telescope_station_beam_max_distance_m(
+        const oskar_Telescope* model)
+{
+    return model->station_beam_max_distance_m;
+}
+
+int oskar_telescope_station_beam_interp_samples(
+        const oskar_Telescope* model)
+{
+    return model->station_beam_interp_samples;
+}
+
+double oskar_telescope_station_beam_interp_cache_mb(
+        const oskar_Telescope* model)
+{
+    return model->station_beam_interp_cache_mb;
+}
+
+int oskar_telescope_num_station_beam_classes(const oskar_Telescope* model)
+{
+    return model->num_station_beam_classes;
+}
+
+const oskar_Mem* oskar_telescope_station_beam_class_const(
+        const oskar_Telescope* model)
+{
+    return model->station_beam_class;
+}
+
 char oskar_telescope_ionosphere_screen_type(const oskar_Telescope* model)
 {
     return (char) (model->ionosphere_screen_type);
@@ -144,6 +188,12 @@ int oskar_telescope_enable_numerical_patterns(const oskar_Telescope* model)
     return model->enable_numerical_patterns;
 }
 
+double oskar_telescope_element_tabulation_tolerance(
+        const oskar_Telescope* model)
+{
+    return model->element_tabulation_tolerance;
+}
+
 int oskar_telescope_max_station_size(const oskar_Telescope* model)
 {
     return model->max_station_size;
@@ -253,6 +303,19 @@ void oskar_telescope_set_allow_station_beam_duplication(oskar_Telescope* model,
     model->allow_station_beam_duplication = value;
 }
 
+void oskar_telescope_set_station_beam_max_distance(oskar_Telescope* model,
+        double max_distance_m)
+{
+    model->station_beam_max_distance_m = max_distance_m;
+}
+
+void oskar_telescope_set_station_beam_interpolation(oskar_Telescope* model,
+        int samples_per_beam_width, double max_cache_size_mb)
+{
+    model->station_beam_interp_samples = samples_per_beam_width;
+    model->station_beam_interp_cache_mb = max_cache_size_mb;
+}
+
 void oskar_telescope_set_ionosphere_screen_type(oskar_Telescope* model,
         const char* type)
 {
@@ -272,6 +335,12 @@ void oskar_telescope_set_enable_numerical_patterns(oskar_Telescope* model,
     model->enable_numerical_patterns = value;
 }
 
+void oskar_telescope_set_element_tabulation_tolerance(oskar_Telescope* model,
+        double tolerance)
+{
+    model->element_tabulation_tolerance = tolerance;
+}
+
 static void oskar_telescope_set_gaussian_station_beam_p(oskar_Station* station,
         double fwhm_rad, double ref_freq_hz)
 {
@@ -483,6 +552,14 @@ void oskar_telescope_set_channel_bandwidth(oskar_Telescope* model,
     model->channel_bandwidth_hz = bandwidth_hz;
 }
 
+void oskar_telescope_set_correlator_tiling(oskar_Telescope* model,
+        int enabled, int station_tile, int source_tile)
+{
+    model->correlator_tiled = enabled;
+    model->correlator_station_tile = station_tile;
+    model->correlator_source_tile = source_tile;
+}
+
 void oskar_telescope_set_time_average(oskar_Telescope* model,
         double time_average_sec)
 {
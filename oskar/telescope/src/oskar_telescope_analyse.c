@@ -32,6 +32,9 @@
 #include "telescope/station/oskar_station_analyse.h"
 #include "telescope/station/oskar_station_different.h"
 
+#include <math.h>
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -81,6 +84,244 @@ static void set_child_station_locations(oskar_Station* s,
 }
 
 
+static unsigned long long hash_bytes(unsigned long long hash,
+        const void* data, size_t num_bytes)
+{
+    size_t i;
+    const unsigned char* p = (const unsigned char*) data;
+    for (i = 0; i < num_bytes; ++i)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+/* Returns a hash of the station layout and element types, used to avoid
+ * a full comparison between stations that are obviously different. */
+static unsigned long long station_hash(const oskar_Station* s)
+{
+    int dim;
+    unsigned long long hash = 14695981039346656037ULL;
+    const int num_elements = oskar_station_num_elements(s);
+    const int num_element_types = oskar_station_num_element_types(s);
+    const oskar_Mem* types = oskar_station_element_types_const(s);
+    hash = hash_bytes(hash, &num_elements, sizeof(int));
+    hash = hash_bytes(hash, &num_element_types, sizeof(int));
+    for (dim = 0; dim < 3; ++dim)
+    {
+        const oskar_Mem* enu =
+                oskar_station_element_true_enu_metres_const(s, 0, dim);
+        if (!enu) continue;
+        hash = hash_bytes(hash, oskar_mem_void_const(enu),
+                oskar_mem_length(enu) *
+                oskar_mem_element_size(oskar_mem_type(enu)));
+    }
+    if (types && oskar_mem_location(types) == OSKAR_CPU)
+        hash = hash_bytes(hash, oskar_mem_void_const(types),
+                oskar_mem_length(types) * sizeof(int));
+    return hash;
+}
+
+
+static double station_distance_m(const oskar_Station* a,
+        const oskar_Station* b)
+{
+    const double dx = oskar_station_offset_ecef_x(a) -
+            oskar_station_offset_ecef_x(b);
+    const double dy = oskar_station_offset_ecef_y(a) -
+            oskar_station_offset_ecef_y(b);
+    const double dz = oskar_station_offset_ecef_z(a) -
+            oskar_station_offset_ecef_z(b);
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+
+/*
+ * Groups stations that produce the same beam into equivalence classes.
+ * Each class is identified by the index of its first station.
+ * Stations with time-variable element errors are always in a class of
+ * their own, as their errors are generated independently.
+ * Stations that have been freed because they were duplicates of the first
+ * station are in the same class as the first station.
+ */
+static void set_station_beam_classes(oskar_Telescope* model,
+        const int* time_variable_errors, int* status)
+{
+    int i, j, num_classes = 0;
+    const int num_stations = model->num_stations;
+    oskar_mem_realloc(model->station_beam_class, (size_t) num_stations,
+            status);
+    unsigned long long* hash = (unsigned long long*)
+            calloc(num_stations > 0 ? num_stations : 1, sizeof(*hash));
+    int* first = (int*) calloc(num_stations > 0 ? num_stations : 1,
+            sizeof(int));
+    int* station_class = oskar_mem_int(model->station_beam_class, status);
+    if (*status || !hash || !first)
+    {
+        free(hash);
+        free(first);
+        model->num_station_beam_classes = 0;
+        return;
+    }
+    for (i = 0; i < num_stations; ++i)
+    {
+        const oskar_Station* station = oskar_telescope_station_const(model, i);
+        station_class[i] = i;
+        if (!station)
+        {
+            station_class[i] = 0;
+            continue;
+        }
+        if (!time_variable_errors[i])
+        {
+            hash[i] = station_hash(station);
+            for (j = 0; j < num_classes; ++j)
+            {
+                const int k = first[j];
+                const oskar_Station* station_k =
+                        oskar_telescope_station_const(model, k);
+                if (time_variable_errors[k] || hash[k] != hash[i] ||
+                        station_distance_m(station_k, station) >
+                        model->station_beam_max_distance_m)
+                    continue;
+                if (!oskar_station_different(station_k, station, status))
+                {
+                    station_class[i] = k;
+                    break;
+                }
+            }
+        }
+        if (station_class[i] == i)
+            first[num_classes++] = i;
+    }
+    model->num_station_beam_classes = num_classes;
+    free(hash);
+    free(first);
+}
+
+
+struct oskar_TileHash
+{
+    unsigned long long hash;
+    int index;
+};
+typedef struct oskar_TileHash oskar_TileHash;
+
+static int compare_tile_hash(const void* a, const void* b)
+{
+    const oskar_TileHash* t_a = (const oskar_TileHash*) a;
+    const oskar_TileHash* t_b = (const oskar_TileHash*) b;
+    if (t_a->hash != t_b->hash) return t_a->hash < t_b->hash ? -1 : 1;
+    return t_a->index - t_b->index;
+}
+
+
+/* Clears the tile beam class of the child stations at all levels below
+ * the given station, and appends them to the list if required. */
+static void list_tiles(oskar_Station* s, int append, int* num_tiles,
+        int* capacity, oskar_Station*** tiles)
+{
+    int i;
+    if (!oskar_station_has_child(s)) return;
+    const int num_elements = oskar_station_num_elements(s);
+    for (i = 0; i < num_elements; ++i)
+    {
+        oskar_Station* child = oskar_station_child(s, i);
+        if (!child) continue;
+        oskar_station_set_tile_beam_class(child, 0);
+        if (append && *num_tiles == *capacity)
+        {
+            oskar_Station** t = (oskar_Station**) realloc(*tiles,
+                    2 * (*capacity + 128) * sizeof(oskar_Station*));
+            if (!t) append = 0;
+            else
+            {
+                *tiles = t;
+                *capacity = 2 * (*capacity + 128);
+            }
+        }
+        if (append) (*tiles)[(*num_tiles)++] = child;
+        list_tiles(child, append, num_tiles, capacity, tiles);
+    }
+}
+
+
+/*
+ * Groups child stations (tiles) that produce the same beam into
+ * telescope-wide classes, using the same rules as for station beam
+ * classes. Tiles in stations with time-variable element errors are never
+ * grouped. Tiles are sorted by hash first, so that only tiles with the
+ * same hash are compared.
+ */
+static void set_tile_beam_classes(oskar_Telescope* model,
+        const int* time_variable_errors, int* status)
+{
+    int i, j, k, start, num_tiles = 0, capacity = 0, num_classes = 0;
+    oskar_Station** tiles = 0;
+    if (*status) return;
+    for (i = 0; i < model->num_stations; ++i)
+    {
+        oskar_Station* station = oskar_telescope_station(model, i);
+        if (!station) continue;
+        list_tiles(station, !time_variable_errors[i],
+                &num_tiles, &capacity, &tiles);
+    }
+    oskar_TileHash* hash = (oskar_TileHash*) calloc(
+            num_tiles > 0 ? num_tiles : 1, sizeof(oskar_TileHash));
+    int* first = (int*) calloc(num_tiles > 0 ? num_tiles : 1, sizeof(int));
+    int* count = (int*) calloc(num_tiles > 0 ? num_tiles : 1, sizeof(int));
+    if (!hash || !first || !count)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        num_tiles = 0;
+    }
+    for (i = 0; i < num_tiles; ++i)
+    {
+        hash[i].hash = station_hash(tiles[i]);
+        hash[i].index = i;
+    }
+    qsort(hash, (size_t) num_tiles, sizeof(oskar_TileHash),
+            compare_tile_hash);
+
+    /* Compare tiles within each run of equal hashes. */
+    for (start = 0; start < num_tiles; start = i)
+    {
+        const int first_class = num_classes;
+        for (i = start; i < num_tiles && hash[i].hash == hash[start].hash; ++i)
+        {
+            oskar_Station* tile = tiles[hash[i].index];
+            for (j = first_class; j < num_classes; ++j)
+            {
+                const oskar_Station* tile_j = tiles[first[j]];
+                if (station_distance_m(tile_j, tile) >
+                        model->station_beam_max_distance_m)
+                    continue;
+                if (!oskar_station_different(tile_j, tile, status))
+                    break;
+            }
+            if (j == num_classes)
+                first[num_classes++] = hash[i].index;
+            oskar_station_set_tile_beam_class(tile, j + 1);
+            count[j]++;
+        }
+    }
+
+    /* Tiles in a class of their own are not shared. */
+    for (k = 0; k < num_tiles; ++k)
+    {
+        const int c = oskar_station_tile_beam_class(tiles[k]);
+        if (c > 0 && count[c - 1] < 2)
+            oskar_station_set_tile_beam_class(tiles[k], 0);
+    }
+    free(tiles);
+    free(hash);
+    free(first);
+    free(count);
+}
+
+
 void oskar_telescope_analyse(oskar_Telescope* model, int* status)
 {
     int i = 0, finished_identical_station_check = 0, num_stations;
@@ -102,12 +343,26 @@ void oskar_telescope_analyse(oskar_Telescope* model, int* status)
     }
 
     /* Recursively analyse each station. */
+    int* time_variable_errors = (int*) calloc(
+            num_stations > 0 ? num_stations : 1, sizeof(int));
+    if (!time_variable_errors)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
     for (i = 0; i < num_stations; ++i)
     {
         oskar_station_analyse(oskar_telescope_station(model, i),
-                &finished_identical_station_check, status);
+                &time_variable_errors[i], status);
+        if (time_variable_errors[i])
+            finished_identical_station_check = 1;
     }
 
+    /* Find the station beam equivalence classes. */
+    set_station_beam_classes(model, time_variable_errors, status);
+    set_tile_beam_classes(model, time_variable_errors, status);
+    free(time_variable_errors);
+
     /* Check if safe to proceed. */
     if (*status) return;
 
@@ -37,8 +37,11 @@ oskar_Telescope* oskar_telescope_create(int type, int location,
     telescope->num_stations = num_stations;
     telescope->max_station_depth = 1;
     telescope->enable_numerical_patterns = 1;
+    telescope->station_beam_max_distance_m = DBL_MAX;
+    telescope->station_beam_interp_cache_mb = 1024.0;
     telescope->uv_filter_max = FLT_MAX;
     telescope->uv_filter_units = OSKAR_METRES;
+    telescope->correlator_tiled = 1;
     telescope->noise_seed = 1;
     for (i = 0; i < 3; ++i)
     {
@@ -53,6 +56,8 @@ oskar_Telescope* oskar_telescope_create(int type, int location,
     }
     telescope->tec_screen_path =
             oskar_mem_create(OSKAR_CHAR, OSKAR_CPU, 0, status);
+    telescope->station_beam_class =
+            oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
     telescope->gains = oskar_gains_create(type);
     if (num_stations > 0)
         telescope->station = (oskar_Station**) calloc(
@@ -33,7 +33,13 @@ oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
     telescope->max_station_depth = src->max_station_depth;
     telescope->identical_stations = src->identical_stations;
     telescope->allow_station_beam_duplication = src->allow_station_beam_duplication;
+    telescope->station_beam_max_distance_m = src->station_beam_max_distance_m;
+    telescope->num_station_beam_classes = src->num_station_beam_classes;
+    telescope->station_beam_interp_samples = src->station_beam_interp_samples;
+    telescope->station_beam_interp_cache_mb = src->station_beam_interp_cache_mb;
     telescope->enable_numerical_patterns = src->enable_numerical_patterns;
+    telescope->element_tabulation_tolerance =
+            src->element_tabulation_tolerance;
     telescope->lon_rad = src->lon_rad;
     telescope->lat_rad = src->lat_rad;
     telescope->alt_metres = src->alt_metres;
@@ -47,6 +53,9 @@ oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
     telescope->uv_filter_min = src->uv_filter_min;
     telescope->uv_filter_max = src->uv_filter_max;
     telescope->uv_filter_units = src->uv_filter_units;
+    telescope->correlator_tiled = src->correlator_tiled;
+    telescope->correlator_station_tile = src->correlator_station_tile;
+    telescope->correlator_source_tile = src->correlator_source_tile;
     telescope->noise_enabled = src->noise_enabled;
     telescope->noise_seed = src->noise_seed;
     telescope->ionosphere_screen_type = src->ionosphere_screen_type;
@@ -68,6 +77,8 @@ oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
     }
     oskar_mem_copy(telescope->tec_screen_path,
             src->tec_screen_path, status);
+    oskar_mem_copy(telescope->station_beam_class,
+            src->station_beam_class, status);
 
     /* Copy the gain model. */
     oskar_gains_free(telescope->gains, status);
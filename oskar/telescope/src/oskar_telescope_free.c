@@ -26,6 +26,7 @@ void oskar_telescope_free(oskar_Telescope* telescope, int* status)
         oskar_mem_free(telescope->station_measured_enu_metres[i], status);
     }
     oskar_mem_free(telescope->tec_screen_path, status);
+    oskar_mem_free(telescope->station_beam_class, status);
 
     /* Free the gain model. */
     oskar_gains_free(telescope->gains, status);
@@ -53,6 +53,10 @@ void oskar_telescope_log_summary(const oskar_Telescope* telescope,
             oskar_telescope_max_station_depth(telescope));
     oskar_log_value(log, 'M', 0, "Identical stations", "%s",
             oskar_telescope_identical_stations(telescope) ? "true" : "false");
+    if (oskar_telescope_allow_station_beam_duplication(telescope) &&
+            oskar_telescope_num_station_beam_classes(telescope) > 0)
+        oskar_log_value(log, 'M', 0, "Num. unique station beams", "%d",
+                oskar_telescope_num_station_beam_classes(telescope));
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/private_telescope.h"
+#include "telescope/oskar_telescope.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t oskar_telescope_memory_size(const oskar_Telescope* model)
+{
+    int i;
+    size_t bytes = 0;
+    if (!model) return 0;
+    bytes += sizeof(oskar_Telescope);
+    for (i = 0; i < 3; ++i)
+    {
+        bytes += oskar_mem_size_bytes(model->station_true_offset_ecef_metres[i]);
+        bytes += oskar_mem_size_bytes(model->station_true_enu_metres[i]);
+        bytes += oskar_mem_size_bytes(
+                model->station_measured_offset_ecef_metres[i]);
+        bytes += oskar_mem_size_bytes(model->station_measured_enu_metres[i]);
+    }
+    bytes += oskar_mem_size_bytes(model->tec_screen_path);
+    for (i = 0; i < model->num_stations; ++i)
+        bytes += oskar_station_memory_size(model->station[i]);
+    return bytes;
+}
+
+#ifdef __cplusplus
+}
+#endif
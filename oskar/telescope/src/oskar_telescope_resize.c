@@ -93,6 +93,10 @@ void oskar_telescope_resize(oskar_Telescope* telescope, int size, int* status)
                 size, status);
     }
 
+    /* Station beam classes must be found again. */
+    oskar_mem_realloc(telescope->station_beam_class, 0, status);
+    telescope->num_station_beam_classes = 0;
+
     /* Store the new size. */
     telescope->num_stations = size;
 }
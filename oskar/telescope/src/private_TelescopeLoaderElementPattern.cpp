@@ -170,6 +170,9 @@ void TelescopeLoaderElementPattern::load_element_patterns(
     // Load functional data.
     load_functional_data(1, station, keys_x, paths_x, status);
     load_functional_data(2, station, keys_y, paths_y, status);
+
+    // Tabulate fitted data, if required.
+    tabulate_element_patterns(station, status);
 }
 
 void TelescopeLoaderElementPattern::load_fitted_data(int feed,
@@ -256,6 +259,34 @@ void TelescopeLoaderElementPattern::load_spherical_wave_data(
     free(tmp);
 }
 
+void TelescopeLoaderElementPattern::tabulate_element_patterns(
+        oskar_Station* station, int* status)
+{
+    const double tolerance =
+            oskar_telescope_element_tabulation_tolerance(telescope_);
+    if (*status || !station || tolerance <= 0.0) return;
+    const int num_element_types = oskar_station_num_element_types(station);
+    for (int i = 0; i < num_element_types; ++i)
+    {
+        oskar_Element* element = oskar_station_element(station, i);
+
+        // Elements loaded from the same files can share the same tables.
+        size_t j = 0;
+        for (; j < tabulated_.size(); ++j)
+        {
+            if (!oskar_element_different(tabulated_[j], element, status))
+                break;
+        }
+        if (j < tabulated_.size())
+            oskar_element_share_tabulated_data(element, tabulated_[j], status);
+        else
+        {
+            oskar_element_tabulate(element, tolerance, 0, status);
+            tabulated_.push_back(element);
+        }
+    }
+}
+
 void TelescopeLoaderElementPattern::parse_filename(const char* s,
         char** buffer, size_t* buflen, int* index, double* freq)
 {
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/*
+ * Spherical wave sum, for CPUs.
+ *
+ * This is included by each translation unit that implements the sum for
+ * a particular instruction set. The VEC template parameter is a wrapper
+ * around the native vector type, as described in math/define_simd_math.h.
+ *
+ * This evaluates the same sum as OSKAR_EVALUATE_SPHERICAL_WAVE_SUM in
+ * define_evaluate_spherical_wave.h, but for one vector of points at a time.
+ * The loop over m is outside the loop over l, so that the associated
+ * Legendre functions P_l^m can be found by upward recurrence in l, starting
+ * from P_m^m, and exp(-i m phi) by complex rotation, with all of the
+ * recurrence state held in vector registers. The normalisation factors are
+ * the same for all points, and are evaluated only once.
+ */
+
+#ifndef OSKAR_DEFINE_EVALUATE_SPHERICAL_WAVE_SUM_SIMD_H_
+#define OSKAR_DEFINE_EVALUATE_SPHERICAL_WAVE_SUM_SIMD_H_
+
+#include "oskar_global.h"
+#include "math/define_simd_math.h"
+#include "math/oskar_cmath.h"
+
+#include <cmath>
+#include <vector>
+
+/* Normalisation factors for each (l, m), in the same order as the
+ * coefficients. */
+template<typename REAL>
+void oskar_sph_wave_norm(int l_max, std::vector<REAL>& norm)
+{
+    norm.assign((l_max + 1) * (l_max + 1), (REAL) 0);
+    for (int l = 1; l <= l_max; ++l)
+    {
+        const int ind0 = l * l - 1 + l;
+        const REAL f = (2 * l + 1) / (4 * ((REAL) M_PI) * l * (l + 1));
+        norm[ind0] = std::sqrt(f);
+        for (int m = 1; m <= l; ++m)
+        {
+            REAL d_fact = (REAL) 1, s_fact = (REAL) 1;
+            for (int i = 2; i <= l - m; ++i) d_fact *= i;
+            for (int i = 2; i <= l + m; ++i) s_fact *= i;
+            norm[ind0 + m] = norm[ind0 - m] = std::sqrt(f * d_fact / s_fact);
+        }
+    }
+}
+
+/* Adds one spherical wave term to the theta and phi components, as in
+ * OSKAR_SPH_WAVE. (c, s) is the normalised phase factor for order m,
+ * and pds_m is P_l^m / sin(theta) multiplied by m. */
+template<typename VEC, typename REAL2>
+inline void oskar_sph_wave_term(typename VEC::type c, typename VEC::type s,
+        typename VEC::type dpms, typename VEC::type pds_m,
+        const REAL2& a_te, const REAL2& a_tm,
+        typename VEC::type& t_re, typename VEC::type& t_im,
+        typename VEC::type& p_re, typename VEC::type& p_im)
+{
+    typedef typename VEC::type V;
+    const V zero = VEC::set1(0);
+    const V te_re = VEC::set1(a_te.x), te_im = VEC::set1(a_te.y);
+    const V tm_re = VEC::set1(a_tm.x), tm_im = VEC::set1(a_tm.y);
+    const V qq_re = VEC::sub(zero, VEC::mul(c, dpms));
+    const V qq_im = VEC::sub(zero, VEC::mul(s, dpms));
+    const V dd_re = VEC::sub(zero, VEC::mul(s, pds_m));
+    const V dd_im = VEC::mul(c, pds_m);
+
+    /* phi += qq * a_tm - dd * a_te */
+    p_re = VEC::fmadd(qq_re, tm_re, p_re);
+    p_re = VEC::fnmadd(qq_im, tm_im, p_re);
+    p_im = VEC::fmadd(qq_re, tm_im, p_im);
+    p_im = VEC::fmadd(qq_im, tm_re, p_im);
+    p_re = VEC::fnmadd(dd_re, te_re, p_re);
+    p_re = VEC::fmadd(dd_im, te_im, p_re);
+    p_im = VEC::fnmadd(dd_re, te_im, p_im);
+    p_im = VEC::fnmadd(dd_im, te_re, p_im);
+
+    /* theta += dd * a_tm + qq * a_te */
+    t_re = VEC::fmadd(dd_re, tm_re, t_re);
+    t_re = VEC::fnmadd(dd_im, tm_im, t_re);
+    t_im = VEC::fmadd(dd_re, tm_im, t_im);
+    t_im = VEC::fmadd(dd_im, tm_re, t_im);
+    t_re = VEC::fmadd(qq_re, te_re, t_re);
+    t_re = VEC::fnmadd(qq_im, te_im, t_re);
+    t_im = VEC::fmadd(qq_re, te_im, t_im);
+    t_im = VEC::fmadd(qq_im, te_re, t_im);
+}
+
+/* The coefficients and output are accessed as complex values rather than
+ * as matrices, as memory is not necessarily aligned to the size of the
+ * matrix types. */
+template<typename VEC, typename REAL2>
+void oskar_evaluate_spherical_wave_sum_simd(
+        const int                                 num_points,
+        const typename VEC::real* const RESTRICT  theta,
+        const typename VEC::real* const RESTRICT  phi_x,
+        const typename VEC::real* const RESTRICT  phi_y,
+        const int                                 l_max,
+        const REAL2* const RESTRICT               alpha,
+        const int                                 offset,
+        REAL2* RESTRICT                           pattern)
+{
+    typedef typename VEC::real REAL;
+    typedef typename VEC::type V;
+    enum { W = VEC::width };
+    std::vector<REAL> norm_;
+    oskar_sph_wave_norm(l_max, norm_);
+    const REAL* const norm = &norm_[0];
+    const int num_blocks = (num_points + W - 1) / W;
+    int b;
+#pragma omp parallel for private(b)
+    for (b = 0; b < num_blocks; ++b)
+    {
+        int k, l, m;
+        REAL t_[W], px_[W], py_[W], out[8][W];
+        const int i0 = b * W;
+        const int n = (num_points - i0 < (int) W) ? num_points - i0 : (int) W;
+        for (k = 0; k < (int) W; ++k)
+        {
+            /* Unused lanes repeat the first point of the block. */
+            const int i = i0 + (k < n ? k : 0);
+            t_[k] = theta[i];
+            px_[k] = phi_x[i];
+            py_[k] = phi_y[i];
+        }
+        const V zero = VEC::set1(0), one = VEC::set1(1);
+
+        /* Hack to avoid divide-by-zero (also in Matlab code!). */
+        V theta_ = VEC::load(t_);
+        const V theta_min = VEC::set1((REAL) 1e-5);
+        theta_ = VEC::select(VEC::cmp_lt(theta_, theta_min),
+                theta_min, theta_);
+        V sin_t, cos_t, sx, cx, sy, cy;
+        VEC::sincos(theta_, sin_t, cos_t);
+        VEC::sincos(VEC::sub(zero, VEC::load(px_)), sx, cx);
+        VEC::sincos(VEC::sub(zero, VEC::load(py_)), sy, cy);
+        const typename VEC::mask pole = VEC::cmp_eq(sin_t, zero);
+        const V inv_sin_t = VEC::select(pole, zero, VEC::div(one, sin_t));
+
+        /* Recurrence state: P_m^m, and exp(-i m phi) for X and Y. */
+        V pmm = one, cmx = one, smx = zero, cmy = one, smy = zero;
+        V xp_re = zero, xp_im = zero, xt_re = zero, xt_im = zero;
+        V yp_re = zero, yp_im = zero, yt_re = zero, yt_im = zero;
+        for (m = 0; m <= l_max; ++m)
+        {
+            if (m > 0)
+            {
+                V t;
+                pmm = VEC::mul(pmm, VEC::mul(VEC::set1((REAL) -(2 * m - 1)),
+                        sin_t));
+                t = VEC::fnmadd(smx, sx, VEC::mul(cmx, cx));
+                smx = VEC::fmadd(smx, cx, VEC::mul(cmx, sx));
+                cmx = t;
+                t = VEC::fnmadd(smy, sy, VEC::mul(cmy, cy));
+                smy = VEC::fmadd(smy, cy, VEC::mul(cmy, sy));
+                cmy = t;
+            }
+
+            /* p0 is P_l^m and p1 is P_(l+1)^m. */
+            V p0 = pmm;
+            V p1 = VEC::mul(VEC::mul(cos_t, VEC::set1((REAL) (2 * m + 1))),
+                    pmm);
+            for (l = m; l <= l_max; ++l)
+            {
+                if (l > 0)
+                {
+                    const int ind0 = l * l - 1 + l;
+                    const V nf = VEC::set1(norm[ind0 + m]);
+                    const REAL2* a_m = alpha + 4 * (ind0 - m);
+                    const REAL2* a_p = alpha + 4 * (ind0 + m);
+                    const V pds = VEC::mul(p0, inv_sin_t);
+                    const V dpms = VEC::mul(VEC::fnmadd(p1,
+                            VEC::set1((REAL) (l - m + 1)),
+                            VEC::mul(VEC::mul(cos_t, p0),
+                            VEC::set1((REAL) (l + 1)))), inv_sin_t);
+                    if (m == 0)
+                    {
+                        oskar_sph_wave_term<VEC>(nf, zero, dpms, zero,
+                                a_p[0], a_p[1], xt_re, xt_im, xp_re, xp_im);
+                        oskar_sph_wave_term<VEC>(nf, zero, dpms, zero,
+                                a_p[2], a_p[3], yt_re, yt_im, yp_re, yp_im);
+                    }
+                    else
+                    {
+                        const V pds_m = VEC::mul(pds, VEC::set1((REAL) m));
+                        const V pds_n = VEC::sub(zero, pds_m);
+                        V c = VEC::mul(cmx, nf), s = VEC::mul(smx, nf);
+                        oskar_sph_wave_term<VEC>(c, s, dpms, pds_n,
+                                a_m[0], a_m[1], xt_re, xt_im, xp_re, xp_im);
+                        s = VEC::sub(zero, s);
+                        oskar_sph_wave_term<VEC>(c, s, dpms, pds_m,
+                                a_p[0], a_p[1], xt_re, xt_im, xp_re, xp_im);
+                        c = VEC::mul(cmy, nf);
+                        s = VEC::mul(smy, nf);
+                        oskar_sph_wave_term<VEC>(c, s, dpms, pds_n,
+                                a_m[2], a_m[3], yt_re, yt_im, yp_re, yp_im);
+                        s = VEC::sub(zero, s);
+                        oskar_sph_wave_term<VEC>(c, s, dpms, pds_m,
+                                a_p[2], a_p[3], yt_re, yt_im, yp_re, yp_im);
+                    }
+                }
+
+                /* Advance the recurrence in l. */
+                const int i = l + 2;
+                const V p = VEC::div(VEC::fnmadd(VEC::set1((REAL) (i + m - 1)),
+                        p0, VEC::mul(VEC::mul(VEC::set1((REAL) (2 * i - 1)),
+                        cos_t), p1)), VEC::set1((REAL) (i - m)));
+                p0 = p1;
+                p1 = p;
+            }
+        }
+
+        /* Store the output.
+         * For some reason the theta/phi components must be reversed? */
+        VEC::store(out[0], xp_re); VEC::store(out[1], xp_im);
+        VEC::store(out[2], xt_re); VEC::store(out[3], xt_im);
+        VEC::store(out[4], yp_re); VEC::store(out[5], yp_im);
+        VEC::store(out[6], yt_re); VEC::store(out[7], yt_im);
+        for (k = 0; k < n; ++k)
+        {
+            REAL2* p = pattern + 4 * (i0 + k + offset);
+            const REAL phi_x_ = px_[k];
+            for (int c = 0; c < 4; ++c)
+            {
+                /* Propagate NAN. */
+                p[c].x = (phi_x_ != phi_x_) ? phi_x_ : out[2 * c][k];
+                p[c].y = (phi_x_ != phi_x_) ? phi_x_ : out[2 * c + 1][k];
+            }
+        }
+    }
+}
+
+/* Defines a C function for one instruction set and precision.
+ * The parameters are as for oskar_evaluate_spherical_wave_sum_simd_f(). */
+#define OSKAR_SPH_WAVE_SUM_SIMD_DEFINE(NAME, VEC, FP, FP4c)                 \
+void NAME(int num_points, const FP* theta, const FP* phi_x,                 \
+        const FP* phi_y, int l_max, const FP4c* alpha, int offset,          \
+        FP4c* pattern)                                                      \
+{                                                                           \
+    oskar_evaluate_spherical_wave_sum_simd<VEC>(num_points, theta, phi_x,   \
+            phi_y, l_max, (const FP##2*) alpha, offset, (FP##2*) pattern);  \
+}
+
+#endif /* include guard */
@@ -51,7 +51,11 @@ enum OSKAR_ELEMENT_TAGS
 {
     OSKAR_ELEMENT_TAG_SURFACE_TYPE = 1,
     OSKAR_ELEMENT_TAG_COORD_SYS = 2,
-    OSKAR_ELEMENT_TAG_MAX_RADIUS = 3
+    OSKAR_ELEMENT_TAG_MAX_RADIUS = 3,
+    OSKAR_ELEMENT_TAG_TABLE_NUM_THETA = 4,
+    OSKAR_ELEMENT_TAG_TABLE_NUM_PHI = 5,
+    OSKAR_ELEMENT_TAG_TABLE_DATA = 6,
+    OSKAR_ELEMENT_TAG_COMMON_PHI_COORDS = 7
 };
 
 enum OSKAR_ELEMENT_SURFACE_TYPE
@@ -95,9 +99,11 @@ enum OSKAR_ELEMENT_TAPER
 #include <telescope/station/element/oskar_element_load_cst.h>
 #include <telescope/station/element/oskar_element_load_scalar.h>
 #include <telescope/station/element/oskar_element_load_spherical_wave_coeff.h>
+#include <telescope/station/element/oskar_element_memory_size.h>
 #include <telescope/station/element/oskar_element_resize_freq_data.h>
 #include <telescope/station/element/oskar_element_read.h>
 #include <telescope/station/element/oskar_element_save.h>
+#include <telescope/station/element/oskar_element_tabulate.h>
 #include <telescope/station/element/oskar_element_write.h>
 
 #endif /* OSKAR_ELEMENT_H_ */
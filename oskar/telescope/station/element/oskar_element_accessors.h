@@ -62,6 +62,10 @@ OSKAR_EXPORT
 int oskar_element_has_spherical_wave_data(const oskar_Element* data,
         int freq_id);
 
+OSKAR_EXPORT
+int oskar_element_has_tabulated_data(const oskar_Element* data,
+        int freq_id);
+
 OSKAR_EXPORT
 int oskar_element_num_freq(const oskar_Element* data);
 
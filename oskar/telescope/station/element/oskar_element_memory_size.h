@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_ELEMENT_MEMORY_SIZE_H_
+#define OSKAR_ELEMENT_MEMORY_SIZE_H_
+
+/**
+ * @file oskar_element_memory_size.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Returns the memory used by an element model, in bytes.
+ *
+ * @details
+ * Returns the memory used by the element model structure and all
+ * its numerical pattern data (fitted splines and spherical wave
+ * coefficients).
+ *
+ * @param[in] data Pointer to element model (may be NULL).
+ *
+ * @return The memory used, in bytes.
+ */
+OSKAR_EXPORT
+size_t oskar_element_memory_size(const oskar_Element* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
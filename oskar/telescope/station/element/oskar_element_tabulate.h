@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_ELEMENT_TABULATE_H_
+#define OSKAR_ELEMENT_TABULATE_H_
+
+/**
+ * @file oskar_element_tabulate.h
+ */
+
+#include <oskar_global.h>
+#include <log/oskar_log.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Resamples fitted element pattern data onto regular (theta, phi) grids.
+ *
+ * @details
+ * For each frequency with spline or spherical wave data, this function
+ * evaluates the element response on a regular grid covering the whole
+ * sphere. oskar_element_evaluate() then finds the response by bicubic
+ * interpolation from the grid instead, for output arrays in CPU memory.
+ *
+ * The grid spacing starts at 5 degrees, and is halved until the maximum
+ * interpolation error at the centre of each grid cell, relative to the
+ * peak amplitude of the response, is no larger than \p tolerance.
+ * The finest spacing allowed is 0.25 degrees.
+ *
+ * Data that have already been tabulated are not changed. Tabulated data
+ * are discarded when new fitted data are loaded for the same frequency.
+ *
+ * The element model must be in CPU memory.
+ *
+ * @param[in,out] data       Element model structure.
+ * @param[in]     tolerance  Maximum relative interpolation error.
+ * @param[in,out] log        Pointer to log structure to use.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_element_tabulate(oskar_Element* data, double tolerance,
+        oskar_Log* log, int* status);
+
+/**
+ * @brief
+ * Shares tabulated element pattern data between element models.
+ *
+ * @details
+ * For each frequency in \p dst that has no tabulated data,
+ * this function makes \p dst refer to the tabulated data in \p src at
+ * the same frequency, if there are any, without copying them.
+ * It is used to avoid duplicating tables for elements loaded from the
+ * same files, so \p src must not be freed before \p dst.
+ *
+ * @param[in,out] dst        Element model structure to update.
+ * @param[in]     src        Element model structure holding the tables.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_element_share_tabulated_data(oskar_Element* dst,
+        const oskar_Element* src, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_EVALUATE_TABULATED_PATTERN_H_
+#define OSKAR_EVALUATE_TABULATED_PATTERN_H_
+
+/**
+ * @file oskar_evaluate_tabulated_pattern.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates an element pattern by interpolation from a table.
+ *
+ * @details
+ * This function evaluates an element pattern at the supplied
+ * (theta, phi) coordinates by bicubic convolution on a table made using
+ * oskar_element_tabulate().
+ *
+ * The table holds \p num_comp complex values at each grid point.
+ * Grid points are spaced evenly in theta from 0 to pi, and in phi from 0
+ * to 2 pi (exclusive). The table is padded by one row at each end in theta,
+ * by one column before the first and two columns after the last in phi.
+ *
+ * Only CPU memory is supported.
+ *
+ * @param[in] num_points         Number of points.
+ * @param[in] theta              Point position (modified) theta values in rad.
+ * @param[in] phi                Point position (modified) phi values in rad.
+ * @param[in] num_theta          Number of grid points in theta.
+ * @param[in] num_phi            Number of grid points in phi.
+ * @param[in] num_comp           Number of complex values per grid point
+ *                               (1 or 2).
+ * @param[in] table              Tabulated complex values.
+ * @param[in] stride             Stride into output array (normally 1 or 4).
+ * @param[in] offset             Start offset into output array.
+ * @param[out] pattern           Array of output Jones matrices/scalars per source.
+ * @param[in,out] status         Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_tabulated_pattern(int num_points, const oskar_Mem* theta,
+        const oskar_Mem* phi, int num_theta, int num_phi, int num_comp,
+        const oskar_Mem* table, int stride, int offset, oskar_Mem* pattern,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
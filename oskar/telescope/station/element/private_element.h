@@ -32,6 +32,17 @@
 #include <mem/oskar_mem.h>
 #include <splines/oskar_splines.h>
 
+/* Element response tabulated on a regular grid in (theta, phi).
+ * The grid is padded by one row at each pole, and by one column before
+ * and two columns after the range of phi, so interpolation needs no
+ * special cases at the edges. */
+struct oskar_ElementTable
+{
+    int num_theta, num_phi; /* Grid size, excluding the padding. */
+    oskar_Mem* data; /* Complex values; NULL if not tabulated. */
+};
+typedef struct oskar_ElementTable oskar_ElementTable;
+
 struct oskar_Element
 {
     int precision, mem_location;
@@ -70,6 +81,9 @@ struct oskar_Element
     int *common_phi_coords;
     int *l_max;
     oskar_Mem **sph_wave;
+
+    /* Tabulated data. */
+    oskar_ElementTable *tab_x, *tab_y, *tab_scalar;
 };
 
 #ifndef OSKAR_ELEMENT_TYPEDEF_
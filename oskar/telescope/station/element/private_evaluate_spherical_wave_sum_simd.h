@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_PRIVATE_EVALUATE_SPHERICAL_WAVE_SUM_SIMD_H_
+#define OSKAR_PRIVATE_EVALUATE_SPHERICAL_WAVE_SUM_SIMD_H_
+
+/**
+ * @file private_evaluate_spherical_wave_sum_simd.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+/* Declares the CPU spherical wave sum for one instruction set and precision.
+ * The parameters are as for oskar_evaluate_spherical_wave_sum_simd_f(). */
+#define OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(NAME, FP, FP4c)                   \
+void NAME(int num_points, const FP* theta, const FP* phi_x,                 \
+        const FP* phi_y, int l_max, const FP4c* alpha, int offset,          \
+        FP4c* pattern);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates the spherical wave sum on the CPU (single precision).
+ *
+ * @details
+ * This is the CPU implementation of oskar_evaluate_spherical_wave_sum(),
+ * using the best instruction set available at run time.
+ *
+ * Each vector of points is evaluated together, using recurrences in l
+ * and m that are shared by all terms of the sum.
+ * The parameters are as for oskar_evaluate_spherical_wave_sum().
+ */
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_evaluate_spherical_wave_sum_simd_f,
+        float, float4c)
+
+/**
+ * @brief
+ * Evaluates the spherical wave sum on the CPU (double precision).
+ *
+ * @details
+ * See oskar_evaluate_spherical_wave_sum_simd_f().
+ */
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_evaluate_spherical_wave_sum_simd_d,
+        double, double4c)
+
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_sph_wave_sum_scalar_f, float, float4c)
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_sph_wave_sum_scalar_d, double, double4c)
+
+#ifdef OSKAR_HAVE_AVX2
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_sph_wave_sum_avx2_f, float, float4c)
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_sph_wave_sum_avx2_d, double, double4c)
+#endif
+
+#ifdef OSKAR_HAVE_AVX512
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_sph_wave_sum_avx512_f, float, float4c)
+OSKAR_SPH_WAVE_SUM_SIMD_PROTOTYPE(oskar_sph_wave_sum_avx512_d, double, double4c)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
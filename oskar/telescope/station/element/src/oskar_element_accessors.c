@@ -81,6 +81,14 @@ int oskar_element_has_spherical_wave_data(const oskar_Element* data,
             data->l_max[freq_id] > 0);
 }
 
+int oskar_element_has_tabulated_data(const oskar_Element* data,
+        int freq_id)
+{
+    return (data->num_freq > freq_id) && ( /* Safe short-circuit. */
+            data->tab_x[freq_id].data || data->tab_y[freq_id].data ||
+            data->tab_scalar[freq_id].data);
+}
+
 int oskar_element_num_freq(const oskar_Element* data)
 {
     return data->num_freq;
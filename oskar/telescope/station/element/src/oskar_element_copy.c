@@ -33,6 +33,22 @@
 extern "C" {
 #endif
 
+static void copy_table(oskar_ElementTable* dst, const oskar_ElementTable* src,
+        int type, int location, int* status)
+{
+    dst->num_theta = src->num_theta;
+    dst->num_phi = src->num_phi;
+    if (!src->data)
+    {
+        oskar_mem_free(dst->data, status);
+        dst->data = 0;
+        return;
+    }
+    if (!dst->data)
+        dst->data = oskar_mem_create(type, location, 0, status);
+    oskar_mem_copy(dst->data, src->data, status);
+}
+
 void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
         int* status)
 {
@@ -89,6 +105,12 @@ void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
         if (src->sph_wave[i] && !dst->sph_wave[i])
             dst->sph_wave[i] = oskar_mem_create(sph_wave_type, loc, 0, status);
         oskar_mem_copy(dst->sph_wave[i], src->sph_wave[i], status);
+        copy_table(&dst->tab_x[i], &src->tab_x[i], prec | OSKAR_COMPLEX,
+                loc, status);
+        copy_table(&dst->tab_y[i], &src->tab_y[i], prec | OSKAR_COMPLEX,
+                loc, status);
+        copy_table(&dst->tab_scalar[i], &src->tab_scalar[i],
+                prec | OSKAR_COMPLEX, loc, status);
     }
 }
 
@@ -33,6 +33,7 @@
 #include "telescope/station/element/oskar_apply_element_taper_gaussian.h"
 #include "telescope/station/element/oskar_evaluate_dipole_pattern.h"
 #include "telescope/station/element/oskar_evaluate_spherical_wave_sum.h"
+#include "telescope/station/element/oskar_evaluate_tabulated_pattern.h"
 #include "convert/oskar_convert_enu_directions_to_theta_phi.h"
 #include "convert/oskar_convert_ludwig3_to_theta_phi_components.h"
 #include "convert/oskar_convert_theta_phi_to_ludwig3_components.h"
@@ -84,6 +85,8 @@ void oskar_element_evaluate(
     const int id = oskar_find_closest_match_d(frequency_hz,
             oskar_element_num_freq(model),
             oskar_element_freqs_hz_const(model));
+    const int use_table = oskar_mem_location(output) == OSKAR_CPU &&
+            oskar_element_has_tabulated_data(model, id);
     dipole_length_m = model->dipole_length;
     if (model->dipole_length_units == OSKAR_WAVELENGTHS)
         dipole_length_m *= (C_0 / frequency_hz);
@@ -102,7 +105,10 @@ void oskar_element_evaluate(
     /* Evaluate polarised response if output array is matrix type. */
     if (oskar_mem_is_matrix(output))
     {
-        if (oskar_element_has_spherical_wave_data(model, id))
+        const oskar_ElementTable* tab_x = use_table ? &model->tab_x[id] : 0;
+        const oskar_ElementTable* tab_y = use_table ? &model->tab_y[id] : 0;
+        if (oskar_element_has_spherical_wave_data(model, id) &&
+                !(tab_x && tab_x->data && tab_y->data))
         {
             oskar_evaluate_spherical_wave_sum(num_points_norm, theta, phi_x,
                     (model->common_phi_coords[id] ? phi_x : phi_y),
@@ -113,16 +119,17 @@ void oskar_element_evaluate(
         {
             const int offset_out_real = offset_out * 8;
             const int offset_out_cplx = offset_out * 4;
-            if (oskar_element_has_x_spline_data(model, id))
+            if (tab_x && tab_x->data)
+                oskar_evaluate_tabulated_pattern(num_points_norm,
+                        theta, phi_x, tab_x->num_theta, tab_x->num_phi, 2,
+                        tab_x->data, 4, offset_out_cplx + 0, output, status);
+            else if (oskar_element_has_x_spline_data(model, id))
             {
-                oskar_splines_evaluate(model->x_h_re[id], num_points_norm,
+                const oskar_Splines* splines[] = {
+                        model->x_h_re[id], model->x_h_im[id],
+                        model->x_v_re[id], model->x_v_im[id]};
+                oskar_splines_evaluate_group(4, splines, num_points_norm,
                         theta, phi_x, 8, offset_out_real + 0, output, status);
-                oskar_splines_evaluate(model->x_h_im[id], num_points_norm,
-                        theta, phi_x, 8, offset_out_real + 1, output, status);
-                oskar_splines_evaluate(model->x_v_re[id], num_points_norm,
-                        theta, phi_x, 8, offset_out_real + 2, output, status);
-                oskar_splines_evaluate(model->x_v_im[id], num_points_norm,
-                        theta, phi_x, 8, offset_out_real + 3, output, status);
                 oskar_convert_ludwig3_to_theta_phi_components(num_points_norm,
                         phi_x, 4, offset_out_cplx + 0, output, status);
             }
@@ -131,16 +138,18 @@ void oskar_element_evaluate(
                         theta, phi_x, frequency_hz, dipole_length_m,
                         4, offset_out_cplx + 0, output, status);
 
-            if (oskar_element_has_y_spline_data(model, id))
+            if (tab_y && tab_y->data)
+                oskar_evaluate_tabulated_pattern(num_points_norm, theta,
+                        (model->common_phi_coords[id] ? phi_x : phi_y),
+                        tab_y->num_theta, tab_y->num_phi, 2,
+                        tab_y->data, 4, offset_out_cplx + 2, output, status);
+            else if (oskar_element_has_y_spline_data(model, id))
             {
-                oskar_splines_evaluate(model->y_h_re[id], num_points_norm,
+                const oskar_Splines* splines[] = {
+                        model->y_h_re[id], model->y_h_im[id],
+                        model->y_v_re[id], model->y_v_im[id]};
+                oskar_splines_evaluate_group(4, splines, num_points_norm,
                         theta, phi_y, 8, offset_out_real + 4, output, status);
-                oskar_splines_evaluate(model->y_h_im[id], num_points_norm,
-                        theta, phi_y, 8, offset_out_real + 5, output, status);
-                oskar_splines_evaluate(model->y_v_re[id], num_points_norm,
-                        theta, phi_y, 8, offset_out_real + 6, output, status);
-                oskar_splines_evaluate(model->y_v_im[id], num_points_norm,
-                        theta, phi_y, 8, offset_out_real + 7, output, status);
                 oskar_convert_ludwig3_to_theta_phi_components(num_points_norm,
                         phi_y, 4, offset_out_cplx + 2, output, status);
             }
@@ -155,7 +164,13 @@ void oskar_element_evaluate(
     else /* Scalar response. */
     {
         const int offset_out_real = offset_out * 2;
-        if (oskar_element_has_scalar_spline_data(model, id))
+        const oskar_ElementTable* tab = use_table ?
+                &model->tab_scalar[id] : 0;
+        if (tab && tab->data)
+            oskar_evaluate_tabulated_pattern(num_points_norm,
+                    theta, phi_x, tab->num_theta, tab->num_phi, 1,
+                    tab->data, 1, offset_out, output, status);
+        else if (oskar_element_has_scalar_spline_data(model, id))
         {
             oskar_splines_evaluate(model->scalar_re[id], num_points_norm,
                     theta, phi_x, 2, offset_out_real + 0, output, status);
@@ -55,6 +55,9 @@ void oskar_element_free(oskar_Element* data, int* status)
         oskar_splines_free(data->scalar_re[i], status);
         oskar_splines_free(data->scalar_im[i], status);
         oskar_mem_free(data->sph_wave[i], status);
+        oskar_mem_free(data->tab_x[i].data, status);
+        oskar_mem_free(data->tab_y[i].data, status);
+        oskar_mem_free(data->tab_scalar[i].data, status);
     }
     free(data->freqs_hz);
     free(data->l_max);
@@ -73,6 +76,9 @@ void oskar_element_free(oskar_Element* data, int* status)
     free(data->scalar_re);
     free(data->scalar_im);
     free(data->sph_wave);
+    free(data->tab_x);
+    free(data->tab_y);
+    free(data->tab_scalar);
 
     /* Free the structure itself. */
     free(data);
@@ -277,6 +277,18 @@ void oskar_element_load_cst(oskar_Element* data,
         oskar_splines_copy(data->y_v_im[i], data->x_v_im[i], status);
     }
 
+    /* Discard any tabulated data for the port(s) just loaded. */
+    if (port == 0 || port == 1)
+    {
+        oskar_mem_free(data->tab_x[i].data, status);
+        data->tab_x[i].data = 0;
+    }
+    if (port == 0 || port == 2)
+    {
+        oskar_mem_free(data->tab_y[i].data, status);
+        data->tab_y[i].data = 0;
+    }
+
     /* Free local arrays. */
     oskar_mem_free(theta, status);
     oskar_mem_free(phi, status);
@@ -186,6 +186,10 @@ void oskar_element_load_scalar(oskar_Element* data,
     oskar_mem_append_raw(data->filename_scalar[i], filename, OSKAR_CHAR,
                 OSKAR_CPU, 1 + strlen(filename), status);
 
+    /* Discard any tabulated data. */
+    oskar_mem_free(data->tab_scalar[i].data, status);
+    data->tab_scalar[i].data = 0;
+
     /* Free local arrays. */
     oskar_mem_free(theta, status);
     oskar_mem_free(phi, status);
@@ -270,6 +270,12 @@ void oskar_element_load_spherical_wave_coeff(oskar_Element* data,
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
     }
 
+    /* Discard any tabulated data. */
+    oskar_mem_free(data->tab_x[i].data, status);
+    oskar_mem_free(data->tab_y[i].data, status);
+    data->tab_x[i].data = 0;
+    data->tab_y[i].data = 0;
+
     /* Free memory. */
     free(line);
     fclose(file);
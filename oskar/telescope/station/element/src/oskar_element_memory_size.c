@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/element/private_element.h"
+#include "telescope/station/element/oskar_element.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t oskar_element_memory_size(const oskar_Element* data)
+{
+    int i;
+    size_t bytes = 0;
+    if (!data) return 0;
+    bytes += sizeof(oskar_Element);
+    for (i = 0; i < data->num_freq; ++i)
+    {
+        bytes += oskar_mem_size_bytes(data->filename_x[i]);
+        bytes += oskar_mem_size_bytes(data->filename_y[i]);
+        bytes += oskar_mem_size_bytes(data->filename_scalar[i]);
+        bytes += oskar_splines_memory_size(data->x_v_re[i]);
+        bytes += oskar_splines_memory_size(data->x_v_im[i]);
+        bytes += oskar_splines_memory_size(data->x_h_re[i]);
+        bytes += oskar_splines_memory_size(data->x_h_im[i]);
+        bytes += oskar_splines_memory_size(data->y_v_re[i]);
+        bytes += oskar_splines_memory_size(data->y_v_im[i]);
+        bytes += oskar_splines_memory_size(data->y_h_re[i]);
+        bytes += oskar_splines_memory_size(data->y_h_im[i]);
+        bytes += oskar_splines_memory_size(data->scalar_re[i]);
+        bytes += oskar_splines_memory_size(data->scalar_im[i]);
+        bytes += oskar_mem_size_bytes(data->sph_wave[i]);
+        bytes += oskar_mem_size_bytes(data->tab_x[i].data);
+        bytes += oskar_mem_size_bytes(data->tab_y[i].data);
+        bytes += oskar_mem_size_bytes(data->tab_scalar[i].data);
+    }
+    return bytes;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -42,6 +42,10 @@ extern "C" {
 
 static void read_splines(oskar_Element* data, oskar_Binary* h,
         oskar_Splines** splines_ptr, int index, int* status);
+static void read_table(oskar_Element* data, oskar_Binary* h,
+        oskar_ElementTable* table, int freq_id, int* status);
+static int has_tag(oskar_Binary* h, unsigned char type,
+        unsigned char group, unsigned char tag);
 
 void oskar_element_read(oskar_Element* data, const char* filename,
         int feed, double freq_hz, int* status)
@@ -49,8 +53,9 @@ void oskar_element_read(oskar_Element* data, const char* filename,
     oskar_Splines **h_re = 0, **h_im = 0, **v_re = 0, **v_im = 0;
     oskar_Splines **scalar_re = 0, **scalar_im = 0;
     oskar_Mem **filename_ptr = 0;
+    oskar_ElementTable* table = 0;
     oskar_Binary* h = 0;
-    int i, n, surface_type = -1;
+    int i, n, surface_type = -1, have_splines;
     if (*status) return;
 
     /* Check if this frequency has already been set, and get its index if so. */
@@ -77,6 +82,7 @@ void oskar_element_read(oskar_Element* data, const char* filename,
         scalar_re = &data->scalar_re[i];
         scalar_im = &data->scalar_im[i];
         filename_ptr = &data->filename_scalar[i];
+        table = &data->tab_scalar[i];
     }
     else if (feed == 1)
     {
@@ -85,6 +91,7 @@ void oskar_element_read(oskar_Element* data, const char* filename,
         v_re = &data->x_v_re[i];
         v_im = &data->x_v_im[i];
         filename_ptr = &data->filename_x[i];
+        table = &data->tab_x[i];
     }
     else if (feed == 2)
     {
@@ -93,6 +100,7 @@ void oskar_element_read(oskar_Element* data, const char* filename,
         v_re = &data->y_v_re[i];
         v_im = &data->y_v_im[i];
         filename_ptr = &data->filename_y[i];
+        table = &data->tab_y[i];
     }
     else
     {
@@ -117,6 +125,9 @@ void oskar_element_read(oskar_Element* data, const char* filename,
         return;
     }
 
+    /* Files may contain only tabulated data. */
+    have_splines = has_tag(h, OSKAR_INT, OSKAR_TAG_GROUP_SPLINE_DATA,
+            OSKAR_SPLINES_TAG_NUM_KNOTS_X_THETA);
     if (feed == 0)
     {
         /* Check the surface type (scalar). */
@@ -124,8 +135,11 @@ void oskar_element_read(oskar_Element* data, const char* filename,
             *status = OSKAR_ERR_INVALID_ARGUMENT;
 
         /* Read data for [real], [imag] surfaces. */
-        read_splines(data, h, scalar_re, 0, status);
-        read_splines(data, h, scalar_im, 1, status);
+        if (have_splines)
+        {
+            read_splines(data, h, scalar_re, 0, status);
+            read_splines(data, h, scalar_im, 1, status);
+        }
     }
     else
     {
@@ -134,12 +148,24 @@ void oskar_element_read(oskar_Element* data, const char* filename,
             *status = OSKAR_ERR_INVALID_ARGUMENT;
 
         /* Read data for [h_re], [h_im], [v_re], [v_im] surfaces. */
-        read_splines(data, h, h_re, 0, status);
-        read_splines(data, h, h_im, 1, status);
-        read_splines(data, h, v_re, 2, status);
-        read_splines(data, h, v_im, 3, status);
+        if (have_splines)
+        {
+            read_splines(data, h, h_re, 0, status);
+            read_splines(data, h, h_im, 1, status);
+            read_splines(data, h, v_re, 2, status);
+            read_splines(data, h, v_im, 3, status);
+        }
     }
 
+    /* Read tabulated data, or discard any from a previous load. */
+    oskar_mem_free(table->data, status);
+    table->data = 0;
+    if (has_tag(h, OSKAR_INT, OSKAR_TAG_GROUP_ELEMENT_DATA,
+            OSKAR_ELEMENT_TAG_TABLE_NUM_THETA))
+        read_table(data, h, table, i, status);
+    else if (!have_splines && !*status)
+        *status = OSKAR_ERR_BINARY_TAG_NOT_FOUND;
+
     /* Store the filename. */
     if (!*filename_ptr)
         *filename_ptr = oskar_mem_create(OSKAR_CHAR, OSKAR_CPU, 0, status);
@@ -175,6 +201,33 @@ static void read_splines(oskar_Element* data, oskar_Binary* h,
             index, &splines->smoothing_factor, status);
 }
 
+static void read_table(oskar_Element* data, oskar_Binary* h,
+        oskar_ElementTable* table, int freq_id, int* status)
+{
+    if (*status) return;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_ELEMENT_DATA;
+    oskar_binary_read_int(h, group, OSKAR_ELEMENT_TAG_TABLE_NUM_THETA, 0,
+            &table->num_theta, status);
+    oskar_binary_read_int(h, group, OSKAR_ELEMENT_TAG_TABLE_NUM_PHI, 0,
+            &table->num_phi, status);
+    oskar_binary_read_int(h, group, OSKAR_ELEMENT_TAG_COMMON_PHI_COORDS, 0,
+            &data->common_phi_coords[freq_id], status);
+    table->data = oskar_mem_create(
+            oskar_element_precision(data) | OSKAR_COMPLEX,
+            oskar_element_mem_location(data), 0, status);
+    oskar_binary_read_mem(h, table->data,
+            group, OSKAR_ELEMENT_TAG_TABLE_DATA, 0, status);
+}
+
+static int has_tag(oskar_Binary* h, unsigned char type,
+        unsigned char group, unsigned char tag)
+{
+    int status = 0;
+    size_t size = 0;
+    oskar_binary_query(h, type, group, tag, 0, &size, &status);
+    return !status;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,8 @@
 #include "telescope/station/element/private_element.h"
 #include "telescope/station/element/oskar_element.h"
 
+#include <string.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,6 +65,9 @@ void oskar_element_resize_freq_data(oskar_Element* model, int size,
             model->sph_wave[i] = 0;
             model->l_max[i] = 0;
             model->common_phi_coords[i] = 0;
+            memset(&model->tab_x[i], 0, sizeof(oskar_ElementTable));
+            memset(&model->tab_y[i], 0, sizeof(oskar_ElementTable));
+            memset(&model->tab_scalar[i], 0, sizeof(oskar_ElementTable));
         }
     }
     else if (size < old_size)
@@ -84,7 +89,9 @@ void oskar_element_resize_freq_data(oskar_Element* model, int size,
             oskar_splines_free(model->scalar_re[i], status);
             oskar_splines_free(model->scalar_im[i], status);
             oskar_mem_free(model->sph_wave[i], status);
-
+            oskar_mem_free(model->tab_x[i].data, status);
+            oskar_mem_free(model->tab_y[i].data, status);
+            oskar_mem_free(model->tab_scalar[i].data, status);
         }
         realloc_arrays(model, size);
     }
@@ -112,6 +119,12 @@ static void realloc_arrays(oskar_Element* e, int size)
     e->scalar_re = (oskar_Splines**) realloc(e->scalar_re, sz);
     e->scalar_im = (oskar_Splines**) realloc(e->scalar_im, sz);
     e->sph_wave = (oskar_Mem**) realloc(e->sph_wave, sz);
+    e->tab_x = (oskar_ElementTable*) realloc(e->tab_x,
+            size * sizeof(oskar_ElementTable));
+    e->tab_y = (oskar_ElementTable*) realloc(e->tab_y,
+            size * sizeof(oskar_ElementTable));
+    e->tab_scalar = (oskar_ElementTable*) realloc(e->tab_scalar,
+            size * sizeof(oskar_ElementTable));
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/element/private_element.h"
+#include "telescope/station/element/oskar_element.h"
+#include "telescope/station/element/oskar_evaluate_spherical_wave_sum.h"
+#include "telescope/station/element/oskar_evaluate_tabulated_pattern.h"
+#include "convert/oskar_convert_ludwig3_to_theta_phi_components.h"
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIN_THETA_INTERVALS 36  /* 5 degrees. */
+#define MAX_THETA_INTERVALS 720 /* 0.25 degrees. */
+
+/* Evaluates the fitted response for one port (0 for scalar, 1 for X,
+ * 2 for Y) in the same way as oskar_element_evaluate(), before conversion
+ * of polarised responses to Ludwig-3 components. */
+static void evaluate_fitted(const oskar_Element* e, int id, int port,
+        int num_points, const oskar_Mem* theta, const oskar_Mem* phi,
+        oskar_Mem* work, int* status)
+{
+    if (port == 0)
+    {
+        oskar_splines_evaluate(e->scalar_re[id], num_points,
+                theta, phi, 2, 0, work, status);
+        oskar_splines_evaluate(e->scalar_im[id], num_points,
+                theta, phi, 2, 1, work, status);
+    }
+    else if (oskar_element_has_spherical_wave_data(e, id))
+    {
+        oskar_evaluate_spherical_wave_sum(num_points, theta, phi, phi,
+                e->l_max[id], e->sph_wave[id], 0, work, status);
+    }
+    else if (port == 1)
+    {
+        const oskar_Splines* splines[] = {
+                e->x_h_re[id], e->x_h_im[id], e->x_v_re[id], e->x_v_im[id]};
+        oskar_splines_evaluate_group(4, splines, num_points,
+                theta, phi, 8, 0, work, status);
+        oskar_convert_ludwig3_to_theta_phi_components(num_points,
+                phi, 4, 0, work, status);
+    }
+    else
+    {
+        const oskar_Splines* splines[] = {
+                e->y_h_re[id], e->y_h_im[id], e->y_v_re[id], e->y_v_im[id]};
+        oskar_splines_evaluate_group(4, splines, num_points,
+                theta, phi, 8, 4, work, status);
+        oskar_convert_ludwig3_to_theta_phi_components(num_points,
+                phi, 4, 2, work, status);
+    }
+}
+
+
+/* Sets coordinates on a regular grid, with theta varying slowest. */
+static void set_grid(int num_theta, double theta0, double inc_theta,
+        int num_phi, double phi0, double inc_phi,
+        oskar_Mem* theta, oskar_Mem* phi, int* status)
+{
+    int i, j, k;
+    const size_t num_points = (size_t) num_theta * num_phi;
+    oskar_mem_ensure(theta, num_points, status);
+    oskar_mem_ensure(phi, num_points, status);
+    if (*status) return;
+    if (oskar_mem_precision(theta) == OSKAR_DOUBLE)
+    {
+        double *t = oskar_mem_double(theta, status);
+        double *p = oskar_mem_double(phi, status);
+        for (i = 0, k = 0; i < num_theta; ++i)
+            for (j = 0; j < num_phi; ++j, ++k)
+            {
+                t[k] = theta0 + i * inc_theta;
+                p[k] = phi0 + j * inc_phi;
+            }
+    }
+    else
+    {
+        float *t = oskar_mem_float(theta, status);
+        float *p = oskar_mem_float(phi, status);
+        for (i = 0, k = 0; i < num_theta; ++i)
+            for (j = 0; j < num_phi; ++j, ++k)
+            {
+                t[k] = (float) (theta0 + i * inc_theta);
+                p[k] = (float) (phi0 + j * inc_phi);
+            }
+    }
+}
+
+
+/* Evaluates the padded table, and returns the peak amplitude. */
+static double make_table(const oskar_Element* e, int id, int port,
+        int num_theta, int num_phi, oskar_Mem* theta, oskar_Mem* phi,
+        oskar_Mem* work, oskar_Mem* table, int* status)
+{
+    int i, j, k;
+    double peak = 0.0;
+    const int num_comp = port ? 2 : 1, stride = port ? 4 : 1;
+    const int offset = (port == 2) ? 2 : 0;
+    const int row = num_phi + 3, half = num_phi / 2;
+    const int num_points = num_theta * num_phi;
+    const double sign = port ? -1.0 : 1.0;
+    if (*status) return 0.0;
+
+    /* Evaluate the response at each grid point. */
+    set_grid(num_theta, 0.0, M_PI / (num_theta - 1),
+            num_phi, 0.0, 2.0 * M_PI / num_phi, theta, phi, status);
+    oskar_mem_ensure(work, (size_t) num_points, status);
+    evaluate_fitted(e, id, port, num_points, theta, phi, work, status);
+    oskar_Mem* values = oskar_mem_convert_precision(work,
+            OSKAR_DOUBLE, status);
+    oskar_mem_ensure(table,
+            (size_t) num_comp * (num_theta + 2) * row, status);
+    if (*status)
+    {
+        oskar_mem_free(values, status);
+        return 0.0;
+    }
+    const double2* v = (const double2*) oskar_mem_void_const(values);
+    double2* t = (double2*) oskar_mem_void(table);
+
+    /* Copy values, wrapping in phi. */
+    for (i = 0; i < num_theta; ++i)
+    {
+        for (j = -1; j <= num_phi + 1; ++j)
+        {
+            const int jj = (j + num_phi) % num_phi;
+            for (k = 0; k < num_comp; ++k)
+            {
+                const double2 val =
+                        v[(i * num_phi + jj) * stride + offset + k];
+                const double amp = sqrt(val.x * val.x + val.y * val.y);
+                t[((i + 1) * row + j + 1) * num_comp + k] = val;
+                if (amp > peak) peak = amp;
+            }
+        }
+    }
+
+    /* Fill the rows beyond each pole, using points on the opposite side.
+     * Theta and phi components change sign across the pole. */
+    for (i = -1; i <= num_theta; i += num_theta + 1)
+    {
+        const int ii = (i < 0) ? 1 : num_theta - 2;
+        for (j = -1; j <= num_phi + 1; ++j)
+        {
+            const int jj = (j + half + num_phi) % num_phi;
+            for (k = 0; k < num_comp; ++k)
+            {
+                const double2 val =
+                        t[((ii + 1) * row + jj + 1) * num_comp + k];
+                double2* out = &t[((i + 1) * row + j + 1) * num_comp + k];
+                out->x = sign * val.x;
+                out->y = sign * val.y;
+            }
+        }
+    }
+    oskar_mem_free(values, status);
+    return peak;
+}
+
+
+/* Returns the maximum interpolation error at the centre of each cell. */
+static double check_table(const oskar_Element* e, int id, int port,
+        int num_theta, int num_phi, const oskar_Mem* table,
+        oskar_Mem* theta, oskar_Mem* phi, oskar_Mem* work,
+        oskar_Mem* interp, int* status)
+{
+    size_t i;
+    double max_err = 0.0;
+    const int num_comp = port ? 2 : 1, stride = port ? 4 : 1;
+    const int offset = (port == 2) ? 2 : 0;
+    const int num_points = (num_theta - 1) * num_phi;
+    if (*status) return 0.0;
+    const double inc_theta = M_PI / (num_theta - 1);
+    const double inc_phi = 2.0 * M_PI / num_phi;
+    set_grid(num_theta - 1, 0.5 * inc_theta, inc_theta,
+            num_phi, 0.5 * inc_phi, inc_phi, theta, phi, status);
+    oskar_mem_ensure(work, (size_t) num_points, status);
+    oskar_mem_ensure(interp, (size_t) num_points, status);
+    evaluate_fitted(e, id, port, num_points, theta, phi, work, status);
+    oskar_Mem* table_p = oskar_mem_convert_precision(table,
+            oskar_mem_precision(work), status);
+    oskar_evaluate_tabulated_pattern(num_points, theta, phi,
+            num_theta, num_phi, num_comp, table_p, stride, offset,
+            interp, status);
+    oskar_mem_free(table_p, status);
+    oskar_Mem* a = oskar_mem_convert_precision(work, OSKAR_DOUBLE, status);
+    oskar_Mem* b = oskar_mem_convert_precision(interp, OSKAR_DOUBLE,
+            status);
+    if (!*status)
+    {
+        const double2* p_a = (const double2*) oskar_mem_void_const(a);
+        const double2* p_b = (const double2*) oskar_mem_void_const(b);
+        for (i = 0; i < (size_t) num_points; ++i)
+        {
+            int k;
+            for (k = 0; k < num_comp; ++k)
+            {
+                const size_t j = i * stride + offset + k;
+                const double dx = p_a[j].x - p_b[j].x;
+                const double dy = p_a[j].y - p_b[j].y;
+                const double err = sqrt(dx * dx + dy * dy);
+                if (err > max_err || err != err) max_err = err;
+            }
+        }
+    }
+    oskar_mem_free(a, status);
+    oskar_mem_free(b, status);
+    return max_err;
+}
+
+
+static void tabulate_port(oskar_Element* e, int id, int port,
+        double tolerance, oskar_ElementTable* tab, oskar_Log* log,
+        int* status)
+{
+    int n, num_theta = 0, num_phi = 0;
+    double rel_err = 0.0;
+    const int prec = e->precision;
+    const int work_type = prec | OSKAR_COMPLEX | (port ? OSKAR_MATRIX : 0);
+    const char* name = (port == 0) ? "scalar" : (port == 1 ? "X" : "Y");
+    if (*status) return;
+    oskar_Mem* theta = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    oskar_Mem* phi = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    oskar_Mem* work = oskar_mem_create(work_type, OSKAR_CPU, 0, status);
+    oskar_Mem* interp = oskar_mem_create(work_type, OSKAR_CPU, 0, status);
+    oskar_Mem* table = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            0, status);
+    for (n = MIN_THETA_INTERVALS; n <= MAX_THETA_INTERVALS && !*status; n *= 2)
+    {
+        num_theta = n + 1;
+        num_phi = 2 * n;
+        const double peak = make_table(e, id, port, num_theta, num_phi,
+                theta, phi, work, table, status);
+        const double err = check_table(e, id, port, num_theta, num_phi,
+                table, theta, phi, work, interp, status);
+        rel_err = (peak > 0.0) ? err / peak : err;
+        if (rel_err <= tolerance) break;
+    }
+    if (!*status)
+    {
+        oskar_mem_free(tab->data, status);
+        tab->data = oskar_mem_convert_precision(table, prec, status);
+        tab->num_theta = num_theta;
+        tab->num_phi = num_phi;
+        oskar_log_message(log, 'M', 0, "Tabulated %s element pattern at "
+                "%.3f MHz on %d x %d grid (max. relative error %.2e).",
+                name, e->freqs_hz[id] / 1e6, num_theta, num_phi, rel_err);
+        if (rel_err > tolerance)
+            oskar_log_warning(log, "Tabulated %s element pattern at "
+                    "%.3f MHz does not meet tolerance %.2e.",
+                    name, e->freqs_hz[id] / 1e6, tolerance);
+    }
+    oskar_mem_free(theta, status);
+    oskar_mem_free(phi, status);
+    oskar_mem_free(work, status);
+    oskar_mem_free(interp, status);
+    oskar_mem_free(table, status);
+}
+
+
+void oskar_element_tabulate(oskar_Element* data, double tolerance,
+        oskar_Log* log, int* status)
+{
+    int i;
+    if (*status) return;
+    if (tolerance <= 0.0)
+    {
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        return;
+    }
+    if (oskar_element_mem_location(data) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    for (i = 0; i < data->num_freq; ++i)
+    {
+        const int sph_wave = oskar_element_has_spherical_wave_data(data, i);
+        if (!data->tab_x[i].data &&
+                (sph_wave || oskar_element_has_x_spline_data(data, i)))
+            tabulate_port(data, i, 1, tolerance, &data->tab_x[i],
+                    log, status);
+        if (!data->tab_y[i].data &&
+                (sph_wave || oskar_element_has_y_spline_data(data, i)))
+            tabulate_port(data, i, 2, tolerance, &data->tab_y[i],
+                    log, status);
+        if (!data->tab_scalar[i].data &&
+                oskar_element_has_scalar_spline_data(data, i))
+            tabulate_port(data, i, 0, tolerance, &data->tab_scalar[i],
+                    log, status);
+    }
+}
+
+
+static void share_table(oskar_ElementTable* dst, const oskar_ElementTable* src,
+        int* status)
+{
+    if (dst->data || !src->data) return;
+    dst->data = oskar_mem_create_alias(src->data, 0,
+            oskar_mem_length(src->data), status);
+    dst->num_theta = src->num_theta;
+    dst->num_phi = src->num_phi;
+}
+
+
+void oskar_element_share_tabulated_data(oskar_Element* dst,
+        const oskar_Element* src, int* status)
+{
+    int i, j;
+    if (*status || dst == src) return;
+    for (i = 0; i < dst->num_freq; ++i)
+    {
+        for (j = 0; j < src->num_freq; ++j)
+        {
+            if (dst->freqs_hz[i] != src->freqs_hz[j]) continue;
+            share_table(&dst->tab_x[i], &src->tab_x[j], status);
+            share_table(&dst->tab_y[i], &src->tab_y[j], status);
+            share_table(&dst->tab_scalar[i], &src->tab_scalar[j], status);
+            break;
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
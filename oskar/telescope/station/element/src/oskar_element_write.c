@@ -39,12 +39,15 @@ extern "C" {
 
 static void write_splines(oskar_Binary* h, const oskar_Splines* splines,
         int index, int* status);
+static void write_table(oskar_Binary* h, const oskar_ElementTable* table,
+        int common_phi_coords, int* status);
 
 void oskar_element_write(const oskar_Element* data, const char* filename,
         int port, double freq_hz, oskar_Log* log, int* status)
 {
     const oskar_Splines *h_re = 0, *h_im = 0, *v_re = 0, *v_im = 0;
     const oskar_Splines *scalar_re = 0, *scalar_im = 0;
+    const oskar_ElementTable* table = 0;
     oskar_Binary* h = 0;
     int freq_id;
     char* log_data = 0;
@@ -63,6 +66,7 @@ void oskar_element_write(const oskar_Element* data, const char* filename,
     {
         scalar_re = data->scalar_re[freq_id];
         scalar_im = data->scalar_im[freq_id];
+        table = &data->tab_scalar[freq_id];
     }
     else if (port == 1)
     {
@@ -70,6 +74,7 @@ void oskar_element_write(const oskar_Element* data, const char* filename,
         h_im = data->x_h_im[freq_id];
         v_re = data->x_v_re[freq_id];
         v_im = data->x_v_im[freq_id];
+        table = &data->tab_x[freq_id];
     }
     else if (port == 2)
     {
@@ -77,6 +82,7 @@ void oskar_element_write(const oskar_Element* data, const char* filename,
         h_im = data->y_h_im[freq_id];
         v_re = data->y_v_re[freq_id];
         v_im = data->y_v_im[freq_id];
+        table = &data->tab_y[freq_id];
     }
     else
     {
@@ -110,8 +116,11 @@ void oskar_element_write(const oskar_Element* data, const char* filename,
                 OSKAR_ELEMENT_SURFACE_TYPE_SCALAR, status);
 
         /* Write data for [real], [imag] surfaces. */
-        write_splines(h, scalar_re, 0, status);
-        write_splines(h, scalar_im, 1, status);
+        if (scalar_re || !table->data)
+        {
+            write_splines(h, scalar_re, 0, status);
+            write_splines(h, scalar_im, 1, status);
+        }
     }
     else
     {
@@ -121,12 +130,19 @@ void oskar_element_write(const oskar_Element* data, const char* filename,
                 OSKAR_ELEMENT_SURFACE_TYPE_LUDWIG_3, status);
 
         /* Write data for [h_re], [h_im], [v_re], [v_im] surfaces. */
-        write_splines(h, h_re, 0, status);
-        write_splines(h, h_im, 1, status);
-        write_splines(h, v_re, 2, status);
-        write_splines(h, v_im, 3, status);
+        if (h_re || !table->data)
+        {
+            write_splines(h, h_re, 0, status);
+            write_splines(h, h_im, 1, status);
+            write_splines(h, v_re, 2, status);
+            write_splines(h, v_im, 3, status);
+        }
     }
 
+    /* Write tabulated data, if present. */
+    if (table->data)
+        write_table(h, table, data->common_phi_coords[freq_id], status);
+
     /* Release the handle. */
     oskar_binary_free(h);
 }
@@ -185,6 +201,30 @@ static void write_splines(oskar_Binary* h, const oskar_Splines* splines,
             index, oskar_splines_smoothing_factor(splines), status);
 }
 
+static void write_table(oskar_Binary* h, const oskar_ElementTable* table,
+        int common_phi_coords, int* status)
+{
+    oskar_Mem* temp;
+    unsigned char group = (unsigned char) OSKAR_TAG_GROUP_ELEMENT_DATA;
+    if (*status) return;
+    oskar_binary_write_int(h, group, OSKAR_ELEMENT_TAG_TABLE_NUM_THETA,
+            0, table->num_theta, status);
+    oskar_binary_write_int(h, group, OSKAR_ELEMENT_TAG_TABLE_NUM_PHI,
+            0, table->num_phi, status);
+    oskar_binary_write_int(h, group, OSKAR_ELEMENT_TAG_COMMON_PHI_COORDS,
+            0, common_phi_coords, status);
+
+    /* Write data in double and single precision. */
+    temp = oskar_mem_convert_precision(table->data, OSKAR_DOUBLE, status);
+    oskar_binary_write_mem(h, temp, group,
+            OSKAR_ELEMENT_TAG_TABLE_DATA, 0, 0, status);
+    oskar_mem_free(temp, status);
+    temp = oskar_mem_convert_precision(table->data, OSKAR_SINGLE, status);
+    oskar_binary_write_mem(h, temp, group,
+            OSKAR_ELEMENT_TAG_TABLE_DATA, 0, 0, status);
+    oskar_mem_free(temp, status);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,20 +27,14 @@
  */
 
 #include "telescope/station/element/oskar_evaluate_spherical_wave_sum.h"
-#include "telescope/station/element/define_evaluate_spherical_wave.h"
+#include "telescope/station/element/private_evaluate_spherical_wave_sum_simd.h"
 #include "log/oskar_log.h"
-#include "math/define_legendre_polynomial.h"
-#include "math/define_multiply.h"
 #include "utility/oskar_device.h"
-#include "utility/oskar_kernel_macros.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-OSKAR_EVALUATE_SPHERICAL_WAVE_SUM(evaluate_spherical_wave_sum_float, float, float2, float4c)
-OSKAR_EVALUATE_SPHERICAL_WAVE_SUM(evaluate_spherical_wave_sum_double, double, double2, double4c)
-
 void oskar_evaluate_spherical_wave_sum(int num_points, const oskar_Mem* theta,
         const oskar_Mem* phi_x, const oskar_Mem* phi_y, int l_max,
         const oskar_Mem* alpha, int offset, oskar_Mem* pattern, int* status)
@@ -58,7 +52,7 @@ void oskar_evaluate_spherical_wave_sum(int num_points, const oskar_Mem* theta,
         switch (oskar_mem_type(pattern))
         {
         case OSKAR_SINGLE_COMPLEX_MATRIX:
-            evaluate_spherical_wave_sum_float(num_points,
+            oskar_evaluate_spherical_wave_sum_simd_f(num_points,
                     oskar_mem_float_const(theta, status),
                     oskar_mem_float_const(phi_x, status),
                     oskar_mem_float_const(phi_y, status), l_max,
@@ -66,7 +60,7 @@ void oskar_evaluate_spherical_wave_sum(int num_points, const oskar_Mem* theta,
                     oskar_mem_float4c(pattern, status));
             break;
         case OSKAR_DOUBLE_COMPLEX_MATRIX:
-            evaluate_spherical_wave_sum_double(num_points,
+            oskar_evaluate_spherical_wave_sum_simd_d(num_points,
                     oskar_mem_double_const(theta, status),
                     oskar_mem_double_const(phi_x, status),
                     oskar_mem_double_const(phi_y, status), l_max,
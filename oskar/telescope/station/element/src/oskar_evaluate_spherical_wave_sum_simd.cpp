@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "correlate/oskar_cross_correlate_simd.h"
+#include "math/private_simd_scalar.h"
+#include "telescope/station/element/define_evaluate_spherical_wave_sum_simd.h"
+#include "telescope/station/element/private_evaluate_spherical_wave_sum_simd.h"
+
+OSKAR_SPH_WAVE_SUM_SIMD_DEFINE(oskar_sph_wave_sum_scalar_f,
+        oskar_simd_scalar<float>, float, float4c)
+OSKAR_SPH_WAVE_SUM_SIMD_DEFINE(oskar_sph_wave_sum_scalar_d,
+        oskar_simd_scalar<double>, double, double4c)
+
+/* The instruction set is chosen in the same way as for the correlator. */
+#define SIMD_DISPATCH(FP)                                                   \
+        switch (oskar_cross_correlate_simd_isa())                           \
+        {                                                                   \
+        SIMD_CASE_AVX512(FP)                                                \
+        SIMD_CASE_AVX2(FP)                                                  \
+        default:                                                            \
+            oskar_sph_wave_sum_scalar_ ## FP SIMD_ARGS;                     \
+        }
+
+#ifdef OSKAR_HAVE_AVX2
+#define SIMD_CASE_AVX2(FP) case OSKAR_SIMD_AVX2:                            \
+        oskar_sph_wave_sum_avx2_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX2(FP)
+#endif
+#ifdef OSKAR_HAVE_AVX512
+#define SIMD_CASE_AVX512(FP) case OSKAR_SIMD_AVX512:                        \
+        oskar_sph_wave_sum_avx512_ ## FP SIMD_ARGS; break;
+#else
+#define SIMD_CASE_AVX512(FP)
+#endif
+
+#define SIMD_ARGS (num_points, theta, phi_x, phi_y, l_max, alpha, offset,   \
+        pattern)
+
+void oskar_evaluate_spherical_wave_sum_simd_f(int num_points,
+        const float* theta, const float* phi_x, const float* phi_y,
+        int l_max, const float4c* alpha, int offset, float4c* pattern)
+{
+    SIMD_DISPATCH(f)
+}
+
+void oskar_evaluate_spherical_wave_sum_simd_d(int num_points,
+        const double* theta, const double* phi_x, const double* phi_y,
+        int l_max, const double4c* alpha, int offset, double4c* pattern)
+{
+    SIMD_DISPATCH(d)
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+/* This file must be compiled with AVX2 and FMA instructions enabled. */
+
+#include "math/private_simd_avx2.h"
+#include "telescope/station/element/define_evaluate_spherical_wave_sum_simd.h"
+#include "telescope/station/element/private_evaluate_spherical_wave_sum_simd.h"
+
+OSKAR_SPH_WAVE_SUM_SIMD_DEFINE(oskar_sph_wave_sum_avx2_f,
+        oskar_simd_avx2_f, float, float4c)
+OSKAR_SPH_WAVE_SUM_SIMD_DEFINE(oskar_sph_wave_sum_avx2_d,
+        oskar_simd_avx2_d, double, double4c)
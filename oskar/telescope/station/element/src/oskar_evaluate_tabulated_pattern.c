@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/element/oskar_evaluate_tabulated_pattern.h"
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bicubic convolution weights (Keys, a = -0.5). */
+#define CUBIC_WEIGHTS(T, W) \
+    W[0] = ((-0.5 * T + 1.0) * T - 0.5) * T; \
+    W[1] = (1.5 * T - 2.5) * T * T + 1.0; \
+    W[2] = ((-1.5 * T + 2.0) * T + 0.5) * T; \
+    W[3] = (0.5 * T - 0.5) * T * T;
+
+#define TABULATED_PATTERN(NAME, FP, FP2) \
+static void NAME(const int num_points, const FP* theta, const FP* phi, \
+        const int num_theta, const int num_phi, const int num_comp, \
+        const FP2* table, const int stride, const int offset, FP2* pattern) \
+{ \
+    int i; \
+    const int row = num_phi + 3; \
+    const double inv_inc_theta = (num_theta - 1) / M_PI; \
+    const double inv_inc_phi = num_phi / (2.0 * M_PI); \
+    _Pragma("omp parallel for private(i)") \
+    for (i = 0; i < num_points; ++i) \
+    { \
+        int c, j, k; \
+        double wt[4], wp[4], acc[4]; \
+        FP2* out = pattern + (size_t) stride * i + offset; \
+        double t = theta[i] * inv_inc_theta, p = phi[i] * inv_inc_phi; \
+        if (t != t || p != p) \
+        { \
+            /* Propagate NAN. */ \
+            for (c = 0; c < num_comp; ++c) \
+                out[c].x = out[c].y = (FP) (t + p); \
+            continue; \
+        } \
+        if (t < 0.0) t = 0.0; \
+        if (t > num_theta - 1) t = num_theta - 1; \
+        p -= num_phi * floor(p / num_phi); \
+        int it = (int) t, ip = (int) p; \
+        if (it > num_theta - 2) it = num_theta - 2; \
+        if (ip > num_phi - 1) ip = num_phi - 1; \
+        t -= it; \
+        p -= ip; \
+        CUBIC_WEIGHTS(t, wt) \
+        CUBIC_WEIGHTS(p, wp) \
+        for (c = 0; c < 2 * num_comp; ++c) acc[c] = 0.0; \
+        for (k = 0; k < 4; ++k) \
+        { \
+            const FP2* g = table + num_comp * ((size_t) (it + k) * row + ip); \
+            for (j = 0; j < 4; ++j, g += num_comp) \
+            { \
+                const double w = wt[k] * wp[j]; \
+                for (c = 0; c < num_comp; ++c) \
+                { \
+                    acc[2 * c]     += w * g[c].x; \
+                    acc[2 * c + 1] += w * g[c].y; \
+                } \
+            } \
+        } \
+        for (c = 0; c < num_comp; ++c) \
+        { \
+            out[c].x = (FP) acc[2 * c]; \
+            out[c].y = (FP) acc[2 * c + 1]; \
+        } \
+    } \
+}
+
+TABULATED_PATTERN(tabulated_pattern_f, float, float2)
+TABULATED_PATTERN(tabulated_pattern_d, double, double2)
+
+void oskar_evaluate_tabulated_pattern(int num_points, const oskar_Mem* theta,
+        const oskar_Mem* phi, int num_theta, int num_phi, int num_comp,
+        const oskar_Mem* table, int stride, int offset, oskar_Mem* pattern,
+        int* status)
+{
+    if (*status) return;
+    const int precision = oskar_mem_precision(pattern);
+    if (oskar_mem_location(pattern) != OSKAR_CPU ||
+            oskar_mem_location(table) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    if (num_comp < 1 || num_comp > 2 || num_theta < 2 || num_phi < 1)
+    {
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        return;
+    }
+    if (oskar_mem_type(table) != (precision | OSKAR_COMPLEX) ||
+            oskar_mem_type(theta) != precision ||
+            oskar_mem_type(phi) != precision)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (oskar_mem_length(table) < (size_t) num_comp *
+            (num_theta + 2) * (num_phi + 3))
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    if (precision == OSKAR_DOUBLE)
+        tabulated_pattern_d(num_points,
+                oskar_mem_double_const(theta, status),
+                oskar_mem_double_const(phi, status), num_theta, num_phi,
+                num_comp, (const double2*) oskar_mem_void_const(table),
+                stride, offset, (double2*) oskar_mem_void(pattern));
+    else if (precision == OSKAR_SINGLE)
+        tabulated_pattern_f(num_points,
+                oskar_mem_float_const(theta, status),
+                oskar_mem_float_const(phi, status), num_theta, num_phi,
+                num_comp, (const float2*) oskar_mem_void_const(table),
+                stride, offset, (float2*) oskar_mem_void(pattern));
+    else
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+}
+
+#ifdef __cplusplus
+}
+#endif
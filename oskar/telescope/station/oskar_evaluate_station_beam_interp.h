@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_EVALUATE_STATION_BEAM_INTERP_H_
+#define OSKAR_EVALUATE_STATION_BEAM_INTERP_H_
+
+/**
+ * @file oskar_evaluate_station_beam_interp.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+#include <telescope/station/oskar_station.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates the station beam for an aperture array station by
+ * interpolation from a grid.
+ *
+ * @details
+ * This function produces an approximation to the result of
+ * oskar_evaluate_station_beam_aperture_array(), by interpolating the beam
+ * from a grid of horizontal direction cosines covering the whole sky.
+ *
+ * The grid spacing is chosen from the station diameter and the wavelength,
+ * so that there are the number of points per beam width set using
+ * oskar_station_work_set_beam_interpolation(). Values are interpolated
+ * using bicubic convolution.
+ *
+ * The grid is kept in the work structure, and is evaluated again only
+ * if the frequency or beam direction changes, or at each time index
+ * if the station has time-variable element errors.
+ * If the beam direction changes, the grid is not evaluated until the new
+ * direction has been used twice, unless the grid is smaller than the
+ * number of points required.
+ *
+ * The beam is evaluated directly, without interpolation, if the grid is
+ * not used, if the grid would be larger than the memory limit,
+ * or if the output is not in CPU memory.
+ *
+ * @param[in]     station       Fully populated station model structure.
+ * @param[in]     work          Station beam workspace.
+ * @param[in]     num_points    Number of coordinates at which to evaluate
+ *                              the beam.
+ * @param[in]     x             Array of horizontal x coordinates at which to
+ *                              evaluate the beam.
+ * @param[in]     y             Array of horizontal y coordinates at which to
+ *                              evaluate the beam.
+ * @param[in]     z             Array of horizontal z coordinates at which to
+ *                              evaluate the beam.
+ * @param[in]     time_index    Simulation time index.
+ * @param[in]     gast_rad      Greenwich Apparent Sidereal Time in radians.
+ * @param[in]     frequency_hz  The observing frequency, in Hz.
+ * @param[out]    beam          Station beam evaluated at x,y,z positions.
+ * @param[in,out] status        Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_station_beam_interp(
+        const oskar_Station* station,
+        oskar_StationWork* work,
+        int num_points,
+        const oskar_Mem* x,
+        const oskar_Mem* y,
+        const oskar_Mem* z,
+        int time_index,
+        double gast_rad,
+        double frequency_hz,
+        oskar_Mem* beam,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -54,6 +54,7 @@ enum OSKAR_STATION_TYPE
 #include <telescope/station/oskar_station_load_layout.h>
 #include <telescope/station/oskar_station_load_mount_types.h>
 #include <telescope/station/oskar_station_load_permitted_beams.h>
+#include <telescope/station/oskar_station_memory_size.h>
 #include <telescope/station/oskar_station_override_element_cable_length_errors.h>
 #include <telescope/station/oskar_station_override_element_feed_angle.h>
 #include <telescope/station/oskar_station_override_element_gains.h>
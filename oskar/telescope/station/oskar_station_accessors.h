@@ -126,6 +126,23 @@ double oskar_station_gaussian_beam_reference_freq_hz(const oskar_Station* model)
 OSKAR_EXPORT
 int oskar_station_identical_children(const oskar_Station* model);
 
+/**
+ * @brief
+ * Returns the class of child stations with the same beam as this one.
+ *
+ * @details
+ * Child stations (tiles) in the same class, anywhere in the telescope,
+ * produce the same beam, so it can be evaluated once and reused
+ * by each parent station (see oskar_station_work_set_tile_beam_sharing()).
+ * The class is set by oskar_telescope_analyse().
+ *
+ * @param[in] model   Pointer to station model.
+ *
+ * @return The class number, starting at 1, or 0 if the beam is not shared.
+ */
+OSKAR_EXPORT
+int oskar_station_tile_beam_class(const oskar_Station* model);
+
 OSKAR_EXPORT
 int oskar_station_num_elements(const oskar_Station* model);
 
@@ -282,6 +299,20 @@ const oskar_Mem* oskar_station_permitted_beam_el_rad_const(
 
 /* Setters. */
 
+/**
+ * @brief
+ * Sets the class of child stations with the same beam as this one.
+ *
+ * @details
+ * This should be set only by oskar_telescope_analyse()
+ * (see oskar_station_tile_beam_class()).
+ *
+ * @param[in] model   Pointer to station model.
+ * @param[in] value   Class number, or 0 if the beam is not shared.
+ */
+OSKAR_EXPORT
+void oskar_station_set_tile_beam_class(oskar_Station* model, int value);
+
 /**
  * @brief
  * Sets the unique station identifier.
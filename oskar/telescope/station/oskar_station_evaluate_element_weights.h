@@ -52,8 +52,11 @@ extern "C" {
  * - Systematic and random gain and phase variations.
  * - User-supplied apodisation weights.
  *
- * The \p weights and \p weights_scratch arrays are resized to hold the weights
- * if necessary.
+ * The \p weights array is resized to hold the weights if necessary.
+ *
+ * If \p work is not NULL, the time-variable errors are kept in it for use
+ * at other frequencies and beam directions
+ * (see oskar_station_work_element_errors()).
  *
  * @param[in] station             Station model.
  * @param[in] feed                Feed index (0 = X, 1 = Y).
@@ -63,14 +66,14 @@ extern "C" {
  * @param[in] z_beam              Beam direction cosine, horizontal z-component.
  * @param[in] time_index          Time index of simulation.
  * @param[in,out] weights         Output array of beamforming weights.
- * @param[in,out] weights_scratch Work array, for calculating the weights error.
+ * @param[in,out] work            Station beam workspace (may be NULL).
  * @param[in,out] status          Status return code.
  */
 OSKAR_EXPORT
 void oskar_station_evaluate_element_weights(const oskar_Station* station,
         int feed, double wavenumber, double x_beam, double y_beam,
         double z_beam, int time_index, oskar_Mem* weights,
-        oskar_Mem* weights_scratch, int* status);
+        oskar_StationWork* work, int* status);
 
 #ifdef __cplusplus
 }
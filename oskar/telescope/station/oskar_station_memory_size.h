@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#ifndef OSKAR_STATION_MEMORY_SIZE_H_
+#define OSKAR_STATION_MEMORY_SIZE_H_
+
+/**
+ * @file oskar_station_memory_size.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Returns the memory used by a station model, in bytes.
+ *
+ * @details
+ * Returns the memory used by the station model, including its element
+ * models and (recursively) any child stations.
+ *
+ * @param[in] model Pointer to station model (may be NULL).
+ *
+ * @return The memory used, in bytes.
+ */
+OSKAR_EXPORT
+size_t oskar_station_memory_size(const oskar_Station* model);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -12,6 +12,7 @@
 
 #include <oskar_global.h>
 #include <mem/oskar_mem.h>
+#include <telescope/station/element/oskar_element.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +24,12 @@ struct oskar_StationWork;
 typedef struct oskar_StationWork oskar_StationWork;
 #endif /* OSKAR_STATION_WORK_TYPEDEF_ */
 
+struct oskar_Station;
+#ifndef OSKAR_STATION_TYPEDEF_
+#define OSKAR_STATION_TYPEDEF_
+typedef struct oskar_Station oskar_Station;
+#endif /* OSKAR_STATION_TYPEDEF_ */
+
 /**
  * @brief Creates a station work buffer structure.
  *
@@ -77,6 +84,201 @@ OSKAR_EXPORT
 void oskar_station_work_set_tec_screen_path(oskar_StationWork* work,
         const char* path);
 
+/**
+ * @brief Sets parameters for aperture array beam interpolation.
+ *
+ * @details
+ * If enabled, the beam of each aperture array station is evaluated
+ * on a grid of direction cosines covering the whole sky, and
+ * interpolated at the required source positions
+ * (see oskar_evaluate_station_beam_interp()).
+ *
+ * The grids are kept in the work structure, and are only evaluated again
+ * if the frequency or beam direction changes, or if the station has
+ * time-variable element errors. At most 256 grids (one per station and
+ * frequency) are kept, and the least recently used ones are discarded
+ * to make room for others.
+ *
+ * @param[in,out] work                   Station beam workspace.
+ * @param[in] samples_per_beam_width     Grid points per beam width,
+ *                                       or 0 to disable interpolation.
+ * @param[in] max_cache_size_mb          Maximum memory for all grids, in MB.
+ */
+OSKAR_EXPORT
+void oskar_station_work_set_beam_interpolation(oskar_StationWork* work,
+        int samples_per_beam_width, double max_cache_size_mb);
+
+/**
+ * @brief Sets the maximum size of the element response cache.
+ *
+ * @details
+ * Element responses that depend on frequency only through the choice of
+ * fitted element data are kept in the work structure, so they can be
+ * reused for other channels that use the same data
+ * (see oskar_station_work_evaluate_element()).
+ *
+ * Responses are matched by the values of the source directions, which
+ * differ between stations at different positions, so the cache only
+ * helps when a station is evaluated more than once for the same
+ * directions: at several frequencies, or for several identical tiles.
+ * If no response is reused during one time index, the cache is turned
+ * off until this function is called again.
+ *
+ * The default size is 256 MB.
+ *
+ * @param[in,out] work          Station beam workspace.
+ * @param[in] max_size_mb       Maximum memory for the cache, in MB,
+ *                              or 0 to disable the cache.
+ */
+OSKAR_EXPORT
+void oskar_station_work_set_element_cache_size(oskar_StationWork* work,
+        double max_size_mb);
+
+/**
+ * @brief Returns an ID for a set of source directions.
+ *
+ * @details
+ * Returns an ID that identifies the given source directions, for use
+ * with oskar_station_work_evaluate_element(). Directions with the same
+ * values are given the same ID.
+ *
+ * A copy of the directions is stored in the work structure. Directions
+ * stored at other time indices are discarded if space is needed.
+ *
+ * Returns -1 if the element cache is disabled, full or turned off
+ * (see oskar_station_work_set_element_cache_size()), or if the
+ * directions are not in CPU memory.
+ *
+ * @param[in,out] work          Station beam workspace.
+ * @param[in] time_index        Simulation time index.
+ * @param[in] offset_points     Start offset into input arrays.
+ * @param[in] num_points        Number of directions.
+ * @param[in] x                 Direction cosines (x, ENU).
+ * @param[in] y                 Direction cosines (y, ENU).
+ * @param[in] z                 Direction cosines (z, ENU).
+ * @param[in,out] status        Status return code.
+ */
+OSKAR_EXPORT
+int oskar_station_work_element_directions(oskar_StationWork* work,
+        int time_index, int offset_points, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        int* status);
+
+/**
+ * @brief Evaluates an element response, using cached values if possible.
+ *
+ * @details
+ * This is a wrapper around oskar_element_evaluate(), with the same
+ * parameters, together with a direction set ID returned by
+ * oskar_station_work_element_directions().
+ *
+ * If the element response depends on frequency only through the choice
+ * of fitted element data, the response is stored for the direction set,
+ * and copied from the cache for any other frequency that uses the same
+ * element data.
+ */
+OSKAR_EXPORT
+void oskar_station_work_evaluate_element(oskar_StationWork* work,
+        int dir_id, const oskar_Element* model, int normalise, int swap_xy,
+        double orientation_x, double orientation_y, int offset_points,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, double frequency_hz, oskar_Mem* theta,
+        oskar_Mem* phi_x, oskar_Mem* phi_y, int offset_out,
+        oskar_Mem* output, int* status);
+
+/**
+ * @brief Enables or disables sharing of tile beams between stations.
+ *
+ * @details
+ * While sharing is enabled, the beam of each child station (tile) that is
+ * in a tile beam class (see oskar_station_tile_beam_class()) is stored
+ * in the work structure, and copied for any other tile in the same class,
+ * in any station, that is evaluated for the same sources.
+ *
+ * Sharing should be enabled only while the beams of a set of stations
+ * are evaluated for one set of sources, at one time and frequency,
+ * as in oskar_evaluate_jones_E(). Stored tile beams are discarded
+ * when sharing is disabled.
+ *
+ * @param[in,out] work          Station beam workspace.
+ * @param[in] enable            If true, enable sharing; otherwise disable it.
+ */
+OSKAR_EXPORT
+void oskar_station_work_set_tile_beam_sharing(oskar_StationWork* work,
+        int enable);
+
+/**
+ * @brief Copies a stored tile beam, if there is one.
+ *
+ * @details
+ * Copies the beam of a tile in the given class, if one has been stored
+ * for the same source directions with oskar_station_work_store_tile_beam()
+ * since tile beam sharing was last enabled.
+ * Stored beams are matched using the values of the direction cosines,
+ * not the arrays that hold them.
+ *
+ * @param[in,out] work          Station beam workspace.
+ * @param[in] tile_class        Tile beam class, or 0 if not shared.
+ * @param[in] time_index        Simulation time index.
+ * @param[in] frequency_hz      Frequency, in Hz.
+ * @param[in] offset_points     Offset into source direction arrays.
+ * @param[in] num_points        Number of source directions.
+ * @param[in] x                 Source x direction cosines used for the beam.
+ * @param[in] y                 Source y direction cosines used for the beam.
+ * @param[in] z                 Source z direction cosines used for the beam.
+ * @param[in] offset_out        Offset into output array.
+ * @param[in,out] output        Output array.
+ * @param[in,out] status        Status return code.
+ *
+ * @return True if the beam was copied, otherwise false.
+ */
+OSKAR_EXPORT
+int oskar_station_work_copy_tile_beam(oskar_StationWork* work,
+        int tile_class, int time_index, double frequency_hz,
+        int offset_points, int num_points, const oskar_Mem* x,
+        const oskar_Mem* y, const oskar_Mem* z, int offset_out,
+        oskar_Mem* output, int* status);
+
+/**
+ * @brief Stores a tile beam for use by other stations.
+ *
+ * @details
+ * Stores a copy of the beam of a tile in the given class, if tile beam
+ * sharing is enabled and there is space for it.
+ * The parameters are as for oskar_station_work_copy_tile_beam().
+ */
+OSKAR_EXPORT
+void oskar_station_work_store_tile_beam(oskar_StationWork* work,
+        int tile_class, int time_index, double frequency_hz,
+        int offset_points, int num_points, const oskar_Mem* x,
+        const oskar_Mem* y, const oskar_Mem* z, int offset_in,
+        const oskar_Mem* beam, int* status);
+
+/**
+ * @brief Returns the time-variable element errors for a station.
+ *
+ * @details
+ * Returns the complex gain and phase errors of each element in the given
+ * feed of the station, as generated by oskar_evaluate_element_weights_errors()
+ * for the time index.
+ *
+ * The errors do not depend on frequency or beam direction, so they are
+ * kept in the work structure and returned again for later calls for the
+ * same station, feed and time index. Errors at other time indices are
+ * replaced when space is needed.
+ *
+ * @param[in,out] work          Station beam workspace.
+ * @param[in] station           Station model.
+ * @param[in] feed              Feed index (0 = X, 1 = Y).
+ * @param[in] time_index        Simulation time index.
+ * @param[in,out] status        Status return code.
+ *
+ * @return The element errors, which must not be modified.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_station_work_element_errors(oskar_StationWork* work,
+        const oskar_Station* station, int feed, int time_index, int* status);
+
 OSKAR_EXPORT
 const oskar_Mem* oskar_station_work_evaluate_tec_screen(oskar_StationWork* work,
         int num_points, const oskar_Mem* l, const oskar_Mem* m,
@@ -68,6 +68,7 @@ struct oskar_Station
 
     /* Data used only for aperture array stations ---------------------------*/
     int identical_children;       /* True if all child stations are identical. */
+    int tile_beam_class;          /* Telescope-wide class of stations with the same beam as this child station, or 0 if none. */
     int num_elements;             /* Number of antenna elements in the station (auto determined). */
     int num_element_types;        /* Number of element types (this is the size of element_pattern array). */
     int normalise_array_pattern;  /* True if the array pattern should be normalised by the number of antennas. */
@@ -8,6 +8,67 @@
 
 #include <mem/oskar_mem.h>
 
+struct oskar_StationBeamGrid
+{
+    const void* station;         /* Station for which the grid is valid. */
+    int station_id;              /* Unique ID of the station. */
+    int time_variable;           /* True if the beam has time-variable errors. */
+    int time_index;              /* Time index, if beam is time-variable. */
+    int num_side;                /* Number of grid points along each side. */
+    int valid;                   /* True if the grid data are valid. */
+    unsigned int last_used;      /* Value of use counter when last used. */
+    double frequency_hz;         /* Frequency of the grid, in Hz. */
+    double beam_dir[3];          /* Beam direction cosines (ENU). */
+    oskar_Mem* data;             /* Beam values on the grid. */
+};
+typedef struct oskar_StationBeamGrid oskar_StationBeamGrid;
+
+struct oskar_ElementCacheDirs
+{
+    int id;                      /* Direction set ID. */
+    int time_index;              /* Time index when directions were set. */
+    unsigned int last_used;      /* Value of use counter when last used. */
+    oskar_Mem* dir[3];           /* Direction cosines (ENU). */
+};
+typedef struct oskar_ElementCacheDirs oskar_ElementCacheDirs;
+
+struct oskar_ElementCacheEntry
+{
+    const void* element;         /* Element model, or NULL if unused. */
+    int dir_id;                  /* Direction set ID. */
+    int freq_index;              /* Index of element data frequency. */
+    int normalise, swap_xy;      /* Element evaluation options. */
+    double freq_hz;              /* Element data frequency, in Hz. */
+    double orientation_x, orientation_y;
+    oskar_Mem* data;             /* Element response. */
+};
+typedef struct oskar_ElementCacheEntry oskar_ElementCacheEntry;
+
+struct oskar_TileBeamCacheEntry
+{
+    int valid;                   /* True if the entry holds a tile beam. */
+    int tile_class;              /* Tile beam class. */
+    int time_index;              /* Time index of the beam. */
+    int offset_points;           /* Offset into source directions. */
+    int num_points;              /* Number of source directions. */
+    unsigned long long dir_hash; /* Hash of source direction cosines. */
+    unsigned long long subset;   /* Hash of visible source indices. */
+    double frequency_hz;         /* Frequency of the beam, in Hz. */
+    oskar_Mem* data;             /* Tile beam. */
+};
+typedef struct oskar_TileBeamCacheEntry oskar_TileBeamCacheEntry;
+
+struct oskar_ElementErrorsCacheEntry
+{
+    const void* station;         /* Station model, or NULL if unused. */
+    int station_id;              /* Unique ID of the station. */
+    int feed;                    /* Feed index. */
+    int time_index;              /* Time index of the errors. */
+    unsigned int seed;           /* Random seed for the errors. */
+    oskar_Mem* data;             /* Complex element errors. */
+};
+typedef struct oskar_ElementErrorsCacheEntry oskar_ElementErrorsCacheEntry;
+
 struct oskar_StationWork
 {
     oskar_Mem* weights;          /* Complex scalar. */
@@ -23,6 +84,10 @@ struct oskar_StationWork
     oskar_Mem* phi_y;            /* Real scalar. */
     oskar_Mem* beam_out_scratch; /* Output scratch array. */
 
+    /* Sources above the horizon, indexed by source_indices. */
+    oskar_Mem* visible_dir[3];   /* Direction cosines (ENU). */
+    oskar_Mem* visible_beam;     /* Beam for visible sources. */
+
     /* TEC screen. */
     char screen_type;
     int previous_time_index;
@@ -33,6 +98,42 @@ struct oskar_StationWork
     oskar_Mem *tec_screen_path, *tec_screen;
     oskar_Mem *screen_output;
 
+    /* Station beam interpolation grids. */
+    int beam_grid_samples;       /* Grid points per beam width (0 = off). */
+    size_t beam_grid_max_bytes;  /* Maximum memory for all grids. */
+    size_t beam_grid_bytes;      /* Current memory used by all grids. */
+    unsigned int beam_grid_counter;
+    int num_beam_grids;
+    oskar_StationBeamGrid* beam_grid;
+    oskar_Mem* beam_grid_dir[3]; /* Direction cosines of grid points. */
+    oskar_Mem* beam_grid_scratch;
+
+    /* Element response cache. */
+    size_t element_cache_max_bytes;
+    size_t element_cache_bytes;
+    unsigned int element_cache_counter;
+    int element_cache_time_index; /* Time index of the last direction set. */
+    int element_cache_hits;      /* Responses reused at that time index. */
+    int element_cache_off;       /* True if responses were not reused. */
+    int element_cache_next_id;
+    int num_element_cache_dirs, num_element_cache_entries;
+    oskar_ElementCacheDirs* element_cache_dirs;
+    oskar_ElementCacheEntry* element_cache_entries;
+
+    /* Tile beam cache. */
+    int tile_beam_sharing;       /* True if tile beams can be shared. */
+    unsigned long long tile_beam_subset; /* Hash of visible source indices. */
+    size_t tile_beam_max_bytes;  /* Maximum memory for all tile beams. */
+    size_t tile_beam_bytes;      /* Current memory used by all tile beams. */
+    int num_tile_beams;
+    oskar_TileBeamCacheEntry* tile_beams;
+
+    /* Time-variable element errors cache. */
+    size_t element_errors_max_bytes;
+    size_t element_errors_bytes;
+    int num_element_errors;
+    oskar_ElementErrorsCacheEntry* element_errors;
+
     int num_depths;
     oskar_Mem** beam;            /* For hierarchical stations. */
 };
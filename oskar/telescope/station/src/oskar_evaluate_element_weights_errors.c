@@ -26,18 +26,71 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "telescope/station/define_evaluate_element_weights_errors.h"
 #include "telescope/station/oskar_evaluate_element_weights_errors.h"
+#include "math/private_random_helpers.h"
 #include "utility/oskar_device.h"
-#include "utility/oskar_kernel_macros.h"
 #include <math.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-OSKAR_ELEMENT_WEIGHTS_ERR(evaluate_element_weights_errors_f, float, float2)
-OSKAR_ELEMENT_WEIGHTS_ERR(evaluate_element_weights_errors_d, double, double2)
+/* Number of random number blocks generated in each batch on the CPU. */
+#define BATCH 64
+
+/*
+ * Generates the errors on the CPU in one pass, for use instead of
+ * oskar_mem_random_gaussian() followed by OSKAR_ELEMENT_WEIGHTS_ERR.
+ * Each Philox block of four random numbers gives the amplitude and phase
+ * perturbations for two elements, in the same order as the random numbers
+ * would be stored in the complex errors array, so the results are the same.
+ * The blocks for a batch of elements are generated together first, as the
+ * counter-based generator has no dependencies between blocks.
+ */
+#define ELEMENT_WEIGHTS_ERR_CPU(NAME, FP, FP2, BOX_MULLER)                  \
+static void NAME(const int n, const unsigned int seed,                      \
+        const unsigned int time_index, const unsigned int station_id,       \
+        const FP* amp_gain, const FP* amp_error, const FP* phase_offset,    \
+        const FP* phase_error, FP2* errors)                                 \
+{                                                                           \
+    int b0, b, j;                                                           \
+    const int num_blocks = (n + 1) / 2;                                     \
+    for (b0 = 0; b0 < num_blocks; b0 += BATCH)                              \
+    {                                                                       \
+        uint32_t rnd[BATCH][4];                                             \
+        const int num = (num_blocks - b0 < BATCH) ? num_blocks - b0 : BATCH;\
+        for (b = 0; b < num; ++b)                                           \
+        {                                                                   \
+            OSKAR_R123_GENERATE_4(seed, b0 + b, time_index, station_id,     \
+                    0x12345678)                                             \
+            rnd[b][0] = u.i[0]; rnd[b][1] = u.i[1];                         \
+            rnd[b][2] = u.i[2]; rnd[b][3] = u.i[3];                         \
+        }                                                                   \
+        for (b = 0; b < num; ++b)                                           \
+        {                                                                   \
+            FP t[4];                                                        \
+            BOX_MULLER(rnd[b][0], rnd[b][1], &t[0], &t[1]);                 \
+            BOX_MULLER(rnd[b][2], rnd[b][3], &t[2], &t[3]);                 \
+            for (j = 0; j < 2; ++j)                                         \
+            {                                                               \
+                FP re, im, amp, phase;                                      \
+                const int i = 2 * (b0 + b) + j;                             \
+                if (i >= n) break;                                          \
+                amp = t[2 * j] * amp_error[i];                              \
+                amp += amp_gain[i];                                         \
+                phase = t[2 * j + 1] * phase_error[i];                      \
+                phase += phase_offset[i];                                   \
+                re = cos(phase); im = sin(phase);                           \
+                errors[i].x = re * amp; errors[i].y = im * amp;             \
+            }                                                               \
+        }                                                                   \
+    }                                                                       \
+}
+
+ELEMENT_WEIGHTS_ERR_CPU(evaluate_element_weights_errors_f,
+        float, float2, oskar_box_muller_f)
+ELEMENT_WEIGHTS_ERR_CPU(evaluate_element_weights_errors_d,
+        double, double2, oskar_box_muller_d)
 
 void oskar_evaluate_element_weights_errors(int num_elements,
         const oskar_Mem* gain, const oskar_Mem* gain_error,
@@ -74,20 +127,19 @@ void oskar_evaluate_element_weights_errors(int num_elements,
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
         return;
     }
-    oskar_mem_random_gaussian(errors, random_seed, time_index,
-            station_id, 0x12345678, 1.0, status);
-    if (*status) return;
     if (location == OSKAR_CPU)
     {
         if (type == OSKAR_DOUBLE_COMPLEX)
-            evaluate_element_weights_errors_d(num_elements,
+            evaluate_element_weights_errors_d(num_elements, random_seed,
+                    (unsigned int) time_index, (unsigned int) station_id,
                     oskar_mem_double_const(gain, status),
                     oskar_mem_double_const(gain_error, status),
                     oskar_mem_double_const(phase, status),
                     oskar_mem_double_const(phase_error, status),
                     oskar_mem_double2(errors, status));
         else if (type == OSKAR_SINGLE_COMPLEX)
-            evaluate_element_weights_errors_f(num_elements,
+            evaluate_element_weights_errors_f(num_elements, random_seed,
+                    (unsigned int) time_index, (unsigned int) station_id,
                     oskar_mem_float_const(gain, status),
                     oskar_mem_float_const(gain_error, status),
                     oskar_mem_float_const(phase, status),
@@ -109,6 +161,9 @@ void oskar_evaluate_element_weights_errors(int num_elements,
             *status = OSKAR_ERR_BAD_DATA_TYPE;
             return;
         }
+        oskar_mem_random_gaussian(errors, random_seed, time_index,
+                station_id, 0x12345678, 1.0, status);
+        if (*status) return;
         oskar_device_check_local_size(location, 0, local_size);
         global_size[0] = oskar_device_global_size(
                 (size_t) num_elements, local_size[0]);
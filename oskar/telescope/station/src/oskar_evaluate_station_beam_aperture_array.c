@@ -13,6 +13,8 @@
 #include "math/oskar_cmath.h"
 #include "math/oskar_dftw.h"
 
+#include <string.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,8 +28,95 @@ static void oskar_evaluate_station_beam_aperture_array_private(
         double frequency_hz, int depth, int offset_out, oskar_Mem* beam,
         int* status);
 
+#define GATHER_VISIBLE(FP) {\
+    const FP *x_ = (const FP*) oskar_mem_void_const(x);\
+    const FP *y_ = (const FP*) oskar_mem_void_const(y);\
+    const FP *z_ = (const FP*) oskar_mem_void_const(z);\
+    FP *xv = (FP*) oskar_mem_void(work->visible_dir[0]);\
+    FP *yv = (FP*) oskar_mem_void(work->visible_dir[1]);\
+    FP *zv = (FP*) oskar_mem_void(work->visible_dir[2]);\
+    for (i = 0; i < num_points; ++i)\
+    {\
+        if (z_[i] < (FP)0) continue;\
+        xv[num_visible] = x_[i];\
+        yv[num_visible] = y_[i];\
+        zv[num_visible] = z_[i];\
+        indices[num_visible++] = i;\
+    }\
+    }
 
-void oskar_evaluate_station_beam_aperture_array(
+/* Copies the directions of sources that are not below the horizon to the
+ * work buffers, using the same test as oskar_blank_below_horizon(),
+ * and returns the number of them. */
+static int gather_visible(oskar_StationWork* work, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        int* status)
+{
+    int i, num_visible = 0;
+    const int type = oskar_mem_type(z);
+    if (*status) return num_points;
+    if (type != OSKAR_SINGLE && type != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return num_points;
+    }
+    for (i = 0; i < 3; ++i)
+    {
+        if (work->visible_dir[i] &&
+                oskar_mem_type(work->visible_dir[i]) != type)
+        {
+            oskar_mem_free(work->visible_dir[i], status);
+            work->visible_dir[i] = 0;
+        }
+        if (!work->visible_dir[i])
+            work->visible_dir[i] = oskar_mem_create(type, OSKAR_CPU,
+                    0, status);
+        oskar_mem_ensure(work->visible_dir[i], (size_t) num_points, status);
+    }
+    oskar_mem_ensure(work->source_indices, (size_t) num_points, status);
+    if (*status) return num_points;
+    int* indices = oskar_mem_int(work->source_indices, status);
+    if (type == OSKAR_DOUBLE)
+        GATHER_VISIBLE(double)
+    else
+        GATHER_VISIBLE(float)
+    return num_visible;
+}
+
+static unsigned long long hash_indices(int num, const int* indices)
+{
+    int i;
+    unsigned long long hash = 14695981039346656037ULL;
+    for (i = 0; i < num; ++i)
+    {
+        hash ^= (unsigned long long) indices[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Copies the beam for the visible sources back to their original
+ * positions, and sets it to zero for the others. */
+static void scatter_visible(const oskar_StationWork* work, int num_points,
+        int num_visible, oskar_Mem* beam, int* status)
+{
+    int i;
+    if (*status) return;
+    if ((int) oskar_mem_length(beam) < num_points)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    const size_t size = oskar_mem_element_size(oskar_mem_type(beam));
+    const int* indices = oskar_mem_int_const(work->source_indices, status);
+    const char* in = (const char*) oskar_mem_void_const(work->visible_beam);
+    char* out = (char*) oskar_mem_void(beam);
+    memset(out, 0, num_points * size);
+    for (i = 0; i < num_visible; ++i)
+        memcpy(out + indices[i] * size, in + i * size, size);
+}
+
+static void evaluate_points(
         const oskar_Station* station,
         oskar_StationWork* work,
         int num_points,
@@ -40,8 +129,6 @@ void oskar_evaluate_station_beam_aperture_array(
         oskar_Mem* beam,
         int* status)
 {
-    if (*status) return;
-
     /* Evaluate beam directly if there are no child stations. */
     if (!oskar_station_has_child(station))
         oskar_evaluate_station_beam_aperture_array_private(station, work,
@@ -64,6 +151,82 @@ void oskar_evaluate_station_beam_aperture_array(
     }
 }
 
+void oskar_evaluate_station_beam_aperture_array(
+        const oskar_Station* station,
+        oskar_StationWork* work,
+        int num_points,
+        const oskar_Mem* x,
+        const oskar_Mem* y,
+        const oskar_Mem* z,
+        int time_index,
+        double gast_rad,
+        double frequency_hz,
+        oskar_Mem* beam,
+        int* status)
+{
+    if (*status) return;
+
+    /* On the CPU, evaluate the beam only for sources above the horizon,
+     * if there are any below it. */
+    if (oskar_mem_location(beam) == OSKAR_CPU &&
+            oskar_mem_location(z) == OSKAR_CPU &&
+            oskar_mem_location(work->source_indices) == OSKAR_CPU)
+    {
+        const int num_visible = gather_visible(work, num_points,
+                x, y, z, status);
+        work->tile_beam_subset = 0;
+        if (num_visible < num_points && !*status)
+        {
+            /* Tile beams can be shared only for the same visible sources. */
+            if (work->tile_beam_sharing)
+                work->tile_beam_subset = hash_indices(num_visible,
+                        oskar_mem_int_const(work->source_indices, status));
+            const int type = oskar_mem_type(beam);
+            if (work->visible_beam &&
+                    oskar_mem_type(work->visible_beam) != type)
+            {
+                oskar_mem_free(work->visible_beam, status);
+                work->visible_beam = 0;
+            }
+            if (!work->visible_beam)
+                work->visible_beam = oskar_mem_create(type, OSKAR_CPU,
+                        0, status);
+            oskar_mem_ensure(work->visible_beam, (size_t) num_visible,
+                    status);
+            if (num_visible > 0)
+                evaluate_points(station, work, num_visible,
+                        work->visible_dir[0], work->visible_dir[1],
+                        work->visible_dir[2], time_index, gast_rad,
+                        frequency_hz, work->visible_beam, status);
+            scatter_visible(work, num_points, num_visible, beam, status);
+            return;
+        }
+    }
+    evaluate_points(station, work, num_points, x, y, z, time_index,
+            gast_rad, frequency_hz, beam, status);
+}
+
+/* Evaluates the beam of a child station, or copies it from another
+ * station in the telescope if it has already been evaluated. */
+static void evaluate_child(const oskar_Station* child,
+        oskar_StationWork* work, int offset_points, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        int time_index, double gast_rad, double frequency_hz, int depth,
+        int offset_out, oskar_Mem* beam, int* status)
+{
+    const int tile_class = oskar_station_tile_beam_class(child);
+    if (oskar_station_work_copy_tile_beam(work, tile_class, time_index,
+            frequency_hz, offset_points, num_points, x, y, z, offset_out,
+            beam, status))
+        return;
+    oskar_evaluate_station_beam_aperture_array_private(child, work,
+            offset_points, num_points, x, y, z, time_index, gast_rad,
+            frequency_hz, depth, offset_out, beam, status);
+    oskar_station_work_store_tile_beam(work, tile_class, time_index,
+            frequency_hz, offset_points, num_points, x, y, z, offset_out,
+            beam, status);
+}
+
 static void oskar_evaluate_station_beam_aperture_array_private(
         const oskar_Station* s, oskar_StationWork* work, int offset_points,
         int num_points, const oskar_Mem* x, const oskar_Mem* y,
@@ -98,6 +261,8 @@ static void oskar_evaluate_station_beam_aperture_array_private(
     {
         /* Check if element types can be used to evaluate the beam. */
         const int num_element_types = oskar_station_num_element_types(s);
+        const int dir_id = oskar_station_work_element_directions(work,
+                time_index, offset_points, num_points, x, y, z, status);
         if (oskar_station_common_element_orientation(s))
         {
             /* Evaluate element patterns for each element type. */
@@ -105,7 +270,7 @@ static void oskar_evaluate_station_beam_aperture_array_private(
             signal = oskar_station_work_beam(work, beam,
                     num_element_types * (num_points + 1), 0, status);
             for (i = 0; i < num_element_types; ++i)
-                oskar_element_evaluate(
+                oskar_station_work_evaluate_element(work, dir_id,
                         oskar_station_element_const(s, i),
                         norm_element, swap_xy,
                         oskar_station_element_euler_index_rad(s, 0, 0, 0) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
@@ -126,7 +291,7 @@ static void oskar_evaluate_station_beam_aperture_array_private(
                     *status = OSKAR_ERR_OUT_OF_RANGE;
                     break;
                 }
-                oskar_element_evaluate(
+                oskar_station_work_evaluate_element(work, dir_id,
                         oskar_station_element_const(s, element_type[i]),
                         norm_element, swap_xy,
                         oskar_station_element_euler_index_rad(s, 0, 0, i) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
@@ -143,7 +308,7 @@ static void oskar_evaluate_station_beam_aperture_array_private(
                 const int eval_y = (i == 1 || num_feeds == 1) ? 1 : 0;
                 oskar_station_evaluate_element_weights(s, i, wavenumber,
                         beam_x, beam_y, beam_z, time_index,
-                        work->weights, work->weights_scratch, status);
+                        work->weights, work, status);
                 oskar_dftw(norm_array, num_elements, wavenumber, work->weights,
                         oskar_station_element_true_enu_metres_const(s, i, 0),
                         oskar_station_element_true_enu_metres_const(s, i, 1),
@@ -179,10 +344,9 @@ static void oskar_evaluate_station_beam_aperture_array_private(
                 num_elements * num_points, depth, status);
         if (oskar_station_identical_children(s))
         {
-            oskar_evaluate_station_beam_aperture_array_private(
-                    oskar_station_child_const(s, 0), work, offset_points,
-                    num_points, x, y, z, time_index, gast_rad, frequency_hz,
-                    depth + 1, 0, signal, status);
+            evaluate_child(oskar_station_child_const(s, 0), work,
+                    offset_points, num_points, x, y, z, time_index, gast_rad,
+                    frequency_hz, depth + 1, 0, signal, status);
             for (i = 1; i < num_elements; ++i)
                 oskar_mem_copy_contents(signal, signal, i * num_points, 0,
                         num_points, status);
@@ -190,10 +354,10 @@ static void oskar_evaluate_station_beam_aperture_array_private(
         else
         {
             for (i = 0; i < num_elements; ++i)
-                oskar_evaluate_station_beam_aperture_array_private(
-                        oskar_station_child_const(s, i), work, offset_points,
-                        num_points, x, y, z, time_index, gast_rad, frequency_hz,
-                        depth + 1, i * num_points, signal, status);
+                evaluate_child(oskar_station_child_const(s, i), work,
+                        offset_points, num_points, x, y, z, time_index,
+                        gast_rad, frequency_hz, depth + 1, i * num_points,
+                        signal, status);
         }
         for (i = 0; i < num_feeds; ++i)
         {
@@ -201,7 +365,7 @@ static void oskar_evaluate_station_beam_aperture_array_private(
             const int eval_y = (i == 1 || num_feeds == 1) ? 1 : 0;
             oskar_station_evaluate_element_weights(s, i, wavenumber,
                     beam_x, beam_y, beam_z, time_index,
-                    work->weights, work->weights_scratch, status);
+                    work->weights, work, status);
             oskar_dftw(norm_array, num_elements, wavenumber, work->weights,
                     oskar_station_element_true_enu_metres_const(s, i, 0),
                     oskar_station_element_true_enu_metres_const(s, i, 1),
@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/oskar_evaluate_station_beam_interp.h"
+#include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
+#include "telescope/station/oskar_blank_below_horizon.h"
+#include "telescope/station/oskar_station_beam_horizon_direction.h"
+#include "telescope/station/private_station_work.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIN_GRID_SIDE 33
+#define MAX_CHUNK_SIZE 16384
+#define MAX_GRIDS 256
+
+/* Bicubic convolution weights (Keys, a = -0.5). */
+#define CUBIC_WEIGHTS(T, W) \
+    W[0] = ((-0.5 * T + 1.0) * T - 0.5) * T; \
+    W[1] = (1.5 * T - 2.5) * T * T + 1.0; \
+    W[2] = ((-1.5 * T + 2.0) * T + 0.5) * T; \
+    W[3] = (0.5 * T - 0.5) * T * T;
+
+#define BEAM_INTERP(NAME, FP) \
+static void NAME(int num_points, const FP* x, const FP* y, int n, \
+        double inv_inc, int num_comp, const FP* grid, FP* out) \
+{ \
+    int i; \
+    _Pragma("omp parallel for private(i)") \
+    for (i = 0; i < num_points; ++i) \
+    { \
+        int c, j, k, ix[4], iy[4]; \
+        double wx[4], wy[4], acc[8]; \
+        const double u = (x[i] + 1.0) * inv_inc; \
+        const double v = (y[i] + 1.0) * inv_inc; \
+        const int u0 = (int) floor(u), v0 = (int) floor(v); \
+        const double tx = u - u0, ty = v - v0; \
+        CUBIC_WEIGHTS(tx, wx) \
+        CUBIC_WEIGHTS(ty, wy) \
+        for (j = 0; j < 4; ++j) \
+        { \
+            ix[j] = u0 - 1 + j; \
+            iy[j] = v0 - 1 + j; \
+            if (ix[j] < 0) ix[j] = 0; \
+            if (ix[j] > n - 1) ix[j] = n - 1; \
+            if (iy[j] < 0) iy[j] = 0; \
+            if (iy[j] > n - 1) iy[j] = n - 1; \
+        } \
+        for (c = 0; c < num_comp; ++c) acc[c] = 0.0; \
+        for (k = 0; k < 4; ++k) \
+        { \
+            for (j = 0; j < 4; ++j) \
+            { \
+                const double w = wx[j] * wy[k]; \
+                const FP* g = grid + num_comp * ((size_t) iy[k] * n + ix[j]); \
+                for (c = 0; c < num_comp; ++c) acc[c] += w * g[c]; \
+            } \
+        } \
+        for (c = 0; c < num_comp; ++c) \
+            out[num_comp * (size_t) i + c] = (FP) acc[c]; \
+    } \
+}
+
+BEAM_INTERP(beam_interp_f, float)
+BEAM_INTERP(beam_interp_d, double)
+
+/* Sets the direction cosines of a block of grid rows.
+ * Points beyond the horizon use z = 0, to give values that can be
+ * used to interpolate close to the horizon. The test is done in the
+ * precision of the beam, as the horizon test for the beam evaluation is. */
+#define GRID_DIRS(NAME, FP) \
+static void NAME(int n, int row, int num_rows, double inc, \
+        FP* x, FP* y, FP* z) \
+{ \
+    int i, k; \
+    for (k = 0; k < num_rows; ++k) \
+    { \
+        const FP y_ = (FP) (-1.0 + (row + k) * inc); \
+        for (i = 0; i < n; ++i) \
+        { \
+            const FP x_ = (FP) (-1.0 + i * inc); \
+            const FP r2 = x_ * x_ + y_ * y_; \
+            const int j = k * n + i; \
+            x[j] = x_; \
+            y[j] = y_; \
+            z[j] = r2 < (FP) 1 ? (FP) sqrt(1.0 - r2) : (FP) 0; \
+        } \
+    } \
+}
+
+GRID_DIRS(grid_dirs_f, float)
+GRID_DIRS(grid_dirs_d, double)
+
+
+/* Returns the maximum horizontal distance of any element from the
+ * station centre, including elements of child stations. */
+static double station_radius_m(const oskar_Station* s, int* status)
+{
+    int i;
+    double r_max = 0.0, r_child = 0.0;
+    const int num_elements = oskar_station_num_elements(s);
+    const oskar_Mem* x = oskar_station_element_true_enu_metres_const(s, 0, 0);
+    const oskar_Mem* y = oskar_station_element_true_enu_metres_const(s, 0, 1);
+    for (i = 0; i < num_elements; ++i)
+    {
+        const double x_ = oskar_mem_get_element(x, i, status);
+        const double y_ = oskar_mem_get_element(y, i, status);
+        const double r = sqrt(x_ * x_ + y_ * y_);
+        if (r > r_max) r_max = r;
+        if (oskar_station_has_child(s))
+        {
+            const double rc = station_radius_m(
+                    oskar_station_child_const(s, i), status);
+            if (rc > r_child) r_child = rc;
+        }
+    }
+    return r_max + r_child;
+}
+
+
+static int mem_nonzero(const oskar_Mem* mem)
+{
+    size_t i;
+    if (!mem) return 0;
+    const size_t n = oskar_mem_length(mem);
+    if (oskar_mem_type(mem) == OSKAR_DOUBLE)
+    {
+        const double* p = (const double*) oskar_mem_void_const(mem);
+        for (i = 0; i < n; ++i) if (p[i] != 0.0) return 1;
+    }
+    else if (oskar_mem_type(mem) == OSKAR_SINGLE)
+    {
+        const float* p = (const float*) oskar_mem_void_const(mem);
+        for (i = 0; i < n; ++i) if (p[i] != 0.0f) return 1;
+    }
+    return 0;
+}
+
+
+/* Returns true if the station, or any of its children, has
+ * time-variable element errors. */
+static int time_variable_errors(const oskar_Station* s)
+{
+    int i, feed;
+    if (!s) return 0;
+    if (oskar_station_apply_element_errors(s))
+    {
+        for (feed = 0; feed < 2; ++feed)
+        {
+            if (mem_nonzero(oskar_station_element_gain_error_const(s, feed)) ||
+                    mem_nonzero(oskar_station_element_phase_error_rad_const(
+                            s, feed)))
+                return 1;
+        }
+    }
+    if (oskar_station_has_child(s))
+    {
+        const int num_elements = oskar_station_num_elements(s);
+        for (i = 0; i < num_elements; ++i)
+            if (time_variable_errors(oskar_station_child_const(s, i)))
+                return 1;
+    }
+    return 0;
+}
+
+
+static void free_grid_data(oskar_StationWork* work, oskar_StationBeamGrid* g,
+        int* status)
+{
+    if (!g->data) return;
+    work->beam_grid_bytes -= oskar_mem_length(g->data) *
+            oskar_mem_element_size(oskar_mem_type(g->data));
+    oskar_mem_free(g->data, status);
+    g->data = 0;
+    g->valid = 0;
+}
+
+
+/* Returns the grid for the station, creating it if necessary.
+ * Once there are MAX_GRIDS entries, the least recently used one is
+ * reused for the new grid. */
+static oskar_StationBeamGrid* get_grid(oskar_StationWork* work,
+        const oskar_Station* station, double frequency_hz, int* status)
+{
+    int i, slot = -1;
+    const int id = oskar_station_unique_id(station);
+    for (i = 0; i < work->num_beam_grids; ++i)
+    {
+        oskar_StationBeamGrid* g = &work->beam_grid[i];
+        if (g->station == (const void*) station && g->station_id == id &&
+                g->frequency_hz == frequency_hz)
+            return g;
+        if (slot < 0 || g->last_used < work->beam_grid[slot].last_used)
+            slot = i;
+    }
+    if (work->num_beam_grids < MAX_GRIDS)
+    {
+        oskar_StationBeamGrid* t = (oskar_StationBeamGrid*) realloc(
+                work->beam_grid, (work->num_beam_grids + 1) *
+                sizeof(oskar_StationBeamGrid));
+        if (!t)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return 0;
+        }
+        work->beam_grid = t;
+        slot = work->num_beam_grids++;
+        work->beam_grid[slot].data = 0;
+    }
+    oskar_StationBeamGrid* g = &work->beam_grid[slot];
+    free_grid_data(work, g, status);
+    g->station = station;
+    g->station_id = id;
+    g->time_variable = time_variable_errors(station);
+    g->time_index = -1;
+    g->num_side = 0;
+    g->valid = 0;
+    g->last_used = 0;
+    g->frequency_hz = frequency_hz;
+    g->beam_dir[0] = g->beam_dir[1] = g->beam_dir[2] = 0.0;
+    return g;
+}
+
+
+/* Frees the least recently used grids until the new one will fit. */
+static int make_space(oskar_StationWork* work, size_t num_bytes,
+        const oskar_StationBeamGrid* keep, int* status)
+{
+    if (num_bytes > work->beam_grid_max_bytes) return 0;
+    while (work->beam_grid_bytes + num_bytes > work->beam_grid_max_bytes)
+    {
+        int i;
+        oskar_StationBeamGrid* oldest = 0;
+        for (i = 0; i < work->num_beam_grids; ++i)
+        {
+            oskar_StationBeamGrid* g = &work->beam_grid[i];
+            if (g == keep || !g->data) continue;
+            if (!oldest || g->last_used < oldest->last_used) oldest = g;
+        }
+        if (!oldest) return 0;
+        free_grid_data(work, oldest, status);
+    }
+    return 1;
+}
+
+
+static void evaluate_grid(const oskar_Station* station,
+        oskar_StationWork* work, oskar_StationBeamGrid* g, int time_index,
+        double gast_rad, double frequency_hz, int* status)
+{
+    int i, row;
+    const int n = g->num_side;
+    const double inc = 2.0 / (n - 1);
+    const int rows_per_chunk = (n < MAX_CHUNK_SIZE) ? MAX_CHUNK_SIZE / n : 1;
+    const int is_dbl = oskar_mem_precision(g->data) == OSKAR_DOUBLE;
+    for (row = 0; row < n; row += rows_per_chunk)
+    {
+        const int num_rows = (n - row < rows_per_chunk) ?
+                n - row : rows_per_chunk;
+        const int num_chunk = num_rows * n;
+        for (i = 0; i < 3; ++i)
+            oskar_mem_ensure(work->beam_grid_dir[i], num_chunk, status);
+        if (*status) return;
+
+        if (is_dbl)
+            grid_dirs_d(n, row, num_rows, inc,
+                    oskar_mem_double(work->beam_grid_dir[0], status),
+                    oskar_mem_double(work->beam_grid_dir[1], status),
+                    oskar_mem_double(work->beam_grid_dir[2], status));
+        else
+            grid_dirs_f(n, row, num_rows, inc,
+                    oskar_mem_float(work->beam_grid_dir[0], status),
+                    oskar_mem_float(work->beam_grid_dir[1], status),
+                    oskar_mem_float(work->beam_grid_dir[2], status));
+        if (work->beam_grid_scratch && oskar_mem_type(
+                work->beam_grid_scratch) != oskar_mem_type(g->data))
+        {
+            oskar_mem_free(work->beam_grid_scratch, status);
+            work->beam_grid_scratch = 0;
+        }
+        if (!work->beam_grid_scratch)
+            work->beam_grid_scratch = oskar_mem_create(
+                    oskar_mem_type(g->data), OSKAR_CPU, 0, status);
+        oskar_mem_ensure(work->beam_grid_scratch, num_chunk, status);
+
+        /* Grids depend on the parent station, so tile beams for them
+         * are not shared. */
+        const int sharing = work->tile_beam_sharing;
+        work->tile_beam_sharing = 0;
+        oskar_evaluate_station_beam_aperture_array(station, work, num_chunk,
+                work->beam_grid_dir[0], work->beam_grid_dir[1],
+                work->beam_grid_dir[2], time_index, gast_rad, frequency_hz,
+                work->beam_grid_scratch, status);
+        work->tile_beam_sharing = sharing;
+        oskar_mem_copy_contents(g->data, work->beam_grid_scratch,
+                (size_t) row * n, 0, (size_t) num_chunk, status);
+    }
+}
+
+
+void oskar_evaluate_station_beam_interp(
+        const oskar_Station* station,
+        oskar_StationWork* work,
+        int num_points,
+        const oskar_Mem* x,
+        const oskar_Mem* y,
+        const oskar_Mem* z,
+        int time_index,
+        double gast_rad,
+        double frequency_hz,
+        oskar_Mem* beam,
+        int* status)
+{
+    double beam_dir[3];
+    if (*status) return;
+
+    /* Evaluate the beam directly if interpolation is not possible. */
+    const int type = oskar_mem_type(beam);
+    if (work->beam_grid_samples <= 0 ||
+            oskar_mem_location(beam) != OSKAR_CPU ||
+            oskar_mem_location(x) != OSKAR_CPU)
+    {
+        oskar_evaluate_station_beam_aperture_array(station, work,
+                num_points, x, y, z, time_index, gast_rad, frequency_hz,
+                beam, status);
+        return;
+    }
+
+    /* Find the grid for the station and frequency. */
+    oskar_station_beam_horizon_direction(station, gast_rad,
+            &beam_dir[0], &beam_dir[1], &beam_dir[2], status);
+    oskar_StationBeamGrid* g = get_grid(work, station, frequency_hz, status);
+    if (*status) return;
+    if (g->num_side == 0)
+    {
+        /* Set the grid size from the beam width. */
+        const double wavelength = 299792458.0 / frequency_hz;
+        const double diameter = 2.0 * station_radius_m(station, status);
+        const double inc = wavelength /
+                (diameter * work->beam_grid_samples);
+        g->num_side = (inc < 2.0 / (MIN_GRID_SIDE - 1)) ?
+                1 + (int) ceil(2.0 / inc) : MIN_GRID_SIDE;
+    }
+    const int n = g->num_side;
+    const size_t num_cells = (size_t) n * n;
+    g->last_used = ++work->beam_grid_counter;
+
+    /* Check whether the grid can be used as it is. */
+    const int same_dir = g->beam_dir[0] == beam_dir[0] &&
+            g->beam_dir[1] == beam_dir[1] && g->beam_dir[2] == beam_dir[2];
+    const int same_time = !g->time_variable || g->time_index == time_index;
+    if (g->data && oskar_mem_type(g->data) != type)
+        free_grid_data(work, g, status);
+    if (!g->valid || !same_dir || !same_time)
+    {
+        /* Don't evaluate a grid larger than the number of points unless
+         * it can be reused: that is, if the beam is not time-variable and
+         * the beam direction is the same as the last time. */
+        const int reusable = same_dir && !g->time_variable &&
+                g->time_index >= 0;
+        const size_t num_bytes = num_cells * oskar_mem_element_size(type);
+        g->valid = 0;
+        g->time_index = time_index;
+        g->beam_dir[0] = beam_dir[0];
+        g->beam_dir[1] = beam_dir[1];
+        g->beam_dir[2] = beam_dir[2];
+        if ((!reusable && num_cells > (size_t) num_points) ||
+                !make_space(work, g->data ? 0 : num_bytes, g, status))
+        {
+            oskar_evaluate_station_beam_aperture_array(station, work,
+                    num_points, x, y, z, time_index, gast_rad, frequency_hz,
+                    beam, status);
+            return;
+        }
+        if (!g->data)
+        {
+            g->data = oskar_mem_create(type, OSKAR_CPU, num_cells, status);
+            work->beam_grid_bytes += num_bytes;
+        }
+        evaluate_grid(station, work, g, time_index, gast_rad, frequency_hz,
+                status);
+        if (*status) return;
+        g->valid = 1;
+    }
+
+    /* Interpolate the beam at the required points. */
+    const int num_comp = oskar_mem_is_matrix(beam) ? 8 : 2;
+    oskar_mem_ensure(beam, (size_t) num_points, status);
+    if (*status) return;
+    if (oskar_mem_precision(beam) == OSKAR_DOUBLE)
+        beam_interp_d(num_points, oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status), n, (n - 1) / 2.0,
+                num_comp, (const double*) oskar_mem_void_const(g->data),
+                (double*) oskar_mem_void(beam));
+    else
+        beam_interp_f(num_points, oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status), n, (n - 1) / 2.0,
+                num_comp, (const float*) oskar_mem_void_const(g->data),
+                (float*) oskar_mem_void(beam));
+    oskar_blank_below_horizon(0, num_points, z, 0, beam, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -132,6 +132,11 @@ int oskar_station_identical_children(const oskar_Station* model)
     return model ? model->identical_children : 0;
 }
 
+int oskar_station_tile_beam_class(const oskar_Station* model)
+{
+    return model ? model->tile_beam_class : 0;
+}
+
 int oskar_station_num_elements(const oskar_Station* model)
 {
     return model ? model->num_elements : 0;
@@ -436,6 +441,11 @@ const oskar_Mem* oskar_station_permitted_beam_el_rad_const(
 
 /* Setters. */
 
+void oskar_station_set_tile_beam_class(oskar_Station* model, int value)
+{
+    if (model) model->tile_beam_class = value;
+}
+
 void oskar_station_set_unique_ids(oskar_Station* model, int* counter)
 {
     if (!model) return;
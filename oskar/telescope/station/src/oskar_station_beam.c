@@ -7,6 +7,7 @@
 #include "telescope/station/oskar_station.h"
 #include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
 #include "telescope/station/oskar_evaluate_station_beam_gaussian.h"
+#include "telescope/station/oskar_evaluate_station_beam_interp.h"
 #include "telescope/station/oskar_evaluate_vla_beam_pbcor.h"
 #include "convert/oskar_convert_apparent_ra_dec_to_enu_directions.h"
 #include "convert/oskar_convert_az_el_to_enu_directions.h"
@@ -171,9 +172,14 @@ void oskar_station_beam(
     }
     else if (station_type == OSKAR_STATION_TYPE_AA)
     {
-        oskar_evaluate_station_beam_aperture_array(station, work,
-                num_points, enu[0], enu[1], enu[2],
-                time_index, gast_rad, frequency_hz, out, status);
+        if (work->beam_grid_samples > 0)
+            oskar_evaluate_station_beam_interp(station, work,
+                    num_points, enu[0], enu[1], enu[2],
+                    time_index, gast_rad, frequency_hz, out, status);
+        else
+            oskar_evaluate_station_beam_aperture_array(station, work,
+                    num_points, enu[0], enu[1], enu[2],
+                    time_index, gast_rad, frequency_hz, out, status);
     }
     else
     {
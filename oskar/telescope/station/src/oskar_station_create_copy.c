@@ -82,6 +82,7 @@ oskar_Station* oskar_station_create_copy(const oskar_Station* src,
 
     /* Copy aperture array data, except num_element_types (done later). */
     dst->identical_children = src->identical_children;
+    dst->tile_beam_class = src->tile_beam_class;
     dst->num_elements = src->num_elements;
     dst->normalise_array_pattern = src->normalise_array_pattern;
     dst->normalise_element_pattern = src->normalise_element_pattern;
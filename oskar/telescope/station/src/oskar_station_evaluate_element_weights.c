@@ -29,48 +29,138 @@
 #include "telescope/station/oskar_station_evaluate_element_weights.h"
 #include "telescope/station/oskar_evaluate_element_weights_dft.h"
 #include "telescope/station/oskar_evaluate_element_weights_errors.h"
+#include "math/define_multiply.h"
+#include "utility/oskar_kernel_macros.h"
+#include <math.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Evaluates the DFT weights on the CPU, and applies the element errors
+ * and apodisation weights (either of which may be NULL) in the same pass. */
+#define ELEMENT_WEIGHTS_CPU(NAME, FP, FP2)                                  \
+static void NAME(const int n, const FP* x, const FP* y, const FP* z,        \
+        const FP* cable_length_error, const FP wavenumber,                  \
+        const FP x1, const FP y1, const FP z1, const FP2* errors,           \
+        const FP2* apodisation, FP2* weights)                               \
+{                                                                           \
+    int i;                                                                  \
+    for (i = 0; i < n; ++i)                                                 \
+    {                                                                       \
+        FP2 w, t;                                                           \
+        const FP p = wavenumber * (                                         \
+                x[i] * x1 + y[i] * y1 + z[i] * z1 + cable_length_error[i]); \
+        SINCOS(-p, w.y, w.x);                                               \
+        if (errors)                                                         \
+        {                                                                   \
+            OSKAR_MUL_COMPLEX(t, w, errors[i])                              \
+            w = t;                                                          \
+        }                                                                   \
+        if (apodisation)                                                    \
+        {                                                                   \
+            OSKAR_MUL_COMPLEX(t, w, apodisation[i])                         \
+            w = t;                                                          \
+        }                                                                   \
+        weights[i] = w;                                                     \
+    }                                                                       \
+}
+
+ELEMENT_WEIGHTS_CPU(element_weights_float, float, float2)
+ELEMENT_WEIGHTS_CPU(element_weights_double, double, double2)
+
 void oskar_station_evaluate_element_weights(const oskar_Station* station,
         int feed, double wavenumber, double x_beam, double y_beam,
         double z_beam, int time_index, oskar_Mem* weights,
-        oskar_Mem* weights_scratch, int* status)
+        oskar_StationWork* work, int* status)
 {
+    oskar_Mem* temp_errors = 0;
+    const oskar_Mem *errors = 0, *apodisation = 0;
     if (*status) return;
     const int num_elements = oskar_station_num_elements(station);
+    const int location = oskar_mem_location(weights);
+    const int type = oskar_mem_type(weights);
     oskar_mem_ensure(weights, num_elements, status);
 
-    /* Generate DFT weights. */
-    oskar_evaluate_element_weights_dft(num_elements,
-            oskar_station_element_measured_enu_metres_const(station, feed, 0),
-            oskar_station_element_measured_enu_metres_const(station, feed, 1),
-            oskar_station_element_measured_enu_metres_const(station, feed, 2),
-            oskar_station_element_cable_length_error_metres_const(station, feed),
-            wavenumber, x_beam, y_beam, z_beam, weights, status);
-
-    /* Apply time-variable errors. */
+    /* Get the time-variable errors. */
     if (oskar_station_apply_element_errors(station))
     {
-        oskar_mem_ensure(weights_scratch, num_elements, status);
-        oskar_evaluate_element_weights_errors(num_elements,
-                oskar_station_element_gain_const(station, feed),
-                oskar_station_element_gain_error_const(station, feed),
-                oskar_station_element_phase_offset_rad_const(station, feed),
-                oskar_station_element_phase_error_rad_const(station, feed),
-                oskar_station_seed_time_variable_errors(station), time_index,
-                oskar_station_unique_id(station), weights_scratch, status);
-        oskar_mem_multiply(weights, weights, weights_scratch,
-                0, 0, 0, num_elements, status);
+        if (work)
+            errors = oskar_station_work_element_errors(work, station,
+                    feed, time_index, status);
+        else
+        {
+            temp_errors = oskar_mem_create(type, location,
+                    num_elements, status);
+            oskar_evaluate_element_weights_errors(num_elements,
+                    oskar_station_element_gain_const(station, feed),
+                    oskar_station_element_gain_error_const(station, feed),
+                    oskar_station_element_phase_offset_rad_const(station, feed),
+                    oskar_station_element_phase_error_rad_const(station, feed),
+                    oskar_station_seed_time_variable_errors(station),
+                    time_index, oskar_station_unique_id(station),
+                    temp_errors, status);
+            errors = temp_errors;
+        }
     }
 
-    /* Apply apodisation. */
+    /* Get the apodisation weights. */
     if (oskar_station_apply_element_weight(station))
-        oskar_mem_multiply(weights, weights,
-                oskar_station_element_weight_const(station, feed),
-                0, 0, 0, num_elements, status);
+        apodisation = oskar_station_element_weight_const(station, feed);
+
+    /* Generate DFT weights, and apply errors and apodisation. */
+    const oskar_Mem* x =
+            oskar_station_element_measured_enu_metres_const(station, feed, 0);
+    const oskar_Mem* y =
+            oskar_station_element_measured_enu_metres_const(station, feed, 1);
+    const oskar_Mem* z =
+            oskar_station_element_measured_enu_metres_const(station, feed, 2);
+    const oskar_Mem* cable =
+            oskar_station_element_cable_length_error_metres_const(station, feed);
+    if (location == OSKAR_CPU && !*status &&
+            oskar_mem_location(x) == location &&
+            oskar_mem_type(x) == oskar_mem_precision(weights) &&
+            (!errors || oskar_mem_type(errors) == type) &&
+            (!apodisation || oskar_mem_type(apodisation) == type))
+    {
+        if (type == OSKAR_DOUBLE_COMPLEX)
+            element_weights_double(num_elements,
+                    oskar_mem_double_const(x, status),
+                    oskar_mem_double_const(y, status),
+                    oskar_mem_double_const(z, status),
+                    oskar_mem_double_const(cable, status),
+                    wavenumber, x_beam, y_beam, z_beam,
+                    errors ? oskar_mem_double2_const(errors, status) : 0,
+                    apodisation ?
+                            oskar_mem_double2_const(apodisation, status) : 0,
+                    oskar_mem_double2(weights, status));
+        else if (type == OSKAR_SINGLE_COMPLEX)
+            element_weights_float(num_elements,
+                    oskar_mem_float_const(x, status),
+                    oskar_mem_float_const(y, status),
+                    oskar_mem_float_const(z, status),
+                    oskar_mem_float_const(cable, status),
+                    (float) wavenumber, (float) x_beam, (float) y_beam,
+                    (float) z_beam,
+                    errors ? oskar_mem_float2_const(errors, status) : 0,
+                    apodisation ?
+                            oskar_mem_float2_const(apodisation, status) : 0,
+                    oskar_mem_float2(weights, status));
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+    }
+    else
+    {
+        oskar_evaluate_element_weights_dft(num_elements, x, y, z, cable,
+                wavenumber, x_beam, y_beam, z_beam, weights, status);
+        if (errors)
+            oskar_mem_multiply(weights, weights, errors,
+                    0, 0, 0, num_elements, status);
+        if (apodisation)
+            oskar_mem_multiply(weights, weights, apodisation,
+                    0, 0, 0, num_elements, status);
+    }
+    oskar_mem_free(temp_errors, status);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/private_station.h"
+#include "telescope/station/oskar_station.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t oskar_station_memory_size(const oskar_Station* model)
+{
+    int i, feed, dim;
+    size_t bytes = 0;
+    if (!model) return 0;
+    bytes += sizeof(oskar_Station);
+
+    /* Element data. */
+    for (feed = 0; feed < 2; feed++)
+    {
+        for (dim = 0; dim < 3; dim++)
+        {
+            bytes += oskar_mem_size_bytes(
+                    model->element_true_enu_metres[feed][dim]);
+            bytes += oskar_mem_size_bytes(
+                    model->element_measured_enu_metres[feed][dim]);
+            bytes += oskar_mem_size_bytes(model->element_euler_cpu[feed][dim]);
+        }
+        bytes += oskar_mem_size_bytes(model->element_weight[feed]);
+        bytes += oskar_mem_size_bytes(model->element_cable_length_error[feed]);
+        bytes += oskar_mem_size_bytes(model->element_gain[feed]);
+        bytes += oskar_mem_size_bytes(model->element_gain_error[feed]);
+        bytes += oskar_mem_size_bytes(model->element_phase_offset_rad[feed]);
+        bytes += oskar_mem_size_bytes(model->element_phase_error_rad[feed]);
+    }
+    bytes += oskar_mem_size_bytes(model->element_types);
+    bytes += oskar_mem_size_bytes(model->element_types_cpu);
+    bytes += oskar_mem_size_bytes(model->element_mount_types_cpu);
+    bytes += oskar_mem_size_bytes(model->permitted_beam_az_rad);
+    bytes += oskar_mem_size_bytes(model->permitted_beam_el_rad);
+    bytes += oskar_mem_size_bytes(model->noise_freq_hz);
+    bytes += oskar_mem_size_bytes(model->noise_rms_jy);
+
+    /* Element pattern data. */
+    if (oskar_station_has_element(model))
+    {
+        for (i = 0; i < model->num_element_types; ++i)
+            bytes += oskar_element_memory_size(
+                    oskar_station_element_const(model, i));
+    }
+
+    /* Child stations. */
+    if (oskar_station_has_child(model))
+    {
+        for (i = 0; i < model->num_elements; ++i)
+            bytes += oskar_station_memory_size(
+                    oskar_station_child_const(model, i));
+    }
+    return bytes;
+}
+
+#ifdef __cplusplus
+}
+#endif
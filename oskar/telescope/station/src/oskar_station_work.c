@@ -40,12 +40,17 @@ oskar_StationWork* oskar_station_work_create(int type,
         work->lmn[i] = oskar_mem_create(type, location, 0, status);
         work->temp_dir_in[i] = oskar_mem_create(type, OSKAR_CPU, 1, status);
         work->temp_dir_out[i] = oskar_mem_create(type, OSKAR_CPU, 1, status);
+        work->beam_grid_dir[i] = oskar_mem_create(type, OSKAR_CPU, 0, status);
     }
     work->tec_screen = oskar_mem_create(type, location, 0, status);
     work->tec_screen_path = oskar_mem_create(OSKAR_CHAR, OSKAR_CPU, 0, status);
     work->screen_output = oskar_mem_create(complex_type, location, 0, status);
     work->screen_type = 'N'; /* None */
     work->previous_time_index = -1;
+    work->element_cache_max_bytes = (size_t) 256 * 1024 * 1024;
+    work->element_cache_time_index = -1;
+    work->tile_beam_max_bytes = (size_t) 256 * 1024 * 1024;
+    work->element_errors_max_bytes = (size_t) 64 * 1024 * 1024;
     return work;
 }
 
@@ -61,15 +66,38 @@ void oskar_station_work_free(oskar_StationWork* work, int* status)
     oskar_mem_free(work->phi_x, status);
     oskar_mem_free(work->phi_y, status);
     oskar_mem_free(work->beam_out_scratch, status);
+    oskar_mem_free(work->visible_beam, status);
     oskar_mem_free(work->tec_screen, status);
     oskar_mem_free(work->tec_screen_path, status);
     oskar_mem_free(work->screen_output, status);
+    oskar_mem_free(work->beam_grid_scratch, status);
+    for (i = 0; i < work->num_beam_grids; ++i)
+        oskar_mem_free(work->beam_grid[i].data, status);
+    free(work->beam_grid);
+    for (i = 0; i < work->num_element_cache_entries; ++i)
+        oskar_mem_free(work->element_cache_entries[i].data, status);
+    for (i = 0; i < work->num_element_cache_dirs; ++i)
+    {
+        oskar_mem_free(work->element_cache_dirs[i].dir[0], status);
+        oskar_mem_free(work->element_cache_dirs[i].dir[1], status);
+        oskar_mem_free(work->element_cache_dirs[i].dir[2], status);
+    }
+    free(work->element_cache_entries);
+    free(work->element_cache_dirs);
+    for (i = 0; i < work->num_tile_beams; ++i)
+        oskar_mem_free(work->tile_beams[i].data, status);
+    free(work->tile_beams);
+    for (i = 0; i < work->num_element_errors; ++i)
+        oskar_mem_free(work->element_errors[i].data, status);
+    free(work->element_errors);
     for (i = 0; i < 3; ++i)
     {
         oskar_mem_free(work->enu[i], status);
         oskar_mem_free(work->lmn[i], status);
         oskar_mem_free(work->temp_dir_in[i], status);
         oskar_mem_free(work->temp_dir_out[i], status);
+        oskar_mem_free(work->beam_grid_dir[i], status);
+        oskar_mem_free(work->visible_dir[i], status);
     }
     for (i = 0; i < work->num_depths; ++i)
         oskar_mem_free(work->beam[i], status);
@@ -119,6 +147,21 @@ void oskar_station_work_set_tec_screen_path(oskar_StationWork* work,
     memcpy(oskar_mem_void(work->tec_screen_path), path, len);
 }
 
+void oskar_station_work_set_beam_interpolation(oskar_StationWork* work,
+        int samples_per_beam_width, double max_cache_size_mb)
+{
+    work->beam_grid_samples = samples_per_beam_width;
+    work->beam_grid_max_bytes = (size_t) (max_cache_size_mb * 1024 * 1024);
+}
+
+void oskar_station_work_set_element_cache_size(oskar_StationWork* work,
+        double max_size_mb)
+{
+    work->element_cache_max_bytes = (size_t) (max_size_mb * 1024 * 1024);
+    work->element_cache_time_index = -1;
+    work->element_cache_off = 0;
+}
+
 /* FIXME(FD) Pass in a time coordinate here so we use the correct screen. */
 const oskar_Mem* oskar_station_work_evaluate_tec_screen(oskar_StationWork* work,
         int num_points, const oskar_Mem* l, const oskar_Mem* m,
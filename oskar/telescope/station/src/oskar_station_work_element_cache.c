@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/oskar_station_work.h"
+#include "telescope/station/private_station_work.h"
+#include "telescope/station/element/private_element.h"
+#include "math/oskar_find_closest_match.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static size_t mem_bytes(const oskar_Mem* mem)
+{
+    return mem ? oskar_mem_length(mem) *
+            oskar_mem_element_size(oskar_mem_type(mem)) : 0;
+}
+
+
+static void free_entry(oskar_StationWork* work, oskar_ElementCacheEntry* e,
+        int* status)
+{
+    work->element_cache_bytes -= mem_bytes(e->data);
+    oskar_mem_free(e->data, status);
+    e->data = 0;
+    e->element = 0;
+}
+
+
+static void free_dirs(oskar_StationWork* work, int index, int* status)
+{
+    int i;
+    oskar_ElementCacheDirs* d = &work->element_cache_dirs[index];
+    for (i = 0; i < work->num_element_cache_entries; ++i)
+    {
+        oskar_ElementCacheEntry* e = &work->element_cache_entries[i];
+        if (e->element && e->dir_id == d->id) free_entry(work, e, status);
+    }
+    for (i = 0; i < 3; ++i)
+    {
+        work->element_cache_bytes -= mem_bytes(d->dir[i]);
+        oskar_mem_free(d->dir[i], status);
+    }
+    work->element_cache_dirs[index] =
+            work->element_cache_dirs[--work->num_element_cache_dirs];
+}
+
+
+/* Frees direction sets from other time indices, and their element
+ * responses, until the required space is available.
+ * Data for the current time index are never discarded, to avoid cycling
+ * through the cache when it is too small for all stations. */
+static int make_space(oskar_StationWork* work, size_t num_bytes,
+        int time_index, int* status)
+{
+    if (num_bytes > work->element_cache_max_bytes) return 0;
+    while (work->element_cache_bytes + num_bytes >
+            work->element_cache_max_bytes)
+    {
+        int i, oldest = -1;
+        for (i = 0; i < work->num_element_cache_dirs; ++i)
+        {
+            const oskar_ElementCacheDirs* d = &work->element_cache_dirs[i];
+            if (d->time_index == time_index) continue;
+            if (oldest < 0 || d->last_used <
+                    work->element_cache_dirs[oldest].last_used)
+                oldest = i;
+        }
+        if (oldest < 0) return 0;
+        free_dirs(work, oldest, status);
+    }
+    return 1;
+}
+
+
+static int dirs_equal(const oskar_ElementCacheDirs* d, int offset_points,
+        int num_points, const oskar_Mem* const dir[3])
+{
+    int i;
+    for (i = 0; i < 3; ++i)
+    {
+        const size_t size = oskar_mem_element_size(oskar_mem_type(dir[i]));
+        if (oskar_mem_type(d->dir[i]) != oskar_mem_type(dir[i]) ||
+                (int) oskar_mem_length(d->dir[i]) != num_points)
+            return 0;
+        if (memcmp(oskar_mem_void_const(d->dir[i]),
+                (const char*) oskar_mem_void_const(dir[i]) +
+                size * offset_points, size * num_points))
+            return 0;
+    }
+    return 1;
+}
+
+
+/* Returns the index of the element data to use, or -1 if the element
+ * response depends on the frequency in any other way. */
+static int cacheable_freq_index(const oskar_Element* model, int is_matrix,
+        double frequency_hz)
+{
+    if (model->num_freq == 0) return -1;
+    const int id = oskar_find_closest_match_d(frequency_hz,
+            model->num_freq, model->freqs_hz);
+    const int dipole = model->element_type == OSKAR_ELEMENT_TYPE_DIPOLE;
+    if (oskar_element_has_tabulated_data(model, id))
+    {
+        const int has_x = model->tab_x[id].data != 0;
+        const int has_y = model->tab_y[id].data != 0;
+        if (is_matrix && (has_x || has_y) &&
+                (has_x || !dipole) && (has_y || !dipole))
+            return id;
+        if (!is_matrix && model->tab_scalar[id].data)
+            return id;
+    }
+    if (is_matrix)
+    {
+        const int has_x = oskar_element_has_x_spline_data(model, id);
+        const int has_y = oskar_element_has_y_spline_data(model, id);
+        if (oskar_element_has_spherical_wave_data(model, id))
+            return id;
+        if ((has_x || has_y) && (has_x || !dipole) && (has_y || !dipole))
+            return id;
+    }
+    else if (oskar_element_has_scalar_spline_data(model, id))
+        return id;
+    return -1;
+}
+
+
+int oskar_station_work_element_directions(oskar_StationWork* work,
+        int time_index, int offset_points, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        int* status)
+{
+    int i;
+    const oskar_Mem* const dir[] = {x, y, z};
+    if (*status || work->element_cache_max_bytes == 0 || num_points <= 0 ||
+            oskar_mem_location(x) != OSKAR_CPU)
+        return -1;
+
+    /* Responses can only be reused for the same directions, so the cache
+     * helps only if a station is evaluated more than once for the same
+     * sources (for example, at several frequencies, or for several tiles).
+     * If no response was reused at the last time index, stop using it. */
+    if (time_index != work->element_cache_time_index)
+    {
+        if (work->element_cache_time_index >= 0 &&
+                work->element_cache_hits == 0 && !work->element_cache_off)
+        {
+            work->element_cache_off = 1;
+            while (work->num_element_cache_dirs > 0)
+                free_dirs(work, 0, status);
+        }
+        work->element_cache_time_index = time_index;
+        work->element_cache_hits = 0;
+    }
+    if (work->element_cache_off) return -1;
+
+    /* Return the ID of a matching direction set, if there is one. */
+    for (i = 0; i < work->num_element_cache_dirs; ++i)
+    {
+        oskar_ElementCacheDirs* d = &work->element_cache_dirs[i];
+        if (dirs_equal(d, offset_points, num_points, dir))
+        {
+            d->time_index = time_index;
+            d->last_used = ++work->element_cache_counter;
+            return d->id;
+        }
+    }
+
+    /* Otherwise, store a copy of the directions. */
+    const size_t num_bytes = 3 * (size_t) num_points *
+            oskar_mem_element_size(oskar_mem_type(x));
+    if (!make_space(work, num_bytes, time_index, status)) return -1;
+    work->element_cache_dirs = (oskar_ElementCacheDirs*) realloc(
+            work->element_cache_dirs, (work->num_element_cache_dirs + 1) *
+            sizeof(oskar_ElementCacheDirs));
+    oskar_ElementCacheDirs* d =
+            &work->element_cache_dirs[work->num_element_cache_dirs++];
+    d->id = work->element_cache_next_id++;
+    d->time_index = time_index;
+    d->last_used = ++work->element_cache_counter;
+    for (i = 0; i < 3; ++i)
+    {
+        d->dir[i] = oskar_mem_create(oskar_mem_type(dir[i]), OSKAR_CPU,
+                (size_t) num_points, status);
+        oskar_mem_copy_contents(d->dir[i], dir[i], 0, (size_t) offset_points,
+                (size_t) num_points, status);
+    }
+    work->element_cache_bytes += num_bytes;
+    return d->id;
+}
+
+
+void oskar_station_work_evaluate_element(oskar_StationWork* work,
+        int dir_id, const oskar_Element* model, int normalise, int swap_xy,
+        double orientation_x, double orientation_y, int offset_points,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, double frequency_hz, oskar_Mem* theta,
+        oskar_Mem* phi_x, oskar_Mem* phi_y, int offset_out,
+        oskar_Mem* output, int* status)
+{
+    int i, found = 0, time_index = -1, slot = -1;
+    if (*status) return;
+    const int id = (dir_id < 0 || oskar_mem_location(output) != OSKAR_CPU) ?
+            -1 : cacheable_freq_index(model,
+                    oskar_mem_is_matrix(output), frequency_hz);
+    if (id >= 0)
+    {
+        /* Return a copy of the cached response if there is one. */
+        for (i = 0; i < work->num_element_cache_entries; ++i)
+        {
+            oskar_ElementCacheEntry* e = &work->element_cache_entries[i];
+            if (!e->element)
+            {
+                if (slot < 0) slot = i;
+                continue;
+            }
+            if (e->element == (const void*) model && e->dir_id == dir_id &&
+                    e->freq_index == id && e->freq_hz == model->freqs_hz[id] &&
+                    e->normalise == normalise && e->swap_xy == swap_xy &&
+                    e->orientation_x == orientation_x &&
+                    e->orientation_y == orientation_y &&
+                    oskar_mem_type(e->data) == oskar_mem_type(output))
+            {
+                oskar_mem_ensure(output, (size_t) (offset_out + num_points),
+                        status);
+                oskar_mem_copy_contents(output, e->data, (size_t) offset_out,
+                        0, (size_t) num_points, status);
+                work->element_cache_hits++;
+                return;
+            }
+        }
+        for (i = 0; i < work->num_element_cache_dirs; ++i)
+        {
+            if (work->element_cache_dirs[i].id == dir_id)
+            {
+                time_index = work->element_cache_dirs[i].time_index;
+                found = 1;
+            }
+        }
+    }
+
+    /* Evaluate the element response. */
+    oskar_element_evaluate(model, normalise, swap_xy,
+            orientation_x, orientation_y, offset_points, num_points,
+            x, y, z, frequency_hz, theta, phi_x, phi_y,
+            offset_out, output, status);
+    if (!found || *status) return;
+
+    /* Store a copy of it, if there is space. */
+    const size_t num_bytes = (size_t) num_points *
+            oskar_mem_element_size(oskar_mem_type(output));
+    if (!make_space(work, num_bytes, time_index, status)) return;
+    if (slot < 0 || slot >= work->num_element_cache_entries ||
+            work->element_cache_entries[slot].element)
+    {
+        slot = work->num_element_cache_entries++;
+        work->element_cache_entries = (oskar_ElementCacheEntry*) realloc(
+                work->element_cache_entries, work->num_element_cache_entries *
+                sizeof(oskar_ElementCacheEntry));
+    }
+    oskar_ElementCacheEntry* e = &work->element_cache_entries[slot];
+    e->element = model;
+    e->dir_id = dir_id;
+    e->freq_index = id;
+    e->freq_hz = model->freqs_hz[id];
+    e->normalise = normalise;
+    e->swap_xy = swap_xy;
+    e->orientation_x = orientation_x;
+    e->orientation_y = orientation_y;
+    e->data = oskar_mem_create(oskar_mem_type(output), OSKAR_CPU,
+            (size_t) num_points, status);
+    oskar_mem_copy_contents(e->data, output, 0, (size_t) offset_out,
+            (size_t) num_points, status);
+    work->element_cache_bytes += num_bytes;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/oskar_station.h"
+#include "telescope/station/oskar_station_work.h"
+#include "telescope/station/oskar_evaluate_element_weights_errors.h"
+#include "telescope/station/private_station_work.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns the feed index with the same error parameters, if any,
+ * so that the errors are only generated once for both feeds. */
+static int error_feed(const oskar_Station* station, int feed)
+{
+    if (feed > 0 &&
+            oskar_station_element_gain_const(station, feed) ==
+            oskar_station_element_gain_const(station, 0) &&
+            oskar_station_element_gain_error_const(station, feed) ==
+            oskar_station_element_gain_error_const(station, 0) &&
+            oskar_station_element_phase_offset_rad_const(station, feed) ==
+            oskar_station_element_phase_offset_rad_const(station, 0) &&
+            oskar_station_element_phase_error_rad_const(station, feed) ==
+            oskar_station_element_phase_error_rad_const(station, 0))
+        return 0;
+    return feed;
+}
+
+
+static void evaluate_errors(const oskar_Station* station, int feed,
+        int time_index, int num_elements, oskar_Mem* errors, int* status)
+{
+    oskar_evaluate_element_weights_errors(num_elements,
+            oskar_station_element_gain_const(station, feed),
+            oskar_station_element_gain_error_const(station, feed),
+            oskar_station_element_phase_offset_rad_const(station, feed),
+            oskar_station_element_phase_error_rad_const(station, feed),
+            oskar_station_seed_time_variable_errors(station), time_index,
+            oskar_station_unique_id(station), errors, status);
+}
+
+
+const oskar_Mem* oskar_station_work_element_errors(oskar_StationWork* work,
+        const oskar_Station* station, int feed, int time_index, int* status)
+{
+    int i, slot = -1;
+    if (*status) return 0;
+    const int num_elements = oskar_station_num_elements(station);
+    const int type = oskar_station_precision(station) | OSKAR_COMPLEX;
+    const int location = oskar_station_mem_location(station);
+    const int station_id = oskar_station_unique_id(station);
+    const unsigned int seed = oskar_station_seed_time_variable_errors(station);
+    const size_t num_bytes = (size_t) num_elements *
+            oskar_mem_element_size(type);
+    feed = error_feed(station, feed);
+
+    /* Return the errors if they have already been generated. */
+    for (i = 0; i < work->num_element_errors; ++i)
+    {
+        const oskar_ElementErrorsCacheEntry* e = &work->element_errors[i];
+        if (e->station == (const void*) station &&
+                e->station_id == station_id && e->feed == feed &&
+                e->time_index == time_index && e->seed == seed &&
+                oskar_mem_type(e->data) == type &&
+                oskar_mem_location(e->data) == location &&
+                oskar_mem_length(e->data) == (size_t) num_elements)
+            return e->data;
+    }
+
+    /* Replace the errors for another time index, if possible. */
+    for (i = 0; i < work->num_element_errors; ++i)
+    {
+        const oskar_ElementErrorsCacheEntry* e = &work->element_errors[i];
+        if (e->time_index != time_index || !e->station)
+        {
+            const size_t old_bytes = oskar_mem_length(e->data) *
+                    oskar_mem_element_size(oskar_mem_type(e->data));
+            if (oskar_mem_type(e->data) != type ||
+                    oskar_mem_location(e->data) != location ||
+                    work->element_errors_bytes - old_bytes + num_bytes >
+                    work->element_errors_max_bytes)
+                continue;
+            work->element_errors_bytes += num_bytes;
+            work->element_errors_bytes -= old_bytes;
+            oskar_mem_realloc(work->element_errors[i].data,
+                    (size_t) num_elements, status);
+            slot = i;
+            break;
+        }
+    }
+
+    /* Otherwise, add a new entry if there is space for it. */
+    if (slot < 0 && work->element_errors_bytes + num_bytes <=
+            work->element_errors_max_bytes)
+    {
+        oskar_ElementErrorsCacheEntry* t = (oskar_ElementErrorsCacheEntry*)
+                realloc(work->element_errors, (work->num_element_errors + 1) *
+                sizeof(oskar_ElementErrorsCacheEntry));
+        if (!t)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return 0;
+        }
+        work->element_errors = t;
+        slot = work->num_element_errors++;
+        work->element_errors[slot].data = oskar_mem_create(type, location,
+                (size_t) num_elements, status);
+        work->element_errors_bytes += num_bytes;
+    }
+
+    /* If there is no space, use the scratch array instead. */
+    if (slot < 0)
+    {
+        oskar_mem_ensure(work->weights_scratch, (size_t) num_elements, status);
+        evaluate_errors(station, feed, time_index, num_elements,
+                work->weights_scratch, status);
+        return work->weights_scratch;
+    }
+    oskar_ElementErrorsCacheEntry* e = &work->element_errors[slot];
+    evaluate_errors(station, feed, time_index, num_elements, e->data, status);
+    e->station = *status ? 0 : station;
+    e->station_id = station_id;
+    e->feed = feed;
+    e->time_index = time_index;
+    e->seed = seed;
+    return e->data;
+}
+
+#ifdef __cplusplus
+}
+#endif
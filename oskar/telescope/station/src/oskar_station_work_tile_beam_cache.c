@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "telescope/station/oskar_station_work.h"
+#include "telescope/station/private_station_work.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns a hash of the source direction cosines used for a tile beam.
+ * The directions depend on the parent station, so the same work arrays
+ * hold different values for each station. */
+static unsigned long long hash_dirs(int offset_points, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z)
+{
+    int i;
+    size_t j;
+    unsigned long long hash = 14695981039346656037ULL;
+    const oskar_Mem* const dir[] = {x, y, z};
+    for (i = 0; i < 3; ++i)
+    {
+        const size_t size = oskar_mem_element_size(oskar_mem_type(dir[i]));
+        const unsigned char* p = (const unsigned char*)
+                oskar_mem_void_const(dir[i]) + size * offset_points;
+        for (j = 0; j < size * num_points; ++j)
+        {
+            hash ^= (unsigned long long) p[j];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+
+static int matches(const oskar_StationWork* work,
+        const oskar_TileBeamCacheEntry* e, int tile_class, int time_index,
+        double frequency_hz, int offset_points, int num_points,
+        unsigned long long dir_hash)
+{
+    return e->valid && e->tile_class == tile_class &&
+            e->time_index == time_index && e->frequency_hz == frequency_hz &&
+            e->offset_points == offset_points &&
+            e->num_points == num_points && e->dir_hash == dir_hash &&
+            e->subset == work->tile_beam_subset;
+}
+
+
+void oskar_station_work_set_tile_beam_sharing(oskar_StationWork* work,
+        int enable)
+{
+    int i;
+    work->tile_beam_sharing = enable;
+    for (i = 0; i < work->num_tile_beams; ++i)
+        work->tile_beams[i].valid = 0;
+}
+
+
+int oskar_station_work_copy_tile_beam(oskar_StationWork* work,
+        int tile_class, int time_index, double frequency_hz,
+        int offset_points, int num_points, const oskar_Mem* x,
+        const oskar_Mem* y, const oskar_Mem* z, int offset_out,
+        oskar_Mem* output, int* status)
+{
+    int i;
+    if (*status || !work->tile_beam_sharing || tile_class <= 0 ||
+            oskar_mem_location(output) != OSKAR_CPU ||
+            oskar_mem_location(x) != OSKAR_CPU)
+        return 0;
+    const unsigned long long dir_hash = hash_dirs(offset_points, num_points,
+            x, y, z);
+    for (i = 0; i < work->num_tile_beams; ++i)
+    {
+        const oskar_TileBeamCacheEntry* e = &work->tile_beams[i];
+        if (!matches(work, e, tile_class, time_index, frequency_hz,
+                offset_points, num_points, dir_hash) ||
+                oskar_mem_type(e->data) != oskar_mem_type(output))
+            continue;
+        oskar_mem_copy_contents(output, e->data, (size_t) offset_out, 0,
+                (size_t) num_points, status);
+        return 1;
+    }
+    return 0;
+}
+
+
+void oskar_station_work_store_tile_beam(oskar_StationWork* work,
+        int tile_class, int time_index, double frequency_hz,
+        int offset_points, int num_points, const oskar_Mem* x,
+        const oskar_Mem* y, const oskar_Mem* z, int offset_in,
+        const oskar_Mem* beam, int* status)
+{
+    int i, slot = -1;
+    if (*status || !work->tile_beam_sharing || tile_class <= 0 ||
+            oskar_mem_location(beam) != OSKAR_CPU ||
+            oskar_mem_location(x) != OSKAR_CPU)
+        return;
+    const int type = oskar_mem_type(beam);
+    const size_t num_bytes = (size_t) num_points *
+            oskar_mem_element_size(type);
+
+    /* Use the memory of an entry that is no longer valid, if possible. */
+    for (i = 0; i < work->num_tile_beams; ++i)
+    {
+        const oskar_TileBeamCacheEntry* e = &work->tile_beams[i];
+        if (e->valid || oskar_mem_type(e->data) != type) continue;
+        if (slot < 0 || oskar_mem_length(e->data) >= (size_t) num_points)
+            slot = i;
+        if (oskar_mem_length(e->data) >= (size_t) num_points) break;
+    }
+    if (slot >= 0)
+    {
+        oskar_TileBeamCacheEntry* e = &work->tile_beams[slot];
+        const size_t old_bytes = oskar_mem_length(e->data) *
+                oskar_mem_element_size(type);
+        if (old_bytes < num_bytes)
+        {
+            if (work->tile_beam_bytes - old_bytes + num_bytes >
+                    work->tile_beam_max_bytes)
+                return;
+            work->tile_beam_bytes += num_bytes - old_bytes;
+            oskar_mem_ensure(e->data, (size_t) num_points, status);
+        }
+    }
+    else
+    {
+        if (work->tile_beam_bytes + num_bytes > work->tile_beam_max_bytes)
+            return;
+        oskar_TileBeamCacheEntry* t = (oskar_TileBeamCacheEntry*) realloc(
+                work->tile_beams, (work->num_tile_beams + 1) *
+                sizeof(oskar_TileBeamCacheEntry));
+        if (!t)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return;
+        }
+        work->tile_beams = t;
+        slot = work->num_tile_beams++;
+        work->tile_beams[slot].data = oskar_mem_create(type, OSKAR_CPU,
+                (size_t) num_points, status);
+        work->tile_beam_bytes += num_bytes;
+    }
+    oskar_TileBeamCacheEntry* e = &work->tile_beams[slot];
+    e->valid = 1;
+    e->tile_class = tile_class;
+    e->time_index = time_index;
+    e->offset_points = offset_points;
+    e->num_points = num_points;
+    e->dir_hash = hash_dirs(offset_points, num_points, x, y, z);
+    e->subset = work->tile_beam_subset;
+    e->frequency_hz = frequency_hz;
+    oskar_mem_copy_contents(e->data, beam, 0, (size_t) offset_in,
+            (size_t) num_points, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "telescope/station/element/oskar_element.h"
+#include "utility/oskar_get_error_string.h"
+#include "math/oskar_cmath.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+static void generate_directions(int num_points, oskar_Mem* x, oskar_Mem* y,
+        oskar_Mem* z, int* status)
+{
+    double* x_ = oskar_mem_double(x, status);
+    double* y_ = oskar_mem_double(y, status);
+    double* z_ = oskar_mem_double(z, status);
+    srand(2);
+    for (int i = 0; i < num_points; ++i)
+    {
+        // Points over the whole sphere, including both poles.
+        const double phi = 2.0 * M_PI * rand() / (double) RAND_MAX;
+        const double cos_theta = (i < 2) ? 1.0 - 2.0 * i :
+                2.0 * rand() / (double) RAND_MAX - 1.0;
+        const double sin_theta = sqrt(1.0 - cos_theta * cos_theta);
+        x_[i] = sin_theta * cos(phi);
+        y_[i] = sin_theta * sin(phi);
+        z_[i] = cos_theta;
+    }
+}
+
+// Returns the maximum difference between two arrays, relative to the
+// largest value in the first one.
+static double max_rel_diff(const oskar_Mem* a, const oskar_Mem* b,
+        int* status)
+{
+    double max_diff = 0.0, max_val = 0.0;
+    const size_t n = oskar_mem_length(a) * 8;
+    const double* a_ = (const double*) oskar_mem_void_const(a);
+    const double* b_ = (const double*) oskar_mem_void_const(b);
+    if (*status || oskar_mem_length(b) * 8 != n) return 1.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (fabs(a_[i]) > max_val) max_val = fabs(a_[i]);
+        if (fabs(a_[i] - b_[i]) > max_diff) max_diff = fabs(a_[i] - b_[i]);
+    }
+    return max_diff / max_val;
+}
+
+static void evaluate(const oskar_Element* element, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double freq_hz, oskar_Mem* output, int* status)
+{
+    oskar_Mem *theta, *phi_x, *phi_y;
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    phi_x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    phi_y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    oskar_element_evaluate(element, 0, 0, M_PI / 2.0, 0.0, 0, num_points,
+            x, y, z, freq_hz, theta, phi_x, phi_y, 0, output, status);
+    oskar_mem_free(theta, status);
+    oskar_mem_free(phi_x, status);
+    oskar_mem_free(phi_y, status);
+}
+
+TEST(element, tabulate_cst)
+{
+    int status = 0;
+    const int num_points = 20000;
+    const double freq_hz = 100e6, tolerance = 1e-3;
+    const char* filename = "temp_test_element_tabulate_cst.txt";
+    const char* filename_x = "temp_test_element_tabulate_x.bin";
+    const char* filename_y = "temp_test_element_tabulate_y.bin";
+
+    // Write a CST file covering the whole sphere.
+    FILE* file = fopen(filename, "w");
+    ASSERT_TRUE(file != NULL);
+    fprintf(file, "Theta [deg.]  Phi [deg.]  Abs(Dir.)[]  Abs(Theta)[]  "
+            "Phase(Theta)[deg.]  Abs(Phi)[]  Phase(Phi)[deg.]  "
+            "Ax.Ratio[]\n");
+    for (int t = 0; t <= 180; t += 10)
+    {
+        for (int p = 0; p < 360; p += 10)
+        {
+            const double theta = t * M_PI / 180.0, phi = p * M_PI / 180.0;
+            const double e_theta = cos(theta) * cos(phi) + 0.5;
+            const double e_phi = -sin(phi) + 0.2 * cos(theta);
+            fprintf(file, "%d %d 0 %.10f %d %.10f %d 0\n", t, p,
+                    fabs(e_theta), e_theta < 0.0 ? 180 : 0,
+                    fabs(e_phi), e_phi < 0.0 ? 180 : 0);
+        }
+    }
+    fclose(file);
+    oskar_Element* element = oskar_element_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_element_load_cst(element, 0, freq_hz, filename, 0.01, 1.5,
+            0, 0, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_FALSE(oskar_element_has_tabulated_data(element, 0));
+
+    // Evaluate the fitted surfaces directly.
+    oskar_Mem *x, *y, *z, *ref, *out, *out2;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    ref = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    out = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    out2 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    generate_directions(num_points, x, y, z, &status);
+    evaluate(element, num_points, x, y, z, freq_hz, ref, &status);
+
+    // Check the tabulated response is close to the fitted one.
+    oskar_element_tabulate(element, tolerance, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_TRUE(oskar_element_has_tabulated_data(element, 0));
+    evaluate(element, num_points, x, y, z, freq_hz, out, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_LT(max_rel_diff(ref, out, &status), 2.0 * tolerance);
+
+    // Check the tables are written and read back.
+    oskar_element_write(element, filename_x, 1, freq_hz, 0, &status);
+    oskar_element_write(element, filename_y, 2, freq_hz, 0, &status);
+    oskar_Element* element2 = oskar_element_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_element_read(element2, filename_x, 1, freq_hz, &status);
+    oskar_element_read(element2, filename_y, 2, freq_hz, &status);
+    remove(filename_x);
+    remove(filename_y);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_TRUE(oskar_element_has_tabulated_data(element2, 0));
+    evaluate(element2, num_points, x, y, z, freq_hz, out2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0.0, max_rel_diff(out, out2, &status));
+
+    // Check that copied tables give the same response.
+    oskar_Element* element3 = oskar_element_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_element_copy(element3, element, &status);
+    evaluate(element3, num_points, x, y, z, freq_hz, out2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0.0, max_rel_diff(out, out2, &status));
+    oskar_element_free(element3, &status);
+
+    // Check that shared tables give the same response without a copy.
+    element3 = oskar_element_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    oskar_element_load_cst(element3, 0, freq_hz, filename, 0.01, 1.5,
+            0, 0, 0, &status);
+    remove(filename);
+    oskar_element_share_tabulated_data(element3, element, &status);
+    ASSERT_TRUE(oskar_element_has_tabulated_data(element3, 0));
+    evaluate(element3, num_points, x, y, z, freq_hz, out2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0.0, max_rel_diff(out, out2, &status));
+    EXPECT_LT(oskar_element_memory_size(element3),
+            oskar_element_memory_size(element));
+
+    oskar_element_free(element, &status);
+    oskar_element_free(element2, &status);
+    oskar_element_free(element3, &status);
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(ref, &status);
+    oskar_mem_free(out, &status);
+    oskar_mem_free(out2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
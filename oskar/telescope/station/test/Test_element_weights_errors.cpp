@@ -29,6 +29,8 @@
 #include <gtest/gtest.h>
 
 #include "telescope/station/oskar_evaluate_element_weights_errors.h"
+#include "telescope/station/oskar_station.h"
+#include "telescope/station/oskar_station_evaluate_element_weights.h"
 #include "utility/oskar_get_error_string.h"
 #include "mem/oskar_mem.h"
 
@@ -258,3 +260,104 @@ TEST(element_weights_errors, test_reinit)
     oskar_mem_free(d_phase_error, &status);
     oskar_mem_free(d_errors, &status);
 }
+
+
+TEST(element_weights_errors, cached_weights)
+{
+    int status = 0, finished = 0, counter = 7;
+    const int num_elements = 101;
+    const double wavenumber = 2.0 * M_PI * 100e6 / 299792458.0;
+    const double beam[] = {0.1, -0.2, sqrt(1.0 - 0.05)};
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_elements, &status);
+    srand(3);
+    for (int i = 0; i < num_elements; ++i)
+    {
+        const double enu[] = {
+                20.0 * rand() / (double) RAND_MAX - 10.0,
+                20.0 * rand() / (double) RAND_MAX - 10.0, 0.0};
+        oskar_station_set_element_coords(station, 0, i, enu, enu, &status);
+        oskar_station_set_element_errors(station, 0, i,
+                1.0 + 0.1 * i / num_elements, 0.1, 0.01 * i, 2.0, &status);
+        oskar_station_set_element_weight(station, 0, i,
+                0.5 + 0.5 * i / num_elements, 0.1, &status);
+    }
+    oskar_station_set_seed_time_variable_errors(station, 5);
+    oskar_station_set_unique_ids(station, &counter);
+    oskar_station_analyse(station, &finished, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_TRUE(oskar_station_apply_element_errors(station));
+    ASSERT_TRUE(oskar_station_apply_element_weight(station));
+
+    // Evaluate the reference weights from separate random numbers.
+    oskar_Mem* random = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_elements, &status);
+    oskar_mem_random_gaussian(random, 5, 2, 7, 0x12345678, 1.0, &status);
+    const double* x = oskar_mem_double_const(
+            oskar_station_element_measured_enu_metres_const(station, 0, 0),
+            &status);
+    const double* y = oskar_mem_double_const(
+            oskar_station_element_measured_enu_metres_const(station, 0, 1),
+            &status);
+    const double* g = oskar_mem_double_const(
+            oskar_station_element_gain_const(station, 0), &status);
+    const double* g_err = oskar_mem_double_const(
+            oskar_station_element_gain_error_const(station, 0), &status);
+    const double* p = oskar_mem_double_const(
+            oskar_station_element_phase_offset_rad_const(station, 0), &status);
+    const double* p_err = oskar_mem_double_const(
+            oskar_station_element_phase_error_rad_const(station, 0), &status);
+    const double2* apod = oskar_mem_double2_const(
+            oskar_station_element_weight_const(station, 0), &status);
+    const double2* r = oskar_mem_double2_const(random, &status);
+
+    // Evaluate the weights with and without a work structure.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_Mem* w1 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            0, &status);
+    oskar_Mem* w2 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            0, &status);
+    oskar_station_evaluate_element_weights(station, 0, wavenumber,
+            beam[0], beam[1], beam[2], 2, w1, 0, &status);
+    oskar_station_evaluate_element_weights(station, 0, wavenumber,
+            beam[0], beam[1], beam[2], 2, w2, work, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double2* w1_ = oskar_mem_double2_const(w1, &status);
+    const double2* w2_ = oskar_mem_double2_const(w2, &status);
+    for (int i = 0; i < num_elements; ++i)
+    {
+        const double amp = r[i].x * g_err[i] + g[i];
+        const double phase = r[i].y * p_err[i] + p[i];
+        const double arg = -wavenumber * (x[i] * beam[0] + y[i] * beam[1]);
+        const double e_re = amp * cos(phase), e_im = amp * sin(phase);
+        const double t_re = cos(arg) * e_re - sin(arg) * e_im;
+        const double t_im = cos(arg) * e_im + sin(arg) * e_re;
+        const double w_re = t_re * apod[i].x - t_im * apod[i].y;
+        const double w_im = t_re * apod[i].y + t_im * apod[i].x;
+        EXPECT_NEAR(w_re, w1_[i].x, 1e-12);
+        EXPECT_NEAR(w_im, w1_[i].y, 1e-12);
+        EXPECT_EQ(w1_[i].x, w2_[i].x);
+        EXPECT_EQ(w1_[i].y, w2_[i].y);
+    }
+
+    // Check the errors are kept for the same time, and not for another.
+    const oskar_Mem* e1 = oskar_station_work_element_errors(work, station,
+            0, 2, &status);
+    EXPECT_EQ(e1, oskar_station_work_element_errors(work, station,
+            0, 2, &status));
+    EXPECT_EQ(e1, oskar_station_work_element_errors(work, station,
+            1, 2, &status));
+    const double e1_re = oskar_mem_double2_const(e1, &status)[0].x;
+    const oskar_Mem* e2 = oskar_station_work_element_errors(work, station,
+            0, 3, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_NE(e1_re, oskar_mem_double2_const(e2, &status)[0].x);
+
+    oskar_station_free(station, &status);
+    oskar_station_work_free(work, &status);
+    oskar_mem_free(random, &status);
+    oskar_mem_free(w1, &status);
+    oskar_mem_free(w2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
@@ -11,6 +11,7 @@
 #include "math/oskar_meshgrid.h"
 #include "math/oskar_evaluate_image_lmn_grid.h"
 #include "interferometer/oskar_evaluate_jones_E.h"
+#include "telescope/station/private_station_work.h"
 #include "utility/oskar_timer.h"
 #include "utility/oskar_get_error_string.h"
 
@@ -161,3 +162,249 @@ TEST(evaluate_jones_E, evaluate_e)
     ASSERT_EQ(0, error) << oskar_get_error_string(error);
 }
 
+
+static oskar_Telescope* create_two_layout_telescope(int num_stations,
+        int* status)
+{
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, status);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        // Alternate between two station layouts of different sizes.
+        const int station_dim = 8;
+        const double station_size_m = (i % 2) ? 30.0 : 40.0;
+        oskar_Station* s = oskar_telescope_station(tel, i);
+        oskar_station_resize(s, station_dim * station_dim, status);
+        oskar_station_resize_element_types(s, 1, status);
+        oskar_element_set_element_type(oskar_station_element(s, 0),
+                "Isotropic", status);
+
+        // Stations are 100 metres apart, with a common horizon.
+        oskar_station_set_position(s, 0.0, M_PI / 2.0, 0.0,
+                100.0 * i, 0.0, 0.0);
+        std::vector<double> x_pos(station_dim);
+        oskar_linspace_d(&x_pos[0], -station_size_m / 2.0,
+                station_size_m / 2.0, station_dim);
+        oskar_meshgrid_d(
+                oskar_mem_double(
+                        oskar_station_element_true_enu_metres(s, 0, 0), status),
+                oskar_mem_double(
+                        oskar_station_element_true_enu_metres(s, 0, 1), status),
+                &x_pos[0], station_dim, &x_pos[0], station_dim);
+        oskar_mem_copy(oskar_station_element_measured_enu_metres(s, 0, 0),
+                oskar_station_element_true_enu_metres(s, 0, 0), status);
+        oskar_mem_copy(oskar_station_element_measured_enu_metres(s, 0, 1),
+                oskar_station_element_true_enu_metres(s, 0, 1), status);
+    }
+    oskar_telescope_set_station_ids(tel);
+    oskar_telescope_set_phase_centre(tel, OSKAR_COORDS_RADEC, 0.0, M_PI / 2.0);
+    oskar_telescope_set_allow_station_beam_duplication(tel, OSKAR_TRUE);
+    return tel;
+}
+
+TEST(evaluate_jones_E, station_beam_classes)
+{
+    int status = 0;
+    const int num_stations = 6;
+
+    // Check the classes found for two interleaved station layouts.
+    oskar_Telescope* tel = create_two_layout_telescope(num_stations, &status);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(2, oskar_telescope_num_station_beam_classes(tel));
+    const int* station_class = oskar_mem_int_const(
+            oskar_telescope_station_beam_class_const(tel), &status);
+    for (int i = 0; i < num_stations; ++i)
+        EXPECT_EQ(i % 2, station_class[i]);
+
+    // Evaluate the station beams, with and without duplication.
+    const int num_pts = 500;
+    oskar_Mem* l = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts, &status);
+    oskar_Mem* m = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts, &status);
+    oskar_Mem* n = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts, &status);
+    oskar_mem_random_range(l, -0.5, 0.5, &status);
+    oskar_mem_random_range(m, -0.5, 0.5, &status);
+    double* l_ = oskar_mem_double(l, &status);
+    double* m_ = oskar_mem_double(m, &status);
+    double* n_ = oskar_mem_double(n, &status);
+    for (int i = 0; i < num_pts; ++i)
+        n_[i] = sqrt(1.0 - l_[i] * l_[i] - m_[i] * m_[i]);
+    const oskar_Mem* const source_coords[] = {l, m, n};
+    oskar_Jones* E_dup = oskar_jones_create(OSKAR_DOUBLE_COMPLEX,
+            OSKAR_CPU, num_stations, num_pts, &status);
+    oskar_Jones* E_all = oskar_jones_create(OSKAR_DOUBLE_COMPLEX,
+            OSKAR_CPU, num_stations, num_pts, &status);
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_evaluate_jones_E(E_dup, OSKAR_COORDS_REL_DIR, num_pts,
+            source_coords, 0.0, M_PI / 2.0, tel, 0, 0.0, 100e6, work, &status);
+    oskar_telescope_set_allow_station_beam_duplication(tel, OSKAR_FALSE);
+    oskar_evaluate_jones_E(E_all, OSKAR_COORDS_REL_DIR, num_pts,
+            source_coords, 0.0, M_PI / 2.0, tel, 0, 0.0, 100e6, work, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    double max_rel_error = 0.0, avg_rel_error = 0.0;
+    oskar_mem_evaluate_relative_error(oskar_jones_mem(E_dup),
+            oskar_jones_mem(E_all), 0, &max_rel_error, &avg_rel_error, 0,
+            &status);
+    EXPECT_LT(max_rel_error, 1e-12);
+
+    // Check that the maximum distance limits the size of each class.
+    oskar_telescope_set_allow_station_beam_duplication(tel, OSKAR_TRUE);
+    oskar_telescope_set_station_beam_max_distance(tel, 250.0);
+    oskar_telescope_analyse(tel, &status);
+    EXPECT_EQ(4, oskar_telescope_num_station_beam_classes(tel));
+    station_class = oskar_mem_int_const(
+            oskar_telescope_station_beam_class_const(tel), &status);
+    const int expected[] = {0, 1, 0, 1, 4, 5};
+    for (int i = 0; i < num_stations; ++i)
+        EXPECT_EQ(expected[i], station_class[i]);
+
+    // Check that stations with time-variable errors are not grouped.
+    oskar_telescope_set_station_beam_max_distance(tel, 1e9);
+    oskar_Station* s = oskar_telescope_station(tel, 2);
+    oskar_mem_set_value_real(oskar_station_element_gain_error(s, 0),
+            0.1, 0, oskar_station_num_elements(s), &status);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(3, oskar_telescope_num_station_beam_classes(tel));
+    station_class = oskar_mem_int_const(
+            oskar_telescope_station_beam_class_const(tel), &status);
+    EXPECT_EQ(2, station_class[2]);
+    EXPECT_EQ(0, station_class[4]);
+
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_jones_free(E_dup, &status);
+    oskar_jones_free(E_all, &status);
+    oskar_station_work_free(work, &status);
+    oskar_telescope_free(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+
+static void set_square_layout(oskar_Station* s, int dim, double size_m,
+        int* status)
+{
+    std::vector<double> x_pos(dim);
+    oskar_linspace_d(&x_pos[0], -size_m / 2.0, size_m / 2.0, dim);
+    oskar_meshgrid_d(
+            oskar_mem_double(
+                    oskar_station_element_true_enu_metres(s, 0, 0), status),
+            oskar_mem_double(
+                    oskar_station_element_true_enu_metres(s, 0, 1), status),
+            &x_pos[0], dim, &x_pos[0], dim);
+    oskar_mem_copy(oskar_station_element_measured_enu_metres(s, 0, 0),
+            oskar_station_element_true_enu_metres(s, 0, 0), status);
+    oskar_mem_copy(oskar_station_element_measured_enu_metres(s, 0, 1),
+            oskar_station_element_true_enu_metres(s, 0, 1), status);
+}
+
+TEST(evaluate_jones_E, tile_beam_classes)
+{
+    int status = 0;
+    const int num_stations = 3, tile_dim = 4, station_dim = 3;
+    const int num_tiles = station_dim * station_dim;
+
+    // Construct stations with different tile layouts, which use two types
+    // of tile: the last tile in each station is larger than the others.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, &status);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        oskar_Station* s = oskar_telescope_station(tel, i);
+        oskar_station_resize(s, num_tiles, &status);
+        oskar_station_set_position(s, 0.0, M_PI / 2.0, 0.0,
+                100.0 * i, 0.0, 0.0);
+        set_square_layout(s, station_dim, 10.0 + i, &status);
+        oskar_station_create_child_stations(s, &status);
+        for (int j = 0; j < num_tiles; ++j)
+        {
+            oskar_Station* tile = oskar_station_child(s, j);
+            oskar_station_resize(tile, tile_dim * tile_dim, &status);
+            oskar_station_resize_element_types(tile, 1, &status);
+            oskar_element_set_element_type(oskar_station_element(tile, 0),
+                    "Isotropic", &status);
+            set_square_layout(tile, tile_dim,
+                    (j == num_tiles - 1) ? 4.0 : 3.0, &status);
+        }
+    }
+    oskar_telescope_set_station_ids(tel);
+    oskar_telescope_set_phase_centre(tel, OSKAR_COORDS_RADEC, 0.0, M_PI / 2.0);
+    oskar_telescope_set_allow_station_beam_duplication(tel, OSKAR_TRUE);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(num_stations, oskar_telescope_num_station_beam_classes(tel));
+
+    // Check that tiles of the same type are in the same class everywhere.
+    const oskar_Station* s0 = oskar_telescope_station_const(tel, 0);
+    const int class_a = oskar_station_tile_beam_class(
+            oskar_station_child_const(s0, 0));
+    const int class_b = oskar_station_tile_beam_class(
+            oskar_station_child_const(s0, num_tiles - 1));
+    EXPECT_GT(class_a, 0);
+    EXPECT_GT(class_b, 0);
+    EXPECT_NE(class_a, class_b);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        const oskar_Station* s = oskar_telescope_station_const(tel, i);
+        EXPECT_EQ(0, oskar_station_tile_beam_class(s));
+        for (int j = 0; j < num_tiles; ++j)
+            EXPECT_EQ(j == num_tiles - 1 ? class_b : class_a,
+                    oskar_station_tile_beam_class(
+                            oskar_station_child_const(s, j)));
+    }
+
+    // Evaluate the station beams, with and without shared tile beams.
+    const int num_pts = 500;
+    oskar_Mem* l = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts, &status);
+    oskar_Mem* m = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts, &status);
+    oskar_Mem* n = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_pts, &status);
+    oskar_mem_random_range(l, -0.5, 0.5, &status);
+    oskar_mem_random_range(m, -0.5, 0.5, &status);
+    double* l_ = oskar_mem_double(l, &status);
+    double* m_ = oskar_mem_double(m, &status);
+    double* n_ = oskar_mem_double(n, &status);
+    for (int i = 0; i < num_pts; ++i)
+        n_[i] = sqrt(1.0 - l_[i] * l_[i] - m_[i] * m_[i]);
+    const oskar_Mem* const source_coords[] = {l, m, n};
+    oskar_Jones* E_tile = oskar_jones_create(OSKAR_DOUBLE_COMPLEX,
+            OSKAR_CPU, num_stations, num_pts, &status);
+    oskar_Jones* E_all = oskar_jones_create(OSKAR_DOUBLE_COMPLEX,
+            OSKAR_CPU, num_stations, num_pts, &status);
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_evaluate_jones_E(E_tile, OSKAR_COORDS_REL_DIR, num_pts,
+            source_coords, 0.0, M_PI / 2.0, tel, 0, 0.0, 100e6, work, &status);
+    EXPECT_EQ(2, work->num_tile_beams);
+    EXPECT_EQ(0, work->tile_beam_sharing);
+    oskar_telescope_set_allow_station_beam_duplication(tel, OSKAR_FALSE);
+    oskar_evaluate_jones_E(E_all, OSKAR_COORDS_REL_DIR, num_pts,
+            source_coords, 0.0, M_PI / 2.0, tel, 0, 0.0, 100e6, work, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    double max_rel_error = 0.0, avg_rel_error = 0.0;
+    oskar_mem_evaluate_relative_error(oskar_jones_mem(E_tile),
+            oskar_jones_mem(E_all), 0, &max_rel_error, &avg_rel_error, 0,
+            &status);
+    EXPECT_LT(max_rel_error, 1e-12);
+
+    // Check that tiles in stations with time-variable errors are not shared.
+    oskar_Station* tile = oskar_station_child(
+            oskar_telescope_station(tel, 1), 0);
+    oskar_mem_set_value_real(oskar_station_element_gain_error(tile, 0),
+            0.1, 0, oskar_station_num_elements(tile), &status);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_station_tile_beam_class(tile));
+    EXPECT_EQ(class_a, oskar_station_tile_beam_class(
+            oskar_station_child_const(oskar_telescope_station(tel, 2), 0)));
+
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_jones_free(E_tile, &status);
+    oskar_jones_free(E_all, &status);
+    oskar_station_work_free(work, &status);
+    oskar_telescope_free(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "telescope/station/element/oskar_evaluate_spherical_wave_sum.h"
+#include "telescope/station/element/define_evaluate_spherical_wave.h"
+#include "math/define_legendre_polynomial.h"
+#include "math/define_multiply.h"
+#include "math/oskar_cmath.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_kernel_macros.h"
+#include "utility/oskar_vector_types.h"
+
+#include <cstdlib>
+
+// Per-point version of the sum, used as the reference.
+OSKAR_EVALUATE_SPHERICAL_WAVE_SUM(sph_wave_sum_ref_f, float, float2, float4c)
+OSKAR_EVALUATE_SPHERICAL_WAVE_SUM(sph_wave_sum_ref_d, double, double2, double4c)
+
+static void convert(oskar_Mem** mem, int precision, int* status)
+{
+    oskar_Mem* temp = oskar_mem_convert_precision(*mem, precision, status);
+    oskar_mem_free(*mem, status);
+    *mem = temp;
+}
+
+static void check_sum(int precision, int l_max, double tol)
+{
+    int status = 0;
+    const int num_points = 1003, offset = 5;
+    const int num_coeff = (l_max + 1) * (l_max + 1) - 1;
+    const int type = precision | OSKAR_COMPLEX | OSKAR_MATRIX;
+    oskar_Mem *theta, *phi_x, *phi_y, *alpha, *pattern, *ref;
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    phi_x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    phi_y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    alpha = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_coeff, &status);
+    ref = oskar_mem_create(type, OSKAR_CPU, num_points + offset, &status);
+    oskar_mem_clear_contents(ref, &status);
+    double* t = oskar_mem_double(theta, &status);
+    double* px = oskar_mem_double(phi_x, &status);
+    double* py = oskar_mem_double(phi_y, &status);
+    double* a = oskar_mem_double(alpha, &status);
+    srand(l_max);
+    for (int i = 0; i < num_points; ++i)
+    {
+        t[i] = M_PI * rand() / (double) RAND_MAX;
+        px[i] = 2.0 * M_PI * rand() / (double) RAND_MAX;
+        py[i] = px[i] - M_PI / 2.0;
+    }
+    t[0] = 0.0;
+    t[1] = M_PI;
+    px[2] = py[2] = NAN;
+    for (int i = 0; i < 8 * num_coeff; ++i)
+        a[i] = 2.0 * rand() / (double) RAND_MAX - 1.0;
+    convert(&theta, precision, &status);
+    convert(&phi_x, precision, &status);
+    convert(&phi_y, precision, &status);
+    convert(&alpha, precision, &status);
+    pattern = oskar_mem_create_copy(ref, OSKAR_CPU, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Evaluate the reference and the library versions.
+    if (precision == OSKAR_DOUBLE)
+        sph_wave_sum_ref_d(num_points, oskar_mem_double_const(theta, &status),
+                oskar_mem_double_const(phi_x, &status),
+                oskar_mem_double_const(phi_y, &status), l_max,
+                oskar_mem_double4c_const(alpha, &status), offset,
+                oskar_mem_double4c(ref, &status));
+    else
+        sph_wave_sum_ref_f(num_points, oskar_mem_float_const(theta, &status),
+                oskar_mem_float_const(phi_x, &status),
+                oskar_mem_float_const(phi_y, &status), l_max,
+                oskar_mem_float4c_const(alpha, &status), offset,
+                oskar_mem_float4c(ref, &status));
+    oskar_evaluate_spherical_wave_sum(num_points, theta, phi_x, phi_y,
+            l_max, alpha, offset, pattern, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Compare the results, relative to the largest value.
+    convert(&ref, OSKAR_DOUBLE, &status);
+    convert(&pattern, OSKAR_DOUBLE, &status);
+    const double* r = oskar_mem_double_const(ref, &status);
+    const double* p = oskar_mem_double_const(pattern, &status);
+    double max_val = 0.0, max_diff = 0.0;
+    for (int i = 8 * offset; i < 8 * (num_points + offset); ++i)
+    {
+        if (i / 8 == offset + 2)
+        {
+            ASSERT_TRUE(std::isnan(p[i]));
+            continue;
+        }
+        if (fabs(r[i]) > max_val) max_val = fabs(r[i]);
+        if (fabs(r[i] - p[i]) > max_diff) max_diff = fabs(r[i] - p[i]);
+    }
+    EXPECT_GT(max_val, 0.0);
+    EXPECT_LT(max_diff / max_val, tol) << "l_max = " << l_max;
+    for (int i = 0; i < 8 * offset; ++i) ASSERT_EQ(0.0, p[i]);
+
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi_x, &status);
+    oskar_mem_free(phi_y, &status);
+    oskar_mem_free(alpha, &status);
+    oskar_mem_free(pattern, &status);
+    oskar_mem_free(ref, &status);
+}
+
+TEST(evaluate_spherical_wave_sum, double_precision)
+{
+    for (int l_max = 1; l_max <= 20; ++l_max)
+        check_sum(OSKAR_DOUBLE, l_max, 1e-10);
+}
+
+TEST(evaluate_spherical_wave_sum, single_precision)
+{
+    for (int l_max = 1; l_max <= 12; ++l_max)
+        check_sum(OSKAR_SINGLE, l_max, 1e-4);
+}
@@ -8,6 +8,8 @@
 #include "telescope/station/oskar_station.h"
 #include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
 #include "telescope/station/oskar_evaluate_station_beam_gaussian.h"
+#include "telescope/station/oskar_evaluate_station_beam_interp.h"
+#include "telescope/station/private_station_work.h"
 #include "utility/oskar_get_error_string.h"
 #include "math/oskar_linspace.h"
 #include "math/oskar_meshgrid.h"
@@ -291,3 +293,341 @@ TEST(evaluate_station_beam, gaussian)
         oskar_mem_free(beam, &error);
     }
 }
+
+
+TEST(evaluate_station_beam, interp)
+{
+    int error = 0;
+    const double gast = 0.0, frequency = 100e6;
+    const int station_dim = 20, num_points = 50000;
+    const double station_size_m = 40.0;
+    const int num_antennas = station_dim * station_dim;
+
+    // Construct a station model, with its beam at a fixed azimuth and
+    // elevation.
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_antennas, &error);
+    oskar_station_resize_element_types(station, 1, &error);
+    oskar_station_set_position(station, 0.0, M_PI / 4.0, 0.0, 0.0, 0.0, 0.0);
+    double* x_pos = (double*) malloc(station_dim * sizeof(double));
+    oskar_linspace_d(x_pos, -station_size_m/2.0, station_size_m/2.0,
+            station_dim);
+    oskar_meshgrid_d(
+            oskar_mem_double(oskar_station_element_true_enu_metres(station, 0, 0), &error),
+            oskar_mem_double(oskar_station_element_true_enu_metres(station, 0, 1), &error),
+            x_pos, station_dim, x_pos, station_dim);
+    free(x_pos);
+    oskar_station_set_phase_centre(station,
+            OSKAR_COORDS_AZEL, 30.0 * M_PI / 180.0, 60.0 * M_PI / 180.0);
+    oskar_element_set_element_type(oskar_station_element(station, 0),
+            "Isotropic", &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z, *beam_ref, *beam;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    double *x_ = oskar_mem_double(x, &error), *y_ = oskar_mem_double(y, &error);
+    double *z_ = oskar_mem_double(z, &error);
+    srand(1);
+    for (int i = 0; i < num_points; ++i)
+    {
+        const double phi = 2.0 * M_PI * rand() / (double) RAND_MAX;
+        const double sin_theta = rand() / (double) RAND_MAX;
+        x_[i] = sin_theta * cos(phi);
+        y_[i] = sin_theta * sin(phi);
+        z_[i] = sqrt(1.0 - sin_theta * sin_theta);
+    }
+
+    // Evaluate the beam directly.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    beam_ref = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(station, work, num_points,
+            x, y, z, 0, gast, frequency, beam_ref, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // The first call with a new beam direction should not create the grid,
+    // but the second one should.
+    oskar_station_work_set_beam_interpolation(work, 8, 1024.0);
+    oskar_evaluate_station_beam_interp(station, work, num_points,
+            x, y, z, 0, gast, frequency, beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    ASSERT_EQ(1, work->num_beam_grids);
+    EXPECT_EQ(0, work->beam_grid[0].valid);
+    for (int t = 1; t < 3; ++t)
+    {
+        oskar_evaluate_station_beam_interp(station, work, num_points,
+                x, y, z, t, gast, frequency, beam, &error);
+        ASSERT_EQ(0, error) << oskar_get_error_string(error);
+        ASSERT_EQ(1, work->num_beam_grids);
+        EXPECT_EQ(1, work->beam_grid[0].valid);
+    }
+
+    // Check the interpolated beam against the direct evaluation.
+    const double2* a = oskar_mem_double2_const(beam, &error);
+    const double2* b = oskar_mem_double2_const(beam_ref, &error);
+    double max_err = 0.0;
+    for (int i = 0; i < num_points; ++i)
+    {
+        const double err = sqrt(pow(a[i].x - b[i].x, 2.0) +
+                pow(a[i].y - b[i].y, 2.0));
+        if (err > max_err) max_err = err;
+    }
+    EXPECT_LT(max_err / num_antennas, 0.005);
+
+    // Check that a grid is not used if it would not fit in memory.
+    oskar_station_work_set_beam_interpolation(work, 8, 0.0);
+    oskar_evaluate_station_beam_interp(station, work, num_points,
+            x, y, z, 0, gast, 2.0 * frequency, beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    ASSERT_EQ(2, work->num_beam_grids);
+    EXPECT_EQ(0, work->beam_grid[1].valid);
+
+    oskar_station_work_free(work, &error);
+    oskar_station_free(station, &error);
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(beam_ref, &error);
+    oskar_mem_free(beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+
+
+TEST(evaluate_station_beam, element_cache)
+{
+    int error = 0, num_tmp = 0;
+    double* tmp = 0;
+    const int station_dim = 4, num_points = 1000;
+    const int num_antennas = station_dim * station_dim;
+    const double freqs_hz[] = {100e6, 104e6, 150e6, 101e6};
+
+    // Write spherical wave coefficients for two element data frequencies.
+    const char* parts[] = {"te_re", "te_im", "tm_re", "tm_im"};
+    char filename[64];
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_antennas, &error);
+    oskar_station_resize_element_types(station, 1, &error);
+    oskar_Element* element = oskar_station_element(station, 0);
+    oskar_element_set_element_type(element, "Dipole", &error);
+    for (int f = 0; f < 2; ++f)
+    {
+        for (int p = 0; p < 4; ++p)
+        {
+            sprintf(filename, "temp_sw_coeff_%s.txt", parts[p]);
+            FILE* file = fopen(filename, "w");
+            for (int l = 1; l <= 3; ++l)
+            {
+                for (int m = 0; m < 2 * l + 1; ++m)
+                    fprintf(file, "%.3f ", 0.1 * (f + 1) * (p - m + l));
+                fprintf(file, "\n");
+            }
+            fclose(file);
+            oskar_element_load_spherical_wave_coeff(element, filename,
+                    f == 0 ? 100e6 : 150e6, &num_tmp, &tmp, &error);
+            remove(filename);
+        }
+    }
+    free(tmp);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Set the station coordinates and beam direction.
+    oskar_station_set_position(station, 0.0, M_PI / 4.0, 0.0, 0.0, 0.0, 0.0);
+    double* x_pos = (double*) malloc(station_dim * sizeof(double));
+    oskar_linspace_d(x_pos, -3.0, 3.0, station_dim);
+    oskar_meshgrid_d(
+            oskar_mem_double(oskar_station_element_true_enu_metres(station, 0, 0), &error),
+            oskar_mem_double(oskar_station_element_true_enu_metres(station, 0, 1), &error),
+            x_pos, station_dim, x_pos, station_dim);
+    free(x_pos);
+    oskar_station_set_phase_centre(station,
+            OSKAR_COORDS_AZEL, 0.0, M_PI / 2.0);
+
+    // Generate directions above the horizon.
+    oskar_Mem *x, *y, *z, *beam_ref, *beam;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    double *x_ = oskar_mem_double(x, &error), *y_ = oskar_mem_double(y, &error);
+    double *z_ = oskar_mem_double(z, &error);
+    for (int i = 0; i < num_points; ++i)
+    {
+        const double phi = 0.1 * i, sin_theta = 0.95 * i / num_points;
+        x_[i] = sin_theta * cos(phi);
+        y_[i] = sin_theta * sin(phi);
+        z_[i] = sqrt(1.0 - sin_theta * sin_theta);
+    }
+    beam_ref = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &error);
+    beam = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &error);
+
+    // Check that cached responses give the same beam as direct evaluation.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    oskar_StationWork* work_ref = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    oskar_station_work_set_element_cache_size(work_ref, 0.0);
+    for (int f = 0; f < 4; ++f)
+    {
+        oskar_evaluate_station_beam_aperture_array(station, work_ref,
+                num_points, x, y, z, 0, 0.0, freqs_hz[f], beam_ref, &error);
+        oskar_evaluate_station_beam_aperture_array(station, work,
+                num_points, x, y, z, 0, 0.0, freqs_hz[f], beam, &error);
+        ASSERT_EQ(0, error) << oskar_get_error_string(error);
+        EXPECT_EQ(0, memcmp(oskar_mem_void_const(beam),
+                oskar_mem_void_const(beam_ref),
+                num_points * oskar_mem_element_size(OSKAR_DOUBLE_COMPLEX_MATRIX)));
+    }
+    EXPECT_EQ(1, work->num_element_cache_dirs);
+    EXPECT_EQ(2, work->num_element_cache_entries);
+    EXPECT_EQ(0, work_ref->num_element_cache_dirs);
+
+    // Check that responses are not reused for different directions.
+    z_[1] = 1.0;
+    x_[1] = y_[1] = 0.0;
+    oskar_evaluate_station_beam_aperture_array(station, work_ref,
+            num_points, x, y, z, 1, 0.0, freqs_hz[0], beam_ref, &error);
+    oskar_evaluate_station_beam_aperture_array(station, work,
+            num_points, x, y, z, 1, 0.0, freqs_hz[0], beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    EXPECT_EQ(0, memcmp(oskar_mem_void_const(beam),
+            oskar_mem_void_const(beam_ref),
+            num_points * oskar_mem_element_size(OSKAR_DOUBLE_COMPLEX_MATRIX)));
+    EXPECT_EQ(2, work->num_element_cache_dirs);
+
+    // Check that the cache is turned off if no response was reused
+    // at the last time index.
+    z_[2] = 1.0;
+    x_[2] = y_[2] = 0.0;
+    oskar_evaluate_station_beam_aperture_array(station, work_ref,
+            num_points, x, y, z, 2, 0.0, freqs_hz[0], beam_ref, &error);
+    oskar_evaluate_station_beam_aperture_array(station, work,
+            num_points, x, y, z, 2, 0.0, freqs_hz[0], beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    EXPECT_EQ(0, memcmp(oskar_mem_void_const(beam),
+            oskar_mem_void_const(beam_ref),
+            num_points * oskar_mem_element_size(OSKAR_DOUBLE_COMPLEX_MATRIX)));
+    EXPECT_EQ(0, work->num_element_cache_dirs);
+
+    oskar_station_work_free(work, &error);
+    oskar_station_work_free(work_ref, &error);
+    oskar_station_free(station, &error);
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(beam_ref, &error);
+    oskar_mem_free(beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
+
+
+TEST(evaluate_station_beam, below_horizon)
+{
+    int error = 0;
+    const int station_dim = 8, num_points = 10000;
+    const int num_antennas = station_dim * station_dim;
+    const int type = OSKAR_DOUBLE_COMPLEX_MATRIX;
+
+    // Construct a station model of dipoles.
+    oskar_Station* station = oskar_station_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_antennas, &error);
+    oskar_station_resize_element_types(station, 1, &error);
+    oskar_station_set_position(station, 0.0, M_PI / 4.0, 0.0, 0.0, 0.0, 0.0);
+    double* x_pos = (double*) malloc(station_dim * sizeof(double));
+    oskar_linspace_d(x_pos, -10.0, 10.0, station_dim);
+    oskar_meshgrid_d(
+            oskar_mem_double(oskar_station_element_true_enu_metres(station, 0, 0), &error),
+            oskar_mem_double(oskar_station_element_true_enu_metres(station, 0, 1), &error),
+            x_pos, station_dim, x_pos, station_dim);
+    free(x_pos);
+    oskar_station_set_phase_centre(station,
+            OSKAR_COORDS_AZEL, 30.0 * M_PI / 180.0, 40.0 * M_PI / 180.0);
+    oskar_element_set_element_type(oskar_station_element(station, 0),
+            "Dipole", &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+
+    // Generate random directions over the whole sky, and copy those
+    // above the horizon.
+    oskar_Mem *x, *y, *z, *x_vis, *y_vis, *z_vis, *beam, *beam_vis;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    x_vis = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    y_vis = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    z_vis = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &error);
+    double *x_ = oskar_mem_double(x, &error), *y_ = oskar_mem_double(y, &error);
+    double *z_ = oskar_mem_double(z, &error);
+    double *xv = oskar_mem_double(x_vis, &error);
+    double *yv = oskar_mem_double(y_vis, &error);
+    double *zv = oskar_mem_double(z_vis, &error);
+    int num_visible = 0;
+    srand(3);
+    for (int i = 0; i < num_points; ++i)
+    {
+        const double phi = 2.0 * M_PI * rand() / (double) RAND_MAX;
+        const double cos_theta = 2.0 * rand() / (double) RAND_MAX - 1.0;
+        const double sin_theta = sqrt(1.0 - cos_theta * cos_theta);
+        x_[i] = sin_theta * cos(phi);
+        y_[i] = sin_theta * sin(phi);
+        z_[i] = (i == 0) ? 0.0 : cos_theta;
+        if (z_[i] < 0.0) continue;
+        xv[num_visible] = x_[i];
+        yv[num_visible] = y_[i];
+        zv[num_visible] = z_[i];
+        num_visible++;
+    }
+    ASSERT_GT(num_visible, 0);
+    ASSERT_LT(num_visible, num_points);
+    beam = oskar_mem_create(type, OSKAR_CPU, num_points, &error);
+    beam_vis = oskar_mem_create(type, OSKAR_CPU, num_visible, &error);
+
+    // Check that the beam is zero below the horizon, and the same as
+    // the beam evaluated only for visible sources elsewhere.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &error);
+    oskar_mem_set_value_real(beam, 1.0, 0, num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(station, work, num_points,
+            x, y, z, 0, 0.0, 100e6, beam, &error);
+    oskar_evaluate_station_beam_aperture_array(station, work, num_visible,
+            x_vis, y_vis, z_vis, 0, 0.0, 100e6, beam_vis, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    const size_t size = oskar_mem_element_size(type);
+    const char* b = (const char*) oskar_mem_void_const(beam);
+    const char* b_vis = (const char*) oskar_mem_void_const(beam_vis);
+    const double4c zero = {{0., 0.}, {0., 0.}, {0., 0.}, {0., 0.}};
+    for (int i = 0, j = 0; i < num_points; ++i)
+    {
+        if (z_[i] < 0.0)
+            ASSERT_EQ(0, memcmp(b + i * size, &zero, size)) << i;
+        else
+            ASSERT_EQ(0, memcmp(b + i * size, b_vis + (j++) * size, size))
+                    << i;
+    }
+
+    // Check that a sky with no visible sources gives zeros.
+    for (int i = 0; i < num_points; ++i) z_[i] = -1.0;
+    oskar_mem_set_value_real(beam, 1.0, 0, num_points, &error);
+    oskar_evaluate_station_beam_aperture_array(station, work, num_points,
+            x, y, z, 0, 0.0, 100e6, beam, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+    for (int i = 0; i < num_points; ++i)
+        ASSERT_EQ(0, memcmp(b + i * size, &zero, size)) << i;
+
+    oskar_station_work_free(work, &error);
+    oskar_station_free(station, &error);
+    oskar_mem_free(x, &error);
+    oskar_mem_free(y, &error);
+    oskar_mem_free(z, &error);
+    oskar_mem_free(x_vis, &error);
+    oskar_mem_free(y_vis, &error);
+    oskar_mem_free(z_vis, &error);
+    oskar_mem_free(beam, &error);
+    oskar_mem_free(beam_vis, &error);
+    ASSERT_EQ(0, error) << oskar_get_error_string(error);
+}
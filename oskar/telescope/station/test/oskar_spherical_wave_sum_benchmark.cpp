@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include "settings/oskar_option_parser.h"
+#include "telescope/station/element/oskar_evaluate_spherical_wave_sum.h"
+#include "telescope/station/element/define_evaluate_spherical_wave.h"
+#include "math/define_legendre_polynomial.h"
+#include "math/define_multiply.h"
+#include "math/oskar_cmath.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_kernel_macros.h"
+#include "utility/oskar_timer.h"
+#include "utility/oskar_device.h"
+#include "utility/oskar_vector_types.h"
+#include "oskar_version.h"
+
+#include <cstdlib>
+#include <cstdio>
+
+// Per-point version of the sum, as used on GPUs.
+OSKAR_EVALUATE_SPHERICAL_WAVE_SUM(sph_wave_sum_ref_f, float, float2, float4c)
+OSKAR_EVALUATE_SPHERICAL_WAVE_SUM(sph_wave_sum_ref_d, double, double2, double4c)
+
+int benchmark(int num_points, int l_max, int loc, int precision,
+        bool use_reference, int niter, double& time_taken);
+
+
+int main(int argc, char** argv)
+{
+    oskar::OptionParser opt("oskar_spherical_wave_sum_benchmark",
+            OSKAR_VERSION_STR);
+    opt.add_required("No. directions");
+    opt.add_required("Maximum order (l_max)");
+    opt.add_flag("-sp", "Use single precision (default: double precision)");
+    opt.add_flag("-g", "Run on the GPU");
+    opt.add_flag("-c", "Run on the CPU");
+    opt.add_flag("-cl", "Run using OpenCL");
+    opt.add_flag("-r", "Use the per-point reference version on the CPU");
+    opt.add_flag("-n", "Number of iterations", 1, "1");
+    opt.add_flag("-v", "Display verbose output.");
+
+    if (!opt.check_options(argc, argv))
+        return EXIT_FAILURE;
+
+    int num_points = atoi(opt.get_arg(0));
+    int l_max = atoi(opt.get_arg(1));
+    int location = -1;
+    if (opt.is_set("-g"))
+        location = OSKAR_GPU;
+    if (opt.is_set("-c"))
+        location = OSKAR_CPU;
+    if (opt.is_set("-cl"))
+        location = OSKAR_CL;
+    if (location < 0)
+    {
+        opt.error("Please select one of -g, -c or -cl");
+        return EXIT_FAILURE;
+    }
+    bool use_reference = opt.is_set("-r") ? true : false;
+    if (use_reference && location != OSKAR_CPU)
+    {
+        opt.error("The reference version can only be used with -c");
+        return EXIT_FAILURE;
+    }
+
+    int precision = opt.is_set("-sp") ? OSKAR_SINGLE : OSKAR_DOUBLE;
+    int niter = opt.get_int("-n");
+
+    if (opt.is_set("-v"))
+    {
+        printf("\n");
+        printf("- Number of directions: %i\n", num_points);
+        printf("- Maximum order: %i\n", l_max);
+        printf("- Precision: %s\n", (precision == OSKAR_SINGLE) ? "single" : "double");
+        printf("- Version: %s\n", use_reference ? "reference" : "library");
+        printf("- Number of iterations: %i\n", niter);
+        printf("\n");
+    }
+
+    double time_taken = 0.0;
+    oskar_device_set_require_double_precision(precision == OSKAR_DOUBLE);
+    int status = benchmark(num_points, l_max, location, precision,
+            use_reference, niter, time_taken);
+
+    if (status)
+    {
+        fprintf(stderr, "ERROR: spherical wave sum failed with code %i: "
+                "%s\n", status, oskar_get_error_string(status));
+        return EXIT_FAILURE;
+    }
+    if (opt.is_set("-v"))
+    {
+        printf("==> Total time taken: %f seconds.\n", time_taken);
+        printf("==> Time taken per iteration: %f seconds.\n", time_taken/niter);
+        printf("\n");
+    }
+    else
+    {
+        printf("%f\n", time_taken/niter);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+int benchmark(int num_points, int l_max, int loc, int precision,
+        bool use_reference, int niter, double& time_taken)
+{
+    int status = 0;
+    const int num_coeff = (l_max + 1) * (l_max + 1) - 1;
+    const int type = precision | OSKAR_COMPLEX | OSKAR_MATRIX;
+
+    // Generate random directions and coefficients on the CPU.
+    oskar_Mem *theta_cpu, *phi_cpu, *alpha_cpu;
+    theta_cpu = oskar_mem_create(precision, OSKAR_CPU, num_points, &status);
+    phi_cpu = oskar_mem_create(precision, OSKAR_CPU, num_points, &status);
+    alpha_cpu = oskar_mem_create(type, OSKAR_CPU, num_coeff, &status);
+    oskar_mem_random_uniform(theta_cpu, 1, 2, 3, 4, &status);
+    oskar_mem_random_uniform(phi_cpu, 5, 6, 7, 8, &status);
+    oskar_mem_random_uniform(alpha_cpu, 9, 10, 11, 12, &status);
+    oskar_mem_scale_real(theta_cpu, M_PI / 2.0, 0, num_points, &status);
+    oskar_mem_scale_real(phi_cpu, 2.0 * M_PI, 0, num_points, &status);
+    oskar_Mem *theta = oskar_mem_create_copy(theta_cpu, loc, &status);
+    oskar_Mem *phi = oskar_mem_create_copy(phi_cpu, loc, &status);
+    oskar_Mem *alpha = oskar_mem_create_copy(alpha_cpu, loc, &status);
+    oskar_Mem *pattern = oskar_mem_create(type, loc, num_points, &status);
+
+    oskar_Timer *tmr = oskar_timer_create(loc);
+    if (!status)
+    {
+        char* device_name = oskar_device_name(loc, 0);
+        printf("Using device '%s'\n", device_name);
+        free(device_name);
+        oskar_timer_start(tmr);
+        for (int i = 0; i < niter; ++i)
+        {
+            if (!use_reference)
+                oskar_evaluate_spherical_wave_sum(num_points, theta, phi, phi,
+                        l_max, alpha, 0, pattern, &status);
+            else if (precision == OSKAR_DOUBLE)
+                sph_wave_sum_ref_d(num_points,
+                        oskar_mem_double_const(theta, &status),
+                        oskar_mem_double_const(phi, &status),
+                        oskar_mem_double_const(phi, &status), l_max,
+                        oskar_mem_double4c_const(alpha, &status), 0,
+                        oskar_mem_double4c(pattern, &status));
+            else
+                sph_wave_sum_ref_f(num_points,
+                        oskar_mem_float_const(theta, &status),
+                        oskar_mem_float_const(phi, &status),
+                        oskar_mem_float_const(phi, &status), l_max,
+                        oskar_mem_float4c_const(alpha, &status), 0,
+                        oskar_mem_float4c(pattern, &status));
+        }
+        time_taken = oskar_timer_elapsed(tmr);
+    }
+
+    // Free memory.
+    oskar_timer_free(tmr);
+    oskar_mem_free(theta_cpu, &status);
+    oskar_mem_free(phi_cpu, &status);
+    oskar_mem_free(alpha_cpu, &status);
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi, &status);
+    oskar_mem_free(alpha, &status);
+    oskar_mem_free(pattern, &status);
+
+    return status;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2021, The OSKAR Developers.
+ * See the LICENSE file at the top-level directory of this distribution.
+ */
+
+#include <gtest/gtest.h>
+
+#include "utility/oskar_get_error_string.h"
+#include "telescope/oskar_telescope.h"
+
+TEST(telescope_memory_size, stations)
+{
+    int status = 0;
+    const int num_stations = 10, num_elements = 256;
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, &status);
+    const size_t empty_size = oskar_telescope_memory_size(tel);
+    EXPECT_GT(empty_size, (size_t)0);
+
+    // Element coordinates must be counted for every station.
+    for (int i = 0; i < num_stations; ++i)
+        oskar_station_resize(oskar_telescope_station(tel, i),
+                num_elements, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const size_t full_size = oskar_telescope_memory_size(tel);
+    EXPECT_GE(full_size - empty_size,
+            num_stations * num_elements * 3 * sizeof(double));
+
+    // A copy must use the same amount of memory.
+    oskar_Telescope* copy = oskar_telescope_create_copy(tel,
+            OSKAR_CPU, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(full_size, oskar_telescope_memory_size(copy));
+    EXPECT_EQ((size_t)0, oskar_telescope_memory_size(0));
+
+    oskar_telescope_free(copy, &status);
+    oskar_telescope_free(tel, &status);
+}
@@ -42,9 +42,11 @@ extern "C" {
 struct oskar_Mutex;
 struct oskar_Thread;
 struct oskar_Barrier;
+struct oskar_Counter;
 typedef struct oskar_Mutex oskar_Mutex;
 typedef struct oskar_Thread oskar_Thread;
 typedef struct oskar_Barrier oskar_Barrier;
+typedef struct oskar_Counter oskar_Counter;
 
 /**
  * @brief Creates a mutex.
@@ -163,6 +165,83 @@ void oskar_barrier_set_num_threads(oskar_Barrier* barrier, int num_threads);
 OSKAR_EXPORT
 int oskar_barrier_wait(oskar_Barrier* barrier);
 
+/**
+ * @brief Creates a counter that threads can wait on.
+ *
+ * @details
+ * Creates a counter that threads can wait on, with an initial value of 0.
+ *
+ * The counter value can only be increased. Threads can block until the
+ * counter reaches a given value, so it can be used to signal progress
+ * through an ordered sequence of tasks without using a barrier.
+ */
+OSKAR_EXPORT
+oskar_Counter* oskar_counter_create(void);
+
+/**
+ * @brief Destroys the counter.
+ *
+ * @details
+ * Destroys the counter.
+ *
+ * @param[in,out] counter Pointer to counter.
+ */
+OSKAR_EXPORT
+void oskar_counter_free(oskar_Counter* counter);
+
+/**
+ * @brief Increments the counter and wakes any waiting threads.
+ *
+ * @details
+ * Increments the counter and wakes any waiting threads.
+ *
+ * @param[in,out] counter Pointer to counter.
+ * @param[in] increment   Amount to add to the counter.
+ *
+ * @return The new value of the counter.
+ */
+OSKAR_EXPORT
+int oskar_counter_add(oskar_Counter* counter, int increment);
+
+/**
+ * @brief Returns the current value of the counter.
+ *
+ * @details
+ * Returns the current value of the counter.
+ *
+ * @param[in,out] counter Pointer to counter.
+ */
+OSKAR_EXPORT
+int oskar_counter_value(oskar_Counter* counter);
+
+/**
+ * @brief Blocks until the counter has reached the given value.
+ *
+ * @details
+ * Blocks the calling thread until the counter is greater than or equal to
+ * the given value. Returns immediately if it is already.
+ *
+ * @param[in,out] counter Pointer to counter.
+ * @param[in] value       Value to wait for.
+ */
+OSKAR_EXPORT
+void oskar_counter_wait(oskar_Counter* counter, int value);
+
+/**
+ * @brief Atomically adds to an integer and returns its previous value.
+ *
+ * @details
+ * Atomically adds to an integer shared between threads, without taking a
+ * lock, and returns the value it had before the addition.
+ *
+ * @param[in,out] value   Pointer to integer to modify.
+ * @param[in] increment   Amount to add.
+ *
+ * @return The previous value of the integer.
+ */
+OSKAR_EXPORT
+int oskar_atomic_fetch_add(volatile int* value, int increment);
+
 #ifdef __cplusplus
 }
 #endif
@@ -302,6 +302,76 @@ int oskar_barrier_wait(oskar_Barrier* barrier)
     return 0;
 }
 
+
+/* =========================================================================
+ *  COUNTER
+ * =========================================================================*/
+
+struct oskar_Counter
+{
+    oskar_ConditionVar var;
+    int value;
+};
+
+oskar_Counter* oskar_counter_create(void)
+{
+    oskar_Counter* counter;
+    counter = (oskar_Counter*) calloc(1, sizeof(oskar_Counter));
+    oskar_condition_init(&counter->var);
+    return counter;
+}
+
+void oskar_counter_free(oskar_Counter* counter)
+{
+    if (!counter) return;
+    oskar_condition_uninit(&counter->var);
+    free(counter);
+}
+
+int oskar_counter_add(oskar_Counter* counter, int increment)
+{
+    int value;
+    oskar_condition_lock(&counter->var);
+    counter->value += increment;
+    value = counter->value;
+    oskar_condition_notify_all(&counter->var);
+    oskar_condition_unlock(&counter->var);
+    return value;
+}
+
+int oskar_counter_value(oskar_Counter* counter)
+{
+    int value;
+    oskar_condition_lock(&counter->var);
+    value = counter->value;
+    oskar_condition_unlock(&counter->var);
+    return value;
+}
+
+void oskar_counter_wait(oskar_Counter* counter, int value)
+{
+    oskar_condition_lock(&counter->var);
+    /* Allow for spurious wake-ups. */
+    while (counter->value < value)
+        oskar_condition_wait(&counter->var);
+    oskar_condition_unlock(&counter->var);
+}
+
+
+/* =========================================================================
+ *  ATOMICS
+ * =========================================================================*/
+
+int oskar_atomic_fetch_add(volatile int* value, int increment)
+{
+#if defined(OSKAR_OS_WIN)
+    return (int) InterlockedExchangeAdd((volatile LONG*) value,
+            (LONG) increment);
+#else
+    return __sync_fetch_and_add(value, increment);
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -124,3 +124,62 @@ TEST(thread, barriers)
     free(args);
     free(threads);
 }
+
+struct CounterArgs
+{
+    volatile int* next_item;
+    int num_items;
+    int* items;
+    oskar_Counter* counter;
+};
+typedef struct CounterArgs CounterArgs;
+
+void* thread_counter(void* arg)
+{
+    CounterArgs* args = (CounterArgs*) arg;
+    for (;;)
+    {
+        const int i = oskar_atomic_fetch_add(args->next_item, 1);
+        if (i >= args->num_items) break;
+        args->items[i] += 1;
+        oskar_counter_add(args->counter, 1);
+    }
+    return 0;
+}
+
+TEST(thread, counter)
+{
+    // Set the number of threads and work items.
+    const int num_threads = 8, num_items = 10000;
+    volatile int next_item = 0;
+    int* items = (int*) calloc((size_t) num_items, sizeof(int));
+    oskar_Counter* counter = oskar_counter_create();
+    CounterArgs args;
+    args.next_item = &next_item;
+    args.num_items = num_items;
+    args.items = items;
+    args.counter = counter;
+
+    // Start all the threads, which claim work items without locking.
+    oskar_Thread** threads = (oskar_Thread**)
+            calloc((size_t) num_threads, sizeof(oskar_Thread*));
+    for (int i = 0; i < num_threads; ++i)
+        threads[i] = oskar_thread_create(thread_counter, (void*)(&args), 0);
+
+    // Wait for all items to be done, then check each was done only once.
+    oskar_counter_wait(counter, num_items);
+    for (int i = 0; i < num_items; ++i)
+        ASSERT_EQ(1, items[i]) << "Item " << i;
+    EXPECT_EQ(num_items + 1, oskar_counter_add(counter, 1));
+
+    // Clean up.
+    for (int i = 0; i < num_threads; ++i)
+    {
+        oskar_thread_join(threads[i]);
+        oskar_thread_free(threads[i]);
+    }
+    EXPECT_EQ(num_items + num_threads, next_item);
+    oskar_counter_free(counter);
+    free(items);
+    free(threads);
+}
@@ -199,7 +199,8 @@ class Imager(object):
     @property
     def algorithm(self):
         """Returns or sets the algorithm used by the imager.
-        Currently one of 'FFT', 'DFT 2D', 'DFT 3D' or 'W-projection'.
+        Currently one of 'FFT', 'DFT 2D', 'DFT 3D', 'W-projection',
+        'W-stacking' or 'IDG'.
 
         The default is 'FFT', which corresponds to basic but quick 2D gridding,
         ignoring baseline w-components.
@@ -219,6 +220,19 @@ class Imager(object):
         of image you are making, as an extra copy of the grid
         will be made by the FFT library.
 
+        'W-stacking' grids the visibilities into a set of W planes, spaced
+        linearly in W, using a small kernel, and applies the W-term
+        correction to each plane in the image domain after its FFT.
+        It is usually faster than W-projection on the CPU. Only a few W
+        planes are gridded at a time, so the memory needed does not depend
+        on the number of W planes.
+
+        'IDG' uses image-domain gridding onto a set of W planes: small
+        subgrids are made from the visibilities by a direct Fourier transform,
+        which uses their exact positions and corrects for the residual W-term,
+        before being transformed and added to the grid. It is slower than
+        W-stacking, but more accurate.
+
         Type
             str
         """
@@ -450,8 +464,8 @@ class Imager(object):
 
     @property
     def num_w_planes(self):
-        """Returns or sets the number of W-projection planes to use,
-        if using W-projection.
+        """Returns or sets the number of W planes to use,
+        if using W-projection, W-stacking or IDG.
 
         A number less than or equal to zero means 'automatic'.
 
@@ -612,6 +626,24 @@ class Imager(object):
     def uv_filter_min(self, value):
         self.set_uv_filter_min(value)
 
+    @property
+    def w_kernel_cache_dir(self):
+        """Returns or sets the directory used to cache W-projection kernels.
+
+        If set, kernels are loaded from this directory if they have
+        already been generated for the same parameters, and saved to it
+        otherwise. An empty string disables the cache (the default).
+
+        Type
+            str
+        """
+        self.capsule_ensure()
+        return _imager_lib.w_kernel_cache_dir(self._capsule)
+
+    @w_kernel_cache_dir.setter
+    def w_kernel_cache_dir(self, value):
+        self.set_w_kernel_cache_dir(value)
+
     @property
     def weighting(self):
         """Returns or sets the type of visibility weighting to use.
@@ -630,8 +662,8 @@ class Imager(object):
 
     @property
     def wprojplanes(self):
-        """Returns or sets the number of W-projection planes to use,
-        if using W-projection.
+        """Returns or sets the number of W planes to use,
+        if using W-projection, W-stacking or IDG.
 
         A number less than or equal to zero means 'automatic'.
 
@@ -1133,6 +1165,15 @@ class Imager(object):
         self.capsule_ensure()
         _imager_lib.set_vis_phase_centre(self._capsule, ra_deg, dec_deg)
 
+    def set_w_kernel_cache_dir(self, path):
+        """Sets the directory used to cache W-projection kernels.
+
+        Args:
+            path (str): Path to the cache directory, or an empty string.
+        """
+        self.capsule_ensure()
+        _imager_lib.set_w_kernel_cache_dir(self._capsule, path)
+
     def set_weighting(self, weighting):
         """Sets the type of visibility weighting to use.
 